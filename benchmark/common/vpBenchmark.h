@@ -0,0 +1,317 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Micro-benchmark harness shared by the ViSP benchmarks.
+ *
+ *****************************************************************************/
+
+#ifndef vpBenchmark_h
+#define vpBenchmark_h
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+/*!
+  \class vpBenchmark
+
+  \brief Minimal micro-benchmark harness used by the programs of the
+  benchmark folder.
+
+  Each case is a functor whose operator()() runs one operation. It is first
+  called once to warm up caches, then the number of calls per repetition is
+  chosen so that a repetition lasts at least the minimal time divided by the
+  number of repetitions. The median and the minimum over the repetitions are
+  reported in nanoseconds per operation, together with a throughput when the
+  number of items processed by one operation is given.
+
+  Results are printed as a table and can be written as JSON or CSV with the
+  -o option, for instance to compare two builds with
+  script/compare-benchmarks.py:
+  \code
+  $ ./benchImageFilter -o before.json
+  ... rebuild ...
+  $ ./benchImageFilter -o after.json
+  $ python script/compare-benchmarks.py before.json after.json
+  \endcode
+*/
+class vpBenchmark
+{
+public:
+  explicit vpBenchmark(const std::string &suite)
+    : m_suite(suite), m_minTime(0.5), m_repeat(5), m_filter(), m_output(), m_label(), m_list(false), m_results()
+  {
+  }
+
+  /*!
+    Parse the command line options. Return false if the program has to stop.
+  */
+  bool parseOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, "cdf:hl:L:o:r:t:", &optarg_)) > 1) {
+      switch (c) {
+      case 'f':
+        m_filter = optarg_;
+        break;
+      case 'L':
+        m_label = optarg_;
+        break;
+      case 'l':
+        m_list = true;
+        break;
+      case 'o':
+        m_output = optarg_;
+        break;
+      case 'r':
+        m_repeat = std::max(1, atoi(optarg_));
+        break;
+      case 't':
+        m_minTime = atof(optarg_);
+        break;
+      case 'c':
+      case 'd':
+        break;
+      case 'h':
+        usage(argv[0], NULL);
+        return false;
+      default:
+        usage(argv[0], optarg_);
+        return false;
+      }
+    }
+    if ((c == 1) || (c == -1)) {
+      usage(argv[0], optarg_);
+      return false;
+    }
+    return true;
+  }
+
+  /*!
+    Run and record a case.
+
+    \param name : Case name, unique within the suite.
+    \param func : Functor running one operation.
+    \param items : Number of items (pixels, points...) processed by one
+    operation, used to compute the throughput. 0 to skip it.
+    \param unit : Name of the items.
+  */
+  template <class Func> void run(const std::string &name, Func &func, double items = 0., const std::string &unit = "")
+  {
+    if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+      return;
+    }
+    if (m_list) {
+      std::cout << name << std::endl;
+      return;
+    }
+
+    func();
+
+    // Calibrate the number of calls per repetition
+    const double target = 1e6 * m_minTime / m_repeat; // us
+    unsigned long n = 1;
+    for (;;) {
+      double t = measure(func, n);
+      if (t >= target || n >= (1ul << 30)) {
+        break;
+      }
+      double scale = (t > 0) ? 1.2 * target / t : 10.;
+      n = (unsigned long)(n * std::min(10., std::max(2., scale)));
+    }
+
+    std::vector<double> ns(m_repeat);
+    for (int r = 0; r < m_repeat; r++) {
+      ns[r] = 1e3 * measure(func, n) / n;
+    }
+    std::sort(ns.begin(), ns.end());
+
+    Result res;
+    res.name = name;
+    res.iterations = n;
+    res.median = ns[ns.size() / 2];
+    res.min = ns[0];
+    res.unit = unit;
+    res.throughput = (items > 0 && res.median > 0) ? items * 1e9 / res.median : 0.;
+    m_results.push_back(res);
+
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(1) << res.median << " ns/op" << std::setw(14) << res.min << " min";
+    if (res.throughput > 0) {
+      const double scale = res.throughput >= 1e6 ? 1e6 : (res.throughput >= 1e3 ? 1e3 : 1.);
+      const char *prefix = res.throughput >= 1e6 ? " M" : (res.throughput >= 1e3 ? " k" : " ");
+      std::cout << std::setw(12) << std::setprecision(2) << res.throughput / scale << prefix << unit << "/s";
+    }
+    std::cout << std::endl;
+  }
+
+  /*!
+    Write the results to the file given with -o, if any. Return the program
+    exit code.
+  */
+  int finish() const
+  {
+    if (m_output.empty() || m_list) {
+      return EXIT_SUCCESS;
+    }
+    std::ofstream file(m_output.c_str());
+    if (!file) {
+      std::cerr << "Cannot write " << m_output << std::endl;
+      return EXIT_FAILURE;
+    }
+    file << std::setprecision(10);
+    if (m_output.size() > 4 && m_output.substr(m_output.size() - 4) == ".csv") {
+      file << "suite,name,iterations,ns_per_op,ns_per_op_min,items_per_second,unit" << std::endl;
+      for (size_t i = 0; i < m_results.size(); i++) {
+        const Result &r = m_results[i];
+        file << m_suite << "," << r.name << "," << r.iterations << "," << r.median << "," << r.min << ","
+             << r.throughput << "," << r.unit << std::endl;
+      }
+      return EXIT_SUCCESS;
+    }
+
+    char date[32];
+    std::time_t now = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    file << "{" << std::endl;
+    file << "  \"suite\": \"" << escape(m_suite) << "\"," << std::endl;
+    file << "  \"label\": \"" << escape(m_label) << "\"," << std::endl;
+    file << "  \"date\": \"" << date << "\"," << std::endl;
+    file << "  \"visp_version\": \"" << VISP_VERSION_MAJOR << "." << VISP_VERSION_MINOR << "." << VISP_VERSION_PATCH
+         << "\"," << std::endl;
+    file << "  \"min_time\": " << m_minTime << "," << std::endl;
+    file << "  \"repeat\": " << m_repeat << "," << std::endl;
+    file << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < m_results.size(); i++) {
+      const Result &r = m_results[i];
+      file << "    {\"name\": \"" << escape(r.name) << "\", \"iterations\": " << r.iterations
+           << ", \"ns_per_op\": " << r.median << ", \"ns_per_op_min\": " << r.min
+           << ", \"items_per_second\": " << r.throughput << ", \"unit\": \"" << escape(r.unit) << "\"}"
+           << (i + 1 < m_results.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+private:
+  struct Result {
+    std::string name;
+    unsigned long iterations;
+    double median;
+    double min;
+    double throughput;
+    std::string unit;
+  };
+
+  template <class Func> static double measure(Func &func, unsigned long n)
+  {
+    double t = vpTime::measureTimeMicros();
+    for (unsigned long i = 0; i < n; i++) {
+      func();
+    }
+    return vpTime::measureTimeMicros() - t;
+  }
+
+  static std::string escape(const std::string &s)
+  {
+    std::string e;
+    for (size_t i = 0; i < s.size(); i++) {
+      if (s[i] == '"' || s[i] == '\\') {
+        e += '\\';
+      }
+      e += s[i];
+    }
+    return e;
+  }
+
+  void usage(const char *name, const char *badparam) const
+  {
+    fprintf(stdout, "\n\
+Run the %s micro-benchmarks.\n\
+\n\
+SYNOPSIS\n\
+  %s [-t <min time>] [-r <repeat>] [-f <pattern>] [-l]\n\
+     [-o <file.json|file.csv>] [-L <label>] [-h]\n",
+            m_suite.c_str(), name);
+
+    fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -t <min time>                                        %g\n\
+     Minimal measuring time of a case, in seconds.\n\
+\n\
+  -r <repeat>                                          %d\n\
+     Number of repetitions. The median is reported.\n\
+\n\
+  -f <pattern>\n\
+     Only run the cases whose name contains the pattern.\n\
+\n\
+  -l\n\
+     List the cases without running them.\n\
+\n\
+  -o <file.json|file.csv>\n\
+     Write the results as JSON, or as CSV if the extension is .csv.\n\
+\n\
+  -L <label>\n\
+     Label stored in the JSON output, like a commit id.\n\
+\n\
+  -h\n\
+     Print the help.\n\n",
+            m_minTime, m_repeat);
+
+    if (badparam) {
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+    }
+  }
+
+  std::string m_suite;
+  double m_minTime;
+  int m_repeat;
+  std::string m_filter;
+  std::string m_output;
+  std::string m_label;
+  bool m_list;
+  std::vector<Result> m_results;
+};
+
+#endif
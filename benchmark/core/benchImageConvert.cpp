@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the vpImageConvert color conversions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchImageConvert.cpp
+
+  Benchmark of the vpImageConvert color conversions on a VGA image.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpImageConvert.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+// Conversions between raw buffers
+typedef void (*SizeConversion)(unsigned char *, unsigned char *, unsigned int);
+typedef void (*FrameConversion)(unsigned char *, unsigned char *, unsigned int, unsigned int);
+
+struct ConvertSize {
+  SizeConversion f;
+  unsigned char *src, *dst;
+  unsigned int size;
+  void operator()() { f(src, dst, size); }
+};
+
+struct ConvertFrame {
+  FrameConversion f;
+  unsigned char *src, *dst;
+  unsigned int width, height;
+  void operator()() { f(src, dst, width, height); }
+};
+
+// BGR conversions, without vertical flip
+void BGRToGrey(unsigned char *bgr, unsigned char *grey, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BGRToGrey(bgr, grey, width, height);
+}
+void BGRToRGBa(unsigned char *bgr, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BGRToRGBa(bgr, rgba, width, height);
+}
+
+// Conversions of read-only camera buffers
+void NV12ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  vpImageConvert::NV12ToRGBa(yuv, rgba, width, height);
+}
+void BayerToRGBaBilinear(unsigned char *bayer, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BayerToRGBa(bayer, rgba, width, height, vpImageConvert::BAYER_RGGB);
+}
+void BayerToRGBaMalvar(unsigned char *bayer, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BayerToRGBa(bayer, rgba, width, height, vpImageConvert::BAYER_RGGB, vpImageConvert::BAYER_MALVAR);
+}
+void BayerToGrey(unsigned char *bayer, unsigned char *grey, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BayerToGrey(bayer, grey, width, height, vpImageConvert::BAYER_RGGB);
+}
+void BayerToGreyHalf(unsigned char *bayer, unsigned char *grey, unsigned int width, unsigned int height)
+{
+  vpImageConvert::BayerToGreyHalf(bayer, grey, width, height, vpImageConvert::BAYER_RGGB);
+}
+
+// Conversions between images
+template <typename Src, typename Dst> struct ConvertImage {
+  const vpImage<Src> *src;
+  vpImage<Dst> *dst;
+  void operator()() { vpImageConvert::convert(*src, *dst); }
+};
+
+void runSize(vpBenchmark &bench, const std::string &name, SizeConversion f, unsigned char *src, unsigned char *dst,
+             unsigned int size)
+{
+  ConvertSize func = {f, src, dst, size};
+  bench.run(name, func, size, "pixel");
+}
+
+void runFrame(vpBenchmark &bench, const std::string &name, FrameConversion f, unsigned char *src, unsigned char *dst,
+              unsigned int width, unsigned int height)
+{
+  ConvertFrame func = {f, src, dst, width, height};
+  bench.run(name, func, width * height, "pixel");
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchImageConvert");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  const unsigned int width = 640, height = 480, size = width * height;
+  std::vector<unsigned char> src(4 * size), dst(4 * size);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = (unsigned char)((i * 7919) % 251);
+  }
+
+  runSize(bench, "GreyToRGBa/640x480", vpImageConvert::GreyToRGBa, &src[0], &dst[0], size);
+  runSize(bench, "GreyToRGB/640x480", vpImageConvert::GreyToRGB, &src[0], &dst[0], size);
+  runSize(bench, "RGBaToGrey/640x480", vpImageConvert::RGBaToGrey, &src[0], &dst[0], size);
+  runSize(bench, "RGBaToRGB/640x480", vpImageConvert::RGBaToRGB, &src[0], &dst[0], size);
+  runSize(bench, "RGBToGrey/640x480", vpImageConvert::RGBToGrey, &src[0], &dst[0], size);
+  runSize(bench, "RGBToRGBa/640x480", vpImageConvert::RGBToRGBa, &src[0], &dst[0], size);
+  runFrame(bench, "BGRToGrey/640x480", BGRToGrey, &src[0], &dst[0], width, height);
+  runFrame(bench, "BGRToRGBa/640x480", BGRToRGBa, &src[0], &dst[0], width, height);
+  runSize(bench, "YUV411ToRGBa/640x480", vpImageConvert::YUV411ToRGBa, &src[0], &dst[0], size);
+  runSize(bench, "YUV422ToGrey/640x480", vpImageConvert::YUV422ToGrey, &src[0], &dst[0], size);
+  runSize(bench, "YUV422ToRGBa/640x480", vpImageConvert::YUV422ToRGBa, &src[0], &dst[0], size);
+  runFrame(bench, "YUV420ToRGBa/640x480", vpImageConvert::YUV420ToRGBa, &src[0], &dst[0], width, height);
+  runFrame(bench, "NV12ToRGBa/640x480", NV12ToRGBa, &src[0], &dst[0], width, height);
+  runSize(bench, "YUV444ToRGBa/640x480", vpImageConvert::YUV444ToRGBa, &src[0], &dst[0], size);
+  runSize(bench, "YCbCrToRGBa/640x480", vpImageConvert::YCbCrToRGBa, &src[0], &dst[0], size);
+  runFrame(bench, "BayerToRGBa/bilinear/640x480", BayerToRGBaBilinear, &src[0], &dst[0], width, height);
+  runFrame(bench, "BayerToRGBa/Malvar/640x480", BayerToRGBaMalvar, &src[0], &dst[0], width, height);
+  runFrame(bench, "BayerToGrey/640x480", BayerToGrey, &src[0], &dst[0], width, height);
+  runFrame(bench, "BayerToGreyHalf/640x480", BayerToGreyHalf, &src[0], &dst[0], width, height);
+
+  vpImage<unsigned char> I(height, width);
+  vpImage<vpRGBa> Irgba(height, width);
+  vpImage<float> If(height, width);
+  vpImage<double> Id(height, width);
+  for (unsigned int i = 0; i < size; i++) {
+    I.bitmap[i] = src[i];
+  }
+  vpImageConvert::convert(I, Irgba);
+  vpImageConvert::convert(I, If);
+  vpImageConvert::convert(I, Id);
+
+  vpImage<unsigned char> Io;
+  vpImage<float> Ifo;
+  vpImage<double> Ido;
+  ConvertImage<unsigned char, float> uchar2float = {&I, &Ifo};
+  bench.run("convert/uchar->float/640x480", uchar2float, size, "pixel");
+  ConvertImage<float, unsigned char> float2uchar = {&If, &Io};
+  bench.run("convert/float->uchar/640x480", float2uchar, size, "pixel");
+  ConvertImage<unsigned char, double> uchar2double = {&I, &Ido};
+  bench.run("convert/uchar->double/640x480", uchar2double, size, "pixel");
+  ConvertImage<double, unsigned char> double2uchar = {&Id, &Io};
+  bench.run("convert/double->uchar/640x480", double2uchar, size, "pixel");
+
+  return bench.finish();
+}
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the vpImageFilter kernels.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchImageFilter.cpp
+
+  Benchmark of the vpImageFilter kernels on a VGA image.
+*/
+
+#include <visp3/core/vpImageFilter.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+template <typename T> struct GaussianBlur {
+  const vpImage<unsigned char> *I;
+  vpImage<T> *GI;
+  unsigned int size;
+  void operator()() { vpImageFilter::gaussianBlur(*I, *GI, size); }
+};
+
+template <typename T> struct GradX {
+  const vpImage<unsigned char> *I;
+  vpImage<T> *dI;
+  const T *filter;
+  unsigned int size;
+  void operator()() { vpImageFilter::getGradX(*I, *dI, filter, size); }
+};
+
+template <typename T> struct GradY {
+  const vpImage<unsigned char> *I;
+  vpImage<T> *dI;
+  const T *filter;
+  unsigned int size;
+  void operator()() { vpImageFilter::getGradY(*I, *dI, filter, size); }
+};
+
+struct GradXGauss2D {
+  const vpImage<unsigned char> *I;
+  vpImage<double> *dI;
+  const double *gaussian, *derivative;
+  unsigned int size;
+  void operator()() { vpImageFilter::getGradXGauss2D(*I, *dI, gaussian, derivative, size); }
+};
+
+struct Filter {
+  const vpImage<unsigned char> *I;
+  vpImage<double> *If;
+  const vpMatrix *M;
+  void operator()() { vpImageFilter::filter(*I, *If, *M); }
+};
+
+struct SepFilter {
+  const vpImage<unsigned char> *I;
+  vpImage<double> *If;
+  const vpColVector *kernel;
+  void operator()() { vpImageFilter::sepFilter(*I, *If, *kernel, *kernel); }
+};
+
+struct GaussPyramidal {
+  const vpImage<unsigned char> *I;
+  vpImage<unsigned char> *GI;
+  void operator()() { vpImageFilter::getGaussPyramidal(*I, *GI); }
+};
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+struct Canny {
+  const vpImage<unsigned char> *I;
+  vpImage<unsigned char> *Ic;
+  void operator()() { vpImageFilter::canny(*I, *Ic, 5, 15, 3); }
+};
+#endif
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchImageFilter");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  vpImage<unsigned char> I(480, 640);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)(128 + 100 * sin(i / 10.) * cos(j / 15.) + (i * j) % 17);
+    }
+  }
+  const double pixels = I.getSize();
+
+  vpImage<double> Id;
+  vpImage<float> If;
+  vpImage<unsigned char> Iu;
+  vpImage<short> Is;
+
+  for (unsigned int size = 3; size <= 7; size += 4) {
+    std::ostringstream suffix;
+    suffix << "/" << size << "/640x480";
+
+    GaussianBlur<double> blurDouble = {&I, &Id, size};
+    bench.run("gaussianBlur/double" + suffix.str(), blurDouble, pixels, "pixel");
+    GaussianBlur<float> blurFloat = {&I, &If, size};
+    bench.run("gaussianBlur/float" + suffix.str(), blurFloat, pixels, "pixel");
+    GaussianBlur<unsigned char> blurFixed = {&I, &Iu, size};
+    bench.run("gaussianBlur/fixed" + suffix.str(), blurFixed, pixels, "pixel");
+
+    std::vector<double> fg((size + 1) / 2), fd((size + 1) / 2);
+    std::vector<float> fdf((size + 1) / 2);
+    std::vector<short> fds((size + 1) / 2);
+    vpImageFilter::getGaussianKernel(&fg[0], size);
+    vpImageFilter::getGaussianDerivativeKernel(&fd[0], size);
+    vpImageFilter::getGaussianDerivativeKernel(&fdf[0], size);
+    for (size_t k = 0; k < fds.size(); k++) {
+      fds[k] = (short)vpMath::round(64 * fd[k]);
+    }
+
+    GradX<double> gradXDouble = {&I, &Id, &fd[0], size};
+    bench.run("getGradX/double" + suffix.str(), gradXDouble, pixels, "pixel");
+    GradY<double> gradYDouble = {&I, &Id, &fd[0], size};
+    bench.run("getGradY/double" + suffix.str(), gradYDouble, pixels, "pixel");
+    GradX<float> gradXFloat = {&I, &If, &fdf[0], size};
+    bench.run("getGradX/float" + suffix.str(), gradXFloat, pixels, "pixel");
+    GradX<short> gradXFixed = {&I, &Is, &fds[0], size};
+    bench.run("getGradX/fixed" + suffix.str(), gradXFixed, pixels, "pixel");
+    GradXGauss2D gradXGauss2D = {&I, &Id, &fg[0], &fd[0], size};
+    bench.run("getGradXGauss2D" + suffix.str(), gradXGauss2D, pixels, "pixel");
+  }
+
+  vpMatrix M(3, 3, 1. / 9.);
+  Filter filter = {&I, &Id, &M};
+  bench.run("filter/3x3/640x480", filter, pixels, "pixel");
+
+  vpColVector kernel(5, 0.2);
+  SepFilter sepFilter = {&I, &Id, &kernel};
+  bench.run("sepFilter/5/640x480", sepFilter, pixels, "pixel");
+
+  GaussPyramidal pyramid = {&I, &Iu};
+  bench.run("getGaussPyramidal/640x480", pyramid, pixels, "pixel");
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  vpImage<unsigned char> Ic;
+  Canny canny = {&I, &Ic};
+  bench.run("canny/640x480", canny, pixels, "pixel");
+#endif
+
+  return bench.finish();
+}
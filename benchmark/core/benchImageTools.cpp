@@ -0,0 +1,119 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of vpImageTools resize, undistort and template matching.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchImageTools.cpp
+
+  Benchmark of vpImageTools resize, undistort and template matching on a VGA
+  image.
+*/
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageTools.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+template <typename Type> struct Resize {
+  const vpImage<Type> *I;
+  vpImage<Type> *Ires;
+  unsigned int width, height;
+  vpImageTools::vpImageInterpolationType method;
+  void operator()() { vpImageTools::resize(*I, *Ires, width, height, method); }
+};
+
+template <typename Type> struct Undistort {
+  const vpImage<Type> *I;
+  const vpCameraParameters *cam;
+  vpImage<Type> *Iund;
+  void operator()() { vpImageTools::undistort(*I, *cam, *Iund); }
+};
+
+struct TemplateMatching {
+  const vpImage<unsigned char> *I, *Itpl;
+  vpImage<double> *Iscore;
+  void operator()() { vpImageTools::templateMatching(*I, *Itpl, *Iscore, 2, 2); }
+};
+
+template <typename Type>
+void runResize(vpBenchmark &bench, const std::string &type, const vpImage<Type> &I, vpImage<Type> &Ires)
+{
+  const char *names[] = {"nearest", "linear", "cubic"};
+  const vpImageTools::vpImageInterpolationType methods[] = {
+      vpImageTools::INTERPOLATION_NEAREST, vpImageTools::INTERPOLATION_LINEAR, vpImageTools::INTERPOLATION_CUBIC};
+  for (int m = 0; m < 3; m++) {
+    Resize<Type> down = {&I, &Ires, I.getWidth() / 2, I.getHeight() / 2, methods[m]};
+    bench.run("resize/" + type + "/" + names[m] + "/640x480->320x240", down, I.getSize() / 4., "pixel");
+    Resize<Type> up = {&I, &Ires, I.getWidth() * 2, I.getHeight() * 2, methods[m]};
+    bench.run("resize/" + type + "/" + names[m] + "/640x480->1280x960", up, I.getSize() * 4., "pixel");
+  }
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchImageTools");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  vpImage<unsigned char> I(480, 640), Ires;
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)(128 + 100 * sin(i / 10.) * cos(j / 15.) + (i * j) % 17);
+    }
+  }
+  vpImage<vpRGBa> Irgba, Irgba_res;
+  vpImageConvert::convert(I, Irgba);
+
+  runResize(bench, "uchar", I, Ires);
+  runResize(bench, "rgba", Irgba, Irgba_res);
+
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 320, 240, -0.25, 0.25);
+  Undistort<unsigned char> undistort = {&I, &cam, &Ires};
+  bench.run("undistort/uchar/640x480", undistort, I.getSize(), "pixel");
+  Undistort<vpRGBa> undistortRGBa = {&Irgba, &cam, &Irgba_res};
+  bench.run("undistort/rgba/640x480", undistortRGBa, I.getSize(), "pixel");
+
+  vpImage<unsigned char> Itpl;
+  vpImageTools::crop(I, 200, 300, 32, 32, Itpl);
+  vpImage<double> Iscore;
+  TemplateMatching matching = {&I, &Itpl, &Iscore};
+  bench.run("templateMatching/32x32/640x480", matching, I.getSize() / 4., "position");
+
+  return bench.finish();
+}
@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of vpMatrix products, pseudo-inverse and SVD per backend.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchMatrix.cpp
+
+  Benchmark of vpMatrix products, pseudo-inverse and SVD, for each of the
+  third-party backends ViSP was built with.
+*/
+
+#include <limits>
+
+#include <visp3/core/vpMatrix.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+typedef unsigned int (vpMatrix::*PseudoInverseMethod)(vpMatrix &, double) const;
+typedef void (vpMatrix::*SvdMethod)(vpColVector &, vpMatrix &);
+
+struct Mult {
+  const vpMatrix *A, *B;
+  vpMatrix *C;
+  void operator()() { vpMatrix::mult2Matrices(*A, *B, *C); }
+};
+
+struct MultVector {
+  const vpMatrix *A;
+  const vpColVector *v;
+  vpColVector *w;
+  void operator()() { vpMatrix::mult2Matrices(*A, *v, *w); }
+};
+
+struct AtA {
+  const vpMatrix *A;
+  vpMatrix *B;
+  void operator()() { A->AtA(*B); }
+};
+
+struct PseudoInverse {
+  const vpMatrix *A;
+  vpMatrix *Ap;
+  PseudoInverseMethod method;
+  void operator()() { (A->*method)(*Ap, 1e-6); }
+};
+
+// The SVD is computed in place, the copy of the input is timed as well
+struct Svd {
+  const vpMatrix *A;
+  vpMatrix *U, *V;
+  vpColVector *w;
+  SvdMethod method;
+  void operator()()
+  {
+    *U = *A;
+    ((*U).*method)(*w, *V);
+  }
+};
+
+struct HomogeneousMult {
+  const vpHomogeneousMatrix *aMb, *bMc;
+  vpHomogeneousMatrix *aMc;
+  void operator()() { *aMc = *aMb * *bMc; }
+};
+
+struct HomogeneousInverse {
+  const vpHomogeneousMatrix *aMb;
+  vpHomogeneousMatrix *bMa;
+  void operator()() { *bMa = aMb->inverse(); }
+};
+
+struct VelocityTwist {
+  const vpHomogeneousMatrix *aMb;
+  vpVelocityTwistMatrix *aVb;
+  void operator()() { aVb->buildFrom(*aMb); }
+};
+
+vpMatrix randomMatrix(unsigned int rows, unsigned int cols)
+{
+  vpMatrix A(rows, cols);
+  for (unsigned int i = 0; i < rows; i++) {
+    for (unsigned int j = 0; j < cols; j++) {
+      A[i][j] = (double)rand() / RAND_MAX - 0.5;
+    }
+  }
+  return A;
+}
+
+std::string sizeName(const vpMatrix &A)
+{
+  std::ostringstream os;
+  os << A.getRows() << "x" << A.getCols();
+  return os.str();
+}
+
+// Products are timed with the built-in kernels, or with BLAS when ViSP is built with it
+void runProducts(vpBenchmark &bench, const std::string &backend)
+{
+  if (backend == "native") {
+    vpMatrix::setLapackMatrixMinSize(std::numeric_limits<unsigned int>::max());
+  }
+
+  const unsigned int sizes[] = {6, 32, 128, 256};
+  for (int s = 0; s < 4; s++) {
+    const unsigned int n = sizes[s];
+    vpMatrix A = randomMatrix(n, n), B = randomMatrix(n, n), C;
+    Mult mult = {&A, &B, &C};
+    bench.run("mult/" + backend + "/" + sizeName(A), mult, 2. * n * n * n, "flop");
+
+    vpColVector v(n, 1.), w;
+    MultVector multVector = {&A, &v, &w};
+    bench.run("multVector/" + backend + "/" + sizeName(A), multVector, 2. * n * n, "flop");
+  }
+
+  // Interaction matrices are tall and skinny
+  const unsigned int rows[] = {100, 1000, 10000};
+  for (int r = 0; r < 3; r++) {
+    vpMatrix L = randomMatrix(rows[r], 6), LtL;
+    AtA ata = {&L, &LtL};
+    bench.run("AtA/" + backend + "/" + sizeName(L), ata, 2. * rows[r] * 36, "flop");
+  }
+  vpMatrix S = randomMatrix(256, 256), StS;
+  AtA ata = {&S, &StS};
+  bench.run("AtA/" + backend + "/" + sizeName(S), ata, 2. * 256 * 256 * 256, "flop");
+}
+
+void runDecompositions(vpBenchmark &bench, const std::string &backend, PseudoInverseMethod pinv, SvdMethod svd,
+                       const std::vector<vpMatrix> &matrices)
+{
+  vpMatrix Ap, U, V;
+  vpColVector w;
+  for (size_t i = 0; i < matrices.size(); i++) {
+    PseudoInverse pseudoInverse = {&matrices[i], &Ap, pinv};
+    bench.run("pseudoInverse/" + backend + "/" + sizeName(matrices[i]), pseudoInverse);
+    Svd decomposition = {&matrices[i], &U, &V, &w, svd};
+    bench.run("svd/" + backend + "/" + sizeName(matrices[i]), decomposition);
+  }
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchMatrix");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+  srand(0);
+
+  runProducts(bench, "native");
+#if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
+  vpMatrix::setLapackMatrixMinSize(0);
+  runProducts(bench, "blas");
+#endif
+
+  const vpHomogeneousMatrix aMb(0.1, -0.2, 0.5, 0.1, -0.3, 0.5), bMc(-0.3, 0.05, 0.2, -0.6, 0.1, 0.2);
+  vpHomogeneousMatrix aMc;
+  vpVelocityTwistMatrix aVb;
+  HomogeneousMult homogeneousMult = {&aMb, &bMc, &aMc};
+  bench.run("homogeneous/mult", homogeneousMult);
+  HomogeneousInverse homogeneousInverse = {&aMb, &aMc};
+  bench.run("homogeneous/inverse", homogeneousInverse);
+  VelocityTwist velocityTwist = {&aMb, &aVb};
+  bench.run("velocityTwist/buildFrom", velocityTwist);
+
+  std::vector<vpMatrix> matrices;
+  matrices.push_back(randomMatrix(100, 6));
+  matrices.push_back(randomMatrix(1000, 6));
+  matrices.push_back(randomMatrix(64, 64));
+
+  vpMatrix Ap;
+  for (size_t i = 0; i < matrices.size(); i++) {
+    PseudoInverse pseudoInverse = {&matrices[i], &Ap, &vpMatrix::pseudoInverse};
+    bench.run("pseudoInverse/default/" + sizeName(matrices[i]), pseudoInverse);
+  }
+#if defined(VISP_HAVE_LAPACK)
+  runDecompositions(bench, "lapack", &vpMatrix::pseudoInverseLapack, &vpMatrix::svdLapack, matrices);
+#endif
+#if defined(VISP_HAVE_EIGEN3)
+  runDecompositions(bench, "eigen3", &vpMatrix::pseudoInverseEigen3, &vpMatrix::svdEigen3, matrices);
+#endif
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020101)
+  runDecompositions(bench, "opencv", &vpMatrix::pseudoInverseOpenCV, &vpMatrix::svdOpenCV, matrices);
+#endif
+#if defined(VISP_HAVE_GSL)
+  runDecompositions(bench, "gsl", &vpMatrix::pseudoInverseGsl, &vpMatrix::svdGsl, matrices);
+#endif
+
+  return bench.finish();
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the native pyramidal KLT tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchKltTracker.cpp
+
+  Benchmark of vpKltTracker corner detection and pyramidal tracking on a
+  synthetic textured image.
+*/
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/klt/vpKltTracker.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+struct Detect {
+  const vpImage<unsigned char> *I;
+  vpKltTracker *klt;
+  void operator()() { klt->initTracking(*I); }
+};
+
+// Features are tracked back and forth between two images, so that each call
+// builds the pyramid of one new image
+struct Track {
+  const vpImage<unsigned char> *I[2];
+  vpKltTracker *klt;
+  unsigned int frame;
+  void operator()() { klt->track(*I[frame++ % 2]); }
+};
+
+void generate(double tu, double tv, vpImage<unsigned char> &I)
+{
+  vpUniRand rand(7);
+  vpImage<double> acc(480, 640, 128.);
+  for (unsigned int b = 0; b < 400; b++) {
+    const double u0 = 640 * rand() + tu, v0 = 480 * rand() + tv, sigma = 2.5 + 4 * rand();
+    const double amplitude = rand() < 0.5 ? -80. : 80.;
+    const int imin = std::max(0, (int)(v0 - 4 * sigma)), imax = std::min(479, (int)(v0 + 4 * sigma));
+    const int jmin = std::max(0, (int)(u0 - 4 * sigma)), jmax = std::min(639, (int)(u0 + 4 * sigma));
+    for (int i = imin; i <= imax; i++) {
+      for (int j = jmin; j <= jmax; j++) {
+        const double d2 = (j - u0) * (j - u0) + (i - v0) * (i - v0);
+        acc[i][j] += amplitude * exp(-d2 / (2 * sigma * sigma));
+      }
+    }
+  }
+  I.resize(acc.getHeight(), acc.getWidth());
+  for (unsigned int i = 0; i < acc.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)std::max(0., std::min(255., acc.bitmap[i]));
+  }
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchKltTracker");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  vpImage<unsigned char> I0, I1;
+  generate(0., 0., I0);
+  generate(1.6, -0.8, I1);
+
+  vpKltTracker klt;
+  klt.setMaxFeatures(300);
+  klt.setWindowSize(11);
+  klt.setMinDistance(12);
+  klt.setUseHarris(0);
+  klt.setPyramidLevels(3);
+
+  Detect detect = {&I0, &klt};
+  bench.run("vpKltTracker/initTracking/640x480", detect);
+
+  klt.initTracking(I0);
+  Track track = {{&I1, &I0}, &klt, 0};
+  bench.run("vpKltTracker/track/640x480", track, (double)klt.getNbFeatures(), "feature");
+
+  return bench.finish();
+}
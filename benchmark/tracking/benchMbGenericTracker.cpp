@@ -0,0 +1,253 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of vpMbGenericTracker::loadModel() and track() on the teabox model.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchMbGenericTracker.cpp
+
+  Benchmark of vpMbGenericTracker::loadModel() with and without the model
+  cache, and of vpMbGenericTracker::track() with the teabox model, on
+  synthetic grey level and depth images rendered at the tracked pose.
+*/
+
+#include <map>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPolygon.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+/*
+  Render the teabox of teabox.cao, a 0.165 x 0.068 x 0.08 m box, with one
+  grey level per face, and the corresponding point cloud.
+*/
+void renderTeabox(const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo, vpImage<unsigned char> &I,
+                  std::vector<vpColVector> &pointcloud)
+{
+  const double X[8][3] = {{0, 0, 0},         {0, 0, -0.08},         {0.165, 0, -0.08}, {0.165, 0, 0},
+                          {0.165, 0.068, 0}, {0.165, 0.068, -0.08}, {0, 0.068, -0.08}, {0, 0.068, 0}};
+  const int faces[6][4] = {{0, 1, 2, 3}, {1, 6, 5, 2}, {4, 5, 6, 7}, {0, 3, 4, 7}, {5, 4, 3, 2}, {0, 7, 6, 1}};
+
+  std::vector<vpColVector> cX(8, vpColVector(3));
+  vpColVector center(3, 0.);
+  for (int k = 0; k < 8; k++) {
+    vpColVector oX(4, 1.);
+    oX[0] = X[k][0];
+    oX[1] = X[k][1];
+    oX[2] = X[k][2];
+    vpColVector c = cMo * oX;
+    cX[k][0] = c[0];
+    cX[k][1] = c[1];
+    cX[k][2] = c[2];
+    center += cX[k] / 8.;
+  }
+
+  I.resize(480, 640, 30);
+  pointcloud.assign(I.getSize(), vpColVector(3, 0.));
+  for (int f = 0; f < 6; f++) {
+    // Outward normal and plane n.X = d, in the camera frame
+    vpColVector n = vpColVector::crossProd(cX[faces[f][1]] - cX[faces[f][0]], cX[faces[f][2]] - cX[faces[f][0]]);
+    n.normalize();
+    if (vpColVector::dotProd(n, cX[faces[f][0]] - center) < 0) {
+      n = -n;
+    }
+    const double d = vpColVector::dotProd(n, cX[faces[f][0]]);
+    if (d >= 0) {
+      continue; // Back face
+    }
+
+    std::vector<vpImagePoint> corners;
+    for (int k = 0; k < 4; k++) {
+      double u = 0., v = 0.;
+      vpMeterPixelConversion::convertPoint(cam, cX[faces[f][k]][0] / cX[faces[f][k]][2],
+                                           cX[faces[f][k]][1] / cX[faces[f][k]][2], u, v);
+      corners.push_back(vpImagePoint(v, u));
+    }
+    vpPolygon polygon(corners);
+    const vpRect bbox = polygon.getBoundingBox();
+    const unsigned char grey = (unsigned char)(90 + 30 * f);
+    for (int i = std::max(0, (int)bbox.getTop()); i <= std::min((int)I.getHeight() - 1, (int)bbox.getBottom()); i++) {
+      for (int j = std::max(0, (int)bbox.getLeft()); j <= std::min((int)I.getWidth() - 1, (int)bbox.getRight());
+           j++) {
+        if (polygon.isInside(vpImagePoint(i, j))) {
+          I[i][j] = grey;
+          const double x = (j - cam.get_u0()) / cam.get_px(), y = (i - cam.get_v0()) / cam.get_py();
+          const double Z = d / (n[0] * x + n[1] * y + n[2]);
+          vpColVector &P = pointcloud[i * I.getWidth() + j];
+          P[0] = x * Z;
+          P[1] = y * Z;
+          P[2] = Z;
+        }
+      }
+    }
+  }
+}
+
+struct LoadModel {
+  const std::string *model;
+  bool useModelCache;
+  void operator()()
+  {
+    vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER);
+    tracker.setUseModelCache(useModelCache);
+    tracker.loadModel(*model);
+  }
+};
+
+struct Track {
+  vpMbGenericTracker *tracker;
+  std::map<std::string, const vpImage<unsigned char> *> *images;
+  std::map<std::string, const std::vector<vpColVector> *> *pointclouds;
+  std::map<std::string, unsigned int> *widths, *heights;
+  void operator()() { tracker->track(*images, *pointclouds, *widths, *heights); }
+};
+
+void setup(vpMbGenericTracker &tracker, const std::string &model, const vpCameraParameters &cam)
+{
+  vpMe me;
+  me.setMaskSize(5);
+  me.setMaskNumber(180);
+  me.setRange(8);
+  me.setThreshold(10000);
+  me.setMu1(0.5);
+  me.setMu2(0.5);
+  me.setSampleStep(4);
+
+  std::vector<std::string> names = tracker.getCameraNames();
+  std::map<std::string, vpCameraParameters> cams;
+  std::map<std::string, std::string> models;
+  for (size_t i = 0; i < names.size(); i++) {
+    cams[names[i]] = cam;
+    models[names[i]] = model;
+  }
+  tracker.setCameraParameters(cams);
+  tracker.setMovingEdge(me);
+  tracker.setDepthDenseSamplingStep(4, 4);
+  tracker.setDepthNormalSamplingStep(4, 4);
+  tracker.setAngleAppear(vpMath::rad(70));
+  tracker.setAngleDisappear(vpMath::rad(80));
+  tracker.loadModel(models);
+}
+
+void runTracker(vpBenchmark &bench, const std::string &name, vpMbGenericTracker &tracker, const std::string &model,
+                const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo, const vpImage<unsigned char> &I,
+                const std::vector<vpColVector> &pointcloud)
+{
+  setup(tracker, model, cam);
+  std::map<std::string, const vpImage<unsigned char> *> images;
+  std::map<std::string, const std::vector<vpColVector> *> pointclouds;
+  std::map<std::string, unsigned int> widths, heights;
+  std::map<std::string, vpHomogeneousMatrix> poses;
+  std::vector<std::string> names = tracker.getCameraNames();
+  for (size_t i = 0; i < names.size(); i++) {
+    images[names[i]] = &I;
+    pointclouds[names[i]] = &pointcloud;
+    widths[names[i]] = I.getWidth();
+    heights[names[i]] = I.getHeight();
+    poses[names[i]] = cMo;
+  }
+  tracker.initFromPose(images, poses);
+
+  Track track = {&tracker, &images, &pointclouds, &widths, &heights};
+  bench.run(name, track, (double)names.size(), "frame");
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchMbGenericTracker");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  std::string model = vpIoTools::createFilePath(vpIoTools::getParent(argv[0]), "teabox.cao");
+  if (!vpIoTools::checkFilename(model)) {
+    model = "teabox.cao";
+  }
+
+  try {
+    const vpCameraParameters cam(600, 600, 320, 240);
+    const vpHomogeneousMatrix cMo(-0.08, -0.03, 0.45, vpMath::rad(-30), vpMath::rad(35), vpMath::rad(10));
+    vpImage<unsigned char> I;
+    std::vector<vpColVector> pointcloud;
+    renderTeabox(cam, cMo, I, pointcloud);
+
+    // The first run with the cache writes it next to the model
+    LoadModel parse = {&model, false}, cached = {&model, true};
+    bench.run("loadModel/parse", parse, 1., "model");
+    bench.run("loadModel/cache", cached, 1., "model");
+
+    {
+      vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER);
+      runTracker(bench, "track/edge/640x480", tracker, model, cam, cMo, I, pointcloud);
+    }
+    for (int zbuffer = 0; zbuffer < 2; zbuffer++) {
+      vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER);
+      tracker.setScanLineVisibilityTest(true);
+      tracker.setZBufferVisibilityTest(zbuffer == 1);
+      runTracker(bench, zbuffer ? "track/edge+depthDense/zbuffer/640x480" : "track/edge+depthDense/scanline/640x480",
+                 tracker, model, cam, cMo, I, pointcloud);
+    }
+    for (int parallel = 0; parallel < 2; parallel++) {
+      vpMbGenericTracker tracker(2, vpMbGenericTracker::EDGE_TRACKER);
+      tracker.setUseParallelTracking(parallel == 1);
+      runTracker(bench, parallel ? "track/edge/stereo/parallel/640x480" : "track/edge/stereo/sequential/640x480",
+                 tracker, model, cam, cMo, I, pointcloud);
+    }
+    {
+      vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER);
+      runTracker(bench, "track/edge+depthDense/640x480", tracker, model, cam, cMo, I, pointcloud);
+    }
+    {
+      vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_NORMAL_TRACKER);
+      runTracker(bench, "track/edge+depthNormal/640x480", tracker, model, cam, cMo, I, pointcloud);
+    }
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    {
+      vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::KLT_TRACKER);
+      runTracker(bench, "track/edge+klt/640x480", tracker, model, cam, cMo, I, pointcloud);
+    }
+#endif
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getStringMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return bench.finish();
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the moving-edges tracking.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchMeSite.cpp
+
+  Benchmark of the moving-edges tracking, site by site and along a line, on a
+  synthetic image.
+*/
+
+#include <vector>
+
+#include <visp3/me/vpMeLine.h>
+#include <visp3/me/vpMeSite.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+// The sites are reset to their initial position before each search
+struct TrackSites {
+  const vpImage<unsigned char> *I;
+  const vpMe *me;
+  const std::vector<vpMeSite> *init;
+  std::vector<vpMeSite> *sites;
+  void operator()()
+  {
+    *sites = *init;
+    for (size_t i = 0; i < sites->size(); i++) {
+      (*sites)[i].track(*I, me, true);
+    }
+  }
+};
+
+struct TrackLine {
+  const vpImage<unsigned char> *I;
+  vpMeLine *line;
+  void operator()() { line->track(*I); }
+};
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchMeSite");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  // Oblique step edge, j = 0.5 i + 200, smoothed over a few pixels
+  vpImage<unsigned char> I(480, 640);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double d = (double)j - (0.5 * i + 200.);
+      I[i][j] = (unsigned char)(60 + 140 / (1 + exp(-d / 1.5)));
+    }
+  }
+
+  vpMe me;
+  me.setRange(10);
+  me.setThreshold(5000);
+  me.setPointsToTrack(200);
+
+  // Sites 2 pixels away from the edge, searched along its normal
+  const double alpha = atan2(-1., 0.5);
+  std::vector<vpMeSite> init;
+  for (unsigned int i = 20; i < 460; i++) {
+    vpMeSite site;
+    site.init(i, 0.5 * i + 202., alpha);
+    site.track(I, &me, false);
+    init.push_back(site);
+  }
+  std::vector<vpMeSite> sites;
+  TrackSites trackSites = {&I, &me, &init, &sites};
+  bench.run("vpMeSite/track/440sites", trackSites, (double)init.size(), "site");
+
+  vpMeLine line;
+  line.setMe(&me);
+  line.initTracking(I, vpImagePoint(40, 220), vpImagePoint(440, 420));
+  TrackLine trackLine = {&I, &line};
+  bench.run("vpMeLine/track/640x480", trackLine);
+
+  return bench.finish();
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the mutual information template tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchTemplateTrackerMI.cpp
+
+  Benchmark of vpTemplateTrackerMIInverseCompositional with an homography
+  warp for several numbers of histogram bins, on a synthetic textured image
+  whose intensities are transformed to emulate an illumination change.
+*/
+
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIInverseCompositional.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+// Each call tracks the template from the same initial parameters, so that
+// the number of iterations does not depend on the previous calls
+struct Track {
+  const vpImage<unsigned char> *I;
+  vpTemplateTrackerMI *tracker;
+  vpColVector p0;
+  void operator()()
+  {
+    tracker->setp(p0);
+    tracker->track(*I);
+  }
+};
+
+void generate(double scale, double tu, double tv, double gain, double offset, vpImage<unsigned char> &I)
+{
+  I.resize(480, 640);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      const double u = (1 + scale) * j + tu, v = (1 + scale) * i + tv;
+      const double g = 127.5 + 50 * sin(u / 9.) * cos(v / 13.) + 40 * sin((u + v) / 21.) + 20 * cos(u * v / 3000.);
+      I[i][j] = (unsigned char)std::max(0., std::min(255., gain * g + offset));
+    }
+  }
+}
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchTemplateTrackerMI");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  vpImage<unsigned char> I0, I1;
+  generate(0., 0., 0., 1., 0., I0);
+  generate(0.006, 2.4, -1.4, 0.8, 30., I1);
+
+  // Two triangles covering a 200x200 template
+  std::vector<vpImagePoint> corners;
+  corners.push_back(vpImagePoint(140, 220));
+  corners.push_back(vpImagePoint(140, 420));
+  corners.push_back(vpImagePoint(340, 420));
+  corners.push_back(vpImagePoint(140, 220));
+  corners.push_back(vpImagePoint(340, 420));
+  corners.push_back(vpImagePoint(340, 220));
+
+  const unsigned int nbIterations = 10;
+  const unsigned int nbBins[] = {8, 16, 32, 64};
+  for (unsigned int k = 0; k < sizeof(nbBins) / sizeof(nbBins[0]); k++) {
+    vpTemplateTrackerWarpHomographySL3 warp;
+    vpTemplateTrackerMIInverseCompositional tracker(&warp);
+    tracker.setSampling(2, 2);
+    tracker.setLambda(0.001);
+    tracker.setIterationMax(nbIterations);
+    tracker.setNc((int)nbBins[k]);
+    tracker.initFromPoints(I0, corners);
+
+    Track track = {&I1, &tracker, tracker.getp()};
+    std::ostringstream name;
+    name << "vpTemplateTrackerMIInverseCompositional/track/Nc" << nbBins[k];
+    bench.run(name.str(), track);
+  }
+
+  return bench.finish();
+}
@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of vpKeyPoint detection, extraction and matching.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchKeyPoint.cpp
+
+  Benchmark of vpKeyPoint detection, description and matching with ORB
+  features on a synthetic textured image.
+*/
+
+#include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpKeyPoint.h>
+
+#include "vpBenchmark.h"
+
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020400)
+
+namespace
+{
+double uniform(vpUniRand &rand, double a, double b) { return a + (b - a) * rand(); }
+
+// Random rectangles and noise give ORB enough corners to work with
+void generateTexture(vpImage<unsigned char> &I, unsigned int seed)
+{
+  vpUniRand rand(seed);
+  I.resize(480, 640, 128);
+  for (int k = 0; k < 400; k++) {
+    const int top = (int)uniform(rand, 0, 460), left = (int)uniform(rand, 0, 620);
+    const int h = (int)uniform(rand, 5, 40), w = (int)uniform(rand, 5, 40);
+    const unsigned char grey = (unsigned char)uniform(rand, 0, 255);
+    for (int i = top; i < std::min(top + h, 480); i++) {
+      for (int j = left; j < std::min(left + w, 640); j++) {
+        I[i][j] = grey;
+      }
+    }
+  }
+}
+
+void addNoise(vpImage<unsigned char> &I)
+{
+  vpGaussRand noise(3., 0., 1234);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)vpMath::saturate<unsigned char>(I.bitmap[i] + noise());
+  }
+}
+
+struct Detect {
+  vpKeyPoint *keypoint;
+  const vpImage<unsigned char> *I;
+  void operator()()
+  {
+    std::vector<cv::KeyPoint> keypoints;
+    keypoint->detect(*I, keypoints);
+  }
+};
+
+struct Extract {
+  vpKeyPoint *keypoint;
+  const vpImage<unsigned char> *I;
+  std::vector<cv::KeyPoint> keypoints;
+  void operator()()
+  {
+    std::vector<cv::KeyPoint> kpts = keypoints;
+    cv::Mat descriptors;
+    keypoint->extract(*I, kpts, descriptors);
+  }
+};
+
+struct Match {
+  vpKeyPoint *keypoint;
+  cv::Mat train, query;
+  void operator()()
+  {
+    std::vector<cv::DMatch> matches;
+    double elapsed;
+    keypoint->match(train, query, matches, elapsed);
+  }
+};
+
+struct MatchPoint {
+  vpKeyPoint *keypoint;
+  const vpImage<unsigned char> *I;
+  void operator()() { keypoint->matchPoint(*I); }
+};
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchKeyPoint");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  try {
+    vpImage<unsigned char> Iref, Icur;
+    generateTexture(Iref, 42);
+    Icur = Iref;
+    addNoise(Icur);
+
+    vpKeyPoint keypoint("ORB", "ORB", "BruteForce-Hamming");
+    Detect detect = {&keypoint, &Icur};
+    bench.run("detect/ORB/640x480", detect, (double)Icur.getSize(), "pixel");
+
+    Extract extract;
+    extract.keypoint = &keypoint;
+    extract.I = &Icur;
+    keypoint.detect(Icur, extract.keypoints);
+    bench.run("extract/ORB/640x480", extract, (double)extract.keypoints.size(), "keypoint");
+
+    Match match;
+    match.keypoint = &keypoint;
+    std::vector<cv::KeyPoint> keypoints;
+    keypoint.detect(Iref, keypoints);
+    keypoint.extract(Iref, keypoints, match.train);
+    keypoint.detect(Icur, keypoints);
+    keypoint.extract(Icur, keypoints, match.query);
+    bench.run("match/BruteForce-Hamming", match, (double)match.query.rows, "keypoint");
+
+    keypoint.buildReference(Iref);
+    MatchPoint matchPoint = {&keypoint, &Icur};
+    bench.run("matchPoint/ORB/640x480", matchPoint, (double)Icur.getSize(), "pixel");
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getStringMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return bench.finish();
+}
+
+#else
+int main()
+{
+  std::cout << "vpKeyPoint benchmarks need OpenCV 2.4 or higher." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the RANSAC pose and homography estimations.
+ *
+ *****************************************************************************/
+
+/*!
+  \example benchPoseRansac.cpp
+
+  Benchmark of vpPose RANSAC and vpHomography::ransac() on synthetic
+  correspondences with outliers.
+*/
+
+#include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpHomography.h>
+#include <visp3/vision/vpPose.h>
+
+#include "vpBenchmark.h"
+
+namespace
+{
+double uniform(vpUniRand &rand, double a, double b) { return a + (b - a) * rand(); }
+
+/*
+  Generate nb points in a 0.4 x 0.4 x 0.2 m volume (planar if requested) seen
+  at cMo, with pixel noise and a ratio of outliers.
+*/
+std::vector<vpPoint> generatePoints(unsigned int nb, double outlierRatio, bool planar, const vpHomogeneousMatrix &cMo)
+{
+  vpUniRand rand(42);
+  vpGaussRand noise(0.5 / 600., 0., 4242);
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < nb; i++) {
+    vpPoint P(uniform(rand, -0.2, 0.2), uniform(rand, -0.2, 0.2), planar ? 0. : uniform(rand, -0.1, 0.1));
+    P.project(cMo);
+    if (i < outlierRatio * nb) {
+      P.set_x(uniform(rand, -0.5, 0.5));
+      P.set_y(uniform(rand, -0.4, 0.4));
+    } else {
+      P.set_x(P.get_x() + noise());
+      P.set_y(P.get_y() + noise());
+    }
+    points.push_back(P);
+  }
+  return points;
+}
+
+struct PoseRansac {
+  const std::vector<vpPoint> *points;
+  vpPose::vpPoseMethodType hypothesis;
+  bool sprt;
+  bool parallel;
+  void operator()()
+  {
+    vpPose pose;
+    pose.addPoints(*points);
+    pose.setRansacNbInliersToReachConsensus((unsigned int)(0.6 * points->size()));
+    pose.setRansacThreshold(2. / 600.);
+    pose.setRansacMaxTrials(1000);
+    pose.setRansacHypothesisMethod(hypothesis);
+    pose.setUseRansacSPRT(sprt);
+    pose.setUseParallelRansac(parallel);
+    vpHomogeneousMatrix cMo;
+    pose.computePose(vpPose::RANSAC, cMo);
+  }
+};
+
+struct HomographyRansac {
+  std::vector<double> xb, yb, xa, ya;
+  void operator()()
+  {
+    vpHomography aHb;
+    std::vector<bool> inliers;
+    double residual;
+    vpHomography::ransac(xb, yb, xa, ya, aHb, inliers, residual, (unsigned int)(0.6 * xa.size()), 2. / 600.);
+  }
+};
+}
+
+int main(int argc, const char **argv)
+{
+  vpBenchmark bench("benchPoseRansac");
+  if (!bench.parseOptions(argc, argv)) {
+    return EXIT_SUCCESS;
+  }
+
+  try {
+    const vpHomogeneousMatrix cMo(0.05, -0.02, 1., vpMath::rad(10), vpMath::rad(-20), vpMath::rad(5));
+    const unsigned int sizes[] = {50, 200, 1000};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      std::vector<vpPoint> points = generatePoints(sizes[s], 0.3, false, cMo);
+      std::stringstream suffix;
+      suffix << "/" << sizes[s] << "pts/30%";
+
+      PoseRansac pose = {&points, vpPose::DEMENTHON, false, false};
+      bench.run("poseRansac/dementhon" + suffix.str(), pose, (double)sizes[s], "point");
+      pose.hypothesis = vpPose::P3P;
+      bench.run("poseRansac/p3p" + suffix.str(), pose, (double)sizes[s], "point");
+      pose.sprt = true;
+      bench.run("poseRansac/p3p/sprt" + suffix.str(), pose, (double)sizes[s], "point");
+      pose.parallel = true;
+      bench.run("poseRansac/p3p/sprt/parallel" + suffix.str(), pose, (double)sizes[s], "point");
+
+      std::vector<vpPoint> planar = generatePoints(sizes[s], 0.3, true, cMo);
+      HomographyRansac homography;
+      for (size_t i = 0; i < planar.size(); i++) {
+        homography.xb.push_back(planar[i].get_oX());
+        homography.yb.push_back(planar[i].get_oY());
+        homography.xa.push_back(planar[i].get_x());
+        homography.ya.push_back(planar[i].get_y());
+      }
+      bench.run("homographyRansac" + suffix.str(), homography, (double)sizes[s], "point");
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getStringMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return bench.finish();
+}
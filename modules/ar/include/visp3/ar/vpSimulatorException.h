@@ -87,6 +87,9 @@ public:
   vpSimulatorException(const int id, const char *format, ...);
   vpSimulatorException(const int id, const std::string &msg);
   explicit vpSimulatorException(const int id);
+
+  vpException *clone() const { return new vpSimulatorException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
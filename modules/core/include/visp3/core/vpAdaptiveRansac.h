@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Adaptive RANSAC with PROSAC sampling and SPRT verification.
+ *
+ *****************************************************************************/
+
+#ifndef _vpAdaptiveRansac_h_
+#define _vpAdaptiveRansac_h_
+
+/*!
+  \file vpAdaptiveRansac.h
+  \brief Adaptive RANSAC engine shared by the robust estimators.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpAdaptiveRansac
+  \ingroup group_core_robust
+
+  \brief Generic RANSAC engine that stops as soon as enough trials were
+  drawn for the current inlier ratio.
+
+  The model to estimate is described by a vpAdaptiveRansac::vpModelEstimator
+  that computes the model hypotheses from minimal samples of data and the
+  error of a datum with respect to a model. The engine then:
+  - updates the number of trials after each better consensus, so that an
+  outlier free sample is drawn with the probability set by setProbability()
+  (see \cite Hartley01a), without exceeding setMaxTrials();
+  - optionally draws the samples following the PROSAC scheme \cite Chum05a
+  when qualities of the data are given with setQualities(): the best data
+  are sampled first, the sampling progressively becoming uniform;
+  - optionally verifies the hypotheses with the sequential probability ratio
+  test (SPRT) of \cite Matas05a enabled with setUseSPRT(): a model is
+  rejected as soon as the data checked so far make it unlikely to be good,
+  without computing the error of all the data;
+  - optionally runs the trials in parallel on vpThreadPool, each task
+  drawing its samples with its own random generator and sharing the trial
+  counter and the best model found so far.
+
+  The following example fits a 2D line \f$ a x + b y + c = 0 \f$:
+  \code
+#include <visp3/core/vpAdaptiveRansac.h>
+
+class LineEstimator : public vpAdaptiveRansac::vpModelEstimator
+{
+public:
+  LineEstimator(const std::vector<double> &x, const std::vector<double> &y) : m_x(x), m_y(y) {}
+  unsigned int getNbData() const { return (unsigned int)m_x.size(); }
+  unsigned int getSampleSize() const { return 2; }
+  void computeModels(const std::vector<unsigned int> &s, std::vector<vpColVector> &models) const
+  {
+    vpColVector line(3);
+    line[0] = m_y[s[0]] - m_y[s[1]];
+    line[1] = m_x[s[1]] - m_x[s[0]];
+    line[2] = -line[0] * m_x[s[0]] - line[1] * m_y[s[0]];
+    double n = sqrt(line[0] * line[0] + line[1] * line[1]);
+    if (n > 0) {
+      models.push_back(line / n);
+    }
+  }
+  double computeError(const vpColVector &line, unsigned int i) const
+  {
+    return fabs(line[0] * m_x[i] + line[1] * m_y[i] + line[2]);
+  }
+
+private:
+  const std::vector<double> &m_x, &m_y;
+};
+
+int main()
+{
+  std::vector<double> x, y;
+  // ... fill the data
+  vpAdaptiveRansac ransac;
+  ransac.setThreshold(0.01);
+  vpColVector line;
+  std::vector<unsigned int> inliers;
+  ransac.estimate(LineEstimator(x, y), line, inliers);
+}
+  \endcode
+
+  \sa vpPose::poseRansac(), vpHomography::ransac()
+*/
+class VISP_EXPORT vpAdaptiveRansac
+{
+public:
+  /*!
+    \class vpModelEstimator
+
+    Interface of the models estimated by vpAdaptiveRansac. When the trials
+    run in parallel, the const functions are called concurrently.
+  */
+  class VISP_EXPORT vpModelEstimator
+  {
+  public:
+    virtual ~vpModelEstimator() {}
+
+    //! Number of data.
+    virtual unsigned int getNbData() const = 0;
+    //! Size of the minimal samples.
+    virtual unsigned int getSampleSize() const = 0;
+    /*!
+      Return false if the sample is degenerate: another sample is then
+      drawn.
+    */
+    virtual bool isSampleValid(const std::vector<unsigned int> &sample) const
+    {
+      (void)sample;
+      return true;
+    }
+    /*!
+      Append to \e models the hypotheses computed from a minimal sample, if
+      any.
+    */
+    virtual void computeModels(const std::vector<unsigned int> &sample, std::vector<vpColVector> &models) const = 0;
+    //! Error of the datum \e index with respect to the model.
+    virtual double computeError(const vpColVector &model, unsigned int index) const = 0;
+    /*!
+      Return false if the datum \e index, whose error is below the threshold,
+      must not be counted in the consensus set \e inliers, for instance
+      because it duplicates one of them.
+    */
+    virtual bool isInlierValid(const std::vector<unsigned int> &inliers, unsigned int index) const
+    {
+      (void)inliers;
+      (void)index;
+      return true;
+    }
+  };
+
+  vpAdaptiveRansac();
+
+  bool estimate(const vpModelEstimator &estimator, vpColVector &model, std::vector<unsigned int> &inliers);
+
+  //! Number of trials performed by the last call to estimate().
+  inline unsigned int getNbTrials() const { return m_nbTrials; }
+  //! Maximum number of trials.
+  inline unsigned int getMaxTrials() const { return m_maxTrials; }
+  //! Number of inliers that stops the search, 0 if disabled.
+  inline unsigned int getNbInliersToReachConsensus() const { return m_nbInliersConsensus; }
+  //! Number of threads, 0 for the number of threads of the shared vpThreadPool.
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+  //! Probability to draw at least one outlier free sample.
+  inline double getProbability() const { return m_probability; }
+  //! Quality of the data used by PROSAC, empty for uniform sampling.
+  inline const std::vector<double> &getQualities() const { return m_qualities; }
+  //! Threshold on the error of an inlier.
+  inline double getThreshold() const { return m_threshold; }
+  //! True if the hypotheses are verified with SPRT.
+  inline bool getUseSPRT() const { return m_useSPRT; }
+
+  /*!
+    Set the maximum number of trials, reached only if the inlier ratio is
+    too low for the desired probability.
+  */
+  inline void setMaxTrials(const unsigned int maxTrials) { m_maxTrials = maxTrials; }
+  /*!
+    Stop as soon as a model with \e nbInliers inliers is found. 0 (default)
+    to only rely on the adaptive number of trials.
+  */
+  inline void setNbInliersToReachConsensus(const unsigned int nbInliers) { m_nbInliersConsensus = nbInliers; }
+  /*!
+    Set the number of threads: 0 for the number of threads of
+    vpThreadPool::getInstance(), 1 (default) for a sequential execution.
+  */
+  inline void setNbThreads(const unsigned int nbThreads) { m_nbThreads = nbThreads; }
+  void setProbability(const double probability);
+  void setQualities(const std::vector<double> &qualities);
+  /*!
+    Set the seed of the random generators. The generator of the i-th task
+    uses seed + i.
+  */
+  inline void setSeed(const long seed) { m_seed = seed; }
+  void setThreshold(const double threshold);
+  /*!
+    Verify the hypotheses with the sequential probability ratio test.
+  */
+  inline void setUseSPRT(const bool useSPRT) { m_useSPRT = useSPRT; }
+
+  static unsigned int computeNbTrials(double probability, double inlierRatio, unsigned int sampleSize,
+                                      unsigned int maxTrials);
+
+private:
+  unsigned int m_maxTrials;
+  unsigned int m_nbInliersConsensus;
+  unsigned int m_nbThreads;
+  unsigned int m_nbTrials;
+  double m_probability;
+  std::vector<double> m_qualities;
+  long m_seed;
+  double m_threshold;
+  bool m_useSPRT;
+};
+
+#endif
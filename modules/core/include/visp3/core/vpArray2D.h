@@ -78,6 +78,8 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! True if data and rowPtrs are heap allocated and released by the array
+  bool ownData;
 
 public:
   //! Address of the first element of the data array
@@ -88,11 +90,11 @@ public:
   Basic constructor of a 2D array.
   Number of columns and rows are set to zero.
   */
-  vpArray2D<Type>() : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL) {}
+  vpArray2D<Type>() : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL) {}
   /*!
   Copy constructor of a 2D array.
   */
-  vpArray2D<Type>(const vpArray2D<Type> &A) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(const vpArray2D<Type> &A) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(A.rowNum, A.colNum, false, false);
     memcpy(data, A.data, rowNum * colNum * sizeof(Type));
@@ -103,7 +105,7 @@ public:
   \param r : Array number of rows.
   \param c : Array number of columns.
   */
-  vpArray2D<Type>(unsigned int r, unsigned int c) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(unsigned int r, unsigned int c) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(r, c);
   }
@@ -114,7 +116,7 @@ public:
   \param c : Array number of columns.
   \param val : Each element of the array is set to \e val.
   */
-  vpArray2D<Type>(unsigned int r, unsigned int c, Type val) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(unsigned int r, unsigned int c, Type val) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(r, c, false, false);
     *this = val;
@@ -124,15 +126,16 @@ public:
   */
   virtual ~vpArray2D<Type>()
   {
-    if (data != NULL) {
-      free(data);
-      data = NULL;
-    }
-
-    if (rowPtrs != NULL) {
-      free(rowPtrs);
-      rowPtrs = NULL;
+    if (ownData) {
+      if (data != NULL) {
+        free(data);
+      }
+      if (rowPtrs != NULL) {
+        free(rowPtrs);
+      }
     }
+    data = NULL;
+    rowPtrs = NULL;
     rowNum = colNum = dsize = 0;
   }
 
@@ -167,6 +170,9 @@ public:
   Default value is true.
   \param recopy_ : if true, will perform an explicit recopy of the old data
   if needed and if flagNullify is set to false.
+
+  \exception vpException::dimensionError : If the array is stored in
+  fixed-size memory, see vpFixedMatrix, and the dimensions differ.
   */
   void resize(const unsigned int nrows, const unsigned int ncols, const bool flagNullify = true,
               const bool recopy_ = true)
@@ -176,6 +182,13 @@ public:
         memset(this->data, 0, this->dsize * sizeof(Type));
       }
     } else {
+      if (!ownData) {
+        // The storage provided by a fixed-size derived class cannot hold
+        // other dimensions
+        throw(vpException(vpException::dimensionError, "Cannot resize a (%dx%d) fixed-size array to (%dx%d)",
+                          rowNum, colNum, nrows, ncols));
+      }
+
       bool recopy = !flagNullify && recopy_; // priority to flagNullify
       const bool recopyNeeded = (ncols != this->colNum && this->colNum > 0 && ncols > 0 && (!flagNullify || recopy));
       Type *copyTmp = NULL;
@@ -645,6 +658,26 @@ public:
     return true;
   }
   //@}
+
+protected:
+  /*!
+  Constructor of a 2D array stored in memory owned by a derived class,
+  typically fixed-size member arrays, that is never freed nor reallocated
+  by vpArray2D. Resizing such an array to other dimensions, including by
+  assigning an array of another size, throws vpException::dimensionError.
+
+  \param r : Array number of rows.
+  \param c : Array number of columns.
+  \param buffer : Storage for the r*c elements.
+  \param rowBuffer : Storage for the r row pointers.
+  */
+  vpArray2D<Type>(unsigned int r, unsigned int c, Type *buffer, Type **rowBuffer)
+    : rowNum(r), colNum(c), rowPtrs(rowBuffer), dsize(r * c), ownData(false), data(buffer)
+  {
+    for (unsigned int i = 0; i < r; i++) {
+      rowPtrs[i] = data + i * c;
+    }
+  }
 };
 
 /*!
@@ -70,6 +70,7 @@ VISP_EXPORT bool checkSSE41();
 VISP_EXPORT bool checkSSE42();
 VISP_EXPORT bool checkAVX();
 VISP_EXPORT bool checkAVX2();
+VISP_EXPORT bool checkFMA();
 VISP_EXPORT void printCPUInfo();
 }
 
@@ -40,6 +40,7 @@
 #define vpColVector_H
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpPoseVector.h>
 #include <visp3/core/vpRotationVector.h>
@@ -98,6 +99,8 @@ public:
   vpColVector(const vpMatrix &M, unsigned int j);
   vpColVector(const std::vector<double> &v);
   vpColVector(const std::vector<float> &v);
+  //! Constructor that initialize a column vector from a fixed-size one.
+  template <unsigned int N> vpColVector(const vpFixedColVector<N> &v) : vpArray2D<double>(v) {}
 #ifdef VISP_HAVE_CPP11_COMPATIBILITY
   vpColVector(vpColVector &&v);
 #endif
@@ -97,6 +97,9 @@ public:
   vpDisplayException(const int id, const std::string &msg) : vpException(id, msg) {}
 
   explicit vpDisplayException(const int id) : vpException(id) {}
+
+  vpException *clone() const { return new vpDisplayException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
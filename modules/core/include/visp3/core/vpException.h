@@ -111,6 +111,19 @@ public:
   */
   virtual ~vpException() throw() {}
 
+  /*!
+    Return a heap allocated copy of the exception that keeps its dynamic
+    type. Used to transport an exception from one thread to another.
+    Derived classes override it.
+  */
+  virtual vpException *clone() const { return new vpException(*this); }
+
+  /*!
+    Throw a copy of the exception with its dynamic type, as opposed to
+    `throw e` that slices it to the static type of \e e.
+  */
+  virtual void rethrow() const { throw *this; }
+
   /** @name Inherited functionalities from vpException */
   //@{
   //! Send the object code.
@@ -0,0 +1,386 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Fixed-size matrices and column vectors stored without heap allocation.
+ *
+ *****************************************************************************/
+#ifndef __vpFixedMatrix_h_
+#define __vpFixedMatrix_h_
+
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \file vpFixedMatrix.h
+  \brief Definition of fixed-size matrices and column vectors.
+*/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Storage of the elements and of the row pointers of a vpFixedMatrix. It is
+  its first base class, so that it is constructed before the vpArray2D base
+  that points to it.
+*/
+template <unsigned int R, unsigned int C> struct vpFixedMatrixStorage {
+  double m_buffer[R * C];
+  double *m_rowBuffer[R];
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  \class vpFixedMatrix
+  \ingroup group_core_matrices
+
+  \brief Matrix whose dimensions are known at compile time.
+
+  The R x C elements and the row pointers are stored inside the object, so
+  that creating, copying or returning such a matrix never allocates memory.
+  The loops of the arithmetic operators have compile-time bounds and are
+  completely unrolled by the compiler.
+
+  The class derives from vpArray2D<double> and can be used everywhere an
+  array is expected. A vpMatrix is built from it with vpMatrix(const
+  vpArray2D<double> &), and it can be built back from a vpMatrix of the same
+  size:
+  \code
+#include <visp3/core/vpFixedMatrix.h>
+#include <visp3/core/vpMatrix.h>
+
+int main()
+{
+  vpFixedMatrix<3, 3> A;
+  A.eye();
+  vpFixedMatrix<3, 2> B;
+  B[0][0] = 1; B[1][1] = 2; B[2][0] = 3;
+  vpFixedMatrix<3, 2> C = A * B; // No allocation
+
+  vpMatrix M = C;                // Conversion to a dynamic matrix
+  vpFixedMatrix<2, 3> D(M.t());  // And back, with a dimension check
+}
+  \endcode
+
+  vpRotationMatrix, vpHomogeneousMatrix, vpVelocityTwistMatrix,
+  vpForceTwistMatrix, vpTranslationVector and vpPoseVector are built on this
+  class.
+
+  The dimensions cannot change: resize(), or assigning an array of another
+  size through vpArray2D, throws vpException::dimensionError.
+*/
+template <unsigned int R, unsigned int C>
+class vpFixedMatrix : private vpFixedMatrixStorage<R, C>, public vpArray2D<double>
+{
+public:
+  //! Number of rows
+  static const unsigned int Rows = R;
+  //! Number of columns
+  static const unsigned int Cols = C;
+
+  /*!
+    Constructor that initializes the matrix with zeros.
+  */
+  vpFixedMatrix() : vpArray2D<double>(R, C, this->m_buffer, this->m_rowBuffer)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] = 0.;
+    }
+  }
+
+  /*!
+    Copy constructor.
+  */
+  vpFixedMatrix(const vpFixedMatrix<R, C> &M) : vpArray2D<double>(R, C, this->m_buffer, this->m_rowBuffer)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] = M.data[i];
+    }
+  }
+
+  /*!
+    Construct the matrix from an array of the same size, for instance a
+    vpMatrix.
+
+    \exception vpException::dimensionError : If \e A is not a R x C array.
+  */
+  explicit vpFixedMatrix(const vpArray2D<double> &A) : vpArray2D<double>(R, C, this->m_buffer, this->m_rowBuffer)
+  {
+    copyFrom(A);
+  }
+
+  virtual ~vpFixedMatrix() {}
+
+  /*!
+    Copy operator.
+  */
+  vpFixedMatrix<R, C> &operator=(const vpFixedMatrix<R, C> &M)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] = M.data[i];
+    }
+    return *this;
+  }
+
+  /*!
+    Copy the elements of an array of the same size, for instance a vpMatrix.
+
+    \exception vpException::dimensionError : If \e A is not a R x C array.
+  */
+  vpFixedMatrix<R, C> &operator=(const vpArray2D<double> &A)
+  {
+    copyFrom(A);
+    return *this;
+  }
+
+  //! Set all the elements to \e x.
+  vpFixedMatrix<R, C> &operator=(double x)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] = x;
+    }
+    return *this;
+  }
+
+  /*!
+    Set the matrix to identity, or to a rectangular identity if the matrix
+    is not square.
+  */
+  void eye()
+  {
+    for (unsigned int i = 0; i < R; i++) {
+      for (unsigned int j = 0; j < C; j++) {
+        data[i * C + j] = (i == j) ? 1. : 0.;
+      }
+    }
+  }
+
+  //! Return the transposed matrix.
+  vpFixedMatrix<C, R> t() const
+  {
+    vpFixedMatrix<C, R> At;
+    for (unsigned int i = 0; i < R; i++) {
+      for (unsigned int j = 0; j < C; j++) {
+        At.data[j * R + i] = data[i * C + j];
+      }
+    }
+    return At;
+  }
+
+  //! Matrix product of the R x C matrix with a C x K matrix.
+  template <unsigned int K> vpFixedMatrix<R, K> operator*(const vpFixedMatrix<C, K> &B) const
+  {
+    vpFixedMatrix<R, K> AB;
+    for (unsigned int i = 0; i < R; i++) {
+      for (unsigned int j = 0; j < K; j++) {
+        double s = 0.;
+        for (unsigned int k = 0; k < C; k++) {
+          s += data[i * C + k] * B.data[k * K + j];
+        }
+        AB.data[i * K + j] = s;
+      }
+    }
+    return AB;
+  }
+
+  //! Multiply all the elements by \e x.
+  vpFixedMatrix<R, C> operator*(double x) const
+  {
+    vpFixedMatrix<R, C> M;
+    for (unsigned int i = 0; i < R * C; i++) {
+      M.data[i] = data[i] * x;
+    }
+    return M;
+  }
+
+  //! Element-wise sum.
+  vpFixedMatrix<R, C> operator+(const vpFixedMatrix<R, C> &B) const
+  {
+    vpFixedMatrix<R, C> M;
+    for (unsigned int i = 0; i < R * C; i++) {
+      M.data[i] = data[i] + B.data[i];
+    }
+    return M;
+  }
+
+  //! Element-wise difference.
+  vpFixedMatrix<R, C> operator-(const vpFixedMatrix<R, C> &B) const
+  {
+    vpFixedMatrix<R, C> M;
+    for (unsigned int i = 0; i < R * C; i++) {
+      M.data[i] = data[i] - B.data[i];
+    }
+    return M;
+  }
+
+  //! Opposite of the matrix.
+  vpFixedMatrix<R, C> operator-() const
+  {
+    vpFixedMatrix<R, C> M;
+    for (unsigned int i = 0; i < R * C; i++) {
+      M.data[i] = -data[i];
+    }
+    return M;
+  }
+
+  //! Add \e B to the matrix.
+  vpFixedMatrix<R, C> &operator+=(const vpFixedMatrix<R, C> &B)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] += B.data[i];
+    }
+    return *this;
+  }
+
+  //! Subtract \e B from the matrix.
+  vpFixedMatrix<R, C> &operator-=(const vpFixedMatrix<R, C> &B)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] -= B.data[i];
+    }
+    return *this;
+  }
+
+  //! Multiply all the elements by \e x.
+  vpFixedMatrix<R, C> &operator*=(double x)
+  {
+    for (unsigned int i = 0; i < R * C; i++) {
+      data[i] *= x;
+    }
+    return *this;
+  }
+
+  //! Return the sum of the squared elements.
+  double sumSquare() const
+  {
+    double s = 0.;
+    for (unsigned int i = 0; i < R * C; i++) {
+      s += data[i] * data[i];
+    }
+    return s;
+  }
+
+private:
+  void copyFrom(const vpArray2D<double> &A)
+  {
+    if (A.getRows() != R || A.getCols() != C) {
+      throw(vpException(vpException::dimensionError, "Cannot copy a (%dx%d) array in a (%dx%d) fixed-size matrix",
+                        A.getRows(), A.getCols(), R, C));
+    }
+    if (A.data != data) {
+      for (unsigned int i = 0; i < R * C; i++) {
+        data[i] = A.data[i];
+      }
+    }
+  }
+};
+
+/*!
+  \class vpFixedColVector
+  \ingroup group_core_matrices
+
+  \brief Column vector whose dimension is known at compile time.
+
+  Like vpFixedMatrix, the elements are stored inside the object. As in
+  vpColVector, operator[] gives access to the elements.
+*/
+template <unsigned int N> class vpFixedColVector : public vpFixedMatrix<N, 1>
+{
+public:
+  //! Constructor that initializes the vector with zeros.
+  vpFixedColVector() : vpFixedMatrix<N, 1>() {}
+  //! Copy constructor.
+  vpFixedColVector(const vpFixedColVector<N> &v) : vpFixedMatrix<N, 1>(v) {}
+  //! Construct a vector from a N x 1 fixed-size matrix.
+  vpFixedColVector(const vpFixedMatrix<N, 1> &v) : vpFixedMatrix<N, 1>(v) {}
+  /*!
+    Construct the vector from an array of the same size, for instance a
+    vpColVector.
+
+    \exception vpException::dimensionError : If \e v is not a N x 1 array.
+  */
+  explicit vpFixedColVector(const vpArray2D<double> &v) : vpFixedMatrix<N, 1>(v) {}
+
+  vpFixedColVector<N> &operator=(const vpFixedColVector<N> &v)
+  {
+    vpFixedMatrix<N, 1>::operator=(v);
+    return *this;
+  }
+  vpFixedColVector<N> &operator=(const vpArray2D<double> &v)
+  {
+    vpFixedMatrix<N, 1>::operator=(v);
+    return *this;
+  }
+  vpFixedColVector<N> &operator=(double x)
+  {
+    vpFixedMatrix<N, 1>::operator=(x);
+    return *this;
+  }
+
+  //! Operator that allows to set a value of an element \f$v_i\f$: v[i] = x
+  inline double &operator[](unsigned int n) { return this->data[n]; }
+  //! Operator that allows to get the value of an element \f$x = v_i\f$: x = v[i]
+  inline const double &operator[](unsigned int n) const { return this->data[n]; }
+
+  //! Dot product of two vectors.
+  static double dotProd(const vpFixedColVector<N> &a, const vpFixedColVector<N> &b)
+  {
+    double s = 0.;
+    for (unsigned int i = 0; i < N; i++) {
+      s += a.data[i] * b.data[i];
+    }
+    return s;
+  }
+};
+
+/*!
+  Product of a R x C fixed-size matrix with a C dimension fixed-size column
+  vector.
+*/
+template <unsigned int R, unsigned int C>
+vpFixedColVector<R> operator*(const vpFixedMatrix<R, C> &A, const vpFixedColVector<C> &v)
+{
+  vpFixedColVector<R> Av;
+  for (unsigned int i = 0; i < R; i++) {
+    double s = 0.;
+    for (unsigned int k = 0; k < C; k++) {
+      s += A.data[i * C + k] * v.data[k];
+    }
+    Av.data[i] = s;
+  }
+  return Av;
+}
+
+//! Multiply all the elements of a fixed-size matrix by \e x.
+template <unsigned int R, unsigned int C> vpFixedMatrix<R, C> operator*(double x, const vpFixedMatrix<R, C> &A)
+{
+  return A * x;
+}
+
+#endif
@@ -41,6 +41,7 @@
 #define vpForceTwistMatrix_h
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpRotationMatrix.h>
@@ -50,7 +51,7 @@
 
   \ingroup group_core_transformations
 
-  This class derived from vpArray2D<double> implements the 6 by 6 matrix which
+  This class derived from vpFixedMatrix<6, 6> implements the 6 by 6 matrix which
 transforms force/torque from one frame to another. This matrix is also called
 force/torque twist transformation matrix.
 
@@ -112,7 +113,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpForceTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpForceTwistMatrix : public vpFixedMatrix<6, 6>
 {
 public:
   // basic constructor
@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Asynchronous frame acquisition.
+ *
+ *****************************************************************************/
+
+#ifndef __vpFrameGrabberAsync_h_
+#define __vpFrameGrabberAsync_h_
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpFrameGrabber.h>
+
+/*!
+  \file vpFrameGrabberAsync.h
+  \brief Acquisition of the images of a frame grabber in a background thread.
+*/
+
+/*!
+  \class vpFrameGrabberAsync
+
+  \ingroup group_core_threading
+
+  \brief Frame grabber that acquires the images of another frame grabber in
+  a background thread, so that capture, decoding and conversion overlap with
+  the processing of the previous images.
+
+  The images are acquired in a ring of preallocated buffers. acquire() does
+  not copy the image: it exchanges the buffer of the image passed as
+  argument with the one of the acquired frame, that is recycled for a next
+  capture. Once the images have the size of the frames, no memory is
+  allocated anymore.
+
+  When all the buffers are filled before being acquired, the queue policy
+  decides:
+  - DROP_OLDEST: the capture thread never waits and replaces the oldest
+    queued frame. acquire() returns the latest frame and drops the older
+    ones, which bounds the latency. This suits live cameras.
+  - BLOCK: the capture thread waits for a free buffer, and acquire() returns
+    the frames in their capture order without losing any of them. This suits
+    image sequences and video files.
+
+  If the wrapped grabber throws, for example at the end of a video, a copy
+  of the exception, with its type, is rethrown by acquire() once the queued
+  frames are consumed.
+
+  The wrapped grabber is opened and closed by this class, but it must not
+  be used directly while open. Without thread support (pthread or Windows
+  threads), the images are acquired synchronously by acquire().
+
+  \code
+#include <visp3/core/vpFrameGrabberAsync.h>
+#include <visp3/io/vpVideoReader.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpVideoReader reader;
+  reader.setFileName("video.mpeg");
+
+  vpFrameGrabberAsync g(reader, 4, vpFrameGrabberAsync::BLOCK);
+  g.open(I);
+  try {
+    while (true) {
+      double timestamp;
+      g.acquire(I, timestamp);
+      // Process I while the next frames are decoded
+    }
+  } catch (...) {
+    // End of the video
+  }
+  std::cout << g.getNbCapturedFrames() << " frames" << std::endl;
+}
+  \endcode
+
+  \sa vpThread, vpThreadPool
+*/
+class VISP_EXPORT vpFrameGrabberAsync : public vpFrameGrabber
+{
+public:
+  //! Behavior when no buffer is free to acquire a new frame
+  typedef enum {
+    DROP_OLDEST, //!< Replace the oldest frame; acquire() returns the latest one
+    BLOCK        //!< Wait for a free buffer; acquire() returns every frame in order
+  } vpQueuePolicy;
+
+  explicit vpFrameGrabberAsync(vpFrameGrabber &grabber, unsigned int bufferSize = 3,
+                               vpQueuePolicy policy = DROP_OLDEST);
+  virtual ~vpFrameGrabberAsync();
+
+  void open(vpImage<unsigned char> &I);
+  void open(vpImage<vpRGBa> &I);
+
+  void acquire(vpImage<unsigned char> &I);
+  void acquire(vpImage<vpRGBa> &I);
+  void acquire(vpImage<unsigned char> &I, double &timestamp);
+  void acquire(vpImage<vpRGBa> &I, double &timestamp);
+
+  void close();
+
+  unsigned int getBufferSize() const;
+  unsigned int getNbCapturedFrames() const;
+  unsigned int getNbDroppedFrames() const;
+  unsigned int getNbQueuedFrames() const;
+  vpQueuePolicy getQueuePolicy() const;
+
+private:
+  vpFrameGrabberAsync(const vpFrameGrabberAsync &);
+  vpFrameGrabberAsync &operator=(const vpFrameGrabberAsync &);
+
+  class Impl;
+  Impl *m_impl;
+};
+
+#endif
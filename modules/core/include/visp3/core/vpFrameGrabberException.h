@@ -89,6 +89,9 @@ public:
   }
   vpFrameGrabberException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpFrameGrabberException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpFrameGrabberException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif /* #ifndef __vpFrameGrabberException_H */
@@ -57,6 +57,7 @@ class vpPoint;
 #include <vector>
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpRotationMatrix.h>
 #include <visp3/core/vpThetaUVector.h>
 //#include <visp3/core/vpTranslationVector.h>
@@ -73,7 +74,8 @@ class vpPoint;
   The class provides a data structure for the homogeneous matrices
   as well as a set of operations on these matrices.
 
-  The vpHomogeneousMatrix class is derived from vpArray2D<double>.
+  The vpHomogeneousMatrix class is derived from vpFixedMatrix<4, 4> and is
+  stored without heap allocation.
 
   An homogeneous matrix is 4x4 matrix defines as
   \f[
@@ -89,7 +91,7 @@ class vpPoint;
   \f$ ^a{\bf t}_b \f$ is a translation vector.
 
 */
-class VISP_EXPORT vpHomogeneousMatrix : public vpArray2D<double>
+class VISP_EXPORT vpHomogeneousMatrix : public vpFixedMatrix<4, 4>
 {
 public:
   vpHomogeneousMatrix();
@@ -50,9 +50,7 @@
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpImagePoint.h>
 #include <visp3/core/vpRGBa.h>
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-#include <visp3/core/vpThread.h>
-#endif
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iomanip> // std::setw
@@ -478,145 +476,68 @@ inline std::ostream &operator<<(std::ostream &s, const vpImage<double> &I)
   return s;
 }
 
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace
 {
-struct ImageLut_Param_t {
-  unsigned int m_start_index;
-  unsigned int m_end_index;
-
-  unsigned char m_lut[256];
-  unsigned char *m_bitmap;
-
-  ImageLut_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {}
-
-  ImageLut_Param_t(const unsigned int start_index, const unsigned int end_index, unsigned char *bitmap)
-    : m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap)
-  {
-  }
-};
-
-vpThread::Return performLutThread(vpThread::Args args)
+class ImageLutBody : public vpThreadPool::vpParallelLoopBody
 {
-  ImageLut_Param_t *imageLut_param = static_cast<ImageLut_Param_t *>(args);
-  unsigned int start_index = imageLut_param->m_start_index;
-  unsigned int end_index = imageLut_param->m_end_index;
-
-  unsigned char *bitmap = imageLut_param->m_bitmap;
-
-  unsigned char *ptrStart = bitmap + start_index;
-  unsigned char *ptrEnd = bitmap + end_index;
-  unsigned char *ptrCurrent = ptrStart;
-
-  //    while(ptrCurrent != ptrEnd) {
-  //      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-  //      ++ptrCurrent;
-  //    }
-
-  if (end_index - start_index >= 8) {
-    // Unroll loop version
-    for (; ptrCurrent <= ptrEnd - 8;) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
+public:
+  ImageLutBody(unsigned char *bitmap, const unsigned char (&lut)[256]) : m_bitmap(bitmap), m_lut(lut) {}
 
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-      ++ptrCurrent;
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    unsigned char *ptrCurrent = m_bitmap + begin;
+    unsigned char *ptrEnd = m_bitmap + end;
+
+    if (end - begin >= 8) {
+      // Unroll loop version
+      for (; ptrCurrent <= ptrEnd - 8; ptrCurrent += 8) {
+        ptrCurrent[0] = m_lut[ptrCurrent[0]];
+        ptrCurrent[1] = m_lut[ptrCurrent[1]];
+        ptrCurrent[2] = m_lut[ptrCurrent[2]];
+        ptrCurrent[3] = m_lut[ptrCurrent[3]];
+        ptrCurrent[4] = m_lut[ptrCurrent[4]];
+        ptrCurrent[5] = m_lut[ptrCurrent[5]];
+        ptrCurrent[6] = m_lut[ptrCurrent[6]];
+        ptrCurrent[7] = m_lut[ptrCurrent[7]];
+      }
     }
-  }
 
-  for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
-    *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+    for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
+      *ptrCurrent = m_lut[*ptrCurrent];
+    }
   }
 
-  return 0;
-}
-
-struct ImageLutRGBa_Param_t {
-  unsigned int m_start_index;
-  unsigned int m_end_index;
-
-  vpRGBa m_lut[256];
+private:
   unsigned char *m_bitmap;
-
-  ImageLutRGBa_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {}
-
-  ImageLutRGBa_Param_t(const unsigned int start_index, const unsigned int end_index, unsigned char *bitmap)
-    : m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap)
-  {
-  }
+  const unsigned char (&m_lut)[256];
 };
 
-vpThread::Return performLutRGBaThread(vpThread::Args args)
+class ImageLutRGBaBody : public vpThreadPool::vpParallelLoopBody
 {
-  ImageLutRGBa_Param_t *imageLut_param = static_cast<ImageLutRGBa_Param_t *>(args);
-  unsigned int start_index = imageLut_param->m_start_index;
-  unsigned int end_index = imageLut_param->m_end_index;
-
-  unsigned char *bitmap = imageLut_param->m_bitmap;
+public:
+  ImageLutRGBaBody(unsigned char *bitmap, const vpRGBa (&lut)[256]) : m_bitmap(bitmap), m_lut(lut) {}
 
-  unsigned char *ptrStart = bitmap + start_index * 4;
-  unsigned char *ptrEnd = bitmap + end_index * 4;
-  unsigned char *ptrCurrent = ptrStart;
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    unsigned char *ptrCurrent = m_bitmap + begin * 4;
+    unsigned char *ptrEnd = m_bitmap + end * 4;
 
-  if (end_index - start_index >= 4 * 2) {
-    // Unroll loop version
-    for (; ptrCurrent <= ptrEnd - 4 * 2;) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-      ptrCurrent++;
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-      ptrCurrent++;
+    while (ptrCurrent != ptrEnd) {
+      ptrCurrent[0] = m_lut[ptrCurrent[0]].R;
+      ptrCurrent[1] = m_lut[ptrCurrent[1]].G;
+      ptrCurrent[2] = m_lut[ptrCurrent[2]].B;
+      ptrCurrent[3] = m_lut[ptrCurrent[3]].A;
+      ptrCurrent += 4;
     }
   }
 
-  while (ptrCurrent != ptrEnd) {
-    *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-    ptrCurrent++;
-
-    *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-    ptrCurrent++;
-
-    *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-    ptrCurrent++;
-
-    *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-    ptrCurrent++;
-  }
-
-  return 0;
-}
+private:
+  unsigned char *m_bitmap;
+  const vpRGBa (&m_lut)[256];
+};
 }
-#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   \brief Image initialisation
@@ -1807,8 +1728,9 @@ template <class Type> void vpImage<Type>::performLut(const Type (&)[256], const
   in parameter.
 
   \param lut : Look-up table (unsigned char array of size=256) which maps each
-  intensity to his new value. \param nbThreads : Number of threads to use for
-  the computation.
+  intensity to his new value.
+  \param nbThreads : Number of image chunks processed in parallel by the
+  threads of vpThreadPool::getInstance().
 */
 template <>
 inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256], const unsigned int nbThreads)
@@ -1819,9 +1741,6 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
   unsigned char *ptrCurrent = ptrStart;
 
   bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
 
   if (!use_single_thread && getSize() <= nbThreads) {
     use_single_thread = true;
@@ -1835,48 +1754,8 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
     // Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLut_Param_t *> imageLutParams;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads - 1);
-
-    for (unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index * step;
-      unsigned int end_index = (index + 1) * step;
-
-      if (index == nbThreads - 1) {
-        end_index = start_index + last_step;
-      }
-
-      ImageLut_Param_t *imageLut_param = new ImageLut_Param_t(start_index, end_index, bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256 * sizeof(unsigned char));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      vpThread *imageLut_thread = new vpThread((vpThread::Fn)performLutThread, (vpThread::Args)imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-    // Delete
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for (size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    vpThreadPool::getInstance().parallelFor(0, size, ImageLutBody(bitmap, lut), nbThreads);
   }
 }
 
@@ -1885,8 +1764,9 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
   parameter.
 
   \param lut : Look-up table (vpRGBa array of size=256) which maps each
-  intensity to his new value. \param nbThreads : Number of threads to use for
-  the computation.
+  intensity to his new value.
+  \param nbThreads : Number of image chunks processed in parallel by the
+  threads of vpThreadPool::getInstance().
 */
 template <> inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], const unsigned int nbThreads)
 {
@@ -1896,9 +1776,6 @@ template <> inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], co
   unsigned char *ptrCurrent = ptrStart;
 
   bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
 
   if (!use_single_thread && getSize() <= nbThreads) {
     use_single_thread = true;
@@ -1920,47 +1797,8 @@ template <> inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], co
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
     // Multi-threads
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLutRGBa_Param_t *> imageLutParams;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads - 1);
-
-    for (unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index * step;
-      unsigned int end_index = (index + 1) * step;
-
-      if (index == nbThreads - 1) {
-        end_index = start_index + last_step;
-      }
-
-      ImageLutRGBa_Param_t *imageLut_param = new ImageLutRGBa_Param_t(start_index, end_index, (unsigned char *)bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256 * sizeof(vpRGBa));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      vpThread *imageLut_thread = new vpThread((vpThread::Fn)performLutRGBaThread, (vpThread::Args)imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-    // Delete
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for (size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    vpThreadPool::getInstance().parallelFor(0, size, ImageLutRGBaBody((unsigned char *)bitmap, lut), nbThreads);
   }
 }
 
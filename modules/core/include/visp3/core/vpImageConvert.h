@@ -52,6 +52,7 @@
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
 // color
 #include <visp3/core/vpRGBa.h>
 
@@ -107,6 +108,23 @@ class VISP_EXPORT vpImageConvert
 {
 
 public:
+  /*!
+    Arrangement of the color filter array of a raw Bayer image, given by the
+    colors of the first two pixels of the first two rows.
+  */
+  typedef enum {
+    BAYER_BGGR, //!< B G / G R
+    BAYER_GBRG, //!< G B / R G
+    BAYER_GRBG, //!< G R / B G
+    BAYER_RGGB  //!< R G / G B
+  } vpBayerPattern;
+
+  //! Interpolation used to recover the missing colors of a Bayer image.
+  typedef enum {
+    BAYER_BILINEAR, //!< Bilinear interpolation
+    BAYER_MALVAR    //!< Gradient-corrected linear interpolation (Malvar, He and Cutler)
+  } vpBayerDemosaicMethod;
+
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba);
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth);
   static void convert(const vpImage<unsigned char> &src, vpImage<vpRGBa> &dest);
@@ -128,6 +146,20 @@ public:
   */
   template <typename Type> static void convert(const vpImage<Type> &src, vpImage<Type> &dest) { dest = src; }
 
+  static void convert(const vpImageView<const unsigned char> &src, vpImage<vpRGBa> &dest);
+  static void convert(const vpImageView<const vpRGBa> &src, vpImage<unsigned char> &dest);
+
+  /*!
+    Copy the pixels of a view in an image.
+    \param src : source view.
+    \param dest : destination image.
+  */
+  template <typename Type>
+  static void convert(const vpImageView<Type> &src, vpImage<typename vpImageView<Type>::PixelType> &dest)
+  {
+    src.copyTo(dest);
+  }
+
 #ifdef VISP_HAVE_OPENCV
   // Deprecated: will be removed with OpenCV transcient from C to C++ api
   static void convert(const IplImage *src, vpImage<vpRGBa> &dest, bool flip = false);
@@ -139,6 +171,8 @@ public:
   static void convert(const cv::Mat &src, vpImage<unsigned char> &dest, const bool flip = false);
   static void convert(const vpImage<vpRGBa> &src, cv::Mat &dest);
   static void convert(const vpImage<unsigned char> &src, cv::Mat &dest, const bool copyData = true);
+  static void convert(const cv::Mat &src, vpImageView<const unsigned char> &dest);
+  static void convert(const vpImageView<const unsigned char> &src, cv::Mat &dest, const bool copyData = true);
 #endif
 #endif
 
@@ -215,6 +249,13 @@ public:
   static void YUV444ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int size);
   static void YUV444ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size);
 
+  static void NV12ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height);
+  static void NV12ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height);
+  static void NV12ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int width, unsigned int height);
+  static void NV21ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height);
+  static void NV21ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height);
+  static void NV21ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int width, unsigned int height);
+
   static void YV12ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height);
   static void YV12ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height);
   static void YVU9ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height);
@@ -247,6 +288,13 @@ public:
   static void MONO16ToGrey(unsigned char *grey16, unsigned char *grey, unsigned int size);
   static void MONO16ToRGBa(unsigned char *grey16, unsigned char *rgba, unsigned int size);
 
+  static void BayerToRGBa(const unsigned char *bayer, unsigned char *rgba, unsigned int width, unsigned int height,
+                          vpBayerPattern pattern, vpBayerDemosaicMethod method = BAYER_BILINEAR);
+  static void BayerToGrey(const unsigned char *bayer, unsigned char *grey, unsigned int width, unsigned int height,
+                          vpBayerPattern pattern);
+  static void BayerToGreyHalf(const unsigned char *bayer, unsigned char *grey, unsigned int width,
+                              unsigned int height, vpBayerPattern pattern);
+
   static void HSVToRGBa(const double *hue, const double *saturation, const double *value, unsigned char *rgba,
                         const unsigned int size);
   static void HSVToRGBa(const unsigned char *hue, const unsigned char *saturation, const unsigned char *value,
@@ -96,6 +96,9 @@ public:
   }
   vpImageException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpImageException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpImageException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
@@ -47,6 +47,7 @@
 
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageException.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpMatrix.h>
 
@@ -62,6 +63,12 @@
 
   \brief  Various image filter, convolution, etc...
 
+  The separable filters, the gradients and the Gaussian pyramid are computed
+  8 pixels at a time with SSE2 when the CPU supports it, with the same
+  results as the per-pixel functions. To avoid double intermediate images,
+  gaussianBlur(), filterX(), filterY(), getGradX() and getGradY() also exist
+  in single precision, and gaussianBlur(), getGradX() and getGradY() in
+  fixed-point arithmetic.
 */
 class VISP_EXPORT vpImageFilter
 {
@@ -159,11 +166,17 @@ public:
 
   static void filter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpMatrix &M,
                      const bool convolve = false);
+  static void filter(const vpImageView<const unsigned char> &I, vpImage<double> &If, const vpMatrix &M,
+                     const bool convolve = false);
 
   static void sepFilter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
                         const vpColVector &kernelV);
+  static void sepFilter(const vpImageView<const unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
+                        const vpColVector &kernelV);
 
   static void filter(const vpImage<unsigned char> &I, vpImage<double> &GI, const double *filter, unsigned int size);
+  static void filter(const vpImageView<const unsigned char> &I, vpImage<double> &GI, const double *filter,
+                     unsigned int size);
   static void filter(const vpImage<double> &I, vpImage<double> &GI, const double *filter, unsigned int size);
 
   static inline unsigned char filterGaussXPyramidal(const vpImage<unsigned char> &I, unsigned int i, unsigned int j)
@@ -179,6 +192,12 @@ public:
 
   static void filterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void filterX(const vpImageView<const unsigned char> &I, vpImage<double> &dIx, const double *filter,
+                      unsigned int size);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
+  static void filterX(const vpImageView<const unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                      unsigned int size);
+  static void filterX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
 
   static inline double filterX(const vpImage<unsigned char> &I, unsigned int r, unsigned int c, const double *filter,
                                unsigned int size)
@@ -272,6 +291,12 @@ public:
 
   static void filterY(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void filterY(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void filterY(const vpImageView<const unsigned char> &I, vpImage<double> &dIy, const double *filter,
+                      unsigned int size);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
+  static void filterY(const vpImageView<const unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                      unsigned int size);
+  static void filterY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
   static inline double filterY(const vpImage<unsigned char> &I, unsigned int r, unsigned int c, const double *filter,
                                unsigned int size)
   {
@@ -366,6 +391,16 @@ public:
                            double sigma = 0., bool normalize = true);
   static void gaussianBlur(const vpImage<double> &I, vpImage<double> &GI, unsigned int size = 7, double sigma = 0.,
                            bool normalize = true);
+  static void gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<double> &GI, unsigned int size = 7,
+                           double sigma = 0., bool normalize = true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<float> &GI, unsigned int size = 7,
+                           double sigma = 0., bool normalize = true);
+  static void gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<float> &GI, unsigned int size = 7,
+                           double sigma = 0., bool normalize = true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, unsigned int size = 7,
+                           double sigma = 0.);
+  static void gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<unsigned char> &GI, unsigned int size = 7,
+                           double sigma = 0.);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -391,21 +426,43 @@ public:
 
   static void getGaussianKernel(double *filter, unsigned int size, double sigma = 0., bool normalize = true);
   static void getGaussianDerivativeKernel(double *filter, unsigned int size, double sigma = 0., bool normalize = true);
+  static void getGaussianKernel(float *filter, unsigned int size, double sigma = 0., bool normalize = true);
+  static void getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma = 0., bool normalize = true);
 
   // fonction renvoyant le gradient en X de l'image I pour traitement
   // pyramidal => dimension /2
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx);
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void getGradX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void getGradX(const vpImageView<const unsigned char> &I, vpImage<double> &dIx, const double *filter,
+                       unsigned int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
+  static void getGradX(const vpImageView<const unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                       unsigned int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<short> &dIx, const short *filter, unsigned int size);
+  static void getGradX(const vpImageView<const unsigned char> &I, vpImage<short> &dIx, const short *filter,
+                       unsigned int size);
   static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel, unsigned int size);
+  static void getGradXGauss2D(const vpImageView<const unsigned char> &I, vpImage<double> &dIx,
+                              const double *gaussianKernel, const double *gaussianDerivativeKernel, unsigned int size);
 
   // fonction renvoyant le gradient en Y de l'image I
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy);
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter, unsigned int size);
   static void getGradY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size);
+  static void getGradY(const vpImageView<const unsigned char> &I, vpImage<double> &dIy, const double *filter,
+                       unsigned int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
+  static void getGradY(const vpImageView<const unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                       unsigned int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<short> &dIy, const short *filter, unsigned int size);
+  static void getGradY(const vpImageView<const unsigned char> &I, vpImage<short> &dIy, const short *filter,
+                       unsigned int size);
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel, unsigned int size);
+  static void getGradYGauss2D(const vpImageView<const unsigned char> &I, vpImage<double> &dIy,
+                              const double *gaussianKernel, const double *gaussianDerivativeKernel, unsigned int size);
 
   static double getSobelKernelX(double *filter, unsigned int size);
   static double getSobelKernelY(double *filter, unsigned int size);
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed image remapping.
+ *
+ *****************************************************************************/
+
+#ifndef __vpImageRemap_h_
+#define __vpImageRemap_h_
+
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpRotationMatrix.h>
+
+/*!
+  \file vpImageRemap.h
+  \brief Image remapping with precomputed fixed-point tables.
+*/
+
+/*!
+  \class vpImageRemap
+
+  \ingroup group_core_image
+
+  \brief Geometric transformation of images, such as undistortion,
+  rectification, resizing or homographic warps, with a table computed once
+  and applied to every new image.
+
+  For each pixel of the destination image, the table stores the offset of
+  the top-left pixel of the 2x2 source neighborhood, and the index of the
+  bilinear interpolation weights. The sub-pixel coordinates are quantized on
+  \f$1/32\f$ of pixel, and the interpolation is computed with integers. The
+  distortion model or the homography is thus no more evaluated when the
+  images are transformed, and the rows are processed in parallel by the
+  threads of vpThreadPool::getInstance(), with SSE2 instructions when
+  available.
+
+  The destination pixels whose source coordinates fall outside of the
+  source image are set to 0.
+
+  Undistortion, rectification and resizing can be fused in a single pass
+  with initUndistortRectify(), for example to undistort and downscale the
+  images of a camera:
+
+  \code
+#include <visp3/core/vpImageRemap.h>
+
+int main()
+{
+  vpCameraParameters cam(1200, 1200, 960, 540, -0.15, 0.16);
+  // Undistorted camera with half the resolution
+  vpCameraParameters cam_half(600, 600, 480, 270);
+
+  vpImageRemap remap;
+  remap.initUndistortRectify(cam, 1920, 1080, vpRotationMatrix(), cam_half, 960, 540);
+
+  vpImage<unsigned char> I(1080, 1920), I_undist;
+  while (true) {
+    // Acquire I
+    remap.remap(I, I_undist);
+  }
+}
+  \endcode
+
+  \sa vpImageTools::undistort(), vpImageTools::resize()
+*/
+class VISP_EXPORT vpImageRemap
+{
+public:
+  vpImageRemap();
+
+  void init(const vpImage<float> &mapU, const vpImage<float> &mapV, unsigned int srcWidth, unsigned int srcHeight);
+  void initHomography(const vpMatrix &H, unsigned int srcWidth, unsigned int srcHeight, unsigned int dstWidth,
+                      unsigned int dstHeight);
+  void initResize(unsigned int srcWidth, unsigned int srcHeight, unsigned int dstWidth, unsigned int dstHeight);
+  void initUndistort(const vpCameraParameters &cam, unsigned int width, unsigned int height);
+  void initUndistortRectify(const vpCameraParameters &cam, unsigned int srcWidth, unsigned int srcHeight,
+                            const vpRotationMatrix &R, const vpCameraParameters &camNew, unsigned int dstWidth,
+                            unsigned int dstHeight);
+
+  //! Height of the destination images.
+  inline unsigned int getDstHeight() const { return m_dstHeight; }
+  //! Width of the destination images.
+  inline unsigned int getDstWidth() const { return m_dstWidth; }
+  //! Height of the source images.
+  inline unsigned int getSrcHeight() const { return m_srcHeight; }
+  //! Width of the source images.
+  inline unsigned int getSrcWidth() const { return m_srcWidth; }
+
+  void remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Idst) const;
+  void remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Idst) const;
+
+private:
+  void resizeTable(unsigned int srcWidth, unsigned int srcHeight, unsigned int dstWidth, unsigned int dstHeight);
+  void setCoordinates(unsigned int index, double u, double v);
+
+  unsigned int m_srcWidth;
+  unsigned int m_srcHeight;
+  unsigned int m_dstWidth;
+  unsigned int m_dstHeight;
+  //! Offset in the source image of the top-left pixel of the neighborhood
+  std::vector<int> m_offsets;
+  //! Index in m_weights of the interpolation weights
+  std::vector<unsigned short> m_weightIndexes;
+  //! Weights of the top-left, top-right, bottom-left and bottom-right pixels
+  std::vector<short> m_weights;
+};
+
+#endif
@@ -49,15 +49,13 @@
 
 #include <visp3/core/vpImage.h>
 
-#ifdef VISP_HAVE_PTHREAD
-#include <pthread.h>
-#endif
-
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpImageException.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRect.h>
 #include <visp3/core/vpRectOriented.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -85,6 +83,9 @@ public:
   template <class Type>
   static inline void binarise(vpImage<Type> &I, Type threshold1, Type threshold2, Type value1, Type value2, Type value3,
                               const bool useLUT = true);
+  template <class Type>
+  static void binarise(const vpImageView<Type> &I, Type threshold1, Type threshold2, Type value1, Type value2,
+                       Type value3);
   static void changeLUT(vpImage<unsigned char> &I, unsigned char A, unsigned char newA, unsigned char B,
                         unsigned char newB);
 
@@ -103,6 +104,9 @@ public:
   template <class Type>
   static void crop(const unsigned char *bitmap, unsigned int width, unsigned int height, const vpRect &roi,
                    vpImage<Type> &crop, unsigned int v_scale = 1, unsigned int h_scale = 1);
+  template <class Type>
+  static void crop(const vpImageView<Type> &I, vpImage<typename vpImageView<Type>::PixelType> &crop,
+                   unsigned int v_scale = 1, unsigned int h_scale = 1);
 
   static void extract(const vpImage<unsigned char> &Src, vpImage<unsigned char> &Dst, const vpRectOriented &r);
   static void extract(const vpImage<unsigned char> &Src, vpImage<double> &Dst, const vpRectOriented &r);
@@ -346,6 +350,41 @@ void vpImageTools::crop(const vpImage<Type> &I, const vpRect &roi, vpImage<Type>
                      v_scale, h_scale);
 }
 
+/*!
+  Copy the pixels of a view, for instance a region of interest created with
+  vpImageView<Type>(I, roi), in an image.
+
+  Setting \e v_scale and \e h_scale to values different from 1 allows also to
+  subsample the view.
+
+  \param I : View to copy.
+  \param crop : Image resized to the size of the (subsampled) view.
+  \param v_scale [in] : Vertical subsampling factor applied to the view.
+  \param h_scale [in] : Horizontal subsampling factor applied to the view.
+*/
+template <class Type>
+void vpImageTools::crop(const vpImageView<Type> &I, vpImage<typename vpImageView<Type>::PixelType> &crop,
+                        unsigned int v_scale, unsigned int h_scale)
+{
+  unsigned int r_height = I.getHeight() / v_scale;
+  unsigned int r_width = I.getWidth() / h_scale;
+
+  crop.resize(r_height, r_width);
+
+  if (h_scale == 1) {
+    for (unsigned int i = 0; i < r_height; i++) {
+      memcpy(crop[i], I[i * v_scale], r_width * sizeof(Type));
+    }
+  } else {
+    for (unsigned int i = 0; i < r_height; i++) {
+      const Type *src = I[i * v_scale];
+      for (unsigned int j = 0; j < r_width; j++) {
+        crop[i][j] = src[j * h_scale];
+      }
+    }
+  }
+}
+
 /*!
   Crop a region of interest (ROI) in an image. The ROI coordinates and
   dimension are defined in the original image.
@@ -477,53 +516,66 @@ inline void vpImageTools::binarise(vpImage<unsigned char> &I, unsigned char thre
   }
 }
 
-#ifdef VISP_HAVE_PTHREAD
+/*!
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-template <class Type> class vpUndistortInternalType
+  Binarise in place the pixels of a view, for instance a region of interest
+  of an image, leaving the rest of the image unchanged.
+
+  - Pixels whose values are less than \e threshold1 are set to \e value1
+
+  - Pixels whose values are greater then or equal to \e threshold1 and
+    less then or equal to \e threshold2 are set to \e value2
+
+  - Pixels whose values are greater than \e threshold2 are set to \e value3
+
+*/
+template <class Type>
+void vpImageTools::binarise(const vpImageView<Type> &I, Type threshold1, Type threshold2, Type value1, Type value2,
+                            Type value3)
 {
-public:
-  Type *src;
-  Type *dst;
-  unsigned int width;
-  unsigned int height;
-  vpCameraParameters cam;
-  unsigned int nthreads;
-  unsigned int threadid;
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    Type *p = I[i];
+    Type *pend = p + I.getWidth();
+    for (; p < pend; p++) {
+      Type v = *p;
+      if (v < threshold1)
+        *p = value1;
+      else if (v > threshold2)
+        *p = value3;
+      else
+        *p = value2;
+    }
+  }
+}
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// Undistort a range of rows of the image
+template <class Type> class vpUndistortInternalType : public vpThreadPool::vpParallelLoopBody
+{
 public:
-  vpUndistortInternalType() : src(NULL), dst(NULL), width(0), height(0), cam(), nthreads(0), threadid(0) {}
-
-  vpUndistortInternalType(const vpUndistortInternalType<Type> &u) { *this = u; }
-  vpUndistortInternalType &operator=(const vpUndistortInternalType<Type> &u)
+  vpUndistortInternalType(const vpImage<Type> &src, vpImage<Type> &dst, const vpCameraParameters &cam)
+    : m_src(src), m_dst(dst), m_cam(cam)
   {
-    src = u.src;
-    dst = u.dst;
-    width = u.width;
-    height = u.height;
-    cam = u.cam;
-    nthreads = u.nthreads;
-    threadid = u.threadid;
-
-    return *this;
   }
 
-  static void *vpUndistort_threaded(void *arg);
+  void operator()(unsigned int begin, unsigned int end) const;
+
+private:
+  const vpImage<Type> &m_src;
+  vpImage<Type> &m_dst;
+  const vpCameraParameters &m_cam;
 };
 
-template <class Type> void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
+template <class Type> void vpUndistortInternalType<Type>::operator()(unsigned int begin, unsigned int end) const
 {
-  vpUndistortInternalType<Type> *undistortSharedData = static_cast<vpUndistortInternalType<Type> *>(arg);
-  int offset = (int)undistortSharedData->threadid;
-  int width = (int)undistortSharedData->width;
-  int height = (int)undistortSharedData->height;
-  int nthreads = (int)undistortSharedData->nthreads;
-
-  double u0 = undistortSharedData->cam.get_u0();
-  double v0 = undistortSharedData->cam.get_v0();
-  double px = undistortSharedData->cam.get_px();
-  double py = undistortSharedData->cam.get_py();
-  double kud = undistortSharedData->cam.get_kud();
+  int width = (int)m_src.getWidth();
+  int height = (int)m_src.getHeight();
+
+  double u0 = m_cam.get_u0();
+  double v0 = m_cam.get_v0();
+  double px = m_cam.get_px();
+  double py = m_cam.get_py();
+  double kud = m_cam.get_kud();
 
   double invpx = 1.0 / px;
   double invpy = 1.0 / py;
@@ -531,10 +583,10 @@ template <class Type> void *vpUndistortInternalType<Type>::vpUndistort_threaded(
   double kud_px2 = kud * invpx * invpx;
   double kud_py2 = kud * invpy * invpy;
 
-  Type *dst = undistortSharedData->dst + (height / nthreads * offset) * width;
-  Type *src = undistortSharedData->src;
+  Type *dst = m_dst.bitmap + begin * (unsigned int)width;
+  const Type *src = m_src.bitmap;
 
-  for (double v = height / nthreads * offset; v < height / nthreads * (offset + 1); v++) {
+  for (double v = begin; v < end; v++) {
     double deltav = v - v0;
     // double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
     double fr1 = 1.0 + kud_py2 * deltav * deltav;
@@ -574,12 +626,8 @@ template <class Type> void *vpUndistortInternalType<Type>::vpUndistort_threaded(
       dst++;
     }
   }
-
-  pthread_exit((void *)0);
-  return NULL;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-#endif // VISP_HAVE_PTHREAD
 
 /*!
   Undistort an image
@@ -599,72 +647,21 @@ template <class Type> void *vpUndistortInternalType<Type>::vpUndistort_threaded(
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+
+  The rows are processed in parallel by the threads of
+  vpThreadPool::getInstance().
+
+  To undistort many images of the same camera, vpImageRemap is much faster:
+  it computes the distortion model once, in a table applied to each image.
 */
 template <class Type>
 void vpImageTools::undistort(const vpImage<Type> &I, const vpCameraParameters &cam, vpImage<Type> &undistI)
 {
-#ifdef VISP_HAVE_PTHREAD
-  //
-  // Optimized version using pthreads
-  //
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  undistI.resize(height, width);
-
-  double kud = cam.get_kud();
-
-  // if (kud == 0) {
-  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  unsigned int nthreads = 2;
-  pthread_attr_t attr;
-  pthread_t *callThd = new pthread_t[nthreads];
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  vpUndistortInternalType<Type> *undistortSharedData;
-  undistortSharedData = new vpUndistortInternalType<Type>[nthreads];
-
-  for (unsigned int i = 0; i < nthreads; i++) {
-    // Each thread works on a different set of data.
-    //    vpTRACE("create thread %d", i);
-    undistortSharedData[i].src = I.bitmap;
-    undistortSharedData[i].dst = undistI.bitmap;
-    undistortSharedData[i].width = I.getWidth();
-    undistortSharedData[i].height = I.getHeight();
-    undistortSharedData[i].cam = cam;
-    undistortSharedData[i].nthreads = nthreads;
-    undistortSharedData[i].threadid = i;
-    pthread_create(&callThd[i], &attr, &vpUndistortInternalType<Type>::vpUndistort_threaded, &undistortSharedData[i]);
-  }
-  pthread_attr_destroy(&attr);
-  /* Wait on the other threads */
-
-  for (unsigned int i = 0; i < nthreads; i++) {
-    //  vpTRACE("join thread %d", i);
-    pthread_join(callThd[i], NULL);
-  }
-
-  delete[] callThd;
-  delete[] undistortSharedData;
-#else  // VISP_HAVE_PTHREAD
-  //
-  // optimized version without pthreads
-  //
   unsigned int width = I.getWidth();
   unsigned int height = I.getHeight();
 
   undistI.resize(height, width);
 
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
   double kud = cam.get_kud();
 
   // if (kud == 0) {
@@ -674,57 +671,8 @@ void vpImageTools::undistort(const vpImage<Type> &I, const vpCameraParameters &c
     return;
   }
 
-  double invpx = 1.0 / px;
-  double invpy = 1.0 / py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistI.bitmap;
-  for (double v = 0; v < height; v++) {
-    double deltav = v - v0;
-    // double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0; u < width; u++) {
-      // computation of u,v : corresponding pixel coordinates in I.
-      double deltau = u - u0;
-      // double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      // printf("[%g][%g] %g %g : ", u, v, u_double, v_double );
-
-      // computation of the bilinear interpolation
-
-      // declarations
-      int u_round = (int)(u_double);
-      int v_round = (int)(v_double);
-      if (u_round < 0.f)
-        u_round = -1;
-      if (v_round < 0.f)
-        v_round = -1;
-      double du_double = (u_double) - (double)u_round;
-      double dv_double = (v_double) - (double)v_round;
-      Type v01;
-      Type v23;
-      if ((0 <= u_round) && (0 <= v_round) && (u_round < (((int)width) - 1)) && (v_round < (((int)height) - 1))) {
-        // process interpolation
-        const Type *_mp = &I[(unsigned int)v_round][(unsigned int)u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-        // printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
-      } else {
-        *dst = 0;
-      }
-      dst++;
-    }
-  }
-#endif // VISP_HAVE_PTHREAD
+  // Rows are processed in parallel by the shared thread pool
+  vpThreadPool::getInstance().parallelFor(0, height, vpUndistortInternalType<Type>(I, undistI, cam));
 
 #if 0
   // non optimized version
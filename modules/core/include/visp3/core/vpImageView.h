@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Non-owning strided view on image memory.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImageView.h
+  \brief Non-owning strided view on image memory.
+*/
+
+#ifndef vpImageView_h
+#define vpImageView_h
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRect.h>
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+/*!
+  \class vpImageView
+
+  \ingroup group_core_image
+
+  \brief Rectangular window on image memory that is not owned by the view.
+
+  Contrary to vpImage, the rows of a view are not necessarily contiguous: two
+  consecutive rows are separated by a stride expressed in bytes. A view can
+  thus refer to:
+  - a whole vpImage,
+  - a region of interest (ROI) of a vpImage or of another view,
+  - an external buffer with a row padding, like a cv::Mat or a frame
+  provided by a camera SDK.
+
+  Creating a view never copies the pixels, so that processing a ROI of a
+  large image costs only the processing of the ROI. The memory has to
+  outlive the view, and resizing the vpImage a view was created from
+  invalidates the view.
+
+  Pixels are accessed like in a vpImage with V[i][j] or V(i, j), where i and
+  j are expressed in the view frame. A vpImageView<Type> gives access to the
+  pixels in write mode and can only be created from a non-const image. A
+  view on a const image is a vpImageView<const Type>, that gives a read-only
+  access to the pixels; a vpImageView<Type> is implicitly converted to it,
+  so that functions that only read the pixels take a vpImageView<const Type>.
+
+  The following example computes the gradient of a ROI without cropping it:
+  \code
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageView.h>
+
+int main()
+{
+  vpImage<unsigned char> I(1944, 2592);
+  // ... acquire I
+  vpImageView<unsigned char> roi(I, vpRect(1000, 800, 320, 240));
+
+  double filter[3];
+  vpImageFilter::getGaussianDerivativeKernel(filter, 5);
+  vpImage<double> dIx; // 240 x 320
+  vpImageFilter::getGradX(roi, dIx, filter, 5);
+}
+  \endcode
+
+  \sa vpImageTools::crop(), vpImageConvert::convert()
+*/
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// Pixel type of the images a view on Type pixels refers to, and type of the
+// bytes of the view
+template <class Type> struct vpImageViewTraits {
+  typedef Type PixelType;
+  typedef unsigned char ByteType;
+};
+template <class Type> struct vpImageViewTraits<const Type> {
+  typedef Type PixelType;
+  typedef const unsigned char ByteType;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+template <class Type> class vpImageView
+{
+public:
+  //! Pixel type without const qualifier, that is the pixel type of the images the view refers to.
+  typedef typename vpImageViewTraits<Type>::PixelType PixelType;
+
+  /*!
+    Default constructor: empty view.
+  */
+  vpImageView() : m_data(NULL), m_height(0), m_width(0), m_stride(0) {}
+
+  /*!
+    View on an external buffer.
+
+    \param data : Pointer to the top left pixel.
+    \param height, width : Size of the view.
+    \param stride : Number of bytes between the beginning of two consecutive
+    rows. If 0, the rows are considered contiguous and the stride is set to
+    width * sizeof(Type).
+  */
+  vpImageView(Type *data, unsigned int height, unsigned int width, unsigned int stride = 0)
+    : m_data(data), m_height(height), m_width(width), m_stride(stride)
+  {
+    if (m_stride == 0) {
+      m_stride = m_width * (unsigned int)sizeof(Type);
+    } else if (m_stride < m_width * sizeof(Type)) {
+      throw vpException(vpException::dimensionError, "Stride %d smaller than a row of %d bytes", m_stride,
+                        (int)(m_width * sizeof(Type)));
+    }
+  }
+
+  /*!
+    Read-only view on the pixels of a view. For a view in write mode, this is
+    the copy constructor.
+  */
+  vpImageView(const vpImageView<PixelType> &V)
+    : m_data(V.getData()), m_height(V.getHeight()), m_width(V.getWidth()), m_stride(V.getStride())
+  {
+  }
+
+  /*!
+    Make this view refer to the pixels of a view. For a view in write mode,
+    this is the copy assignment.
+  */
+  vpImageView &operator=(const vpImageView<PixelType> &V)
+  {
+    init(V.getData(), V.getHeight(), V.getWidth(), V.getStride());
+    return *this;
+  }
+
+  /*!
+    View on a whole image.
+  */
+  explicit vpImageView(vpImage<PixelType> &I)
+    : m_data(I.bitmap), m_height(I.getHeight()), m_width(I.getWidth()),
+      m_stride(I.getWidth() * (unsigned int)sizeof(Type))
+  {
+  }
+
+  /*!
+    Read-only view on a whole const image. Only available for a
+    vpImageView<const Type>.
+  */
+  explicit vpImageView(const vpImage<PixelType> &I)
+    : m_data(static_cast<const PixelType *>(I.bitmap)), m_height(I.getHeight()), m_width(I.getWidth()),
+      m_stride(I.getWidth() * (unsigned int)sizeof(Type))
+  {
+  }
+
+  /*!
+    View on a region of interest of an image. The ROI is clipped to the image
+    with the same rules as vpImageTools::crop().
+
+    \param I : Image.
+    \param roi : Region of interest in the image frame.
+  */
+  vpImageView(vpImage<PixelType> &I, const vpRect &roi) : m_data(NULL), m_height(0), m_width(0), m_stride(0)
+  {
+    const vpImageView<Type> V = vpImageView<Type>(I).getView(roi);
+    init(V.getData(), V.getHeight(), V.getWidth(), V.getStride());
+  }
+
+  /*!
+    Read-only view on a region of interest of a const image. Only available
+    for a vpImageView<const Type>.
+  */
+  vpImageView(const vpImage<PixelType> &I, const vpRect &roi) : m_data(NULL), m_height(0), m_width(0), m_stride(0)
+  {
+    const vpImageView<Type> V = vpImageView<Type>(I).getView(roi);
+    init(V.getData(), V.getHeight(), V.getWidth(), V.getStride());
+  }
+
+  /*!
+    View on a region of interest of an image.
+
+    \param I : Image.
+    \param top, left : Position of the top left corner of the ROI in the
+    image.
+    \param height, width : Size of the ROI.
+    \exception vpException::dimensionError : The ROI is not fully inside
+    the image.
+  */
+  vpImageView(vpImage<PixelType> &I, unsigned int top, unsigned int left, unsigned int height, unsigned int width)
+    : m_data(NULL), m_height(0), m_width(0), m_stride(0)
+  {
+    const vpImageView<Type> V = vpImageView<Type>(I).getView(top, left, height, width);
+    init(V.getData(), V.getHeight(), V.getWidth(), V.getStride());
+  }
+
+  /*!
+    Read-only view on a region of interest of a const image. Only available
+    for a vpImageView<const Type>.
+  */
+  vpImageView(const vpImage<PixelType> &I, unsigned int top, unsigned int left, unsigned int height,
+              unsigned int width)
+    : m_data(NULL), m_height(0), m_width(0), m_stride(0)
+  {
+    const vpImageView<Type> V = vpImageView<Type>(I).getView(top, left, height, width);
+    init(V.getData(), V.getHeight(), V.getWidth(), V.getStride());
+  }
+
+  /*!
+    Copy the pixels of the view in an image resized to the view size.
+  */
+  void copyTo(vpImage<PixelType> &I) const
+  {
+    I.resize(m_height, m_width);
+    for (unsigned int i = 0; i < m_height; i++) {
+      memcpy(I[i], (*this)[i], m_width * sizeof(Type));
+    }
+  }
+
+  //! Pointer to the top left pixel.
+  inline Type *getData() const { return m_data; }
+  //! Number of rows.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Number of pixels.
+  inline unsigned int getSize() const { return m_height * m_width; }
+  //! Number of bytes between the beginning of two consecutive rows.
+  inline unsigned int getStride() const { return m_stride; }
+  //! Number of columns.
+  inline unsigned int getWidth() const { return m_width; }
+
+  /*!
+    Sub-view of this view. The ROI is expressed in the frame of this view.
+
+    \exception vpException::dimensionError : The ROI is not fully inside
+    the view.
+  */
+  vpImageView<Type> getView(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    if (top + height > m_height || left + width > m_width) {
+      throw vpException(vpException::dimensionError, "ROI (%d, %d, %d x %d) outside of a %d x %d view", top, left,
+                        width, height, m_width, m_height);
+    }
+    return vpImageView<Type>((*this)[top] + left, height, width, m_stride);
+  }
+
+  /*!
+    Sub-view of this view. The ROI is expressed in the frame of this view and
+    clipped to the view with the same rules as vpImageTools::crop().
+  */
+  vpImageView<Type> getView(const vpRect &roi) const
+  {
+    int i_min = (std::max)((int)ceil(roi.getTop()), 0);
+    int j_min = (std::max)((int)ceil(roi.getLeft()), 0);
+    int i_max = (std::min)((int)ceil(roi.getTop() + roi.getHeight()), (int)m_height);
+    int j_max = (std::min)((int)ceil(roi.getLeft() + roi.getWidth()), (int)m_width);
+    if (i_max <= i_min || j_max <= j_min) {
+      return vpImageView<Type>();
+    }
+    return vpImageView<Type>((*this)[i_min] + j_min, (unsigned int)(i_max - i_min), (unsigned int)(j_max - j_min),
+                             m_stride);
+  }
+
+  //! True if the rows follow each other in memory.
+  inline bool isContiguous() const { return m_stride == m_width * sizeof(Type); }
+
+  //! Pointer to the first pixel of row i.
+  inline Type *operator[](unsigned int i) const
+  {
+    typedef typename vpImageViewTraits<Type>::ByteType ByteType;
+    return reinterpret_cast<Type *>(reinterpret_cast<ByteType *>(m_data) + (size_t)i * m_stride);
+  }
+
+  //! Pixel at row i and column j.
+  inline Type &operator()(unsigned int i, unsigned int j) const { return (*this)[i][j]; }
+
+private:
+  void init(Type *data, unsigned int height, unsigned int width, unsigned int stride)
+  {
+    m_data = data;
+    m_height = height;
+    m_width = width;
+    m_stride = stride;
+  }
+
+  Type *m_data;
+  unsigned int m_height;
+  unsigned int m_width;
+  unsigned int m_stride;
+};
+
+#endif
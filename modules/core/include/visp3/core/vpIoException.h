@@ -94,6 +94,9 @@ public:
   }
   vpIoException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpIoException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpIoException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
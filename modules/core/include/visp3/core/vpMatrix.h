@@ -112,6 +112,18 @@ public:
     LU_DECOMPOSITION /*!< LU decomposition method. */
   } vpDetMethod;
 
+  /*!
+    Micro-kernel used by the built-in matrix products.
+    \sa setProductKernel()
+  */
+  typedef enum {
+    PRODUCT_KERNEL_AUTO,     /*!< Fastest kernel supported by the CPU. */
+    PRODUCT_KERNEL_SCALAR,   /*!< Portable C++ kernel. */
+    PRODUCT_KERNEL_SSE2,     /*!< SSE2 kernel (x86). */
+    PRODUCT_KERNEL_AVX2_FMA, /*!< AVX2 and FMA kernel (x86). */
+    PRODUCT_KERNEL_NEON      /*!< NEON kernel (aarch64). */
+  } vpProductKernel;
+
 public:
   /*!
     Basic constructor of a matrix of double. Number of columns and rows are
@@ -590,6 +602,32 @@ vpMatrix M(R);
   static vpMatrix kron(const vpMatrix &m1, const vpMatrix &m2);
   //@}
 
+  //---------------------------------
+  // Matrix products Static Public Member Functions
+  //---------------------------------
+  /** @name Matrix products settings with Static Public Member Functions  */
+  //@{
+  /*!
+    Return the minimal matrix size from which products are computed with
+    BLAS when ViSP is built with a third-party Lapack library.
+    \sa setLapackMatrixMinSize()
+   */
+  static unsigned int getLapackMatrixMinSize() { return m_lapack_min_size; }
+  /*!
+    Set the minimal matrix size from which products are computed with BLAS
+    when ViSP is built with a third-party Lapack library. Smaller products
+    use the built-in cache-blocked kernels that avoid the BLAS call
+    overhead. By default the size is 16: below, the argument checks and the
+    threading setup of optimized BLAS libraries cost more than the product
+    itself, and the products with 6-column interaction matrices done at
+    each tracking iteration stay on the built-in kernels.
+    \sa getLapackMatrixMinSize()
+   */
+  static void setLapackMatrixMinSize(unsigned int min_size) { m_lapack_min_size = min_size; }
+  static vpProductKernel getProductKernel();
+  static bool setProductKernel(vpProductKernel kernel);
+  //@}
+
   //-------------------------------------------------
   // 2D Convolution Static Public Member Functions
   //-------------------------------------------------
@@ -751,6 +789,14 @@ private:
   static void blas_dgemv(char trans, const int M, const int N, double alpha, double *a_data, const int lda,
                          double *x_data, const int incx, double beta, double *y_data, const int incy);
 #endif
+  static void native_dgemm(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K,
+                           const double *A, unsigned int lda, const double *B, unsigned int ldb, double *C,
+                           unsigned int ldc);
+  static void native_dgemv(unsigned int M, unsigned int N, const double *A, unsigned int lda, const double *x,
+                           double *y);
+  static bool useLapack(unsigned int M, unsigned int N, unsigned int K);
+
+  static unsigned int m_lapack_min_size;
 
   static void computeCovarianceMatrixVVS(const vpHomogeneousMatrix &cMo, const vpColVector &deltaS, const vpMatrix &Ls,
                                          vpMatrix &Js, vpColVector &deltaP);
@@ -104,6 +104,9 @@ public:
   vpMatrixException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpMatrixException(const int id) : vpException(id) { ; }
   // vpMatrixException() : vpException() { ;}
+
+  vpException *clone() const { return new vpMatrixException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
@@ -56,6 +56,7 @@ class vpThetaUVector;
 class vpRowVector;
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpRotationMatrix.h>
@@ -70,7 +71,7 @@ class vpRowVector;
   The vpPose class implements a complete representation of every rigid motion
   in the euclidian space.
 
-  The vpPose class is derived from vpArray2D<double>.
+  The vpPoseVector class is derived from vpFixedMatrix<6, 1>.
 
   The pose is composed of a translation and a rotation
   minimaly represented by a 6 dimension pose vector as: \f[ ^{a}{\bf
@@ -89,7 +90,7 @@ class vpRowVector;
   see vpThetaUVector documentation.
 
 */
-class VISP_EXPORT vpPoseVector : public vpArray2D<double>
+class VISP_EXPORT vpPoseVector : public vpFixedMatrix<6, 1>
 {
 public:
   // constructor
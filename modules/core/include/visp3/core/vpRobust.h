@@ -44,6 +44,8 @@
 #ifndef CROBUST_HH
 #define CROBUST_HH
 
+#include <vector>
+
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpMath.h>
@@ -54,6 +56,11 @@
   \brief Contains an M-Estimator and various influence function.
 
   Supported methods: M-estimation, Tukey, Cauchy and Huber
+
+  The medians are computed by selection in linear time and the weights by
+  SIMD kernels (AVX or NEON) when the CPU supports them. The internal buffers
+  only grow, so the same instance can be reused at each iteration and frame
+  without reallocation.
 */
 class VISP_EXPORT vpRobust
 {
@@ -64,11 +71,11 @@ public:
 
 private:
   //! Normalized residue
-  vpColVector normres;
+  std::vector<double> normres;
   //! Sorted normalized Residues
-  vpColVector sorted_normres;
+  std::vector<double> sorted_normres;
   //! Sorted residues
-  vpColVector sorted_residues;
+  std::vector<double> sorted_residues;
 
   //! Noise threshold
   double NoiseThreshold;
@@ -76,8 +83,6 @@ private:
   double sig_prev;
   //!
   unsigned int it;
-  //! Vairiable used in swap method
-  double swap;
   //! Size of the containers
   unsigned int size;
 
@@ -126,7 +131,7 @@ public:
 
 private:
   //! Compute normalized median
-  double computeNormalizedMedian(vpColVector &all_normres, const vpColVector &residues, const vpColVector &all_residues,
+  double computeNormalizedMedian(const vpColVector &residues, const vpColVector &all_residues,
                                  const vpColVector &weights);
 
   //! Calculate various scale estimates
@@ -138,11 +143,11 @@ private:
   /** @name PsiFunctions  */
   //@{
   //! Tuckey influence function
-  void psiTukey(double sigma, vpColVector &x, vpColVector &w);
+  void psiTukey(double sigma, const std::vector<double> &x, unsigned int n_data, vpColVector &w);
   //! Caucht influence function
-  void psiCauchy(double sigma, vpColVector &x, vpColVector &w);
+  void psiCauchy(double sigma, const std::vector<double> &x, unsigned int n_data, vpColVector &w);
   //! Huber influence function
-  void psiHuber(double sigma, vpColVector &x, vpColVector &w);
+  void psiHuber(double sigma, const std::vector<double> &x, unsigned int n_data, vpColVector &w);
   //@}
 
   //! Partial derivative of loss function
@@ -180,17 +185,8 @@ private:
 
   /** @name Sort function  */
   //@{
-  //! Swap two value
-  void exch(double &A, double &B)
-  {
-    swap = A;
-    A = B;
-    B = swap;
-  }
-  //! Sort function using partition method
-  int partition(vpColVector &a, int l, int r);
-  //! Sort the vector and select a value in the sorted vector
-  double select(vpColVector &a, int l, int r, int k);
+  //! Select the k-th smallest value of the n first values, that are reordered
+  static double select(double *a, unsigned int n, unsigned int k);
   //@}
 };
 
@@ -45,6 +45,7 @@
 */
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpPoseVector.h>
 #include <visp3/core/vpQuaternionVector.h>
@@ -65,10 +66,11 @@
   The vpRotationMatrix considers the particular case of
   a rotation matrix.
 
-  The vpRotationMatrix class is derived from vpArray2D<double>.
+  The vpRotationMatrix class is derived from vpFixedMatrix<3, 3> and is
+  stored without heap allocation.
 
 */
-class VISP_EXPORT vpRotationMatrix : public vpArray2D<double>
+class VISP_EXPORT vpRotationMatrix : public vpFixedMatrix<3, 3>
 {
 public:
   vpRotationMatrix();
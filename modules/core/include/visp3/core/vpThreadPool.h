@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pool of persistent worker threads.
+ *
+ *****************************************************************************/
+
+#ifndef __vpThreadPool_h_
+#define __vpThreadPool_h_
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \class vpThreadPool
+
+  \ingroup group_core_threading
+
+  \brief Pool of persistent worker threads shared by the parallel code paths
+  of ViSP.
+
+  Instead of creating and joining threads at each call, the algorithms that
+  run in parallel submit their work to a process-wide pool obtained with
+  getInstance(). Each worker owns a task queue; an idle worker steals tasks
+  from the queues of the other workers. A thread waiting for its tasks to
+  complete executes pending tasks instead of blocking, so that nested
+  parallel calls (a parallel loop run from inside a task) do not
+  oversubscribe the machine nor deadlock.
+
+  The pool uses pthread when available, or native Windows threading
+  capabilities. Without thread support, every task is executed by the
+  calling thread.
+
+  By default the pool contains one thread per logical core, the calling
+  thread included. This can be changed with setNumberOfThreads().
+
+  The following example computes the sum of the elements of a vector:
+  \code
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThreadPool.h>
+
+class SumBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  SumBody(const std::vector<double> &v, double &sum, vpMutex &mutex) : m_v(v), m_sum(sum), m_mutex(mutex) {}
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    double sum = 0;
+    for (unsigned int i = begin; i < end; i++)
+      sum += m_v[i];
+
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_sum += sum;
+  }
+
+private:
+  const std::vector<double> &m_v;
+  double &m_sum;
+  vpMutex &m_mutex;
+};
+
+int main()
+{
+  std::vector<double> v(100000, 1.0);
+  double sum = 0;
+  vpMutex mutex;
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)v.size(), SumBody(v, sum, mutex));
+}
+  \endcode
+
+  Independent heterogeneous jobs are run with a vpThreadPool::vpTaskGroup.
+
+  \sa vpThread, vpMutex
+*/
+class VISP_EXPORT vpThreadPool
+{
+public:
+  /*!
+    Unit of work submitted to the pool through a vpTaskGroup.
+  */
+  class VISP_EXPORT vpTask
+  {
+  public:
+    virtual ~vpTask() {}
+    //! Function executed by one of the threads of the pool.
+    virtual void run() = 0;
+  };
+
+  /*!
+    Body of a loop executed by parallelFor(). The operator is called
+    concurrently on disjoint ranges of indexes and must thus only write to
+    data owned by its range, or protect shared data.
+  */
+  class VISP_EXPORT vpParallelLoopBody
+  {
+  public:
+    virtual ~vpParallelLoopBody() {}
+    //! Process the indexes in [\e begin, \e end).
+    virtual void operator()(unsigned int begin, unsigned int end) const = 0;
+  };
+
+  /*!
+    Set of tasks whose completion can be awaited. The tasks are not copied:
+    they must outlive the call to wait(). The destructor waits for the
+    completion of the remaining tasks.
+
+    If a task throws, the first exception is rethrown by wait() once all the
+    tasks of the group have completed. Exceptions derived from vpException
+    keep their type (see vpException::rethrow()).
+  */
+  class VISP_EXPORT vpTaskGroup
+  {
+  public:
+    explicit vpTaskGroup(vpThreadPool &pool = vpThreadPool::getInstance());
+    ~vpTaskGroup();
+
+    void run(vpTask &task);
+    void wait();
+
+  private:
+    vpTaskGroup(const vpTaskGroup &);
+    vpTaskGroup &operator=(const vpTaskGroup &);
+
+    friend class vpThreadPool;
+
+    vpThreadPool &m_pool;
+    //! Number of submitted tasks not yet completed
+    unsigned int m_pending;
+    //! True if one of the tasks has thrown
+    bool m_failed;
+    //! Copy of the first exception thrown by a task, NULL if none
+    vpException *m_exception;
+  };
+
+  explicit vpThreadPool(unsigned int nbThreads = 0);
+  virtual ~vpThreadPool();
+
+  static vpThreadPool &getInstance();
+  static unsigned int getNumberOfCPUs();
+  unsigned int getNumberOfThreads() const;
+
+  bool isWorkerThread() const;
+
+  void parallelFor(unsigned int begin, unsigned int end, const vpParallelLoopBody &body, unsigned int nbChunks = 0);
+
+  void setNumberOfThreads(unsigned int nbThreads);
+
+private:
+  vpThreadPool(const vpThreadPool &);
+  vpThreadPool &operator=(const vpThreadPool &);
+
+  class Impl;
+  Impl *m_impl;
+};
+
+#endif
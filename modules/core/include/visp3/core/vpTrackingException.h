@@ -93,6 +93,9 @@ public:
   }
   vpTrackingException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpTrackingException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpTrackingException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
@@ -46,6 +46,7 @@
 */
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpPoseVector.h>
@@ -88,14 +89,14 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpTranslationVector : public vpArray2D<double>
+class VISP_EXPORT vpTranslationVector : public vpFixedMatrix<3, 1>
 {
 public:
   /*!
       Default constructor.
       The translation vector is initialized to zero.
     */
-  vpTranslationVector() : vpArray2D<double>(3, 1){};
+  vpTranslationVector() : vpFixedMatrix<3, 1>(){};
   vpTranslationVector(const double tx, const double ty, const double tz);
   vpTranslationVector(const vpTranslationVector &tv);
   explicit vpTranslationVector(const vpHomogeneousMatrix &M);
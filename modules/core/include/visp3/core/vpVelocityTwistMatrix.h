@@ -41,6 +41,7 @@
 #define vpVelocityRwistMatrix_h
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedMatrix.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpMatrix.h>
@@ -54,7 +55,7 @@ class vpColVector;
 
   \ingroup group_core_transformations
 
-  This class derived from vpArray2D<double> implements the 6 by 6 matrix which
+  This class derived from vpFixedMatrix<6, 6> implements the 6 by 6 matrix which
 transforms velocities from one frame to another. This matrix is also called
 velocity twist transformation matrix.
 
@@ -111,7 +112,7 @@ frame
 }
   \endcode
 */
-class VISP_EXPORT vpVelocityTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpVelocityTwistMatrix : public vpFixedMatrix<6, 6>
 {
   friend class vpMatrix;
 
@@ -95,6 +95,44 @@ void vpImageConvert::convert(const vpImage<vpRGBa> &src, vpImage<unsigned char>
   RGBaToGrey((unsigned char *)src.bitmap, dest.bitmap, src.getHeight() * src.getWidth());
 }
 
+/*!
+  Convert a view on a grey level image, for instance a region of interest, to
+  a vpImage\<vpRGBa\>. The alpha component is set to vpRGBa::alpha_default.
+  \param src : source view
+  \param dest : destination image
+*/
+void vpImageConvert::convert(const vpImageView<const unsigned char> &src, vpImage<vpRGBa> &dest)
+{
+  dest.resize(src.getHeight(), src.getWidth());
+
+  if (src.isContiguous()) {
+    GreyToRGBa((unsigned char *)src.getData(), (unsigned char *)dest.bitmap, src.getSize());
+  } else {
+    for (unsigned int i = 0; i < src.getHeight(); i++) {
+      GreyToRGBa((unsigned char *)src[i], (unsigned char *)dest[i], src.getWidth());
+    }
+  }
+}
+
+/*!
+  Convert a view on a color image, for instance a region of interest, to a
+  vpImage\<unsigned char\>.
+  \param src : source view
+  \param dest : destination image
+*/
+void vpImageConvert::convert(const vpImageView<const vpRGBa> &src, vpImage<unsigned char> &dest)
+{
+  dest.resize(src.getHeight(), src.getWidth());
+
+  if (src.isContiguous()) {
+    RGBaToGrey((unsigned char *)src.getData(), dest.bitmap, src.getSize());
+  } else {
+    for (unsigned int i = 0; i < src.getHeight(); i++) {
+      RGBaToGrey((unsigned char *)src[i], dest[i], src.getWidth());
+    }
+  }
+}
+
 /*!
   Convert a vpImage\<float\> to a vpImage\<unsigend char\> by renormalizing
   between 0 and 255. \param src : source image \param dest : destination image
@@ -945,6 +983,43 @@ void vpImageConvert::convert(const vpImage<unsigned char> &src, cv::Mat &dest, c
   }
 }
 
+/*!
+  Wrap a grey level cv::Mat, which can be a region of interest of a larger
+  matrix, in a view without copying the pixels. The view is valid as long as
+  the memory of \e src is.
+
+  \param src : source CV_8UC1 matrix
+  \param dest : view on the pixels of \e src
+  \exception vpException::badValue : \e src is not a CV_8UC1 matrix.
+*/
+void vpImageConvert::convert(const cv::Mat &src, vpImageView<const unsigned char> &dest)
+{
+  if (src.type() != CV_8UC1) {
+    throw vpException(vpException::badValue, "Only CV_8UC1 matrices can be wrapped in a view");
+  }
+  dest = vpImageView<const unsigned char>(src.ptr<unsigned char>(0), (unsigned int)src.rows, (unsigned int)src.cols,
+                                          (unsigned int)src.step[0]);
+}
+
+/*!
+  Convert a view on a grey level image to a cv::Mat.
+
+  \param src : source view
+  \param dest : destination matrix
+  \param copyData : if false, \e dest refers to the pixels of the view with its
+  stride, so that no pixel is copied. Otherwise the pixels are copied in a
+  continuous matrix.
+*/
+void vpImageConvert::convert(const vpImageView<const unsigned char> &src, cv::Mat &dest, const bool copyData)
+{
+  cv::Mat tmpMap((int)src.getHeight(), (int)src.getWidth(), CV_8UC1, (void *)src.getData(), (size_t)src.getStride());
+  if (copyData) {
+    dest = tmpMap.clone();
+  } else {
+    dest = tmpMap;
+  }
+}
+
 #endif
 #endif
 
@@ -1908,139 +1983,144 @@ void vpImageConvert::YUV411ToRGB(unsigned char *yuv, unsigned char *rgb, unsigne
 #endif
 }
 
-/*!
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Chroma offsets of the 4:2:0 conversions, that use integer approximations
+// of R = Y + 1.402 V, G = Y - 0.344 U - 0.714 V and B = Y + 1.772 U
+inline void yuv420Offsets(int u, int v, int &dr, int &dg, int &db)
+{
+  const int U = (int)((u - 128) * 0.354);
+  const int V = (int)((v - 128) * 0.707);
+  dr = 2 * V;
+  dg = -U - V;
+  db = 5 * U;
+}
 
-  Convert YUV420 [Y(NxM), U(N/2xM/2), V(N/2xM/2)] image into RGBa image.
+inline unsigned char yuv420Clamp(int x) { return (unsigned char)(x < 0 ? 0 : (x > 255 ? 255 : x)); }
 
-  The alpha component of the converted image is set to vpRGBa::alpha_default.
+#if VISP_HAVE_SSE2
+// Truncated product of signed 16-bit values in [-128, 127] by a factor
+// f / 65536, computed exactly as the truncation toward zero done by the
+// scalar code
+inline __m128i yuv420MulTrunc(const __m128i &d, const __m128i &f)
+{
+  const __m128i sign = _mm_srai_epi16(d, 15);
+  const __m128i absd = _mm_max_epi16(d, _mm_sub_epi16(_mm_setzero_si128(), d));
+  const __m128i q = _mm_mulhi_epu16(absd, f);
+  return _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+}
+#endif
 
+/*
+  Convert a 4:2:0 image with a full resolution Y plane and U and V planes
+  subsampled by 2 in both directions into RGBa (nChannels = 4) or RGB
+  (nChannels = 3). uvStep is 1 for planar chroma (I420, YV12) and 2 for
+  interleaved chroma (NV12, NV21); uvStride is the size in bytes of a chroma
+  row.
 */
-void vpImageConvert::YUV420ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+void yuv420ToRGBx(const unsigned char *y, const unsigned char *u, const unsigned char *v, unsigned int uvStep,
+                  unsigned int uvStride, unsigned char *dst, unsigned int nChannels, unsigned int width,
+                  unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iU = yuv + size;
-  unsigned char *iV = yuv + 5 * size / 4;
+#if VISP_HAVE_SSE2
+  const bool useSSE2 = vpCPUFeatures::checkSSE2();
+  // 0.354 and 0.707 in 16-bit fixed point, that give the same truncated
+  // products as the floating point factors for all the chroma values
+  const __m128i fu = _mm_set1_epi16((short)23199), fv = _mm_set1_epi16((short)46328);
+  const __m128i bias = _mm_set1_epi16(128), lowMask = _mm_set1_epi16(0x00FF), zero = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8((char)vpRGBa::alpha_default);
+#endif
+  const unsigned int w2 = width / 2;
   for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba + 4 * width - 7;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
+    const unsigned char *y0 = y + 2 * i * width, *y1 = y0 + width;
+    const unsigned char *ui = u + i * uvStride, *vi = v + i * uvStride;
+    unsigned char *d0 = dst + 2 * i * width * nChannels, *d1 = d0 + width * nChannels;
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    // 8 chroma samples and 2 x 16 pixels per iteration
+    for (; useSSE2 && j + 8 <= w2; j += 8) {
+      __m128i u16, v16;
+      if (uvStep == 1) {
+        u16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ui + j)), zero);
+        v16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(vi + j)), zero);
+      } else {
+        // The 16 bytes read from u + 2j contain the 8 U samples at even
+        // positions if u < v, at odd positions otherwise
+        const __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i *>((u < v ? ui : vi) + 2 * j));
+        const __m128i even = _mm_and_si128(uv, lowMask), odd = _mm_srli_epi16(uv, 8);
+        u16 = u < v ? even : odd;
+        v16 = u < v ? odd : even;
+      }
+      const __m128i U = yuv420MulTrunc(_mm_sub_epi16(u16, bias), fu);
+      const __m128i V = yuv420MulTrunc(_mm_sub_epi16(v16, bias), fv);
+      const __m128i dr = _mm_add_epi16(V, V);
+      const __m128i dg = _mm_sub_epi16(zero, _mm_add_epi16(U, V));
+      const __m128i db = _mm_add_epi16(_mm_slli_epi16(U, 2), U);
+      // Each chroma sample is shared by two neighboring pixels
+      const __m128i dr0 = _mm_unpacklo_epi16(dr, dr), dr1 = _mm_unpackhi_epi16(dr, dr);
+      const __m128i dg0 = _mm_unpacklo_epi16(dg, dg), dg1 = _mm_unpackhi_epi16(dg, dg);
+      const __m128i db0 = _mm_unpacklo_epi16(db, db), db1 = _mm_unpackhi_epi16(db, db);
+
+      for (unsigned int k = 0; k < 2; k++) {
+        const __m128i yy = _mm_loadu_si128(reinterpret_cast<const __m128i *>((k == 0 ? y0 : y1) + 2 * j));
+        const __m128i ylo = _mm_unpacklo_epi8(yy, zero), yhi = _mm_unpackhi_epi8(yy, zero);
+        // Saturation gives the same clamping to [0, 255] as the scalar code
+        const __m128i r = _mm_packus_epi16(_mm_add_epi16(ylo, dr0), _mm_add_epi16(yhi, dr1));
+        const __m128i g = _mm_packus_epi16(_mm_add_epi16(ylo, dg0), _mm_add_epi16(yhi, dg1));
+        const __m128i b = _mm_packus_epi16(_mm_add_epi16(ylo, db0), _mm_add_epi16(yhi, db1));
+        unsigned char *d = (k == 0 ? d0 : d1) + 2 * j * nChannels;
+        if (nChannels == 4) {
+          const __m128i rg_lo = _mm_unpacklo_epi8(r, g), ba_lo = _mm_unpacklo_epi8(b, alpha);
+          const __m128i rg_hi = _mm_unpackhi_epi8(r, g), ba_hi = _mm_unpackhi_epi8(b, alpha);
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(d), _mm_unpacklo_epi16(rg_lo, ba_lo));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(d + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(d + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(d + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+        } else {
+          unsigned char rr[16], gg[16], bb[16];
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(rr), r);
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(gg), g);
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(bb), b);
+          for (unsigned int l = 0; l < 16; l++) {
+            *d++ = rr[l];
+            *d++ = gg[l];
+            *d++ = bb[l];
+          }
+        }
+      }
+    }
+#endif
+    for (; j < w2; j++) {
+      int dr, dg, db;
+      yuv420Offsets(ui[j * uvStep], vi[j * uvStep], dr, dg, db);
+      for (unsigned int k = 0; k < 4; k++) {
+        const unsigned int col = 2 * j + (k & 1);
+        const int Y = (k < 2 ? y0 : y1)[col];
+        unsigned char *d = (k < 2 ? d0 : d1) + col * nChannels;
+        d[0] = yuv420Clamp(Y + dr);
+        d[1] = yuv420Clamp(Y + dg);
+        d[2] = yuv420Clamp(Y + db);
+        if (nChannels == 4)
+          d[3] = vpRGBa::alpha_default;
+      }
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+/*!
 
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+  Convert YUV420 [Y(NxM), U(N/2xM/2), V(N/2xM/2)] image into RGBa image.
 
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+  The alpha component of the converted image is set to vpRGBa::alpha_default.
 
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba - 4 * width + 1;
-    }
-    yuv += width;
-    rgba += 4 * width;
-  }
+*/
+void vpImageConvert::YUV420ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  const unsigned int size = width * height;
+  yuv420ToRGBx(yuv, yuv + size, yuv + 5 * size / 4, 1, width / 2, rgba, 4, width, height);
 }
 /*!
 
@@ -2049,126 +2129,8 @@ void vpImageConvert::YUV420ToRGBa(unsigned char *yuv, unsigned char *rgba, unsig
 */
 void vpImageConvert::YUV420ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iU = yuv + size;
-  unsigned char *iV = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb + 3 * width - 5;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb - 3 * width + 1;
-    }
-    yuv += width;
-    rgb += 3 * width;
-  }
+  const unsigned int size = width * height;
+  yuv420ToRGBx(yuv, yuv + size, yuv + 5 * size / 4, 1, width / 2, rgb, 3, width, height);
 }
 
 /*!
@@ -2286,137 +2248,104 @@ void vpImageConvert::YUV444ToGrey(unsigned char *yuv, unsigned char *grey, unsig
 
 /*!
 
-  Convert YV12 [Y(NxM), V(N/2xM/2), U(N/2xM/2)] image into RGBa image.
+  Convert NV12 [Y(NxM), UV(N/2xM/2) interleaved as U0 V0 U1 V1...] image
+  into RGBa image. This semi-planar format is output by many hardware
+  decoders and mobile cameras.
 
   The alpha component of the converted image is set to vpRGBa::alpha_default.
 
+  \param yuv : Input image, width x height x 3 / 2 bytes.
+  \param rgba : Output image, width x height x 4 bytes.
+  \param width, height : Image size, both even.
+
+  The conversion uses the same equations as YUV420ToRGBa() and is vectorized
+  with SSE2 when the CPU supports it.
 */
-void vpImageConvert::YV12ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+void vpImageConvert::NV12ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width,
+                                unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iV = yuv + size;
-  unsigned char *iU = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
+  const unsigned char *uv = yuv + width * height;
+  yuv420ToRGBx(yuv, uv, uv + 1, 2, width, rgba, 4, width, height);
+}
 
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+/*!
 
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+  Convert NV12 [Y(NxM), UV(N/2xM/2) interleaved as U0 V0 U1 V1...] image
+  into RGB image.
 
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+  \sa NV12ToRGBa()
+*/
+void vpImageConvert::NV12ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
+{
+  const unsigned char *uv = yuv + width * height;
+  yuv420ToRGBx(yuv, uv, uv + 1, 2, width, rgb, 3, width, height);
+}
 
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
+/*!
 
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+  Convert NV12 [Y(NxM), UV(N/2xM/2) interleaved as U0 V0 U1 V1...] image
+  into grey image, by copying the luminance plane.
 
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+*/
+void vpImageConvert::NV12ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int width,
+                                unsigned int height)
+{
+  memcpy(grey, yuv, (size_t)width * height);
+}
 
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+/*!
 
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = 0;
-      rgba = rgba + 4 * width - 7;
+  Convert NV21 [Y(NxM), VU(N/2xM/2) interleaved as V0 U0 V1 U1...] image
+  into RGBa image. This semi-planar format is the default preview format of
+  Android cameras.
 
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+  The alpha component of the converted image is set to vpRGBa::alpha_default.
 
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+  \sa NV12ToRGBa()
+*/
+void vpImageConvert::NV21ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width,
+                                unsigned int height)
+{
+  const unsigned char *vu = yuv + width * height;
+  yuv420ToRGBx(yuv, vu + 1, vu, 2, width, rgba, 4, width, height);
+}
 
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+/*!
 
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
+  Convert NV21 [Y(NxM), VU(N/2xM/2) interleaved as V0 U0 V1 U1...] image
+  into RGB image.
 
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+  \sa NV12ToRGBa()
+*/
+void vpImageConvert::NV21ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
+{
+  const unsigned char *vu = yuv + width * height;
+  yuv420ToRGBx(yuv, vu + 1, vu, 2, width, rgb, 3, width, height);
+}
 
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+/*!
 
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+  Convert NV21 [Y(NxM), VU(N/2xM/2) interleaved as V0 U0 V1 U1...] image
+  into grey image, by copying the luminance plane.
 
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba - 4 * width + 1;
-    }
-    yuv += width;
-    rgba += 4 * width;
-  }
+*/
+void vpImageConvert::NV21ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int width,
+                                unsigned int height)
+{
+  memcpy(grey, yuv, (size_t)width * height);
+}
+
+/*!
+
+  Convert YV12 [Y(NxM), V(N/2xM/2), U(N/2xM/2)] image into RGBa image.
+
+  The alpha component of the converted image is set to vpRGBa::alpha_default.
+
+*/
+void vpImageConvert::YV12ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  const unsigned int size = width * height;
+  yuv420ToRGBx(yuv, yuv + 5 * size / 4, yuv + size, 1, width / 2, rgba, 4, width, height);
 }
 /*!
 
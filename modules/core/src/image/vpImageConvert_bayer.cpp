@@ -0,0 +1,523 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bayer demosaicing.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImageConvert_bayer.cpp
+  \brief Bayer demosaicing and Bayer to grey conversions.
+*/
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Site types of the color filter array
+enum vpBayerSite { SITE_R, SITE_GR, SITE_GB, SITE_B };
+
+// Type of the site (i, j). Gr is a green site in a row that contains red
+// sites, Gb in a row that contains blue sites.
+vpBayerSite bayerSite(vpImageConvert::vpBayerPattern pattern, unsigned int i, unsigned int j)
+{
+  // Cell position of the red site
+  unsigned int ri = 0, rj = 0;
+  switch (pattern) {
+  case vpImageConvert::BAYER_BGGR:
+    ri = 1;
+    rj = 1;
+    break;
+  case vpImageConvert::BAYER_GBRG:
+    ri = 1;
+    rj = 0;
+    break;
+  case vpImageConvert::BAYER_GRBG:
+    ri = 0;
+    rj = 1;
+    break;
+  case vpImageConvert::BAYER_RGGB:
+  default:
+    break;
+  }
+  const bool redRow = (i & 1) == ri, redCol = (j & 1) == rj;
+  if (redRow)
+    return redCol ? SITE_R : SITE_GR;
+  return redCol ? SITE_GB : SITE_B;
+}
+
+// Mirrored index without repeating the border (-1 -> 1), that keeps the
+// parity of the color filter array
+inline int reflect(int i, int n)
+{
+  if (i < 0)
+    return -i;
+  if (i >= n)
+    return 2 * n - 2 - i;
+  return i;
+}
+
+inline int avg2(int a, int b) { return (a + b + 1) >> 1; }
+
+inline unsigned char clampPixel(int v) { return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+// Same coefficients as vpImageConvert::RGBToGrey(), in 8-bit fixed point
+inline unsigned char rgbToGrey(int r, int g, int b) { return (unsigned char)((54 * r + 183 * g + 19 * b + 128) >> 8); }
+
+struct vpBayerImage {
+  const unsigned char *data;
+  int width, height;
+  inline int at(int i, int j) const { return data[reflect(i, height) * width + reflect(j, width)]; }
+};
+
+// Bilinear interpolation of the missing colors of site (i, j). Averages are
+// computed pairwise with rounding, as _mm_avg_epu8() does.
+void bilinearPixel(const vpBayerImage &b, vpBayerSite site, int i, int j, int &r, int &g, int &bl)
+{
+  const int c = b.at(i, j);
+  const int h = avg2(b.at(i, j - 1), b.at(i, j + 1));
+  const int v = avg2(b.at(i - 1, j), b.at(i + 1, j));
+  switch (site) {
+  case SITE_R:
+    r = c;
+    g = avg2(h, v);
+    bl = avg2(avg2(b.at(i - 1, j - 1), b.at(i - 1, j + 1)), avg2(b.at(i + 1, j - 1), b.at(i + 1, j + 1)));
+    break;
+  case SITE_B:
+    r = avg2(avg2(b.at(i - 1, j - 1), b.at(i - 1, j + 1)), avg2(b.at(i + 1, j - 1), b.at(i + 1, j + 1)));
+    g = avg2(h, v);
+    bl = c;
+    break;
+  case SITE_GR:
+    r = h;
+    g = c;
+    bl = v;
+    break;
+  case SITE_GB:
+  default:
+    r = v;
+    g = c;
+    bl = h;
+    break;
+  }
+}
+
+// Malvar-He-Cutler gradient-corrected linear interpolation of the missing
+// colors of site (i, j), with the kernels scaled by 16
+void malvarPixel(const vpBayerImage &b, vpBayerSite site, int i, int j, int &r, int &g, int &bl)
+{
+  const int c = b.at(i, j);
+  const int n = b.at(i - 1, j), s = b.at(i + 1, j), w = b.at(i, j - 1), e = b.at(i, j + 1);
+  const int nn = b.at(i - 2, j), ss = b.at(i + 2, j), ww = b.at(i, j - 2), ee = b.at(i, j + 2);
+  const int diag = b.at(i - 1, j - 1) + b.at(i - 1, j + 1) + b.at(i + 1, j - 1) + b.at(i + 1, j + 1);
+
+  if (site == SITE_R || site == SITE_B) {
+    const int kg = clampPixel((8 * c + 4 * (n + s + w + e) - 2 * (nn + ss + ww + ee) + 8) >> 4);
+    const int kd = clampPixel((12 * c + 4 * diag - 3 * (nn + ss + ww + ee) + 8) >> 4);
+    g = kg;
+    r = site == SITE_R ? c : kd;
+    bl = site == SITE_R ? kd : c;
+  } else {
+    const int kh = clampPixel((10 * c + 8 * (w + e) - 2 * (ww + ee) - 2 * diag + nn + ss + 8) >> 4);
+    const int kv = clampPixel((10 * c + 8 * (n + s) - 2 * (nn + ss) - 2 * diag + ww + ee + 8) >> 4);
+    g = c;
+    r = site == SITE_GR ? kh : kv;
+    bl = site == SITE_GR ? kv : kh;
+  }
+}
+
+template <bool malvar>
+void demosaicPixel(const vpBayerImage &b, vpBayerSite site, int i, int j, unsigned char *rgba, unsigned char *grey)
+{
+  int r, g, bl;
+  if (malvar)
+    malvarPixel(b, site, i, j, r, g, bl);
+  else
+    bilinearPixel(b, site, i, j, r, g, bl);
+  if (rgba != NULL) {
+    rgba[4 * j] = (unsigned char)r;
+    rgba[4 * j + 1] = (unsigned char)g;
+    rgba[4 * j + 2] = (unsigned char)bl;
+    rgba[4 * j + 3] = vpRGBa::alpha_default;
+  }
+  if (grey != NULL) {
+    grey[j] = rgbToGrey(r, g, bl);
+  }
+}
+
+#if VISP_HAVE_SSE2
+inline __m128i select8(const __m128i &mask, const __m128i &a, const __m128i &b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline __m128i loadu(const unsigned char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+inline __m128i load8(const unsigned char *p)
+{
+  return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)), _mm_setzero_si128());
+}
+
+// Value of each channel for a site type, from the candidates computed for
+// all the pixels of a chunk
+inline void siteChannels(vpBayerSite site, const __m128i &c, const __m128i &k0, const __m128i &k1,
+                         const __m128i &k2, const __m128i &k3, __m128i &r, __m128i &g, __m128i &b)
+{
+  // k0: G at R/B sites, k1: R/B at R/B sites, k2: horizontal at G sites,
+  // k3: vertical at G sites
+  switch (site) {
+  case SITE_R:
+    r = c;
+    g = k0;
+    b = k1;
+    break;
+  case SITE_B:
+    r = k1;
+    g = k0;
+    b = c;
+    break;
+  case SITE_GR:
+    r = k2;
+    g = c;
+    b = k3;
+    break;
+  case SITE_GB:
+  default:
+    r = k3;
+    g = c;
+    b = k2;
+    break;
+  }
+}
+
+// Write 16 (or the low 8) pixels as RGBa and/or grey
+inline void storePixels(const __m128i &r, const __m128i &g, const __m128i &b, unsigned char *rgba,
+                        unsigned char *grey, bool half)
+{
+  if (rgba != NULL) {
+    const __m128i a = _mm_set1_epi8((char)vpRGBa::alpha_default);
+    const __m128i rg_lo = _mm_unpacklo_epi8(r, g), ba_lo = _mm_unpacklo_epi8(b, a);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rgba), _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+    if (!half) {
+      const __m128i rg_hi = _mm_unpackhi_epi8(r, g), ba_hi = _mm_unpackhi_epi8(b, a);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+    }
+  }
+  if (grey != NULL) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i cr = _mm_set1_epi16(54), cg = _mm_set1_epi16(183), cb = _mm_set1_epi16(19),
+                  round = _mm_set1_epi16(128);
+    // The weighted sum is at most 256 * 255 and fits in unsigned 16-bit lanes
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(r, zero), cr),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(g, zero), cg));
+    lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), cb)), round), 8);
+    if (half) {
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(grey), _mm_packus_epi16(lo, lo));
+    } else {
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(r, zero), cr),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(g, zero), cg));
+      hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), cb)), round),
+                          8);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(grey), _mm_packus_epi16(lo, hi));
+    }
+  }
+}
+
+// Bilinear demosaicing of 16 pixels of an interior row starting at column j
+void bilinearChunk(const unsigned char *p, int width, vpBayerSite evenSite, vpBayerSite oddSite, int j,
+                   unsigned char *rgba, unsigned char *grey)
+{
+  const unsigned char *up = p - width, *down = p + width;
+  const __m128i c = loadu(p);
+  const __m128i h = _mm_avg_epu8(loadu(p - 1), loadu(p + 1));
+  const __m128i v = _mm_avg_epu8(loadu(up), loadu(down));
+  const __m128i cross = _mm_avg_epu8(h, v);
+  const __m128i diag =
+      _mm_avg_epu8(_mm_avg_epu8(loadu(up - 1), loadu(up + 1)), _mm_avg_epu8(loadu(down - 1), loadu(down + 1)));
+
+  __m128i r0, g0, b0, r1, g1, b1;
+  siteChannels(evenSite, c, cross, diag, h, v, r0, g0, b0);
+  siteChannels(oddSite, c, cross, diag, h, v, r1, g1, b1);
+  // Lanes of even columns
+  const __m128i mask = (j & 1) ? _mm_set1_epi16((short)0xFF00) : _mm_set1_epi16(0x00FF);
+  storePixels(select8(mask, r0, r1), select8(mask, g0, g1), select8(mask, b0, b1), rgba ? rgba + 4 * j : NULL,
+              grey ? grey + j : NULL, false);
+}
+
+// Malvar-He-Cutler demosaicing of 8 pixels of an interior row starting at
+// column j, in 16-bit arithmetic
+void malvarChunk(const unsigned char *p, int width, vpBayerSite evenSite, vpBayerSite oddSite, int j,
+                 unsigned char *rgba, unsigned char *grey)
+{
+  const unsigned char *n1 = p - width, *s1 = p + width, *n2 = p - 2 * width, *s2 = p + 2 * width;
+  const __m128i c = load8(p);
+  const __m128i cross = _mm_add_epi16(_mm_add_epi16(load8(n1), load8(s1)), _mm_add_epi16(load8(p - 1), load8(p + 1)));
+  const __m128i we = _mm_add_epi16(load8(p - 1), load8(p + 1));
+  const __m128i ns = _mm_add_epi16(load8(n1), load8(s1));
+  const __m128i wwee = _mm_add_epi16(load8(p - 2), load8(p + 2));
+  const __m128i nnss = _mm_add_epi16(load8(n2), load8(s2));
+  const __m128i diag =
+      _mm_add_epi16(_mm_add_epi16(load8(n1 - 1), load8(n1 + 1)), _mm_add_epi16(load8(s1 - 1), load8(s1 + 1)));
+  const __m128i far4 = _mm_add_epi16(wwee, nnss);
+  const __m128i round = _mm_set1_epi16(8);
+
+  // 8c + 4 cross - 2 far
+  __m128i kg = _mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(c, 3), _mm_slli_epi16(cross, 2)), _mm_slli_epi16(far4, 1));
+  // 12c + 4 diag - 3 far
+  __m128i kd = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(c, 3), _mm_slli_epi16(c, 2)), _mm_slli_epi16(diag, 2));
+  kd = _mm_sub_epi16(kd, _mm_add_epi16(_mm_slli_epi16(far4, 1), far4));
+  // 10c - 2 diag, shared by the horizontal and vertical kernels
+  const __m128i c10 =
+      _mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(c, 3), _mm_slli_epi16(c, 1)), _mm_slli_epi16(diag, 1));
+  // + 8(w + e) - 2(ww + ee) + nn + ss
+  __m128i kh = _mm_add_epi16(_mm_add_epi16(c10, _mm_slli_epi16(we, 3)), _mm_sub_epi16(nnss, _mm_slli_epi16(wwee, 1)));
+  // + 8(n + s) - 2(nn + ss) + ww + ee
+  __m128i kv = _mm_add_epi16(_mm_add_epi16(c10, _mm_slli_epi16(ns, 3)), _mm_sub_epi16(wwee, _mm_slli_epi16(nnss, 1)));
+
+  kg = _mm_srai_epi16(_mm_add_epi16(kg, round), 4);
+  kd = _mm_srai_epi16(_mm_add_epi16(kd, round), 4);
+  kh = _mm_srai_epi16(_mm_add_epi16(kh, round), 4);
+  kv = _mm_srai_epi16(_mm_add_epi16(kv, round), 4);
+
+  // Saturate to bytes, the 8 pixels are in the low half
+  const __m128i c8 = _mm_packus_epi16(c, c), kg8 = _mm_packus_epi16(kg, kg), kd8 = _mm_packus_epi16(kd, kd),
+                kh8 = _mm_packus_epi16(kh, kh), kv8 = _mm_packus_epi16(kv, kv);
+
+  __m128i r0, g0, b0, r1, g1, b1;
+  siteChannels(evenSite, c8, kg8, kd8, kh8, kv8, r0, g0, b0);
+  siteChannels(oddSite, c8, kg8, kd8, kh8, kv8, r1, g1, b1);
+  const __m128i mask = (j & 1) ? _mm_set1_epi16((short)0xFF00) : _mm_set1_epi16(0x00FF);
+  storePixels(select8(mask, r0, r1), select8(mask, g0, g1), select8(mask, b0, b1), rgba ? rgba + 4 * j : NULL,
+              grey ? grey + j : NULL, true);
+}
+#endif
+
+// Demosaic row i. Either rgba or grey can be NULL.
+template <bool malvar>
+void demosaicRow(const vpBayerImage &b, vpImageConvert::vpBayerPattern pattern, int i, unsigned char *rgba,
+                 unsigned char *grey, bool useSSE2)
+{
+  const vpBayerSite siteEven = bayerSite(pattern, (unsigned int)i, 0);
+  const vpBayerSite siteOdd = bayerSite(pattern, (unsigned int)i, 1);
+  const int border = malvar ? 2 : 1;
+  int j = 0;
+
+  for (; j < border && j < b.width; j++) {
+    demosaicPixel<malvar>(b, (j & 1) ? siteOdd : siteEven, i, j, rgba, grey);
+  }
+#if VISP_HAVE_SSE2
+  if (useSSE2 && i >= border && i < b.height - border) {
+    const unsigned char *p = b.data + i * b.width;
+    const int step = malvar ? 8 : 16;
+    // The chunk reads up to column j + step - 1 + border
+    for (; j + step + border <= b.width; j += step) {
+      if (malvar)
+        malvarChunk(p + j, b.width, siteEven, siteOdd, j, rgba, grey);
+      else
+        bilinearChunk(p + j, b.width, siteEven, siteOdd, j, rgba, grey);
+    }
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; j < b.width; j++) {
+    demosaicPixel<malvar>(b, (j & 1) ? siteOdd : siteEven, i, j, rgba, grey);
+  }
+}
+
+// Demosaic the rows [begin, end)
+template <bool malvar> class DemosaicRows : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  DemosaicRows(const vpBayerImage &b, vpImageConvert::vpBayerPattern pattern, unsigned char *rgba,
+               unsigned char *grey, bool useSSE2)
+    : m_b(b), m_pattern(pattern), m_rgba(rgba), m_grey(grey), m_useSSE2(useSSE2)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const size_t width = (size_t)m_b.width;
+    for (unsigned int i = begin; i < end; i++) {
+      demosaicRow<malvar>(m_b, m_pattern, (int)i, m_rgba ? m_rgba + 4 * i * width : NULL,
+                          m_grey ? m_grey + i * width : NULL, m_useSSE2);
+    }
+  }
+
+private:
+  const vpBayerImage &m_b;
+  vpImageConvert::vpBayerPattern m_pattern;
+  unsigned char *m_rgba;
+  unsigned char *m_grey;
+  bool m_useSSE2;
+};
+
+template <bool malvar>
+void demosaic(const unsigned char *bayer, unsigned char *rgba, unsigned char *grey, unsigned int width,
+              unsigned int height, vpImageConvert::vpBayerPattern pattern)
+{
+  if (width < 3 || height < 3) {
+    throw(vpException(vpException::dimensionError, "Cannot demosaic a %dx%d Bayer image", width, height));
+  }
+  vpBayerImage b;
+  b.data = bayer;
+  b.width = (int)width;
+  b.height = (int)height;
+  const bool useSSE2 = vpCPUFeatures::checkSSE2();
+
+  vpThreadPool::getInstance().parallelFor(0, height, DemosaicRows<malvar>(b, pattern, rgba, grey, useSSE2));
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Convert a raw Bayer image into a RGBa image. The alpha component is set to
+  vpRGBa::alpha_default.
+
+  \param bayer : Input Bayer image, width x height pixels.
+  \param rgba : Output RGBa image, width x height x 4 bytes.
+  \param width, height : Image size, at least 3 x 3 pixels.
+  \param pattern : Arrangement of the color filter array.
+  \param method : BAYER_BILINEAR for a bilinear interpolation of the missing
+  colors, or BAYER_MALVAR for the gradient-corrected (edge-aware) linear
+  interpolation of Malvar, He and Cutler, that reduces the color fringes
+  along edges.
+
+  The image borders are interpolated by mirroring the image. Rows are
+  processed with SSE2 when the CPU supports it, and in parallel by
+  vpThreadPool.
+
+  \sa BayerToGrey(), BayerToGreyHalf()
+*/
+void vpImageConvert::BayerToRGBa(const unsigned char *bayer, unsigned char *rgba, unsigned int width,
+                                 unsigned int height, vpBayerPattern pattern, vpBayerDemosaicMethod method)
+{
+  if (method == BAYER_MALVAR)
+    demosaic<true>(bayer, rgba, NULL, width, height, pattern);
+  else
+    demosaic<false>(bayer, rgba, NULL, width, height, pattern);
+}
+
+/*!
+  Convert a raw Bayer image into a grey image of the same size, without
+  building the color image. The luminance is computed from the bilinear
+  interpolation of the colors with the coefficients of RGBToGrey().
+
+  \param bayer : Input Bayer image, width x height pixels.
+  \param grey : Output grey image, width x height pixels.
+  \param width, height : Image size, at least 3 x 3 pixels.
+  \param pattern : Arrangement of the color filter array.
+
+  \sa BayerToGreyHalf(), BayerToRGBa()
+*/
+void vpImageConvert::BayerToGrey(const unsigned char *bayer, unsigned char *grey, unsigned int width,
+                                 unsigned int height, vpBayerPattern pattern)
+{
+  demosaic<false>(bayer, NULL, grey, width, height, pattern);
+}
+
+/*!
+  Convert a raw Bayer image into a grey image of half resolution. Each 2x2
+  cell of the color filter array gives one grey pixel, computed from its red,
+  blue and averaged green values with the coefficients of RGBToGrey(). No
+  interpolation is needed, which makes it the fastest way to get a grey image
+  from a Bayer sensor.
+
+  \param bayer : Input Bayer image, width x height pixels.
+  \param grey : Output grey image, (width / 2) x (height / 2) pixels.
+  \param width, height : Size of the Bayer image.
+  \param pattern : Arrangement of the color filter array.
+
+  \sa BayerToGrey()
+*/
+void vpImageConvert::BayerToGreyHalf(const unsigned char *bayer, unsigned char *grey, unsigned int width,
+                                     unsigned int height, vpBayerPattern pattern)
+{
+  const unsigned int w = width / 2, h = height / 2;
+  // Position of the red and blue sites in a 2x2 cell, as 2 * row + col
+  unsigned int ir = 0;
+  switch (pattern) {
+  case BAYER_BGGR:
+    ir = 3;
+    break;
+  case BAYER_GBRG:
+    ir = 2;
+    break;
+  case BAYER_GRBG:
+    ir = 1;
+    break;
+  case BAYER_RGGB:
+  default:
+    break;
+  }
+  const unsigned int ib = 3 - ir, ig0 = ir ^ 1, ig1 = ir ^ 2;
+  const bool useSSE2 = vpCPUFeatures::checkSSE2();
+
+  for (unsigned int i = 0; i < h; i++) {
+    const unsigned char *row0 = bayer + 2 * i * width, *row1 = row0 + width;
+    unsigned char *dst = grey + i * w;
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    if (useSSE2) {
+      const __m128i evenMask = _mm_set1_epi16(0x00FF);
+      for (; j + 16 <= w; j += 16) {
+        const __m128i a0 = loadu(row0 + 2 * j), a1 = loadu(row0 + 2 * j + 16);
+        const __m128i b0 = loadu(row1 + 2 * j), b1 = loadu(row1 + 2 * j + 16);
+        // Sites of the cells, indexed as 2 * row + col
+        __m128i cell[4];
+        cell[0] = _mm_packus_epi16(_mm_and_si128(a0, evenMask), _mm_and_si128(a1, evenMask));
+        cell[1] = _mm_packus_epi16(_mm_srli_epi16(a0, 8), _mm_srli_epi16(a1, 8));
+        cell[2] = _mm_packus_epi16(_mm_and_si128(b0, evenMask), _mm_and_si128(b1, evenMask));
+        cell[3] = _mm_packus_epi16(_mm_srli_epi16(b0, 8), _mm_srli_epi16(b1, 8));
+        storePixels(cell[ir], _mm_avg_epu8(cell[ig0], cell[ig1]), cell[ib], NULL, dst + j, false);
+      }
+    }
+#else
+    (void)useSSE2;
+#endif
+    for (; j < w; j++) {
+      const unsigned char cell[4] = {row0[2 * j], row0[2 * j + 1], row1[2 * j], row1[2 * j + 1]};
+      dst[j] = rgbToGrey(cell[ir], avg2(cell[ig0], cell[ig1]), cell[ib]);
+    }
+  }
+}
@@ -36,8 +36,12 @@
  *
  *****************************************************************************/
 
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageView.h>
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 #include <opencv2/imgproc/imgproc.hpp>
 #elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020101)
@@ -46,6 +50,1068 @@
 #include <cv.h>
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+// AVX2 kernels are compiled for their own target and only called when the
+// CPU supports them
+#if VISP_HAVE_SSE2 && (defined(__x86_64__) || defined(__i386__)) &&                                                  \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define VISP_HAVE_AVX2_KERNEL 1
+#define VISP_TARGET_AVX2 __attribute__((target("avx2")))
+#elif VISP_HAVE_SSE2 && defined(_MSC_VER) && (_MSC_VER >= 1800)
+#include <immintrin.h>
+#define VISP_HAVE_AVX2_KERNEL 1
+#define VISP_TARGET_AVX2
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VISP_HAVE_NEON_KERNEL 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+/*
+  Kernels used by the row functions below. The 128-bit kernels are written
+  with SSE2 on x86 and with NEON on AArch64, where NEON is always available.
+  The AVX2 kernels process the same blocks with 256-bit registers and leave
+  the remaining pixels to the 128-bit and scalar kernels.
+*/
+enum vpSimdKernels { scalarKernels, vector128Kernels, avx2Kernels };
+
+vpSimdKernels selectSimdKernels()
+{
+  vpSimdKernels kernels = scalarKernels;
+#if VISP_HAVE_NEON_KERNEL
+  kernels = vector128Kernels;
+#endif
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    kernels = vector128Kernels;
+  }
+#endif
+#if VISP_HAVE_AVX2_KERNEL
+  if (kernels == vector128Kernels && vpCPUFeatures::checkAVX2()) {
+    kernels = avx2Kernels;
+  }
+#endif
+  return kernels;
+}
+
+vpSimdKernels simdKernels()
+{
+  static const vpSimdKernels kernels = selectSimdKernels();
+  return kernels;
+}
+
+// Mirrored neighbours, as in filterXLeftBorder() and filterXRightBorder()
+inline unsigned int mirrorLow(unsigned int j, unsigned int k) { return (j > k) ? j - k : k - j; }
+inline unsigned int mirrorHigh(unsigned int j, unsigned int k, unsigned int n)
+{
+  return (j + k < n) ? j + k : 2 * n - j - k - 1;
+}
+
+/*
+  Scalar kernels. The SIMD versions below accumulate in the same order, so
+  both give the same results.
+*/
+template <typename S, typename T>
+inline T filterPixelMirrored(const S *src, unsigned int j, unsigned int width, const T *filter, unsigned int half)
+{
+  T result = 0;
+  for (unsigned int k = 1; k <= half; k++) {
+    result += filter[k] * (src[mirrorHigh(j, k, width)] + src[mirrorLow(j, k)]);
+  }
+  return result + filter[0] * src[j];
+}
+
+template <typename S, typename T>
+inline T filterPixel(const S *src, unsigned int j, const T *filter, unsigned int half)
+{
+  T result = 0;
+  for (unsigned int k = 1; k <= half; k++) {
+    result += filter[k] * (src[j + k] + src[j - k]);
+  }
+  return result + filter[0] * src[j];
+}
+
+template <typename S, typename T>
+inline T derivativePixel(const S *src, unsigned int j, const T *filter, unsigned int half)
+{
+  T result = 0;
+  for (unsigned int k = 1; k <= half; k++) {
+    result += filter[k] * (src[j + k] - src[j - k]);
+  }
+  return result;
+}
+
+#if VISP_HAVE_SSE2
+// Eight consecutive output values, in double or float
+struct vpBlock8d {
+  __m128d v[4];
+};
+struct vpBlock8f {
+  __m128 v[2];
+};
+template <typename T> struct vpBlock8;
+template <> struct vpBlock8<double> {
+  typedef vpBlock8d type;
+};
+template <> struct vpBlock8<float> {
+  typedef vpBlock8f type;
+};
+
+inline void setZero(vpBlock8d &b) { b.v[0] = b.v[1] = b.v[2] = b.v[3] = _mm_setzero_pd(); }
+inline void setZero(vpBlock8f &b) { b.v[0] = b.v[1] = _mm_setzero_ps(); }
+
+inline void store(double *dst, const vpBlock8d &b)
+{
+  for (int m = 0; m < 4; m++) {
+    _mm_storeu_pd(dst + 2 * m, b.v[m]);
+  }
+}
+inline void store(float *dst, const vpBlock8f &b)
+{
+  _mm_storeu_ps(dst, b.v[0]);
+  _mm_storeu_ps(dst + 4, b.v[1]);
+}
+
+// Eight unsigned bytes widened to 16-bit lanes
+inline __m128i load8u(const unsigned char *p)
+{
+  return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)), _mm_setzero_si128());
+}
+
+// b += f * x, where x holds eight signed 16-bit integers
+inline void mulAdd(vpBlock8d &b, double f, const __m128i &x)
+{
+  const __m128d vf = _mm_set1_pd(f);
+  const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+  const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+  b.v[0] = _mm_add_pd(b.v[0], _mm_mul_pd(vf, _mm_cvtepi32_pd(lo)));
+  b.v[1] = _mm_add_pd(b.v[1], _mm_mul_pd(vf, _mm_cvtepi32_pd(_mm_srli_si128(lo, 8))));
+  b.v[2] = _mm_add_pd(b.v[2], _mm_mul_pd(vf, _mm_cvtepi32_pd(hi)));
+  b.v[3] = _mm_add_pd(b.v[3], _mm_mul_pd(vf, _mm_cvtepi32_pd(_mm_srli_si128(hi, 8))));
+}
+inline void mulAdd(vpBlock8f &b, float f, const __m128i &x)
+{
+  const __m128 vf = _mm_set1_ps(f);
+  const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+  const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+  b.v[0] = _mm_add_ps(b.v[0], _mm_mul_ps(vf, _mm_cvtepi32_ps(lo)));
+  b.v[1] = _mm_add_ps(b.v[1], _mm_mul_ps(vf, _mm_cvtepi32_ps(hi)));
+}
+
+// b += f * p, b += f * (p + q) and b += f * (p - q) on unsigned char data
+template <typename B, typename T> inline void mulAdd(B &b, T f, const unsigned char *p) { mulAdd(b, f, load8u(p)); }
+template <typename B, typename T>
+inline void mulAddSum(B &b, T f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_add_epi16(load8u(p), load8u(q)));
+}
+template <typename B, typename T>
+inline void mulAddDiff(B &b, T f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_sub_epi16(load8u(p), load8u(q)));
+}
+
+// Same on double data
+inline void mulAdd(vpBlock8d &b, double f, const double *p)
+{
+  const __m128d vf = _mm_set1_pd(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = _mm_add_pd(b.v[m], _mm_mul_pd(vf, _mm_loadu_pd(p + 2 * m)));
+  }
+}
+inline void mulAddSum(vpBlock8d &b, double f, const double *p, const double *q)
+{
+  const __m128d vf = _mm_set1_pd(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = _mm_add_pd(b.v[m], _mm_mul_pd(vf, _mm_add_pd(_mm_loadu_pd(p + 2 * m), _mm_loadu_pd(q + 2 * m))));
+  }
+}
+inline void mulAddDiff(vpBlock8d &b, double f, const double *p, const double *q)
+{
+  const __m128d vf = _mm_set1_pd(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = _mm_add_pd(b.v[m], _mm_mul_pd(vf, _mm_sub_pd(_mm_loadu_pd(p + 2 * m), _mm_loadu_pd(q + 2 * m))));
+  }
+}
+
+// Same on float data
+inline void mulAdd(vpBlock8f &b, float f, const float *p)
+{
+  const __m128 vf = _mm_set1_ps(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm_add_ps(b.v[m], _mm_mul_ps(vf, _mm_loadu_ps(p + 4 * m)));
+  }
+}
+inline void mulAddSum(vpBlock8f &b, float f, const float *p, const float *q)
+{
+  const __m128 vf = _mm_set1_ps(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm_add_ps(b.v[m], _mm_mul_ps(vf, _mm_add_ps(_mm_loadu_ps(p + 4 * m), _mm_loadu_ps(q + 4 * m))));
+  }
+}
+inline void mulAddDiff(vpBlock8f &b, float f, const float *p, const float *q)
+{
+  const __m128 vf = _mm_set1_ps(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm_add_ps(b.v[m], _mm_mul_ps(vf, _mm_sub_ps(_mm_loadu_ps(p + 4 * m), _mm_loadu_ps(q + 4 * m))));
+  }
+}
+#elif VISP_HAVE_NEON_KERNEL
+// Same blocks with NEON
+struct vpBlock8d {
+  float64x2_t v[4];
+};
+struct vpBlock8f {
+  float32x4_t v[2];
+};
+template <typename T> struct vpBlock8;
+template <> struct vpBlock8<double> {
+  typedef vpBlock8d type;
+};
+template <> struct vpBlock8<float> {
+  typedef vpBlock8f type;
+};
+
+inline void setZero(vpBlock8d &b) { b.v[0] = b.v[1] = b.v[2] = b.v[3] = vdupq_n_f64(0.); }
+inline void setZero(vpBlock8f &b) { b.v[0] = b.v[1] = vdupq_n_f32(0.f); }
+
+inline void store(double *dst, const vpBlock8d &b)
+{
+  for (int m = 0; m < 4; m++) {
+    vst1q_f64(dst + 2 * m, b.v[m]);
+  }
+}
+inline void store(float *dst, const vpBlock8f &b)
+{
+  vst1q_f32(dst, b.v[0]);
+  vst1q_f32(dst + 4, b.v[1]);
+}
+
+inline int16x8_t load8u(const unsigned char *p) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p))); }
+
+inline void mulAdd(vpBlock8d &b, double f, const int16x8_t &x)
+{
+  const float64x2_t vf = vdupq_n_f64(f);
+  const int32x4_t lo = vmovl_s16(vget_low_s16(x)), hi = vmovl_s16(vget_high_s16(x));
+  const int32x2_t x32[4] = {vget_low_s32(lo), vget_high_s32(lo), vget_low_s32(hi), vget_high_s32(hi)};
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = vaddq_f64(b.v[m], vmulq_f64(vf, vcvtq_f64_s64(vmovl_s32(x32[m]))));
+  }
+}
+inline void mulAdd(vpBlock8f &b, float f, const int16x8_t &x)
+{
+  const float32x4_t vf = vdupq_n_f32(f);
+  b.v[0] = vaddq_f32(b.v[0], vmulq_f32(vf, vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)))));
+  b.v[1] = vaddq_f32(b.v[1], vmulq_f32(vf, vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)))));
+}
+
+template <typename B, typename T> inline void mulAdd(B &b, T f, const unsigned char *p) { mulAdd(b, f, load8u(p)); }
+template <typename B, typename T>
+inline void mulAddSum(B &b, T f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, vaddq_s16(load8u(p), load8u(q)));
+}
+template <typename B, typename T>
+inline void mulAddDiff(B &b, T f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, vsubq_s16(load8u(p), load8u(q)));
+}
+
+inline void mulAdd(vpBlock8d &b, double f, const double *p)
+{
+  const float64x2_t vf = vdupq_n_f64(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = vaddq_f64(b.v[m], vmulq_f64(vf, vld1q_f64(p + 2 * m)));
+  }
+}
+inline void mulAddSum(vpBlock8d &b, double f, const double *p, const double *q)
+{
+  const float64x2_t vf = vdupq_n_f64(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = vaddq_f64(b.v[m], vmulq_f64(vf, vaddq_f64(vld1q_f64(p + 2 * m), vld1q_f64(q + 2 * m))));
+  }
+}
+inline void mulAddDiff(vpBlock8d &b, double f, const double *p, const double *q)
+{
+  const float64x2_t vf = vdupq_n_f64(f);
+  for (int m = 0; m < 4; m++) {
+    b.v[m] = vaddq_f64(b.v[m], vmulq_f64(vf, vsubq_f64(vld1q_f64(p + 2 * m), vld1q_f64(q + 2 * m))));
+  }
+}
+
+inline void mulAdd(vpBlock8f &b, float f, const float *p)
+{
+  const float32x4_t vf = vdupq_n_f32(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = vaddq_f32(b.v[m], vmulq_f32(vf, vld1q_f32(p + 4 * m)));
+  }
+}
+inline void mulAddSum(vpBlock8f &b, float f, const float *p, const float *q)
+{
+  const float32x4_t vf = vdupq_n_f32(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = vaddq_f32(b.v[m], vmulq_f32(vf, vaddq_f32(vld1q_f32(p + 4 * m), vld1q_f32(q + 4 * m))));
+  }
+}
+inline void mulAddDiff(vpBlock8f &b, float f, const float *p, const float *q)
+{
+  const float32x4_t vf = vdupq_n_f32(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = vaddq_f32(b.v[m], vmulq_f32(vf, vsubq_f32(vld1q_f32(p + 4 * m), vld1q_f32(q + 4 * m))));
+  }
+}
+#endif
+
+#if VISP_HAVE_AVX2_KERNEL
+// Same blocks in 256-bit registers
+struct vpBlock8dAVX2 {
+  __m256d v[2];
+};
+struct vpBlock8fAVX2 {
+  __m256 v;
+};
+template <typename T> struct vpBlock8AVX2;
+template <> struct vpBlock8AVX2<double> {
+  typedef vpBlock8dAVX2 type;
+};
+template <> struct vpBlock8AVX2<float> {
+  typedef vpBlock8fAVX2 type;
+};
+
+VISP_TARGET_AVX2 inline void setZero(vpBlock8dAVX2 &b) { b.v[0] = b.v[1] = _mm256_setzero_pd(); }
+VISP_TARGET_AVX2 inline void setZero(vpBlock8fAVX2 &b) { b.v = _mm256_setzero_ps(); }
+
+VISP_TARGET_AVX2 inline void store(double *dst, const vpBlock8dAVX2 &b)
+{
+  _mm256_storeu_pd(dst, b.v[0]);
+  _mm256_storeu_pd(dst + 4, b.v[1]);
+}
+VISP_TARGET_AVX2 inline void store(float *dst, const vpBlock8fAVX2 &b) { _mm256_storeu_ps(dst, b.v); }
+
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8dAVX2 &b, double f, const __m128i &x)
+{
+  const __m256d vf = _mm256_set1_pd(f);
+  b.v[0] = _mm256_add_pd(b.v[0], _mm256_mul_pd(vf, _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(x))));
+  b.v[1] = _mm256_add_pd(b.v[1], _mm256_mul_pd(vf, _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_srli_si128(x, 8)))));
+}
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8fAVX2 &b, float f, const __m128i &x)
+{
+  b.v = _mm256_add_ps(b.v, _mm256_mul_ps(_mm256_set1_ps(f), _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x))));
+}
+
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8dAVX2 &b, double f, const unsigned char *p) { mulAdd(b, f, load8u(p)); }
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8fAVX2 &b, float f, const unsigned char *p) { mulAdd(b, f, load8u(p)); }
+VISP_TARGET_AVX2 inline void mulAddSum(vpBlock8dAVX2 &b, double f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_add_epi16(load8u(p), load8u(q)));
+}
+VISP_TARGET_AVX2 inline void mulAddSum(vpBlock8fAVX2 &b, float f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_add_epi16(load8u(p), load8u(q)));
+}
+VISP_TARGET_AVX2 inline void mulAddDiff(vpBlock8dAVX2 &b, double f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_sub_epi16(load8u(p), load8u(q)));
+}
+VISP_TARGET_AVX2 inline void mulAddDiff(vpBlock8fAVX2 &b, float f, const unsigned char *p, const unsigned char *q)
+{
+  mulAdd(b, f, _mm_sub_epi16(load8u(p), load8u(q)));
+}
+
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8dAVX2 &b, double f, const double *p)
+{
+  const __m256d vf = _mm256_set1_pd(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm256_add_pd(b.v[m], _mm256_mul_pd(vf, _mm256_loadu_pd(p + 4 * m)));
+  }
+}
+VISP_TARGET_AVX2 inline void mulAddSum(vpBlock8dAVX2 &b, double f, const double *p, const double *q)
+{
+  const __m256d vf = _mm256_set1_pd(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm256_add_pd(b.v[m],
+                           _mm256_mul_pd(vf, _mm256_add_pd(_mm256_loadu_pd(p + 4 * m), _mm256_loadu_pd(q + 4 * m))));
+  }
+}
+VISP_TARGET_AVX2 inline void mulAddDiff(vpBlock8dAVX2 &b, double f, const double *p, const double *q)
+{
+  const __m256d vf = _mm256_set1_pd(f);
+  for (int m = 0; m < 2; m++) {
+    b.v[m] = _mm256_add_pd(b.v[m],
+                           _mm256_mul_pd(vf, _mm256_sub_pd(_mm256_loadu_pd(p + 4 * m), _mm256_loadu_pd(q + 4 * m))));
+  }
+}
+
+VISP_TARGET_AVX2 inline void mulAdd(vpBlock8fAVX2 &b, float f, const float *p)
+{
+  b.v = _mm256_add_ps(b.v, _mm256_mul_ps(_mm256_set1_ps(f), _mm256_loadu_ps(p)));
+}
+VISP_TARGET_AVX2 inline void mulAddSum(vpBlock8fAVX2 &b, float f, const float *p, const float *q)
+{
+  b.v = _mm256_add_ps(b.v, _mm256_mul_ps(_mm256_set1_ps(f), _mm256_add_ps(_mm256_loadu_ps(p), _mm256_loadu_ps(q))));
+}
+VISP_TARGET_AVX2 inline void mulAddDiff(vpBlock8fAVX2 &b, float f, const float *p, const float *q)
+{
+  b.v = _mm256_add_ps(b.v, _mm256_mul_ps(_mm256_set1_ps(f), _mm256_sub_ps(_mm256_loadu_ps(p), _mm256_loadu_ps(q))));
+}
+
+// Sixteen unsigned bytes widened to 16-bit lanes
+VISP_TARGET_AVX2 inline __m256i load16u(const unsigned char *p)
+{
+  return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+
+// Sixteen 16-bit lanes packed to bytes, in order
+VISP_TARGET_AVX2 inline void store16u(unsigned char *dst, const __m256i &x)
+{
+  const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(x, x), 0x08);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+}
+
+/*
+  AVX2 loops of the row kernels below. They start at pixel j, process whole
+  blocks and return the index of the first pixel left to the other kernels.
+*/
+template <typename S, typename T>
+VISP_TARGET_AVX2 unsigned int filterXBlocksAVX2(const S *src, T *dst, unsigned int j, unsigned int end,
+                                                const T *filter, unsigned int half)
+{
+  for (; j + 8 <= end; j += 8) {
+    typename vpBlock8AVX2<T>::type b;
+    setZero(b);
+    for (unsigned int k = 1; k <= half; k++) {
+      mulAddSum(b, filter[k], src + j + k, src + j - k);
+    }
+    mulAdd(b, filter[0], src + j);
+    store(dst + j, b);
+  }
+  return j;
+}
+
+template <typename S, typename T>
+VISP_TARGET_AVX2 unsigned int gradXBlocksAVX2(const S *src, T *dst, unsigned int j, unsigned int end,
+                                              const T *filter, unsigned int half)
+{
+  for (; j + 8 <= end; j += 8) {
+    typename vpBlock8AVX2<T>::type b;
+    setZero(b);
+    for (unsigned int k = 1; k <= half; k++) {
+      mulAddDiff(b, filter[k], src + j + k, src + j - k);
+    }
+    store(dst + j, b);
+  }
+  return j;
+}
+
+template <typename S, typename T>
+VISP_TARGET_AVX2 unsigned int filterYBlocksAVX2(const S *const *up, const S *const *down, const S *src, T *dst,
+                                                unsigned int width, const T *filter, unsigned int half)
+{
+  unsigned int j = 0;
+  for (; j + 8 <= width; j += 8) {
+    typename vpBlock8AVX2<T>::type b;
+    setZero(b);
+    for (unsigned int k = 1; k <= half; k++) {
+      mulAddSum(b, filter[k], down[k] + j, up[k] + j);
+    }
+    mulAdd(b, filter[0], src + j);
+    store(dst + j, b);
+  }
+  return j;
+}
+
+template <typename S, typename T>
+VISP_TARGET_AVX2 unsigned int gradYBlocksAVX2(const S *const *up, const S *const *down, T *dst, unsigned int width,
+                                              const T *filter, unsigned int half)
+{
+  unsigned int j = 0;
+  for (; j + 8 <= width; j += 8) {
+    typename vpBlock8AVX2<T>::type b;
+    setZero(b);
+    for (unsigned int k = 1; k <= half; k++) {
+      mulAddDiff(b, filter[k], down[k] + j, up[k] + j);
+    }
+    store(dst + j, b);
+  }
+  return j;
+}
+
+VISP_TARGET_AVX2 unsigned int blurXBlocksQ8AVX2(const unsigned char *src, unsigned short *dst, unsigned int j,
+                                                unsigned int end, const unsigned short *q, unsigned int half)
+{
+  for (; j + 16 <= end; j += 16) {
+    __m256i acc = _mm256_mullo_epi16(load16u(src + j), _mm256_set1_epi16((short)q[0]));
+    for (unsigned int k = 1; k <= half; k++) {
+      const __m256i s = _mm256_add_epi16(load16u(src + j + k), load16u(src + j - k));
+      acc = _mm256_add_epi16(acc, _mm256_mullo_epi16(s, _mm256_set1_epi16((short)q[k])));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), acc);
+  }
+  return j;
+}
+
+// acc0/acc1 += x * q on sixteen unsigned 16-bit integers. The unpacks work
+// within 128-bit lanes, which _mm256_packs_epi32() undoes.
+VISP_TARGET_AVX2 inline void mulAddU16(__m256i &acc0, __m256i &acc1, const __m256i &x, const __m256i &vq)
+{
+  const __m256i lo = _mm256_mullo_epi16(x, vq);
+  const __m256i hi = _mm256_mulhi_epu16(x, vq);
+  acc0 = _mm256_add_epi32(acc0, _mm256_unpacklo_epi16(lo, hi));
+  acc1 = _mm256_add_epi32(acc1, _mm256_unpackhi_epi16(lo, hi));
+}
+
+VISP_TARGET_AVX2 unsigned int blurYBlocksQ8AVX2(const unsigned short *const *up, const unsigned short *const *down,
+                                                const unsigned short *src, unsigned char *dst, unsigned int width,
+                                                const unsigned short *q, unsigned int half)
+{
+  const __m256i rounding = _mm256_set1_epi32(1 << 15);
+  unsigned int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    __m256i acc0 = rounding, acc1 = rounding;
+    mulAddU16(acc0, acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + j)),
+              _mm256_set1_epi16((short)q[0]));
+    for (unsigned int k = 1; k <= half; k++) {
+      const __m256i vq = _mm256_set1_epi16((short)q[k]);
+      mulAddU16(acc0, acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(up[k] + j)), vq);
+      mulAddU16(acc0, acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(down[k] + j)), vq);
+    }
+    store16u(dst + j, _mm256_packs_epi32(_mm256_srli_epi32(acc0, 16), _mm256_srli_epi32(acc1, 16)));
+  }
+  return j;
+}
+
+VISP_TARGET_AVX2 unsigned int gradXBlocksS16AVX2(const unsigned char *src, short *dst, unsigned int j,
+                                                 unsigned int end, const short *filter, unsigned int half)
+{
+  for (; j + 16 <= end; j += 16) {
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned int k = 1; k <= half; k++) {
+      const __m256i d = _mm256_sub_epi16(load16u(src + j + k), load16u(src + j - k));
+      acc = _mm256_add_epi16(acc, _mm256_mullo_epi16(d, _mm256_set1_epi16(filter[k])));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), acc);
+  }
+  return j;
+}
+
+VISP_TARGET_AVX2 unsigned int gradYBlocksS16AVX2(const unsigned char *const *up, const unsigned char *const *down,
+                                                 short *dst, unsigned int width, const short *filter,
+                                                 unsigned int half)
+{
+  unsigned int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned int k = 1; k <= half; k++) {
+      const __m256i d = _mm256_sub_epi16(load16u(down[k] + j), load16u(up[k] + j));
+      acc = _mm256_add_epi16(acc, _mm256_mullo_epi16(d, _mm256_set1_epi16(filter[k])));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), acc);
+  }
+  return j;
+}
+
+// Gaussian pyramid rows, as in getGaussXPyramidal() and getGaussYPyramidal()
+VISP_TARGET_AVX2 unsigned int gaussXPyramidalBlocksAVX2(const unsigned char *src, unsigned char *dst, unsigned int j,
+                                                        unsigned int width, unsigned int w)
+{
+  const __m256i mask = _mm256_set1_epi16(0x00ff);
+  for (; 2 * j + 34 <= width && j + 16 <= w - 1; j += 16) {
+    const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * j - 2));
+    const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * j));
+    const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * j + 2));
+    const __m256i e1 = _mm256_and_si256(v1, mask);
+    __m256i sum = _mm256_add_epi16(_mm256_and_si256(v0, mask), _mm256_and_si256(v2, mask));
+    sum = _mm256_add_epi16(
+        sum, _mm256_slli_epi16(_mm256_add_epi16(_mm256_srli_epi16(v0, 8), _mm256_srli_epi16(v1, 8)), 2));
+    sum = _mm256_add_epi16(sum, _mm256_add_epi16(_mm256_slli_epi16(e1, 2), _mm256_slli_epi16(e1, 1)));
+    store16u(dst + j, _mm256_srli_epi16(sum, 4));
+  }
+  return j;
+}
+
+VISP_TARGET_AVX2 unsigned int gaussYPyramidalBlocksAVX2(const unsigned char *const *r, unsigned char *dst,
+                                                        unsigned int width)
+{
+  unsigned int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    const __m256i v2 = load16u(r[2] + j);
+    __m256i sum = _mm256_add_epi16(load16u(r[0] + j), load16u(r[4] + j));
+    sum = _mm256_add_epi16(sum, _mm256_slli_epi16(_mm256_add_epi16(load16u(r[1] + j), load16u(r[3] + j)), 2));
+    sum = _mm256_add_epi16(sum, _mm256_add_epi16(_mm256_slli_epi16(v2, 2), _mm256_slli_epi16(v2, 1)));
+    store16u(dst + j, _mm256_srli_epi16(sum, 4));
+  }
+  return j;
+}
+#endif
+
+/*
+  Row kernels: symmetric filter along X with mirrored borders, derivative
+  filter along X with null borders, and their counterparts along Y that
+  combine the rows given in up[k] and down[k], k = 1..half.
+*/
+template <typename S, typename T>
+void filterXRow(const S *src, T *dst, unsigned int width, const T *filter, unsigned int half, vpSimdKernels simd)
+{
+  if (width <= 2 * half) {
+    for (unsigned int j = 0; j < width; j++) {
+      dst[j] = filterPixelMirrored(src, j, width, filter, half);
+    }
+    return;
+  }
+  unsigned int j = 0;
+  for (; j < half; j++) {
+    dst[j] = filterPixelMirrored(src, j, width, filter, half);
+  }
+  const unsigned int end = width - half;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = filterXBlocksAVX2(src, dst, j, end, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      typename vpBlock8<T>::type b;
+      setZero(b);
+      for (unsigned int k = 1; k <= half; k++) {
+        mulAddSum(b, filter[k], src + j + k, src + j - k);
+      }
+      mulAdd(b, filter[0], src + j);
+      store(dst + j, b);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < end; j++) {
+    dst[j] = filterPixel(src, j, filter, half);
+  }
+  for (; j < width; j++) {
+    dst[j] = filterPixelMirrored(src, j, width, filter, half);
+  }
+}
+
+template <typename S, typename T>
+void gradXRow(const S *src, T *dst, unsigned int width, const T *filter, unsigned int half, vpSimdKernels simd)
+{
+  if (width <= 2 * half) {
+    for (unsigned int j = 0; j < width; j++) {
+      dst[j] = 0;
+    }
+    return;
+  }
+  unsigned int j = 0;
+  for (; j < half; j++) {
+    dst[j] = 0;
+  }
+  const unsigned int end = width - half;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = gradXBlocksAVX2(src, dst, j, end, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      typename vpBlock8<T>::type b;
+      setZero(b);
+      for (unsigned int k = 1; k <= half; k++) {
+        mulAddDiff(b, filter[k], src + j + k, src + j - k);
+      }
+      store(dst + j, b);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < end; j++) {
+    dst[j] = derivativePixel(src, j, filter, half);
+  }
+  for (; j < width; j++) {
+    dst[j] = 0;
+  }
+}
+
+template <typename S, typename T>
+void filterYRow(const S *const *up, const S *const *down, const S *src, T *dst, unsigned int width, const T *filter,
+                unsigned int half, vpSimdKernels simd)
+{
+  unsigned int j = 0;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = filterYBlocksAVX2(up, down, src, dst, width, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= width; j += 8) {
+      typename vpBlock8<T>::type b;
+      setZero(b);
+      for (unsigned int k = 1; k <= half; k++) {
+        mulAddSum(b, filter[k], down[k] + j, up[k] + j);
+      }
+      mulAdd(b, filter[0], src + j);
+      store(dst + j, b);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < width; j++) {
+    T result = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      result += filter[k] * (down[k][j] + up[k][j]);
+    }
+    dst[j] = result + filter[0] * src[j];
+  }
+}
+
+template <typename S, typename T>
+void gradYRow(const S *const *up, const S *const *down, T *dst, unsigned int width, const T *filter,
+              unsigned int half, vpSimdKernels simd)
+{
+  unsigned int j = 0;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = gradYBlocksAVX2(up, down, dst, width, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= width; j += 8) {
+      typename vpBlock8<T>::type b;
+      setZero(b);
+      for (unsigned int k = 1; k <= half; k++) {
+        mulAddDiff(b, filter[k], down[k] + j, up[k] + j);
+      }
+      store(dst + j, b);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < width; j++) {
+    T result = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      result += filter[k] * (down[k][j] - up[k][j]);
+    }
+    dst[j] = result;
+  }
+}
+
+/*
+  Whole image versions. ImageType is a vpImage or a vpImageView whose pixels
+  are of type S.
+*/
+template <typename S, typename ImageType, typename T>
+void filterXImpl(const ImageType &I, vpImage<T> &dIx, const T *filter, unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const vpSimdKernels simd = simdKernels();
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    filterXRow<S, T>(I[i], dIx[i], I.getWidth(), filter, half, simd);
+  }
+}
+
+template <typename S, typename ImageType, typename T>
+void filterYImpl(const ImageType &I, vpImage<T> &dIy, const T *filter, unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const unsigned int height = I.getHeight();
+  const vpSimdKernels simd = simdKernels();
+  dIy.resize(height, I.getWidth());
+  std::vector<const S *> up(half + 1), down(half + 1);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int k = 1; k <= half; k++) {
+      up[k] = I[mirrorLow(i, k)];
+      down[k] = I[mirrorHigh(i, k, height)];
+    }
+    filterYRow<S, T>(&up[0], &down[0], I[i], dIy[i], I.getWidth(), filter, half, simd);
+  }
+}
+
+template <typename S, typename ImageType, typename T>
+void gradXImpl(const ImageType &I, vpImage<T> &dIx, const T *filter, unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const vpSimdKernels simd = simdKernels();
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    gradXRow<S, T>(I[i], dIx[i], I.getWidth(), filter, half, simd);
+  }
+}
+
+template <typename S, typename ImageType, typename T>
+void gradYImpl(const ImageType &I, vpImage<T> &dIy, const T *filter, unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  const vpSimdKernels simd = simdKernels();
+  dIy.resize(height, width);
+  std::vector<const S *> up(half + 1), down(half + 1);
+  for (unsigned int i = 0; i < height; i++) {
+    T *dst = dIy[i];
+    if (i < half || i + half >= height) {
+      for (unsigned int j = 0; j < width; j++) {
+        dst[j] = 0;
+      }
+      continue;
+    }
+    for (unsigned int k = 1; k <= half; k++) {
+      up[k] = I[i - k];
+      down[k] = I[i + k];
+    }
+    gradYRow<S, T>(&up[0], &down[0], dst, width, filter, half, simd);
+  }
+}
+
+/*
+  Fixed-point Gaussian blur. The kernel is quantized on 8 bits (its taps sum
+  to 256), the horizontal pass keeps the exact 16-bit sums and the vertical
+  pass rounds the 32-bit sums back to 8 bits.
+*/
+void getGaussianKernelQ8(unsigned short *q, unsigned int size, double sigma)
+{
+  const unsigned int half = (size - 1) / 2;
+  std::vector<double> fg(half + 1);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, true);
+  int sum = 0;
+  for (unsigned int k = 1; k <= half; k++) {
+    q[k] = (unsigned short)vpMath::round(fg[k] * 256.);
+    sum += 2 * q[k];
+  }
+  q[0] = (unsigned short)(256 - sum);
+}
+
+void blurXRowQ8(const unsigned char *src, unsigned short *dst, unsigned int width, const unsigned short *q,
+                unsigned int half, vpSimdKernels simd)
+{
+  unsigned int j = 0;
+  const unsigned int end = (width > 2 * half) ? width - half : 0;
+  for (; j < half && j < width; j++) {
+    unsigned int sum = q[0] * src[j];
+    for (unsigned int k = 1; k <= half; k++) {
+      sum += q[k] * (src[mirrorHigh(j, k, width)] + src[mirrorLow(j, k)]);
+    }
+    dst[j] = (unsigned short)sum;
+  }
+  // The sums fit in 16 bits, so wrapping intermediate products is harmless
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = blurXBlocksQ8AVX2(src, dst, j, end, q, half);
+  }
+#endif
+#if VISP_HAVE_SSE2
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      __m128i acc = _mm_mullo_epi16(load8u(src + j), _mm_set1_epi16((short)q[0]));
+      for (unsigned int k = 1; k <= half; k++) {
+        const __m128i s = _mm_add_epi16(load8u(src + j + k), load8u(src + j - k));
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(s, _mm_set1_epi16((short)q[k])));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), acc);
+    }
+  }
+#elif VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      uint16x8_t acc = vmulq_n_u16(vmovl_u8(vld1_u8(src + j)), q[0]);
+      for (unsigned int k = 1; k <= half; k++) {
+        acc = vmlaq_n_u16(acc, vaddl_u8(vld1_u8(src + j + k), vld1_u8(src + j - k)), q[k]);
+      }
+      vst1q_u16(dst + j, acc);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < end; j++) {
+    unsigned int sum = q[0] * src[j];
+    for (unsigned int k = 1; k <= half; k++) {
+      sum += q[k] * (src[j + k] + src[j - k]);
+    }
+    dst[j] = (unsigned short)sum;
+  }
+  for (; j < width; j++) {
+    unsigned int sum = q[0] * src[j];
+    for (unsigned int k = 1; k <= half; k++) {
+      sum += q[k] * (src[mirrorHigh(j, k, width)] + src[mirrorLow(j, k)]);
+    }
+    dst[j] = (unsigned short)sum;
+  }
+}
+
+#if VISP_HAVE_SSE2
+// acc0/acc1 += x * q, with x eight unsigned 16-bit integers and 32-bit results
+inline void mulAddU16(__m128i &acc0, __m128i &acc1, const __m128i &x, const __m128i &vq)
+{
+  const __m128i lo = _mm_mullo_epi16(x, vq);
+  const __m128i hi = _mm_mulhi_epu16(x, vq);
+  acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(lo, hi));
+  acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(lo, hi));
+}
+#endif
+
+void blurYRowQ8(const unsigned short *const *up, const unsigned short *const *down, const unsigned short *src,
+                unsigned char *dst, unsigned int width, const unsigned short *q, unsigned int half, vpSimdKernels simd)
+{
+  unsigned int j = 0;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = blurYBlocksQ8AVX2(up, down, src, dst, width, q, half);
+  }
+#endif
+#if VISP_HAVE_SSE2
+  if (simd != scalarKernels) {
+    const __m128i rounding = _mm_set1_epi32(1 << 15);
+    for (; j + 8 <= width; j += 8) {
+      __m128i acc0 = rounding, acc1 = rounding;
+      mulAddU16(acc0, acc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + j)),
+                _mm_set1_epi16((short)q[0]));
+      for (unsigned int k = 1; k <= half; k++) {
+        const __m128i vq = _mm_set1_epi16((short)q[k]);
+        mulAddU16(acc0, acc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(up[k] + j)), vq);
+        mulAddU16(acc0, acc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down[k] + j)), vq);
+      }
+      const __m128i res = _mm_packs_epi32(_mm_srli_epi32(acc0, 16), _mm_srli_epi32(acc1, 16));
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + j), _mm_packus_epi16(res, res));
+    }
+  }
+#elif VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= width; j += 8) {
+      const uint16x8_t x = vld1q_u16(src + j);
+      uint32x4_t acc0 = vmlal_n_u16(vdupq_n_u32(1u << 15), vget_low_u16(x), q[0]);
+      uint32x4_t acc1 = vmlal_n_u16(vdupq_n_u32(1u << 15), vget_high_u16(x), q[0]);
+      for (unsigned int k = 1; k <= half; k++) {
+        const uint16x8_t u = vld1q_u16(up[k] + j), d = vld1q_u16(down[k] + j);
+        acc0 = vmlal_n_u16(vmlal_n_u16(acc0, vget_low_u16(u), q[k]), vget_low_u16(d), q[k]);
+        acc1 = vmlal_n_u16(vmlal_n_u16(acc1, vget_high_u16(u), q[k]), vget_high_u16(d), q[k]);
+      }
+      vst1_u8(dst + j, vqmovn_u16(vcombine_u16(vshrn_n_u32(acc0, 16), vshrn_n_u32(acc1, 16))));
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < width; j++) {
+    unsigned int sum = (1u << 15) + (unsigned int)q[0] * src[j];
+    for (unsigned int k = 1; k <= half; k++) {
+      sum += (unsigned int)q[k] * up[k][j] + (unsigned int)q[k] * down[k][j];
+    }
+    dst[j] = (unsigned char)(sum >> 16);
+  }
+}
+
+/*
+  Fixed-point derivative filters on 16-bit signed integers. As with
+  vpImageFilter::getGradX(), borders are set to 0.
+*/
+void gradXRowS16(const unsigned char *src, short *dst, unsigned int width, const short *filter, unsigned int half,
+                 vpSimdKernels simd)
+{
+  unsigned int j = 0;
+  const unsigned int end = (width > 2 * half) ? width - half : 0;
+  for (; j < half && j < width; j++) {
+    dst[j] = 0;
+  }
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = gradXBlocksS16AVX2(src, dst, j, end, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      __m128i acc = _mm_setzero_si128();
+      for (unsigned int k = 1; k <= half; k++) {
+        const __m128i d = _mm_sub_epi16(load8u(src + j + k), load8u(src + j - k));
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(d, _mm_set1_epi16(filter[k])));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), acc);
+    }
+  }
+#elif VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= end; j += 8) {
+      int16x8_t acc = vdupq_n_s16(0);
+      for (unsigned int k = 1; k <= half; k++) {
+        const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(src + j + k), vld1_u8(src + j - k)));
+        acc = vmlaq_n_s16(acc, d, filter[k]);
+      }
+      vst1q_s16(dst + j, acc);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < end; j++) {
+    int result = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      result += filter[k] * (src[j + k] - src[j - k]);
+    }
+    dst[j] = (short)result;
+  }
+  for (; j < width; j++) {
+    dst[j] = 0;
+  }
+}
+
+void gradYRowS16(const unsigned char *const *up, const unsigned char *const *down, short *dst, unsigned int width,
+                 const short *filter, unsigned int half, vpSimdKernels simd)
+{
+  unsigned int j = 0;
+#if VISP_HAVE_AVX2_KERNEL
+  if (simd == avx2Kernels) {
+    j = gradYBlocksS16AVX2(up, down, dst, width, filter, half);
+  }
+#endif
+#if VISP_HAVE_SSE2
+  if (simd != scalarKernels) {
+    for (; j + 8 <= width; j += 8) {
+      __m128i acc = _mm_setzero_si128();
+      for (unsigned int k = 1; k <= half; k++) {
+        const __m128i d = _mm_sub_epi16(load8u(down[k] + j), load8u(up[k] + j));
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(d, _mm_set1_epi16(filter[k])));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), acc);
+    }
+  }
+#elif VISP_HAVE_NEON_KERNEL
+  if (simd != scalarKernels) {
+    for (; j + 8 <= width; j += 8) {
+      int16x8_t acc = vdupq_n_s16(0);
+      for (unsigned int k = 1; k <= half; k++) {
+        const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(down[k] + j), vld1_u8(up[k] + j)));
+        acc = vmlaq_n_s16(acc, d, filter[k]);
+      }
+      vst1q_s16(dst + j, acc);
+    }
+  }
+#else
+  (void)simd;
+#endif
+  for (; j < width; j++) {
+    int result = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      result += filter[k] * (down[k][j] - up[k][j]);
+    }
+    dst[j] = (short)result;
+  }
+}
+} // namespace
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Apply a filter to an image.
   \param I : Image to filter
@@ -74,6 +1140,17 @@
   Only pixels in the input image fully covered by the kernel are considered.
 */
 void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpMatrix &M, const bool convolve)
+{
+  vpImageFilter::filter(vpImageView<const unsigned char>(I), If, M, convolve);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filter(const vpImageView<const unsigned char> &I, vpImage<double> &If, const vpMatrix &M,
+                           const bool convolve)
 {
   unsigned int size_y = M.getRows(), size_x = M.getCols();
   unsigned int half_size_y = size_y / 2, half_size_x = size_x / 2;
@@ -223,6 +1300,17 @@ void vpImageFilter::filter(const vpImage<double> &I, vpImage<double> &Iu, vpImag
 */
 void vpImageFilter::sepFilter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
                               const vpColVector &kernelV)
+{
+  vpImageFilter::sepFilter(vpImageView<const unsigned char>(I), If, kernelH, kernelV);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::sepFilter(const vpImageView<const unsigned char> &I, vpImage<double> &If,
+                              const vpColVector &kernelH, const vpColVector &kernelV)
 {
   unsigned int size = kernelH.size();
   unsigned int half_size = size / 2;
@@ -325,6 +1413,17 @@ void vpImageFilter::canny(const vpImage<unsigned char> &Isrc, vpImage<unsigned c
  */
 void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double> &GI, const double *filter,
                            unsigned int size)
+{
+  vpImageFilter::filter(vpImageView<const unsigned char>(I), GI, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filter(const vpImageView<const unsigned char> &I, vpImage<double> &GI, const double *filter,
+                           unsigned int size)
 {
   vpImage<double> GIx;
   filterX(I, GIx, filter, size);
@@ -346,76 +1445,112 @@ void vpImageFilter::filter(const vpImage<double> &I, vpImage<double> &GI, const
 void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                             unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  vpImageFilter::filterX(vpImageView<const unsigned char>(I), dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filterX(const vpImageView<const unsigned char> &I, vpImage<double> &dIx, const double *filter,
+                            unsigned int size)
+{
+  filterXImpl<unsigned char>(I, dIx, filter, size);
+}
+void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  filterXImpl<double>(I, dIx, filter, size);
+}
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
+                            unsigned int size)
+{
+  vpImageFilter::filterY(vpImageView<const unsigned char>(I), dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filterY(const vpImageView<const unsigned char> &I, vpImage<double> &dIy, const double *filter,
+                            unsigned int size)
+{
+  filterYImpl<unsigned char>(I, dIy, filter, size);
+}
+void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  filterYImpl<double>(I, dIy, filter, size);
+}
+
+/*!
+  Apply a symmetric 1D filter along the rows of an image, with single
+  precision results. Borders are mirrored.
+
+  \param I : Input image.
+  \param dIx : Filtered image.
+  \param filter : Half of the filter coefficients, filter[0] being the
+  central one, as given by getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                            unsigned int size)
+{
+  filterXImpl<unsigned char>(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filterX(const vpImageView<const unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                            unsigned int size)
+{
+  filterXImpl<unsigned char>(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+*/
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size)
+{
+  filterXImpl<float>(I, dIx, filter, size);
 }
-void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+
+/*!
+  Apply a symmetric 1D filter along the columns of an image, with single
+  precision results. Borders are mirrored.
+
+  \param I : Input image.
+  \param dIy : Filtered image.
+  \param filter : Half of the filter coefficients, filter[0] being the
+  central one, as given by getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                            unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  filterYImpl<unsigned char>(I, dIy, filter, size);
 }
-void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::filterY(const vpImageView<const unsigned char> &I, vpImage<float> &dIy, const float *filter,
                             unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  filterYImpl<unsigned char>(I, dIy, filter, size);
 }
-void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+
+/*!
+  \overload
+*/
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  filterYImpl<float>(I, dIy, filter, size);
 }
 
 /*!
@@ -431,6 +1566,17 @@ void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, cons
  */
 void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double> &GI, unsigned int size, double sigma,
                                  bool normalize)
+{
+  vpImageFilter::gaussianBlur(vpImageView<const unsigned char>(I), GI, size, sigma, normalize);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<double> &GI, unsigned int size,
+                                 double sigma, bool normalize)
 {
   double *fg = new double[(size + 1) / 2];
   vpImageFilter::getGaussianKernel(fg, size, sigma, normalize);
@@ -464,6 +1610,91 @@ void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double> &GI,
   delete[] fg;
 }
 
+/*!
+  Apply a Gaussian blur to an image, with single precision results. This is
+  faster than the double precision version since twice as many values fit
+  in a SIMD register.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or
+  negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter
+  coefficients or not.
+*/
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<float> &GI, unsigned int size, double sigma,
+                                 bool normalize)
+{
+  vpImageFilter::gaussianBlur(vpImageView<const unsigned char>(I), GI, size, sigma, normalize);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<float> &GI, unsigned int size,
+                                 double sigma, bool normalize)
+{
+  std::vector<float> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  vpImage<float> GIx;
+  vpImageFilter::filterX(I, GIx, &fg[0], size);
+  vpImageFilter::filterY(GIx, GI, &fg[0], size);
+}
+
+/*!
+  Apply a Gaussian blur to an image, in fixed-point arithmetic.
+
+  The normalized kernel is quantized to 8 bits, the horizontal pass is
+  computed exactly on 16 bits and the vertical pass is rounded to the
+  nearest integer. The result differs by at most one grey level from the
+  double precision blur rounded to unsigned char, and it is computed 8
+  pixels at a time when SSE2 is available.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or
+  negative, it is computed from filter size as sigma = (size-1)/6.
+*/
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, unsigned int size,
+                                 double sigma)
+{
+  vpImageFilter::gaussianBlur(vpImageView<const unsigned char>(I), GI, size, sigma);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::gaussianBlur(const vpImageView<const unsigned char> &I, vpImage<unsigned char> &GI,
+                                 unsigned int size, double sigma)
+{
+  const unsigned int half = (size - 1) / 2;
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  const vpSimdKernels simd = simdKernels();
+  std::vector<unsigned short> q(half + 1);
+  getGaussianKernelQ8(&q[0], size, sigma);
+
+  vpImage<unsigned short> GIx(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    blurXRowQ8(I[i], GIx[i], width, &q[0], half, simd);
+  }
+
+  GI.resize(height, width);
+  std::vector<const unsigned short *> up(half + 1), down(half + 1);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int k = 1; k <= half; k++) {
+      up[k] = GIx[mirrorLow(i, k)];
+      down[k] = GIx[mirrorHigh(i, k, height)];
+    }
+    blurYRowQ8(&up[0], &down[0], GIx[i], GI[i], width, &q[0], half, simd);
+  }
+}
+
 /*!
   Return the coefficients of a Gaussian filter.
 
@@ -543,6 +1774,34 @@ void vpImageFilter::getGaussianDerivativeKernel(double *filter, unsigned int siz
   }
 }
 
+/*!
+  \overload
+
+  Single precision coefficients, for the filters on vpImage<float>.
+*/
+void vpImageFilter::getGaussianKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  for (unsigned int i = 0; i < fg.size(); i++) {
+    filter[i] = (float)fg[i];
+  }
+}
+
+/*!
+  \overload
+
+  Single precision coefficients, for the filters on vpImage<float>.
+*/
+void vpImageFilter::getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> fg((size + 1) / 2);
+  vpImageFilter::getGaussianDerivativeKernel(&fg[0], size, sigma, normalize);
+  for (unsigned int i = 0; i < fg.size(); i++) {
+    filter[i] = (float)fg[i];
+  }
+}
+
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx)
 {
   dIx.resize(I.getHeight(), I.getWidth());
@@ -584,79 +1843,182 @@ void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &d
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                              unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  vpImageFilter::getGradX(vpImageView<const unsigned char>(I), dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradX(const vpImageView<const unsigned char> &I, vpImage<double> &dIx, const double *filter,
+                             unsigned int size)
+{
+  gradXImpl<unsigned char>(I, dIx, filter, size);
 }
 void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  // dIx=0;
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  gradXImpl<double>(I, dIx, filter, size);
 }
 
 void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
                              unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
+  vpImageFilter::getGradY(vpImageView<const unsigned char>(I), dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradY(const vpImageView<const unsigned char> &I, vpImage<double> &dIy, const double *filter,
+                             unsigned int size)
+{
+  gradYImpl<unsigned char>(I, dIy, filter, size);
 }
 
 void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  // dIy=0;
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
+  gradYImpl<double>(I, dIy, filter, size);
+}
+
+/*!
+  Compute the gradient along X with a derivative filter, with single
+  precision results. Borders are set to 0.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Half of the derivative filter coefficients, as given by
+  getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                             unsigned int size)
+{
+  gradXImpl<unsigned char>(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradX(const vpImageView<const unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                             unsigned int size)
+{
+  gradXImpl<unsigned char>(I, dIx, filter, size);
+}
+
+/*!
+  Compute the gradient along Y with a derivative filter, with single
+  precision results. Borders are set to 0.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Half of the derivative filter coefficients, as given by
+  getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                             unsigned int size)
+{
+  gradYImpl<unsigned char>(I, dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradY(const vpImageView<const unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                             unsigned int size)
+{
+  gradYImpl<unsigned char>(I, dIy, filter, size);
+}
+
+/*!
+  Compute the gradient along X with an integer derivative filter, in 16-bit
+  fixed-point arithmetic. Borders are set to 0.
+
+  The result is exact as long as 255 times the sum of the absolute values of
+  the coefficients fits in a short. A Gaussian derivative kernel can be
+  scaled and rounded to integers for that purpose, the gradient then being
+  scaled by the same factor.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Half of the derivative filter coefficients, filter[0]
+  being unused.
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<short> &dIx, const short *filter,
+                             unsigned int size)
+{
+  vpImageFilter::getGradX(vpImageView<const unsigned char>(I), dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradX(const vpImageView<const unsigned char> &I, vpImage<short> &dIx, const short *filter,
+                             unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const vpSimdKernels simd = simdKernels();
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    gradXRowS16(I[i], dIx[i], I.getWidth(), filter, half, simd);
   }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
+}
+
+/*!
+  Compute the gradient along Y with an integer derivative filter, in 16-bit
+  fixed-point arithmetic. Borders are set to 0.
+
+  The result is exact as long as 255 times the sum of the absolute values of
+  the coefficients fits in a short.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Half of the derivative filter coefficients, filter[0]
+  being unused.
+  \param size : Filter size. This value should be odd.
+*/
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<short> &dIy, const short *filter,
+                             unsigned int size)
+{
+  vpImageFilter::getGradY(vpImageView<const unsigned char>(I), dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradY(const vpImageView<const unsigned char> &I, vpImage<short> &dIy, const short *filter,
+                             unsigned int size)
+{
+  const unsigned int half = (size - 1) / 2;
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  const vpSimdKernels simd = simdKernels();
+  dIy.resize(height, width);
+  std::vector<const unsigned char *> up(half + 1), down(half + 1);
+  for (unsigned int i = 0; i < height; i++) {
+    short *dst = dIy[i];
+    if (i < half || i + half >= height) {
+      for (unsigned int j = 0; j < width; j++) {
+        dst[j] = 0;
+      }
+      continue;
     }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      up[k] = I[i - k];
+      down[k] = I[i + k];
     }
+    gradYRowS16(&up[0], &down[0], dst, width, filter, half, simd);
   }
 }
 
@@ -672,6 +2034,19 @@ void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double> &dIy, con
  */
 void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *gaussianKernel,
                                     const double *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImageFilter::getGradXGauss2D(vpImageView<const unsigned char>(I), dIx, gaussianKernel, gaussianDerivativeKernel,
+                                 size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradXGauss2D(const vpImageView<const unsigned char> &I, vpImage<double> &dIx,
+                                    const double *gaussianKernel, const double *gaussianDerivativeKernel,
+                                    unsigned int size)
 {
   vpImage<double> GIy;
   vpImageFilter::filterY(I, GIy, gaussianKernel, size);
@@ -690,6 +2065,19 @@ void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<dou
  */
 void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *gaussianKernel,
                                     const double *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImageFilter::getGradYGauss2D(vpImageView<const unsigned char>(I), dIy, gaussianKernel, gaussianDerivativeKernel,
+                                 size);
+}
+
+/*!
+  \overload
+
+  Applied on a view of the image, which avoids copying a region of interest.
+*/
+void vpImageFilter::getGradYGauss2D(const vpImageView<const unsigned char> &I, vpImage<double> &dIy,
+                                    const double *gaussianKernel, const double *gaussianDerivativeKernel,
+                                    unsigned int size)
 {
   vpImage<double> GIx;
   vpImageFilter::filterX(I, GIx, gaussianKernel, size);
@@ -744,14 +2132,55 @@ void vpImageFilter::getGaussXPyramidal(const vpImage<unsigned char> &I, vpImage<
   }
 #else
   unsigned int w = I.getWidth() / 2;
+  const vpSimdKernels simd = simdKernels();
 
   GI.resize(I.getHeight(), w);
   for (unsigned int i = 0; i < I.getHeight(); i++) {
-    GI[i][0] = I[i][0];
-    for (unsigned int j = 1; j < w - 1; j++) {
-      GI[i][j] = vpImageFilter::filterGaussXPyramidal(I, i, 2 * j);
+    const unsigned char *src = I[i];
+    unsigned char *dst = GI[i];
+    dst[0] = src[0];
+    unsigned int j = 1;
+#if VISP_HAVE_AVX2_KERNEL
+    if (simd == avx2Kernels) {
+      j = gaussXPyramidalBlocksAVX2(src, dst, j, I.getWidth(), w);
+    }
+#endif
+#if VISP_HAVE_SSE2
+    if (simd != scalarKernels) {
+      // Same integer result as filterGaussXPyramidal(), 8 pixels at a time.
+      // Even and odd source pixels are split from the 16-bit lanes.
+      const __m128i mask = _mm_set1_epi16(0x00ff);
+      for (; 2 * j + 18 <= I.getWidth() && j + 8 <= w - 1; j += 8) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * j - 2));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * j));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * j + 2));
+        const __m128i e1 = _mm_and_si128(v1, mask);
+        __m128i sum = _mm_add_epi16(_mm_and_si128(v0, mask), _mm_and_si128(v2, mask));
+        sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_add_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8)), 2));
+        sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(e1, 2), _mm_slli_epi16(e1, 1)));
+        sum = _mm_srli_epi16(sum, 4);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + j), _mm_packus_epi16(sum, sum));
+      }
+    }
+#elif VISP_HAVE_NEON_KERNEL
+    if (simd != scalarKernels) {
+      // Even and odd source pixels are split by the interleaved loads
+      for (; 2 * j + 18 <= I.getWidth() && j + 8 <= w - 1; j += 8) {
+        const uint8x8x2_t v0 = vld2_u8(src + 2 * j - 2), v1 = vld2_u8(src + 2 * j);
+        const uint8x8_t e2 = vld2_u8(src + 2 * j + 2).val[0];
+        uint16x8_t sum = vaddl_u8(v0.val[0], e2);
+        sum = vaddq_u16(sum, vshlq_n_u16(vaddl_u8(v0.val[1], v1.val[1]), 2));
+        sum = vmlaq_n_u16(sum, vmovl_u8(v1.val[0]), 6);
+        vst1_u8(dst + j, vshrn_n_u16(sum, 4));
+      }
+    }
+#else
+    (void)simd;
+#endif
+    for (; j < w - 1; j++) {
+      dst[j] = vpImageFilter::filterGaussXPyramidal(I, i, 2 * j);
     }
-    GI[i][w - 1] = I[i][2 * w - 1];
+    dst[w - 1] = src[2 * w - 1];
   }
 
 #endif
@@ -771,15 +2200,51 @@ void vpImageFilter::getGaussYPyramidal(const vpImage<unsigned char> &I, vpImage<
 
 #else
   unsigned int h = I.getHeight() / 2;
-
-  GI.resize(h, I.getWidth());
-  for (unsigned int j = 0; j < I.getWidth(); j++) {
-    GI[0][j] = I[0][j];
-    for (unsigned int i = 1; i < h - 1; i++) {
-      GI[i][j] = vpImageFilter::filterGaussYPyramidal(I, 2 * i, j);
+  const unsigned int width = I.getWidth();
+  const vpSimdKernels simd = simdKernels();
+
+  GI.resize(h, width);
+  memcpy(GI[0], I[0], width);
+  // Row by row, with the same integer result as filterGaussYPyramidal()
+  for (unsigned int i = 1; i < h - 1; i++) {
+    const unsigned char *r0 = I[2 * i - 2], *r1 = I[2 * i - 1], *r2 = I[2 * i], *r3 = I[2 * i + 1],
+                        *r4 = I[2 * i + 2];
+    unsigned char *dst = GI[i];
+    unsigned int j = 0;
+#if VISP_HAVE_AVX2_KERNEL
+    if (simd == avx2Kernels) {
+      const unsigned char *r[5] = {r0, r1, r2, r3, r4};
+      j = gaussYPyramidalBlocksAVX2(r, dst, width);
+    }
+#endif
+#if VISP_HAVE_SSE2
+    if (simd != scalarKernels) {
+      for (; j + 8 <= width; j += 8) {
+        const __m128i v2 = load8u(r2 + j);
+        __m128i sum = _mm_add_epi16(load8u(r0 + j), load8u(r4 + j));
+        sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_add_epi16(load8u(r1 + j), load8u(r3 + j)), 2));
+        sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(v2, 2), _mm_slli_epi16(v2, 1)));
+        sum = _mm_srli_epi16(sum, 4);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + j), _mm_packus_epi16(sum, sum));
+      }
+    }
+#elif VISP_HAVE_NEON_KERNEL
+    if (simd != scalarKernels) {
+      for (; j + 8 <= width; j += 8) {
+        uint16x8_t sum = vaddl_u8(vld1_u8(r0 + j), vld1_u8(r4 + j));
+        sum = vaddq_u16(sum, vshlq_n_u16(vaddl_u8(vld1_u8(r1 + j), vld1_u8(r3 + j)), 2));
+        sum = vmlaq_n_u16(sum, vmovl_u8(vld1_u8(r2 + j)), 6);
+        vst1_u8(dst + j, vshrn_n_u16(sum, 4));
+      }
+    }
+#else
+    (void)simd;
+#endif
+    for (; j < width; j++) {
+      dst[j] = (unsigned char)((r0[j] + 4 * r1[j] + 6 * r2[j] + 4 * r3[j] + r4[j]) >> 4);
     }
-    GI[h - 1][j] = I[2 * h - 1][j];
   }
+  memcpy(GI[h - 1], I[2 * h - 1], width);
 #endif
 }
 
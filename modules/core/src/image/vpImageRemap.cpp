@@ -0,0 +1,471 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed image remapping.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageRemap.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Sub-pixel coordinates are quantized on 1/INTER_SIZE of pixel, and the
+// weights of the four pixels sum to INTER_SIZE^2
+const int INTER_BITS = 5;
+const int INTER_SIZE = 1 << INTER_BITS;
+const int WEIGHT_BITS = 2 * INTER_BITS;
+const int WEIGHT_ROUND = 1 << (WEIGHT_BITS - 1);
+// Weights of a pixel outside of the source image
+const unsigned short OUTSIDE_INDEX = (INTER_SIZE + 1) * (INTER_SIZE + 1);
+
+bool checkSSE2()
+{
+#if VISP_HAVE_SSE2
+  return vpCPUFeatures::checkSSE2();
+#else
+  return false;
+#endif
+}
+
+class vpRemapGrayBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpRemapGrayBody(const vpImage<unsigned char> &I, vpImage<unsigned char> &Idst, const int *offsets,
+                  const unsigned short *indexes, const short *weights)
+    : m_I(I), m_Idst(Idst), m_offsets(offsets), m_indexes(indexes), m_weights(weights), m_useSSE2(checkSSE2())
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int width = m_Idst.getWidth();
+    const int stride = (int)m_I.getWidth();
+    const unsigned char *src = m_I.bitmap;
+
+    for (unsigned int i = begin; i < end; i++) {
+      const int *offsets = m_offsets + i * width;
+      const unsigned short *indexes = m_indexes + i * width;
+      unsigned char *dst = m_Idst[i];
+      unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+      if (m_useSSE2) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi32(WEIGHT_ROUND);
+        for (; j + 8 <= width; j += 8) {
+          // Gather the pairs of horizontal neighbors of the 8 pixels, and
+          // interleave the matching weights for _mm_madd_epi16()
+          unsigned short top[8], bottom[8];
+          __m128i w[8];
+          for (unsigned int k = 0; k < 8; k++) {
+            const unsigned char *p = src + offsets[j + k];
+            memcpy(&top[k], p, sizeof(unsigned short));
+            memcpy(&bottom[k], p + stride, sizeof(unsigned short));
+            w[k] = _mm_loadl_epi64((const __m128i *)(m_weights + 4 * indexes[j + k]));
+          }
+
+          const __m128i t = _mm_loadu_si128((const __m128i *)top);
+          const __m128i b = _mm_loadu_si128((const __m128i *)bottom);
+          __m128i sum[2];
+          for (unsigned int k = 0; k < 2; k++) {
+            const __m128i w01 = _mm_unpacklo_epi32(w[4 * k], w[4 * k + 1]);
+            const __m128i w23 = _mm_unpacklo_epi32(w[4 * k + 2], w[4 * k + 3]);
+            const __m128i pt = k == 0 ? _mm_unpacklo_epi8(t, zero) : _mm_unpackhi_epi8(t, zero);
+            const __m128i pb = k == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+            sum[k] = _mm_add_epi32(_mm_madd_epi16(pt, _mm_unpacklo_epi64(w01, w23)),
+                                   _mm_madd_epi16(pb, _mm_unpackhi_epi64(w01, w23)));
+            sum[k] = _mm_srai_epi32(_mm_add_epi32(sum[k], round), WEIGHT_BITS);
+          }
+
+          const __m128i res = _mm_packs_epi32(sum[0], sum[1]);
+          _mm_storel_epi64((__m128i *)(dst + j), _mm_packus_epi16(res, res));
+        }
+      }
+#endif
+
+      for (; j < width; j++) {
+        const unsigned char *p = src + offsets[j];
+        const short *w = m_weights + 4 * indexes[j];
+        const int sum = p[0] * w[0] + p[1] * w[1] + p[stride] * w[2] + p[stride + 1] * w[3];
+        dst[j] = (unsigned char)((sum + WEIGHT_ROUND) >> WEIGHT_BITS);
+      }
+    }
+  }
+
+private:
+  const vpImage<unsigned char> &m_I;
+  vpImage<unsigned char> &m_Idst;
+  const int *m_offsets;
+  const unsigned short *m_indexes;
+  const short *m_weights;
+  bool m_useSSE2;
+};
+
+class vpRemapRGBaBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpRemapRGBaBody(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Idst, const int *offsets, const unsigned short *indexes,
+                  const short *weights)
+    : m_I(I), m_Idst(Idst), m_offsets(offsets), m_indexes(indexes), m_weights(weights), m_useSSE2(checkSSE2())
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int width = m_Idst.getWidth();
+    const int stride = (int)m_I.getWidth();
+    const vpRGBa *src = m_I.bitmap;
+
+    for (unsigned int i = begin; i < end; i++) {
+      const int *offsets = m_offsets + i * width;
+      const unsigned short *indexes = m_indexes + i * width;
+      vpRGBa *dst = m_Idst[i];
+
+#if VISP_HAVE_SSE2
+      if (m_useSSE2) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi32(WEIGHT_ROUND);
+        for (unsigned int j = 0; j < width; j++) {
+          // Interleave the channels of the horizontal neighbors
+          const vpRGBa *p = src + offsets[j];
+          const __m128i t = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p), zero);
+          const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(p + stride)), zero);
+          const __m128i pt = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8));
+          const __m128i pb = _mm_unpacklo_epi16(b, _mm_srli_si128(b, 8));
+
+          const __m128i w = _mm_loadl_epi64((const __m128i *)(m_weights + 4 * indexes[j]));
+          __m128i sum = _mm_add_epi32(_mm_madd_epi16(pt, _mm_shuffle_epi32(w, 0x00)),
+                                      _mm_madd_epi16(pb, _mm_shuffle_epi32(w, 0x55)));
+          sum = _mm_srai_epi32(_mm_add_epi32(sum, round), WEIGHT_BITS);
+
+          const __m128i res = _mm_packs_epi32(sum, sum);
+          const int rgba = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+          memcpy((unsigned char *)(dst + j), &rgba, sizeof(vpRGBa));
+        }
+        continue;
+      }
+#endif
+
+      for (unsigned int j = 0; j < width; j++) {
+        const unsigned char *p = (const unsigned char *)(src + offsets[j]);
+        const unsigned char *q = p + stride * sizeof(vpRGBa);
+        const short *w = m_weights + 4 * indexes[j];
+        unsigned char *d = (unsigned char *)(dst + j);
+        for (unsigned int c = 0; c < 4; c++) {
+          const int sum = p[c] * w[0] + p[c + 4] * w[1] + q[c] * w[2] + q[c + 4] * w[3];
+          d[c] = (unsigned char)((sum + WEIGHT_ROUND) >> WEIGHT_BITS);
+        }
+      }
+    }
+  }
+
+private:
+  const vpImage<vpRGBa> &m_I;
+  vpImage<vpRGBa> &m_Idst;
+  const int *m_offsets;
+  const unsigned short *m_indexes;
+  const short *m_weights;
+  bool m_useSSE2;
+};
+} // namespace
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The table is empty until one of the init methods is
+  called.
+*/
+vpImageRemap::vpImageRemap()
+  : m_srcWidth(0), m_srcHeight(0), m_dstWidth(0), m_dstHeight(0), m_offsets(), m_weightIndexes(),
+    m_weights(4 * (OUTSIDE_INDEX + 1), 0)
+{
+  for (int fy = 0; fy <= INTER_SIZE; fy++) {
+    for (int fx = 0; fx <= INTER_SIZE; fx++) {
+      short *w = &m_weights[4 * (fy * (INTER_SIZE + 1) + fx)];
+      w[0] = (short)((INTER_SIZE - fx) * (INTER_SIZE - fy));
+      w[1] = (short)(fx * (INTER_SIZE - fy));
+      w[2] = (short)((INTER_SIZE - fx) * fy);
+      w[3] = (short)(fx * fy);
+    }
+  }
+}
+
+/*!
+  Initialize the table from arbitrary maps of source coordinates.
+
+  \param mapU : For each destination pixel, horizontal coordinate of the
+  matching point in the source image.
+  \param mapV : For each destination pixel, vertical coordinate of the
+  matching point in the source image.
+  \param srcWidth : Width of the source images.
+  \param srcHeight : Height of the source images.
+
+  The destination images have the size of the maps.
+*/
+void vpImageRemap::init(const vpImage<float> &mapU, const vpImage<float> &mapV, unsigned int srcWidth,
+                        unsigned int srcHeight)
+{
+  if (mapU.getWidth() != mapV.getWidth() || mapU.getHeight() != mapV.getHeight()) {
+    throw(vpException(vpException::dimensionError, "The two maps do not have the same size"));
+  }
+
+  resizeTable(srcWidth, srcHeight, mapU.getWidth(), mapU.getHeight());
+  for (unsigned int k = 0; k < mapU.getSize(); k++) {
+    setCoordinates(k, mapU.bitmap[k], mapV.bitmap[k]);
+  }
+}
+
+/*!
+  Initialize the table to warp the images by a homography.
+
+  \param H : 3x3 homography that transforms the homogeneous pixel
+  coordinates \f$(u, v, 1)\f$ of the source image into the ones of the
+  destination image.
+  \param srcWidth : Width of the source images.
+  \param srcHeight : Height of the source images.
+  \param dstWidth : Width of the destination images.
+  \param dstHeight : Height of the destination images.
+*/
+void vpImageRemap::initHomography(const vpMatrix &H, unsigned int srcWidth, unsigned int srcHeight,
+                                  unsigned int dstWidth, unsigned int dstHeight)
+{
+  if (H.getRows() != 3 || H.getCols() != 3) {
+    throw(vpException(vpException::dimensionError, "The homography is not a 3x3 matrix"));
+  }
+
+  // The adjugate of H is its inverse up to a scale factor, which is enough
+  // for homogeneous coordinates
+  double Hinv[3][3];
+  for (unsigned int r = 0; r < 3; r++) {
+    for (unsigned int c = 0; c < 3; c++) {
+      const unsigned int c1 = (r + 1) % 3, c2 = (r + 2) % 3, r1 = (c + 1) % 3, r2 = (c + 2) % 3;
+      Hinv[r][c] = H[r1][c1] * H[r2][c2] - H[r1][c2] * H[r2][c1];
+    }
+  }
+
+  resizeTable(srcWidth, srcHeight, dstWidth, dstHeight);
+  for (unsigned int i = 0; i < dstHeight; i++) {
+    for (unsigned int j = 0; j < dstWidth; j++) {
+      const double x = Hinv[0][0] * j + Hinv[0][1] * i + Hinv[0][2];
+      const double y = Hinv[1][0] * j + Hinv[1][1] * i + Hinv[1][2];
+      const double z = Hinv[2][0] * j + Hinv[2][1] * i + Hinv[2][2];
+      if (std::fabs(z) > std::numeric_limits<double>::epsilon()) {
+        setCoordinates(i * dstWidth + j, x / z, y / z);
+      } else {
+        setCoordinates(i * dstWidth + j, -1, -1);
+      }
+    }
+  }
+}
+
+/*!
+  Initialize the table to resize the images with a bilinear interpolation.
+  The corners of the source and destination images are matched, as in
+  vpImageTools::resize().
+
+  \param srcWidth : Width of the source images.
+  \param srcHeight : Height of the source images.
+  \param dstWidth : Width of the destination images.
+  \param dstHeight : Height of the destination images.
+*/
+void vpImageRemap::initResize(unsigned int srcWidth, unsigned int srcHeight, unsigned int dstWidth,
+                              unsigned int dstHeight)
+{
+  const double scaleX = dstWidth > 1 ? (srcWidth - 1) / (double)(dstWidth - 1) : 0.;
+  const double scaleY = dstHeight > 1 ? (srcHeight - 1) / (double)(dstHeight - 1) : 0.;
+
+  resizeTable(srcWidth, srcHeight, dstWidth, dstHeight);
+  for (unsigned int i = 0; i < dstHeight; i++) {
+    for (unsigned int j = 0; j < dstWidth; j++) {
+      setCoordinates(i * dstWidth + j, j * scaleX, i * scaleY);
+    }
+  }
+}
+
+/*!
+  Initialize the table to undistort the images of a camera. The
+  undistorted images have the size and the intrinsic parameters of the
+  distorted ones, as with vpImageTools::undistort().
+
+  \param cam : Parameters of the camera causing distortion.
+  \param width : Width of the images.
+  \param height : Height of the images.
+*/
+void vpImageRemap::initUndistort(const vpCameraParameters &cam, unsigned int width, unsigned int height)
+{
+  initUndistortRectify(cam, width, height, vpRotationMatrix(),
+                       vpCameraParameters(cam.get_px(), cam.get_py(), cam.get_u0(), cam.get_v0()), width, height);
+}
+
+/*!
+  Initialize the table to undistort, rectify and resize the images of a
+  camera in a single pass.
+
+  \param cam : Parameters of the camera causing distortion.
+  \param srcWidth : Width of the source images.
+  \param srcHeight : Height of the source images.
+  \param R : Rotation from the frame of the rectified camera to the frame of
+  the camera, which is the identity to only undistort the images.
+  \param camNew : Intrinsic parameters of the rectified camera. Its
+  distortion parameters are ignored. Scaling the parameters of \e cam and
+  the size of the images by the same factor resizes the images.
+  \param dstWidth : Width of the destination images.
+  \param dstHeight : Height of the destination images.
+*/
+void vpImageRemap::initUndistortRectify(const vpCameraParameters &cam, unsigned int srcWidth, unsigned int srcHeight,
+                                        const vpRotationMatrix &R, const vpCameraParameters &camNew,
+                                        unsigned int dstWidth, unsigned int dstHeight)
+{
+  const double u0 = cam.get_u0(), v0 = cam.get_v0(), px = cam.get_px(), py = cam.get_py();
+  const double kud = cam.get_projModel() == vpCameraParameters::perspectiveProjWithDistortion ? cam.get_kud() : 0.;
+
+  double r[3][3];
+  for (unsigned int k = 0; k < 3; k++) {
+    for (unsigned int l = 0; l < 3; l++) {
+      r[k][l] = R[k][l];
+    }
+  }
+
+  resizeTable(srcWidth, srcHeight, dstWidth, dstHeight);
+  for (unsigned int i = 0; i < dstHeight; i++) {
+    const double y_new = (i - camNew.get_v0()) / camNew.get_py();
+    for (unsigned int j = 0; j < dstWidth; j++) {
+      const double x_new = (j - camNew.get_u0()) / camNew.get_px();
+      const double X = r[0][0] * x_new + r[0][1] * y_new + r[0][2];
+      const double Y = r[1][0] * x_new + r[1][1] * y_new + r[1][2];
+      const double Z = r[2][0] * x_new + r[2][1] * y_new + r[2][2];
+      if (Z > std::numeric_limits<double>::epsilon()) {
+        const double x = X / Z, y = Y / Z;
+        const double fr = 1.0 + kud * (x * x + y * y);
+        setCoordinates(i * dstWidth + j, u0 + px * x * fr, v0 + py * y * fr);
+      } else {
+        setCoordinates(i * dstWidth + j, -1, -1);
+      }
+    }
+  }
+}
+
+/*!
+  Transform a grayscale image.
+
+  \param I : Source image, whose size must be the one given to initialize
+  the table.
+  \param Idst : Destination image, resized if needed. It must be different
+  from \e I.
+*/
+void vpImageRemap::remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Idst) const
+{
+  if (I.getWidth() != m_srcWidth || I.getHeight() != m_srcHeight) {
+    throw(vpException(vpException::dimensionError, "The image does not have the size of the remap table"));
+  }
+
+  Idst.resize(m_dstHeight, m_dstWidth);
+  if (Idst.getSize() == 0) {
+    return;
+  }
+  vpThreadPool::getInstance().parallelFor(
+      0, m_dstHeight, vpRemapGrayBody(I, Idst, &m_offsets[0], &m_weightIndexes[0], &m_weights[0]));
+}
+
+/*!
+  Transform a color image. The four channels are interpolated.
+
+  \param I : Source image, whose size must be the one given to initialize
+  the table.
+  \param Idst : Destination image, resized if needed. It must be different
+  from \e I.
+*/
+void vpImageRemap::remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Idst) const
+{
+  if (I.getWidth() != m_srcWidth || I.getHeight() != m_srcHeight) {
+    throw(vpException(vpException::dimensionError, "The image does not have the size of the remap table"));
+  }
+
+  Idst.resize(m_dstHeight, m_dstWidth);
+  if (Idst.getSize() == 0) {
+    return;
+  }
+  vpThreadPool::getInstance().parallelFor(
+      0, m_dstHeight, vpRemapRGBaBody(I, Idst, &m_offsets[0], &m_weightIndexes[0], &m_weights[0]));
+}
+
+void vpImageRemap::resizeTable(unsigned int srcWidth, unsigned int srcHeight, unsigned int dstWidth,
+                               unsigned int dstHeight)
+{
+  if (srcWidth < 2 || srcHeight < 2) {
+    throw(vpException(vpException::dimensionError, "The source images must have at least 2 rows and 2 columns"));
+  }
+
+  m_srcWidth = srcWidth;
+  m_srcHeight = srcHeight;
+  m_dstWidth = dstWidth;
+  m_dstHeight = dstHeight;
+  m_offsets.resize(dstWidth * dstHeight);
+  m_weightIndexes.resize(dstWidth * dstHeight);
+}
+
+void vpImageRemap::setCoordinates(unsigned int index, double u, double v)
+{
+  // Points closer to the border than half a sub-pixel step are kept, to be
+  // robust to rounding errors, e.g. on the last column when resizing
+  const double margin = 0.5 / INTER_SIZE;
+  if (!(u >= -margin && u <= m_srcWidth - 1 + margin && v >= -margin && v <= m_srcHeight - 1 + margin)) {
+    m_offsets[index] = 0;
+    m_weightIndexes[index] = OUTSIDE_INDEX;
+    return;
+  }
+
+  u = std::min(std::max(u, 0.), m_srcWidth - 1.);
+  v = std::min(std::max(v, 0.), m_srcHeight - 1.);
+  // On the last row and column, use the previous one with a full weight on
+  // the next one
+  const int j = std::min((int)u, (int)m_srcWidth - 2);
+  const int i = std::min((int)v, (int)m_srcHeight - 2);
+  const int fx = vpMath::round((u - j) * INTER_SIZE);
+  const int fy = vpMath::round((v - i) * INTER_SIZE);
+
+  m_offsets[index] = i * (int)m_srcWidth + j;
+  m_weightIndexes[index] = (unsigned short)(fy * (INTER_SIZE + 1) + fx);
+}
@@ -76,6 +76,28 @@
 #define USE_SSE 1
 #endif
 
+// Products with fewer multiply-adds are not worth packing the operands
+#define VP_MATRIX_NATIVE_GEMM_MIN_OPS 4096
+// A^T A with at most this number of columns is computed row by row
+#define VP_MATRIX_ATA_SMALL_COLS 16
+
+unsigned int vpMatrix::m_lapack_min_size = 16;
+
+/*
+  Return true when a M x K by K x N product has to be computed with BLAS.
+*/
+bool vpMatrix::useLapack(unsigned int M, unsigned int N, unsigned int K)
+{
+#if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
+  return (M >= m_lapack_min_size && N >= m_lapack_min_size && K >= m_lapack_min_size);
+#else
+  (void)M;
+  (void)N;
+  (void)K;
+  return false;
+#endif
+}
+
 // Prototypes of specific functions
 vpMatrix subblock(const vpMatrix &, unsigned int, unsigned int);
 
@@ -448,6 +470,11 @@ void vpMatrix::AAt(vpMatrix &B) const
   if ((B.rowNum != rowNum) || (B.colNum != rowNum))
     B.resize(rowNum, rowNum, false, false);
 
+  if ((double)rowNum * rowNum * colNum > VP_MATRIX_NATIVE_GEMM_MIN_OPS) {
+    native_dgemm(false, true, rowNum, rowNum, colNum, data, colNum, data, colNum, B.data, rowNum);
+    return;
+  }
+
   // compute A*A^T
   for (unsigned int i = 0; i < rowNum; i++) {
     for (unsigned int j = i; j < rowNum; j++) {
@@ -483,37 +510,44 @@ void vpMatrix::AtA(vpMatrix &B) const
     B.resize(colNum, colNum, false, false);
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char transa = 'n';
-  char transb = 't';
+  if (useLapack(colNum, colNum, rowNum)) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char transa = 'n';
+    char transb = 't';
+
+    vpMatrix::blas_dgemm(transa, transb, colNum, colNum, rowNum, alpha, data, colNum, data, colNum, beta, B.data,
+                         colNum);
+    return;
+  }
+#endif
 
-  vpMatrix::blas_dgemm(transa, transb, colNum, colNum, rowNum, alpha, data, colNum, data, colNum, beta, B.data, colNum);
-#else
-  unsigned int i, j, k;
-  double s;
-  double *ptr;
-  for (i = 0; i < colNum; i++) {
-    double *Bi = B[i];
-    for (j = 0; j < i; j++) {
-      ptr = data;
-      s = 0;
-      for (k = 0; k < rowNum; k++) {
-        s += (*(ptr + i)) * (*(ptr + j));
-        ptr += colNum;
+  if (colNum > VP_MATRIX_ATA_SMALL_COLS) {
+    native_dgemm(true, false, colNum, colNum, rowNum, data, colNum, data, colNum, B.data, colNum);
+    return;
+  }
+
+  // Accumulate the outer products of the rows of A in the lower triangle of
+  // a local buffer, reading A once and contiguously
+  double acc[VP_MATRIX_ATA_SMALL_COLS * VP_MATRIX_ATA_SMALL_COLS];
+  for (unsigned int i = 0; i < colNum * colNum; i++) {
+    acc[i] = 0.;
+  }
+  for (unsigned int k = 0; k < rowNum; k++) {
+    const double *ak = rowPtrs[k];
+    for (unsigned int i = 0; i < colNum; i++) {
+      double *acc_i = acc + i * colNum;
+      const double aki = ak[i];
+      for (unsigned int j = 0; j <= i; j++) {
+        acc_i[j] += aki * ak[j];
       }
-      *Bi++ = s;
-      B[j][i] = s;
     }
-    ptr = data;
-    s = 0;
-    for (k = 0; k < rowNum; k++) {
-      s += (*(ptr + i)) * (*(ptr + i));
-      ptr += colNum;
+  }
+  for (unsigned int i = 0; i < colNum; i++) {
+    for (unsigned int j = 0; j <= i; j++) {
+      B.rowPtrs[i][j] = B.rowPtrs[j][i] = acc[i * colNum + j];
     }
-    *Bi = s;
   }
-#endif
 }
 
 /*!
@@ -773,21 +807,18 @@ void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVe
     w.resize(A.rowNum, false);
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char trans = 't';
-  int incr = 1;
+  if (useLapack(A.rowNum, 1, A.colNum)) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char trans = 't';
+    int incr = 1;
 
-  vpMatrix::blas_dgemv(trans, A.colNum, A.rowNum, alpha, A.data, A.colNum, v.data, incr, beta, w.data, incr);
-#else
-  w = 0.0;
-  for (unsigned int j = 0; j < A.colNum; j++) {
-    double vj = v[j]; // optimization em 5/12/2006
-    for (unsigned int i = 0; i < A.rowNum; i++) {
-      w[i] += A.rowPtrs[i][j] * vj;
-    }
+    vpMatrix::blas_dgemv(trans, A.colNum, A.rowNum, alpha, A.data, A.colNum, v.data, incr, beta, w.data, incr);
+    return;
   }
 #endif
+
+  native_dgemv(A.rowNum, A.colNum, A.data, A.colNum, v.data, w.data);
 }
 
 //---------------------------------
@@ -814,29 +845,38 @@ void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
   }
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char trans = 'n';
+  if (useLapack(A.rowNum, B.colNum, A.colNum)) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char trans = 'n';
 
-  vpMatrix::blas_dgemm(trans, trans, B.colNum, A.rowNum, A.colNum, alpha, B.data, B.colNum, A.data, A.colNum, beta,
-                       C.data, B.colNum);
-#else
-  // 5/12/06 some "very" simple optimization to avoid indexation
+    vpMatrix::blas_dgemm(trans, trans, B.colNum, A.rowNum, A.colNum, alpha, B.data, B.colNum, A.data, A.colNum, beta,
+                         C.data, B.colNum);
+    return;
+  }
+#endif
+
+  if ((double)A.rowNum * B.colNum * A.colNum > VP_MATRIX_NATIVE_GEMM_MIN_OPS) {
+    native_dgemm(false, false, A.rowNum, B.colNum, A.colNum, A.data, A.colNum, B.data, B.colNum, C.data, B.colNum);
+    return;
+  }
+
+  // Small products: i-k-j loop that streams the rows of B and C
   unsigned int BcolNum = B.colNum;
   unsigned int BrowNum = B.rowNum;
-  unsigned int i, j, k;
   double **BrowPtrs = B.rowPtrs;
-  for (i = 0; i < A.rowNum; i++) {
-    double *rowptri = A.rowPtrs[i];
+  for (unsigned int i = 0; i < A.rowNum; i++) {
+    const double *rowptri = A.rowPtrs[i];
     double *ci = C[i];
-    for (j = 0; j < BcolNum; j++) {
-      double s = 0;
-      for (k = 0; k < BrowNum; k++)
-        s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
+    for (unsigned int j = 0; j < BcolNum; j++)
+      ci[j] = 0;
+    for (unsigned int k = 0; k < BrowNum; k++) {
+      const double aik = rowptri[k];
+      const double *bk = BrowPtrs[k];
+      for (unsigned int j = 0; j < BcolNum; j++)
+        ci[j] += aik * bk[j];
     }
   }
-#endif
 }
 
 /*!
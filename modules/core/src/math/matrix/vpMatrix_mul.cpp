@@ -29,12 +29,40 @@
  * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
  *
  * Description:
- * BLAS subroutines.
+ * BLAS subroutines and built-in matrix products.
  *
  *****************************************************************************/
 
+#include <algorithm>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+// AVX2 and FMA kernels are compiled for their own target and only called
+// when the CPU supports them
+#if (defined(__x86_64__) || defined(__i386__)) &&                                                                     \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define VISP_HAVE_AVX2_FMA_KERNEL 1
+#define VISP_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1800) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#define VISP_HAVE_AVX2_FMA_KERNEL 1
+#define VISP_TARGET_AVX2_FMA
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VISP_HAVE_NEON_KERNEL 1
+#endif
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
@@ -65,11 +93,476 @@ void vpMatrix::blas_dgemv(char trans, const int M_, const int N_, double alpha,
 
   dgemv_(&trans, &M, &N, &alpha, a_data, &lda, x_data, &incx, &beta, y_data, &incy);
 }
+#endif
+
+namespace
+{
+/*
+  Blocking of the built-in GEMM. C is computed by MC x NC blocks; for each
+  block, KC columns of op(A) and KC rows of op(B) are packed in panels of
+  MR rows and NR columns that the micro-kernel reads sequentially. A packed
+  KC x NR panel of B stays in L1, a MC x KC block of A in L2.
+*/
+const unsigned int gemmMR = 4;
+const unsigned int gemmMaxNR = 8;
+const unsigned int gemmKC = 256;
+const unsigned int gemmMC = 96;
+const unsigned int gemmNC = 2048;
+// Products with fewer multiply-adds run on a single thread
+const double gemmParallelMinFlops = 2e6;
 
-#else
-// Work arround to avoid warning LNK4221: This object file does not define any
-// previously undefined public symbols
-void dummy_vpMatrix_blas(){};
+// Computes the MR x NR tile AB = Ap * Bp from packed panels of depth kc
+typedef void (*vpGemmMicroKernel)(unsigned int kc, const double *Ap, const double *Bp, double *AB);
+
+struct vpGemmKernel {
+  vpMatrix::vpProductKernel type;
+  vpGemmMicroKernel run;
+  unsigned int nr;
+};
+
+void microKernelScalar(unsigned int kc, const double *Ap, const double *Bp, double *AB)
+{
+  double ab[gemmMR * 4];
+  for (unsigned int i = 0; i < gemmMR * 4; i++) {
+    ab[i] = 0.;
+  }
+  for (unsigned int p = 0; p < kc; p++, Ap += gemmMR, Bp += 4) {
+    for (unsigned int i = 0; i < gemmMR; i++) {
+      const double a = Ap[i];
+      ab[4 * i] += a * Bp[0];
+      ab[4 * i + 1] += a * Bp[1];
+      ab[4 * i + 2] += a * Bp[2];
+      ab[4 * i + 3] += a * Bp[3];
+    }
+  }
+  for (unsigned int i = 0; i < gemmMR * 4; i++) {
+    AB[i] = ab[i];
+  }
+}
+
+#if VISP_HAVE_SSE2
+void microKernelSSE2(unsigned int kc, const double *Ap, const double *Bp, double *AB)
+{
+  __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd(), c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+  __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd(), c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+  for (unsigned int p = 0; p < kc; p++, Ap += gemmMR, Bp += 4) {
+    const __m128d b0 = _mm_loadu_pd(Bp), b1 = _mm_loadu_pd(Bp + 2);
+    __m128d a = _mm_set1_pd(Ap[0]);
+    c00 = _mm_add_pd(c00, _mm_mul_pd(a, b0));
+    c01 = _mm_add_pd(c01, _mm_mul_pd(a, b1));
+    a = _mm_set1_pd(Ap[1]);
+    c10 = _mm_add_pd(c10, _mm_mul_pd(a, b0));
+    c11 = _mm_add_pd(c11, _mm_mul_pd(a, b1));
+    a = _mm_set1_pd(Ap[2]);
+    c20 = _mm_add_pd(c20, _mm_mul_pd(a, b0));
+    c21 = _mm_add_pd(c21, _mm_mul_pd(a, b1));
+    a = _mm_set1_pd(Ap[3]);
+    c30 = _mm_add_pd(c30, _mm_mul_pd(a, b0));
+    c31 = _mm_add_pd(c31, _mm_mul_pd(a, b1));
+  }
+  _mm_storeu_pd(AB, c00);
+  _mm_storeu_pd(AB + 2, c01);
+  _mm_storeu_pd(AB + 4, c10);
+  _mm_storeu_pd(AB + 6, c11);
+  _mm_storeu_pd(AB + 8, c20);
+  _mm_storeu_pd(AB + 10, c21);
+  _mm_storeu_pd(AB + 12, c30);
+  _mm_storeu_pd(AB + 14, c31);
+}
 #endif
 
+#if VISP_HAVE_AVX2_FMA_KERNEL
+VISP_TARGET_AVX2_FMA void microKernelAVX2(unsigned int kc, const double *Ap, const double *Bp, double *AB)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd(),
+          c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(), c30 = _mm256_setzero_pd(),
+          c31 = _mm256_setzero_pd();
+  for (unsigned int p = 0; p < kc; p++, Ap += gemmMR, Bp += 8) {
+    const __m256d b0 = _mm256_loadu_pd(Bp), b1 = _mm256_loadu_pd(Bp + 4);
+    __m256d a = _mm256_broadcast_sd(Ap);
+    c00 = _mm256_fmadd_pd(a, b0, c00);
+    c01 = _mm256_fmadd_pd(a, b1, c01);
+    a = _mm256_broadcast_sd(Ap + 1);
+    c10 = _mm256_fmadd_pd(a, b0, c10);
+    c11 = _mm256_fmadd_pd(a, b1, c11);
+    a = _mm256_broadcast_sd(Ap + 2);
+    c20 = _mm256_fmadd_pd(a, b0, c20);
+    c21 = _mm256_fmadd_pd(a, b1, c21);
+    a = _mm256_broadcast_sd(Ap + 3);
+    c30 = _mm256_fmadd_pd(a, b0, c30);
+    c31 = _mm256_fmadd_pd(a, b1, c31);
+  }
+  _mm256_storeu_pd(AB, c00);
+  _mm256_storeu_pd(AB + 4, c01);
+  _mm256_storeu_pd(AB + 8, c10);
+  _mm256_storeu_pd(AB + 12, c11);
+  _mm256_storeu_pd(AB + 16, c20);
+  _mm256_storeu_pd(AB + 20, c21);
+  _mm256_storeu_pd(AB + 24, c30);
+  _mm256_storeu_pd(AB + 28, c31);
+}
+
+VISP_TARGET_AVX2_FMA double dotAVX2(const double *a, const double *x, unsigned int n)
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+  unsigned int k = 0;
+  for (; k + 8 <= n; k += 8) {
+    s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(x + k), s0);
+    s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + k + 4), _mm256_loadu_pd(x + k + 4), s1);
+  }
+  double s[4];
+  _mm256_storeu_pd(s, _mm256_add_pd(s0, s1));
+  double sum = (s[0] + s[1]) + (s[2] + s[3]);
+  for (; k < n; k++) {
+    sum += a[k] * x[k];
+  }
+  return sum;
+}
+#endif
+
+#if VISP_HAVE_NEON_KERNEL
+void microKernelNEON(unsigned int kc, const double *Ap, const double *Bp, double *AB)
+{
+  float64x2_t c00 = vdupq_n_f64(0.), c01 = vdupq_n_f64(0.), c10 = vdupq_n_f64(0.), c11 = vdupq_n_f64(0.);
+  float64x2_t c20 = vdupq_n_f64(0.), c21 = vdupq_n_f64(0.), c30 = vdupq_n_f64(0.), c31 = vdupq_n_f64(0.);
+  for (unsigned int p = 0; p < kc; p++, Ap += gemmMR, Bp += 4) {
+    const float64x2_t b0 = vld1q_f64(Bp), b1 = vld1q_f64(Bp + 2);
+    c00 = vfmaq_n_f64(c00, b0, Ap[0]);
+    c01 = vfmaq_n_f64(c01, b1, Ap[0]);
+    c10 = vfmaq_n_f64(c10, b0, Ap[1]);
+    c11 = vfmaq_n_f64(c11, b1, Ap[1]);
+    c20 = vfmaq_n_f64(c20, b0, Ap[2]);
+    c21 = vfmaq_n_f64(c21, b1, Ap[2]);
+    c30 = vfmaq_n_f64(c30, b0, Ap[3]);
+    c31 = vfmaq_n_f64(c31, b1, Ap[3]);
+  }
+  vst1q_f64(AB, c00);
+  vst1q_f64(AB + 2, c01);
+  vst1q_f64(AB + 4, c10);
+  vst1q_f64(AB + 6, c11);
+  vst1q_f64(AB + 8, c20);
+  vst1q_f64(AB + 10, c21);
+  vst1q_f64(AB + 12, c30);
+  vst1q_f64(AB + 14, c31);
+}
+#endif
+
+// Return false if the kernel is not compiled in or not supported by the CPU
+bool getGemmKernel(vpMatrix::vpProductKernel type, vpGemmKernel &kernel)
+{
+  kernel.type = type;
+  kernel.nr = 4;
+  switch (type) {
+  case vpMatrix::PRODUCT_KERNEL_SCALAR:
+    kernel.run = microKernelScalar;
+    return true;
+#if VISP_HAVE_SSE2
+  case vpMatrix::PRODUCT_KERNEL_SSE2:
+    kernel.run = microKernelSSE2;
+    return vpCPUFeatures::checkSSE2();
+#endif
+#if VISP_HAVE_AVX2_FMA_KERNEL
+  case vpMatrix::PRODUCT_KERNEL_AVX2_FMA:
+    kernel.run = microKernelAVX2;
+    kernel.nr = 8;
+    return vpCPUFeatures::checkAVX2() && vpCPUFeatures::checkFMA();
+#endif
+#if VISP_HAVE_NEON_KERNEL
+  case vpMatrix::PRODUCT_KERNEL_NEON:
+    kernel.run = microKernelNEON;
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+vpGemmKernel selectGemmKernel()
+{
+  const vpMatrix::vpProductKernel preferred[] = {vpMatrix::PRODUCT_KERNEL_AVX2_FMA, vpMatrix::PRODUCT_KERNEL_SSE2,
+                                                 vpMatrix::PRODUCT_KERNEL_NEON};
+  vpGemmKernel kernel;
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++) {
+    if (getGemmKernel(preferred[i], kernel)) {
+      return kernel;
+    }
+  }
+  getGemmKernel(vpMatrix::PRODUCT_KERNEL_SCALAR, kernel);
+  return kernel;
+}
+
+vpGemmKernel &gemmKernel()
+{
+  static vpGemmKernel kernel = selectGemmKernel();
+  return kernel;
+}
+
+// Pack the mc x kc block of op(A) at (i0, p0) in panels of MR rows, padded with zeros
+void packA(bool trans, const double *A, unsigned int lda, unsigned int i0, unsigned int p0, unsigned int mc,
+           unsigned int kc, double *Ap)
+{
+  for (unsigned int i = 0; i < mc; i += gemmMR) {
+    const unsigned int mr = std::min(gemmMR, mc - i);
+    if (trans) {
+      for (unsigned int p = 0; p < kc; p++) {
+        const double *a = A + (p0 + p) * lda + i0 + i;
+        unsigned int r = 0;
+        for (; r < mr; r++) {
+          *Ap++ = a[r];
+        }
+        for (; r < gemmMR; r++) {
+          *Ap++ = 0.;
+        }
+      }
+    } else {
+      const double *a = A + (i0 + i) * lda + p0;
+      for (unsigned int p = 0; p < kc; p++) {
+        unsigned int r = 0;
+        for (; r < mr; r++) {
+          *Ap++ = a[r * lda + p];
+        }
+        for (; r < gemmMR; r++) {
+          *Ap++ = 0.;
+        }
+      }
+    }
+  }
+}
+
+// Pack the kc x nc block of op(B) at (p0, j0) in panels of nr columns, padded with zeros
+void packB(bool trans, const double *B, unsigned int ldb, unsigned int p0, unsigned int j0, unsigned int kc,
+           unsigned int nc, unsigned int nr, double *Bp)
+{
+  for (unsigned int j = 0; j < nc; j += nr) {
+    const unsigned int nb = std::min(nr, nc - j);
+    if (trans) {
+      const double *b = B + (j0 + j) * ldb + p0;
+      for (unsigned int p = 0; p < kc; p++) {
+        unsigned int c = 0;
+        for (; c < nb; c++) {
+          *Bp++ = b[c * ldb + p];
+        }
+        for (; c < nr; c++) {
+          *Bp++ = 0.;
+        }
+      }
+    } else {
+      for (unsigned int p = 0; p < kc; p++) {
+        const double *b = B + (p0 + p) * ldb + j0 + j;
+        unsigned int c = 0;
+        for (; c < nb; c++) {
+          *Bp++ = b[c];
+        }
+        for (; c < nr; c++) {
+          *Bp++ = 0.;
+        }
+      }
+    }
+  }
+}
+
+// Write or add the valid mr x nb part of a micro-kernel tile to C
+inline void storeTile(const double *AB, unsigned int nr, double *C, unsigned int ldc, unsigned int mr,
+                      unsigned int nb, bool accumulate)
+{
+  for (unsigned int i = 0; i < mr; i++, AB += nr, C += ldc) {
+    if (accumulate) {
+      for (unsigned int j = 0; j < nb; j++) {
+        C[j] += AB[j];
+      }
+    } else {
+      for (unsigned int j = 0; j < nb; j++) {
+        C[j] = AB[j];
+      }
+    }
+  }
+}
+
+// Computes the row blocks [begin, end) of C for one kc x nc packed panel of op(B)
+class GemmRowBlocks : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  GemmRowBlocks(const vpGemmKernel &kernel, bool transA, const double *A, unsigned int lda, const double *Bp,
+                double *C, unsigned int ldc, unsigned int M, unsigned int jc, unsigned int nc, unsigned int pc,
+                unsigned int kc)
+    : m_kernel(kernel), m_transA(transA), m_A(A), m_lda(lda), m_Bp(Bp), m_C(C), m_ldc(ldc), m_M(M), m_jc(jc),
+      m_nc(nc), m_pc(pc), m_kc(kc)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int nr = m_kernel.nr;
+    const bool accumulate = (m_pc > 0);
+    std::vector<double> Ap(gemmMC * m_kc);
+    double AB[gemmMR * gemmMaxNR];
+    for (unsigned int b = begin; b < end; b++) {
+      const unsigned int ic = b * gemmMC;
+      const unsigned int mc = std::min(gemmMC, m_M - ic);
+      packA(m_transA, m_A, m_lda, ic, m_pc, mc, m_kc, &Ap[0]);
+      for (unsigned int jr = 0; jr < m_nc; jr += nr) {
+        for (unsigned int ir = 0; ir < mc; ir += gemmMR) {
+          m_kernel.run(m_kc, &Ap[ir * m_kc], &m_Bp[jr * m_kc], AB);
+          storeTile(AB, nr, m_C + (ic + ir) * m_ldc + m_jc + jr, m_ldc, std::min(gemmMR, mc - ir),
+                    std::min(nr, m_nc - jr), accumulate);
+        }
+      }
+    }
+  }
+
+private:
+  const vpGemmKernel &m_kernel;
+  bool m_transA;
+  const double *m_A;
+  unsigned int m_lda;
+  const double *m_Bp;
+  double *m_C;
+  unsigned int m_ldc;
+  unsigned int m_M;
+  unsigned int m_jc;
+  unsigned int m_nc;
+  unsigned int m_pc;
+  unsigned int m_kc;
+};
+}
+
+/*
+  Built-in C = op(A) * op(B) where op(A) is M x K and op(B) is K x N, all
+  the matrices being stored by rows. When transA (resp. transB) is true,
+  op(A) = A^T (resp. op(B) = B^T).
+*/
+void vpMatrix::native_dgemm(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K,
+                            const double *A, unsigned int lda, const double *B, unsigned int ldb, double *C,
+                            unsigned int ldc)
+{
+  if (M == 0 || N == 0) {
+    return;
+  }
+  if (K == 0) {
+    for (unsigned int i = 0; i < M; i++) {
+      std::fill(C + i * ldc, C + i * ldc + N, 0.);
+    }
+    return;
+  }
+
+  const vpGemmKernel &kernel = gemmKernel();
+  const unsigned int nr = kernel.nr;
+  const unsigned int kcMax = std::min(gemmKC, K);
+  const unsigned int ncMax = std::min(gemmNC, N);
+  std::vector<double> Bp(kcMax * ((ncMax + nr - 1) / nr) * nr);
+  const unsigned int nbRowBlocks = (M + gemmMC - 1) / gemmMC;
+  const bool parallel = (nbRowBlocks > 1) && ((double)M * N * K > gemmParallelMinFlops);
+
+  for (unsigned int jc = 0; jc < N; jc += gemmNC) {
+    const unsigned int nc = std::min(gemmNC, N - jc);
+    for (unsigned int pc = 0; pc < K; pc += gemmKC) {
+      const unsigned int kc = std::min(gemmKC, K - pc);
+      packB(transB, B, ldb, pc, jc, kc, nc, nr, &Bp[0]);
+
+      // The row blocks of C share the packed panels of B
+      GemmRowBlocks body(kernel, transA, A, lda, &Bp[0], C, ldc, M, jc, nc, pc, kc);
+      if (parallel) {
+        vpThreadPool::getInstance().parallelFor(0, nbRowBlocks, body);
+      } else {
+        body(0, nbRowBlocks);
+      }
+    }
+  }
+}
+
+/*
+  Built-in y = A * x where A is M x N and stored by rows.
+*/
+void vpMatrix::native_dgemv(unsigned int M, unsigned int N, const double *A, unsigned int lda, const double *x,
+                            double *y)
+{
+  const vpMatrix::vpProductKernel type = gemmKernel().type;
+#if VISP_HAVE_AVX2_FMA_KERNEL
+  if (type == vpMatrix::PRODUCT_KERNEL_AVX2_FMA) {
+    for (unsigned int i = 0; i < M; i++) {
+      y[i] = dotAVX2(A + i * lda, x, N);
+    }
+    return;
+  }
+#endif
+
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (type == vpMatrix::PRODUCT_KERNEL_SSE2) {
+    // Four rows at a time to reuse the loads of x
+    for (; i + 4 <= M; i += 4) {
+      const double *a0 = A + i * lda, *a1 = a0 + lda, *a2 = a1 + lda, *a3 = a2 + lda;
+      __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+      unsigned int k = 0;
+      for (; k + 2 <= N; k += 2) {
+        const __m128d xk = _mm_loadu_pd(x + k);
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a0 + k), xk));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a1 + k), xk));
+        s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(a2 + k), xk));
+        s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(a3 + k), xk));
+      }
+      double s[8];
+      _mm_storeu_pd(s, s0);
+      _mm_storeu_pd(s + 2, s1);
+      _mm_storeu_pd(s + 4, s2);
+      _mm_storeu_pd(s + 6, s3);
+      double y0 = s[0] + s[1], y1 = s[2] + s[3], y2 = s[4] + s[5], y3 = s[6] + s[7];
+      for (; k < N; k++) {
+        y0 += a0[k] * x[k];
+        y1 += a1[k] * x[k];
+        y2 += a2[k] * x[k];
+        y3 += a3[k] * x[k];
+      }
+      y[i] = y0;
+      y[i + 1] = y1;
+      y[i + 2] = y2;
+      y[i + 3] = y3;
+    }
+  }
+#endif
+  for (; i < M; i++) {
+    const double *a = A + i * lda;
+    double s = 0.;
+    for (unsigned int k = 0; k < N; k++) {
+      s += a[k] * x[k];
+    }
+    y[i] = s;
+  }
+}
+
 #endif // #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Return the micro-kernel used by the built-in matrix products.
+
+  \sa setProductKernel()
+*/
+vpMatrix::vpProductKernel vpMatrix::getProductKernel() { return gemmKernel().type; }
+
+/*!
+  Select the micro-kernel used by the built-in matrix products, that are
+  used when ViSP is built without BLAS or for matrices smaller than
+  getLapackMatrixMinSize(). By default the fastest kernel supported by the
+  CPU is used; forcing another one is mainly useful to test or benchmark
+  the kernels. It must not be called while products are being computed
+  by other threads.
+
+  \param kernel : Kernel to use. PRODUCT_KERNEL_AUTO restores the default.
+
+  \return false if the kernel is not available on this platform. The
+  current kernel is then kept.
+*/
+bool vpMatrix::setProductKernel(vpProductKernel kernel)
+{
+  if (kernel == PRODUCT_KERNEL_AUTO) {
+    gemmKernel() = selectGemmKernel();
+    return true;
+  }
+  vpGemmKernel forced;
+  if (!getGemmKernel(kernel, forced)) {
+    return false;
+  }
+  gemmKernel() = forced;
+  return true;
+}
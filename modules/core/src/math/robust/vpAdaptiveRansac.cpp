@@ -0,0 +1,475 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Adaptive RANSAC with PROSAC sampling and SPRT verification.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpAdaptiveRansac.cpp
+  \brief Adaptive RANSAC engine shared by the robust estimators.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <float.h>
+#include <limits>
+
+#include <visp3/core/vpAdaptiveRansac.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpUniRand.h>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#include <visp3/core/vpMutex.h>
+#define VP_ADAPTIVE_RANSAC_HAVE_MUTEX 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of trials after which PROSAC sampling is the same as RANSAC's one
+const double prosacGrowthMaxTrials = 200000.0;
+// Number of attempts to draw a non degenerate sample in a trial
+const unsigned int maxSampleAttempts = 100;
+// Cost of the computation of the hypotheses, in number of verified data, to
+// tune the SPRT decision threshold
+const double sprtModelCost = 200.0;
+
+class RansacMutex
+{
+public:
+#if defined(VP_ADAPTIVE_RANSAC_HAVE_MUTEX)
+  void lock() { m_mutex.lock(); }
+  void unlock() { m_mutex.unlock(); }
+
+private:
+  vpMutex m_mutex;
+#else
+  void lock() {}
+  void unlock() {}
+#endif
+};
+
+// Decision threshold A of the SPRT, see Matas and Chum, ICCV'05
+double computeSPRTThreshold(double epsilon, double delta)
+{
+  if (epsilon <= delta) {
+    // A good model cannot be distinguished from a bad one
+    return DBL_MAX;
+  }
+
+  const double C = (1.0 - delta) * log((1.0 - delta) / (1.0 - epsilon)) + delta * log(delta / epsilon);
+  const double K = sprtModelCost / C;
+  double A = K + 1.0;
+  for (unsigned int i = 0; i < 10; i++) {
+    A = K + 1.0 + log(A);
+  }
+
+  return A;
+}
+
+// State shared between the tasks running the trials
+class RansacState
+{
+public:
+  RansacState(const vpAdaptiveRansac::vpModelEstimator &estimator, unsigned int nbData, unsigned int sampleSize)
+    : m_estimator(estimator), m_nbData(nbData), m_sampleSize(sampleSize), m_threshold(0), m_probability(0),
+      m_maxTrials(0), m_nbInliersConsensus(0), m_useSPRT(false), m_order(), m_prosacTrials(), m_mutex(), m_nbTrials(0),
+      m_trialsBound(0), m_stop(false), m_bestNbInliers(0), m_bestModel(), m_bestInliers(), m_epsilon(0.1),
+      m_delta(0.01), m_sprtThreshold(DBL_MAX), m_nbVerified(0), m_sumVerifiedRatio(0)
+  {
+  }
+
+  void drawSample(unsigned int trial, vpUniRand &rng, std::vector<unsigned int> &sample) const;
+  void run(unsigned int index, long seed);
+
+  const vpAdaptiveRansac::vpModelEstimator &m_estimator;
+  const unsigned int m_nbData;
+  const unsigned int m_sampleSize;
+  double m_threshold;
+  double m_probability;
+  unsigned int m_maxTrials;
+  unsigned int m_nbInliersConsensus;
+  bool m_useSPRT;
+  //! Data indexes by decreasing quality and PROSAC growth function, both
+  //! empty for uniform sampling
+  std::vector<unsigned int> m_order;
+  std::vector<unsigned int> m_prosacTrials;
+
+  // Shared by the tasks, protected by m_mutex
+  RansacMutex m_mutex;
+  unsigned int m_nbTrials;
+  unsigned int m_trialsBound;
+  bool m_stop;
+  unsigned int m_bestNbInliers;
+  vpColVector m_bestModel;
+  std::vector<unsigned int> m_bestInliers;
+  double m_epsilon;
+  double m_delta;
+  double m_sprtThreshold;
+  unsigned int m_nbVerified;
+  double m_sumVerifiedRatio;
+
+private:
+  RansacState(const RansacState &);
+  RansacState &operator=(const RansacState &);
+};
+
+// Draw sampleSize distinct indexes among the first n ones of order (or of
+// the data if order is empty), appended to sample
+void drawUniform(unsigned int n, unsigned int sampleSize, const std::vector<unsigned int> &order, vpUniRand &rng,
+                 std::vector<unsigned int> &sample)
+{
+  const size_t first = sample.size();
+  while (sample.size() < first + sampleSize) {
+    unsigned int r = (std::min)((unsigned int)(rng() * n), n - 1);
+    if (!order.empty()) {
+      r = order[r];
+    }
+    if (std::find(sample.begin(), sample.end(), r) == sample.end()) {
+      sample.push_back(r);
+    }
+  }
+}
+
+void RansacState::drawSample(unsigned int trial, vpUniRand &rng, std::vector<unsigned int> &sample) const
+{
+  sample.clear();
+  if (m_order.empty() || trial > m_prosacTrials.back()) {
+    drawUniform(m_nbData, m_sampleSize, m_order, rng, sample);
+    return;
+  }
+
+  // PROSAC: the sample is made of the n-th best datum and of sampleSize - 1
+  // data drawn among the n - 1 best ones
+  const unsigned int n = (unsigned int)(std::lower_bound(m_prosacTrials.begin() + m_sampleSize,
+                                                         m_prosacTrials.end(), trial) -
+                                        m_prosacTrials.begin());
+  sample.push_back(m_order[n - 1]);
+  drawUniform(n - 1, m_sampleSize - 1, m_order, rng, sample);
+}
+
+void RansacState::run(unsigned int index, long seed)
+{
+  vpUniRand rng(seed + (long)index);
+  std::vector<unsigned int> sample;
+  std::vector<vpColVector> models;
+  std::vector<unsigned int> consensus;
+  consensus.reserve(m_nbData);
+
+  while (true) {
+    unsigned int trial, bestNbInliers;
+    double epsilon, delta, sprtThreshold;
+    m_mutex.lock();
+    if (m_stop || m_nbTrials >= m_trialsBound) {
+      m_mutex.unlock();
+      break;
+    }
+    trial = ++m_nbTrials;
+    bestNbInliers = m_bestNbInliers;
+    epsilon = m_epsilon;
+    delta = m_delta;
+    sprtThreshold = m_sprtThreshold;
+    m_mutex.unlock();
+
+    bool validSample = false;
+    for (unsigned int attempt = 0; attempt < maxSampleAttempts && !validSample; attempt++) {
+      drawSample(trial, rng, sample);
+      validSample = m_estimator.isSampleValid(sample);
+    }
+    if (!validSample) {
+      continue;
+    }
+
+    models.clear();
+    m_estimator.computeModels(sample, models);
+
+    for (size_t k = 0; k < models.size(); k++) {
+      // With SPRT, the data are checked from a random position so that the
+      // decision does not depend on their order
+      unsigned int start = 0;
+      if (m_useSPRT) {
+        start = (std::min)((unsigned int)(rng() * m_nbData), m_nbData - 1);
+      }
+
+      consensus.clear();
+      bool rejected = false;
+      unsigned int nbChecked = 0;
+      double lambda = 1.0;
+      const double lambdaInlier = delta / epsilon;
+      const double lambdaOutlier = (1.0 - delta) / (1.0 - epsilon);
+      for (unsigned int j = 0; j < m_nbData; j++) {
+        unsigned int i = start + j;
+        if (i >= m_nbData) {
+          i -= m_nbData;
+        }
+        nbChecked++;
+
+        if (m_estimator.computeError(models[k], i) < m_threshold && m_estimator.isInlierValid(consensus, i)) {
+          consensus.push_back(i);
+          lambda *= lambdaInlier;
+        } else {
+          lambda *= lambdaOutlier;
+        }
+
+        if (m_useSPRT && lambda > sprtThreshold) {
+          rejected = true;
+          break;
+        }
+      }
+
+      const unsigned int nbInliers = (unsigned int)consensus.size();
+      if (!rejected && nbInliers > bestNbInliers && start != 0) {
+        std::sort(consensus.begin(), consensus.end());
+      }
+
+      m_mutex.lock();
+      // The inlier ratio of the verified models estimates the probability
+      // that a datum is consistent with a bad model
+      m_nbVerified++;
+      m_sumVerifiedRatio += (double)nbInliers / (double)nbChecked;
+      if (m_useSPRT) {
+        m_delta = (std::max)(1e-4, (std::min)(0.5, m_sumVerifiedRatio / m_nbVerified));
+      }
+
+      if (!rejected && nbInliers > m_bestNbInliers) {
+        m_bestNbInliers = nbInliers;
+        m_bestModel = models[k];
+        m_bestInliers = consensus;
+        m_epsilon = (std::min)(1.0 - 1e-4, (double)nbInliers / (double)m_nbData);
+        m_trialsBound = vpAdaptiveRansac::computeNbTrials(m_probability, (double)nbInliers / (double)m_nbData,
+                                                          m_sampleSize, m_maxTrials);
+        if (m_nbInliersConsensus > 0 && nbInliers >= m_nbInliersConsensus) {
+          m_stop = true;
+        }
+      }
+
+      if (m_useSPRT) {
+        m_sprtThreshold = computeSPRTThreshold(m_epsilon, m_delta);
+      }
+      bestNbInliers = m_bestNbInliers;
+      epsilon = m_epsilon;
+      delta = m_delta;
+      sprtThreshold = m_sprtThreshold;
+      m_mutex.unlock();
+    }
+  }
+}
+
+// Task running the trials in a worker of the thread pool
+class RansacTask : public vpThreadPool::vpTask
+{
+public:
+  RansacTask(RansacState &state, unsigned int index, long seed) : m_state(&state), m_index(index), m_seed(seed) {}
+  void run() { m_state->run(m_index, m_seed); }
+
+private:
+  RansacState *m_state;
+  unsigned int m_index;
+  long m_seed;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor: probability of 0.99, at most 1000 trials, a threshold
+  of 1e-3, uniform sampling, no SPRT and a sequential execution.
+*/
+vpAdaptiveRansac::vpAdaptiveRansac()
+  : m_maxTrials(1000), m_nbInliersConsensus(0), m_nbThreads(1), m_nbTrials(0), m_probability(0.99), m_qualities(),
+    m_seed(0), m_threshold(1e-3), m_useSPRT(false)
+{
+}
+
+/*!
+  Compute the number of trials needed to draw at least one outlier free
+  sample with a given probability.
+
+  \param probability : Desired probability (typically 0.99).
+  \param inlierRatio : Ratio of inliers among the data.
+  \param sampleSize : Size of the minimal samples.
+  \param maxTrials : Upper bound on the number of trials.
+  \return \f$ \lceil \log(1 - p) / \log(1 - w^s) \rceil \f$ bounded by \e
+  maxTrials.
+*/
+unsigned int vpAdaptiveRansac::computeNbTrials(double probability, double inlierRatio, unsigned int sampleSize,
+                                               unsigned int maxTrials)
+{
+  if (inlierRatio >= 1.0) {
+    return (std::min)(1u, maxTrials);
+  }
+  if (inlierRatio <= 0.0 || probability >= 1.0) {
+    return maxTrials;
+  }
+
+  const double den = log(1.0 - pow(inlierRatio, (double)sampleSize));
+  if (!(den < 0.0)) {
+    return maxTrials;
+  }
+
+  const double nbTrials = ceil(log(1.0 - probability) / den);
+  if (nbTrials >= (double)maxTrials) {
+    return maxTrials;
+  }
+
+  return (std::max)(1u, (unsigned int)nbTrials);
+}
+
+/*!
+  Robustly estimate a model.
+
+  \param estimator : Description of the model.
+  \param model : Model with the largest consensus set.
+  \param inliers : Indexes of the data in the consensus set, in increasing
+  order.
+  \return true if a model with at least one inlier was found.
+
+  \exception vpException::badValue : Less data than the sample size.
+*/
+bool vpAdaptiveRansac::estimate(const vpModelEstimator &estimator, vpColVector &model,
+                                std::vector<unsigned int> &inliers)
+{
+  const unsigned int nbData = estimator.getNbData();
+  const unsigned int sampleSize = estimator.getSampleSize();
+  if (sampleSize == 0 || nbData < sampleSize) {
+    throw vpException(vpException::badValue, "Not enough data (%d) for samples of %d data", nbData, sampleSize);
+  }
+
+  RansacState state(estimator, nbData, sampleSize);
+  state.m_threshold = m_threshold;
+  state.m_probability = m_probability;
+  state.m_maxTrials = m_maxTrials;
+  state.m_nbInliersConsensus = m_nbInliersConsensus;
+  state.m_useSPRT = m_useSPRT;
+  state.m_trialsBound = m_maxTrials;
+  if (m_useSPRT) {
+    state.m_sprtThreshold = computeSPRTThreshold(state.m_epsilon, state.m_delta);
+  }
+
+  if (!m_qualities.empty()) {
+    if (m_qualities.size() != nbData) {
+      throw vpException(vpException::dimensionError, "%d qualities for %d data", (int)m_qualities.size(), nbData);
+    }
+
+    // Sort the data by decreasing quality
+    std::vector<std::pair<double, unsigned int> > sorted(nbData);
+    for (unsigned int i = 0; i < nbData; i++) {
+      sorted[i] = std::make_pair(-m_qualities[i], i);
+    }
+    std::stable_sort(sorted.begin(), sorted.end());
+    state.m_order.resize(nbData);
+    for (unsigned int i = 0; i < nbData; i++) {
+      state.m_order[i] = sorted[i].second;
+    }
+
+    // PROSAC growth function: m_prosacTrials[n] is the trial from which the
+    // samples are drawn among the n best data
+    state.m_prosacTrials.resize(nbData + 1, 0);
+    double Tn = prosacGrowthMaxTrials;
+    for (unsigned int i = 0; i < sampleSize; i++) {
+      Tn *= (double)(sampleSize - i) / (double)(nbData - i);
+    }
+    unsigned int Tn_prime = 1;
+    state.m_prosacTrials[sampleSize] = Tn_prime;
+    for (unsigned int n = sampleSize; n < nbData; n++) {
+      const double Tn_1 = Tn * (double)(n + 1) / (double)(n + 1 - sampleSize);
+      Tn_prime += (unsigned int)ceil(Tn_1 - Tn);
+      state.m_prosacTrials[n + 1] = Tn_prime;
+      Tn = Tn_1;
+    }
+  }
+
+  unsigned int nbThreads = m_nbThreads;
+  if (nbThreads == 0) {
+    nbThreads = vpThreadPool::getInstance().getNumberOfThreads();
+  }
+
+  if (nbThreads <= 1) {
+    state.run(0, m_seed);
+  } else {
+    std::vector<RansacTask> tasks;
+    tasks.reserve(nbThreads);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      tasks.push_back(RansacTask(state, i, m_seed));
+    }
+
+    vpThreadPool::vpTaskGroup group;
+    for (size_t i = 0; i < tasks.size(); i++) {
+      group.run(tasks[i]);
+    }
+    group.wait();
+  }
+
+  m_nbTrials = state.m_nbTrials;
+  if (state.m_bestNbInliers == 0) {
+    return false;
+  }
+
+  model = state.m_bestModel;
+  inliers = state.m_bestInliers;
+  return true;
+}
+
+/*!
+  Set the probability to draw at least one outlier free sample, that
+  determines the number of trials.
+
+  \exception vpException::badValue : Probability not in ]0, 1].
+*/
+void vpAdaptiveRansac::setProbability(const double probability)
+{
+  if (probability <= 0.0 || probability > 1.0) {
+    throw vpException(vpException::badValue, "The probability %f must be in ]0, 1]", probability);
+  }
+  m_probability = probability;
+}
+
+/*!
+  Set the quality of each datum, for instance the opposite of the distance
+  between matched descriptors. The samples are then drawn with PROSAC, the
+  data with the highest qualities being tried first. An empty vector
+  restores uniform sampling.
+*/
+void vpAdaptiveRansac::setQualities(const std::vector<double> &qualities) { m_qualities = qualities; }
+
+/*!
+  Set the threshold: a datum is an inlier if its error is strictly below.
+
+  \exception vpException::badValue : Threshold not positive.
+*/
+void vpAdaptiveRansac::setThreshold(const double threshold)
+{
+  if (threshold <= 0.0) {
+    throw vpException(vpException::badValue, "The RANSAC threshold must be positive");
+  }
+  m_threshold = threshold;
+}
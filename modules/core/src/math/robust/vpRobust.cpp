@@ -41,21 +41,233 @@
   \file vpRobust.cpp
 */
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpMath.h>
 
-#include <cmath>  // std::fabs
-#include <limits> // numeric_limits
+#include <algorithm> // std::nth_element
+#include <cmath>     // std::fabs
+#include <limits>    // numeric_limits
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <visp3/core/vpRobust.h>
 
+// AVX kernels are compiled for their own target and only called when the
+// CPU supports them
+#if (defined(__x86_64__) || defined(__i386__)) &&                                                                     \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#include <immintrin.h>
+#define VISP_HAVE_AVX_KERNEL 1
+#define VISP_TARGET_AVX __attribute__((target("avx")))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1800) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#define VISP_HAVE_AVX_KERNEL 1
+#define VISP_TARGET_AVX
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VISP_HAVE_NEON_KERNEL 1
+#endif
+
 #define vpITMAX 100
 #define vpEPS 3.0e-7
 #define vpCST 1
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+const double tukeyCst = vpCST * 4.6851;
+const double huberCst = 1.2107; // 1.345;
+const double cauchyCst = 2.3849;
+
+/*
+  Weighting kernels. They all compute exactly the same operations in the
+  same order as the scalar versions, so that the weights do not depend on
+  the CPU. A zero weight on input marks a rejected data for Tukey and Huber.
+*/
+void absDiffScalar(const double *r, double med, double *out, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; i++) {
+    out[i] = std::fabs(r[i] - med);
+  }
+}
+
+void tukeyScalar(const double *x, double sig, double *w, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; i++) {
+    double xi_sig = x[i] / sig;
+    if ((std::fabs(xi_sig) <= tukeyCst) && std::fabs(w[i]) > std::numeric_limits<double>::epsilon()) {
+      w[i] = vpMath::sqr(1 - vpMath::sqr(xi_sig / tukeyCst));
+    } else {
+      // Outlier - could resize list of points tracked here?
+      w[i] = 0;
+    }
+  }
+}
+
+void huberScalar(const double *x, double sig, double *w, unsigned int n)
+{
+  for (unsigned int i = 0; i < n; i++) {
+    if (std::fabs(w[i]) > std::numeric_limits<double>::epsilon()) {
+      double xi_sig = std::fabs(x[i] / sig);
+      w[i] = xi_sig <= huberCst ? 1 : huberCst / xi_sig;
+    }
+  }
+}
+
+void cauchyScalar(const double *x, double sig, double *w, unsigned int n)
+{
+  const double const_sig = cauchyCst * sig;
+  for (unsigned int i = 0; i < n; i++) {
+    w[i] = 1 / (1 + vpMath::sqr(x[i] / const_sig));
+  }
+}
+
+#if VISP_HAVE_AVX_KERNEL
+VISP_TARGET_AVX inline __m256d absAVX(__m256d v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+
+VISP_TARGET_AVX void absDiffAVX(const double *r, double med, double *out, unsigned int n)
+{
+  const __m256d m = _mm256_set1_pd(med);
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, absAVX(_mm256_sub_pd(_mm256_loadu_pd(r + i), m)));
+  }
+  absDiffScalar(r + i, med, out + i, n - i);
+}
+
+VISP_TARGET_AVX void tukeyAVX(const double *x, double sig, double *w, unsigned int n)
+{
+  const __m256d s = _mm256_set1_pd(sig), c = _mm256_set1_pd(tukeyCst), one = _mm256_set1_pd(1.0);
+  const __m256d eps = _mm256_set1_pd(std::numeric_limits<double>::epsilon());
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d xi_sig = _mm256_div_pd(_mm256_loadu_pd(x + i), s);
+    const __m256d inlier = _mm256_and_pd(_mm256_cmp_pd(absAVX(xi_sig), c, _CMP_LE_OQ),
+                                         _mm256_cmp_pd(absAVX(_mm256_loadu_pd(w + i)), eps, _CMP_GT_OQ));
+    const __m256d u = _mm256_div_pd(xi_sig, c);
+    const __m256d v = _mm256_sub_pd(one, _mm256_mul_pd(u, u));
+    _mm256_storeu_pd(w + i, _mm256_and_pd(inlier, _mm256_mul_pd(v, v)));
+  }
+  tukeyScalar(x + i, sig, w + i, n - i);
+}
+
+VISP_TARGET_AVX void huberAVX(const double *x, double sig, double *w, unsigned int n)
+{
+  const __m256d s = _mm256_set1_pd(sig), c = _mm256_set1_pd(huberCst), one = _mm256_set1_pd(1.0);
+  const __m256d eps = _mm256_set1_pd(std::numeric_limits<double>::epsilon());
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d wi = _mm256_loadu_pd(w + i);
+    const __m256d xi_sig = absAVX(_mm256_div_pd(_mm256_loadu_pd(x + i), s));
+    const __m256d v = _mm256_blendv_pd(_mm256_div_pd(c, xi_sig), one, _mm256_cmp_pd(xi_sig, c, _CMP_LE_OQ));
+    _mm256_storeu_pd(w + i, _mm256_blendv_pd(wi, v, _mm256_cmp_pd(absAVX(wi), eps, _CMP_GT_OQ)));
+  }
+  huberScalar(x + i, sig, w + i, n - i);
+}
+
+VISP_TARGET_AVX void cauchyAVX(const double *x, double sig, double *w, unsigned int n)
+{
+  const __m256d s = _mm256_set1_pd(cauchyCst * sig), one = _mm256_set1_pd(1.0);
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d u = _mm256_div_pd(_mm256_loadu_pd(x + i), s);
+    _mm256_storeu_pd(w + i, _mm256_div_pd(one, _mm256_add_pd(one, _mm256_mul_pd(u, u))));
+  }
+  cauchyScalar(x + i, sig, w + i, n - i);
+}
+#endif
+
+#if VISP_HAVE_NEON_KERNEL
+void absDiffNEON(const double *r, double med, double *out, unsigned int n)
+{
+  const float64x2_t m = vdupq_n_f64(med);
+  unsigned int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    vst1q_f64(out + i, vabsq_f64(vsubq_f64(vld1q_f64(r + i), m)));
+  }
+  absDiffScalar(r + i, med, out + i, n - i);
+}
+
+void tukeyNEON(const double *x, double sig, double *w, unsigned int n)
+{
+  const float64x2_t s = vdupq_n_f64(sig), c = vdupq_n_f64(tukeyCst), one = vdupq_n_f64(1.0);
+  const float64x2_t eps = vdupq_n_f64(std::numeric_limits<double>::epsilon()), zero = vdupq_n_f64(0.0);
+  unsigned int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const float64x2_t xi_sig = vdivq_f64(vld1q_f64(x + i), s);
+    const uint64x2_t inlier = vandq_u64(vcleq_f64(vabsq_f64(xi_sig), c), vcgtq_f64(vabsq_f64(vld1q_f64(w + i)), eps));
+    const float64x2_t u = vdivq_f64(xi_sig, c);
+    const float64x2_t v = vsubq_f64(one, vmulq_f64(u, u));
+    vst1q_f64(w + i, vbslq_f64(inlier, vmulq_f64(v, v), zero));
+  }
+  tukeyScalar(x + i, sig, w + i, n - i);
+}
+
+void huberNEON(const double *x, double sig, double *w, unsigned int n)
+{
+  const float64x2_t s = vdupq_n_f64(sig), c = vdupq_n_f64(huberCst), one = vdupq_n_f64(1.0);
+  const float64x2_t eps = vdupq_n_f64(std::numeric_limits<double>::epsilon());
+  unsigned int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const float64x2_t wi = vld1q_f64(w + i);
+    const float64x2_t xi_sig = vabsq_f64(vdivq_f64(vld1q_f64(x + i), s));
+    const float64x2_t v = vbslq_f64(vcleq_f64(xi_sig, c), one, vdivq_f64(c, xi_sig));
+    vst1q_f64(w + i, vbslq_f64(vcgtq_f64(vabsq_f64(wi), eps), v, wi));
+  }
+  huberScalar(x + i, sig, w + i, n - i);
+}
+
+void cauchyNEON(const double *x, double sig, double *w, unsigned int n)
+{
+  const float64x2_t s = vdupq_n_f64(cauchyCst * sig), one = vdupq_n_f64(1.0);
+  unsigned int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const float64x2_t u = vdivq_f64(vld1q_f64(x + i), s);
+    vst1q_f64(w + i, vdivq_f64(one, vaddq_f64(one, vmulq_f64(u, u))));
+  }
+  cauchyScalar(x + i, sig, w + i, n - i);
+}
+#endif
+
+struct vpRobustKernels {
+  void (*absDiff)(const double *r, double med, double *out, unsigned int n);
+  void (*tukey)(const double *x, double sig, double *w, unsigned int n);
+  void (*huber)(const double *x, double sig, double *w, unsigned int n);
+  void (*cauchy)(const double *x, double sig, double *w, unsigned int n);
+};
+
+vpRobustKernels selectRobustKernels()
+{
+  vpRobustKernels kernels = {absDiffScalar, tukeyScalar, huberScalar, cauchyScalar};
+#if VISP_HAVE_NEON_KERNEL
+  kernels.absDiff = absDiffNEON;
+  kernels.tukey = tukeyNEON;
+  kernels.huber = huberNEON;
+  kernels.cauchy = cauchyNEON;
+#endif
+#if VISP_HAVE_AVX_KERNEL
+  if (vpCPUFeatures::checkAVX()) {
+    kernels.absDiff = absDiffAVX;
+    kernels.tukey = tukeyAVX;
+    kernels.huber = huberAVX;
+    kernels.cauchy = cauchyAVX;
+  }
+#endif
+  return kernels;
+}
+
+const vpRobustKernels &robustKernels()
+{
+  static const vpRobustKernels kernels = selectRobustKernels();
+  return kernels;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 // ===================================================================
 /*!
   \brief Constructor.
@@ -63,13 +275,10 @@
 
 */
 vpRobust::vpRobust(unsigned int n_data)
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
+  : normres(n_data), sorted_normres(n_data), sorted_residues(n_data), NoiseThreshold(0.0017), sig_prev(0), it(0),
+    size(n_data)
 {
   vpCDEBUG(2) << "vpRobust constructor reached" << std::endl;
-
-  normres.resize(n_data);
-  sorted_normres.resize(n_data);
-  sorted_residues.resize(n_data);
   // NoiseThreshold=0.0017; //Can not be more accurate than 1 pixel
 }
 
@@ -77,7 +286,7 @@ vpRobust::vpRobust(unsigned int n_data)
   Default constructor.
 */
 vpRobust::vpRobust()
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
+  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), size(0)
 {
 }
 
@@ -97,7 +306,6 @@ vpRobust &vpRobust::operator=(const vpRobust &other)
   NoiseThreshold = other.NoiseThreshold;
   sig_prev = other.sig_prev;
   it = other.it;
-  swap = other.swap;
   size = other.size;
   return *this;
 }
@@ -114,7 +322,6 @@ vpRobust &vpRobust::operator=(const vpRobust &&other)
   NoiseThreshold = std::move(other.NoiseThreshold);
   sig_prev = std::move(other.sig_prev);
   it = std::move(other.it);
-  swap = std::move(other.swap);
   size = std::move(other.size);
   return *this;
 }
@@ -124,16 +331,17 @@ vpRobust &vpRobust::operator=(const vpRobust &&other)
   \brief Resize containers.
   \param n_data : size of input data vector.
 
+  The containers only grow, so that alternating between data vectors of
+  different sizes does not reallocate them.
 */
 void vpRobust::resize(unsigned int n_data)
 {
-
-  if (n_data != size) {
+  if (n_data > sorted_residues.size()) {
     normres.resize(n_data);
     sorted_normres.resize(n_data);
     sorted_residues.resize(n_data);
-    size = n_data;
   }
+  size = n_data;
 }
 
 // ===================================================================
@@ -180,26 +388,27 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   double normmedian = 0; // Normalized median
   double sigma = 0;      // Standard Deviation
 
-  // resize vector only if the size of residue vector has changed
+  // resize vector only if the size of residue vector has increased
   unsigned int n_data = residues.getRows();
+  if (n_data == 0) {
+    return;
+  }
   resize(n_data);
 
-  sorted_residues = residues;
+  std::copy(residues.data, residues.data + n_data, sorted_residues.begin());
 
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
 
   // Calculate median
-  med = select(sorted_residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  med = select(&sorted_residues[0], n_data, ind_med);
   // residualMedian = med ;
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++) {
-    normres[i] = (fabs(residues[i] - med));
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
-  }
+  robustKernels().absDiff(residues.data, med, &normres[0], n_data);
+  std::copy(normres.begin(), normres.begin() + n_data, sorted_normres.begin());
 
   // Calculate MAD
-  normmedian = select(sorted_normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  normmedian = select(&sorted_normres[0], n_data, ind_med);
   // normalizedResidualMedian = normmedian ;
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826 * normmedian; // median Absolute Deviation
@@ -212,17 +421,17 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
 
   switch (method) {
   case TUKEY: {
-    psiTukey(sigma, normres, weights);
+    psiTukey(sigma, normres, n_data, weights);
 
     vpCDEBUG(2) << "Tukey's function computed" << std::endl;
     break;
   }
   case CAUCHY: {
-    psiCauchy(sigma, normres, weights);
+    psiCauchy(sigma, normres, n_data, weights);
     break;
   }
   case HUBER: {
-    psiHuber(sigma, normres, weights);
+    psiHuber(sigma, normres, n_data, weights);
     break;
   }
   }
@@ -236,11 +445,10 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   double sigma = 0;      // Standard Deviation
 
   unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data);
 
-  // compute median with the residues vector, return all_normres which are the
+  // compute median with the residues vector, normres is set to the
   // normalized all_residues vector.
-  normmedian = computeNormalizedMedian(all_normres, residues, all_residues, weights);
+  normmedian = computeNormalizedMedian(residues, all_residues, weights);
 
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826 * normmedian; // Median Absolute Deviation
@@ -253,24 +461,24 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
 
   switch (method) {
   case TUKEY: {
-    psiTukey(sigma, all_normres, weights);
+    psiTukey(sigma, normres, n_all_data, weights);
 
     vpCDEBUG(2) << "Tukey's function computed" << std::endl;
     break;
   }
   case CAUCHY: {
-    psiCauchy(sigma, all_normres, weights);
+    psiCauchy(sigma, normres, n_all_data, weights);
     break;
   }
   case HUBER: {
-    psiHuber(sigma, all_normres, weights);
+    psiHuber(sigma, normres, n_all_data, weights);
     break;
   }
   };
 }
 
-double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVector &residues,
-                                         const vpColVector &all_residues, const vpColVector &weights)
+double vpRobust::computeNormalizedMedian(const vpColVector &residues, const vpColVector &all_residues,
+                                         const vpColVector &weights)
 {
   double med = 0;
   double normmedian = 0;
@@ -278,53 +486,42 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVe
   unsigned int n_all_data = all_residues.getRows();
   unsigned int n_data = residues.getRows();
 
-  // resize vector only if the size of residue vector has changed
+  // resize vector only if the size of residue vector has increased
   resize(n_data);
+  if (normres.size() < n_all_data) {
+    normres.resize(n_all_data);
+  }
 
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-
-  // all_normres.resize(n_all_data); // Normalized Residue
-  // vpColVector sorted_normres(n_data); // Normalized Residue
-  // vpColVector sorted_residues = residues;
-  // vpColVector sorted_residues;
-
+  // Be careful to not use the rejected residues for the
+  // calculation.
   unsigned int index = 0;
   for (unsigned int j = 0; j < n_data; j++) {
     // if(weights[j]!=0)
     if (std::fabs(weights[j]) > std::numeric_limits<double>::epsilon()) {
-      no_null_weight_residues[index] = residues[j];
+      sorted_residues[index] = residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data, no_null_weight_residues.data, index * sizeof(double));
   n_data = index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
 
   // Calculate Median
-  // Be careful to not use the rejected residues for the
-  // calculation.
-
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
-  med = select(sorted_residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  if (n_data > 0) {
+    med = select(&sorted_residues[0], n_data, ind_med);
+  }
 
-  unsigned int i;
   // Normalize residues
-  for (i = 0; i < n_all_data; i++) {
-    all_normres[i] = (fabs(all_residues[i] - med));
+  if (n_all_data > 0) {
+    robustKernels().absDiff(all_residues.data, med, &normres[0], n_all_data);
   }
+  if (n_data > 0) {
+    robustKernels().absDiff(&sorted_residues[0], med, &sorted_normres[0], n_data);
 
-  for (i = 0; i < n_data; i++) {
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
+    // MAD calculated only on first iteration
+    normmedian = select(&sorted_normres[0], n_data, ind_med);
   }
-  // MAD calculated only on first iteration
-
-  // normmedian = Median(normres, weights);
-  // normmedian = Median(normres);
-  normmedian = select(sorted_normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
 
   return normmedian;
 }
@@ -345,24 +542,23 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
   double sigma = 0; // Standard Deviation
 
   unsigned int n_data = residues.getRows();
-  vpColVector norm_res(n_data); // Normalized Residue
+  std::vector<double> norm_res(n_data); // Normalized Residue
   vpColVector w(n_data);
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
 
   // Calculate Median
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
-  med = select(residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  med = select(residues.data, n_data, ind_med);
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++)
-    norm_res[i] = (fabs(residues[i] - med));
+  robustKernels().absDiff(residues.data, med, &norm_res[0], n_data);
 
   // Check for various methods.
   // For Huber compute Simultaneous scale estimate
   // For Others use MAD calculated on first iteration
   if (it == 0) {
-    double normmedian = select(norm_res, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/); // Normalized Median
+    double normmedian = select(&norm_res[0], n_data, ind_med); // Normalized Median
     // 1.48 keeps scale estimate consistent for a normal probability dist.
     sigma = 1.4826 * normmedian; // Median Absolute Deviation
   } else {
@@ -378,7 +574,7 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
 
   vpCDEBUG(2) << "MAD and C computed" << std::endl;
 
-  psiHuber(sigma, norm_res, w);
+  psiHuber(sigma, norm_res, n_data, w);
 
   sig_prev = sigma;
 
@@ -526,137 +722,109 @@ double vpRobust::simult_chi_huber(double x)
 /*!
   \brief calculation of Tukey's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n_data : number of residues
   \param weights : weight vector
 */
 
-void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiTukey(double sig, const std::vector<double> &x, unsigned int n_data, vpColVector &weights)
 {
+  if (n_data == 0) {
+    return;
+  }
 
-  unsigned int n_data = x.getRows();
-  double cst_const = vpCST * 4.6851;
-
-  for (unsigned int i = 0; i < n_data; i++) {
-    // if(sig==0 && weights[i]!=0)
-    if (std::fabs(sig) <= std::numeric_limits<double>::epsilon() &&
-        std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
-      weights[i] = 1;
-      continue;
-    }
-
-    double xi_sig = x[i] / sig;
-
-    // if((fabs(xi_sig)<=(cst_const)) && weights[i]!=0)
-    if ((std::fabs(xi_sig) <= (cst_const)) && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
-      weights[i] = vpMath::sqr(1 - vpMath::sqr(xi_sig / cst_const));
-      // w[i] = vpMath::sqr(1-vpMath::sqr(x[i]/sig/4.7));
-    } else {
-      // Outlier - could resize list of points tracked here?
-      weights[i] = 0;
+  // if(sig==0)
+  if (std::fabs(sig) <= std::numeric_limits<double>::epsilon()) {
+    for (unsigned int i = 0; i < n_data; i++) {
+      // if(weights[i]!=0)
+      weights[i] = std::fabs(weights[i]) > std::numeric_limits<double>::epsilon() ? 1 : 0;
     }
+    return;
   }
+
+  robustKernels().tukey(&x[0], sig, weights.data, n_data);
 }
 
 /*!
-  \brief calculation of Tukey's influence function
+  \brief calculation of Huber's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n_data : number of residues
   \param weights : weight vector
 */
-void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiHuber(double sig, const std::vector<double> &x, unsigned int n_data, vpColVector &weights)
 {
-  double c = 1.2107; // 1.345;
-  unsigned int n_data = x.getRows();
-
-  for (unsigned int i = 0; i < n_data; i++) {
-    // if(weights[i]!=0)
-    if (std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
-      double xi_sig = x[i] / sig;
-      if (fabs(xi_sig) <= c)
-        weights[i] = 1;
-      else
-        weights[i] = c / fabs(xi_sig);
-    }
+  if (n_data > 0) {
+    robustKernels().huber(&x[0], sig, weights.data, n_data);
   }
 }
 
 /*!
   \brief calculation of Cauchy's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n_data : number of residues
   \param weights : weight vector
 */
 
-void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiCauchy(double sig, const std::vector<double> &x, unsigned int n_data, vpColVector &weights)
 {
-  unsigned int n_data = x.getRows();
-  double const_sig = 2.3849 * sig;
-
-  // Calculate Cauchy's equation
-  for (unsigned int i = 0; i < n_data; i++) {
-    weights[i] = 1 / (1 + vpMath::sqr(x[i] / (const_sig)));
-
-    // If one coordinate is an outlier the other is too!
-    // w[i] < 0.01 is a threshold to be set
-    /*if(w[i] < 0.01)
-      {
-      if(i%2 == 0)
-      {
-      w[i+1] = w[i];
-      i++;
-      }
-      else
-      w[i-1] = w[i];
-      }*/
+  // If one coordinate is an outlier the other is too!
+  if (n_data > 0) {
+    robustKernels().cauchy(&x[0], sig, weights.data, n_data);
   }
 }
 
 /*!
-  \brief partition function
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
-*/
-int vpRobust::partition(vpColVector &a, int l, int r)
-{
-  int i = l - 1;
-  int j = r;
-  double v = a[(unsigned int)r];
+  \brief select a value of a partially sorted vector
 
-  for (;;) {
-    while (a[(unsigned int)++i] < v)
-      ;
-    while (v < a[(unsigned int)--j])
-      if (j == l)
-        break;
-    if (i >= j)
-      break;
-    exch(a[(unsigned int)i], a[(unsigned int)j]);
-  }
-  exch(a[(unsigned int)i], a[(unsigned int)r]);
-  return i;
-}
+  Large vectors are first binned in a histogram over their range; only the
+  values of the bin that contains the k-th value are then partially sorted.
+  The selected value is exact.
 
-/*!
-  \brief sort a part of a vector and select a value of this new vector
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
-  \param k : value to be selected
+  \param a : vector to be partially sorted
+  \param n : number of values to be considered
+  \param k : index of the value to be selected in the sorted vector
 */
-double vpRobust::select(vpColVector &a, int l, int r, int k)
+double vpRobust::select(double *a, unsigned int n, unsigned int k)
 {
-  while (r > l) {
-    int i = partition(a, l, r);
-    if (i >= k)
-      r = i - 1;
-    if (i <= k)
-      l = i + 1;
+  const unsigned int nbBins = 1024;
+  if (n >= 4 * nbBins) {
+    double min = a[0], max = a[0];
+    for (unsigned int i = 1; i < n; i++) {
+      min = a[i] < min ? a[i] : min;
+      max = a[i] > max ? a[i] : max;
+    }
+
+    const double scale = nbBins / (max - min);
+    if (scale > 0 && scale < std::numeric_limits<double>::infinity()) {
+      unsigned int histogram[nbBins] = {0};
+      for (unsigned int i = 0; i < n; i++) {
+        histogram[std::min((unsigned int)((a[i] - min) * scale), nbBins - 1)]++;
+      }
+
+      unsigned int bin = 0;
+      while (k >= histogram[bin]) {
+        k -= histogram[bin];
+        bin++;
+      }
+
+      // Move the values of the bin in front of the vector
+      unsigned int nb = 0;
+      for (unsigned int i = 0; i < n; i++) {
+        if (std::min((unsigned int)((a[i] - min) * scale), nbBins - 1) == bin) {
+          std::swap(a[i], a[nb++]);
+        }
+      }
+      n = nb;
+    }
   }
-  return a[(unsigned int)k];
+
+  std::nth_element(a, a + k, a + n);
+  return a[k];
 }
 
 #if !defined(VISP_HAVE_FUNC_ERFC) && !defined(VISP_HAVE_FUNC_STD_ERFC)
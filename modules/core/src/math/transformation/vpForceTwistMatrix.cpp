@@ -59,10 +59,8 @@
 */
 vpForceTwistMatrix &vpForceTwistMatrix::operator=(const vpForceTwistMatrix &M)
 {
-  for (int i = 0; i < 6; i++) {
-    for (int j = 0; j < 6; j++) {
-      rowPtrs[i][j] = M.rowPtrs[i][j];
-    }
+  for (unsigned int i = 0; i < 36; i++) {
+    data[i] = M.data[i];
   }
 
   return *this;
@@ -86,7 +84,7 @@ void vpForceTwistMatrix::eye()
 /*!
   Initialize a force/torque twist transformation matrix to identity.
 */
-vpForceTwistMatrix::vpForceTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
+vpForceTwistMatrix::vpForceTwistMatrix() : vpFixedMatrix<6, 6>() { eye(); }
 
 /*!
 
@@ -95,7 +93,7 @@ vpForceTwistMatrix::vpForceTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
 
   \param F : Force/torque twist matrix used as initializer.
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F) : vpArray2D<double>(6, 6) { *this = F; }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F) : vpFixedMatrix<6, 6>() { *this = F; }
 
 /*!
 
@@ -126,7 +124,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F) : vpArray2D<
   \f]
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpArray2D<double>(6, 6)
+vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpFixedMatrix<6, 6>()
 {
   if (full)
     buildFrom(M);
@@ -154,7 +152,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   buildFrom(t, thetau);
 }
@@ -176,7 +174,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpThe
   \param thetau : \f$\theta u\f$ rotation vector used to initialize \f$R\f$.
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau) : vpArray2D<double>(6, 6) { buildFrom(thetau); }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau) : vpFixedMatrix<6, 6>() { buildFrom(thetau); }
 
 /*!
 
@@ -198,7 +196,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau) : vpArray2D
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   buildFrom(t, R);
 }
@@ -220,7 +218,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpRot
   \param R : Rotation matrix.
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R) : vpArray2D<double>(6, 6) { buildFrom(R); }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R) : vpFixedMatrix<6, 6>() { buildFrom(R); }
 
 /*!
 
@@ -244,7 +242,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R) : vpArray2D<do
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz, const double tux,
                                        const double tuy, const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   vpTranslationVector T(tx, ty, tz);
   vpThetaUVector tu(tux, tuy, tuz);
@@ -274,11 +272,10 @@ vpForceTwistMatrix vpForceTwistMatrix::operator*(const vpForceTwistMatrix &F) co
   vpForceTwistMatrix Fout;
 
   for (unsigned int i = 0; i < 6; i++) {
+    const double *a = data + 6 * i;
     for (unsigned int j = 0; j < 6; j++) {
-      double s = 0;
-      for (unsigned int k = 0; k < 6; k++)
-        s += rowPtrs[i][k] * F.rowPtrs[k][j];
-      Fout[i][j] = s;
+      const double *b = F.data + j;
+      Fout.data[6 * i + j] = a[0] * b[0] + a[1] * b[6] + a[2] * b[12] + a[3] * b[18] + a[4] * b[24] + a[5] * b[30];
     }
   }
   return Fout;
@@ -401,13 +398,15 @@ vpColVector vpForceTwistMatrix::operator*(const vpColVector &H) const
 */
 vpForceTwistMatrix vpForceTwistMatrix::buildFrom(const vpTranslationVector &t, const vpRotationMatrix &R)
 {
-  vpMatrix skewaR = t.skew(t) * R;
-
-  for (unsigned int i = 0; i < 3; i++) {
-    for (unsigned int j = 0; j < 3; j++) {
-      (*this)[i][j] = R[i][j];
-      (*this)[i + 3][j + 3] = R[i][j];
-      (*this)[i + 3][j] = skewaR[i][j];
+  // [t]_x R computed in place of a 3x3 vpMatrix product
+  const double *r = R.data;
+  for (unsigned int j = 0; j < 3; j++) {
+    const double skewaR[3] = {-t[2] * r[3 + j] + t[1] * r[6 + j], t[2] * r[j] - t[0] * r[6 + j],
+                              -t[1] * r[j] + t[0] * r[3 + j]};
+    for (unsigned int i = 0; i < 3; i++) {
+      data[6 * i + j] = r[3 * i + j];
+      data[6 * (i + 3) + j + 3] = r[3 * i + j];
+      data[6 * (i + 3) + j] = skewaR[i];
     }
   }
   return (*this);
@@ -54,7 +54,7 @@
   rotation vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpFixedMatrix<4, 4>()
 {
   buildFrom(t, q);
   (*this)[3][3] = 1.;
@@ -63,20 +63,20 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpQ
 /*!
   Default constructor that initialize an homogeneous matrix as identity.
 */
-vpHomogeneousMatrix::vpHomogeneousMatrix() : vpArray2D<double>(4, 4) { eye(); }
+vpHomogeneousMatrix::vpHomogeneousMatrix() : vpFixedMatrix<4, 4>() { eye(); }
 
 /*!
   Copy constructor that initialize an homogeneous matrix from another
   homogeneous matrix.
 */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(4, 4) { *this = M; }
+vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M) : vpFixedMatrix<4, 4>() { *this = M; }
 
 /*!
   Construct an homogeneous matrix from a translation vector and \f$\theta {\bf
   u}\f$ rotation vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpFixedMatrix<4, 4>()
 {
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
@@ -87,7 +87,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpT
   matrix.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpFixedMatrix<4, 4>()
 {
   insert(R);
   insert(t);
@@ -97,7 +97,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpR
 /*!
   Construct an homogeneous matrix from a pose vector.
  */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p) : vpFixedMatrix<4, 4>()
 {
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]);
   (*this)[3][3] = 1.;
@@ -142,7 +142,7 @@ M:
 0  0  0  1
   \endcode
   */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v) : vpFixedMatrix<4, 4>()
 {
   buildFrom(v);
   (*this)[3][3] = 1.;
@@ -187,7 +187,7 @@ M:
 0  0  0  1
   \endcode
   */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v) : vpFixedMatrix<4, 4>()
 {
   buildFrom(v);
   (*this)[3][3] = 1.;
@@ -200,7 +200,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v) : vpArray
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx, const double ty, const double tz, const double tux,
                                          const double tuy, const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpFixedMatrix<4, 4>()
 {
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
@@ -370,10 +370,8 @@ void vpHomogeneousMatrix::buildFrom(const std::vector<double> &v)
 */
 vpHomogeneousMatrix &vpHomogeneousMatrix::operator=(const vpHomogeneousMatrix &M)
 {
-  for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4; j++) {
-      rowPtrs[i][j] = M.rowPtrs[i][j];
-    }
+  for (unsigned int i = 0; i < 16; i++) {
+    data[i] = M.data[i];
   }
   return *this;
 }
@@ -399,21 +397,16 @@ vpHomogeneousMatrix vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M)
 {
   vpHomogeneousMatrix p;
 
-  vpRotationMatrix R1, R2, R;
-  vpTranslationVector T1, T2, T;
-
-  extract(T1);
-  M.extract(T2);
-
-  extract(R1);
-  M.extract(R2);
-
-  R = R1 * R2;
-
-  T = R1 * T2 + T1;
-
-  p.insert(T);
-  p.insert(R);
+  // [R1 T1] [R2 T2] = [R1 R2  R1 T2 + T1], the last row of p is already set
+  const double *B = M.data;
+  for (unsigned int i = 0; i < 3; i++) {
+    const double *a = data + 4 * i;
+    double *c = p.data + 4 * i;
+    c[0] = a[0] * B[0] + a[1] * B[4] + a[2] * B[8];
+    c[1] = a[0] * B[1] + a[1] * B[5] + a[2] * B[9];
+    c[2] = a[0] * B[2] + a[1] * B[6] + a[2] * B[10];
+    c[3] = a[0] * B[3] + a[1] * B[7] + a[2] * B[11] + a[3];
+  }
 
   return p;
 }
@@ -644,16 +637,13 @@ vpHomogeneousMatrix vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi;
 
-  vpRotationMatrix R;
-  extract(R);
-  vpTranslationVector T;
-  extract(T);
-
-  vpTranslationVector RtT;
-  RtT = -(R.t() * T);
-
-  Mi.insert(R.t());
-  Mi.insert(RtT);
+  for (unsigned int i = 0; i < 3; i++) {
+    double *c = Mi.data + 4 * i;
+    c[0] = data[i];
+    c[1] = data[4 + i];
+    c[2] = data[8 + i];
+    c[3] = -(data[i] * data[3] + data[4 + i] * data[7] + data[8 + i] * data[11]);
+  }
 
   return Mi;
 }
@@ -63,7 +63,7 @@
   The pose vector is initialized to zero.
 
 */
-vpPoseVector::vpPoseVector() : vpArray2D<double>(6, 1) {}
+vpPoseVector::vpPoseVector() : vpFixedMatrix<6, 1>() {}
 
 /*!
 
@@ -82,7 +82,7 @@ vpPoseVector::vpPoseVector() : vpArray2D<double>(6, 1) {}
 */
 vpPoseVector::vpPoseVector(const double tx, const double ty, const double tz, const double tux, const double tuy,
                            const double tuz)
-  : vpArray2D<double>(6, 1)
+  : vpFixedMatrix<6, 1>()
 {
   (*this)[0] = tx;
   (*this)[1] = ty;
@@ -103,7 +103,7 @@ vpPoseVector::vpPoseVector(const double tx, const double ty, const double tz, co
   \param tu : \f$\theta \bf u\f$ rotation  vector.
 
 */
-vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpThetaUVector &tu) : vpArray2D<double>(6, 1)
+vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpThetaUVector &tu) : vpFixedMatrix<6, 1>()
 {
   buildFrom(tv, tu);
 }
@@ -120,7 +120,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpThetaUVector &
   u\f$ vector is extracted to initialise the pose vector.
 
 */
-vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpRotationMatrix &R) : vpArray2D<double>(6, 1)
+vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpRotationMatrix &R) : vpFixedMatrix<6, 1>()
 {
   buildFrom(tv, R);
 }
@@ -135,7 +135,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector &tv, const vpRotationMatrix
   initialize the pose vector.
 
 */
-vpPoseVector::vpPoseVector(const vpHomogeneousMatrix &M) : vpArray2D<double>(6, 1) { buildFrom(M); }
+vpPoseVector::vpPoseVector(const vpHomogeneousMatrix &M) : vpFixedMatrix<6, 1>() { buildFrom(M); }
 
 /*!
 
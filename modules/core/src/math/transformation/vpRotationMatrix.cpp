@@ -84,10 +84,8 @@ void vpRotationMatrix::eye()
 */
 vpRotationMatrix &vpRotationMatrix::operator=(const vpRotationMatrix &R)
 {
-  for (unsigned int i = 0; i < 3; i++) {
-    for (unsigned int j = 0; j < 3; j++) {
-      rowPtrs[i][j] = R.rowPtrs[i][j];
-    }
+  for (unsigned int i = 0; i < 9; i++) {
+    data[i] = R.data[i];
   }
 
   return *this;
@@ -138,13 +136,13 @@ vpRotationMatrix vpRotationMatrix::operator*(const vpRotationMatrix &R) const
 {
   vpRotationMatrix p;
 
+  const double *B = R.data;
   for (unsigned int i = 0; i < 3; i++) {
-    for (unsigned int j = 0; j < 3; j++) {
-      double s = 0;
-      for (unsigned int k = 0; k < 3; k++)
-        s += rowPtrs[i][k] * R.rowPtrs[k][j];
-      p[i][j] = s;
-    }
+    const double *a = data + 3 * i;
+    double *c = p.data + 3 * i;
+    c[0] = a[0] * B[0] + a[1] * B[3] + a[2] * B[6];
+    c[1] = a[0] * B[1] + a[1] * B[4] + a[2] * B[7];
+    c[2] = a[0] * B[2] + a[1] * B[5] + a[2] * B[8];
   }
   return p;
 }
@@ -238,13 +236,8 @@ vpTranslationVector vpRotationMatrix::operator*(const vpTranslationVector &tv) c
 {
   vpTranslationVector p;
 
-  for (unsigned int j = 0; j < 3; j++)
-    p[j] = 0;
-
-  for (unsigned int j = 0; j < 3; j++) {
-    for (unsigned int i = 0; i < 3; i++) {
-      p[i] += rowPtrs[i][j] * tv[j];
-    }
+  for (unsigned int i = 0; i < 3; i++) {
+    p.data[i] = data[3 * i] * tv.data[0] + data[3 * i + 1] * tv.data[1] + data[3 * i + 2] * tv.data[2];
   }
 
   return p;
@@ -321,52 +314,52 @@ bool vpRotationMatrix::isARotationMatrix() const
 /*!
   Default constructor that initialise a 3-by-3 rotation matrix to identity.
 */
-vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3, 3) { eye(); }
+vpRotationMatrix::vpRotationMatrix() : vpFixedMatrix<3, 3>() { eye(); }
 
 /*!
   Copy contructor that construct a 3-by-3 rotation matrix from another
   rotation matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpArray2D<double>(3, 3) { (*this) = M; }
+vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpFixedMatrix<3, 3>() { (*this) = M; }
 /*!
   Construct a 3-by-3 rotation matrix from an homogeneous matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(3, 3) { buildFrom(M); }
+vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpFixedMatrix<3, 3>() { buildFrom(M); }
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}\f$ angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>(3, 3) { buildFrom(tu); }
+vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpFixedMatrix<3, 3>() { buildFrom(tu); }
 
 /*!
   Construct a 3-by-3 rotation matrix from a pose vector.
  */
-vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3, 3) { buildFrom(p); }
+vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpFixedMatrix<3, 3>() { buildFrom(p); }
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,z) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double>(3, 3) { buildFrom(euler); }
+vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpFixedMatrix<3, 3>() { buildFrom(euler); }
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(x,y,z) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>(3, 3) { buildFrom(Rxyz); }
+vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpFixedMatrix<3, 3>() { buildFrom(Rxyz); }
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,x) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>(3, 3) { buildFrom(Rzyx); }
+vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpFixedMatrix<3, 3>() { buildFrom(Rzyx); }
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}=(\theta u_x,
   \theta u_y, \theta u_z)^T\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpArray2D<double>(3, 3)
+vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpFixedMatrix<3, 3>()
 {
   buildFrom(tux, tuy, tuz);
 }
@@ -374,7 +367,7 @@ vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const dou
 /*!
   Construct a 3-by-3 rotation matrix from quaternion angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector &q) : vpArray2D<double>(3, 3) { buildFrom(q); }
+vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector &q) : vpFixedMatrix<3, 3>() { buildFrom(q); }
 
 /*!
   Return the rotation matrix transpose which is also the inverse of the
@@ -386,10 +379,11 @@ vpRotationMatrix vpRotationMatrix::t() const
 {
   vpRotationMatrix Rt;
 
-  unsigned int i, j;
-  for (i = 0; i < 3; i++)
-    for (j = 0; j < 3; j++)
-      Rt[j][i] = (*this)[i][j];
+  for (unsigned int i = 0; i < 3; i++) {
+    Rt.data[3 * i] = data[i];
+    Rt.data[3 * i + 1] = data[3 + i];
+    Rt.data[3 * i + 2] = data[6 + i];
+  }
 
   return Rt;
 }
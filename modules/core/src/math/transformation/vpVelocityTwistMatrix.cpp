@@ -57,10 +57,8 @@
 */
 vpVelocityTwistMatrix &vpVelocityTwistMatrix::operator=(const vpVelocityTwistMatrix &V)
 {
-  for (int i = 0; i < 6; i++) {
-    for (int j = 0; j < 6; j++) {
-      rowPtrs[i][j] = V.rowPtrs[i][j];
-    }
+  for (unsigned int i = 0; i < 36; i++) {
+    data[i] = V.data[i];
   }
 
   return *this;
@@ -82,7 +80,7 @@ void vpVelocityTwistMatrix::eye()
 /*!
   Initialize a velocity twist transformation matrix as identity.
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpFixedMatrix<6, 6>() { eye(); }
 
 /*!
   Initialize a velocity twist transformation matrix from another velocity
@@ -90,7 +88,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpArray2D<double>(6, 6) { eye()
 
   \param V : Velocity twist matrix used as initializer.
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V) : vpArray2D<double>(6, 6) { *this = V; }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V) : vpFixedMatrix<6, 6>() { *this = V; }
 
 /*!
 
@@ -110,7 +108,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V) : v
   {\bf 0}_{3\times 3} & {\bf R} \end{array} \right] \f]
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpArray2D<double>(6, 6)
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpFixedMatrix<6, 6>()
 {
   if (full)
     buildFrom(M);
@@ -133,7 +131,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   buildFrom(t, thetau);
 }
@@ -150,7 +148,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const
   vector \f$R\f$ .
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau) : vpArray2D<double>(6, 6)
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau) : vpFixedMatrix<6, 6>()
 {
   buildFrom(thetau);
 }
@@ -169,7 +167,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau) : vpA
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   buildFrom(t, R);
 }
@@ -185,7 +183,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const
   \param R : Rotation matrix.
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R) : vpArray2D<double>(6, 6) { buildFrom(R); }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R) : vpFixedMatrix<6, 6>() { buildFrom(R); }
 
 /*!
 
@@ -204,7 +202,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R) : vpArra
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx, const double ty, const double tz, const double tux,
                                              const double tuy, const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpFixedMatrix<6, 6>()
 {
   vpTranslationVector t(tx, ty, tz);
   vpThetaUVector tu(tux, tuy, tuz);
@@ -222,11 +220,10 @@ vpVelocityTwistMatrix vpVelocityTwistMatrix::operator*(const vpVelocityTwistMatr
   vpVelocityTwistMatrix p;
 
   for (unsigned int i = 0; i < 6; i++) {
+    const double *a = data + 6 * i;
     for (unsigned int j = 0; j < 6; j++) {
-      double s = 0;
-      for (int k = 0; k < 6; k++)
-        s += rowPtrs[i][k] * V.rowPtrs[k][j];
-      p[i][j] = s;
+      const double *b = V.data + j;
+      p.data[6 * i + j] = a[0] * b[0] + a[1] * b[6] + a[2] * b[12] + a[3] * b[18] + a[4] * b[24] + a[5] * b[30];
     }
   }
   return p;
@@ -364,13 +361,15 @@ vpVelocityTwistMatrix vpVelocityTwistMatrix::buildFrom(const vpRotationMatrix &R
 */
 vpVelocityTwistMatrix vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t, const vpRotationMatrix &R)
 {
-  vpMatrix skewaR = t.skew(t) * R;
-
-  for (unsigned int i = 0; i < 3; i++) {
-    for (unsigned int j = 0; j < 3; j++) {
-      (*this)[i][j] = R[i][j];
-      (*this)[i + 3][j + 3] = R[i][j];
-      (*this)[i][j + 3] = skewaR[i][j];
+  // [t]_x R computed in place of a 3x3 vpMatrix product
+  const double *r = R.data;
+  for (unsigned int j = 0; j < 3; j++) {
+    const double skewaR[3] = {-t[2] * r[3 + j] + t[1] * r[6 + j], t[2] * r[j] - t[0] * r[6 + j],
+                              -t[1] * r[j] + t[0] * r[3 + j]};
+    for (unsigned int i = 0; i < 3; i++) {
+      data[6 * i + j] = r[3 * i + j];
+      data[6 * (i + 3) + j + 3] = r[3 * i + j];
+      data[6 * i + j + 3] = skewaR[i];
     }
   }
 
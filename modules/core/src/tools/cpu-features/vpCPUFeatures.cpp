@@ -54,5 +54,7 @@ bool checkAVX() { return cpu_features.HW_AVX; }
 
 bool checkAVX2() { return cpu_features.HW_AVX2; }
 
+bool checkFMA() { return cpu_features.HW_FMA3; }
+
 void printCPUInfo() { cpu_features.print(); }
 } // namespace vpCPUFeatures
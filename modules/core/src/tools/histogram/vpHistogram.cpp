@@ -50,89 +50,61 @@
 #include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImageConvert.h>
 
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
 
 namespace
 {
-struct Histogram_Param_t {
-  unsigned int m_start_index;
-  unsigned int m_end_index;
-
-  unsigned int m_lut[256];
-  unsigned int *m_histogram;
-  const vpImage<unsigned char> *m_I;
-
-  Histogram_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_histogram(NULL), m_I(NULL) {}
-
-  Histogram_Param_t(const unsigned int start_index, const unsigned int end_index, const vpImage<unsigned char> *const I)
-    : m_start_index(start_index), m_end_index(end_index), m_lut(), m_histogram(NULL), m_I(I)
+// Compute one partial histogram per chunk of the image
+class HistogramBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  HistogramBody(const vpImage<unsigned char> &I, const unsigned int *lut, unsigned int size, unsigned int nbChunks,
+                unsigned int *histograms)
+    : m_I(I), m_lut(lut), m_size(size), m_nbChunks(nbChunks), m_histograms(histograms)
   {
   }
 
-  ~Histogram_Param_t()
+  void operator()(unsigned int begin, unsigned int end) const
   {
-    if (m_histogram != NULL) {
-      delete[] m_histogram;
-    }
-  }
-};
-
-vpThread::Return computeHistogramThread(vpThread::Args args)
-{
-  Histogram_Param_t *histogram_param = static_cast<Histogram_Param_t *>(args);
-  unsigned int start_index = histogram_param->m_start_index;
-  unsigned int end_index = histogram_param->m_end_index;
-
-  const vpImage<unsigned char> *I = histogram_param->m_I;
-
-  unsigned char *ptrStart = (unsigned char *)(I->bitmap) + start_index;
-  unsigned char *ptrEnd = (unsigned char *)(I->bitmap) + end_index;
-  unsigned char *ptrCurrent = ptrStart;
-
-  //    while(ptrCurrent != ptrEnd) {
-  //      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ]
-  //      ] ++;
-  //      ++ptrCurrent;
-  //    }
-
-  if (end_index - start_index >= 8) {
-    // Unroll loop version
-    for (; ptrCurrent <= ptrEnd - 8;) {
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
+    const unsigned int image_size = m_I.getSize();
+    const unsigned int step = image_size / m_nbChunks;
+
+    for (unsigned int chunk = begin; chunk < end; chunk++) {
+      unsigned int start_index = chunk * step;
+      unsigned int end_index = (chunk == m_nbChunks - 1) ? image_size : start_index + step;
+      unsigned int *histogram = m_histograms + chunk * m_size;
+
+      const unsigned char *ptrCurrent = m_I.bitmap + start_index;
+      const unsigned char *ptrEnd = m_I.bitmap + end_index;
+
+      if (end_index - start_index >= 8) {
+        // Unroll loop version
+        for (; ptrCurrent <= ptrEnd - 8; ptrCurrent += 8) {
+          histogram[m_lut[ptrCurrent[0]]]++;
+          histogram[m_lut[ptrCurrent[1]]]++;
+          histogram[m_lut[ptrCurrent[2]]]++;
+          histogram[m_lut[ptrCurrent[3]]]++;
+          histogram[m_lut[ptrCurrent[4]]]++;
+          histogram[m_lut[ptrCurrent[5]]]++;
+          histogram[m_lut[ptrCurrent[6]]]++;
+          histogram[m_lut[ptrCurrent[7]]]++;
+        }
+      }
 
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
+      for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
+        histogram[m_lut[*ptrCurrent]]++;
+      }
     }
   }
 
-  for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
-    histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-  }
-
-  return 0;
-}
+private:
+  const vpImage<unsigned char> &m_I;
+  const unsigned int *m_lut;
+  unsigned int m_size;
+  unsigned int m_nbChunks;
+  unsigned int *m_histograms;
+};
 }
-#endif
 
 bool compare_vpHistogramPeak(vpHistogramPeak first, vpHistogramPeak second);
 
@@ -233,7 +205,9 @@ void vpHistogram::init(unsigned size_)
 
   \param I : Gray level image.
   \param nbins : Number of bins to compute the histogram.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of image chunks processed in parallel by the
+  threads of vpThreadPool::getInstance(). When 0 or 1, the histogram is
+  computed by the calling thread.
 */
 void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int nbins, const unsigned int nbThreads)
 {
@@ -252,12 +226,7 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
 
   memset(histogram, 0, size * sizeof(unsigned int));
 
-  bool use_single_thread;
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#else
-  use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#endif
+  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
 
   if (!use_single_thread && I.getSize() <= nbThreads) {
     use_single_thread = true;
@@ -281,60 +250,20 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-    // Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<Histogram_Param_t *> histogramParams;
-
-    unsigned int image_size = I.getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads - 1);
-
-    for (unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index * step;
-      unsigned int end_index = (index + 1) * step;
-
-      if (index == nbThreads - 1) {
-        end_index = start_index + last_step;
-      }
-
-      Histogram_Param_t *histogram_param = new Histogram_Param_t(start_index, end_index, &I);
-      histogram_param->m_histogram = new unsigned int[size];
-      memset(histogram_param->m_histogram, 0, size * sizeof(unsigned int));
-      memcpy(histogram_param->m_lut, lut, 256 * sizeof(unsigned int));
-
-      histogramParams.push_back(histogram_param);
-
-      // Start the threads
-      vpThread *histogram_thread = new vpThread((vpThread::Fn)computeHistogramThread, (vpThread::Args)histogram_param);
-      threadpool.push_back(histogram_thread);
-    }
-
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
+    // Multi-threads: one partial histogram per chunk, reduced afterwards
+    std::vector<unsigned int> histograms(nbThreads * size, 0);
+    vpThreadPool::getInstance().parallelFor(0, nbThreads, HistogramBody(I, lut, size, nbThreads, &histograms[0]),
+                                            nbThreads);
 
     for (unsigned int cpt1 = 0; cpt1 < size; cpt1++) {
       unsigned int sum = 0;
 
-      for (size_t cpt2 = 0; cpt2 < histogramParams.size(); cpt2++) {
-        sum += histogramParams[cpt2]->m_histogram[cpt1];
+      for (unsigned int cpt2 = 0; cpt2 < nbThreads; cpt2++) {
+        sum += histograms[cpt2 * size + cpt1];
       }
 
       histogram[cpt1] = sum;
     }
-
-    // Delete
-    for (size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for (size_t cpt = 0; cpt < histogramParams.size(); cpt++) {
-      delete histogramParams[cpt];
-    }
-#endif
   }
 }
 
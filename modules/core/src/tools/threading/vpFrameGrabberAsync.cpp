@@ -0,0 +1,540 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Asynchronous frame acquisition.
+ *
+ *****************************************************************************/
+
+#include <vector>
+
+#include <visp3/core/vpFrameGrabberAsync.h>
+#include <visp3/core/vpFrameGrabberException.h>
+#include <visp3/core/vpTime.h>
+
+#if defined(VISP_HAVE_PTHREAD)
+#include <pthread.h>
+#define VP_FRAME_GRABBER_ASYNC_HAVE_THREADS 1
+#elif defined(_WIN32) && !defined(WINRT_8_0)
+// Include WinSock2.h before windows.h to ensure that winsock.h is not
+// included by windows.h since winsock.h and winsock2.h are incompatible
+#include <WinSock2.h>
+#include <windows.h>
+#define VP_FRAME_GRABBER_ASYNC_HAVE_THREADS 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+// Minimal mutex and condition variable wrappers. vpMutex relies on Windows
+// mutex handles that cannot be used with condition variables.
+class GrabberMutex
+{
+public:
+#if defined(VISP_HAVE_PTHREAD)
+  GrabberMutex() : m_mutex() { pthread_mutex_init(&m_mutex, NULL); }
+  ~GrabberMutex() { pthread_mutex_destroy(&m_mutex); }
+  void lock() { pthread_mutex_lock(&m_mutex); }
+  void unlock() { pthread_mutex_unlock(&m_mutex); }
+  pthread_mutex_t m_mutex;
+#else
+  GrabberMutex() : m_mutex() { InitializeCriticalSection(&m_mutex); }
+  ~GrabberMutex() { DeleteCriticalSection(&m_mutex); }
+  void lock() { EnterCriticalSection(&m_mutex); }
+  void unlock() { LeaveCriticalSection(&m_mutex); }
+  CRITICAL_SECTION m_mutex;
+#endif
+
+private:
+  GrabberMutex(const GrabberMutex &);
+  GrabberMutex &operator=(const GrabberMutex &);
+};
+
+class GrabberCondition
+{
+public:
+#if defined(VISP_HAVE_PTHREAD)
+  GrabberCondition() : m_cond() { pthread_cond_init(&m_cond, NULL); }
+  ~GrabberCondition() { pthread_cond_destroy(&m_cond); }
+  void wait(GrabberMutex &mutex) { pthread_cond_wait(&m_cond, &mutex.m_mutex); }
+  void broadcast() { pthread_cond_broadcast(&m_cond); }
+  pthread_cond_t m_cond;
+#else
+  GrabberCondition() : m_cond() { InitializeConditionVariable(&m_cond); }
+  void wait(GrabberMutex &mutex) { SleepConditionVariableCS(&m_cond, &mutex.m_mutex, INFINITE); }
+  void broadcast() { WakeAllConditionVariable(&m_cond); }
+  CONDITION_VARIABLE m_cond;
+#endif
+
+private:
+  GrabberCondition(const GrabberCondition &);
+  GrabberCondition &operator=(const GrabberCondition &);
+};
+#else
+// Without threads, nothing needs to be protected
+class GrabberMutex
+{
+public:
+  void lock() {}
+  void unlock() {}
+};
+#endif
+
+class GrabberLock
+{
+public:
+  explicit GrabberLock(GrabberMutex &mutex) : m_mutex(mutex) { m_mutex.lock(); }
+  ~GrabberLock() { m_mutex.unlock(); }
+
+private:
+  GrabberLock(const GrabberLock &);
+  GrabberLock &operator=(const GrabberLock &);
+  GrabberMutex &m_mutex;
+};
+
+// Exchange the pixels of two images, but not the display attached to them
+template <class Type> void swapPixels(vpImage<Type> &first, vpImage<Type> &second)
+{
+  vpDisplay *const firstDisplay = first.display, *const secondDisplay = second.display;
+  swap(first, second);
+  first.display = firstDisplay;
+  second.display = secondDisplay;
+}
+}
+
+/*
+  The state shared with the capture thread is only made of slot indexes:
+  a slot is either free, written by the capture thread, or queued. The
+  pixels are never copied, and the lock is only held to move indexes and to
+  swap image buffers, which are constant time operations.
+*/
+class vpFrameGrabberAsync::Impl
+{
+public:
+  Impl(vpFrameGrabber &grabber, unsigned int bufferSize, vpQueuePolicy policy)
+    : m_grabber(grabber), m_bufferSize(bufferSize), m_policy(policy), m_color(false), m_gray(bufferSize),
+      m_rgba(bufferSize), m_timestamps(bufferSize, 0.), m_free(), m_queue(bufferSize, 0), m_queueHead(0),
+      m_nbQueued(0), m_nbCaptured(0), m_nbDropped(0), m_running(false), m_error(NULL), m_mutex()
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+      ,
+      m_thread(), m_threadStarted(false), m_frameQueued(), m_slotFreed()
+#endif
+  {
+    m_free.reserve(bufferSize);
+  }
+
+  ~Impl()
+  {
+    stop();
+    delete m_error;
+  }
+
+  template <class Type> void open(vpImage<Type> &I, bool color)
+  {
+    stop();
+    m_grabber.open(I);
+
+    m_color = color;
+    m_free.clear();
+    for (unsigned int i = 0; i < m_bufferSize; i++) {
+      m_free.push_back(i);
+    }
+    m_queueHead = 0;
+    m_nbQueued = 0;
+    m_nbCaptured = 0;
+    m_nbDropped = 0;
+    delete m_error;
+    m_error = NULL;
+    m_running = true;
+
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+#if defined(VISP_HAVE_PTHREAD)
+    m_threadStarted = pthread_create(&m_thread, NULL, captureEntry, this) == 0;
+#else
+    m_thread = CreateThread(NULL, 0, captureEntry, this, 0, NULL);
+    m_threadStarted = m_thread != NULL;
+#endif
+    if (!m_threadStarted) {
+      m_running = false;
+      throw vpFrameGrabberException(vpFrameGrabberException::initializationError, "Cannot start the capture thread");
+    }
+#endif
+  }
+
+  template <class Type> void acquire(vpImage<Type> &I, double &timestamp, bool color)
+  {
+    if (color != m_color) {
+      throw vpFrameGrabberException(vpFrameGrabberException::settingError,
+                                    "The images are not of the type the grabber was opened with");
+    }
+
+#if !defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+    if (m_running) {
+      captureOne();
+    }
+#endif
+
+    GrabberLock lock(m_mutex);
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+    while (m_nbQueued == 0 && m_running) {
+      m_frameQueued.wait(m_mutex);
+    }
+#endif
+    if (m_nbQueued == 0) {
+      if (m_error != NULL) {
+        m_error->rethrow();
+      }
+      throw vpFrameGrabberException(vpFrameGrabberException::initializationError, "The grabber is not open");
+    }
+
+    if (m_policy == DROP_OLDEST) {
+      // Keep only the latest frame
+      while (m_nbQueued > 1) {
+        m_free.push_back(popQueued());
+        m_nbDropped++;
+      }
+    }
+    const unsigned int slot = popQueued();
+
+    swapPixels(I, buffer<Type>(slot));
+    timestamp = m_timestamps[slot];
+    m_free.push_back(slot);
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+    m_slotFreed.broadcast();
+#endif
+  }
+
+  void stop()
+  {
+    {
+      GrabberLock lock(m_mutex);
+      m_running = false;
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+      m_slotFreed.broadcast();
+#endif
+    }
+
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+    // The thread may have stopped by itself when the grabber has thrown
+    if (m_threadStarted) {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_join(m_thread, NULL);
+#else
+      WaitForSingleObject(m_thread, INFINITE);
+      CloseHandle(m_thread);
+#endif
+      m_threadStarted = false;
+    }
+#endif
+  }
+
+  vpFrameGrabber &m_grabber;
+  const unsigned int m_bufferSize;
+  const vpQueuePolicy m_policy;
+  //! True when opened with color images
+  bool m_color;
+  std::vector<vpImage<unsigned char> > m_gray;
+  std::vector<vpImage<vpRGBa> > m_rgba;
+  std::vector<double> m_timestamps;
+  //! Slots that can be written by the capture thread
+  std::vector<unsigned int> m_free;
+  //! Circular queue of the slots of the acquired frames, oldest first
+  std::vector<unsigned int> m_queue;
+  unsigned int m_queueHead;
+  unsigned int m_nbQueued;
+  unsigned int m_nbCaptured;
+  unsigned int m_nbDropped;
+  //! False once closed or once the grabber has thrown
+  bool m_running;
+  //! Copy of the exception thrown by the grabber, with its dynamic type
+  vpException *m_error;
+  mutable GrabberMutex m_mutex;
+
+private:
+  template <class Type> vpImage<Type> &buffer(unsigned int slot);
+
+  unsigned int popQueued()
+  {
+    const unsigned int slot = m_queue[m_queueHead];
+    m_queueHead = (m_queueHead + 1) % m_bufferSize;
+    m_nbQueued--;
+    return slot;
+  }
+
+  void pushQueued(unsigned int slot)
+  {
+    m_queue[(m_queueHead + m_nbQueued) % m_bufferSize] = slot;
+    m_nbQueued++;
+  }
+
+  // Acquire one frame in a free slot; return false when the capture stops
+  bool captureOne()
+  {
+    unsigned int slot = 0;
+    {
+      GrabberLock lock(m_mutex);
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+      while (m_running && m_free.empty() && m_policy == BLOCK) {
+        m_slotFreed.wait(m_mutex);
+      }
+#endif
+      if (!m_running) {
+        return false;
+      }
+      if (m_free.empty()) {
+        // Replace the oldest frame
+        slot = popQueued();
+        m_nbDropped++;
+      } else {
+        slot = m_free.back();
+        m_free.pop_back();
+      }
+    }
+
+    vpException *error = NULL;
+    try {
+      if (m_color) {
+        m_grabber.acquire(m_rgba[slot]);
+      } else {
+        m_grabber.acquire(m_gray[slot]);
+      }
+    } catch (const vpException &e) {
+      error = e.clone();
+    } catch (const std::exception &e) {
+      error = new vpException(vpException::fatalError, e.what());
+    } catch (...) {
+      error = new vpException(vpException::fatalError, "Unknown exception in the capture thread");
+    }
+    const bool failed = error != NULL;
+    const double timestamp = vpTime::measureTimeMs();
+
+    GrabberLock lock(m_mutex);
+    if (failed) {
+      m_free.push_back(slot);
+      m_error = error;
+      m_running = false;
+    } else {
+      m_timestamps[slot] = timestamp;
+      pushQueued(slot);
+      m_nbCaptured++;
+    }
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+    m_frameQueued.broadcast();
+#endif
+    return !failed;
+  }
+
+#if defined(VP_FRAME_GRABBER_ASYNC_HAVE_THREADS)
+  void captureLoop()
+  {
+    while (captureOne()) {
+    }
+  }
+
+#if defined(VISP_HAVE_PTHREAD)
+  static void *captureEntry(void *arg)
+  {
+    static_cast<Impl *>(arg)->captureLoop();
+    return NULL;
+  }
+  pthread_t m_thread;
+#else
+  static DWORD WINAPI captureEntry(LPVOID arg)
+  {
+    static_cast<Impl *>(arg)->captureLoop();
+    return 0;
+  }
+  HANDLE m_thread;
+#endif
+  bool m_threadStarted;
+
+  GrabberCondition m_frameQueued;
+  GrabberCondition m_slotFreed;
+#endif
+};
+
+template <> vpImage<unsigned char> &vpFrameGrabberAsync::Impl::buffer<unsigned char>(unsigned int slot)
+{
+  return m_gray[slot];
+}
+
+template <> vpImage<vpRGBa> &vpFrameGrabberAsync::Impl::buffer<vpRGBa>(unsigned int slot) { return m_rgba[slot]; }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Create an asynchronous frame grabber over \e grabber, that must outlive
+  this object.
+
+  \param grabber : Frame grabber whose images are acquired in a background
+  thread.
+  \param bufferSize : Number of preallocated image buffers, at least 2. At
+  most \e bufferSize - 1 frames are waiting to be acquired while the capture
+  thread writes the next one.
+  \param policy : Behavior when all the buffers are filled.
+
+  \exception vpFrameGrabberException::settingError : If \e bufferSize is
+  lower than 2.
+*/
+vpFrameGrabberAsync::vpFrameGrabberAsync(vpFrameGrabber &grabber, unsigned int bufferSize, vpQueuePolicy policy)
+  : vpFrameGrabber(), m_impl(NULL)
+{
+  if (bufferSize < 2) {
+    throw vpFrameGrabberException(vpFrameGrabberException::settingError, "The buffer size %u must be at least 2",
+                                  bufferSize);
+  }
+  m_impl = new Impl(grabber, bufferSize, policy);
+}
+
+/*!
+  Destructor. Stop the capture thread and close the wrapped grabber.
+*/
+vpFrameGrabberAsync::~vpFrameGrabberAsync()
+{
+  close();
+  delete m_impl;
+}
+
+/*!
+  Open the wrapped grabber, that initializes \e I with its first image as
+  vpFrameGrabber::open() does, and start the capture of gray level images.
+*/
+void vpFrameGrabberAsync::open(vpImage<unsigned char> &I)
+{
+  m_impl->open(I, false);
+  width = m_impl->m_grabber.getWidth();
+  height = m_impl->m_grabber.getHeight();
+  init = true;
+}
+
+/*!
+  Open the wrapped grabber, that initializes \e I with its first image as
+  vpFrameGrabber::open() does, and start the capture of color images.
+*/
+void vpFrameGrabberAsync::open(vpImage<vpRGBa> &I)
+{
+  m_impl->open(I, true);
+  width = m_impl->m_grabber.getWidth();
+  height = m_impl->m_grabber.getHeight();
+  init = true;
+}
+
+/*!
+  Wait for a new gray level image and return it in \e I.
+
+  \param I : Acquired image. Its previous buffer is recycled.
+  \param timestamp : Time in ms, as given by vpTime::measureTimeMs(), at
+  which the acquisition of the image by the wrapped grabber completed.
+
+  \exception vpFrameGrabberException::settingError : If the grabber was
+  opened with color images.
+*/
+void vpFrameGrabberAsync::acquire(vpImage<unsigned char> &I, double &timestamp) { m_impl->acquire(I, timestamp, false); }
+
+/*!
+  Wait for a new color image and return it in \e I.
+
+  \param I : Acquired image. Its previous buffer is recycled.
+  \param timestamp : Time in ms, as given by vpTime::measureTimeMs(), at
+  which the acquisition of the image by the wrapped grabber completed.
+
+  \exception vpFrameGrabberException::settingError : If the grabber was
+  opened with gray level images.
+*/
+void vpFrameGrabberAsync::acquire(vpImage<vpRGBa> &I, double &timestamp) { m_impl->acquire(I, timestamp, true); }
+
+/*!
+  Wait for a new gray level image and return it in \e I.
+*/
+void vpFrameGrabberAsync::acquire(vpImage<unsigned char> &I)
+{
+  double timestamp;
+  acquire(I, timestamp);
+}
+
+/*!
+  Wait for a new color image and return it in \e I.
+*/
+void vpFrameGrabberAsync::acquire(vpImage<vpRGBa> &I)
+{
+  double timestamp;
+  acquire(I, timestamp);
+}
+
+/*!
+  Stop the capture thread and close the wrapped grabber. The frames that
+  were not acquired are discarded.
+*/
+void vpFrameGrabberAsync::close()
+{
+  if (init) {
+    m_impl->stop();
+    m_impl->m_grabber.close();
+    init = false;
+  }
+}
+
+/*!
+  Return the number of image buffers.
+*/
+unsigned int vpFrameGrabberAsync::getBufferSize() const { return m_impl->m_bufferSize; }
+
+/*!
+  Return the number of frames acquired by the wrapped grabber since open().
+*/
+unsigned int vpFrameGrabberAsync::getNbCapturedFrames() const
+{
+  GrabberLock lock(m_impl->m_mutex);
+  return m_impl->m_nbCaptured;
+}
+
+/*!
+  Return the number of frames dropped since open(), either replaced by the
+  capture thread or skipped by acquire() with the DROP_OLDEST policy.
+*/
+unsigned int vpFrameGrabberAsync::getNbDroppedFrames() const
+{
+  GrabberLock lock(m_impl->m_mutex);
+  return m_impl->m_nbDropped;
+}
+
+/*!
+  Return the number of frames that are waiting to be acquired.
+*/
+unsigned int vpFrameGrabberAsync::getNbQueuedFrames() const
+{
+  GrabberLock lock(m_impl->m_mutex);
+  return m_impl->m_nbQueued;
+}
+
+/*!
+  Return the policy applied when all the buffers are filled.
+*/
+vpFrameGrabberAsync::vpQueuePolicy vpFrameGrabberAsync::getQueuePolicy() const { return m_impl->m_policy; }
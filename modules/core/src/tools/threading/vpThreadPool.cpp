@@ -0,0 +1,651 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pool of persistent worker threads.
+ *
+ *****************************************************************************/
+
+#include <deque>
+#include <vector>
+
+#include <visp3/core/vpThreadPool.h>
+
+#if defined(VISP_HAVE_PTHREAD)
+#include <pthread.h>
+#include <unistd.h>
+#define VP_THREAD_POOL_HAVE_THREADS 1
+#elif defined(_WIN32) && !defined(WINRT_8_0)
+// Include WinSock2.h before windows.h to ensure that winsock.h is not
+// included by windows.h since winsock.h and winsock2.h are incompatible
+#include <WinSock2.h>
+#include <windows.h>
+#define VP_THREAD_POOL_HAVE_THREADS 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+// Minimal mutex, condition variable and thread local storage wrappers.
+// vpMutex relies on Windows mutex handles that cannot be used with
+// condition variables, that's why they are not used here.
+class PoolMutex
+{
+public:
+#if defined(VISP_HAVE_PTHREAD)
+  PoolMutex() : m_mutex() { pthread_mutex_init(&m_mutex, NULL); }
+  ~PoolMutex() { pthread_mutex_destroy(&m_mutex); }
+  void lock() { pthread_mutex_lock(&m_mutex); }
+  void unlock() { pthread_mutex_unlock(&m_mutex); }
+  pthread_mutex_t m_mutex;
+#else
+  PoolMutex() : m_mutex() { InitializeCriticalSection(&m_mutex); }
+  ~PoolMutex() { DeleteCriticalSection(&m_mutex); }
+  void lock() { EnterCriticalSection(&m_mutex); }
+  void unlock() { LeaveCriticalSection(&m_mutex); }
+  CRITICAL_SECTION m_mutex;
+#endif
+
+private:
+  PoolMutex(const PoolMutex &);
+  PoolMutex &operator=(const PoolMutex &);
+};
+
+class PoolLock
+{
+public:
+  explicit PoolLock(PoolMutex &mutex) : m_mutex(mutex) { m_mutex.lock(); }
+  ~PoolLock() { m_mutex.unlock(); }
+
+private:
+  PoolLock(const PoolLock &);
+  PoolLock &operator=(const PoolLock &);
+  PoolMutex &m_mutex;
+};
+
+class PoolCondition
+{
+public:
+#if defined(VISP_HAVE_PTHREAD)
+  PoolCondition() : m_cond() { pthread_cond_init(&m_cond, NULL); }
+  ~PoolCondition() { pthread_cond_destroy(&m_cond); }
+  void wait(PoolMutex &mutex) { pthread_cond_wait(&m_cond, &mutex.m_mutex); }
+  void signal() { pthread_cond_signal(&m_cond); }
+  void broadcast() { pthread_cond_broadcast(&m_cond); }
+  pthread_cond_t m_cond;
+#else
+  PoolCondition() : m_cond() { InitializeConditionVariable(&m_cond); }
+  void wait(PoolMutex &mutex) { SleepConditionVariableCS(&m_cond, &mutex.m_mutex, INFINITE); }
+  void signal() { WakeConditionVariable(&m_cond); }
+  void broadcast() { WakeAllConditionVariable(&m_cond); }
+  CONDITION_VARIABLE m_cond;
+#endif
+
+private:
+  PoolCondition(const PoolCondition &);
+  PoolCondition &operator=(const PoolCondition &);
+};
+
+class PoolThreadLocal
+{
+public:
+#if defined(VISP_HAVE_PTHREAD)
+  PoolThreadLocal() : m_key() { pthread_key_create(&m_key, NULL); }
+  ~PoolThreadLocal() { pthread_key_delete(m_key); }
+  void set(void *value) { pthread_setspecific(m_key, value); }
+  void *get() const { return pthread_getspecific(m_key); }
+  pthread_key_t m_key;
+#else
+  PoolThreadLocal() : m_index(TlsAlloc()) {}
+  ~PoolThreadLocal() { TlsFree(m_index); }
+  void set(void *value) { TlsSetValue(m_index, value); }
+  void *get() const { return TlsGetValue(m_index); }
+  DWORD m_index;
+#endif
+
+private:
+  PoolThreadLocal(const PoolThreadLocal &);
+  PoolThreadLocal &operator=(const PoolThreadLocal &);
+};
+#endif
+
+// Task executing a chunk of a parallel loop
+class LoopChunkTask : public vpThreadPool::vpTask
+{
+public:
+  LoopChunkTask() : m_body(NULL), m_begin(0), m_end(0) {}
+  void run() { (*m_body)(m_begin, m_end); }
+
+  const vpThreadPool::vpParallelLoopBody *m_body;
+  unsigned int m_begin;
+  unsigned int m_end;
+};
+}
+
+class vpThreadPool::Impl
+{
+public:
+  Impl() : m_nbWorkers(0)
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+    , m_workers(), m_queues(), m_contexts(), m_stateMutex(), m_workAvailable(), m_taskDone(), m_workerContext(),
+      m_nbQueued(0), m_nbWaiting(0), m_nextQueue(0), m_stop(false)
+#endif
+  {
+  }
+
+  ~Impl() { stop(); }
+
+  struct Item {
+    Item() : task(NULL), group(NULL) {}
+    Item(vpTask *t, vpTaskGroup *g) : task(t), group(g) {}
+    vpTask *task;
+    vpTaskGroup *group;
+  };
+
+  // Run the task and return a copy of the exception it has thrown, NULL on
+  // success. The copy keeps the dynamic type of vpException derivates.
+  static vpException *execute(const Item &item)
+  {
+    try {
+      item.task->run();
+    } catch (const vpException &e) {
+      return e.clone();
+    } catch (const std::exception &e) {
+      return new vpException(vpException::fatalError, e.what());
+    } catch (...) {
+      return new vpException(vpException::fatalError, "Unknown exception thrown by a task");
+    }
+    return NULL;
+  }
+
+  // Keep the first exception of the group, the next ones are dropped
+  static void setFailure(vpTaskGroup &group, vpException *error)
+  {
+    if (!group.m_failed) {
+      group.m_failed = true;
+      group.m_exception = error;
+    } else {
+      delete error;
+    }
+  }
+
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  struct Queue {
+    PoolMutex mutex;
+    std::deque<Item> items;
+  };
+
+  struct WorkerContext {
+    Impl *impl;
+    unsigned int index;
+  };
+
+#if defined(VISP_HAVE_PTHREAD)
+  typedef pthread_t Handle;
+  static void *workerEntry(void *arg)
+  {
+    WorkerContext *ctx = static_cast<WorkerContext *>(arg);
+    ctx->impl->workerLoop(ctx);
+    return NULL;
+  }
+#else
+  typedef HANDLE Handle;
+  static DWORD WINAPI workerEntry(LPVOID arg)
+  {
+    WorkerContext *ctx = static_cast<WorkerContext *>(arg);
+    ctx->impl->workerLoop(ctx);
+    return 0;
+  }
+#endif
+
+  void start(unsigned int nbWorkers)
+  {
+    m_stop = false;
+    m_nbQueued = 0;
+    m_queues.resize(nbWorkers);
+    m_contexts.resize(nbWorkers);
+    m_workers.reserve(nbWorkers);
+    for (unsigned int i = 0; i < nbWorkers; i++) {
+      m_queues[i] = new Queue;
+      m_contexts[i].impl = this;
+      m_contexts[i].index = i;
+    }
+
+    for (unsigned int i = 0; i < nbWorkers; i++) {
+      Handle handle;
+#if defined(VISP_HAVE_PTHREAD)
+      if (pthread_create(&handle, NULL, workerEntry, &m_contexts[i]) != 0) {
+        break;
+      }
+#else
+      handle = CreateThread(NULL, 0, workerEntry, &m_contexts[i], 0, NULL);
+      if (handle == NULL) {
+        break;
+      }
+#endif
+      m_workers.push_back(handle);
+    }
+    m_nbWorkers = (unsigned int)m_workers.size();
+  }
+
+  void stop()
+  {
+    {
+      PoolLock lock(m_stateMutex);
+      m_stop = true;
+      m_workAvailable.broadcast();
+    }
+
+    for (size_t i = 0; i < m_workers.size(); i++) {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_join(m_workers[i], NULL);
+#else
+      WaitForSingleObject(m_workers[i], INFINITE);
+      CloseHandle(m_workers[i]);
+#endif
+    }
+
+    // Tasks left by workers that failed to start are run by the caller
+    for (size_t i = 0; i < m_queues.size(); i++) {
+      while (!m_queues[i]->items.empty()) {
+        Item item = m_queues[i]->items.front();
+        m_queues[i]->items.pop_front();
+        vpException *error = execute(item);
+        if (error != NULL) {
+          setFailure(*item.group, error);
+        }
+        item.group->m_pending--;
+      }
+      delete m_queues[i];
+    }
+
+    m_workers.clear();
+    m_queues.clear();
+    m_contexts.clear();
+    m_nbWorkers = 0;
+  }
+
+  const WorkerContext *currentContext() const
+  {
+    const WorkerContext *ctx = static_cast<const WorkerContext *>(m_workerContext.get());
+    return (ctx != NULL && ctx->impl == this) ? ctx : NULL;
+  }
+
+  void push(const Item &item)
+  {
+    unsigned int index;
+    const WorkerContext *ctx = currentContext();
+    if (ctx != NULL) {
+      index = ctx->index;
+    } else {
+      PoolLock lock(m_stateMutex);
+      index = m_nextQueue;
+      m_nextQueue = (m_nextQueue + 1) % m_nbWorkers;
+    }
+
+    // Count the task before it becomes visible to pop(), so that m_nbQueued
+    // never underflows. The state mutex is taken first, pop() never holds a
+    // queue mutex while locking it.
+    PoolLock lock(m_stateMutex);
+    m_nbQueued++;
+    {
+      PoolLock queueLock(m_queues[index]->mutex);
+      m_queues[index]->items.push_back(item);
+    }
+    m_workAvailable.signal();
+    if (m_nbWaiting > 0) {
+      // Threads waiting for a group can help with the new task
+      m_taskDone.broadcast();
+    }
+  }
+
+  // Pop from the back of the own queue, or steal from the front of the others
+  bool pop(const WorkerContext *ctx, Item &item)
+  {
+    const unsigned int nbQueues = (unsigned int)m_queues.size();
+    unsigned int first = 0;
+    bool found = false;
+    if (ctx != NULL) {
+      Queue &own = *m_queues[ctx->index];
+      PoolLock lock(own.mutex);
+      if (!own.items.empty()) {
+        item = own.items.back();
+        own.items.pop_back();
+        found = true;
+      }
+      first = ctx->index + 1;
+    }
+
+    for (unsigned int k = 0; k < nbQueues && !found; k++) {
+      Queue &other = *m_queues[(first + k) % nbQueues];
+      PoolLock lock(other.mutex);
+      if (!other.items.empty()) {
+        item = other.items.front();
+        other.items.pop_front();
+        found = true;
+      }
+    }
+
+    if (found) {
+      PoolLock lock(m_stateMutex);
+      m_nbQueued--;
+    }
+    return found;
+  }
+
+  void complete(const Item &item)
+  {
+    vpException *error = execute(item);
+
+    PoolLock lock(m_stateMutex);
+    if (error != NULL) {
+      setFailure(*item.group, error);
+    }
+    item.group->m_pending--;
+    if (item.group->m_pending == 0) {
+      m_taskDone.broadcast();
+    }
+  }
+
+  void workerLoop(WorkerContext *ctx)
+  {
+    m_workerContext.set(ctx);
+    for (;;) {
+      Item item;
+      if (pop(ctx, item)) {
+        complete(item);
+        continue;
+      }
+
+      PoolLock lock(m_stateMutex);
+      while (!m_stop && m_nbQueued == 0) {
+        m_workAvailable.wait(m_stateMutex);
+      }
+      if (m_stop && m_nbQueued == 0) {
+        break;
+      }
+    }
+    m_workerContext.set(NULL);
+  }
+
+  void wait(vpTaskGroup &group)
+  {
+    const WorkerContext *ctx = currentContext();
+    for (;;) {
+      {
+        PoolLock lock(m_stateMutex);
+        if (group.m_pending == 0) {
+          return;
+        }
+      }
+
+      Item item;
+      if (pop(ctx, item)) {
+        complete(item);
+        continue;
+      }
+
+      PoolLock lock(m_stateMutex);
+      m_nbWaiting++;
+      while (group.m_pending > 0 && m_nbQueued == 0) {
+        m_taskDone.wait(m_stateMutex);
+      }
+      m_nbWaiting--;
+    }
+  }
+#endif
+
+  unsigned int m_nbWorkers;
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  std::vector<Handle> m_workers;
+  std::vector<Queue *> m_queues;
+  std::vector<WorkerContext> m_contexts;
+  PoolMutex m_stateMutex;
+  PoolCondition m_workAvailable;
+  PoolCondition m_taskDone;
+  PoolThreadLocal m_workerContext;
+  unsigned int m_nbQueued;
+  unsigned int m_nbWaiting;
+  unsigned int m_nextQueue;
+  bool m_stop;
+#else
+  void stop() {}
+#endif
+
+private:
+  Impl(const Impl &);
+  Impl &operator=(const Impl &);
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Create a task group attached to \e pool.
+*/
+vpThreadPool::vpTaskGroup::vpTaskGroup(vpThreadPool &pool)
+  : m_pool(pool), m_pending(0), m_failed(false), m_exception(NULL)
+{
+}
+
+/*!
+  Wait for the completion of the tasks of the group. Exceptions thrown by
+  the tasks are discarded.
+*/
+vpThreadPool::vpTaskGroup::~vpTaskGroup()
+{
+  try {
+    wait();
+  } catch (...) {
+  }
+  delete m_exception;
+}
+
+/*!
+  Submit \e task to the pool. If the pool has no worker thread, the task is
+  executed immediately by the calling thread.
+
+  \param task : Task to execute. It is not copied and must remain valid until
+  wait() returns.
+*/
+void vpThreadPool::vpTaskGroup::run(vpTask &task)
+{
+  vpThreadPool::Impl *impl = m_pool.m_impl;
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  if (impl->m_nbWorkers > 0) {
+    {
+      PoolLock lock(impl->m_stateMutex);
+      m_pending++;
+    }
+    impl->push(vpThreadPool::Impl::Item(&task, this));
+    return;
+  }
+#endif
+  vpException *error = impl->execute(vpThreadPool::Impl::Item(&task, this));
+  if (error != NULL) {
+    vpThreadPool::Impl::setFailure(*this, error);
+  }
+}
+
+/*!
+  Wait for the completion of all the tasks submitted to the group. While
+  waiting, the calling thread executes pending tasks of the pool.
+
+  \exception vpException : Copy of the first exception thrown by a task of
+  the group. Exceptions derived from vpException keep their type, so that a
+  vpTrackingException thrown by a task can be caught as such. Other
+  exceptions are rethrown as a vpException::fatalError.
+*/
+void vpThreadPool::vpTaskGroup::wait()
+{
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  m_pool.m_impl->wait(*this);
+#endif
+  if (m_failed) {
+    vpException *error = m_exception;
+    m_exception = NULL;
+    m_failed = false;
+    try {
+      error->rethrow();
+    } catch (...) {
+      delete error;
+      throw;
+    }
+  }
+}
+
+/*!
+  Create a pool. Most of the time, the shared instance returned by
+  getInstance() should be used instead.
+
+  \param nbThreads : Number of threads that execute the tasks, the calling
+  thread included. When 0, one thread per logical core is used.
+
+  \sa setNumberOfThreads()
+*/
+vpThreadPool::vpThreadPool(unsigned int nbThreads) : m_impl(new Impl) { setNumberOfThreads(nbThreads); }
+
+/*!
+  Destructor. Pending tasks are completed before the worker threads are
+  joined.
+*/
+vpThreadPool::~vpThreadPool() { delete m_impl; }
+
+/*!
+  Return the pool shared by the whole process. It is created on first use.
+*/
+vpThreadPool &vpThreadPool::getInstance()
+{
+  static vpThreadPool pool;
+  return pool;
+}
+
+/*!
+  Return the number of logical cores of the machine, or 1 when it cannot be
+  determined.
+*/
+unsigned int vpThreadPool::getNumberOfCPUs()
+{
+  long nb = 1;
+#if defined(VISP_HAVE_PTHREAD) && defined(_SC_NPROCESSORS_ONLN)
+  nb = sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined(_WIN32) && !defined(WINRT_8_0)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  nb = (long)info.dwNumberOfProcessors;
+#endif
+  return nb > 0 ? (unsigned int)nb : 1;
+}
+
+/*!
+  Return the number of threads that execute the tasks, the thread waiting
+  for the tasks included.
+*/
+unsigned int vpThreadPool::getNumberOfThreads() const { return m_impl->m_nbWorkers + 1; }
+
+/*!
+  Return true if the calling thread is one of the workers of the pool.
+*/
+bool vpThreadPool::isWorkerThread() const
+{
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  return m_impl->currentContext() != NULL;
+#else
+  return false;
+#endif
+}
+
+/*!
+  Execute \e body over the range [\e begin, \e end) split in contiguous
+  chunks, and wait for its completion. The calling thread processes chunks
+  too.
+
+  \param begin, end : Range of indexes.
+  \param body : Loop body called once per chunk.
+  \param nbChunks : Number of chunks. When 0, four chunks per thread are used
+  to balance the load. The value is bounded by the number of indexes.
+*/
+void vpThreadPool::parallelFor(unsigned int begin, unsigned int end, const vpParallelLoopBody &body,
+                               unsigned int nbChunks)
+{
+  if (end <= begin) {
+    return;
+  }
+
+  const unsigned int size = end - begin;
+  if (nbChunks == 0) {
+    nbChunks = 4 * getNumberOfThreads();
+  }
+  if (nbChunks > size) {
+    nbChunks = size;
+  }
+  if (nbChunks == 1 || m_impl->m_nbWorkers == 0) {
+    body(begin, end);
+    return;
+  }
+
+  std::vector<LoopChunkTask> chunks(nbChunks);
+  const unsigned int step = size / nbChunks;
+  const unsigned int remainder = size % nbChunks;
+  unsigned int first = begin;
+  for (unsigned int i = 0; i < nbChunks; i++) {
+    chunks[i].m_body = &body;
+    chunks[i].m_begin = first;
+    first += step + (i < remainder ? 1 : 0);
+    chunks[i].m_end = first;
+  }
+
+  vpTaskGroup group(*this);
+  for (unsigned int i = 1; i < nbChunks; i++) {
+    group.run(chunks[i]);
+  }
+  chunks[0].run();
+  group.wait();
+}
+
+/*!
+  Change the number of threads that execute the tasks. The pending tasks are
+  completed and the workers restarted. Must not be called while tasks are
+  running.
+
+  \param nbThreads : Number of threads, the calling thread included. When 0,
+  one thread per logical core is used. When 1, the tasks are executed by the
+  calling thread.
+*/
+void vpThreadPool::setNumberOfThreads(unsigned int nbThreads)
+{
+  if (nbThreads == 0) {
+    nbThreads = getNumberOfCPUs();
+  }
+
+  m_impl->stop();
+#if defined(VP_THREAD_POOL_HAVE_THREADS)
+  m_impl->start(nbThreads - 1);
+#endif
+}
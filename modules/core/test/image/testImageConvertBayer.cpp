@@ -0,0 +1,308 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test Bayer demosaicing and 4:2:0 (I420, YV12, NV12, NV21) conversions.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testImageConvertBayer.cpp
+
+  \brief Test Bayer demosaicing and 4:2:0 (I420, YV12, NV12, NV21)
+  conversions against per-pixel references.
+
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpThreadPool.h>
+
+namespace
+{
+const char *patternNames[4] = {"BGGR", "GBRG", "GRBG", "RGGB"};
+
+// Color (0: R, 1: G, 2: B) of pixel (i, j) of the color filter array
+int cfaColor(vpImageConvert::vpBayerPattern pattern, int i, int j)
+{
+  const char c = patternNames[pattern][2 * (i & 1) + (j & 1)];
+  return c == 'R' ? 0 : (c == 'G' ? 1 : 2);
+}
+
+int at(const std::vector<unsigned char> &bayer, int w, int h, int i, int j)
+{
+  i = i < 0 ? -i : (i >= h ? 2 * h - 2 - i : i);
+  j = j < 0 ? -j : (j >= w ? 2 * w - 2 - j : j);
+  return bayer[i * w + j];
+}
+
+int avg(int a, int b) { return (a + b + 1) >> 1; }
+
+int clamp(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+// Per-pixel bilinear and Malvar-He-Cutler demosaicing
+void demosaicReference(const std::vector<unsigned char> &bayer, int w, int h, vpImageConvert::vpBayerPattern pattern,
+                       bool malvar, std::vector<unsigned char> &rgba)
+{
+  rgba.resize(4 * w * h);
+  for (int i = 0; i < h; i++) {
+    for (int j = 0; j < w; j++) {
+      const int color = cfaColor(pattern, i, j);
+      int rgb[3];
+      const int c = at(bayer, w, h, i, j);
+      rgb[color] = c;
+      if (!malvar) {
+        const int hor = avg(at(bayer, w, h, i, j - 1), at(bayer, w, h, i, j + 1));
+        const int ver = avg(at(bayer, w, h, i - 1, j), at(bayer, w, h, i + 1, j));
+        const int diag = avg(avg(at(bayer, w, h, i - 1, j - 1), at(bayer, w, h, i - 1, j + 1)),
+                             avg(at(bayer, w, h, i + 1, j - 1), at(bayer, w, h, i + 1, j + 1)));
+        if (color != 1) {
+          rgb[1] = avg(hor, ver);
+          rgb[2 - color] = diag;
+        } else {
+          // Color of the horizontal neighbors
+          const int hc = cfaColor(pattern, i, j + 1);
+          rgb[hc] = hor;
+          rgb[2 - hc] = ver;
+        }
+      } else {
+        int n[5][5];
+        for (int di = -2; di <= 2; di++)
+          for (int dj = -2; dj <= 2; dj++)
+            n[di + 2][dj + 2] = at(bayer, w, h, i + di, j + dj);
+        const int cross = n[1][2] + n[3][2] + n[2][1] + n[2][3];
+        const int far = n[0][2] + n[4][2] + n[2][0] + n[2][4];
+        const int diag = n[1][1] + n[1][3] + n[3][1] + n[3][3];
+        if (color != 1) {
+          rgb[1] = clamp((8 * c + 4 * cross - 2 * far + 8) >> 4);
+          rgb[2 - color] = clamp((12 * c + 4 * diag - 3 * far + 8) >> 4);
+        } else {
+          const int hc = cfaColor(pattern, i, j + 1);
+          rgb[hc] = clamp(
+              (10 * c + 8 * (n[2][1] + n[2][3]) - 2 * (n[2][0] + n[2][4]) - 2 * diag + n[0][2] + n[4][2] + 8) >> 4);
+          rgb[2 - hc] = clamp(
+              (10 * c + 8 * (n[1][2] + n[3][2]) - 2 * (n[0][2] + n[4][2]) - 2 * diag + n[2][0] + n[2][4] + 8) >> 4);
+        }
+      }
+      for (int k = 0; k < 3; k++)
+        rgba[4 * (i * w + j) + k] = (unsigned char)rgb[k];
+      rgba[4 * (i * w + j) + 3] = vpRGBa::alpha_default;
+    }
+  }
+}
+
+unsigned char grey(int r, int g, int b) { return (unsigned char)((54 * r + 183 * g + 19 * b + 128) >> 8); }
+
+// Per-pixel 4:2:0 conversion, as done by the original YUV420ToRGBa()
+void yuv420Reference(const std::vector<unsigned char> &y, const std::vector<unsigned char> &u,
+                     const std::vector<unsigned char> &v, int w, int h, std::vector<unsigned char> &rgba)
+{
+  rgba.resize(4 * w * h);
+  for (int i = 0; i < h; i++) {
+    for (int j = 0; j < w; j++) {
+      const int U = (int)((u[(i / 2) * (w / 2) + j / 2] - 128) * 0.354);
+      const int V = (int)((v[(i / 2) * (w / 2) + j / 2] - 128) * 0.707);
+      const int Y = y[i * w + j];
+      rgba[4 * (i * w + j)] = (unsigned char)clamp(Y + 2 * V);
+      rgba[4 * (i * w + j) + 1] = (unsigned char)clamp(Y - U - V);
+      rgba[4 * (i * w + j) + 2] = (unsigned char)clamp(Y + 5 * U);
+      rgba[4 * (i * w + j) + 3] = vpRGBa::alpha_default;
+    }
+  }
+}
+
+bool isEqual(const std::vector<unsigned char> &a, const std::vector<unsigned char> &b, const std::string &name)
+{
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i] != b[i]) {
+      std::cerr << name << ": " << (int)a[i] << " != " << (int)b[i] << " at byte " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testBayer(int w, int h)
+{
+  std::vector<unsigned char> bayer(w * h), rgba(4 * w * h), ref, g(w * h), gh((w / 2) * (h / 2));
+  for (size_t i = 0; i < bayer.size(); i++)
+    bayer[i] = (unsigned char)(rand() % 256);
+
+  for (int p = 0; p < 4; p++) {
+    const vpImageConvert::vpBayerPattern pattern = (vpImageConvert::vpBayerPattern)p;
+    const std::string name = std::string(patternNames[p]) + " " + (w > 20 ? "large" : "small");
+
+    demosaicReference(bayer, w, h, pattern, false, ref);
+    vpImageConvert::BayerToRGBa(&bayer[0], &rgba[0], w, h, pattern, vpImageConvert::BAYER_BILINEAR);
+    if (!isEqual(rgba, ref, "BayerToRGBa bilinear " + name))
+      return false;
+
+    std::vector<unsigned char> gref(w * h);
+    for (int i = 0; i < w * h; i++)
+      gref[i] = grey(ref[4 * i], ref[4 * i + 1], ref[4 * i + 2]);
+    vpImageConvert::BayerToGrey(&bayer[0], &g[0], w, h, pattern);
+    if (!isEqual(g, gref, "BayerToGrey " + name))
+      return false;
+
+    demosaicReference(bayer, w, h, pattern, true, ref);
+    vpImageConvert::BayerToRGBa(&bayer[0], &rgba[0], w, h, pattern, vpImageConvert::BAYER_MALVAR);
+    if (!isEqual(rgba, ref, "BayerToRGBa Malvar " + name))
+      return false;
+
+    std::vector<unsigned char> ghref(gh.size());
+    for (int i = 0; i < h / 2; i++) {
+      for (int j = 0; j < w / 2; j++) {
+        int rgb[3] = {0, 0, 0}, green[2], nGreen = 0;
+        for (int k = 0; k < 4; k++) {
+          const int c = cfaColor(pattern, k / 2, k % 2);
+          const int val = bayer[(2 * i + k / 2) * w + 2 * j + k % 2];
+          if (c == 1)
+            green[nGreen++] = val;
+          else
+            rgb[c] = val;
+        }
+        ghref[i * (w / 2) + j] = grey(rgb[0], avg(green[0], green[1]), rgb[2]);
+      }
+    }
+    vpImageConvert::BayerToGreyHalf(&bayer[0], &gh[0], w, h, pattern);
+    if (!isEqual(gh, ghref, "BayerToGreyHalf " + name))
+      return false;
+  }
+
+  // A uniform scene must be recovered exactly by both methods, borders
+  // included
+  const int color[3] = {200, 90, 30};
+  for (int p = 0; p < 4; p++) {
+    const vpImageConvert::vpBayerPattern pattern = (vpImageConvert::vpBayerPattern)p;
+    for (int i = 0; i < h; i++)
+      for (int j = 0; j < w; j++)
+        bayer[i * w + j] = (unsigned char)color[cfaColor(pattern, i, j)];
+    for (int m = 0; m < 2; m++) {
+      vpImageConvert::BayerToRGBa(&bayer[0], &rgba[0], w, h, pattern, (vpImageConvert::vpBayerDemosaicMethod)m);
+      for (int i = 0; i < w * h; i++) {
+        if (rgba[4 * i] != color[0] || rgba[4 * i + 1] != color[1] || rgba[4 * i + 2] != color[2]) {
+          std::cerr << "Uniform scene " << patternNames[p] << ": bad color at pixel " << i << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool testYUV420(int w, int h)
+{
+  const int size = w * h, csize = (w / 2) * (h / 2);
+  std::vector<unsigned char> y(size), u(csize), v(csize);
+  for (int i = 0; i < size; i++)
+    y[i] = (unsigned char)(rand() % 256);
+  for (int i = 0; i < csize; i++) {
+    u[i] = (unsigned char)(rand() % 256);
+    v[i] = (unsigned char)(rand() % 256);
+  }
+  std::vector<unsigned char> ref, rgba(4 * size), rgb(3 * size), grey(size);
+  yuv420Reference(y, u, v, w, h, ref);
+  std::vector<unsigned char> refRGB(3 * size);
+  for (int i = 0; i < size; i++)
+    for (int k = 0; k < 3; k++)
+      refRGB[3 * i + k] = ref[4 * i + k];
+
+  // Planar layouts
+  std::vector<unsigned char> i420(y), yv12(y);
+  i420.insert(i420.end(), u.begin(), u.end());
+  i420.insert(i420.end(), v.begin(), v.end());
+  yv12.insert(yv12.end(), v.begin(), v.end());
+  yv12.insert(yv12.end(), u.begin(), u.end());
+  vpImageConvert::YUV420ToRGBa(&i420[0], &rgba[0], w, h);
+  if (!isEqual(rgba, ref, "YUV420ToRGBa"))
+    return false;
+  vpImageConvert::YUV420ToRGB(&i420[0], &rgb[0], w, h);
+  if (!isEqual(rgb, refRGB, "YUV420ToRGB"))
+    return false;
+  vpImageConvert::YV12ToRGBa(&yv12[0], &rgba[0], w, h);
+  if (!isEqual(rgba, ref, "YV12ToRGBa"))
+    return false;
+
+  // Semi-planar layouts
+  std::vector<unsigned char> nv12(y), nv21(y);
+  for (int i = 0; i < csize; i++) {
+    nv12.push_back(u[i]);
+    nv12.push_back(v[i]);
+    nv21.push_back(v[i]);
+    nv21.push_back(u[i]);
+  }
+  vpImageConvert::NV12ToRGBa(&nv12[0], &rgba[0], w, h);
+  if (!isEqual(rgba, ref, "NV12ToRGBa"))
+    return false;
+  vpImageConvert::NV12ToRGB(&nv12[0], &rgb[0], w, h);
+  if (!isEqual(rgb, refRGB, "NV12ToRGB"))
+    return false;
+  vpImageConvert::NV21ToRGBa(&nv21[0], &rgba[0], w, h);
+  if (!isEqual(rgba, ref, "NV21ToRGBa"))
+    return false;
+  vpImageConvert::NV21ToRGB(&nv21[0], &rgb[0], w, h);
+  if (!isEqual(rgb, refRGB, "NV21ToRGB"))
+    return false;
+  vpImageConvert::NV12ToGrey(&nv12[0], &grey[0], w, h);
+  if (!isEqual(grey, y, "NV12ToGrey"))
+    return false;
+  vpImageConvert::NV21ToGrey(&nv21[0], &grey[0], w, h);
+  if (!isEqual(grey, y, "NV21ToGrey"))
+    return false;
+  return true;
+}
+}
+
+int main()
+{
+  srand(0);
+  // Sizes that exercise the vectorized chunks, the scalar tails and the
+  // mirrored borders
+  if (!testBayer(77, 41) || !testBayer(8, 6) || !testBayer(3, 3)) {
+    return EXIT_FAILURE;
+  }
+  // Rows demosaiced concurrently
+  vpThreadPool::getInstance().setNumberOfThreads(4);
+  if (!testBayer(77, 41)) {
+    return EXIT_FAILURE;
+  }
+  if (!testYUV420(70, 38) || !testYUV420(64, 48)) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testImageConvertBayer is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
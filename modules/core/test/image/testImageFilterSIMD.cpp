@@ -0,0 +1,241 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the vectorized separable filters and their float and fixed-point
+ * variants.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testImageFilterSIMD.cpp
+
+  \brief Test the vectorized separable filters and their float and
+  fixed-point variants against the per-pixel filters.
+
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpImageFilter.h>
+
+namespace
+{
+template <typename T1, typename T2>
+bool isNear(const vpImage<T1> &I1, const vpImage<T2> &I2, double tolerance, const std::string &name)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    std::cerr << name << ": bad size" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < I1.getHeight(); i++) {
+    for (unsigned int j = 0; j < I1.getWidth(); j++) {
+      if (std::fabs((double)I1[i][j] - (double)I2[i][j]) > tolerance) {
+        std::cerr << name << ": " << (double)I1[i][j] << " != " << (double)I2[i][j] << " at (" << i << ", " << j
+                  << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Reference filters computed with the per-pixel functions
+template <typename T>
+void filterXReference(const vpImage<T> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  unsigned int half = (size - 1) / 2;
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (j < half)
+        dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+      else if (j >= I.getWidth() - half)
+        dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+      else
+        dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+    }
+  }
+}
+
+void filterYReference(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  unsigned int half = (size - 1) / 2;
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (i < half)
+        dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+      else if (i >= I.getHeight() - half)
+        dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+      else
+        dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+    }
+  }
+}
+
+template <typename T>
+void gradReference(const vpImage<T> &I, vpImage<double> &dIx, vpImage<double> &dIy, const double *filter,
+                   unsigned int size)
+{
+  unsigned int half = (size - 1) / 2;
+  dIx.resize(I.getHeight(), I.getWidth(), 0.);
+  dIy.resize(I.getHeight(), I.getWidth(), 0.);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (j >= half && j < I.getWidth() - half)
+        dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
+      if (i >= half && i < I.getHeight() - half)
+        dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
+    }
+  }
+}
+}
+
+int main()
+{
+  // Odd sizes to exercise the scalar tails of the vectorized loops
+  vpImage<unsigned char> I(61, 83);
+  srand(0);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)(rand() % 256);
+  }
+
+  for (unsigned int size = 3; size <= 11; size += 2) {
+    std::vector<double> fg((size + 1) / 2), fd((size + 1) / 2);
+    std::vector<float> fgf((size + 1) / 2), fdf((size + 1) / 2);
+    vpImageFilter::getGaussianKernel(&fg[0], size);
+    vpImageFilter::getGaussianDerivativeKernel(&fd[0], size);
+    vpImageFilter::getGaussianKernel(&fgf[0], size);
+    vpImageFilter::getGaussianDerivativeKernel(&fdf[0], size);
+
+    // Double precision filters give the same results as the per-pixel ones
+    vpImage<double> GIx, GIx_ref, GI, GI_ref;
+    vpImageFilter::filterX(I, GIx, &fg[0], size);
+    filterXReference(I, GIx_ref, &fg[0], size);
+    if (!isNear(GIx, GIx_ref, 0., "filterX")) {
+      return EXIT_FAILURE;
+    }
+    vpImageFilter::filterY(GIx, GI, &fg[0], size);
+    filterYReference(GIx, GI_ref, &fg[0], size);
+    if (!isNear(GI, GI_ref, 0., "filterY")) {
+      return EXIT_FAILURE;
+    }
+    vpImage<double> GIx2, GIx2_ref;
+    vpImageFilter::filterX(GI, GIx2, &fg[0], size);
+    filterXReference(GI, GIx2_ref, &fg[0], size);
+    if (!isNear(GIx2, GIx2_ref, 0., "filterX (double)")) {
+      return EXIT_FAILURE;
+    }
+
+    vpImage<double> dIx, dIy, dIx_ref, dIy_ref;
+    vpImageFilter::getGradX(I, dIx, &fd[0], size);
+    vpImageFilter::getGradY(I, dIy, &fd[0], size);
+    gradReference(I, dIx_ref, dIy_ref, &fd[0], size);
+    if (!isNear(dIx, dIx_ref, 0., "getGradX") || !isNear(dIy, dIy_ref, 0., "getGradY")) {
+      return EXIT_FAILURE;
+    }
+    vpImageFilter::getGradX(GI, dIx, &fd[0], size);
+    vpImageFilter::getGradY(GI, dIy, &fd[0], size);
+    gradReference(GI, dIx_ref, dIy_ref, &fd[0], size);
+    if (!isNear(dIx, dIx_ref, 0., "getGradX (double)") || !isNear(dIy, dIy_ref, 0., "getGradY (double)")) {
+      return EXIT_FAILURE;
+    }
+
+    // Single precision filters
+    vpImage<float> GIf, dIxf, dIyf;
+    vpImageFilter::gaussianBlur(I, GIf, size);
+    if (!isNear(GIf, GI, 1e-3, "gaussianBlur (float)")) {
+      return EXIT_FAILURE;
+    }
+    vpImageFilter::getGradX(I, dIxf, &fdf[0], size);
+    vpImageFilter::getGradY(I, dIyf, &fdf[0], size);
+    vpImageFilter::getGradX(I, dIx, &fd[0], size);
+    vpImageFilter::getGradY(I, dIy, &fd[0], size);
+    if (!isNear(dIxf, dIx, 1e-3, "getGradX (float)") || !isNear(dIyf, dIy, 1e-3, "getGradY (float)")) {
+      return EXIT_FAILURE;
+    }
+
+    // Fixed-point blur is within one grey level of the rounded double blur
+    vpImage<unsigned char> GIu;
+    vpImageFilter::gaussianBlur(I, GIu, size);
+    vpImage<double> GI_round(GI.getHeight(), GI.getWidth());
+    for (unsigned int i = 0; i < GI.getSize(); i++) {
+      GI_round.bitmap[i] = vpMath::round(GI.bitmap[i]);
+    }
+    if (!isNear(GIu, GI_round, 1., "gaussianBlur (fixed-point)")) {
+      return EXIT_FAILURE;
+    }
+
+    // Fixed-point gradients are exact with an integer kernel
+    std::vector<short> fs((size + 1) / 2);
+    std::vector<double> fsd((size + 1) / 2);
+    for (unsigned int k = 0; k < fs.size(); k++) {
+      fs[k] = (short)vpMath::round(fd[k] * 64);
+      fsd[k] = fs[k];
+    }
+    vpImage<short> dIxs, dIys;
+    vpImageFilter::getGradX(I, dIxs, &fs[0], size);
+    vpImageFilter::getGradY(I, dIys, &fs[0], size);
+    gradReference(I, dIx_ref, dIy_ref, &fsd[0], size);
+    if (!isNear(dIxs, dIx_ref, 0., "getGradX (fixed-point)") || !isNear(dIys, dIy_ref, 0., "getGradY (fixed-point)")) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Gaussian pyramid
+  vpImage<unsigned char> GIx, GI;
+  vpImageFilter::getGaussXPyramidal(I, GIx);
+  vpImageFilter::getGaussYPyramidal(GIx, GI);
+  for (unsigned int i = 0; i < GIx.getHeight(); i++) {
+    for (unsigned int j = 1; j < GIx.getWidth() - 1; j++) {
+      if (GIx[i][j] != vpImageFilter::filterGaussXPyramidal(I, i, 2 * j)) {
+        std::cerr << "getGaussXPyramidal: bad value at (" << i << ", " << j << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  for (unsigned int i = 1; i < GI.getHeight() - 1; i++) {
+    for (unsigned int j = 0; j < GI.getWidth(); j++) {
+      if (GI[i][j] != vpImageFilter::filterGaussYPyramidal(GIx, 2 * i, j)) {
+        std::cerr << "getGaussYPyramidal: bad value at (" << i << ", " << j << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "testImageFilterSIMD is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test image remapping with precomputed tables.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testImageRemap.cpp
+
+  \brief Test the fixed-point image remapping of vpImageRemap against
+  floating-point bilinear interpolations.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageRemap.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpRxyzVector.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+// Smooth image, whose interpolation error due to the quantization of the
+// coordinates is small
+void createImage(vpImage<unsigned char> &I, unsigned int height, unsigned int width)
+{
+  I.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      I[i][j] = (unsigned char)(127.5 + 60 * sin(i / 7.) + 60 * cos(j / 11.));
+    }
+  }
+}
+
+// Bilinear interpolation of a source image, or 0 outside of the image. As
+// in vpImageRemap, points closer to the border than half a 1/32 pixel step
+// are clamped
+double interpolate(const vpImage<unsigned char> &I, double u, double v)
+{
+  const double margin = 1 / 64.;
+  if (u < -margin || v < -margin || u > I.getWidth() - 1 + margin || v > I.getHeight() - 1 + margin) {
+    return 0;
+  }
+  u = (std::min)((std::max)(u, 0.), I.getWidth() - 1.);
+  v = (std::min)((std::max)(v, 0.), I.getHeight() - 1.);
+  unsigned int j = (std::min)((unsigned int)u, I.getWidth() - 2);
+  unsigned int i = (std::min)((unsigned int)v, I.getHeight() - 2);
+  double du = u - j, dv = v - i;
+  return (1 - dv) * ((1 - du) * I[i][j] + du * I[i][j + 1]) + dv * ((1 - du) * I[i + 1][j] + du * I[i + 1][j + 1]);
+}
+
+bool check(const vpImage<unsigned char> &I, const vpImage<double> &I_ref, double tolerance, const std::string &name)
+{
+  if (I.getHeight() != I_ref.getHeight() || I.getWidth() != I_ref.getWidth()) {
+    std::cerr << name << ": bad size" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (std::fabs(I[i][j] - I_ref[i][j]) > tolerance) {
+        std::cerr << name << ": " << (int)I[i][j] << " != " << I_ref[i][j] << " at (" << i << ", " << j << ")"
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  vpImage<unsigned char> I;
+  // Odd width to exercise the scalar tail of the vectorized loop
+  createImage(I, 241, 323);
+
+  // Undistortion
+  vpCameraParameters cam(400, 410, 160, 118, -0.2, 0.21);
+  vpImageRemap remap;
+  remap.initUndistort(cam, I.getWidth(), I.getHeight());
+  vpImage<unsigned char> I_undist;
+  remap.remap(I, I_undist);
+
+  vpImage<double> I_ref(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double x = (j - cam.get_u0()) / cam.get_px(), y = (i - cam.get_v0()) / cam.get_py();
+      double fr = 1 + cam.get_kud() * (x * x + y * y);
+      I_ref[i][j] = interpolate(I, cam.get_u0() + cam.get_px() * x * fr, cam.get_v0() + cam.get_py() * y * fr);
+    }
+  }
+  if (!check(I_undist, I_ref, 1.5, "initUndistort")) {
+    return EXIT_FAILURE;
+  }
+
+  // Fused undistortion, rectification and resizing to half the size
+  vpRotationMatrix R(vpRxyzVector(0.02, -0.03, 0.01));
+  vpCameraParameters cam_new(200, 200, 80, 60);
+  remap.initUndistortRectify(cam, I.getWidth(), I.getHeight(), R, cam_new, 161, 121);
+  remap.remap(I, I_undist);
+
+  I_ref.resize(121, 161);
+  for (unsigned int i = 0; i < I_ref.getHeight(); i++) {
+    for (unsigned int j = 0; j < I_ref.getWidth(); j++) {
+      vpColVector X(3);
+      X[0] = (j - cam_new.get_u0()) / cam_new.get_px();
+      X[1] = (i - cam_new.get_v0()) / cam_new.get_py();
+      X[2] = 1;
+      X = R * X;
+      double x = X[0] / X[2], y = X[1] / X[2];
+      double fr = 1 + cam.get_kud() * (x * x + y * y);
+      I_ref[i][j] = interpolate(I, cam.get_u0() + cam.get_px() * x * fr, cam.get_v0() + cam.get_py() * y * fr);
+    }
+  }
+  if (!check(I_undist, I_ref, 1.5, "initUndistortRectify")) {
+    return EXIT_FAILURE;
+  }
+
+  // Homography
+  vpMatrix H(3, 3);
+  H[0][0] = 1.1;
+  H[0][1] = 0.05;
+  H[0][2] = -12;
+  H[1][0] = -0.04;
+  H[1][1] = 0.95;
+  H[1][2] = 7;
+  H[2][0] = 1e-4;
+  H[2][1] = -2e-4;
+  H[2][2] = 1;
+  remap.initHomography(H, I.getWidth(), I.getHeight(), 300, 200);
+  vpImage<unsigned char> I_warp;
+  remap.remap(I, I_warp);
+
+  // Inverse of H up to a scale factor
+  vpMatrix Hinv(3, 3);
+  Hinv[0][0] = H[1][1] * H[2][2] - H[1][2] * H[2][1];
+  Hinv[0][1] = H[0][2] * H[2][1] - H[0][1] * H[2][2];
+  Hinv[0][2] = H[0][1] * H[1][2] - H[0][2] * H[1][1];
+  Hinv[1][0] = H[1][2] * H[2][0] - H[1][0] * H[2][2];
+  Hinv[1][1] = H[0][0] * H[2][2] - H[0][2] * H[2][0];
+  Hinv[1][2] = H[0][2] * H[1][0] - H[0][0] * H[1][2];
+  Hinv[2][0] = H[1][0] * H[2][1] - H[1][1] * H[2][0];
+  Hinv[2][1] = H[0][1] * H[2][0] - H[0][0] * H[2][1];
+  Hinv[2][2] = H[0][0] * H[1][1] - H[0][1] * H[1][0];
+  I_ref.resize(200, 300);
+  for (unsigned int i = 0; i < I_ref.getHeight(); i++) {
+    for (unsigned int j = 0; j < I_ref.getWidth(); j++) {
+      double z = Hinv[2][0] * j + Hinv[2][1] * i + Hinv[2][2];
+      I_ref[i][j] = interpolate(I, (Hinv[0][0] * j + Hinv[0][1] * i + Hinv[0][2]) / z,
+                                (Hinv[1][0] * j + Hinv[1][1] * i + Hinv[1][2]) / z);
+    }
+  }
+  if (!check(I_warp, I_ref, 1.5, "initHomography")) {
+    return EXIT_FAILURE;
+  }
+
+  // Resize, whose last row and column match the ones of the source image
+  remap.initResize(I.getWidth(), I.getHeight(), 97, 75);
+  vpImage<unsigned char> I_resize;
+  remap.remap(I, I_resize);
+  vpImage<unsigned char> I_resize_ref(75, 97);
+  vpImageTools::resize(I, I_resize_ref, vpImageTools::INTERPOLATION_LINEAR);
+  vpImageConvert::convert(I_resize_ref, I_ref);
+  if (!check(I_resize, I_ref, 1.5, "initResize")) {
+    return EXIT_FAILURE;
+  }
+
+  // Color images are interpolated channel by channel with the same weights
+  vpImage<vpRGBa> I_color(I.getHeight(), I.getWidth());
+  vpImage<unsigned char> I_channels[4];
+  for (unsigned int c = 0; c < 4; c++) {
+    createImage(I_channels[c], I.getHeight(), I.getWidth());
+    for (unsigned int k = 0; k < I.getSize(); k++) {
+      I_channels[c].bitmap[k] = (unsigned char)(I_channels[c].bitmap[k] + 50 * c + k % 7);
+      ((unsigned char *)&I_color.bitmap[k])[c] = I_channels[c].bitmap[k];
+    }
+  }
+  remap.initHomography(H, I.getWidth(), I.getHeight(), 300, 200);
+  vpImage<vpRGBa> I_color_warp;
+  remap.remap(I_color, I_color_warp);
+  for (unsigned int c = 0; c < 4; c++) {
+    remap.remap(I_channels[c], I_warp);
+    for (unsigned int k = 0; k < I_warp.getSize(); k++) {
+      if (((unsigned char *)&I_color_warp.bitmap[k])[c] != I_warp.bitmap[k]) {
+        std::cerr << "Color remap differs from grayscale remap on channel " << c << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Timing against vpImageTools::undistort() on a 2 MP image
+  createImage(I, 1080, 1920);
+  vpCameraParameters cam_hd(1200, 1200, 960, 540, -0.15, 0.16);
+  double t = vpTime::measureTimeMs();
+  remap.initUndistort(cam_hd, I.getWidth(), I.getHeight());
+  double t_init = vpTime::measureTimeMs() - t;
+
+  const unsigned int nbIterations = 20;
+  t = vpTime::measureTimeMs();
+  for (unsigned int iter = 0; iter < nbIterations; iter++) {
+    remap.remap(I, I_undist);
+  }
+  double t_remap = (vpTime::measureTimeMs() - t) / nbIterations;
+
+  vpImage<unsigned char> I_undist_tools;
+  t = vpTime::measureTimeMs();
+  for (unsigned int iter = 0; iter < nbIterations; iter++) {
+    vpImageTools::undistort(I, cam_hd, I_undist_tools);
+  }
+  double t_undistort = (vpTime::measureTimeMs() - t) / nbIterations;
+
+  std::cout << "1920x1080 undistortion: vpImageRemap " << t_remap << " ms (table " << t_init
+            << " ms), vpImageTools::undistort() " << t_undistort << " ms" << std::endl;
+
+  std::cout << "testImageRemap is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test image views on regions of interest and strided memory.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testImageView.cpp
+
+  \brief Test image views on regions of interest and strided memory.
+
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpImageView.h>
+
+namespace
+{
+bool isEqual(const vpImage<double> &I1, const vpImage<double> &I2, const std::string &name)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    std::cerr << name << ": bad size" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < I1.getHeight(); i++) {
+    for (unsigned int j = 0; j < I1.getWidth(); j++) {
+      if (I1[i][j] != I2[i][j]) {
+        std::cerr << name << ": " << I1[i][j] << " != " << I2[i][j] << " at (" << i << ", " << j << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Reference separable filtering computed with the per-pixel functions
+void filterReference(const vpImage<unsigned char> &I, vpImage<double> &dIx, vpImage<double> &dIy, const double *filter,
+                     unsigned int size)
+{
+  unsigned int half = (size - 1) / 2;
+  dIx.resize(I.getHeight(), I.getWidth());
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (j < half) {
+        dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+      } else if (j >= I.getWidth() - half) {
+        dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+      } else {
+        dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+      }
+
+      if (i < half) {
+        dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+      } else if (i >= I.getHeight() - half) {
+        dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+      } else {
+        dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+      }
+    }
+  }
+}
+}
+
+int main()
+{
+  const unsigned int height = 61, width = 83;
+  vpImage<unsigned char> I(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      I[i][j] = (unsigned char)((i * 7 + j * 13 + (i * j) % 17) % 256);
+    }
+  }
+
+  try {
+    // Region of interest: same pixels as a cropped image
+    vpRect roi(10, 5, 40, 30);
+    vpImageView<unsigned char> view(I, roi);
+    vpImage<unsigned char> I_crop, I_view;
+    vpImageTools::crop(I, roi, I_crop);
+    vpImageTools::crop(view, I_view);
+    if (view.getHeight() != 30 || view.getWidth() != 40 || view.getStride() != width || view.isContiguous() ||
+        !(I_view == I_crop) || view[3][4] != I[8][14] || view.getView(2, 3, 5, 6)(1, 1) != I[8][14]) {
+      std::cerr << "Bad region of interest" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // A const image gives a read-only view, and a view in write mode
+    // converts to a read-only one
+    const vpImage<unsigned char> &I_const = I;
+    vpImageView<const unsigned char> view_const(I_const, roi), view_converted(view);
+    vpImage<unsigned char> I_view_const;
+    vpImageTools::crop(view_const, I_view_const);
+    if (view_const.getData() != view.getData() || view_converted.getData() != view.getData() ||
+        view_const.getStride() != view.getStride() || !(I_view_const == I_crop) ||
+        vpImageView<const unsigned char>(I_const, 8, 14, 2, 2)[0][0] != I[8][14]) {
+      std::cerr << "Bad read-only view" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Clipping
+    vpImageView<unsigned char> clipped(I, vpRect(-5, 50, 20, 40));
+    if (clipped.getHeight() != 11 || clipped.getWidth() != 15 || clipped[0][0] != I[50][0]) {
+      std::cerr << "Bad clipping" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    bool exceptionThrown = false;
+    try {
+      view.getView(25, 0, 10, 10);
+    } catch (const vpException &) {
+      exceptionThrown = true;
+    }
+    if (!exceptionThrown) {
+      std::cerr << "An exception was expected for an out of view ROI" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Filters applied on a view or on the cropped image give the same result
+    const unsigned int size = 7;
+    double filter[(size + 1) / 2], derivative_filter[(size + 1) / 2];
+    vpImageFilter::getGaussianKernel(filter, size);
+    vpImageFilter::getGaussianDerivativeKernel(derivative_filter, size);
+
+    vpImage<double> If1, If2;
+    vpImageFilter::gaussianBlur(I_crop, If1);
+    vpImageFilter::gaussianBlur(view, If2);
+    if (!isEqual(If1, If2, "gaussianBlur")) {
+      return EXIT_FAILURE;
+    }
+    vpImageFilter::getGradX(I_crop, If1, derivative_filter, size);
+    vpImageFilter::getGradX(view, If2, derivative_filter, size);
+    if (!isEqual(If1, If2, "getGradX")) {
+      return EXIT_FAILURE;
+    }
+    vpImageFilter::getGradY(I_crop, If1, derivative_filter, size);
+    vpImageFilter::getGradY(view, If2, derivative_filter, size);
+    if (!isEqual(If1, If2, "getGradY")) {
+      return EXIT_FAILURE;
+    }
+    vpMatrix M(3, 3);
+    M[0][0] = M[2][2] = 1;
+    M[0][2] = M[2][0] = -1;
+    vpImageFilter::filter(I_crop, If1, M, true);
+    vpImageFilter::filter(view, If2, M, true);
+    if (!isEqual(If1, If2, "filter")) {
+      return EXIT_FAILURE;
+    }
+
+    // The row-wise separable filters match the per-pixel functions
+    vpImage<double> dIx_ref, dIy_ref;
+    filterReference(I, dIx_ref, dIy_ref, filter, size);
+    vpImageFilter::filterX(I, If1, filter, size);
+    vpImageFilter::filterY(I, If2, filter, size);
+    if (!isEqual(If1, dIx_ref, "filterX") || !isEqual(If2, dIy_ref, "filterY")) {
+      return EXIT_FAILURE;
+    }
+
+    // External buffer with a row padding
+    const unsigned int stride = width + 13;
+    std::vector<unsigned char> buffer(height * stride, 0);
+    for (unsigned int i = 0; i < height; i++) {
+      memcpy(&buffer[i * stride], I[i], width);
+    }
+    vpImageView<unsigned char> padded(&buffer[0], height, width, stride);
+    vpImageFilter::gaussianBlur(I, If1);
+    vpImageFilter::gaussianBlur(padded, If2);
+    if (!isEqual(If1, If2, "gaussianBlur on strided memory")) {
+      return EXIT_FAILURE;
+    }
+
+    // In-place binarisation of a ROI
+    vpImage<unsigned char> I_bin = I;
+    vpImageTools::binarise(vpImageView<unsigned char>(I_bin, 10, 20, 5, 8), (unsigned char)100, (unsigned char)100,
+                           (unsigned char)0, (unsigned char)255, (unsigned char)255);
+    for (unsigned int i = 0; i < height; i++) {
+      for (unsigned int j = 0; j < width; j++) {
+        bool inside = i >= 10 && i < 15 && j >= 20 && j < 28;
+        unsigned char expected = inside ? (I[i][j] < 100 ? 0 : 255) : I[i][j];
+        if (I_bin[i][j] != expected) {
+          std::cerr << "Bad binarisation at (" << i << ", " << j << ")" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Conversions
+    vpImage<vpRGBa> I_color, I_color_crop;
+    vpImageConvert::convert(I, I_color);
+    vpImage<unsigned char> I_grey, I_grey_crop;
+    vpImageConvert::convert(vpImageView<vpRGBa>(I_color, roi), I_grey);
+    vpImageConvert::convert(I_crop, I_color_crop);
+    vpImageConvert::convert(I_color_crop, I_grey_crop);
+    // The SSSE3 and scalar conversions may differ by one grey level
+    for (unsigned int i = 0; i < I_grey.getHeight(); i++) {
+      for (unsigned int j = 0; j < I_grey.getWidth(); j++) {
+        if (std::abs((int)I_grey[i][j] - (int)I_grey_crop[i][j]) > 1) {
+          std::cerr << "Bad conversion of a vpRGBa view" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    vpImageConvert::convert(view, I_color);
+    if (!(I_color == I_color_crop)) {
+      std::cerr << "Bad conversion of a grey level view" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testImageView is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the adaptive RANSAC engine.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testAdaptiveRansac.cpp
+
+  \brief Test the adaptive RANSAC engine on a 2D line fitting with outliers.
+
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpAdaptiveRansac.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+// Line a x + b y + c = 0 with a^2 + b^2 = 1
+class LineEstimator : public vpAdaptiveRansac::vpModelEstimator
+{
+public:
+  LineEstimator(const std::vector<double> &x, const std::vector<double> &y) : m_x(x), m_y(y) {}
+
+  unsigned int getNbData() const { return (unsigned int)m_x.size(); }
+
+  unsigned int getSampleSize() const { return 2; }
+
+  bool isSampleValid(const std::vector<unsigned int> &sample) const
+  {
+    return std::fabs(m_x[sample[0]] - m_x[sample[1]]) + std::fabs(m_y[sample[0]] - m_y[sample[1]]) > 1e-9;
+  }
+
+  void computeModels(const std::vector<unsigned int> &sample, std::vector<vpColVector> &models) const
+  {
+    vpColVector line(3);
+    line[0] = m_y[sample[0]] - m_y[sample[1]];
+    line[1] = m_x[sample[1]] - m_x[sample[0]];
+    double n = sqrt(line[0] * line[0] + line[1] * line[1]);
+    line[0] /= n;
+    line[1] /= n;
+    line[2] = -line[0] * m_x[sample[0]] - line[1] * m_y[sample[0]];
+    models.push_back(line);
+  }
+
+  double computeError(const vpColVector &line, unsigned int index) const
+  {
+    return std::fabs(line[0] * m_x[index] + line[1] * m_y[index] + line[2]);
+  }
+
+private:
+  const std::vector<double> &m_x;
+  const std::vector<double> &m_y;
+};
+
+// Points of the line y = 0.5 x + 1 with a small noise, followed by outliers.
+// The qualities favor the inliers.
+void generateData(unsigned int nbInliers, unsigned int nbOutliers, std::vector<double> &x, std::vector<double> &y,
+                  std::vector<double> &qualities)
+{
+  vpUniRand rng(1234);
+  for (unsigned int i = 0; i < nbInliers + nbOutliers; i++) {
+    double xi = 20.0 * rng() - 10.0;
+    if (i < nbInliers) {
+      x.push_back(xi);
+      y.push_back(0.5 * xi + 1.0 + 0.002 * (rng() - 0.5));
+      qualities.push_back(1.0 + rng());
+    } else {
+      x.push_back(xi);
+      y.push_back(20.0 * rng() - 10.0);
+      qualities.push_back(rng());
+    }
+  }
+}
+
+bool checkResult(const std::string &name, const vpAdaptiveRansac &ransac, bool found, const vpColVector &line,
+                 const std::vector<unsigned int> &inliers, unsigned int nbInliers)
+{
+  std::cout << name << ": " << ransac.getNbTrials() << " trials, " << inliers.size() << " inliers" << std::endl;
+  if (!found) {
+    std::cerr << "No model found" << std::endl;
+    return false;
+  }
+
+  // Expected line: 0.5 x - y + 1 = 0, normalized, up to the sign
+  double n = sqrt(1.25);
+  double s = line[1] > 0 ? -1.0 : 1.0;
+  if (std::fabs(s * line[0] - 0.5 / n) > 0.01 || std::fabs(s * line[1] + 1.0 / n) > 0.01 ||
+      std::fabs(s * line[2] - 1.0 / n) > 0.01) {
+    std::cerr << "Bad line: " << line.t() << std::endl;
+    return false;
+  }
+
+  // All the inliers and only a few outliers lying close to the line
+  unsigned int nbTrueInliers = 0;
+  for (size_t i = 0; i < inliers.size(); i++) {
+    if (inliers[i] < nbInliers) {
+      nbTrueInliers++;
+    }
+  }
+  if (nbTrueInliers != nbInliers || inliers.size() > nbInliers + 5) {
+    std::cerr << "Bad consensus: " << nbTrueInliers << " true inliers among " << inliers.size() << std::endl;
+    return false;
+  }
+
+  if (ransac.getNbTrials() == 0 || ransac.getNbTrials() > ransac.getMaxTrials()) {
+    std::cerr << "Bad number of trials" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int nbInliers = 100, nbOutliers = 150;
+    std::vector<double> x, y, qualities;
+    generateData(nbInliers, nbOutliers, x, y, qualities);
+    LineEstimator estimator(x, y);
+
+    vpColVector line;
+    std::vector<unsigned int> inliers;
+
+    vpAdaptiveRansac ransac;
+    ransac.setThreshold(0.01);
+    ransac.setMaxTrials(5000);
+    bool found = ransac.estimate(estimator, line, inliers);
+    if (!checkResult("Uniform sampling", ransac, found, line, inliers, nbInliers)) {
+      return EXIT_FAILURE;
+    }
+    // 60% of outliers with samples of 2 points: about 26 trials at 99%
+    if (ransac.getNbTrials() >= 5000) {
+      std::cerr << "The number of trials was not adapted" << std::endl;
+      return EXIT_FAILURE;
+    }
+    unsigned int nbUniformTrials = ransac.getNbTrials();
+
+    ransac.setQualities(qualities);
+    found = ransac.estimate(estimator, line, inliers);
+    if (!checkResult("PROSAC", ransac, found, line, inliers, nbInliers)) {
+      return EXIT_FAILURE;
+    }
+    if (ransac.getNbTrials() > nbUniformTrials) {
+      std::cerr << "PROSAC needed more trials than the uniform sampling" << std::endl;
+      return EXIT_FAILURE;
+    }
+    ransac.setQualities(std::vector<double>());
+
+    ransac.setUseSPRT(true);
+    found = ransac.estimate(estimator, line, inliers);
+    if (!checkResult("SPRT", ransac, found, line, inliers, nbInliers)) {
+      return EXIT_FAILURE;
+    }
+    ransac.setUseSPRT(false);
+
+    // Stop as soon as the consensus is reached
+    ransac.setNbInliersToReachConsensus(nbInliers / 2);
+    found = ransac.estimate(estimator, line, inliers);
+    if (!found || inliers.size() < nbInliers / 2) {
+      std::cerr << "Consensus not reached" << std::endl;
+      return EXIT_FAILURE;
+    }
+    ransac.setNbInliersToReachConsensus(0);
+
+    // Parallel trials
+    vpThreadPool::getInstance().setNumberOfThreads(4);
+    ransac.setNbThreads(0);
+    ransac.setUseSPRT(true);
+    ransac.setQualities(qualities);
+    found = ransac.estimate(estimator, line, inliers);
+    if (!checkResult("Parallel", ransac, found, line, inliers, nbInliers)) {
+      return EXIT_FAILURE;
+    }
+
+    // Not enough data
+    std::vector<double> x1(1, 0.0), y1(1, 0.0);
+    try {
+      ransac.estimate(LineEstimator(x1, y1), line, inliers);
+      std::cerr << "An exception was expected" << std::endl;
+      return EXIT_FAILURE;
+    } catch (const vpException &) {
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testAdaptiveRansac is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test fixed-size matrices and the transformations built on them.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFixedMatrix.cpp
+
+  Test vpFixedMatrix and vpFixedColVector against vpMatrix, and the
+  homogeneous, rotation and twist matrices that are stored in them.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpFixedMatrix.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
+
+namespace
+{
+bool equal(const vpArray2D<double> &A, const vpArray2D<double> &B, double eps = 1e-12)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < A.size(); i++) {
+    if (std::fabs(A.data[i] - B.data[i]) > eps) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <unsigned int R, unsigned int C> void fill(vpFixedMatrix<R, C> &M, double offset)
+{
+  for (unsigned int i = 0; i < R; i++) {
+    for (unsigned int j = 0; j < C; j++) {
+      M[i][j] = offset + i * C + j - 0.1 * j * j;
+    }
+  }
+}
+
+bool check(bool ok, const std::string &what)
+{
+  if (!ok) {
+    std::cerr << "Failed: " << what << std::endl;
+  }
+  return ok;
+}
+}
+
+int main()
+{
+  bool ok = true;
+
+  // Arithmetic against vpMatrix
+  vpFixedMatrix<3, 4> A;
+  vpFixedMatrix<4, 2> B;
+  fill(A, 1.);
+  fill(B, -2.);
+  vpMatrix Am = A, Bm = B;
+  ok &= check(Am.getRows() == 3 && Am.getCols() == 4 && equal(Am, A), "conversion to vpMatrix");
+  ok &= check(equal(A * B, Am * Bm), "product");
+  ok &= check(equal(A.t(), Am.t()), "transpose");
+  ok &= check(equal(A + A, Am + Am) && equal(A - A * 2., Am - Am * 2.) && equal(-A, -Am), "sum and difference");
+  vpFixedMatrix<3, 4> A2(Am * 3.);
+  A2 -= A;
+  A2 *= 0.5;
+  ok &= check(equal(A2, A), "compound operators");
+
+  vpFixedColVector<4> v;
+  for (unsigned int i = 0; i < 4; i++) {
+    v[i] = 1. + i;
+  }
+  vpColVector vc = v;
+  ok &= check(equal(A * v, Am * vc) && vpFixedColVector<4>::dotProd(v, v) == 30., "matrix-vector product");
+  ok &= check(vpFixedColVector<4>(vc)[3] == 4., "conversion from vpColVector");
+
+  // Copies must not share the storage of their source
+  vpFixedMatrix<3, 4> C(A);
+  vpFixedMatrix<3, 4> D;
+  D = A;
+  A[1][2] = 100.;
+  ok &= check(C[1][2] != 100. && D[1][2] != 100. && C.data != A.data, "independent copies");
+
+  bool thrown = false;
+  try {
+    vpFixedMatrix<4, 3> E(Am);
+  } catch (vpException &e) {
+    thrown = (e.getCode() == vpException::dimensionError);
+  }
+  ok &= check(thrown, "dimension check");
+
+  // The dimensions of a fixed-size array cannot change, even through
+  // vpArray2D, and its storage is kept
+  {
+    vpFixedMatrix<2, 2> F;
+    F[1][1] = 5.;
+    const double *storage = F.data;
+    vpArray2D<double> &base = F;
+    thrown = false;
+    try {
+      base.resize(3, 2, false);
+    } catch (vpException &e) {
+      thrown = (e.getCode() == vpException::dimensionError);
+    }
+    ok &= check(thrown && F.getRows() == 2 && F.data == storage && F[1][1] == 5., "resize");
+
+    thrown = false;
+    try {
+      base = vpArray2D<double>(1, 4);
+    } catch (vpException &e) {
+      thrown = (e.getCode() == vpException::dimensionError);
+    }
+    ok &= check(thrown && F.getCols() == 2 && F.data == storage, "assignment of another size");
+
+    base.resize(2, 2);
+    ok &= check(F.data == storage && F[1][1] == 0., "resize to the same dimensions");
+  }
+
+  // Transformations
+  vpHomogeneousMatrix aMb(0.1, -0.2, 0.5, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+  vpHomogeneousMatrix bMc(-0.3, 0.05, 0.2, vpMath::rad(-40), vpMath::rad(5), vpMath::rad(15));
+  vpMatrix aMbm = aMb, bMcm = bMc;
+  ok &= check(equal(aMb * bMc, aMbm * bMcm), "homogeneous product");
+  ok &= check(equal(aMb.inverse(), aMbm.inverseByLU()), "homogeneous inverse");
+
+  vpRotationMatrix aRb = aMb.getRotationMatrix(), bRc = bMc.getRotationMatrix();
+  vpTranslationVector t = bMc.getTranslationVector();
+  ok &= check(equal(aRb * bRc, vpMatrix(aRb) * vpMatrix(bRc)) && equal(aRb.t(), vpMatrix(aRb).t()), "rotation");
+  ok &= check(equal(aRb * t, vpMatrix(aRb) * vpColVector(t)), "rotation times translation");
+
+  vpVelocityTwistMatrix V(t, aRb);
+  vpMatrix Vm(6, 6);
+  vpMatrix skewR = vpTranslationVector::skew(t) * vpMatrix(aRb);
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      Vm[i][j] = Vm[i + 3][j + 3] = aRb[i][j];
+      Vm[i][j + 3] = skewR[i][j];
+    }
+  }
+  ok &= check(equal(V, Vm), "velocity twist");
+  ok &= check(equal(V * V, Vm * Vm), "velocity twist product");
+
+  std::vector<vpHomogeneousMatrix> poses;
+  for (unsigned int i = 0; i < 50; i++) {
+    poses.push_back(aMb * bMc);
+  }
+  ok &= check(equal(poses.front(), poses.back()) && poses.front().data != poses.back().data, "container of poses");
+
+  if (!ok) {
+    return EXIT_FAILURE;
+  }
+  std::cout << "testFixedMatrix is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the built-in matrix products against a naive implementation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMatrixMult.cpp
+
+  Test the built-in cache-blocked matrix products used by vpMatrix when no
+  BLAS library is available (or for matrices smaller than
+  vpMatrix::getLapackMatrixMinSize()), for sizes that exercise the edges of
+  the blocking.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+void randomMatrix(vpUniRand &rand, vpMatrix &A, unsigned int rows, unsigned int cols)
+{
+  A.resize(rows, cols, false, false);
+  for (unsigned int i = 0; i < A.size(); i++) {
+    A.data[i] = 2. * rand() - 1.;
+  }
+}
+
+vpMatrix naiveProduct(const vpMatrix &A, const vpMatrix &B)
+{
+  vpMatrix C(A.getRows(), B.getCols());
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    for (unsigned int j = 0; j < B.getCols(); j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < A.getCols(); k++) {
+        s += A[i][k] * B[k][j];
+      }
+      C[i][j] = s;
+    }
+  }
+  return C;
+}
+
+bool equal(const vpMatrix &A, const vpMatrix &B, unsigned int depth)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    return false;
+  }
+  // Each entry sums depth products of values in [-1, 1]
+  const double eps = 1e-14 * (depth + 1);
+  for (unsigned int i = 0; i < A.size(); i++) {
+    if (std::fabs(A.data[i] - B.data[i]) > eps) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool check(bool ok, const std::string &what, unsigned int m, unsigned int n, unsigned int k)
+{
+  if (!ok) {
+    std::cerr << "Failed: " << what << " (" << m << "x" << k << " by " << k << "x" << n << ")" << std::endl;
+  }
+  return ok;
+}
+
+bool testProducts(vpUniRand &rand)
+{
+  bool ok = true;
+
+  // Sizes around the micro-kernel tiles and the cache blocks
+  const unsigned int sizes[][3] = {{1, 1, 1},     {3, 5, 7},     {4, 8, 16},   {5, 9, 17},   {17, 13, 3},
+                                   {33, 31, 29},  {97, 65, 255}, {96, 8, 257}, {191, 23, 600}, {7, 2050, 9},
+                                   {300, 6, 40}, {40, 300, 6}};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    const unsigned int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+    vpMatrix A, B;
+    randomMatrix(rand, A, m, k);
+    randomMatrix(rand, B, k, n);
+    vpMatrix C_ref = naiveProduct(A, B);
+
+    ok &= check(equal(A * B, C_ref, k), "A * B", m, n, k);
+    ok &= check(equal(A.AtA(), naiveProduct(A.t(), A), m), "AtA", k, k, m);
+    ok &= check(equal(A.AAt(), naiveProduct(A, A.t()), k), "AAt", m, m, k);
+
+    vpColVector x(k);
+    for (unsigned int i = 0; i < k; i++) {
+      x[i] = 2. * rand() - 1.;
+    }
+    vpMatrix X(k, 1);
+    for (unsigned int i = 0; i < k; i++) {
+      X[i][0] = x[i];
+    }
+    ok &= check(equal(A * x, naiveProduct(A, X), k), "A * x", m, 1, k);
+  }
+
+  // Result matrix reused with another size
+  {
+    vpMatrix A, B, C(3, 3);
+    randomMatrix(rand, A, 50, 70);
+    randomMatrix(rand, B, 70, 40);
+    vpMatrix::mult2Matrices(A, B, C);
+    ok &= check(equal(C, naiveProduct(A, B), 70), "reused result", 50, 40, 70);
+  }
+
+  // Empty inner dimension
+  {
+    vpMatrix A(40, 0), B(0, 30);
+    vpMatrix C = A * B;
+    ok &= check(C.getRows() == 40 && C.getCols() == 30 && C.sumSquare() == 0.,
+                "empty inner dimension", 40, 30, 0);
+  }
+
+  return ok;
+}
+}
+
+int main()
+{
+  // Always use the built-in kernels, even when ViSP is built with BLAS
+  vpMatrix::setLapackMatrixMinSize(100000);
+
+  vpUniRand rand(42);
+  bool ok = true;
+
+  // Force each micro-kernel available on this platform
+  const vpMatrix::vpProductKernel kernels[] = {vpMatrix::PRODUCT_KERNEL_SCALAR, vpMatrix::PRODUCT_KERNEL_SSE2,
+                                               vpMatrix::PRODUCT_KERNEL_AVX2_FMA, vpMatrix::PRODUCT_KERNEL_NEON};
+  const char *names[] = {"scalar", "SSE2", "AVX2/FMA", "NEON"};
+  for (unsigned int i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+    if (!vpMatrix::setProductKernel(kernels[i])) {
+      std::cout << "Kernel " << names[i] << " not available" << std::endl;
+      continue;
+    }
+    std::cout << "Test the " << names[i] << " kernel" << std::endl;
+    ok &= testProducts(rand);
+  }
+  vpMatrix::setProductKernel(vpMatrix::PRODUCT_KERNEL_AUTO);
+
+  if (!ok) {
+    return EXIT_FAILURE;
+  }
+  std::cout << "testMatrixMult is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
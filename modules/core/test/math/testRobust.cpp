@@ -42,11 +42,15 @@
   Test some vpMath functionalities.
 */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <visp3/core/vpGaussRand.h>
 #include <visp3/core/vpIoTools.h>
 #include <visp3/core/vpRobust.h>
 #include <visp3/io/vpParseArgv.h>
@@ -55,6 +59,7 @@
 
 void usage(const char *name, const char *badparam, std::string ofilename);
 bool getOptions(int argc, const char **argv, std::string &ofilename);
+bool testMEstimator(vpRobust::vpRobustEstimatorType method, unsigned int n_data);
 
 /*!
 
@@ -139,6 +144,72 @@ bool getOptions(int argc, const char **argv, std::string &ofilename)
   return true;
 }
 
+/*!
+
+  Compare the weights computed by vpRobust::MEstimator() with the ones
+  obtained from a sorted copy of the residues.
+
+  \param method : Influence function.
+  \param n_data : Number of residues.
+  \return true if the weights are the same.
+
+*/
+bool testMEstimator(vpRobust::vpRobustEstimatorType method, unsigned int n_data)
+{
+  vpGaussRand noise(1.0, 0.0, n_data);
+  vpColVector residues(n_data), weights(n_data, 1.0), weights_ref(n_data, 1.0);
+  for (unsigned int i = 0; i < n_data; i++) {
+    // Some outliers, and some data already rejected
+    residues[i] = (i % 13 == 0) ? 20 * noise() : noise();
+    if (i % 11 == 3) {
+      weights[i] = weights_ref[i] = 0;
+    }
+  }
+
+  unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
+  std::vector<double> sorted(residues.data, residues.data + n_data);
+  std::sort(sorted.begin(), sorted.end());
+  double med = sorted[ind_med];
+  for (unsigned int i = 0; i < n_data; i++) {
+    sorted[i] = fabs(residues[i] - med);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  double sigma = std::max(1.4826 * sorted[ind_med], 0.0017);
+
+  for (unsigned int i = 0; i < n_data; i++) {
+    double x = fabs(residues[i] - med) / sigma;
+    switch (method) {
+    case vpRobust::TUKEY:
+      if (x <= 4.6851 && fabs(weights_ref[i]) > std::numeric_limits<double>::epsilon()) {
+        weights_ref[i] = vpMath::sqr(1 - vpMath::sqr(x / 4.6851));
+      } else {
+        weights_ref[i] = 0;
+      }
+      break;
+    case vpRobust::CAUCHY:
+      weights_ref[i] = 1 / (1 + vpMath::sqr(fabs(residues[i] - med) / (2.3849 * sigma)));
+      break;
+    case vpRobust::HUBER:
+      if (fabs(weights_ref[i]) > std::numeric_limits<double>::epsilon()) {
+        weights_ref[i] = x <= 1.2107 ? 1 : 1.2107 / x;
+      }
+      break;
+    }
+  }
+
+  vpRobust robust;
+  robust.MEstimator(method, residues, weights);
+  for (unsigned int i = 0; i < n_data; i++) {
+    if (!vpMath::equal(weights[i], weights_ref[i], 1e-12)) {
+      std::cerr << "Bad weight " << i << " with " << n_data << " residues: " << weights[i] << " instead of "
+                << weights_ref[i] << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
 int main(int argc, const char **argv)
 {
   try {
@@ -203,6 +274,18 @@ int main(int argc, const char **argv)
       f << x << "  " << w << std::endl;
       x += 0.01;
     }
+
+    // Odd sizes exercise the scalar tails of the vectorized kernels and
+    // large ones the histogram selection of the medians
+    unsigned int sizes[] = {1, 2, 5, 8, 17, 1001, 20000};
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+      if (!testMEstimator(vpRobust::TUKEY, sizes[i]) || !testMEstimator(vpRobust::CAUCHY, sizes[i]) ||
+          !testMEstimator(vpRobust::HUBER, sizes[i])) {
+        return 1;
+      }
+    }
+    std::cout << "vpRobust::MEstimator() weights are correct" << std::endl;
+
     return 0;
   } catch (const vpException &e) {
     std::cout << "Catch an exception: " << e << std::endl;
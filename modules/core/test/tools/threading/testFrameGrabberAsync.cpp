@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test asynchronous frame acquisition.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testFrameGrabberAsync.cpp
+
+  \brief Test the acquisition of the images of a frame grabber in a
+  background thread.
+
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+#include <visp3/core/vpFrameGrabberAsync.h>
+#include <visp3/core/vpFrameGrabberException.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+// Grabber whose images are filled with their index, until the last one
+class CounterGrabber : public vpFrameGrabber
+{
+public:
+  explicit CounterGrabber(unsigned int nbFrames) : m_nbFrames(nbFrames), m_index(0) {}
+
+  void open(vpImage<unsigned char> &I)
+  {
+    m_index = 0;
+    width = 64;
+    height = 48;
+    init = true;
+    acquire(I);
+  }
+  void open(vpImage<vpRGBa> &) { throw vpFrameGrabberException(vpFrameGrabberException::settingError, "Gray only"); }
+
+  void acquire(vpImage<unsigned char> &I)
+  {
+    if (m_index == m_nbFrames) {
+      throw vpFrameGrabberException(vpFrameGrabberException::otherError, "End of sequence");
+    }
+    vpTime::wait(1);
+    I.resize(height, width);
+    I = (unsigned char)m_index++;
+  }
+  void acquire(vpImage<vpRGBa> &) {}
+
+  void close() { init = false; }
+
+private:
+  unsigned int m_nbFrames;
+  unsigned int m_index;
+};
+
+bool testBlock()
+{
+  CounterGrabber grabber(100);
+  vpFrameGrabberAsync g(grabber, 3, vpFrameGrabberAsync::BLOCK);
+  vpImage<unsigned char> I;
+  g.open(I);
+  if (I[0][0] != 0) {
+    std::cerr << "Bad first frame" << std::endl;
+    return false;
+  }
+
+  // Every frame is acquired in order, in a fixed set of buffers
+  std::set<unsigned char *> buffers;
+  double last_timestamp = 0;
+  for (unsigned int i = 1; i < 100; i++) {
+    double timestamp;
+    g.acquire(I, timestamp);
+    if (I[0][0] != i || I[47][63] != i || timestamp < last_timestamp) {
+      std::cerr << "Bad frame " << (unsigned int)I[0][0] << " instead of " << i << std::endl;
+      return false;
+    }
+    last_timestamp = timestamp;
+    buffers.insert(I.bitmap);
+  }
+  if (buffers.size() > g.getBufferSize() + 1) {
+    std::cerr << "The buffers are not recycled" << std::endl;
+    return false;
+  }
+
+  // The exception of the wrapped grabber keeps its type
+  bool end = false;
+  try {
+    g.acquire(I);
+  } catch (const vpFrameGrabberException &e) {
+    end = (e.getStringMessage() == "End of sequence");
+  }
+  if (!end || g.getNbCapturedFrames() != 99 || g.getNbDroppedFrames() != 0) {
+    std::cerr << "Bad end of sequence" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool testDropOldest()
+{
+  CounterGrabber grabber(100);
+  vpFrameGrabberAsync g(grabber, 3, vpFrameGrabberAsync::DROP_OLDEST);
+  vpImage<unsigned char> I;
+  g.open(I);
+
+  // A slow consumer gets increasing frames, the older ones are dropped
+  unsigned int nb_acquired = 0;
+  int last = 0;
+  try {
+    while (true) {
+      g.acquire(I);
+      nb_acquired++;
+      if (I[0][0] <= last) {
+        std::cerr << "Frame " << (unsigned int)I[0][0] << " after frame " << last << std::endl;
+        return false;
+      }
+      last = I[0][0];
+      vpTime::wait(3);
+    }
+  } catch (const vpException &e) {
+    if (e.getStringMessage() != "End of sequence") {
+      throw;
+    }
+  }
+  if (g.getNbCapturedFrames() != 99 || nb_acquired + g.getNbDroppedFrames() != 99) {
+    std::cerr << "Bad statistics: " << g.getNbCapturedFrames() << " captured, " << nb_acquired << " acquired, "
+              << g.getNbDroppedFrames() << " dropped" << std::endl;
+    return false;
+  }
+
+  // The grabber was opened with gray level images
+  vpImage<vpRGBa> I_color;
+  try {
+    g.acquire(I_color);
+    std::cerr << "Color image acquired" << std::endl;
+    return false;
+  } catch (const vpFrameGrabberException &) {
+  }
+
+  return true;
+}
+
+bool testBufferSize()
+{
+  // A single buffer cannot be written while a frame is queued
+  CounterGrabber grabber(1);
+  try {
+    vpFrameGrabberAsync g(grabber, 1);
+    std::cerr << "A single buffer is accepted" << std::endl;
+    return false;
+  } catch (const vpFrameGrabberException &) {
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    if (!testBufferSize() || !testBlock() || !testDropOldest()) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testFrameGrabberAsync is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,242 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the pool of persistent worker threads.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testThreadPool.cpp
+
+  \brief Test the pool of persistent worker threads.
+
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpHistogram.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTrackingException.h>
+
+namespace
+{
+class SquareBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  explicit SquareBody(std::vector<unsigned int> &v) : m_v(v) {}
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    for (unsigned int i = begin; i < end; i++) {
+      m_v[i] = i * i;
+    }
+  }
+
+private:
+  std::vector<unsigned int> &m_v;
+};
+
+// Each row is processed by a nested parallel loop
+class NestedBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  NestedBody(vpThreadPool &pool, std::vector<std::vector<unsigned int> > &rows) : m_pool(pool), m_rows(rows) {}
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    for (unsigned int i = begin; i < end; i++) {
+      m_pool.parallelFor(0, (unsigned int)m_rows[i].size(), SquareBody(m_rows[i]));
+    }
+  }
+
+private:
+  vpThreadPool &m_pool;
+  std::vector<std::vector<unsigned int> > &m_rows;
+};
+
+class CountTask : public vpThreadPool::vpTask
+{
+public:
+  CountTask(unsigned int &counter, vpMutex &mutex) : m_counter(counter), m_mutex(mutex) {}
+
+  void run()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_counter++;
+  }
+
+private:
+  unsigned int &m_counter;
+  vpMutex &m_mutex;
+};
+
+class ThrowTask : public vpThreadPool::vpTask
+{
+public:
+  void run() { throw vpTrackingException(vpTrackingException::fatalError, "Expected failure"); }
+};
+
+bool checkSquares(const std::vector<unsigned int> &v)
+{
+  for (size_t i = 0; i < v.size(); i++) {
+    if (v[i] != i * i) {
+      std::cerr << "Bad value at index " << i << ": " << v[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testPool(vpThreadPool &pool)
+{
+  std::cout << "Test with " << pool.getNumberOfThreads() << " thread(s)" << std::endl;
+
+  // Parallel loop, with the default and an explicit number of chunks
+  std::vector<unsigned int> v(10007, 0);
+  pool.parallelFor(0, (unsigned int)v.size(), SquareBody(v));
+  if (!checkSquares(v)) {
+    return false;
+  }
+
+  std::fill(v.begin(), v.end(), 0);
+  pool.parallelFor(0, (unsigned int)v.size(), SquareBody(v), 3);
+  if (!checkSquares(v)) {
+    return false;
+  }
+
+  // Nested parallel loops
+  std::vector<std::vector<unsigned int> > rows(50, std::vector<unsigned int>(1000, 0));
+  pool.parallelFor(0, (unsigned int)rows.size(), NestedBody(pool, rows));
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (!checkSquares(rows[i])) {
+      return false;
+    }
+  }
+
+  // Task group
+  unsigned int counter = 0;
+  vpMutex mutex;
+  std::vector<CountTask> tasks(100, CountTask(counter, mutex));
+  {
+    vpThreadPool::vpTaskGroup group(pool);
+    for (size_t i = 0; i < tasks.size(); i++) {
+      group.run(tasks[i]);
+    }
+    group.wait();
+  }
+  if (counter != tasks.size()) {
+    std::cerr << "Bad number of executed tasks: " << counter << std::endl;
+    return false;
+  }
+
+  // Exception thrown by a task, it must keep its type
+  ThrowTask throw_task;
+  bool caught = false;
+  try {
+    vpThreadPool::vpTaskGroup group(pool);
+    for (size_t i = 0; i < 10; i++) {
+      group.run(tasks[i]);
+    }
+    group.run(throw_task);
+    group.wait();
+  } catch (const vpTrackingException &e) {
+    caught = (e.getStringMessage() == "Expected failure");
+  } catch (const vpException &e) {
+    std::cerr << "The exception thrown by the task lost its type" << std::endl;
+  }
+  if (!caught) {
+    std::cerr << "The exception thrown by the task was not rethrown" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::cout << "Number of CPUs: " << vpThreadPool::getNumberOfCPUs() << std::endl;
+
+    if (!testPool(vpThreadPool::getInstance())) {
+      return EXIT_FAILURE;
+    }
+
+    vpThreadPool pool(4);
+    if (!testPool(pool)) {
+      return EXIT_FAILURE;
+    }
+
+    pool.setNumberOfThreads(1);
+    if (!testPool(pool)) {
+      return EXIT_FAILURE;
+    }
+
+    // Code paths moved on the shared pool must give the same results
+    vpImage<unsigned char> I(480, 640);
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      I.bitmap[i] = (unsigned char)((i * 7) % 251);
+    }
+
+    vpHistogram histogram_single, histogram_multi;
+    histogram_single.calculate(I, 256, 1);
+    histogram_multi.calculate(I, 256, 4);
+    for (unsigned int i = 0; i < 256; i++) {
+      if (histogram_single[i] != histogram_multi[i]) {
+        std::cerr << "Bad histogram value for bin " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    unsigned char lut[256];
+    for (unsigned int i = 0; i < 256; i++) {
+      lut[i] = (unsigned char)(255 - i);
+    }
+    vpImage<unsigned char> I_single = I, I_multi = I;
+    I_single.performLut(lut, 1);
+    I_multi.performLut(lut, 4);
+    if (I_single != I_multi) {
+      std::cerr << "Bad look-up table result" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testThreadPool is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
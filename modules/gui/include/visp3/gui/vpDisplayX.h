@@ -43,10 +43,16 @@
 #include <visp3/core/vpDisplay.h>
 #ifdef VISP_HAVE_X11
 
+#include <map>
+#include <vector>
+
 // namespace X11name
 //{
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#ifdef VISP_HAVE_X11_XSHM
+#include <X11/extensions/XShm.h>
+#endif
 //#include <X11/Xatom.h>
 //#include <X11/cursorfont.h>
 //} ;
@@ -79,6 +85,15 @@
   It also define method to display some geometric feature (point, line,
 circle) in the image.
 
+  When the X server runs on the same computer and supports the MIT-SHM
+  extension, the images are converted in a buffer shared with the server
+  instead of being sent through the connection. The lines and points drawn
+  with the same color and thickness are sent together when the display is
+  flushed, or before another kind of drawing. To keep the display from
+  slowing down a processing loop, setMaxFrameRate() drops the images that
+  come too early, or before the server has read the previous one, with all
+  the drawings and the flush that follow them.
+
   The example below shows how to display an image with this video device.
   \code
 #include <visp3/core/vpConfig.h>
@@ -167,6 +182,29 @@ private:
   bool ximage_data_init;
   unsigned int RMask, GMask, BMask;
   int RShift, GShift, BShift;
+#ifdef VISP_HAVE_X11_XSHM
+  XShmSegmentInfo m_shmInfo;
+#endif
+  //! True when Ximage is shared with the X server
+  bool m_useShm;
+  //! Event type sent by the server when it has read a shared image
+  int m_shmCompletionType;
+  //! Number of shared images put and not yet read by the server
+  unsigned int m_pendingImages;
+  //! Kind of the primitives waiting to be drawn
+  enum vpBatchType { BATCH_NONE, BATCH_SEGMENTS, BATCH_POINTS };
+  vpBatchType m_batchType;
+  unsigned long m_batchPixel;
+  unsigned int m_batchThickness;
+  int m_batchLineStyle;
+  std::vector<XSegment> m_segments;
+  std::vector<XPoint> m_points;
+  //! Pixel values of the colors that are not predefined
+  std::map<unsigned int, unsigned long> m_pixels;
+  double m_maxFrameRate;
+  double m_lastFrameTime;
+  //! True when the current image and its overlay are not displayed
+  bool m_skipFrame;
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -199,6 +237,13 @@ public:
   virtual ~vpDisplayX();
 
   void getImage(vpImage<vpRGBa> &I);
+  /*!
+    Return the maximal number of images displayed per second, or 0 when
+    every image is displayed.
+
+    \sa setMaxFrameRate()
+  */
+  double getMaxFrameRate() const { return m_maxFrameRate; }
   unsigned int getScreenDepth();
   unsigned int getScreenHeight();
   void getScreenSize(unsigned int &width, unsigned int &height);
@@ -208,6 +253,8 @@ public:
   void init(vpImage<vpRGBa> &I, int winx = -1, int winy = -1, const std::string &title = "");
   void init(unsigned int width, unsigned int height, int winx = -1, int winy = -1, const std::string &title = "");
 
+  void setMaxFrameRate(double fps);
+
 protected:
   void clearDisplay(const vpColor &color = vpColor::white);
 
@@ -260,6 +307,19 @@ protected:
   void setFont(const std::string &font);
   void setTitle(const std::string &title);
   void setWindowPosition(int winx, int winy);
+
+private:
+  void addPoint(unsigned long pixel, int x, int y);
+  void addSegment(unsigned long pixel, unsigned int thickness, int lineStyle, int x1, int y1, int x2, int y2);
+  void clearBatch();
+  void createImage();
+  void destroyImage();
+  void drawBatch();
+  unsigned long getPixel(const vpColor &color);
+  bool isImageBusy();
+  void putImage(int x, int y, unsigned int w, unsigned int h);
+  bool skipFrame();
+  void syncImage();
 };
 
 #endif
@@ -62,6 +62,87 @@
 // math
 #include <visp3/core/vpMath.h>
 
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpTime.h>
+
+#ifdef VISP_HAVE_X11_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Grey level image to 32 bits little endian pixels (B, G, R, A bytes)
+void convertGreyToBGRa(const unsigned char *src, unsigned char *dst, unsigned int size)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && size >= 16) {
+    const __m128i alpha = _mm_set1_epi8((char)vpRGBa::alpha_default);
+    for (; i <= size - 16; i += 16) {
+      const __m128i grey = _mm_loadu_si128((const __m128i *)(src + i));
+      const __m128i gg_lo = _mm_unpacklo_epi8(grey, grey);
+      const __m128i gg_hi = _mm_unpackhi_epi8(grey, grey);
+      const __m128i ga_lo = _mm_unpacklo_epi8(grey, alpha);
+      const __m128i ga_hi = _mm_unpackhi_epi8(grey, alpha);
+      _mm_storeu_si128((__m128i *)(dst + 4 * i), _mm_unpacklo_epi16(gg_lo, ga_lo));
+      _mm_storeu_si128((__m128i *)(dst + 4 * i + 16), _mm_unpackhi_epi16(gg_lo, ga_lo));
+      _mm_storeu_si128((__m128i *)(dst + 4 * i + 32), _mm_unpacklo_epi16(gg_hi, ga_hi));
+      _mm_storeu_si128((__m128i *)(dst + 4 * i + 48), _mm_unpackhi_epi16(gg_hi, ga_hi));
+    }
+  }
+#endif
+  for (; i < size; i++) {
+    dst[4 * i] = src[i];
+    dst[4 * i + 1] = src[i];
+    dst[4 * i + 2] = src[i];
+    dst[4 * i + 3] = vpRGBa::alpha_default;
+  }
+}
+
+// RGBa image to 32 bits little endian pixels (B, G, R, A bytes)
+void convertRGBaToBGRa(const vpRGBa *src, unsigned char *dst, unsigned int size)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && size >= 4) {
+    // Swap the bytes 0 and 2 of each 32 bits pixel
+    const __m128i mask_ag = _mm_set1_epi32((int)0xFF00FF00);
+    const __m128i mask_b = _mm_set1_epi32(0xFF);
+    for (; i <= size - 4; i += 4) {
+      const __m128i rgba = _mm_loadu_si128((const __m128i *)(src + i));
+      const __m128i r = _mm_slli_epi32(_mm_and_si128(rgba, mask_b), 16);
+      const __m128i b = _mm_and_si128(_mm_srli_epi32(rgba, 16), mask_b);
+      _mm_storeu_si128((__m128i *)(dst + 4 * i), _mm_or_si128(_mm_and_si128(rgba, mask_ag), _mm_or_si128(r, b)));
+    }
+  }
+#endif
+  for (; i < size; i++) {
+    dst[4 * i] = src[i].B;
+    dst[4 * i + 1] = src[i].G;
+    dst[4 * i + 2] = src[i].R;
+    dst[4 * i + 3] = src[i].A;
+  }
+}
+
+#ifdef VISP_HAVE_X11_XSHM
+bool shmError = false;
+
+int handleShmError(Display *, XErrorEvent *)
+{
+  shmError = true;
+  return 0;
+}
+#endif
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
 
   Constructor : initialize a display to visualize a gray level image
@@ -86,7 +167,9 @@
 vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
 
@@ -119,7 +202,9 @@ vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, vpScaleType scaleType)
 vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, int x, int y, const std::string &title, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I, x, y, title);
@@ -147,7 +232,9 @@ vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, int x, int y, const std::strin
 vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I);
@@ -177,7 +264,9 @@ vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, vpScaleType scaleType)
 vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, int x, int y, const std::string &title, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I, x, y, title);
@@ -208,7 +297,9 @@ int main()
 vpDisplayX::vpDisplayX(int x, int y, const std::string &title)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
   m_windowXPosition = x;
   m_windowYPosition = y;
@@ -238,7 +329,9 @@ int main()
 vpDisplayX::vpDisplayX()
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), m_useShm(false), m_shmCompletionType(0), m_pendingImages(0), m_batchType(BATCH_NONE), m_batchPixel(0),
+    m_batchThickness(0), m_batchLineStyle(LineSolid), m_segments(), m_points(), m_pixels(), m_maxFrameRate(0),
+    m_lastFrameTime(0), m_skipFrame(false)
 {
 }
 
@@ -659,13 +752,7 @@ void vpDisplayX::init(vpImage<unsigned char> &I, int x, int y, const std::string
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createImage();
   m_displayHasBeenInitialized = true;
 
   XStoreName(display, window, m_title.c_str());
@@ -1091,13 +1178,7 @@ void vpDisplayX::init(vpImage<vpRGBa> &I, int x, int y, const std::string &title
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createImage();
   m_displayHasBeenInitialized = true;
 
   XSync(display, true);
@@ -1542,13 +1623,7 @@ void vpDisplayX::init(unsigned int w, unsigned int h, int x, int y, const std::s
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createImage();
   m_displayHasBeenInitialized = true;
 
   XSync(display, true);
@@ -1620,6 +1695,27 @@ void vpDisplayX::setWindowPosition(int winx, int winy)
   }
 }
 
+/*!
+  Limit the number of images displayed per second.
+
+  An image is dropped, with the drawings and the flush that follow it until
+  the next image, when it comes less than 1/\e fps second after the last
+  displayed image, or when the X server has not yet read the last displayed
+  image from the shared memory. Displaying the images of a processing loop
+  then costs the time of the displayed images only, and never waits for the
+  X server.
+
+  \param fps : Maximal number of images displayed per second. When set to 0,
+  the default, every image is displayed.
+
+  \sa getMaxFrameRate()
+*/
+void vpDisplayX::setMaxFrameRate(double fps)
+{
+  m_maxFrameRate = (fps > 0) ? fps : 0;
+  m_skipFrame = false;
+}
+
 /*!
   Display the gray level image \e I (8bits).
 
@@ -1634,6 +1730,13 @@ void vpDisplayX::setWindowPosition(int winx, int winy)
 void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
 {
   if (m_displayHasBeenInitialized) {
+    if (skipFrame())
+      return;
+
+    // The image erases the overlay
+    clearBatch();
+    syncImage();
+
     switch (screen_depth) {
     case 8: {
       // Correction de l'image de facon a liberer les niveaux de gris
@@ -1670,7 +1773,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1695,7 +1798,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1709,7 +1812,9 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
         unsigned char *n = I.bitmap + size_;
         // for (unsigned int i = 0; i < size; i++) // suppression de
         // l'iterateur i
-        if (XImageByteOrder(display) == 1) {
+        if (XImageByteOrder(display) == LSBFirst && Ximage->bytes_per_line == (int)(4 * m_width)) {
+          convertGreyToBGRa(bitmap, dst_32, size_);
+        } else if (XImageByteOrder(display) == 1) {
           // big endian
           while (bitmap < n) {
             unsigned char val = *(bitmap++);
@@ -1755,7 +1860,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1778,6 +1883,13 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
 void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
 {
   if (m_displayHasBeenInitialized) {
+    if (skipFrame())
+      return;
+
+    // The image erases the overlay
+    clearBatch();
+    syncImage();
+
     switch (screen_depth) {
     case 16: {
       vpRGBa *bitmap = I.bitmap;
@@ -1813,7 +1925,7 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
         }
       }
 
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
 
       break;
@@ -1828,7 +1940,9 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
       if (m_scale == 1) {
         vpRGBa *bitmap = I.bitmap;
         unsigned int sizeI = m_width * m_height;
-        if (XImageByteOrder(display) == 1) {
+        if (XImageByteOrder(display) == LSBFirst && Ximage->bytes_per_line == (int)(4 * m_width)) {
+          convertRGBaToBGRa(bitmap, dst_32, sizeI);
+        } else if (XImageByteOrder(display) == 1) {
           // big endian
           for (unsigned int i = 0; i < sizeI; i++) {
             *(dst_32++) = bitmap->A;
@@ -1874,7 +1988,7 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1900,8 +2014,14 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
 */
 void vpDisplayX::displayImage(const unsigned char *bitmap)
 {
-
   if (m_displayHasBeenInitialized) {
+    if (skipFrame())
+      return;
+
+    // The image erases the overlay
+    clearBatch();
+    syncImage();
+
     unsigned char *dst_32 = (unsigned char *)Ximage->data;
     for (unsigned int i = 0; i < m_width * m_height; i++) {
       *(dst_32++) = *bitmap; // red component.
@@ -1912,7 +2032,7 @@ void vpDisplayX::displayImage(const unsigned char *bitmap)
     }
 
     // Affichage de l'image dans la Pixmap.
-    XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+    putImage(0, 0, m_width, m_height);
     XSetWindowBackgroundPixmap(display, window, pixmap);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
@@ -1938,6 +2058,12 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
                                  const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
+    drawBatch();
+    syncImage();
+
     switch (screen_depth) {
     case 8: {
       // Correction de l'image de facon a liberer les niveaux de gris
@@ -1967,8 +2093,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           i++;
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         // Correction de l'image de facon a liberer les niveaux de gris
         // ROUGE, VERT, BLEU, JAUNE
@@ -1992,7 +2117,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
               dst_8[j] = nivGris;
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       // Affichage de l'image dans la Pixmap.
@@ -2010,8 +2135,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2031,7 +2155,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2081,8 +2205,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2120,7 +2243,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2151,6 +2274,12 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                                  const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
+    drawBatch();
+    syncImage();
+
     switch (screen_depth) {
     case 16: {
       if (m_scale == 1) {
@@ -2167,8 +2296,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                 (((r << 8) >> RShift) & RMask) | (((g << 8) >> GShift) & GMask) | (((b << 8) >> BShift) & BMask);
           }
         }
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         unsigned int bytes_per_line = (unsigned int)Ximage->bytes_per_line;
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
@@ -2193,7 +2321,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                 (((r << 8) >> RShift) & RMask) | (((g << 8) >> GShift) & GMask) | (((b << 8) >> BShift) & BMask);
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2252,8 +2380,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2290,7 +2417,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
             }
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2315,11 +2442,8 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
 void vpDisplayX::closeDisplay()
 {
   if (m_displayHasBeenInitialized) {
-    if (ximage_data_init == true)
-      free(Ximage->data);
-
-    Ximage->data = NULL;
-    XDestroyImage(Ximage);
+    clearBatch();
+    destroyImage();
 
     XFreePixmap(display, pixmap);
 
@@ -2328,6 +2452,8 @@ void vpDisplayX::closeDisplay()
     XCloseDisplay(display);
 
     m_displayHasBeenInitialized = false;
+    m_pixels.clear();
+    m_skipFrame = false;
 
     if (x_color != NULL) {
       delete[] x_color;
@@ -2344,6 +2470,10 @@ void vpDisplayX::closeDisplay()
 void vpDisplayX::flushDisplay()
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
+    drawBatch();
     XClearWindow(display, window);
     XFlush(display);
   } else {
@@ -2361,6 +2491,10 @@ void vpDisplayX::flushDisplay()
 void vpDisplayX::flushDisplayROI(const vpImagePoint &iP, const unsigned int w, const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
+    drawBatch();
     XClearArea(display, window, (int)(iP.get_u() / m_scale), (int)(iP.get_v() / m_scale), w / m_scale, h / m_scale, 0);
     XFlush(display);
   } else {
@@ -2375,6 +2509,7 @@ void vpDisplayX::flushDisplayROI(const vpImagePoint &iP, const unsigned int w, c
 void vpDisplayX::clearDisplay(const vpColor &color)
 {
   if (m_displayHasBeenInitialized) {
+    clearBatch();
 
     if (color.id < vpColor::id_unknown)
       XSetWindowBackground(display, window, x_color[color.id]);
@@ -2458,16 +2593,11 @@ void vpDisplayX::displayArrow(const vpImagePoint &ip1, const vpImagePoint &ip2,
 void vpDisplayX::displayCharString(const vpImagePoint &ip, const char *text, const vpColor &color)
 {
   if (m_displayHasBeenInitialized) {
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    if (m_skipFrame)
+      return;
+
+    drawBatch();
+    XSetForeground(display, context, getPixel(color));
     XDrawString(display, pixmap, context, (int)(ip.get_u() / m_scale), (int)(ip.get_v() / m_scale), text,
                 (int)strlen(text));
   } else {
@@ -2488,18 +2618,13 @@ void vpDisplayX::displayCircle(const vpImagePoint &center, unsigned int radius,
                                unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    drawBatch();
+    XSetForeground(display, context, getPixel(color));
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
@@ -2558,24 +2683,15 @@ void vpDisplayX::displayDotLine(const vpImagePoint &ip1, const vpImagePoint &ip2
                                 unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
 
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
-
-    XSetLineAttributes(display, context, thickness, LineOnOffDash, CapButt, JoinBevel);
-
-    XDrawLine(display, pixmap, context, vpMath::round(ip1.get_u() / m_scale), vpMath::round(ip1.get_v() / m_scale),
-              vpMath::round(ip2.get_u() / m_scale), vpMath::round(ip2.get_v() / m_scale));
+    addSegment(getPixel(color), thickness, LineOnOffDash, vpMath::round(ip1.get_u() / m_scale),
+               vpMath::round(ip1.get_v() / m_scale), vpMath::round(ip2.get_u() / m_scale),
+               vpMath::round(ip2.get_v() / m_scale));
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2591,24 +2707,15 @@ void vpDisplayX::displayLine(const vpImagePoint &ip1, const vpImagePoint &ip2, c
                              unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
 
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
-
-    XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
-
-    XDrawLine(display, pixmap, context, vpMath::round(ip1.get_u() / m_scale), vpMath::round(ip1.get_v() / m_scale),
-              vpMath::round(ip2.get_u() / m_scale), vpMath::round(ip2.get_v() / m_scale));
+    addSegment(getPixel(color), thickness, LineSolid, vpMath::round(ip1.get_u() / m_scale),
+               vpMath::round(ip1.get_v() / m_scale), vpMath::round(ip2.get_u() / m_scale),
+               vpMath::round(ip2.get_v() / m_scale));
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2623,24 +2730,17 @@ void vpDisplayX::displayLine(const vpImagePoint &ip1, const vpImagePoint &ip2, c
 void vpDisplayX::displayPoint(const vpImagePoint &ip, const vpColor &color, unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    if (m_skipFrame)
+      return;
 
     if (thickness == 1) {
-      XDrawPoint(display, pixmap, context, vpMath::round(ip.get_u() / m_scale), vpMath::round(ip.get_v() / m_scale));
+      addPoint(getPixel(color), vpMath::round(ip.get_u() / m_scale), vpMath::round(ip.get_v() / m_scale));
     } else {
+      drawBatch();
+      XSetForeground(display, context, getPixel(color));
       XFillRectangle(display, pixmap, context, vpMath::round(ip.get_u() / m_scale), vpMath::round(ip.get_v() / m_scale),
                      thickness, thickness);
     }
-
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2663,18 +2763,13 @@ void vpDisplayX::displayRectangle(const vpImagePoint &topLeft, unsigned int w, u
                                   bool fill, unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    drawBatch();
+    XSetForeground(display, context, getPixel(color));
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
     if (fill == false) {
       XDrawRectangle(display, pixmap, context, vpMath::round(topLeft.get_u() / m_scale),
@@ -2704,18 +2799,13 @@ void vpDisplayX::displayRectangle(const vpImagePoint &topLeft, const vpImagePoin
                                   bool fill, unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    drawBatch();
+    XSetForeground(display, context, getPixel(color));
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
@@ -2755,18 +2845,13 @@ void vpDisplayX::displayRectangle(const vpImagePoint &topLeft, const vpImagePoin
 void vpDisplayX::displayRectangle(const vpRect &rectangle, const vpColor &color, bool fill, unsigned int thickness)
 {
   if (m_displayHasBeenInitialized) {
+    if (m_skipFrame)
+      return;
+
     if (thickness == 1)
       thickness = 0;
-    if (color.id < vpColor::id_unknown)
-      XSetForeground(display, context, x_color[color.id]);
-    else {
-      xcolor.pad = 0;
-      xcolor.red = 256 * color.R;
-      xcolor.green = 256 * color.G;
-      xcolor.blue = 256 * color.B;
-      XAllocColor(display, lut, &xcolor);
-      XSetForeground(display, context, xcolor.pixel);
-    }
+    drawBatch();
+    XSetForeground(display, context, getPixel(color));
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
@@ -3021,6 +3106,8 @@ bool vpDisplayX::getClickUp(vpImagePoint &ip, vpMouseButton::vpMouseButtonType &
 void vpDisplayX::getImage(vpImage<vpRGBa> &I)
 {
   if (m_displayHasBeenInitialized) {
+    drawBatch();
+
     XImage *xi;
 
     XCopyArea(display, window, pixmap, context, 0, 0, m_width, m_height, 0, 0);
@@ -3316,6 +3403,245 @@ int vpDisplayX::getMsb(unsigned int u32val)
   return i;
 }
 
+/*!
+  Add a point to the points waiting to be drawn, after the primitives of
+  another kind or color.
+*/
+void vpDisplayX::addPoint(unsigned long pixel, int x, int y)
+{
+  if (m_batchType != BATCH_POINTS || m_batchPixel != pixel) {
+    drawBatch();
+    m_batchType = BATCH_POINTS;
+    m_batchPixel = pixel;
+  }
+  XPoint point;
+  point.x = (short)x;
+  point.y = (short)y;
+  m_points.push_back(point);
+}
+
+/*!
+  Add a line to the lines waiting to be drawn, after the primitives of
+  another kind, color or style.
+*/
+void vpDisplayX::addSegment(unsigned long pixel, unsigned int thickness, int lineStyle, int x1, int y1, int x2, int y2)
+{
+  if (m_batchType != BATCH_SEGMENTS || m_batchPixel != pixel || m_batchThickness != thickness ||
+      m_batchLineStyle != lineStyle) {
+    drawBatch();
+    m_batchType = BATCH_SEGMENTS;
+    m_batchPixel = pixel;
+    m_batchThickness = thickness;
+    m_batchLineStyle = lineStyle;
+  }
+  XSegment segment;
+  segment.x1 = (short)x1;
+  segment.y1 = (short)y1;
+  segment.x2 = (short)x2;
+  segment.y2 = (short)y2;
+  m_segments.push_back(segment);
+}
+
+/*!
+  Forget the primitives waiting to be drawn.
+*/
+void vpDisplayX::clearBatch()
+{
+  m_batchType = BATCH_NONE;
+  m_segments.clear();
+  m_points.clear();
+}
+
+/*!
+  Create the image converted for the X server, in memory shared with the
+  server when possible.
+*/
+void vpDisplayX::createImage()
+{
+  Visual *visual = DefaultVisual(display, screen);
+  m_useShm = false;
+  m_pendingImages = 0;
+
+#ifdef VISP_HAVE_X11_XSHM
+  // The attachment fails with a remote X server
+  if (XShmQueryExtension(display)) {
+    Ximage = XShmCreateImage(display, visual, screen_depth, ZPixmap, NULL, &m_shmInfo, m_width, m_height);
+    if (Ximage != NULL) {
+      m_shmInfo.shmid = shmget(IPC_PRIVATE, (size_t)Ximage->bytes_per_line * m_height, IPC_CREAT | 0600);
+      if (m_shmInfo.shmid != -1) {
+        m_shmInfo.shmaddr = (char *)shmat(m_shmInfo.shmid, NULL, 0);
+        if (m_shmInfo.shmaddr != (char *)-1) {
+          m_shmInfo.readOnly = False;
+          Ximage->data = m_shmInfo.shmaddr;
+
+          XSync(display, False);
+          shmError = false;
+          XErrorHandler handler = XSetErrorHandler(handleShmError);
+          Status status = XShmAttach(display, &m_shmInfo);
+          XSync(display, False);
+          XSetErrorHandler(handler);
+          m_useShm = (status != 0) && !shmError;
+
+          if (!m_useShm)
+            shmdt(m_shmInfo.shmaddr);
+        }
+        // The segment is released when detached by both processes
+        shmctl(m_shmInfo.shmid, IPC_RMID, NULL);
+      }
+
+      if (!m_useShm) {
+        Ximage->data = NULL;
+        XDestroyImage(Ximage);
+      }
+    }
+  }
+
+  if (m_useShm) {
+    m_shmCompletionType = XShmGetEventBase(display) + ShmCompletion;
+    ximage_data_init = false;
+    return;
+  }
+#endif
+
+  Ximage = XCreateImage(display, visual, screen_depth, ZPixmap, 0, NULL, m_width, m_height, XBitmapPad(display), 0);
+
+  Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
+  ximage_data_init = true;
+}
+
+/*!
+  Destroy the image created by createImage().
+*/
+void vpDisplayX::destroyImage()
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (m_useShm) {
+    XShmDetach(display, &m_shmInfo);
+    XSync(display, False);
+    Ximage->data = NULL;
+    XDestroyImage(Ximage);
+    shmdt(m_shmInfo.shmaddr);
+    m_useShm = false;
+    m_pendingImages = 0;
+    return;
+  }
+#endif
+
+  if (ximage_data_init == true)
+    free(Ximage->data);
+
+  Ximage->data = NULL;
+  XDestroyImage(Ximage);
+}
+
+/*!
+  Draw the primitives waiting to be drawn in the pixmap, with a single
+  request.
+*/
+void vpDisplayX::drawBatch()
+{
+  if (m_batchType == BATCH_NONE)
+    return;
+
+  XSetForeground(display, context, m_batchPixel);
+  if (m_batchType == BATCH_SEGMENTS) {
+    XSetLineAttributes(display, context, m_batchThickness, m_batchLineStyle, CapButt, JoinBevel);
+    XDrawSegments(display, pixmap, context, &m_segments[0], (int)m_segments.size());
+  } else {
+    XDrawPoints(display, pixmap, context, &m_points[0], (int)m_points.size(), CoordModeOrigin);
+  }
+  clearBatch();
+}
+
+/*!
+  Return the pixel value of a color. The colors that are not predefined are
+  allocated once, since each allocation waits for the X server.
+*/
+unsigned long vpDisplayX::getPixel(const vpColor &color)
+{
+  if (color.id < vpColor::id_unknown)
+    return x_color[color.id];
+
+  const unsigned int rgb = ((unsigned int)color.R << 16) | ((unsigned int)color.G << 8) | color.B;
+  std::map<unsigned int, unsigned long>::const_iterator it = m_pixels.find(rgb);
+  if (it != m_pixels.end())
+    return it->second;
+
+  xcolor.pad = 0;
+  xcolor.red = 256 * color.R;
+  xcolor.green = 256 * color.G;
+  xcolor.blue = 256 * color.B;
+  XAllocColor(display, lut, &xcolor);
+  m_pixels[rgb] = xcolor.pixel;
+  return xcolor.pixel;
+}
+
+/*!
+  Return true when the X server has not yet read all the images put from the
+  shared memory, without waiting for it.
+*/
+bool vpDisplayX::isImageBusy()
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (m_pendingImages > 0) {
+    XEvent completion;
+    while (m_pendingImages > 0 && XCheckTypedEvent(display, m_shmCompletionType, &completion))
+      m_pendingImages--;
+  }
+#endif
+  return m_pendingImages > 0;
+}
+
+/*!
+  Copy a part of the converted image in the pixmap.
+*/
+void vpDisplayX::putImage(int x, int y, unsigned int w, unsigned int h)
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (m_useShm) {
+    // The server reads the shared memory when it processes the request, and
+    // then sends a completion event
+    XShmPutImage(display, pixmap, context, Ximage, x, y, x, y, w, h, True);
+    m_pendingImages++;
+    return;
+  }
+#endif
+  XPutImage(display, pixmap, context, Ximage, x, y, x, y, w, h);
+}
+
+/*!
+  Decide whether the new image, its overlay and its flush are dropped,
+  according to setMaxFrameRate().
+*/
+bool vpDisplayX::skipFrame()
+{
+  m_skipFrame = false;
+  if (m_maxFrameRate > 0) {
+    const double t = vpTime::measureTimeMs();
+    if (t - m_lastFrameTime < 1000. / m_maxFrameRate || isImageBusy())
+      m_skipFrame = true;
+    else
+      m_lastFrameTime = t;
+  }
+  return m_skipFrame;
+}
+
+/*!
+  Wait until the X server has read the shared image, before it is modified.
+*/
+void vpDisplayX::syncImage()
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (m_pendingImages > 0) {
+    XSync(display, False);
+    XEvent completion;
+    while (XCheckTypedEvent(display, m_shmCompletionType, &completion)) {
+    }
+    m_pendingImages = 0;
+  }
+#endif
+}
+
 #elif !defined(VISP_BUILD_SHARED_LIBS)
 // Work arround to avoid warning: libvisp_core.a(vpDisplayX.cpp.o) has no
 // symbols
@@ -241,6 +241,30 @@ struct vpContour {
   }
 };
 
+/*!
+  Contours stored in flat arrays of integer coordinates, in the order they
+  are found by a raster scan of the image.
+*/
+struct vpCompactContours {
+  //! Coordinates of the points of all the contours, as successive (i, j) pairs.
+  std::vector<int> m_points;
+  //! Index of the first point of each contour, followed by the total number of points.
+  std::vector<unsigned int> m_offsets;
+  //! Type of each contour.
+  std::vector<vpContourType> m_types;
+  //! Index of the parent of each contour, -1 for the contours without parent.
+  std::vector<int> m_parents;
+
+  vpCompactContours() : m_points(), m_offsets(1, 0), m_types(), m_parents() {}
+
+  //! Return the number of contours.
+  unsigned int size() const { return (unsigned int)m_types.size(); }
+  //! Return the number of points of contour \e k.
+  unsigned int getNbPoints(unsigned int k) const { return m_offsets[k + 1] - m_offsets[k]; }
+  //! Return the (i, j) coordinates of the points of contour \e k.
+  const int *getPoints(unsigned int k) const { return &m_points[2 * m_offsets[k]]; }
+};
+
 VISP_EXPORT void drawContours(vpImage<unsigned char> &I, const std::vector<std::vector<vpImagePoint> > &contours,
                               unsigned char grayValue = 255);
 VISP_EXPORT void drawContours(vpImage<vpRGBa> &I, const std::vector<std::vector<vpImagePoint> > &contours,
@@ -249,6 +273,9 @@ VISP_EXPORT void drawContours(vpImage<vpRGBa> &I, const std::vector<std::vector<
 VISP_EXPORT void findContours(const vpImage<unsigned char> &I_original, vpContour &contours,
                               std::vector<std::vector<vpImagePoint> > &contourPts,
                               const vpContourRetrievalType &retrievalMode = vp::CONTOUR_RETR_TREE);
+
+VISP_EXPORT void findContours(const vpImage<unsigned char> &I, vpCompactContours &contours,
+                              const vpContourRetrievalType &retrievalMode = vp::CONTOUR_RETR_TREE);
 }
 
 #endif
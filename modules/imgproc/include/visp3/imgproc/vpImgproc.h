@@ -47,6 +47,7 @@
 
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/imgproc/vpContours.h>
 
 #define USE_OLD_FILL_HOLE 0
@@ -124,8 +125,25 @@ VISP_EXPORT void unsharpMask(vpImage<vpRGBa> &I, const unsigned int size = 7, co
 VISP_EXPORT void unsharpMask(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Ires, const unsigned int size = 7,
                              const double weight = 0.6);
 
+/*!
+  \ingroup group_imgproc_connected_components
+
+  Statistics of a connected component.
+*/
+struct vpConnectedComponentStats {
+  unsigned int m_area;     //!< Number of pixels of the component.
+  vpRect m_bbox;           //!< Bounding box, whose size is given in pixels.
+  vpImagePoint m_centroid; //!< Center of gravity of the pixels.
+
+  vpConnectedComponentStats() : m_area(0), m_bbox(), m_centroid() {}
+};
+
+VISP_EXPORT void
+connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                    const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 VISP_EXPORT void
 connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                    std::vector<vpConnectedComponentStats> &stats,
                     const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 
 VISP_EXPORT void fillHoles(vpImage<unsigned char> &I
@@ -41,132 +41,324 @@
   \brief Basic connected components.
 */
 
-#include <queue>
+#include <algorithm>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 namespace
 {
-void getNeighbors(const vpImage<unsigned char> &I, std::queue<vpImagePoint> &listOfNeighbors, const unsigned int i,
-                  const unsigned int j, const vpImageMorphology::vpConnexityType &connexity)
-{
-  unsigned char currValue = I[i][j];
+// Horizontal run of pixels of the same non zero value, end included
+struct Run {
+  unsigned int m_start;
+  unsigned int m_end;
+  unsigned char m_value;
+};
 
-  if (connexity == vpImageMorphology::CONNEXITY_4) {
-    // Top
-    if (I[i - 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i - 1, j));
-    }
+// Runs of a band of rows, labeled with a union-find forest local to the band
+struct Stripe {
+  unsigned int m_firstRow;
+  unsigned int m_lastRow; // excluded
+  std::vector<Run> m_runs;
+  //! Index of the first run of each row, followed by the number of runs
+  std::vector<unsigned int> m_rowOffsets;
+  std::vector<unsigned int> m_parents;
+};
 
-    // Left
-    if (I[i][j - 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j - 1));
+// Return the index of the first pixel from j that differs from value
+unsigned int skipValue(const unsigned char *row, unsigned int j, const unsigned int width, const unsigned char value,
+                       const bool useSSE2)
+{
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    const __m128i v = _mm_set1_epi8((char)value);
+    for (; j + 16 <= width; j += 16) {
+      const __m128i pixels = _mm_loadu_si128((const __m128i *)(row + j));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(pixels, v)) != 0xFFFF) {
+        break;
+      }
     }
+  }
+#else
+  (void)useSSE2;
+#endif
+  while (j < width && row[j] == value) {
+    j++;
+  }
+  return j;
+}
 
-    // Right
-    if (I[i][j + 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j + 1));
-    }
+unsigned int findRoot(std::vector<unsigned int> &parents, unsigned int x)
+{
+  while (parents[x] != x) {
+    parents[x] = parents[parents[x]]; // path halving
+    x = parents[x];
+  }
+  return x;
+}
+
+// The smallest index becomes the root, so that the result does not depend on
+// the order of the unions
+void unite(std::vector<unsigned int> &parents, unsigned int a, unsigned int b)
+{
+  a = findRoot(parents, a);
+  b = findRoot(parents, b);
+  if (a < b) {
+    parents[b] = a;
+  } else if (b < a) {
+    parents[a] = b;
+  }
+}
 
-    // Bottom
-    if (I[i + 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i + 1, j));
+// Unite the runs of a row with the connected runs of the previous row, both
+// given as ranges of indexes in runs and parents
+void linkRows(const std::vector<Run> &runs, std::vector<unsigned int> &parents, unsigned int prev,
+              const unsigned int prev_end, unsigned int cur, const unsigned int cur_end, const unsigned int adjacency)
+{
+  for (; cur < cur_end; cur++) {
+    const Run &run = runs[cur];
+    while (prev < prev_end && runs[prev].m_end + adjacency < run.m_start) {
+      prev++;
     }
-  } else {
-    for (int cpt1 = -1; cpt1 <= 1; cpt1++) {
-      for (int cpt2 = -1; cpt2 <= 1; cpt2++) {
-        // Everything except the current position
-        if (cpt1 != 0 || cpt2 != 0) {
-          if (I[(int)i + cpt1][(int)j + cpt2] == currValue) {
-            listOfNeighbors.push(vpImagePoint((int)i + cpt1, (int)j + cpt2));
-          }
-        }
+    for (unsigned int k = prev; k < prev_end && runs[k].m_start <= run.m_end + adjacency; k++) {
+      if (runs[k].m_value == run.m_value) {
+        unite(parents, k, cur);
       }
     }
   }
 }
 
-void visitNeighbors(vpImage<unsigned char> &I_copy, std::queue<vpImagePoint> &listOfNeighbors, vpImage<int> &labels,
-                    const int current_label, const vpImageMorphology::vpConnexityType &connexity)
+class StripeLabelingBody : public vpThreadPool::vpParallelLoopBody
 {
-  // Visit the neighbors
-  while (!listOfNeighbors.empty()) {
-    vpImagePoint imPt = listOfNeighbors.front();
-    unsigned int i = (unsigned int)imPt.get_i();
-    unsigned int j = (unsigned int)imPt.get_j();
-    listOfNeighbors.pop();
-
-    if (I_copy[i][j]) {
-      getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
-
-      // Reset current position and set label
-      I_copy[i][j] = 0;
-      labels[i][j] = current_label;
+public:
+  StripeLabelingBody(const vpImage<unsigned char> &I, std::vector<Stripe> &stripes, unsigned int adjacency,
+                     bool useSSE2)
+    : m_I(I), m_stripes(stripes), m_adjacency(adjacency), m_useSSE2(useSSE2)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int width = m_I.getWidth();
+    for (unsigned int s = begin; s < end; s++) {
+      Stripe &stripe = m_stripes[s];
+      stripe.m_runs.clear();
+      stripe.m_rowOffsets.clear();
+
+      for (unsigned int i = stripe.m_firstRow; i < stripe.m_lastRow; i++) {
+        stripe.m_rowOffsets.push_back((unsigned int)stripe.m_runs.size());
+        const unsigned char *row = m_I[i];
+        unsigned int j = skipValue(row, 0, width, 0, m_useSSE2);
+        while (j < width) {
+          Run run;
+          run.m_start = j;
+          run.m_value = row[j];
+          j = skipValue(row, j + 1, width, run.m_value, m_useSSE2);
+          run.m_end = j - 1;
+          stripe.m_runs.push_back(run);
+          j = skipValue(row, j, width, 0, m_useSSE2);
+        }
+      }
+      stripe.m_rowOffsets.push_back((unsigned int)stripe.m_runs.size());
+
+      stripe.m_parents.resize(stripe.m_runs.size());
+      for (unsigned int k = 0; k < stripe.m_parents.size(); k++) {
+        stripe.m_parents[k] = k;
+      }
+      for (unsigned int r = 1; r + 1 < stripe.m_rowOffsets.size(); r++) {
+        linkRows(stripe.m_runs, stripe.m_parents, stripe.m_rowOffsets[r - 1], stripe.m_rowOffsets[r],
+                 stripe.m_rowOffsets[r], stripe.m_rowOffsets[r + 1], m_adjacency);
+      }
     }
   }
-}
-} // namespace
 
-/*!
-  \ingroup group_imgproc_connected_components
+private:
+  const vpImage<unsigned char> &m_I;
+  std::vector<Stripe> &m_stripes;
+  unsigned int m_adjacency;
+  bool m_useSSE2;
+};
 
-  Perform connected components detection.
+class StripeWritingBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  StripeWritingBody(const std::vector<Stripe> &stripes, const std::vector<unsigned int> &stripeOffsets,
+                    const std::vector<int> &runLabels, vpImage<int> &labels)
+    : m_stripes(stripes), m_stripeOffsets(stripeOffsets), m_runLabels(runLabels), m_labels(labels)
+  {
+  }
 
-  \param I : Input image (0 means background).
-  \param labels : Label image that contain for each position the component
-  label. \param nbComponents : Number of connected components. \param
-  connexity : Type of connexity.
-*/
-void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
-                             const vpImageMorphology::vpConnexityType &connexity)
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    for (unsigned int s = begin; s < end; s++) {
+      const Stripe &stripe = m_stripes[s];
+      for (unsigned int i = stripe.m_firstRow; i < stripe.m_lastRow; i++) {
+        int *row = m_labels[i];
+        memset(row, 0, sizeof(int) * m_labels.getWidth());
+        const unsigned int r = i - stripe.m_firstRow;
+        for (unsigned int k = stripe.m_rowOffsets[r]; k < stripe.m_rowOffsets[r + 1]; k++) {
+          const Run &run = stripe.m_runs[k];
+          std::fill(row + run.m_start, row + run.m_end + 1, m_runLabels[m_stripeOffsets[s] + k]);
+        }
+      }
+    }
+  }
+
+private:
+  const std::vector<Stripe> &m_stripes;
+  const std::vector<unsigned int> &m_stripeOffsets;
+  const std::vector<int> &m_runLabels;
+  vpImage<int> &m_labels;
+};
+
+void labelComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                     std::vector<vp::vpConnectedComponentStats> *stats,
+                     const vpImageMorphology::vpConnexityType &connexity)
 {
+  nbComponents = 0;
+  if (stats != NULL) {
+    stats->clear();
+  }
   if (I.getSize() == 0) {
     return;
   }
 
   labels.resize(I.getHeight(), I.getWidth());
 
-  vpImage<unsigned char> I_copy(I.getHeight() + 2, I.getWidth() + 2);
-  // Copy and add border
-  for (unsigned int i = 0; i < I_copy.getHeight(); i++) {
-    if (i == 0 || i == I_copy.getHeight() - 1) {
-      memset(I_copy[i], 0, sizeof(unsigned char) * I_copy.getWidth());
+  // Bands of at least 64 rows, a few per thread to balance the load
+  vpThreadPool &pool = vpThreadPool::getInstance();
+  const unsigned int nbStripes =
+      std::max(1u, std::min(4 * pool.getNumberOfThreads(), I.getHeight() / 64));
+  std::vector<Stripe> stripes(nbStripes);
+  for (unsigned int s = 0; s < nbStripes; s++) {
+    stripes[s].m_firstRow = (unsigned int)((unsigned long long)I.getHeight() * s / nbStripes);
+    stripes[s].m_lastRow = (unsigned int)((unsigned long long)I.getHeight() * (s + 1) / nbStripes);
+  }
+
+  const unsigned int adjacency = connexity == vpImageMorphology::CONNEXITY_4 ? 0 : 1;
+  bool useSSE2 = false;
+#if VISP_HAVE_SSE2
+  useSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+  pool.parallelFor(0, nbStripes, StripeLabelingBody(I, stripes, adjacency, useSSE2), nbStripes);
+
+  // Merge the forests of the bands, in the raster order of the runs
+  std::vector<unsigned int> stripeOffsets(nbStripes + 1, 0);
+  for (unsigned int s = 0; s < nbStripes; s++) {
+    stripeOffsets[s + 1] = stripeOffsets[s] + (unsigned int)stripes[s].m_runs.size();
+  }
+  const unsigned int nbRuns = stripeOffsets[nbStripes];
+
+  std::vector<Run> runs;
+  runs.reserve(nbRuns);
+  std::vector<unsigned int> parents(nbRuns);
+  for (unsigned int s = 0; s < nbStripes; s++) {
+    runs.insert(runs.end(), stripes[s].m_runs.begin(), stripes[s].m_runs.end());
+    for (unsigned int k = 0; k < stripes[s].m_parents.size(); k++) {
+      parents[stripeOffsets[s] + k] = stripeOffsets[s] + stripes[s].m_parents[k];
+    }
+  }
+  for (unsigned int s = 1; s < nbStripes; s++) {
+    const std::vector<unsigned int> &prevRows = stripes[s - 1].m_rowOffsets, &curRows = stripes[s].m_rowOffsets;
+    linkRows(runs, parents, stripeOffsets[s - 1] + prevRows[prevRows.size() - 2],
+             stripeOffsets[s - 1] + prevRows.back(), stripeOffsets[s] + curRows[0], stripeOffsets[s] + curRows[1], adjacency);
+  }
+
+  // Components are numbered in the raster order of their first pixel
+  std::vector<int> runLabels(nbRuns, 0);
+  for (unsigned int k = 0; k < nbRuns; k++) {
+    const unsigned int root = findRoot(parents, k);
+    if (root == k) {
+      runLabels[k] = ++nbComponents;
     } else {
-      I_copy[i][0] = 0;
-      memcpy(I_copy[i] + 1, I[i - 1], sizeof(unsigned char) * I.getWidth());
-      I_copy[i][I_copy.getWidth() - 1] = 0;
+      runLabels[k] = runLabels[root];
     }
   }
 
-  vpImage<int> labels_copy(I.getHeight() + 2, I.getWidth() + 2, 0);
+  pool.parallelFor(0, nbStripes, StripeWritingBody(stripes, stripeOffsets, runLabels, labels), nbStripes);
 
-  int current_label = 1;
-  std::queue<vpImagePoint> listOfNeighbors;
+  if (stats != NULL) {
+    stats->resize((size_t)nbComponents);
+    std::vector<double> sum_i((size_t)nbComponents, 0.0), sum_j((size_t)nbComponents, 0.0);
+    std::vector<unsigned int> top(nbComponents), left(nbComponents, I.getWidth()), bottom(nbComponents),
+        right(nbComponents, 0);
+    for (unsigned int s = 0; s < nbStripes; s++) {
+      const Stripe &stripe = stripes[s];
+      for (unsigned int i = stripe.m_firstRow; i < stripe.m_lastRow; i++) {
+        const unsigned int r = i - stripe.m_firstRow;
+        for (unsigned int k = stripe.m_rowOffsets[r]; k < stripe.m_rowOffsets[r + 1]; k++) {
+          const Run &run = stripe.m_runs[k];
+          const unsigned int c = (unsigned int)runLabels[stripeOffsets[s] + k] - 1;
+          const unsigned int length = run.m_end - run.m_start + 1;
+          vp::vpConnectedComponentStats &stat = (*stats)[c];
+          if (stat.m_area == 0) {
+            top[c] = i;
+          }
+          stat.m_area += length;
+          sum_i[c] += (double)i * length;
+          sum_j[c] += (run.m_start + run.m_end) * 0.5 * length;
+          left[c] = std::min(left[c], run.m_start);
+          right[c] = std::max(right[c], run.m_end);
+          bottom[c] = i;
+        }
+      }
+    }
 
-  for (unsigned int cpt1 = 0; cpt1 < I.getHeight(); cpt1++) {
-    unsigned int i = cpt1 + 1;
+    for (unsigned int c = 0; c < (unsigned int)nbComponents; c++) {
+      vp::vpConnectedComponentStats &stat = (*stats)[c];
+      stat.m_bbox = vpRect(left[c], top[c], right[c] - left[c] + 1, bottom[c] - top[c] + 1);
+      stat.m_centroid.set_ij(sum_i[c] / stat.m_area, sum_j[c] / stat.m_area);
+    }
+  }
+}
+} // namespace
 
-    for (unsigned int cpt2 = 0; cpt2 < I.getWidth(); cpt2++) {
-      unsigned int j = cpt2 + 1;
+/*!
+  \ingroup group_imgproc_connected_components
 
-      if (I_copy[i][j] && labels_copy[i][j] == 0) {
-        // Get all the neighbors relative to the current position
-        getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
+  Perform connected components detection.
 
-        // Reset current position and set label
-        I_copy[i][j] = 0;
-        labels_copy[i][j] = current_label;
+  Neighbor pixels of the same non zero value are connected. The image is
+  encoded as horizontal runs of pixels, labeled with a union-find structure
+  by bands of rows processed concurrently on vpThreadPool::getInstance(),
+  that are then merged. The components are numbered from 1 in the raster
+  order of their first pixel.
 
-        visitNeighbors(I_copy, listOfNeighbors, labels_copy, current_label, connexity);
+  \param I : Input image (0 means background).
+  \param labels : Label image that contain for each position the component
+  label. \param nbComponents : Number of connected components. \param
+  connexity : Type of connexity.
+*/
+void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                             const vpImageMorphology::vpConnexityType &connexity)
+{
+  labelComponents(I, labels, nbComponents, NULL, connexity);
+}
 
-        // Increment label
-        current_label++;
-      }
-    }
-  }
+/*!
+  \ingroup group_imgproc_connected_components
 
-  for (unsigned int i = 0; i < labels.getHeight(); i++) {
-    memcpy(labels[i], labels_copy[i + 1] + 1, sizeof(int) * labels.getWidth());
-  }
+  Perform connected components detection, and compute the area, the
+  bounding box and the centroid of each component.
 
-  nbComponents = current_label - 1;
+  \param I : Input image (0 means background).
+  \param labels : Label image that contain for each position the component
+  label.
+  \param nbComponents : Number of connected components.
+  \param stats : Statistics of the components, the ones of the component
+  labeled \e k being stored in \e stats[k-1].
+  \param connexity : Type of connexity.
+*/
+void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                             std::vector<vpConnectedComponentStats> &stats,
+                             const vpImageMorphology::vpConnexityType &connexity)
+{
+  labelComponents(I, labels, nbComponents, &stats, connexity);
 }
@@ -72,154 +72,241 @@
   \brief Basic contours extraction.
 */
 
-#include <map>
+#include <algorithm>
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 namespace
 {
-bool fromTo(const vpImagePoint &from, const vpImagePoint &to, vpDirection &direction)
-{
-  if (from == to) {
-    return false;
-  }
+// Offsets of the 8 neighbors, clockwise from north, in the order of
+// vpDirectionType
+const int dir_i[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+const int dir_j[8] = {0, 1, 1, 1, 0, -1, -1, -1};
 
-  if (std::fabs(from.get_i() - to.get_i()) < std::numeric_limits<double>::epsilon()) {
-    if (from.get_j() < to.get_j()) {
-      direction.m_direction = EAST;
-    } else {
-      direction.m_direction = WEST;
-    }
-  } else if (from.get_i() < to.get_i()) {
-    if (std::fabs(from.get_j() - to.get_j()) < std::numeric_limits<double>::epsilon()) {
-      direction.m_direction = SOUTH;
-    } else if (from.get_j() < to.get_j()) {
-      direction.m_direction = SOUTH_EAST;
-    } else {
-      direction.m_direction = SOUTH_WEST;
-    }
+inline int clockwise(int dir) { return (dir + 1) & 7; }
+inline int counterClockwise(int dir) { return (dir + 7) & 7; }
+
+// Direction of the move from (i1, j1) to (i2, j2)
+int fromTo(int i1, int j1, int i2, int j2)
+{
+  if (i1 == i2) {
+    return j1 < j2 ? EAST : WEST;
+  } else if (i1 < i2) {
+    return j1 == j2 ? SOUTH : (j1 < j2 ? SOUTH_EAST : SOUTH_WEST);
   } else {
-    if (std::fabs(from.get_j() - to.get_j()) < std::numeric_limits<double>::epsilon()) {
-      direction.m_direction = NORTH;
-    } else if (from.get_j() < to.get_j()) {
-      direction.m_direction = NORTH_EAST;
-    } else {
-      direction.m_direction = NORTH_WEST;
-    }
+    return j1 == j2 ? NORTH : (j1 < j2 ? NORTH_EAST : NORTH_WEST);
   }
-
-  return true;
 }
 
-bool crossesEastBorder(const vpImage<int> &I, bool checked[8], const vpImagePoint &point)
+/*
+  Border following of Suzuki and Abe, on a padded image of labels where the
+  pixels are addressed by their offset.
+  Ref: Satoshi Suzuki and others. Topological structural analysis of
+  digitized binary images by border following.
+*/
+class BorderFollower
 {
-  vpDirection direction;
-  if (!fromTo(point, vpImagePoint(point.get_i(), point.get_j() + 1), direction)) {
-    return false;
+public:
+  BorderFollower(vpImage<int> &I, std::vector<int> &points) : m_I(I), m_points(points)
+  {
+    const int w = (int)I.getWidth();
+    for (int d = 0; d < 8; d++) {
+      m_offsets[d] = dir_i[d] * w + dir_j[d];
+    }
   }
 
-  bool b = checked[(int)direction.m_direction];
-
-  if (point.get_i() < 0 || point.get_j() < 0) {
-    return false;
-  }
+  // Follow the border that starts at ij, from its neighbor i2j2
+  void follow(int i, int j, int i2, int j2, int nbd)
+  {
+    const int w = (int)m_I.getWidth();
+    int *const data = m_I.bitmap;
+    const int ij = i * w + j;
 
-  unsigned int i = (unsigned int)point.get_i();
-  unsigned int j = (unsigned int)point.get_j();
+    int dir = fromTo(i, j, i2, j2);
 
-  return I[i][j] != 0 && ((unsigned int)point.get_j() == I.getWidth() - 1 || b);
-}
+    // Find i1j1 (3.1)
+    int trace = clockwise(dir), i1j1 = -1;
+    while (trace != dir) {
+      if (data[ij + m_offsets[trace]] != 0) {
+        i1j1 = ij + m_offsets[trace];
+        break;
+      }
+      trace = clockwise(trace);
+    }
 
-void addContourPoint(vpImage<int> &I, vp::vpContour *border, const vpImagePoint &point, bool checked[8], const int nbd)
-{
-  border->m_points.push_back(vpImagePoint(point.get_i() - 1, point.get_j() - 1)); // remove 1-pixel padding
+    if (i1j1 < 0) {
+      //(3.1) ; single pixel contour
+      return;
+    }
 
-  unsigned int i = (unsigned int)point.get_i();
-  unsigned int j = (unsigned int)point.get_j();
+    // Follow the border keeping the direction from i3j3 to i2j2 instead of
+    // i2j2 itself, to avoid converting offsets back to coordinates
+    int p3 = ij, i3 = i, j3 = j; //(3.2)
+    dir = trace;
+    while (true) {
+      //(3.3)
+      bool checked[8] = {false, false, false, false, false, false, false, false};
+      trace = counterClockwise(dir);
+      int p4 = p3 + m_offsets[trace];
+      while (data[p4] == 0) {
+        checked[trace] = true;
+        trace = counterClockwise(trace);
+        p4 = p3 + m_offsets[trace];
+      }
 
-  if (crossesEastBorder(I, checked, point)) {
-    I[i][j] = -nbd;
-  } else if (I[i][j] == 1) {
-    // Only set if the pixel has not been visited before (3.4) (b)
-    I[i][j] = nbd;
-  } // Otherwise leave it alone
-}
+      //(3.4)
+      m_points.push_back(i3 - 1); // remove 1-pixel padding
+      m_points.push_back(j3 - 1);
+      if (j3 == w - 1 || checked[EAST]) {
+        data[p3] = -nbd;
+      } else if (data[p3] == 1) {
+        // Only set if the pixel has not been visited before (3.4) (b)
+        data[p3] = nbd;
+      } // Otherwise leave it alone
+
+      if (p4 == ij && p3 == i1j1) {
+        //(3.5)
+        break;
+      }
 
-void followBorder(vpImage<int> &I, const vpImagePoint &ij, vpImagePoint &i2j2, vp::vpContour *border, const int nbd)
-{
-  vpDirection dir;
-  if (!fromTo(ij, i2j2, dir)) {
-    throw vpException(vpException::fatalError, "ij == i2j2");
+      //(3.5)
+      p3 = p4;
+      i3 += dir_i[trace];
+      j3 += dir_j[trace];
+      dir = (trace + 4) & 7;
+    }
   }
 
-  vpDirection trace = dir.clockwise();
-  vpImagePoint i1j1(-1, -1);
+private:
+  vpImage<int> &m_I;
+  std::vector<int> &m_points;
+  int m_offsets[8];
+};
 
-  // Find i1j1 (3.1)
-  while (trace.m_direction != dir.m_direction) {
-    vpImagePoint activePixel = trace.active(I, ij);
-
-    if (activePixel.get_i() >= 0 && activePixel.get_j() >= 0) {
-      i1j1 = activePixel;
-      break;
+// Skip the pixels of the padded row that neither start a border nor update
+// LNBD: background pixels and unvisited pixels inside the foreground
+int skipInert(const int *row, int j, const int width, const bool useSSE2)
+{
+#if VISP_HAVE_SSE2
+  if (useSSE2 && j > 0) {
+    const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi32(1);
+    for (; j + 5 <= width; j += 4) {
+      const __m128i pixels = _mm_loadu_si128((const __m128i *)(row + j));
+      const __m128i left = _mm_loadu_si128((const __m128i *)(row + j - 1));
+      const __m128i right = _mm_loadu_si128((const __m128i *)(row + j + 1));
+      const __m128i inside = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(left, zero), _mm_cmpeq_epi32(right, zero)),
+                                              _mm_cmpeq_epi32(pixels, one));
+      if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(pixels, zero), inside)) != 0xFFFF) {
+        break;
+      }
     }
-
-    trace = trace.clockwise();
   }
+#else
+  (void)useSSE2;
+#endif
+  return j;
+}
 
-  if (i1j1.get_i() < 0 || i1j1.get_j() < 0) {
-    //(3.1) ; single pixel contour
-    return;
-  }
+// Extract all the contours with their hierarchy
+void extractContours(const vpImage<unsigned char> &I_original, vp::vpCompactContours &contours)
+{
+  contours.m_points.clear();
+  contours.m_offsets.assign(1, 0);
+  contours.m_types.clear();
+  contours.m_parents.clear();
 
-  i2j2 = i1j1;
-  vpImagePoint i3j3 = ij; //(3.2)
+  // Copy uchar I_original into int I + padding
+  vpImage<int> I(I_original.getHeight() + 2, I_original.getWidth() + 2, 0);
+  for (unsigned int i = 0; i < I_original.getHeight(); i++) {
+    std::copy(I_original[i], I_original[i] + I_original.getWidth(), I[i + 1] + 1);
+  }
 
-  bool checked[8] = {false, false, false, false, false, false, false, false};
+  int nbd = 1;  // Newest border
+  int lnbd = 1; // Last newest border
 
-  while (true) {
-    if (!fromTo(i3j3, i2j2, dir)) {
-      throw vpException(vpException::fatalError, "i3j3 == i2j2");
-    }
+  // Index of the contour of each border number; the background is the hole
+  // contour -1
+  std::vector<int> borderMap(2, -1);
 
-    trace = dir.counterClockwise();
-    vpImagePoint i4j4(-1, -1);
+  bool useSSE2 = false;
+#if VISP_HAVE_SSE2
+  useSSE2 = vpCPUFeatures::checkSSE2();
+#endif
 
-    // Reset checked
-    for (int cpt = 0; cpt < 8; cpt++) {
-      checked[cpt] = false;
-    }
+  BorderFollower follower(I, contours.m_points);
+  const int w = (int)I.getWidth(), h = (int)I.getHeight();
+  for (int i = 0; i < h; i++) {
+    lnbd = 1; // Reset LNBD at the beginning of each scan row
 
-    while (true) {
-      i4j4 = trace.active(I, i3j3); //(3.3)
-      if (i4j4.get_i() >= 0 && i4j4.get_j() >= 0) {
+    int *row = I[i];
+    for (int j = 0; j < w; j++) {
+      j = skipInert(row, j, w, useSSE2);
+      if (j == w) {
         break;
       }
 
-      checked[(int)trace.m_direction] = true;
-      trace = trace.counterClockwise();
-    }
+      int fji = row[j];
+      if (fji == 0) {
+        continue;
+      }
 
-    addContourPoint(I, border, i3j3, checked, nbd);
+      bool isOuter = (fji == 1 && (j == 0 || row[j - 1] == 0));
+      bool isHole = (fji >= 1 && (j == w - 1 || row[j + 1] == 0));
 
-    if (i4j4 == ij && i3j3 == i1j1) {
-      //(3.5)
-      break;
-    }
+      if (isOuter || isHole) { // else (1) (c)
+        nbd++;
+        int from_j = j;
+        vp::vpContourType type;
+        int parent;
 
-    //(3.5)
-    i2j2 = i3j3;
-    i3j3 = i4j4;
-  }
-}
+        if (isOuter) {
+          //(1) (a)
+          from_j = j - 1;
+          type = vp::CONTOUR_OUTER;
+        } else {
+          //(1) (b)
+          if (fji > 1) {
+            lnbd = fji;
+          }
+          from_j = j + 1;
+          type = vp::CONTOUR_HOLE;
+        }
 
-bool isOuterBorderStart(const vpImage<int> &I, unsigned int i, unsigned int j)
-{
-  return (I[i][j] == 1 && (j == 0 || I[i][j - 1] == 0));
-}
+        // Table 1
+        const int borderPrime = borderMap[(size_t)lnbd];
+        const vp::vpContourType typePrime = borderPrime < 0 ? vp::CONTOUR_HOLE : contours.m_types[(size_t)borderPrime];
+        if (typePrime == type) {
+          parent = borderPrime < 0 ? -1 : contours.m_parents[(size_t)borderPrime];
+        } else {
+          parent = borderPrime;
+        }
 
-bool isHoleBorderStart(const vpImage<int> &I, unsigned int i, unsigned int j)
-{
-  return (I[i][j] >= 1 && (j == I.getWidth() - 1 || I[i][j + 1] == 0));
+        follower.follow(i, j, i, from_j, nbd);
+
+        //(3) (1) ; single pixel contour
+        if (contours.m_points.size() == 2 * contours.m_offsets.back()) {
+          contours.m_points.push_back(i - 1); // remove 1-pixel padding
+          contours.m_points.push_back(j - 1);
+          row[j] = -nbd;
+        }
+
+        borderMap.push_back((int)contours.m_types.size());
+        contours.m_types.push_back(type);
+        contours.m_parents.push_back(parent);
+        contours.m_offsets.push_back((unsigned int)(contours.m_points.size() / 2));
+      }
+
+      //(4)
+      if (fji != 0 && fji != 1) {
+        lnbd = std::abs(fji);
+      }
+    }
+  }
 }
 
 void getContoursList(const vp::vpContour &root, const int level, vp::vpContour &contour_list)
@@ -296,6 +383,8 @@ void vp::drawContours(vpImage<vpRGBa> &I, const std::vector<std::vector<vpImageP
   foreground, other values are not allowed). \param contours : Detected
   contours. \param contourPts : List of contours, each contour contains a list
   of contour points. \param retrievalMode : Contour retrieval mode.
+
+  \sa findContours(const vpImage<unsigned char> &, vpCompactContours &, const vpContourRetrievalType &)
 */
 void vp::findContours(const vpImage<unsigned char> &I_original, vpContour &contours,
                       std::vector<std::vector<vpImagePoint> > &contourPts, const vpContourRetrievalType &retrievalMode)
@@ -307,115 +396,27 @@ void vp::findContours(const vpImage<unsigned char> &I_original, vpContour &conto
   // Clear output results
   contourPts.clear();
 
-  // Copy uchar I_original into int I + padding
-  vpImage<int> I(I_original.getHeight() + 2, I_original.getWidth() + 2);
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    if (i == 0 || i == I.getHeight() - 1) {
-      memset(I.bitmap, 0, sizeof(int) * I.getWidth());
-    } else {
-      I[i][0] = 0;
-      for (unsigned int j = 0; j < I_original.getWidth(); j++) {
-        I[i][j + 1] = I_original[i - 1][j];
-      }
-      I[i][I.getWidth() - 1] = 0;
-    }
-  }
-
-  // Ref: http://openimaj.org/
-  // Ref: Satoshi Suzuki and others. Topological structural analysis of
-  // digitized binary images by border following.
-  int nbd = 1;  // Newest border
-  int lnbd = 1; // Last newest border
+  vpCompactContours compact;
+  extractContours(I_original, compact);
 
   // Background contour
   // By default the root contour is a hole contour
   vpContour *root = new vpContour(vp::CONTOUR_HOLE);
 
-  std::map<int, vpContour *> borderMap;
-  borderMap[lnbd] = root;
-
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    lnbd = 1; // Reset LNBD at the beginning of each scan row
-
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      int fji = I[i][j];
-
-      bool isOuter = isOuterBorderStart(I, i, j);
-      bool isHole = isHoleBorderStart(I, i, j);
-
-      if (isOuter || isHole) { // else (1) (c)
-        vpContour *border = new vpContour;
-        vpContour *borderPrime = NULL;
-        vpImagePoint from(i, j);
-
-        if (isOuter) {
-          //(1) (a)
-          nbd++;
-          from.set_j(from.get_j() - 1);
-          border->m_contourType = vp::CONTOUR_OUTER;
-          borderPrime = borderMap[lnbd];
-
-          // Table 1
-          switch (borderPrime->m_contourType) {
-          case vp::CONTOUR_OUTER:
-            border->setParent(borderPrime->m_parent);
-            break;
-
-          case vp::CONTOUR_HOLE:
-            border->setParent(borderPrime);
-            break;
-
-          default:
-            break;
-          }
-        } else {
-          //(1) (b)
-          nbd++;
-
-          if (fji > 1) {
-            lnbd = fji;
-          }
-
-          borderPrime = borderMap[lnbd];
-          from.set_j(from.get_j() + 1);
-          border->m_contourType = vp::CONTOUR_HOLE;
-
-          // Table 1
-          switch (borderPrime->m_contourType) {
-          case vp::CONTOUR_OUTER:
-            border->setParent(borderPrime);
-            break;
-
-          case vp::CONTOUR_HOLE:
-            border->setParent(borderPrime->m_parent);
-            break;
-
-          default:
-            break;
-          }
-        }
-
-        vpImagePoint ij(i, j);
-        followBorder(I, ij, from, border, nbd);
-
-        //(3) (1) ; single pixel contour
-        if (border->m_points.empty()) {
-          border->m_points.push_back(vpImagePoint(ij.get_i() - 1, ij.get_j() - 1)); // remove 1-pixel padding
-          I[i][j] = -nbd;
-        }
-
-        if (retrievalMode == CONTOUR_RETR_LIST || retrievalMode == CONTOUR_RETR_TREE) {
-          // Add contour points
-          contourPts.push_back(border->m_points);
-        }
-
-        borderMap[nbd] = border;
-      }
+  std::vector<vpContour *> borders(compact.size());
+  for (unsigned int k = 0; k < compact.size(); k++) {
+    vpContour *border = new vpContour(compact.m_types[k]);
+    const int *pts = compact.getPoints(k);
+    border->m_points.resize(compact.getNbPoints(k));
+    for (unsigned int n = 0; n < border->m_points.size(); n++) {
+      border->m_points[n].set_ij(pts[2 * n], pts[2 * n + 1]);
+    }
+    border->setParent(compact.m_parents[k] < 0 ? root : borders[(size_t)compact.m_parents[k]]);
+    borders[k] = border;
 
-      //(4)
-      if (fji != 0 && fji != 1) {
-        lnbd = std::abs(fji);
-      }
+    if (retrievalMode == CONTOUR_RETR_LIST || retrievalMode == CONTOUR_RETR_TREE) {
+      // Add contour points
+      contourPts.push_back(border->m_points);
     }
   }
 
@@ -466,3 +467,50 @@ void vp::findContours(const vpImage<unsigned char> &I_original, vpContour &conto
   delete root;
   root = NULL;
 }
+
+/*!
+  \ingroup group_imgproc_contours
+
+  Extract contours from a binary image, as flat arrays of integer
+  coordinates. This is much faster than the extraction in a tree of
+  vpContour with vpImagePoint coordinates, for the same contours in the same
+  order: the k-th contour is the k-th element of the \e contourPts list
+  returned by findContours(const vpImage<unsigned char> &, vpContour &,
+  std::vector<std::vector<vpImagePoint> > &, const vpContourRetrievalType &).
+
+  \param I : Input binary image (0 means background, 1 means foreground,
+  other values are not allowed).
+  \param contours : Detected contours. With CONTOUR_RETR_TREE, the hierarchy
+  is given by the parent indexes; with CONTOUR_RETR_LIST, all the contours
+  are returned without parent; with CONTOUR_RETR_EXTERNAL, only the outer
+  contours without parent are returned.
+  \param retrievalMode : Contour retrieval mode.
+*/
+void vp::findContours(const vpImage<unsigned char> &I, vpCompactContours &contours,
+                      const vpContourRetrievalType &retrievalMode)
+{
+  extractContours(I, contours);
+
+  if (retrievalMode == CONTOUR_RETR_LIST) {
+    contours.m_parents.assign(contours.m_parents.size(), -1);
+  } else if (retrievalMode == CONTOUR_RETR_EXTERNAL) {
+    // Keep the contours of the first level, compacting the arrays in place
+    unsigned int nb = 0, nbPoints = 0;
+    for (unsigned int k = 0; k < contours.size(); k++) {
+      if (contours.m_parents[k] < 0) {
+        const unsigned int first = contours.m_offsets[k], size = contours.getNbPoints(k);
+        std::copy(contours.m_points.begin() + 2 * first, contours.m_points.begin() + 2 * (first + size),
+                  contours.m_points.begin() + 2 * nbPoints);
+        contours.m_types[nb] = contours.m_types[k];
+        contours.m_offsets[nb] = nbPoints;
+        nbPoints += size;
+        nb++;
+      }
+    }
+    contours.m_points.resize(2 * nbPoints);
+    contours.m_types.resize(nb);
+    contours.m_parents.assign(nb, -1);
+    contours.m_offsets.resize(nb + 1);
+    contours.m_offsets[nb] = nbPoints;
+  }
+}
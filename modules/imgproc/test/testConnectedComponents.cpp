@@ -36,6 +36,7 @@
  *
  *****************************************************************************/
 #include <map>
+#include <queue>
 #include <set>
 #include <visp3/core/vpImageTools.h>
 #include <visp3/core/vpIoTools.h>
@@ -55,6 +56,60 @@
 void usage(const char *name, const char *badparam, std::string ipath, std::string opath, std::string user);
 bool getOptions(int argc, const char **argv, std::string &ipath, std::string &opath, std::string user);
 bool checkLabels(const vpImage<int> &label1, const vpImage<int> &label2);
+bool checkStats(const vpImage<int> &labels, const int nbComponents,
+                const std::vector<vp::vpConnectedComponentStats> &stats);
+bool checkFixedLabels(const vpImageMorphology::vpConnexityType connexity, const int *expected,
+                      const int expectedNbComponents);
+void computeReferenceLabels(const vpImage<unsigned char> &I, const vpImageMorphology::vpConnexityType connexity,
+                            vpImage<int> &labels, int &nbComponents);
+bool checkRandomLabels(const vpImageMorphology::vpConnexityType connexity);
+
+namespace
+{
+// 12 x 12 binary image with a ring around a ring, shapes on the image border,
+// diagonal links and an isolated pixel
+const unsigned char image_data[12 * 12] = {
+    255, 255,   0,   0,   0,   0,   0,   0,   0,   0,   0, 255, //
+    255,   0,   0,   0,   0,   0,   0,   0,   0,   0, 255,   0, //
+      0,   0, 255, 255, 255, 255, 255, 255, 255,   0,   0,   0, //
+      0,   0, 255,   0,   0,   0,   0,   0, 255,   0,   0,   0, //
+      0,   0, 255,   0, 255, 255, 255,   0, 255,   0,   0,   0, //
+      0,   0, 255,   0, 255,   0, 255,   0, 255,   0, 255,   0, //
+      0,   0, 255,   0, 255, 255, 255,   0, 255,   0,   0,   0, //
+      0,   0, 255,   0,   0,   0,   0,   0, 255,   0,   0,   0, //
+      0,   0, 255, 255, 255, 255, 255, 255, 255,   0,   0,   0, //
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, //
+    255,   0, 255,   0,   0,   0,   0, 255, 255, 255, 255, 255, //
+      0, 255,   0,   0,   0,   0,   0, 255,   0,   0,   0, 255};
+
+// Expected labels of image_data, numbered in raster scan order
+const int labels_connex4[] = {
+    1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, //
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, //
+    0, 0, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, //
+    0, 0, 4, 0, 0, 0, 0, 0, 4, 0, 0, 0, //
+    0, 0, 4, 0, 5, 5, 5, 0, 4, 0, 0, 0, //
+    0, 0, 4, 0, 5, 0, 5, 0, 4, 0, 6, 0, //
+    0, 0, 4, 0, 5, 5, 5, 0, 4, 0, 0, 0, //
+    0, 0, 4, 0, 0, 0, 0, 0, 4, 0, 0, 0, //
+    0, 0, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, //
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, //
+    7, 0, 8, 0, 0, 0, 0, 9, 9, 9, 9, 9, //
+    0, 10, 0, 0, 0, 0, 0, 9, 0, 0, 0, 9};
+const int labels_connex8[] = {
+    1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, //
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, //
+    0, 0, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, //
+    0, 0, 3, 0, 0, 0, 0, 0, 3, 0, 0, 0, //
+    0, 0, 3, 0, 4, 4, 4, 0, 3, 0, 0, 0, //
+    0, 0, 3, 0, 4, 0, 4, 0, 3, 0, 5, 0, //
+    0, 0, 3, 0, 4, 4, 4, 0, 3, 0, 0, 0, //
+    0, 0, 3, 0, 0, 0, 0, 0, 3, 0, 0, 0, //
+    0, 0, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, //
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, //
+    6, 0, 6, 0, 0, 0, 0, 7, 7, 7, 7, 7, //
+    0, 6, 0, 0, 0, 0, 0, 7, 0, 0, 0, 7};
+}
 
 /*
   Print the program options.
@@ -197,9 +252,162 @@ bool checkLabels(const vpImage<int> &label1, const vpImage<int> &label2)
   return true;
 }
 
+bool checkStats(const vpImage<int> &labels, const int nbComponents,
+                const std::vector<vp::vpConnectedComponentStats> &stats)
+{
+  if (stats.size() != (size_t)nbComponents) {
+    std::cerr << "stats.size() != nbComponents" << std::endl;
+    return false;
+  }
+
+  std::vector<unsigned int> area((size_t)nbComponents, 0);
+  std::vector<double> sum_i((size_t)nbComponents, 0.0), sum_j((size_t)nbComponents, 0.0);
+  std::vector<unsigned int> top((size_t)nbComponents, labels.getHeight()), bottom((size_t)nbComponents, 0);
+  std::vector<unsigned int> left((size_t)nbComponents, labels.getWidth()), right((size_t)nbComponents, 0);
+  for (unsigned int i = 0; i < labels.getHeight(); i++) {
+    for (unsigned int j = 0; j < labels.getWidth(); j++) {
+      if (labels[i][j] > 0) {
+        size_t k = (size_t)(labels[i][j] - 1);
+        area[k]++;
+        sum_i[k] += i;
+        sum_j[k] += j;
+        top[k] = std::min(top[k], i);
+        bottom[k] = std::max(bottom[k], i);
+        left[k] = std::min(left[k], j);
+        right[k] = std::max(right[k], j);
+      }
+    }
+  }
+
+  for (size_t k = 0; k < stats.size(); k++) {
+    const vpRect &bbox = stats[k].m_bbox;
+    if (stats[k].m_area != area[k] || bbox.getLeft() != left[k] || bbox.getTop() != top[k] ||
+        bbox.getRight() != right[k] || bbox.getBottom() != bottom[k] ||
+        std::fabs(stats[k].m_centroid.get_i() - sum_i[k] / area[k]) > 1e-6 ||
+        std::fabs(stats[k].m_centroid.get_j() - sum_j[k] / area[k]) > 1e-6) {
+      std::cerr << "Wrong statistics for component " << k + 1 << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+  Compare the labels of image_data and their statistics with the expected
+  labels.
+*/
+bool checkFixedLabels(const vpImageMorphology::vpConnexityType connexity, const int *expected,
+                      const int expectedNbComponents)
+{
+  vpImage<unsigned char> I(12, 12);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = image_data[i];
+  }
+
+  vpImage<int> labels;
+  int nbComponents = 0;
+  vp::connectedComponents(I, labels, nbComponents, connexity);
+  if (nbComponents != expectedNbComponents) {
+    std::cerr << nbComponents << " components instead of " << expectedNbComponents << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < labels.getSize(); i++) {
+    if (labels.bitmap[i] != expected[i]) {
+      std::cerr << "Label " << labels.bitmap[i] << " instead of " << expected[i] << " at (" << i / labels.getWidth()
+                << ", " << i % labels.getWidth() << ")" << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<vp::vpConnectedComponentStats> stats;
+  vpImage<int> labels_stats;
+  vp::connectedComponents(I, labels_stats, nbComponents, stats, connexity);
+  return labels_stats == labels && checkStats(labels_stats, nbComponents, stats);
+}
+
+/*
+  Reference labeling: flood fill each component from its first pixel in the
+  raster scan order.
+*/
+void computeReferenceLabels(const vpImage<unsigned char> &I, const vpImageMorphology::vpConnexityType connexity,
+                            vpImage<int> &labels, int &nbComponents)
+{
+  labels.resize(I.getHeight(), I.getWidth(), 0);
+  nbComponents = 0;
+  const int height = (int)I.getHeight(), width = (int)I.getWidth();
+  for (int i0 = 0; i0 < height; i0++) {
+    for (int j0 = 0; j0 < width; j0++) {
+      if (I[i0][j0] == 0 || labels[i0][j0] != 0) {
+        continue;
+      }
+
+      nbComponents++;
+      labels[i0][j0] = nbComponents;
+      std::queue<std::pair<int, int> > queue;
+      queue.push(std::make_pair(i0, j0));
+      while (!queue.empty()) {
+        const int i = queue.front().first, j = queue.front().second;
+        queue.pop();
+        for (int di = -1; di <= 1; di++) {
+          for (int dj = -1; dj <= 1; dj++) {
+            const int ni = i + di, nj = j + dj;
+            if ((di == 0 && dj == 0) || (connexity == vpImageMorphology::CONNEXITY_4 && di != 0 && dj != 0) ||
+                ni < 0 || ni >= height || nj < 0 || nj >= width) {
+              continue;
+            }
+            if (I[ni][nj] != 0 && labels[ni][nj] == 0) {
+              labels[ni][nj] = nbComponents;
+              queue.push(std::make_pair(ni, nj));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+  Compare the labels of a pseudo-random image, tall enough to be split in
+  several bands and wide enough for the SIMD code, with the reference
+  labeling.
+*/
+bool checkRandomLabels(const vpImageMorphology::vpConnexityType connexity)
+{
+  vpImage<unsigned char> I(300, 77);
+  unsigned int seed = 12345;
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    // Sparse and dense rows, to have long background runs and large components
+    const unsigned int density = 20 + 50 * ((i / 40) % 2);
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      seed = seed * 1103515245u + 12345u;
+      I[i][j] = ((seed >> 16) % 100 < density) ? 255 : 0;
+    }
+  }
+
+  vpImage<int> labels, labels_reference;
+  int nbComponents = 0, nbComponents_reference = 0;
+  vp::connectedComponents(I, labels, nbComponents, connexity);
+  computeReferenceLabels(I, connexity, labels_reference, nbComponents_reference);
+  if (nbComponents != nbComponents_reference || !(labels == labels_reference)) {
+    std::cerr << "Wrong labels of the random image: " << nbComponents << " components instead of "
+              << nbComponents_reference << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 int main(int argc, const char **argv)
 {
   try {
+    // Check the labels of generated images, without the input images
+    if (!checkFixedLabels(vpImageMorphology::CONNEXITY_4, labels_connex4, 10) ||
+        !checkFixedLabels(vpImageMorphology::CONNEXITY_8, labels_connex8, 7) ||
+        !checkRandomLabels(vpImageMorphology::CONNEXITY_4) || !checkRandomLabels(vpImageMorphology::CONNEXITY_8)) {
+      return EXIT_FAILURE;
+    }
+
     std::string env_ipath;
     std::string opt_ipath;
     std::string opt_opath;
@@ -306,6 +514,17 @@ int main(int argc, const char **argv)
     std::cout << "Time: " << t << " ms" << std::endl;
     std::cout << "nbComponents=" << nbComponents << std::endl;
 
+    std::vector<vp::vpConnectedComponentStats> stats;
+    vpImage<int> labels_stats;
+    t = vpTime::measureTimeMs();
+    vp::connectedComponents(I, labels_stats, nbComponents, stats, vpImageMorphology::CONNEXITY_8);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "\n8-connexity connected components with statistics:" << std::endl;
+    std::cout << "Time: " << t << " ms" << std::endl;
+    if (!(labels_stats == labels_connex8) || !checkStats(labels_stats, nbComponents, stats)) {
+      throw vpException(vpException::fatalError, "Wrong connected components statistics");
+    }
+
     // Save results
     vpImage<vpRGBa> labels_connex4_color(labels_connex4.getHeight(), labels_connex4.getWidth(), vpRGBa(0, 0, 0, 0));
     for (unsigned int i = 0; i < labels_connex4.getHeight(); i++) {
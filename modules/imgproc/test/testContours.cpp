@@ -55,6 +55,147 @@
 
 void usage(const char *name, const char *badparam, std::string ipath, std::string opath, std::string user);
 bool getOptions(int argc, const char **argv, std::string &ipath, std::string &opath, std::string user);
+bool checkCompactContours(const vp::vpCompactContours &compact_contours,
+                          const std::vector<std::vector<vpImagePoint> > &contours);
+vpImage<unsigned char> toImage(const unsigned char *data, unsigned int height, unsigned int width);
+bool checkContours(const vpImage<unsigned char> &I, const vp::vpContourRetrievalType retrievalMode, const int *expected,
+                   const std::string &name, const int offset_i = 0, const int offset_j = 0);
+bool testContoursFixedImages();
+
+namespace
+{
+// 14 x 10 binary image with nested contours
+const unsigned char image1_data[14 * 10] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1,
+    1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// 12 x 12 binary image with a ring around a ring, shapes on the image border,
+// diagonal links and an isolated pixel
+const unsigned char image2_data[12 * 12] = {
+    1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, //
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, //
+    0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, //
+    0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, //
+    0, 0, 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, //
+    0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, //
+    0, 0, 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, //
+    0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, //
+    0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, //
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, //
+    1, 0, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, //
+    0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1};
+
+// Expected contours, in raster scan order: the number of contours, then for
+// each contour its type (0: outer, 1: hole), the index of its parent (-1 if
+// none), its number of points and its (i, j) points. In these images, the
+// raster scan order is also the depth-first order of the hierarchy.
+const int contours1_tree[] = {5,
+    0, -1, 20, // contour 0
+    1, 2, 2, 1, 2, 2, 3, 3, 4, 2, 5, 2, 6, 3, 6, 4, 6, 5, 5, 6, 4, 5, 3, 6, 3, 7, 4, 8, 3, 7, 2, 6, 1, 6, 2, 5,
+    2, 4, 1, 3,
+    1, 0, 9, // contour 1
+    4, 2, 3, 3, 3, 4, 4, 5, 5, 6, 6, 5, 6, 4, 6, 3, 5, 2,
+    0, -1, 13, // contour 2
+    8, 2, 9, 2, 10, 2, 11, 2, 12, 3, 11, 4, 11, 5, 12, 6, 11, 7, 10, 6, 9, 5, 9, 4, 9, 3,
+    1, 2, 9, // contour 3
+    10, 2, 9, 3, 9, 4, 9, 5, 10, 6, 11, 5, 11, 4, 12, 3, 11, 2,
+    1, 2, 4, // contour 4
+    11, 5, 10, 6, 11, 7, 12, 6
+};
+const int contours1_list[] = {5,
+    0, -1, 20, // contour 0
+    1, 2, 2, 1, 2, 2, 3, 3, 4, 2, 5, 2, 6, 3, 6, 4, 6, 5, 5, 6, 4, 5, 3, 6, 3, 7, 4, 8, 3, 7, 2, 6, 1, 6, 2, 5,
+    2, 4, 1, 3,
+    1, -1, 9, // contour 1
+    4, 2, 3, 3, 3, 4, 4, 5, 5, 6, 6, 5, 6, 4, 6, 3, 5, 2,
+    0, -1, 13, // contour 2
+    8, 2, 9, 2, 10, 2, 11, 2, 12, 3, 11, 4, 11, 5, 12, 6, 11, 7, 10, 6, 9, 5, 9, 4, 9, 3,
+    1, -1, 9, // contour 3
+    10, 2, 9, 3, 9, 4, 9, 5, 10, 6, 11, 5, 11, 4, 12, 3, 11, 2,
+    1, -1, 4, // contour 4
+    11, 5, 10, 6, 11, 7, 12, 6
+};
+const int contours1_external[] = {2,
+    0, -1, 20, // contour 0
+    1, 2, 2, 1, 2, 2, 3, 3, 4, 2, 5, 2, 6, 3, 6, 4, 6, 5, 5, 6, 4, 5, 3, 6, 3, 7, 4, 8, 3, 7, 2, 6, 1, 6, 2, 5,
+    2, 4, 1, 3,
+    0, -1, 13, // contour 1
+    8, 2, 9, 2, 10, 2, 11, 2, 12, 3, 11, 4, 11, 5, 12, 6, 11, 7, 10, 6, 9, 5, 9, 4, 9, 3
+};
+const int contours2_tree[] = {9,
+    0, -1, 3, // contour 0
+    0, 0, 1, 0, 0, 1,
+    0, -1, 2, // contour 1
+    0, 11, 1, 10,
+    0, -1, 24, // contour 2
+    2, 2, 3, 2, 4, 2, 5, 2, 6, 2, 7, 2, 8, 2, 8, 3, 8, 4, 8, 5, 8, 6, 8, 7, 8, 8, 7, 8, 6, 8, 5, 8, 4, 8, 3, 8,
+    2, 8, 2, 7, 2, 6, 2, 5, 2, 4, 2, 3,
+    1, 2, 20, // contour 3
+    3, 2, 2, 3, 2, 4, 2, 5, 2, 6, 2, 7, 3, 8, 4, 8, 5, 8, 6, 8, 7, 8, 8, 7, 8, 6, 8, 5, 8, 4, 8, 3, 7, 2, 6, 2,
+    5, 2, 4, 2,
+    0, 3, 8, // contour 4
+    4, 4, 5, 4, 6, 4, 6, 5, 6, 6, 5, 6, 4, 6, 4, 5,
+    1, 4, 4, // contour 5
+    5, 4, 4, 5, 5, 6, 6, 5,
+    0, -1, 1, // contour 6
+    5, 10,
+    0, -1, 4, // contour 7
+    10, 0, 11, 1, 10, 2, 11, 1,
+    0, -1, 10, // contour 8
+    10, 7, 11, 7, 10, 8, 10, 9, 10, 10, 11, 11, 10, 11, 10, 10, 10, 9, 10, 8
+};
+const int contours2_list[] = {9,
+    0, -1, 3, // contour 0
+    0, 0, 1, 0, 0, 1,
+    0, -1, 2, // contour 1
+    0, 11, 1, 10,
+    0, -1, 24, // contour 2
+    2, 2, 3, 2, 4, 2, 5, 2, 6, 2, 7, 2, 8, 2, 8, 3, 8, 4, 8, 5, 8, 6, 8, 7, 8, 8, 7, 8, 6, 8, 5, 8, 4, 8, 3, 8,
+    2, 8, 2, 7, 2, 6, 2, 5, 2, 4, 2, 3,
+    1, -1, 20, // contour 3
+    3, 2, 2, 3, 2, 4, 2, 5, 2, 6, 2, 7, 3, 8, 4, 8, 5, 8, 6, 8, 7, 8, 8, 7, 8, 6, 8, 5, 8, 4, 8, 3, 7, 2, 6, 2,
+    5, 2, 4, 2,
+    0, -1, 8, // contour 4
+    4, 4, 5, 4, 6, 4, 6, 5, 6, 6, 5, 6, 4, 6, 4, 5,
+    1, -1, 4, // contour 5
+    5, 4, 4, 5, 5, 6, 6, 5,
+    0, -1, 1, // contour 6
+    5, 10,
+    0, -1, 4, // contour 7
+    10, 0, 11, 1, 10, 2, 11, 1,
+    0, -1, 10, // contour 8
+    10, 7, 11, 7, 10, 8, 10, 9, 10, 10, 11, 11, 10, 11, 10, 10, 10, 9, 10, 8
+};
+const int contours2_external[] = {6,
+    0, -1, 3, // contour 0
+    0, 0, 1, 0, 0, 1,
+    0, -1, 2, // contour 1
+    0, 11, 1, 10,
+    0, -1, 24, // contour 2
+    2, 2, 3, 2, 4, 2, 5, 2, 6, 2, 7, 2, 8, 2, 8, 3, 8, 4, 8, 5, 8, 6, 8, 7, 8, 8, 7, 8, 6, 8, 5, 8, 4, 8, 3, 8,
+    2, 8, 2, 7, 2, 6, 2, 5, 2, 4, 2, 3,
+    0, -1, 1, // contour 3
+    5, 10,
+    0, -1, 4, // contour 4
+    10, 0, 11, 1, 10, 2, 11, 1,
+    0, -1, 10, // contour 5
+    10, 7, 11, 7, 10, 8, 10, 9, 10, 10, 11, 11, 10, 11, 10, 10, 10, 9, 10, 8
+};
+
+// Flatten the hierarchy in depth-first order, with the index of the parent of each contour
+void flattenContours(const vp::vpContour &contour, const int parent, std::vector<const vp::vpContour *> &flat,
+                     std::vector<int> &parents)
+{
+  for (std::vector<vp::vpContour *>::const_iterator it = contour.m_children.begin(); it != contour.m_children.end();
+       ++it) {
+    flat.push_back(*it);
+    parents.push_back(parent);
+    flattenContours(**it, (int)flat.size() - 1, flat, parents);
+  }
+}
+}
 
 /*
   Print the program options.
@@ -184,9 +325,133 @@ void displayContourInfo(const vp::vpContour &contour, const int level)
   }
 }
 
+bool checkCompactContours(const vp::vpCompactContours &compact_contours,
+                          const std::vector<std::vector<vpImagePoint> > &contours)
+{
+  if (compact_contours.size() != contours.size()) {
+    std::cerr << "compact_contours.size() != contours.size()" << std::endl;
+    return false;
+  }
+
+  for (unsigned int k = 0; k < compact_contours.size(); k++) {
+    const int *points = compact_contours.getPoints(k);
+    if (compact_contours.getNbPoints(k) != contours[k].size()) {
+      std::cerr << "compact_contours.getNbPoints(" << k << ") != contours[" << k << "].size()" << std::endl;
+      return false;
+    }
+
+    for (unsigned int n = 0; n < compact_contours.getNbPoints(k); n++) {
+      if (points[2 * n] != (int)contours[k][n].get_i() || points[2 * n + 1] != (int)contours[k][n].get_j()) {
+        std::cerr << "Contour " << k << " differs at point " << n << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+vpImage<unsigned char> toImage(const unsigned char *data, unsigned int height, unsigned int width)
+{
+  vpImage<unsigned char> I(height, width);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = data[i];
+  }
+  return I;
+}
+
+/*
+  Compare the contours of I extracted with the vpContour and with the
+  vpCompactContours overloads with the expected contours, translated by
+  (offset_i, offset_j).
+*/
+bool checkContours(const vpImage<unsigned char> &I, const vp::vpContourRetrievalType retrievalMode, const int *expected,
+                   const std::string &name, const int offset_i, const int offset_j)
+{
+  vp::vpContour vp_contours;
+  std::vector<std::vector<vpImagePoint> > contours;
+  vp::findContours(I, vp_contours, contours, retrievalMode);
+  std::vector<const vp::vpContour *> flat;
+  std::vector<int> parents;
+  flattenContours(vp_contours, -1, flat, parents);
+
+  vp::vpCompactContours compact_contours;
+  vp::findContours(I, compact_contours, retrievalMode);
+
+  const unsigned int nbContours = (unsigned int)expected[0];
+  if (contours.size() != nbContours || flat.size() != nbContours || compact_contours.size() != nbContours) {
+    std::cerr << name << ": " << contours.size() << ", " << flat.size() << " and " << compact_contours.size()
+              << " contours instead of " << nbContours << std::endl;
+    return false;
+  }
+
+  const int *ptr = expected + 1;
+  for (unsigned int k = 0; k < nbContours; k++) {
+    const vp::vpContourType type = ptr[0] == 0 ? vp::CONTOUR_OUTER : vp::CONTOUR_HOLE;
+    const int parent = ptr[1];
+    const unsigned int nbPoints = (unsigned int)ptr[2];
+    const int *points = ptr + 3;
+    ptr += 3 + 2 * nbPoints;
+
+    if (flat[k]->m_contourType != type || compact_contours.m_types[k] != type) {
+      std::cerr << name << ": wrong type of contour " << k << std::endl;
+      return false;
+    }
+    if (parents[k] != parent || compact_contours.m_parents[k] != parent) {
+      std::cerr << name << ": wrong parent of contour " << k << std::endl;
+      return false;
+    }
+    if (contours[k].size() != nbPoints || flat[k]->m_points.size() != nbPoints ||
+        compact_contours.getNbPoints(k) != nbPoints) {
+      std::cerr << name << ": wrong number of points in contour " << k << std::endl;
+      return false;
+    }
+
+    const int *compact_points = compact_contours.getPoints(k);
+    for (unsigned int n = 0; n < nbPoints; n++) {
+      const int i = points[2 * n] + offset_i, j = points[2 * n + 1] + offset_j;
+      const vpImagePoint ip(i, j);
+      if (contours[k][n] != ip || flat[k]->m_points[n] != ip || compact_points[2 * n] != i ||
+          compact_points[2 * n + 1] != j) {
+        std::cerr << name << ": contour " << k << " differs at point " << n << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/*
+  Check the contours of small binary images in the three retrieval modes, and
+  of the second image inside a larger one.
+*/
+bool testContoursFixedImages()
+{
+  const vpImage<unsigned char> I1 = toImage(image1_data, 14, 10), I2 = toImage(image2_data, 12, 12);
+  vpImage<unsigned char> I3(40, 45, 0);
+  for (unsigned int i = 0; i < I2.getHeight(); i++) {
+    for (unsigned int j = 0; j < I2.getWidth(); j++) {
+      I3[i + 14][j + 20] = I2[i][j];
+    }
+  }
+  return checkContours(I1, vp::CONTOUR_RETR_TREE, contours1_tree, "image 1, tree") &&
+         checkContours(I1, vp::CONTOUR_RETR_LIST, contours1_list, "image 1, list") &&
+         checkContours(I1, vp::CONTOUR_RETR_EXTERNAL, contours1_external, "image 1, external") &&
+         checkContours(I2, vp::CONTOUR_RETR_TREE, contours2_tree, "image 2, tree") &&
+         checkContours(I2, vp::CONTOUR_RETR_LIST, contours2_list, "image 2, list") &&
+         checkContours(I2, vp::CONTOUR_RETR_EXTERNAL, contours2_external, "image 2, external") &&
+         checkContours(I3, vp::CONTOUR_RETR_TREE, contours2_tree, "image 2 in a larger image", 14, 20);
+}
+
 int main(int argc, const char **argv)
 {
   try {
+    // Check the contours of small images, without the input images
+    if (!testContoursFixedImages()) {
+      return EXIT_FAILURE;
+    }
+
     std::string env_ipath;
     std::string opt_ipath;
     std::string opt_opath;
@@ -267,13 +532,7 @@ int main(int argc, const char **argv)
     // Here starts really the test
     //
 
-    unsigned char image_data[14 * 10] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1,
-        1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0,
-        0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-    vpImage<unsigned char> I_test_data(image_data, 14, 10, true);
+    vpImage<unsigned char> I_test_data = toImage(image1_data, 14, 10);
     std::cout << "Test with image data:" << std::endl;
     printImage(I_test_data, "I_test_data");
 
@@ -286,6 +545,12 @@ int main(int argc, const char **argv)
     displayContourInfo(vp_contours, 0);
     std::cout << "ViSP: nb contours=" << contours.size() << " ; t=" << t << " ms" << std::endl;
 
+    vp::vpCompactContours compact_contours;
+    vp::findContours(I_test_data, compact_contours);
+    if (!checkCompactContours(compact_contours, contours)) {
+      throw vpException(vpException::fatalError, "Compact contours differ from vpContour contours");
+    }
+
     // Read Klimt.ppm
     filename = vpIoTools::createFilePath(ipath, "Klimt/Klimt.pgm");
     vpImage<unsigned char> I;
@@ -309,6 +574,14 @@ int main(int argc, const char **argv)
     std::cout << "\nTest with Klimt image:" << std::endl;
     std::cout << "ViSP: nb contours=" << contours.size() << " ; t=" << t << " ms" << std::endl;
 
+    t = vpTime::measureTimeMs();
+    vp::findContours(I, compact_contours);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "ViSP compact contours: nb contours=" << compact_contours.size() << " ; t=" << t << " ms" << std::endl;
+    if (!checkCompactContours(compact_contours, contours)) {
+      throw vpException(vpException::fatalError, "Compact contours differ from vpContour contours");
+    }
+
     // Draw and save
     vpImage<unsigned char> I_draw_contours(I2.getHeight(), I2.getWidth(), 0);
     vp::drawContours(I_draw_contours, contours);
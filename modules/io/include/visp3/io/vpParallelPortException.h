@@ -99,6 +99,9 @@ public:
   }
   vpParallelPortException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpParallelPortException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpParallelPortException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
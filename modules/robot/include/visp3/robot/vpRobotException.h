@@ -134,6 +134,9 @@ public:
   }
   vpRobotException(const int id, const std::string &msg) : vpException(id, msg) {}
   explicit vpRobotException(const int id) : vpException(id) {}
+
+  vpException *clone() const { return new vpRobotException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
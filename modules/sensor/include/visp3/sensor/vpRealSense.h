@@ -48,6 +48,7 @@
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpMatrix.h>
 
 #if defined(VISP_HAVE_REALSENSE) && defined(VISP_HAVE_CPP11_COMPATIBILITY)
 
@@ -337,12 +338,14 @@ public:
   virtual ~vpRealSense();
 
   void acquire(std::vector<vpColVector> &pointcloud);
+  void acquire(vpMatrix &pointcloud);
 #ifdef VISP_HAVE_PCL
   void acquire(pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
   void acquire(pcl::PointCloud<pcl::PointXYZRGB>::Ptr &pointcloud);
 #endif
   void acquire(vpImage<unsigned char> &grey); // tested
   void acquire(vpImage<unsigned char> &grey, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<unsigned char> &grey, vpMatrix &pointcloud);
   void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth,
                std::vector<vpColVector> &pointcloud);
 #ifdef VISP_HAVE_PCL
@@ -355,6 +358,7 @@ public:
 
   void acquire(vpImage<vpRGBa> &color); // tested
   void acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<vpRGBa> &color, vpMatrix &pointcloud);
   void acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth,
                std::vector<vpColVector> &pointcloud);
 
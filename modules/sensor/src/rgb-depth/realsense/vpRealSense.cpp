@@ -412,6 +412,31 @@ void vpRealSense::acquire(vpImage<unsigned char> &grey, std::vector<vpColVector>
   vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
 }
 
+/*!
+  Acquire data from RealSense device.
+  \param grey : Greyscale image.
+  \param pointcloud : Point cloud data as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix
+  is not reallocated when its size does not change between two acquisitions.
+ */
+void vpRealSense::acquire(vpImage<unsigned char> &grey, vpMatrix &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (!m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve grey image
+  vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
+}
+
 /*!
   Acquire data from RealSense device.
   \param pointcloud : Point cloud data as a vector of column vectors. Each
@@ -433,6 +458,27 @@ void vpRealSense::acquire(std::vector<vpColVector> &pointcloud)
   vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
 }
 
+/*!
+  Acquire data from RealSense device.
+  \param pointcloud : Point cloud data as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix
+  is not reallocated when its size does not change between two acquisitions.
+ */
+void vpRealSense::acquire(vpMatrix &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (!m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
+}
+
 /*!
   Acquire data from RealSense device.
   \param color : Color image.
@@ -545,6 +591,31 @@ void vpRealSense::acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &poin
   vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
 }
 
+/*!
+  Acquire data from RealSense device.
+  \param color : Color image.
+  \param pointcloud : Point cloud data as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix
+  is not reallocated when its size does not change between two acquisitions.
+ */
+void vpRealSense::acquire(vpImage<vpRGBa> &color, vpMatrix &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (!m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve color image
+  vp_rs_get_color_impl(m_device, m_intrinsics, color);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud, m_invalidDepthValue);
+}
+
 /*!
   Acquire data from RealSense device.
   \param data_image : Color image buffer or NULL if not wanted.
@@ -122,6 +122,44 @@ void vpRealSense2::acquire(unsigned char *const data_image, unsigned char *const
   }
 }
 
+/*!
+  Acquire data from RealSense device.
+  \param data_image : Color image buffer or NULL if not wanted.
+  \param data_depth : Depth image buffer or NULL if not wanted.
+  \param pointcloud : Point cloud stored as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix is
+  only reallocated when the depth stream resolution changes.
+  \param data_infrared : Infrared image buffer or NULL if not wanted.
+  \param align_to : Align to a reference stream or NULL if not wanted.
+ */
+void vpRealSense2::acquire(unsigned char *const data_image, unsigned char *const data_depth, vpMatrix &pointcloud,
+                           unsigned char *const data_infrared, rs2::align *const align_to)
+{
+  auto data = m_pipe.wait_for_frames();
+  if (align_to != NULL)
+#if (RS2_API_VERSION > ((2 * 10000) + (9 * 100) + 0))
+    data = align_to->process(data);
+#else
+    data = align_to->proccess(data);
+#endif
+
+  if (data_image != NULL) {
+    auto color_frame = data.get_color_frame();
+    getNativeFrameData(color_frame, data_image);
+  }
+
+  auto depth_frame = data.get_depth_frame();
+  if (data_depth != NULL)
+    getNativeFrameData(depth_frame, data_depth);
+
+  getPointcloud(depth_frame, pointcloud);
+
+  if (data_infrared != NULL) {
+    auto infrared_frame = data.first(RS2_STREAM_INFRARED);
+    getNativeFrameData(infrared_frame, data_infrared);
+  }
+}
+
 #ifdef VISP_HAVE_PCL
 /*!
   Acquire data from RealSense device.
@@ -397,6 +435,54 @@ void vpRealSense2::getPointcloud(const rs2::depth_frame &depth_frame, std::vecto
   }
 }
 
+void vpRealSense2::getPointcloud(const rs2::depth_frame &depth_frame, vpMatrix &pointcloud)
+{
+  if (m_depthScale <= std::numeric_limits<float>::epsilon()) {
+    std::stringstream ss;
+    ss << "Error, depth scale <= 0: " << m_depthScale;
+    throw vpException(vpException::fatalError, ss.str());
+  }
+
+  auto vf = depth_frame.as<rs2::video_frame>();
+  const int width = vf.get_width();
+  const int height = vf.get_height();
+  // No reallocation if the size did not change
+  pointcloud.resize((unsigned int)(width * height), 3, false, false);
+
+  const uint16_t *p_depth_frame = reinterpret_cast<const uint16_t *>(depth_frame.get_data());
+
+  // Multi-threading if OpenMP
+  // Concurrent writes at different locations are safe
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < height; i++) {
+    auto depth_pixel_index = i * width;
+    double *p_pointcloud = pointcloud.data + 3 * depth_pixel_index;
+
+    for (int j = 0; j < width; j++, depth_pixel_index++, p_pointcloud += 3) {
+      if (p_depth_frame[depth_pixel_index] == 0) {
+        p_pointcloud[0] = m_invalidDepthValue;
+        p_pointcloud[1] = m_invalidDepthValue;
+        p_pointcloud[2] = m_invalidDepthValue;
+        continue;
+      }
+
+      // Get the depth value of the current pixel
+      auto pixels_distance = m_depthScale * p_depth_frame[depth_pixel_index];
+
+      float points[3];
+      const float pixel[] = {(float)j, (float)i};
+      rs2_deproject_pixel_to_point(points, &m_depthIntrinsics, pixel, pixels_distance);
+
+      if (pixels_distance > m_max_Z)
+        points[0] = points[1] = points[2] = m_invalidDepthValue;
+
+      p_pointcloud[0] = points[0];
+      p_pointcloud[1] = points[1];
+      p_pointcloud[2] = points[2];
+    }
+  }
+}
+
 #ifdef VISP_HAVE_PCL
 void vpRealSense2::getPointcloud(const rs2::depth_frame &depth_frame, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud)
 {
@@ -252,6 +252,47 @@ void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map<rs::st
   }
 }
 
+// Retrieve point cloud as a contiguous (width x height) x 3 matrix
+void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map<rs::stream, rs::intrinsics> &m_intrinsics,
+                               float max_Z, vpMatrix &pointcloud, const float invalidDepthValue = 0.0f,
+                               const rs::stream &stream_depth = rs::stream::depth)
+{
+  if (m_device->is_stream_enabled(rs::stream::depth)) {
+    std::map<rs::stream, rs::intrinsics>::const_iterator it_intrinsics = m_intrinsics.find(stream_depth);
+    if (it_intrinsics == m_intrinsics.end()) {
+      throw vpException(vpException::fatalError, "Cannot find intrinsics for depth stream!");
+    }
+
+    const float depth_scale = m_device->get_depth_scale();
+
+    rs::float3 depth_point;
+    uint16_t *depth = (uint16_t *)m_device->get_frame_data(stream_depth);
+    int width = it_intrinsics->second.width;
+    int height = it_intrinsics->second.height;
+    // No reallocation if the size did not change
+    pointcloud.resize((unsigned int)(width * height), 3, false, false);
+    double *p_pointcloud = pointcloud.data;
+
+    for (int i = 0; i < height; i++) {
+      for (int j = 0; j < width; j++, p_pointcloud += 3) {
+        float scaled_depth = depth[i * width + j] * depth_scale;
+
+        rs::float2 depth_pixel = {(float)j, (float)i};
+        depth_point = it_intrinsics->second.deproject(depth_pixel, scaled_depth);
+
+        if (depth_point.z <= 0 || depth_point.z > max_Z) {
+          depth_point.x = depth_point.y = depth_point.z = invalidDepthValue;
+        }
+        p_pointcloud[0] = depth_point.x;
+        p_pointcloud[1] = depth_point.y;
+        p_pointcloud[2] = depth_point.z;
+      }
+    }
+  } else {
+    pointcloud.resize(0, 0);
+  }
+}
+
 #ifdef VISP_HAVE_PCL
 // Retrieve point cloud
 void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map<rs::stream, rs::intrinsics> &m_intrinsics,
@@ -51,6 +51,7 @@
 #include <visp3/core/vpColor.h>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
 
 #if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408))
 
@@ -137,9 +138,11 @@ public:
   void initTracking(const cv::Mat &I, const cv::Mat &mask = cv::Mat());
   void initTracking(const cv::Mat &I, const std::vector<cv::Point2f> &pts);
   void initTracking(const cv::Mat &I, const std::vector<cv::Point2f> &pts, const std::vector<long> &ids);
+  void initTracking(const vpImageView<const unsigned char> &I);
 
   vpKltOpencv &operator=(const vpKltOpencv &copy);
   void track(const cv::Mat &I);
+  void track(const vpImageView<const unsigned char> &I);
   void setBlockSize(const int blockSize);
   void setHarrisFreeParameter(double harris_k);
   void setInitialGuess(const std::vector<cv::Point2f> &guess_pts);
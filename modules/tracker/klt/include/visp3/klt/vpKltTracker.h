@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Native pyramidal KLT (Kanade-Lucas-Tomasi) feature tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpKltTracker.h
+
+  \brief Native pyramidal KLT (Kanade-Lucas-Tomasi) feature tracker that
+  does not require OpenCV.
+*/
+
+#ifndef vpKltTracker_h
+#define vpKltTracker_h
+
+#include <vector>
+
+#include <visp3/core/vpColor.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+
+/*!
+  \class vpKltTracker
+
+  \ingroup module_klt
+
+  \brief KLT (Kanade-Lucas-Tomasi) feature tracker implemented in ViSP, that
+  works directly on vpImage<unsigned char> and does not depend on OpenCV.
+
+  Features are detected with a Shi-Tomasi (minimal eigenvalue) or Harris
+  corner detector, and tracked from one image to the next one with the
+  iterative pyramidal Lucas-Kanade method. The Gaussian pyramid and the
+  gradients of an image are computed once, when the image is passed to
+  initTracking() or track(), and reused as the reference of the next call to
+  track(). Patches are sampled with SSE2 bilinear interpolation when the CPU
+  supports it. The detection and the tracking of the features are run on
+  vpThreadPool.
+
+  The interface follows the one of vpKltOpencv, with vpImagePoint instead of
+  cv::Point2f. vpMbtDistanceKltPoints accepts either of them, while
+  vpMbKltTracker, vpMbEdgeKltTracker and vpMbGenericTracker still use
+  vpKltOpencv.
+
+  \code
+#include <visp3/klt/vpKltTracker.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpKltTracker klt;
+  klt.setMaxFeatures(200);
+  klt.setWindowSize(10);
+  klt.setQuality(0.01);
+  klt.setMinDistance(15);
+  klt.setPyramidLevels(3);
+
+  // Acquire I
+  klt.initTracking(I);
+  while (true) {
+    // Acquire I
+    klt.track(I);
+    for (int i = 0; i < klt.getNbFeatures(); i++) {
+      long id;
+      float x, y;
+      klt.getFeature(i, id, x, y);
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpKltTracker
+{
+public:
+  vpKltTracker();
+  virtual ~vpKltTracker();
+
+  void addFeature(const float &x, const float &y);
+  void addFeature(const long &id, const float &x, const float &y);
+
+  void display(const vpImage<unsigned char> &I, const vpColor &color = vpColor::red, unsigned int thickness = 1);
+
+  //! Get the size of the averaging block used to detect the features.
+  int getBlockSize() const { return m_blockSize; }
+  void getFeature(const int &index, long &id, float &x, float &y) const;
+  //! Get the list of current features.
+  std::vector<vpImagePoint> getFeatures() const { return m_points[1]; }
+  //! Get the unique id of each feature.
+  std::vector<long> getFeaturesId() const { return m_points_id; }
+  //! Get the free parameter of the Harris detector.
+  double getHarrisFreeParameter() const { return m_harris_k; }
+  //! Get the maximum number of features to track in the image.
+  int getMaxFeatures() const { return m_maxCount; }
+  //! Get the minimal Euclidean distance between detected corners during
+  //! initialization.
+  double getMinDistance() const { return m_minDistance; }
+  //! Get the number of current features
+  int getNbFeatures() const { return (int)m_points[1].size(); }
+  //! Get the number of previous features.
+  int getNbPrevFeatures() const { return (int)m_points[0].size(); }
+  //! Get the list of previous features
+  std::vector<vpImagePoint> getPrevFeatures() const { return m_points[0]; }
+  //! Get the maximal pyramid level.
+  int getPyramidLevels() const { return m_pyrMaxLevel; }
+  //! Get the parameter characterizing the minimal accepted quality of image
+  //! corners.
+  double getQuality() const { return m_qualityLevel; }
+  //! Get the window size used to track the features.
+  int getWindowSize() const { return m_winSize; }
+
+  void initTracking(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask = NULL);
+  void initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts);
+  void initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts,
+                    const std::vector<long> &ids);
+
+  void track(const vpImage<unsigned char> &I);
+
+  void setBlockSize(const int blockSize);
+  void setHarrisFreeParameter(double harris_k);
+  void setInitialGuess(const std::vector<vpImagePoint> &guess_pts);
+  void setInitialGuess(const std::vector<vpImagePoint> &init_pts, const std::vector<vpImagePoint> &guess_pts,
+                       const std::vector<long> &fid);
+  void setMaxFeatures(const int maxCount);
+  void setMinDistance(double minDistance);
+  void setMinEigThreshold(double minEigThreshold);
+  void setPyramidLevels(const int pyrMaxLevel);
+  void setQuality(double qualityLevel);
+  void setTermCriteria(unsigned int maxIter, double epsilon);
+  //! Does nothing. Just here for compat with vpKltOpencv.
+  void setTrackerId(int tid) { (void)tid; }
+  void setUseHarris(const int useHarrisDetector);
+  void setWindowSize(const int winSize);
+  void suppressFeature(const int &index);
+
+protected:
+  void buildPyramid(const vpImage<unsigned char> &I);
+  void detectFeatures(const vpImage<unsigned char> *mask);
+
+  //! Gaussian pyramids of the previous [0] and current [1] images
+  std::vector<vpImage<unsigned char> > m_pyr[2];
+  //! Gradients along x and y of each level of the previous [0] and current
+  //! [1] pyramids, in 16-bit fixed point (twice the gradient)
+  std::vector<vpImage<short> > m_gradX[2], m_gradY[2];
+  std::vector<vpImagePoint> m_points[2]; //!< Previous [0] and current [1] keypoint location
+  std::vector<long> m_points_id;         //!< Keypoint id
+  int m_maxCount;
+  unsigned int m_maxIter;
+  double m_epsilon;
+  int m_winSize;
+  double m_qualityLevel;
+  double m_minDistance;
+  double m_minEigThreshold;
+  double m_harris_k;
+  int m_blockSize;
+  int m_useHarrisDetector;
+  int m_pyrMaxLevel;
+  long m_next_points_id;
+  bool m_initial_guess;
+};
+
+#endif
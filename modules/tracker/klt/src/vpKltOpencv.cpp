@@ -52,6 +52,7 @@
 #include <string>
 
 #include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/klt/vpKltOpencv.h>
 
@@ -139,6 +140,35 @@ void vpKltOpencv::initTracking(const cv::Mat &I, const cv::Mat &mask)
   }
 }
 
+/*!
+  Initialise the tracking by extracting KLT keypoints on a view of a grey
+  level image, for instance a region of interest. The view is wrapped in a
+  cv::Mat header so that only the region of interest is copied in the
+  tracker. The keypoints are expressed in the view frame.
+
+  \param I : View on a grey level image.
+*/
+void vpKltOpencv::initTracking(const vpImageView<const unsigned char> &I)
+{
+  cv::Mat cvI;
+  vpImageConvert::convert(I, cvI, false);
+  initTracking(cvI);
+}
+
+/*!
+  Track KLT keypoints in a view of a grey level image, for instance a region
+  of interest, without cropping it first. The view has to keep the same size
+  between two calls.
+
+  \param I : View on a grey level image.
+*/
+void vpKltOpencv::track(const vpImageView<const unsigned char> &I)
+{
+  cv::Mat cvI;
+  vpImageConvert::convert(I, cvI, false);
+  track(cvI);
+}
+
 /*!
    Track KLT keypoints using the iterative Lucas-Kanade method with pyramids.
 
@@ -0,0 +1,962 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Native pyramidal KLT (Kanade-Lucas-Tomasi) feature tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpKltTracker.cpp
+
+  \brief Native pyramidal KLT (Kanade-Lucas-Tomasi) feature tracker.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTrackingException.h>
+#include <visp3/klt/vpKltTracker.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+bool checkSSE2()
+{
+#if VISP_HAVE_SSE2
+  return vpCPUFeatures::checkSSE2();
+#else
+  return false;
+#endif
+}
+
+// Central difference I(x+1) - I(x-1), i.e. twice the gradient
+const short g_derivFilter[2] = {0, 1};
+
+struct vpKltCorner {
+  float response;
+  int i, j;
+  bool operator<(const vpKltCorner &c) const
+  {
+    if (response != c.response)
+      return response > c.response;
+    if (i != c.i)
+      return i < c.i;
+    return j < c.j;
+  }
+};
+
+#if VISP_HAVE_SSE2
+inline __m128 loadU8x4(const unsigned char *p)
+{
+  int v;
+  memcpy(&v, p, sizeof(int));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i w = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(w, zero));
+}
+
+inline __m128 loadS16x4(const short *p)
+{
+  __m128i w = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(w, w), 16));
+}
+#endif
+
+// Bilinear sampling of a n x n patch whose top-left corner is at
+// (iy + ay, ix + ax). The same weights apply to every pixel of the patch.
+// Pixels up to ix + n and iy + n are read.
+template <typename Type>
+void samplePatch(const vpImage<Type> &I, int ix, int iy, float ax, float ay, int n, float scale, float *dst,
+                 bool useSSE2)
+{
+  const float w00 = (1.f - ax) * (1.f - ay) * scale, w01 = ax * (1.f - ay) * scale;
+  const float w10 = (1.f - ax) * ay * scale, w11 = ax * ay * scale;
+  (void)useSSE2;
+  for (int r = 0; r < n; r++) {
+    const Type *r0 = I[(unsigned int)(iy + r)] + ix;
+    const Type *r1 = I[(unsigned int)(iy + r + 1)] + ix;
+    float *d = dst + r * n;
+    for (int k = 0; k < n; k++) {
+      d[k] = w00 * r0[k] + w01 * r0[k + 1] + w10 * r1[k] + w11 * r1[k + 1];
+    }
+  }
+}
+
+#if VISP_HAVE_SSE2
+template <>
+void samplePatch(const vpImage<unsigned char> &I, int ix, int iy, float ax, float ay, int n, float scale, float *dst,
+                 bool useSSE2)
+{
+  const float w00 = (1.f - ax) * (1.f - ay) * scale, w01 = ax * (1.f - ay) * scale;
+  const float w10 = (1.f - ax) * ay * scale, w11 = ax * ay * scale;
+  const __m128 v00 = _mm_set1_ps(w00), v01 = _mm_set1_ps(w01), v10 = _mm_set1_ps(w10), v11 = _mm_set1_ps(w11);
+  for (int r = 0; r < n; r++) {
+    const unsigned char *r0 = I[(unsigned int)(iy + r)] + ix;
+    const unsigned char *r1 = I[(unsigned int)(iy + r + 1)] + ix;
+    float *d = dst + r * n;
+    int k = 0;
+    if (useSSE2) {
+      for (; k + 4 <= n; k += 4) {
+        __m128 s = _mm_add_ps(_mm_mul_ps(v00, loadU8x4(r0 + k)), _mm_mul_ps(v01, loadU8x4(r0 + k + 1)));
+        s = _mm_add_ps(s, _mm_add_ps(_mm_mul_ps(v10, loadU8x4(r1 + k)), _mm_mul_ps(v11, loadU8x4(r1 + k + 1))));
+        _mm_storeu_ps(d + k, s);
+      }
+    }
+    for (; k < n; k++) {
+      d[k] = w00 * r0[k] + w01 * r0[k + 1] + w10 * r1[k] + w11 * r1[k + 1];
+    }
+  }
+}
+
+template <>
+void samplePatch(const vpImage<short> &I, int ix, int iy, float ax, float ay, int n, float scale, float *dst,
+                 bool useSSE2)
+{
+  const float w00 = (1.f - ax) * (1.f - ay) * scale, w01 = ax * (1.f - ay) * scale;
+  const float w10 = (1.f - ax) * ay * scale, w11 = ax * ay * scale;
+  const __m128 v00 = _mm_set1_ps(w00), v01 = _mm_set1_ps(w01), v10 = _mm_set1_ps(w10), v11 = _mm_set1_ps(w11);
+  for (int r = 0; r < n; r++) {
+    const short *r0 = I[(unsigned int)(iy + r)] + ix;
+    const short *r1 = I[(unsigned int)(iy + r + 1)] + ix;
+    float *d = dst + r * n;
+    int k = 0;
+    if (useSSE2) {
+      for (; k + 4 <= n; k += 4) {
+        __m128 s = _mm_add_ps(_mm_mul_ps(v00, loadS16x4(r0 + k)), _mm_mul_ps(v01, loadS16x4(r0 + k + 1)));
+        s = _mm_add_ps(s, _mm_add_ps(_mm_mul_ps(v10, loadS16x4(r1 + k)), _mm_mul_ps(v11, loadS16x4(r1 + k + 1))));
+        _mm_storeu_ps(d + k, s);
+      }
+    }
+    for (; k < n; k++) {
+      d[k] = w00 * r0[k] + w01 * r0[k + 1] + w10 * r1[k] + w11 * r1[k + 1];
+    }
+  }
+}
+#endif
+
+// Mismatch vector b = sum (T - J) [gx gy]^T over the patch
+void computeMismatch(const float *T, const float *J, const float *gx, const float *gy, int size, double &bx,
+                     double &by, bool useSSE2)
+{
+  float sx = 0.f, sy = 0.f;
+  int k = 0;
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    __m128 ax = _mm_setzero_ps(), ay = _mm_setzero_ps();
+    for (; k + 4 <= size; k += 4) {
+      const __m128 e = _mm_sub_ps(_mm_loadu_ps(T + k), _mm_loadu_ps(J + k));
+      ax = _mm_add_ps(ax, _mm_mul_ps(e, _mm_loadu_ps(gx + k)));
+      ay = _mm_add_ps(ay, _mm_mul_ps(e, _mm_loadu_ps(gy + k)));
+    }
+    float tx[4], ty[4];
+    _mm_storeu_ps(tx, ax);
+    _mm_storeu_ps(ty, ay);
+    sx = (tx[0] + tx[1]) + (tx[2] + tx[3]);
+    sy = (ty[0] + ty[1]) + (ty[2] + ty[3]);
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; k < size; k++) {
+    const float e = T[k] - J[k];
+    sx += e * gx[k];
+    sy += e * gy[k];
+  }
+  bx = sx;
+  by = sy;
+}
+
+// Top-left integer corner and sub-pixel offset of the patch centered on
+// (u, v). Returns false if the patch, its bilinear neighbours and the
+// one-pixel gradient border do not fit in the image.
+bool patchCorner(double u, double v, int half, int n, unsigned int width, unsigned int height, int &ix, int &iy,
+                 float &ax, float &ay)
+{
+  const double x0 = u - half, y0 = v - half;
+  if (!(x0 >= 1. && y0 >= 1. && x0 + n < (double)width - 2. && y0 + n < (double)height - 2.))
+    return false;
+  ix = (int)x0;
+  iy = (int)y0;
+  ax = (float)(x0 - ix);
+  ay = (float)(y0 - iy);
+  return true;
+}
+
+// Lucas-Kanade iterations at one pyramid level. (nu, nv) contains the
+// initial guess and is updated with the tracked position.
+bool trackLevel(const vpImage<unsigned char> &I0, const vpImage<short> &Ix, const vpImage<short> &Iy,
+                const vpImage<unsigned char> &I1, double pu, double pv, double &nu, double &nv, int half,
+                unsigned int maxIter, double epsilon, double minEigThreshold, float *T, float *gx, float *gy, float *J,
+                bool useSSE2)
+{
+  const int n = 2 * half + 1;
+  const int size = n * n;
+  const double eps2 = epsilon * epsilon;
+
+  int ix, iy;
+  float ax, ay;
+  if (!patchCorner(pu, pv, half, n, I0.getWidth(), I0.getHeight(), ix, iy, ax, ay))
+    return false;
+  samplePatch(I0, ix, iy, ax, ay, n, 1.f, T, useSSE2);
+  samplePatch(Ix, ix, iy, ax, ay, n, 0.5f, gx, useSSE2);
+  samplePatch(Iy, ix, iy, ax, ay, n, 0.5f, gy, useSSE2);
+
+  double a = 0., b = 0., c = 0.;
+  for (int k = 0; k < size; k++) {
+    a += gx[k] * gx[k];
+    b += gx[k] * gy[k];
+    c += gy[k] * gy[k];
+  }
+  const double det = a * c - b * b;
+  // Minimal eigenvalue normalized by the window area, intensities in [0, 1]
+  const double minEig = (a + c - sqrt((a - c) * (a - c) + 4. * b * b)) / (2. * size * 255. * 255.);
+  if (minEig < minEigThreshold || det < std::numeric_limits<double>::epsilon())
+    return false;
+
+  double u = nu, v = nv;
+  for (unsigned int iter = 0; iter < maxIter; iter++) {
+    if (!patchCorner(u, v, half, n, I1.getWidth(), I1.getHeight(), ix, iy, ax, ay))
+      return false;
+    samplePatch(I1, ix, iy, ax, ay, n, 1.f, J, useSSE2);
+
+    double bx, by;
+    computeMismatch(T, J, gx, gy, size, bx, by, useSSE2);
+    const double du = (c * bx - b * by) / det;
+    const double dv = (a * by - b * bx) / det;
+    u += du;
+    v += dv;
+    if (du * du + dv * dv < eps2)
+      break;
+  }
+
+  nu = u;
+  nv = v;
+  return true;
+}
+
+// Pyramidal Lucas-Kanade on a single feature. nextPt contains the initial
+// guess at the finest level and is updated with the tracked position.
+bool trackFeature(const std::vector<vpImage<unsigned char> > &prevPyr, const std::vector<vpImage<short> > &prevGx,
+                  const std::vector<vpImage<short> > &prevGy, const std::vector<vpImage<unsigned char> > &nextPyr,
+                  const vpImagePoint &prevPt, vpImagePoint &nextPt, int half, unsigned int maxIter, double epsilon,
+                  double minEigThreshold, float *T, float *gx, float *gy, float *J, bool useSSE2)
+{
+  const int nbLevels = (int)std::min(prevPyr.size(), nextPyr.size());
+
+  double scale = 1. / (1 << (nbLevels - 1));
+  double nu = nextPt.get_u() * scale, nv = nextPt.get_v() * scale;
+
+  for (int level = nbLevels - 1; level >= 0; level--) {
+    if (!trackLevel(prevPyr[(size_t)level], prevGx[(size_t)level], prevGy[(size_t)level], nextPyr[(size_t)level],
+                    prevPt.get_u() * scale, prevPt.get_v() * scale, nu, nv, half, maxIter, epsilon, minEigThreshold, T,
+                    gx, gy, J, useSSE2)) {
+      // Near the image borders the coarse levels are skipped, only a failure
+      // at the finest level means that the feature is lost
+      if (level == 0)
+        return false;
+    }
+
+    if (level > 0) {
+      nu *= 2.;
+      nv *= 2.;
+      scale *= 2.;
+    }
+  }
+
+  nextPt.set_uv(nu, nv);
+  return true;
+}
+
+// Structure tensor of the rows [begin, end), summed over a horizontal block
+class StructureTensorRows : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  StructureTensorRows(const vpImage<short> &Ix, const vpImage<short> &Iy, int r, vpImage<float> &Sxx,
+                      vpImage<float> &Sxy, vpImage<float> &Syy)
+    : m_Ix(Ix), m_Iy(Iy), m_r(r), m_Sxx(Sxx), m_Sxy(Sxy), m_Syy(Syy)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const int width = (int)m_Ix.getWidth();
+    for (unsigned int i = begin; i < end; i++) {
+      float *sxx = m_Sxx[i], *sxy = m_Sxy[i], *syy = m_Syy[i];
+      const short *gx = m_Ix[i], *gy = m_Iy[i];
+      for (int j = m_r; j < width - m_r; j++) {
+        float a = 0.f, b = 0.f, c = 0.f;
+        for (int k = -m_r; k <= m_r; k++) {
+          const float x = 0.5f * gx[j + k], y = 0.5f * gy[j + k];
+          a += x * x;
+          b += x * y;
+          c += y * y;
+        }
+        sxx[j] = a;
+        sxy[j] = b;
+        syy[j] = c;
+      }
+    }
+  }
+
+private:
+  const vpImage<short> &m_Ix;
+  const vpImage<short> &m_Iy;
+  int m_r;
+  vpImage<float> &m_Sxx;
+  vpImage<float> &m_Sxy;
+  vpImage<float> &m_Syy;
+};
+
+// Shi-Tomasi or Harris response of the rows [begin, end), the structure
+// tensor being summed over a vertical block
+class CornerResponseRows : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  CornerResponseRows(const vpImage<float> &Sxx, const vpImage<float> &Sxy, const vpImage<float> &Syy, int r,
+                     int border, bool useHarris, float k_harris, vpImage<float> &response)
+    : m_Sxx(Sxx), m_Sxy(Sxy), m_Syy(Syy), m_r(r), m_border(border), m_useHarris(useHarris), m_k_harris(k_harris),
+      m_response(response)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const int width = (int)m_Sxx.getWidth();
+    for (int i = (int)begin; i < (int)end; i++) {
+      float *R = m_response[i];
+      for (int j = m_border; j < width - m_border; j++) {
+        float a = 0.f, b = 0.f, c = 0.f;
+        for (int k = -m_r; k <= m_r; k++) {
+          a += m_Sxx[i + k][j];
+          b += m_Sxy[i + k][j];
+          c += m_Syy[i + k][j];
+        }
+        if (m_useHarris) {
+          R[j] = a * c - b * b - m_k_harris * (a + c) * (a + c);
+        } else {
+          R[j] = 0.5f * (a + c - sqrtf((a - c) * (a - c) + 4.f * b * b));
+        }
+      }
+    }
+  }
+
+private:
+  const vpImage<float> &m_Sxx;
+  const vpImage<float> &m_Sxy;
+  const vpImage<float> &m_Syy;
+  int m_r;
+  int m_border;
+  bool m_useHarris;
+  float m_k_harris;
+  vpImage<float> &m_response;
+};
+
+// Pyramidal Lucas-Kanade on the features [begin, end)
+class TrackFeatures : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  TrackFeatures(const std::vector<vpImage<unsigned char> > &prevPyr, const std::vector<vpImage<short> > &prevGx,
+                const std::vector<vpImage<short> > &prevGy, const std::vector<vpImage<unsigned char> > &nextPyr,
+                const std::vector<vpImagePoint> &prevPts, std::vector<vpImagePoint> &nextPts, int half,
+                unsigned int maxIter, double epsilon, double minEigThreshold, bool useSSE2,
+                std::vector<unsigned char> &status)
+    : m_prevPyr(prevPyr), m_prevGx(prevGx), m_prevGy(prevGy), m_nextPyr(nextPyr), m_prevPts(prevPts),
+      m_nextPts(nextPts), m_half(half), m_maxIter(maxIter), m_epsilon(epsilon), m_minEigThreshold(minEigThreshold),
+      m_useSSE2(useSSE2), m_status(status)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const int size = (2 * m_half + 1) * (2 * m_half + 1);
+    std::vector<float> buffer((size_t)(4 * size));
+    float *T = &buffer[0], *gx = T + size, *gy = gx + size, *J = gy + size;
+    for (unsigned int i = begin; i < end; i++) {
+      m_status[i] = trackFeature(m_prevPyr, m_prevGx, m_prevGy, m_nextPyr, m_prevPts[i], m_nextPts[i], m_half,
+                                 m_maxIter, m_epsilon, m_minEigThreshold, T, gx, gy, J, m_useSSE2)
+                        ? 1
+                        : 0;
+    }
+  }
+
+private:
+  const std::vector<vpImage<unsigned char> > &m_prevPyr;
+  const std::vector<vpImage<short> > &m_prevGx;
+  const std::vector<vpImage<short> > &m_prevGy;
+  const std::vector<vpImage<unsigned char> > &m_nextPyr;
+  const std::vector<vpImagePoint> &m_prevPts;
+  std::vector<vpImagePoint> &m_nextPts;
+  int m_half;
+  unsigned int m_maxIter;
+  double m_epsilon;
+  double m_minEigThreshold;
+  bool m_useSSE2;
+  std::vector<unsigned char> &m_status;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor.
+ */
+vpKltTracker::vpKltTracker()
+  : m_points_id(), m_maxCount(500), m_maxIter(20), m_epsilon(0.03), m_winSize(10), m_qualityLevel(0.01),
+    m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04), m_blockSize(3), m_useHarrisDetector(1),
+    m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
+{
+}
+
+/*!
+  Destructor.
+ */
+vpKltTracker::~vpKltTracker() {}
+
+/*!
+  Compute the Gaussian pyramid of an image and the gradients of each level,
+  and store them as the current pyramid.
+
+  \param I : Grey level image.
+*/
+void vpKltTracker::buildPyramid(const vpImage<unsigned char> &I)
+{
+  const unsigned int minSize = (unsigned int)(2 * (m_winSize / 2) + 1) + 4;
+  const unsigned int nbLevels = (unsigned int)std::max(m_pyrMaxLevel, 0) + 1;
+
+  m_pyr[1].resize(nbLevels);
+  m_pyr[1][0] = I;
+  unsigned int level = 1;
+  for (; level < nbLevels; level++) {
+    const vpImage<unsigned char> &prev = m_pyr[1][level - 1];
+    if (prev.getWidth() / 2 < minSize || prev.getHeight() / 2 < minSize)
+      break;
+    vpImageFilter::getGaussPyramidal(prev, m_pyr[1][level]);
+  }
+  m_pyr[1].resize(level);
+
+  m_gradX[1].resize(level);
+  m_gradY[1].resize(level);
+  for (unsigned int l = 0; l < level; l++) {
+    vpImageFilter::getGradX(m_pyr[1][l], m_gradX[1][l], g_derivFilter, 3);
+    vpImageFilter::getGradY(m_pyr[1][l], m_gradY[1][l], g_derivFilter, 3);
+  }
+}
+
+/*!
+  Detect corners on the current image with the Shi-Tomasi or Harris
+  detector.
+
+  \param mask : Image mask used to restrict the detection area, or NULL.
+*/
+void vpKltTracker::detectFeatures(const vpImage<unsigned char> *mask)
+{
+  const vpImage<short> &Ix = m_gradX[1][0];
+  const vpImage<short> &Iy = m_gradY[1][0];
+  const int height = (int)Ix.getHeight(), width = (int)Ix.getWidth();
+  const int r = std::max(m_blockSize, 1) / 2;
+
+  if (mask != NULL && (mask->getHeight() != (unsigned int)height || mask->getWidth() != (unsigned int)width)) {
+    throw(vpTrackingException(vpTrackingException::initializationError,
+                              "Mask size (%dx%d) differs from image size (%dx%d)", mask->getWidth(),
+                              mask->getHeight(), width, height));
+  }
+
+  // Structure tensor summed over the block, gradients in intensity units
+  vpImage<float> Sxx(Ix.getHeight(), Ix.getWidth(), 0.f), Sxy(Ix.getHeight(), Ix.getWidth(), 0.f),
+      Syy(Ix.getHeight(), Ix.getWidth(), 0.f);
+  vpImage<float> response(Ix.getHeight(), Ix.getWidth(), 0.f);
+
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)height, StructureTensorRows(Ix, Iy, r, Sxx, Sxy, Syy));
+
+  const int border = std::max(r + 1, 2);
+  const float k_harris = (float)m_harris_k;
+  const bool useHarris = m_useHarrisDetector != 0;
+  if (height > 2 * border) {
+    vpThreadPool::getInstance().parallelFor((unsigned int)border, (unsigned int)(height - border),
+                                            CornerResponseRows(Sxx, Sxy, Syy, r, border, useHarris, k_harris, response));
+  }
+
+  float maxResponse = 0.f;
+  for (int i = border; i < height - border; i++) {
+    for (int j = border; j < width - border; j++) {
+      maxResponse = std::max(maxResponse, response[i][j]);
+    }
+  }
+  if (maxResponse <= 0.f)
+    return;
+  const float threshold = (float)(m_qualityLevel * maxResponse);
+
+  // Local maxima over a 3x3 neighbourhood above the quality threshold
+  std::vector<vpKltCorner> corners;
+  for (int i = border + 1; i < height - border - 1; i++) {
+    const float *R0 = response[i - 1], *R1 = response[i], *R2 = response[i + 1];
+    for (int j = border + 1; j < width - border - 1; j++) {
+      const float v = R1[j];
+      if (v <= threshold || v < R1[j - 1] || v < R1[j + 1] || v < R0[j - 1] || v < R0[j] || v < R0[j + 1] ||
+          v < R2[j - 1] || v < R2[j] || v < R2[j + 1])
+        continue;
+      if (mask != NULL && (*mask)[i][j] == 0)
+        continue;
+      vpKltCorner corner;
+      corner.response = v;
+      corner.i = i;
+      corner.j = j;
+      corners.push_back(corner);
+    }
+  }
+  std::sort(corners.begin(), corners.end());
+
+  // Strongest corners first, rejecting those closer than the minimal
+  // distance to an accepted one. Accepted corners are binned in a grid of
+  // cells of minDistance size.
+  const double minDist = std::max(m_minDistance, 0.);
+  const double minDist2 = minDist * minDist;
+  const int cell = std::max((int)minDist, 1);
+  const int gridW = (width + cell - 1) / cell, gridH = (height + cell - 1) / cell;
+  std::vector<std::vector<vpImagePoint> > grid((size_t)(gridW * gridH));
+
+  for (size_t n = 0; n < corners.size(); n++) {
+    if (m_maxCount > 0 && (int)m_points[1].size() >= m_maxCount)
+      break;
+    const int i = corners[n].i, j = corners[n].j;
+    const int ci = i / cell, cj = j / cell;
+
+    bool keep = true;
+    if (minDist > 0.) {
+      for (int gi = std::max(ci - 1, 0); gi <= std::min(ci + 1, gridH - 1) && keep; gi++) {
+        for (int gj = std::max(cj - 1, 0); gj <= std::min(cj + 1, gridW - 1) && keep; gj++) {
+          const std::vector<vpImagePoint> &pts = grid[(size_t)(gi * gridW + gj)];
+          for (size_t p = 0; p < pts.size(); p++) {
+            const double di = pts[p].get_i() - i, dj = pts[p].get_j() - j;
+            if (di * di + dj * dj < minDist2) {
+              keep = false;
+              break;
+            }
+          }
+        }
+      }
+    }
+    if (!keep)
+      continue;
+    grid[(size_t)(ci * gridW + cj)].push_back(vpImagePoint(i, j));
+
+    // Sub-pixel location from a parabola fitted along each axis
+    const float *R = response[i];
+    double di = 0., dj = 0.;
+    const double dxx = R[j - 1] - 2. * R[j] + R[j + 1];
+    const double dyy = response[i - 1][j] - 2. * R[j] + response[i + 1][j];
+    if (dxx < 0.)
+      dj = vpMath::maximum(-0.5, vpMath::minimum(0.5, 0.5 * (R[j - 1] - R[j + 1]) / dxx));
+    if (dyy < 0.)
+      di = vpMath::maximum(-0.5, vpMath::minimum(0.5, 0.5 * (response[i - 1][j] - response[i + 1][j]) / dyy));
+
+    m_points[1].push_back(vpImagePoint(i + di, j + dj));
+    m_points_id.push_back(m_next_points_id++);
+  }
+}
+
+/*!
+  Initialise the tracking by extracting KLT keypoints on the provided image.
+
+  \param I : Grey level image used as input.
+  \param mask : Image mask used to restrict the keypoint detection area.
+  Pixels set to 0 are not considered. If mask is NULL, all the image is
+  considered.
+
+  \exception vpTrackingException::initializationError : If the mask size
+  differs from the image size.
+*/
+void vpKltTracker::initTracking(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask)
+{
+  m_next_points_id = 0;
+  m_initial_guess = false;
+  for (size_t i = 0; i < 2; i++) {
+    m_points[i].clear();
+  }
+  m_points_id.clear();
+
+  buildPyramid(I);
+  detectFeatures(mask);
+}
+
+/*!
+  Set the points that will be used as initialization during the next call to
+  track().
+
+  \param I : Input image.
+  \param pts : Vector of points that should be tracked.
+*/
+void vpKltTracker::initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts)
+{
+  initTracking(I, pts, std::vector<long>());
+}
+
+/*!
+  Set the points that will be used as initialization during the next call to
+  track().
+
+  \param I : Input image.
+  \param pts : Vector of points that should be tracked.
+  \param ids : Identifiers of the points. If the size of this vector differs
+  from the number of points, new identifiers are generated.
+*/
+void vpKltTracker::initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts,
+                                const std::vector<long> &ids)
+{
+  m_initial_guess = false;
+  m_points[0].clear();
+  m_points[1] = pts;
+  m_points_id.clear();
+
+  if (ids.size() != pts.size()) {
+    m_next_points_id = 0;
+    for (size_t i = 0; i < m_points[1].size(); i++)
+      m_points_id.push_back(m_next_points_id++);
+  } else {
+    long max = 0;
+    for (size_t i = 0; i < m_points[1].size(); i++) {
+      m_points_id.push_back(ids[i]);
+      if (ids[i] > max)
+        max = ids[i];
+    }
+    m_next_points_id = max + 1;
+  }
+
+  buildPyramid(I);
+}
+
+/*!
+  Track KLT keypoints using the iterative Lucas-Kanade method with pyramids.
+  The pyramid of the previous image, computed by the previous call to
+  initTracking() or track(), is reused. Lost features are removed.
+
+  \param I : Input image, with the same size as the previous one.
+
+  \exception vpTrackingException::fatalError : If there is no feature to
+  track.
+*/
+void vpKltTracker::track(const vpImage<unsigned char> &I)
+{
+  if (m_points[1].size() == 0)
+    throw vpTrackingException(vpTrackingException::fatalError, "Not enough key points to track.");
+
+  // The pyramid of the last image becomes the reference
+  m_pyr[0].swap(m_pyr[1]);
+  m_gradX[0].swap(m_gradX[1]);
+  m_gradY[0].swap(m_gradY[1]);
+  buildPyramid(I);
+  if (m_pyr[0].empty() || m_pyr[0][0].getHeight() != I.getHeight() || m_pyr[0][0].getWidth() != I.getWidth()) {
+    m_pyr[0] = m_pyr[1];
+    m_gradX[0] = m_gradX[1];
+    m_gradY[0] = m_gradY[1];
+  }
+
+  if (m_initial_guess) {
+    m_initial_guess = false;
+  } else {
+    m_points[0] = m_points[1];
+  }
+
+  const int nbPoints = (int)m_points[1].size();
+  const int half = m_winSize / 2;
+  const bool useSSE2 = checkSSE2();
+  std::vector<unsigned char> status((size_t)nbPoints, 0);
+
+  // Chunks of 16 features balance the iterations that differ between features
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)nbPoints,
+                                          TrackFeatures(m_pyr[0], m_gradX[0], m_gradY[0], m_pyr[1], m_points[0],
+                                                        m_points[1], half, m_maxIter, m_epsilon, m_minEigThreshold,
+                                                        useSSE2, status),
+                                          (unsigned int)(nbPoints + 15) / 16);
+
+  // Remove points that are lost
+  size_t k = 0;
+  for (size_t i = 0; i < status.size(); i++) {
+    if (status[i]) {
+      m_points[0][k] = m_points[0][i];
+      m_points[1][k] = m_points[1][i];
+      m_points_id[k] = m_points_id[i];
+      k++;
+    }
+  }
+  m_points[0].resize(k);
+  m_points[1].resize(k);
+  m_points_id.resize(k);
+}
+
+/*!
+  Get the 'index'th feature image coordinates.  Beware that
+  getFeature(i,...) may not represent the same feature before and
+  after a tracking iteration (if a feature is lost, features are
+  shifted in the array).
+
+  \param index : Index of feature.
+  \param id : id of the feature.
+  \param x : x coordinate.
+  \param y : y coordinate.
+*/
+void vpKltTracker::getFeature(const int &index, long &id, float &x, float &y) const
+{
+  if ((size_t)index >= m_points[1].size()) {
+    throw(vpException(vpException::badValue, "Feature [%d] doesn't exist", index));
+  }
+
+  x = (float)m_points[1][(size_t)index].get_u();
+  y = (float)m_points[1][(size_t)index].get_v();
+  id = m_points_id[(size_t)index];
+}
+
+/*!
+  Display features position and id.
+
+  \param I : Image used as background. Display should be initialized on it.
+  \param color : Color used to display the features.
+  \param thickness : Thickness of the drawings.
+*/
+void vpKltTracker::display(const vpImage<unsigned char> &I, const vpColor &color, unsigned int thickness)
+{
+  vpImagePoint ip;
+  for (size_t i = 0; i < m_points[1].size(); i++) {
+    ip.set_u(vpMath::round(m_points[1][i].get_u()));
+    ip.set_v(vpMath::round(m_points[1][i].get_v()));
+    vpDisplay::displayCross(I, ip, 10, color, thickness);
+
+    std::ostringstream id;
+    id << m_points_id[i];
+    ip.set_u(vpMath::round(m_points[1][i].get_u() + 5));
+    vpDisplay::displayText(I, ip, id.str(), color);
+  }
+}
+
+/*!
+  Set the maximum number of features to track in the image.
+
+  \param maxCount : Maximum number of features to detect and track. Default
+  value is set to 500.
+*/
+void vpKltTracker::setMaxFeatures(const int maxCount) { m_maxCount = maxCount; }
+
+/*!
+  Set the window size used to track the features.
+
+  \param winSize : Side length of the tracking window. Even values are
+  rounded to the next odd value. Default value is set to 10, that leads to a
+  11 \f$\times\f$ 11 window.
+*/
+void vpKltTracker::setWindowSize(const int winSize) { m_winSize = std::max(winSize, 2); }
+
+/*!
+  Set the parameter characterizing the minimal accepted quality of image
+  corners.
+
+  \param qualityLevel : Quality level parameter. Default value is set to 0.01.
+  The parameter value is multiplied by the best corner quality measure, which
+  is the minimal eigenvalue or the Harris function response. The corners with
+  the quality measure less than the product are rejected.
+*/
+void vpKltTracker::setQuality(double qualityLevel) { m_qualityLevel = qualityLevel; }
+
+/*!
+  Set the free parameter of the Harris detector.
+
+  \param harris_k : Free parameter of the Harris detector. Default value is
+  set to 0.04.
+*/
+void vpKltTracker::setHarrisFreeParameter(double harris_k) { m_harris_k = harris_k; }
+
+/*!
+  Set the parameter indicating whether to use a Harris detector or
+  the minimal eigenvalue of gradient matrices for corner detection.
+  \param useHarrisDetector : If 1 (default value), use the Harris detector. If
+  0 use the eigenvalue.
+*/
+void vpKltTracker::setUseHarris(const int useHarrisDetector) { m_useHarrisDetector = useHarrisDetector; }
+
+/*!
+  Set the minimal Euclidean distance between detected corners during
+  initialization.
+
+  \param minDistance : Minimal possible Euclidean distance between the
+  detected corners. Default value is set to 15.
+*/
+void vpKltTracker::setMinDistance(double minDistance) { m_minDistance = minDistance; }
+
+/*!
+  Set the minimal eigen value threshold used to reject a point during the
+  tracking. The eigen value is normalized by the window area, with
+  intensities in [0, 1].
+
+  \param minEigThreshold : Minimal eigen value threshold. Default
+  value is set to 1e-4.
+*/
+void vpKltTracker::setMinEigThreshold(double minEigThreshold) { m_minEigThreshold = minEigThreshold; }
+
+/*!
+  Set the size of the averaging block used to detect the features.
+
+  \param blockSize : Size of an average block for computing a derivative
+  covariation matrix over each pixel neighborhood. Default value is set to 3.
+*/
+void vpKltTracker::setBlockSize(const int blockSize) { m_blockSize = blockSize; }
+
+/*!
+  Set the maximal pyramid level. If the level is zero, then no pyramid is
+  computed for the optical flow. Levels that would be smaller than the
+  tracking window are not computed.
+
+  \param pyrMaxLevel : 0-based maximal pyramid level number; if set to 0,
+  pyramids are not used (single level), if set to 1, two levels are used, and
+  so on. Default value is set to 3.
+*/
+void vpKltTracker::setPyramidLevels(const int pyrMaxLevel) { m_pyrMaxLevel = pyrMaxLevel; }
+
+/*!
+  Set the termination criteria of the Lucas-Kanade iterations at each
+  pyramid level.
+
+  \param maxIter : Maximal number of iterations. Default value is set to 20.
+  \param epsilon : The iterations stop when the update of the position is
+  smaller than this value in pixel. Default value is set to 0.03.
+*/
+void vpKltTracker::setTermCriteria(unsigned int maxIter, double epsilon)
+{
+  m_maxIter = maxIter;
+  m_epsilon = epsilon;
+}
+
+/*!
+  Set the points that will be used as initial guess during the next call to
+  track(). The current features are used as the position in the previous
+  image.
+
+  \param guess_pts : Vector of points that should be tracked. The size of this
+  vector should be the same as the one returned by getFeatures(). If this is
+  not the case, an exception is returned. Note also that the id of the points
+  is not modified.
+*/
+void vpKltTracker::setInitialGuess(const std::vector<vpImagePoint> &guess_pts)
+{
+  if (guess_pts.size() != m_points[1].size()) {
+    throw(vpException(vpException::badValue,
+                      "Cannot set initial guess: size feature vector [%d] "
+                      "and guess vector [%d] doesn't match",
+                      m_points[1].size(), guess_pts.size()));
+  }
+
+  m_points[0] = m_points[1];
+  m_points[1] = guess_pts;
+  m_initial_guess = true;
+}
+
+/*!
+  Set the points that will be used as initial guess during the next call to
+  track().
+
+  \param init_pts : Initial points (could be obtained from getPrevFeatures()
+  or getFeatures()).
+  \param guess_pts : Prediction of the new position of the initial points.
+  The size of this vector must be the same as the size of the vector of
+  initial points.
+  \param fid : Identifiers of the initial points.
+*/
+void vpKltTracker::setInitialGuess(const std::vector<vpImagePoint> &init_pts,
+                                   const std::vector<vpImagePoint> &guess_pts, const std::vector<long> &fid)
+{
+  if (guess_pts.size() != init_pts.size() || fid.size() != init_pts.size()) {
+    throw(vpException(vpException::badValue,
+                      "Cannot set initial guess: size init vector [%d], "
+                      "guess vector [%d] and id vector [%d] don't match",
+                      init_pts.size(), guess_pts.size(), fid.size()));
+  }
+
+  m_points[0] = init_pts;
+  m_points[1] = guess_pts;
+  m_points_id = fid;
+  m_initial_guess = true;
+}
+
+/*!
+  Add a keypoint at the end of the feature list. The id of the feature is set
+  to ensure that it is unique.
+
+  \param x,y : Coordinates of the feature in the image.
+*/
+void vpKltTracker::addFeature(const float &x, const float &y)
+{
+  m_points[1].push_back(vpImagePoint(y, x));
+  m_points_id.push_back(m_next_points_id++);
+}
+
+/*!
+  Add a keypoint at the end of the feature list.
+
+  \warning This function doesn't ensure that the id of the feature is unique.
+  You should rather use addFeature(const float &, const float &).
+
+  \param id : Feature id. Should be unique
+  \param x,y : Coordinates of the feature in the image.
+*/
+void vpKltTracker::addFeature(const long &id, const float &x, const float &y)
+{
+  m_points[1].push_back(vpImagePoint(y, x));
+  m_points_id.push_back(id);
+  if (id >= m_next_points_id)
+    m_next_points_id = id + 1;
+}
+
+/*!
+  Remove the feature with the given index as parameter.
+
+  \param index : Index of the feature to remove.
+*/
+void vpKltTracker::suppressFeature(const int &index)
+{
+  if ((size_t)index >= m_points[1].size()) {
+    throw(vpException(vpException::badValue, "Feature [%d] doesn't exist", index));
+  }
+
+  m_points[1].erase(m_points[1].begin() + index);
+  m_points_id.erase(m_points_id.begin() + index);
+  if ((size_t)index < m_points[0].size())
+    m_points[0].erase(m_points[0].begin() + index);
+}
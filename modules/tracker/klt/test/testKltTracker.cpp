@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the native pyramidal KLT tracker on synthetic images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKltTracker.cpp
+
+  Test vpKltTracker on a synthetic textured image translated by a known
+  sub-pixel motion: corner detection, pyramidal tracking, initial guess and
+  detection mask.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/klt/vpKltTracker.h>
+
+namespace
+{
+struct Blob {
+  double u, v, sigma, amplitude;
+};
+
+// Sum of Gaussian blobs translated by (tu, tv), evaluated analytically so
+// that the motion between two images is exactly known
+void generate(const std::vector<Blob> &blobs, double tu, double tv, vpImage<unsigned char> &I)
+{
+  vpImage<double> acc(480, 640, 128.);
+  for (size_t b = 0; b < blobs.size(); b++) {
+    const Blob &blob = blobs[b];
+    const double u0 = blob.u + tu, v0 = blob.v + tv, r = 4 * blob.sigma;
+    const int imin = std::max(0, (int)(v0 - r)), imax = std::min((int)acc.getHeight() - 1, (int)(v0 + r));
+    const int jmin = std::max(0, (int)(u0 - r)), jmax = std::min((int)acc.getWidth() - 1, (int)(u0 + r));
+    for (int i = imin; i <= imax; i++) {
+      for (int j = jmin; j <= jmax; j++) {
+        const double d2 = (j - u0) * (j - u0) + (i - v0) * (i - v0);
+        acc[i][j] += blob.amplitude * exp(-d2 / (2 * blob.sigma * blob.sigma));
+      }
+    }
+  }
+  I.resize(acc.getHeight(), acc.getWidth());
+  for (unsigned int i = 0; i < acc.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)std::max(0., std::min(255., acc.bitmap[i] + 0.5));
+  }
+}
+
+// Check that most of the features moved by (tu, tv) since the reference
+// positions. A few features close to the image borders may drift.
+bool checkMotion(const vpKltTracker &klt, const std::vector<vpImagePoint> &ref, const std::vector<long> &refId,
+                 double tu, double tv, const char *name)
+{
+  double sumErr = 0.;
+  int nbInliers = 0;
+  for (int i = 0; i < klt.getNbFeatures(); i++) {
+    long id;
+    float x, y;
+    klt.getFeature(i, id, x, y);
+    size_t k = 0;
+    while (k < refId.size() && refId[k] != id)
+      k++;
+    if (k == refId.size()) {
+      std::cerr << name << ": unknown feature id " << id << std::endl;
+      return false;
+    }
+    const double err = sqrt(vpMath::sqr(x - ref[k].get_u() - tu) + vpMath::sqr(y - ref[k].get_v() - tv));
+    if (err < 0.25) {
+      sumErr += err;
+      nbInliers++;
+    }
+  }
+  const double meanErr = nbInliers > 0 ? sumErr / nbInliers : 0.;
+  std::cout << name << ": " << klt.getNbFeatures() << "/" << ref.size() << " features tracked, " << nbInliers
+            << " inliers with a mean error of " << meanErr << " px" << std::endl;
+  return nbInliers >= (int)(0.9 * ref.size()) && meanErr < 0.05;
+}
+}
+
+int main()
+{
+  vpUniRand rand(7);
+  std::vector<Blob> blobs;
+  for (unsigned int b = 0; b < 400; b++) {
+    Blob blob;
+    blob.u = 640 * rand();
+    blob.v = 480 * rand();
+    blob.sigma = 2.5 + 4 * rand();
+    blob.amplitude = rand() < 0.5 ? -70 - 30 * rand() : 70 + 30 * rand();
+    blobs.push_back(blob);
+  }
+
+  vpImage<unsigned char> I0, I1, I2;
+  generate(blobs, 0., 0., I0);
+  generate(blobs, 2.7, -1.4, I1);
+  generate(blobs, 9.2, 3.1, I2);
+
+  vpKltTracker klt;
+  klt.setMaxFeatures(300);
+  klt.setWindowSize(11);
+  klt.setQuality(0.01);
+  klt.setMinDistance(12);
+  klt.setBlockSize(5);
+  klt.setUseHarris(0);
+  klt.setPyramidLevels(3);
+
+  klt.initTracking(I0);
+  std::vector<vpImagePoint> ref = klt.getFeatures();
+  std::vector<long> refId = klt.getFeaturesId();
+  std::cout << "Detected " << ref.size() << " features" << std::endl;
+  if (ref.size() < 100 || (int)ref.size() > klt.getMaxFeatures()) {
+    std::cerr << "Unexpected number of features" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < ref.size(); i++) {
+    for (size_t j = i + 1; j < ref.size(); j++) {
+      if (vpImagePoint::distance(ref[i], ref[j]) < klt.getMinDistance() - 1.) {
+        std::cerr << "Features " << i << " and " << j << " are too close" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Two successive frames, the second one with a larger motion
+  klt.track(I1);
+  if (!checkMotion(klt, ref, refId, 2.7, -1.4, "Frame 1")) {
+    return EXIT_FAILURE;
+  }
+  klt.track(I2);
+  if (!checkMotion(klt, ref, refId, 9.2, 3.1, "Frame 2")) {
+    return EXIT_FAILURE;
+  }
+
+  // A single level is enough with a close initial guess
+  klt.initTracking(I0, ref, refId);
+  klt.setPyramidLevels(0);
+  std::vector<vpImagePoint> guess = ref;
+  for (size_t i = 0; i < guess.size(); i++) {
+    guess[i].set_uv(guess[i].get_u() + 9., guess[i].get_v() + 3.);
+  }
+  klt.setInitialGuess(guess);
+  klt.track(I2);
+  if (!checkMotion(klt, ref, refId, 9.2, 3.1, "Initial guess")) {
+    return EXIT_FAILURE;
+  }
+
+  // Detection restricted to the left half of the image
+  vpImage<unsigned char> mask(I0.getHeight(), I0.getWidth(), 0);
+  for (unsigned int i = 0; i < mask.getHeight(); i++) {
+    for (unsigned int j = 0; j < mask.getWidth() / 2; j++) {
+      mask[i][j] = 255;
+    }
+  }
+  klt.initTracking(I0, &mask);
+  if (klt.getNbFeatures() == 0) {
+    std::cerr << "No feature detected in the mask" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < klt.getNbFeatures(); i++) {
+    long id;
+    float x, y;
+    klt.getFeature(i, id, x, y);
+    if (x >= mask.getWidth() / 2) {
+      std::cerr << "Feature " << id << " detected outside of the mask" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "testKltTracker is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
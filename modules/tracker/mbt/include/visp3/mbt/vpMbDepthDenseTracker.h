@@ -110,6 +110,8 @@ public:
   virtual void track(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud);
 #endif
   virtual void track(const std::vector<vpColVector> &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpImage<uint16_t> &depth, const double depthScale);
 
 protected:
   //! Set of faces describing the object used only for display with scan line.
@@ -136,6 +138,8 @@ protected:
   vpColVector m_w_depthDense;
   //! Weighted error
   vpColVector m_weightedError_depthDense;
+  //! Normalized coordinates of the pixels of the depth images
+  vpMbtDepthRayTable m_depthDenseRayTable;
 #if DEBUG_DISPLAY_DEPTH_DENSE
   vpDisplay *m_debugDisp_depthDense;
   vpImage<unsigned char> m_debugImage_depthDense;
@@ -143,6 +147,8 @@ protected:
 
   void addFace(vpMbtPolygon &polygon, const bool alreadyClose);
 
+  void addVVSDepthDenseNormalEquations(const double *const w, vpMatrix &LTL, vpColVector &LTR) const;
+
   void computeVisibility(const unsigned int width, const unsigned int height);
 
   void computeVVS();
@@ -166,5 +172,8 @@ protected:
 #endif
   void segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                          const unsigned int height);
+  void segmentPointCloud(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height);
+  void segmentPointCloud(const vpMbtDepthPoints &points);
+  void segmentPointCloud(const vpImage<uint16_t> &depth, const double depthScale);
 };
 #endif
@@ -113,6 +113,8 @@ public:
   virtual void track(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud);
 #endif
   virtual void track(const std::vector<vpColVector> &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpImage<uint16_t> &depth, const double depthScale);
 
 protected:
   //! Method to estimate the desired features
@@ -149,6 +151,8 @@ protected:
   vpColVector m_w_depthNormal;
   //! Weighted error
   vpColVector m_weightedError_depthNormal;
+  //! Normalized coordinates of the pixels of the depth images
+  vpMbtDepthRayTable m_depthNormalRayTable;
 #if DEBUG_DISPLAY_DEPTH_NORMAL
   vpDisplay *m_debugDisp_depthNormal;
   vpImage<unsigned char> m_debugImage_depthNormal;
@@ -177,5 +181,8 @@ protected:
 #endif
   void segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                          const unsigned int height);
+  void segmentPointCloud(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height);
+  void segmentPointCloud(const vpMbtDepthPoints &points);
+  void segmentPointCloud(const vpImage<uint16_t> &depth, const double depthScale);
 };
 #endif
@@ -516,6 +516,9 @@ protected:
   virtual void computeVVSInit();
   virtual void computeVVSInteractionMatrixAndResidu();
   virtual void computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> &I);
+  void computeVVSEdgeResidu(const vpImage<unsigned char> &I);
+  void stackVVSEdgeInteractionMatrix();
+  void addVVSEdgeNormalEquations(const double *const w, vpMatrix &LTL, vpColVector &LTR) const;
   virtual void computeVVSWeights();
   using vpMbTracker::computeVVSWeights;
 
@@ -197,6 +197,13 @@ public:
 
   virtual inline vpColVector getRobustWeights() const { return m_w; }
 
+  /*!
+    Return true if the per-camera tracking stages are run concurrently.
+
+    \sa setUseParallelTracking()
+  */
+  inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+
   virtual void init(const vpImage<unsigned char> &I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -272,6 +279,8 @@ public:
   virtual void setClipping(const unsigned int &flags1, const unsigned int &flags2);
   virtual void setClipping(const std::map<std::string, unsigned int> &mapOfClippingFlags);
 
+  virtual void setCovarianceComputation(const bool &flag);
+
   virtual void setDepthDenseFilteringMaxDistance(const double maxDistance);
   virtual void setDepthDenseFilteringMethod(const int method);
   virtual void setDepthDenseFilteringMinDistance(const double minDistance);
@@ -348,6 +357,7 @@ public:
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
   virtual void setScanLineVisibilityTest(const bool &v);
+  virtual void setZBufferVisibilityTest(const bool &v);
 
   virtual void setTrackerType(const int type);
   virtual void setTrackerType(const std::map<std::string, int> &mapOfTrackerTypes);
@@ -358,6 +368,8 @@ public:
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 #endif
+  virtual void setUseModelCache(const bool use);
+  virtual void setUseParallelTracking(const bool parallel);
 
   virtual void testTracking();
 
@@ -372,6 +384,13 @@ public:
                      std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                      std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                     std::map<std::string, const vpMatrix *> &mapOfPointClouds,
+                     std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                     std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                     std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                     std::map<std::string, double> &mapOfDepthScales);
 
 protected:
   virtual void computeProjectionError();
@@ -383,6 +402,8 @@ protected:
   virtual void computeVVSInteractionMatrixAndResidu();
   virtual void computeVVSInteractionMatrixAndResidu(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                                     std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist);
+  void computeVVSNormalEquations(const std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist,
+                                 const vpColVector *const W, vpMatrix &LTL, vpColVector &LTR) const;
   using vpMbTracker::computeVVSWeights;
   virtual void computeVVSWeights();
 
@@ -404,6 +425,13 @@ protected:
                            std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                           std::map<std::string, const vpMatrix *> &mapOfPointClouds,
+                           std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                           std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                           std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                           std::map<std::string, double> &mapOfDepthScales);
 
 private:
   class TrackerWrapper : public vpMbEdgeTracker,
@@ -424,8 +452,6 @@ private:
     int m_trackerType;
     //! Robust weights
     vpColVector m_w;
-    //! Weighted error
-    vpColVector m_weightedError;
 
     TrackerWrapper();
     explicit TrackerWrapper(const int trackerType);
@@ -488,6 +514,10 @@ private:
     virtual void computeVVSInteractionMatrixAndResidu();
     using vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu;
     virtual void computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> *const ptr_I);
+    void computeVVSNormalEquations(const double *const W, vpMatrix &LTL, vpColVector &LTR) const;
+    void computeVVSResidualWeights(const double factorEdge, const double factorKlt, const double factorDepth,
+                                   const double factorDepthDense, vpColVector &W, double &num, double &den);
+    void computeVVSStackedInteractionMatrix();
     using vpMbTracker::computeVVSWeights;
     virtual void computeVVSWeights();
 
@@ -513,8 +543,25 @@ private:
     virtual void preTracking(const vpImage<unsigned char> *const ptr_I = NULL,
                              const std::vector<vpColVector> *const point_cloud = NULL,
                              const unsigned int pointcloud_width = 0, const unsigned int pointcloud_height = 0);
+    virtual void preTracking(const vpImage<unsigned char> *const ptr_I, const vpMatrix *const point_cloud,
+                             const unsigned int pointcloud_width, const unsigned int pointcloud_height);
+    virtual void preTracking(const vpImage<unsigned char> *const ptr_I, const vpImage<uint16_t> *const depth,
+                             const double depthScale);
+
+  private:
+    void preTrackingDepth(const vpMbtDepthPoints &points);
+    void preTrackingImage(const vpImage<unsigned char> *const ptr_I);
   };
 
+  // Loop body running one tracking stage for a range of cameras
+  class TrackerStageBody;
+
+  template <class DepthInput>
+  void checkTrackingInputs(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                           std::map<std::string, DepthInput> &mapOfDepthInputs, const char *missingDepthMessage);
+  void computeVVSAndPostTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                 TrackerStageBody &postTracking);
+
 protected:
   //! (s - s*)
   vpColVector m_error;
@@ -538,7 +585,7 @@ protected:
   double m_thresholdOutlier;
   //! Robust weights
   vpColVector m_w;
-  //! Weighted error
-  vpColVector m_weightedError;
+  //! If true, the per-camera tracking stages are run concurrently
+  bool m_useParallelTracking;
 };
 #endif
@@ -46,6 +46,7 @@
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/mbt/vpMbScanLine.h>
+#include <visp3/mbt/vpMbZBuffer.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
 #ifdef VISP_HAVE_OGRE
@@ -75,6 +76,9 @@ private:
   //! Number of visible polygon
   unsigned int nbVisiblePolygon;
   vpMbScanLine scanlineRender;
+  //! Software z-buffer used instead of the scanline renderer when enabled
+  vpMbZBuffer zbufferRender;
+  bool useZBuffer;
 
 #ifdef VISP_HAVE_OGRE
   vpImage<unsigned char> ogreBackground;
@@ -112,6 +116,32 @@ public:
                             const bool &displayResults = false);
 
   vpMbScanLine &getMbScanLineRenderer() { return scanlineRender; }
+  //! Get the software z-buffer renderer, used when isZBufferRender() is true.
+  vpMbZBuffer &getMbZBufferRenderer() { return zbufferRender; }
+
+  /*!
+    Get the mask of the visible faces computed by the last call to
+    computeScanLineRender().
+  */
+  const vpImage<unsigned char> &getMask() const
+  {
+    return useZBuffer ? zbufferRender.getMask() : scanlineRender.getMask();
+  }
+
+  /*!
+    Get the index of the polygon visible at each pixel, -1 if none, computed
+    by the last call to computeScanLineRender().
+  */
+  const vpImage<int> &getPrimitiveIDs() const
+  {
+    return useZBuffer ? zbufferRender.getPrimitiveIDs() : scanlineRender.getPrimitiveIDs();
+  }
+
+  /*!
+    Return true if computeScanLineRender() uses the software z-buffer
+    renderer instead of the scanline renderer.
+  */
+  bool isZBufferRender() const { return useZBuffer; }
 
 #ifdef VISP_HAVE_OGRE
   void displayOgre(const vpHomogeneousMatrix &cMo);
@@ -274,6 +304,16 @@ public:
 
     \return Size of the list.
   */
+  /*!
+    Use the software z-buffer renderer (vpMbZBuffer) instead of the scanline
+    renderer (vpMbScanLine) in computeScanLineRender() and
+    computeScanLineQuery(). The z-buffer also gives the depth map predicted
+    from the model, see getMbZBufferRenderer().
+
+    \param v : true to use the z-buffer renderer.
+  */
+  inline void setZBufferRender(bool v) { useZBuffer = v; }
+
   inline unsigned int size() const { return (unsigned int)Lpol.size(); }
 };
 
@@ -281,7 +321,8 @@ public:
   Basic constructor.
 */
 template <class PolygonType>
-vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces() : Lpol(), nbVisiblePolygon(0), scanlineRender()
+vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces()
+  : Lpol(), nbVisiblePolygon(0), scanlineRender(), zbufferRender(), useZBuffer(false)
 {
 #ifdef VISP_HAVE_OGRE
   ogreInitialised = false;
@@ -329,7 +370,8 @@ template <class PolygonType> vpMbHiddenFaces<PolygonType>::~vpMbHiddenFaces()
 */
 template <class PolygonType>
 vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces(const vpMbHiddenFaces<PolygonType> &copy)
-  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender)
+  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender),
+    zbufferRender(copy.zbufferRender), useZBuffer(copy.useZBuffer)
 #ifdef VISP_HAVE_OGRE
     ,
     ogreBackground(copy.ogreBackground), ogreInitialised(copy.ogreInitialised), nbRayAttempts(copy.nbRayAttempts),
@@ -349,6 +391,8 @@ template <class PolygonType> void swap(vpMbHiddenFaces<PolygonType> &first, vpMb
   swap(first.Lpol, second.Lpol);
   swap(first.nbVisiblePolygon, second.nbVisiblePolygon);
   swap(first.scanlineRender, second.scanlineRender);
+  swap(first.zbufferRender, second.zbufferRender);
+  swap(first.useZBuffer, second.useZBuffer);
 #ifdef VISP_HAVE_OGRE
   swap(first.ogreInitialised, second.ogreInitialised);
   swap(first.nbRayAttempts, second.nbRayAttempts);
@@ -454,7 +498,8 @@ void vpMbHiddenFaces<PolygonType>::computeClippedPolygons(const vpHomogeneousMat
 
 /*!
   Render the scene in order to perform, later via computeScanLineQuery(),
-  visibility tests.
+  visibility tests. The scene is rendered by the software z-buffer when
+  setZBufferRender() is enabled, by the scanline renderer otherwise.
 
   \param cam : Camera parameters that will be used to render the scene.
   \param w : Width of the render window.
@@ -483,7 +528,12 @@ void vpMbHiddenFaces<PolygonType>::computeScanLineRender(const vpCameraParameter
     }
   }
 
-  scanlineRender.drawScene(listPolyClipped, listPolyIndices, cam, w, h);
+  if (useZBuffer) {
+    zbufferRender.setMaskBorder(scanlineRender.getMaskBorder());
+    zbufferRender.drawScene(listPolyClipped, listPolyIndices, cam, w, h);
+  } else {
+    scanlineRender.drawScene(listPolyClipped, listPolyIndices, cam, w, h);
+  }
 }
 
 /*!
@@ -502,7 +552,10 @@ void vpMbHiddenFaces<PolygonType>::computeScanLineQuery(const vpPoint &a, const
                                                         std::vector<std::pair<vpPoint, vpPoint> > &lines,
                                                         const bool &displayResults)
 {
-  scanlineRender.queryLineVisibility(a, b, lines, displayResults);
+  if (useZBuffer)
+    zbufferRender.queryLineVisibility(a, b, lines);
+  else
+    scanlineRender.queryLineVisibility(a, b, lines, displayResults);
 }
 
 /*!
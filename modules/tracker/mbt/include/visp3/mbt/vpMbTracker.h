@@ -66,6 +66,7 @@
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpRobust.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbtModelCache.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
 #include <visp3/mbt/vpMbtDistanceCircle.h>
@@ -225,6 +226,16 @@ protected:
   vpCameraParameters m_projectionErrorCam;
   //! Mask used to disable tracking on a part of image
   const vpImage<bool> *m_mask;
+  //! If true, load the CAO models from their binary cache when it is up to
+  //! date, and write it otherwise
+  bool m_useModelCache;
+  //! Description of the last loaded CAO model
+  vpMbtModelCache m_modelCache;
+  //! True while the primitives of a CAO model are recorded in m_modelCache
+  bool m_recordModelCache;
+  //! Projection error lines sorted by the X coordinate of their first point,
+  //! used to find the lines shared by several faces
+  std::multimap<double, vpMbtDistanceLine *> m_projectionErrorLineIndex;
 
 public:
   vpMbTracker();
@@ -297,6 +308,13 @@ public:
    */
   virtual inline unsigned int getMaxIter() const { return m_maxIter; }
 
+  /*!
+    Get the description of the last CAO model loaded with loadModel(), with
+    the face normals and the edge adjacency computed when it was cached.
+    It is empty if the model cache is disabled, see setUseModelCache().
+  */
+  virtual const vpMbtModelCache &getModelCache() const { return m_modelCache; }
+
   /*!
     Get the error angle between the gradient direction of the model features
     projected at the resulting pose and their normal. The error is expressed
@@ -548,6 +566,18 @@ public:
 
   virtual void setMask(const vpImage<bool> &mask) { m_mask = &mask; }
 
+  /*!
+    Enable or disable the binary cache of the CAO models (disabled by
+    default). When enabled, loadModel() writes the parsed model in a binary file next to
+    the .cao file (see vpMbtModelCache::getCacheFilename()), and loads it
+    from this file instead of parsing the text as long as none of the
+    parsed files has changed. The cache is silently not written if the
+    directory of the model is read-only.
+
+    \param use : true to use the model cache.
+  */
+  virtual void setUseModelCache(const bool use) { m_useModelCache = use; }
+
   /*!
     Set the minimal error (previous / current estimation) to determine if
     there is convergence or not.
@@ -586,6 +616,17 @@ public:
 
   virtual void setScanLineVisibilityTest(const bool &v) { useScanLine = v; }
 
+  /*!
+    Use a software z-buffer (vpMbZBuffer) instead of the scanline renderer
+    for the scanline visibility test enabled with
+    setScanLineVisibilityTest(). It also renders the depth map predicted
+    from the model, available with
+    getFaces().getMbZBufferRenderer().getDepthMap().
+
+    \param v : true to use the z-buffer renderer.
+  */
+  virtual void setZBufferVisibilityTest(const bool &v) { faces.setZBufferRender(v); }
+
   virtual void setOgreVisibilityTest(const bool &v);
 
   void savePose(const std::string &filename) const;
@@ -756,6 +797,9 @@ protected:
                                           const vpHomogeneousMatrix &cMoPrev, const vpMatrix &L_true,
                                           const vpMatrix &LVJ_true, const vpColVector &error);
 
+  static void addVVSNormalEquations(const vpMatrix &L, const vpColVector &error, const double *const w,
+                                    vpMatrix &LTL, vpColVector &LTR);
+
   void computeJTR(const vpMatrix &J, const vpColVector &R, vpColVector &JTR) const;
 
   double computeProjectionErrorImpl(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo,
@@ -765,12 +809,17 @@ protected:
                                                  const vpColVector &m_error_prev, const vpHomogeneousMatrix &cMoPrev,
                                                  double &mu, bool &reStartFromLastIncrement,
                                                  vpColVector *const w = NULL, const vpColVector *const m_w_prev = NULL);
+  void computeVVSCheckRank(const vpMatrix &LTL, bool &isoJoIdentity_);
   virtual void computeVVSInit() = 0;
   virtual void computeVVSInteractionMatrixAndResidu() = 0;
   virtual void computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, vpMatrix &L, vpMatrix &LTL,
                                         vpColVector &R, const vpColVector &error, vpColVector &error_prev,
                                         vpColVector &LTR, double &mu, vpColVector &v, const vpColVector *const w = NULL,
                                         vpColVector *const m_w_prev = NULL);
+  void computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, const vpMatrix &LTL,
+                                const vpColVector &LTR, const vpColVector &error, vpColVector &error_prev, double &mu,
+                                vpColVector &v, const vpColVector *const w = NULL,
+                                vpColVector *const m_w_prev = NULL);
   virtual void computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w);
 
 #ifdef VISP_HAVE_COIN3D
@@ -834,6 +883,7 @@ protected:
   void initProjectionErrorFaceFromLines(vpMbtPolygon &polygon);
 
   virtual void loadVRMLModel(const std::string &modelFile);
+  void loadCAOModelFromCache(int &startIdFace, const bool verbose = false);
   virtual void loadCAOModel(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename,
                             int &startIdFace, const bool verbose = false, const bool parent = true,
                             const vpHomogeneousMatrix &T=vpHomogeneousMatrix());
@@ -872,6 +922,8 @@ protected:
   inline std::string &trim(std::string &s) const { return ltrim(rtrim(s)); }
 
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
+  std::vector<vpMbtDistanceLine *> sameLines(const std::multimap<double, vpMbtDistanceLine *> &index,
+                                             const vpPoint &P1, const vpPoint &P2) const;
 };
 
 #endif
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Software z-buffer rendering of the polygons of a CAD model.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbZBuffer.h
+  \brief Tiled software z-buffer renderer used to test the visibility of the
+  faces and edges of a CAD model.
+*/
+
+#ifndef vpMbZBuffer_HH
+#define vpMbZBuffer_HH
+
+#include <utility>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbZBuffer
+
+  \ingroup group_mbt_faces
+
+  \brief Software z-buffer renderer of polygons already transformed and
+  clipped in the camera frame.
+
+  It is an alternative to vpMbScanLine for the visibility tests of the
+  model-based trackers, and does not need Ogre or a display. The image is
+  split into square tiles and the tiles are rendered in parallel by
+  vpThreadPool. Each polygon is filled span by span within a tile, and the
+  inverse of the depth is interpolated linearly, so that the per-pixel cost
+  is one multiply-add and one comparison.
+
+  One call to drawScene() per frame fills reusable buffers that give:
+  - the index of the visible polygon of each pixel, see getPrimitiveIDs(),
+  - the depth of each pixel, that is the depth map predicted from the model
+    and the pose, see getDepthMap(),
+  - a mask of the visible faces, see getMask(),
+  - the visible parts of the edges of the model, see queryLineVisibility().
+*/
+class VISP_EXPORT vpMbZBuffer
+{
+public:
+  vpMbZBuffer();
+
+  void drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
+                 const std::vector<int> &listPolyIndices, const vpCameraParameters &cam, unsigned int width,
+                 unsigned int height);
+
+  /*!
+    Get the depth map rendered by the last call to drawScene(). Pixels that
+    do not belong to a polygon are set to 0.
+  */
+  const vpImage<float> &getDepthMap() const { return m_depth; }
+  //! Get the relative tolerance of the depth test of queryLineVisibility().
+  double getDepthTolerance() const { return m_depthTolerance; }
+  //! Get the number of pixels removed along the borders of the faces in the
+  //! mask.
+  unsigned int getMaskBorder() const { return m_maskBorder; }
+  /*!
+    Get the mask of the visible faces rendered by the last call to
+    drawScene(), eroded by getMaskBorder() pixels along the face borders.
+  */
+  const vpImage<unsigned char> &getMask() const { return m_mask; }
+  /*!
+    Get the index of the polygon visible at each pixel, -1 if none,
+    rendered by the last call to drawScene().
+  */
+  const vpImage<int> &getPrimitiveIDs() const { return m_ids; }
+  //! Get the size of the square tiles rendered in parallel.
+  unsigned int getTileSize() const { return m_tileSize; }
+
+  bool isVisible(const vpPoint &P, double tolerance = -1) const;
+
+  void queryLineVisibility(const vpPoint &a, const vpPoint &b, std::vector<std::pair<vpPoint, vpPoint> > &lines) const;
+
+  /*!
+    Set the relative tolerance of the depth tests of isVisible() and
+    queryLineVisibility(). A point is hidden if its depth exceeds the one of
+    the z-buffer by more than this ratio.
+  */
+  void setDepthTolerance(double tolerance) { m_depthTolerance = tolerance; }
+  //! Set the number of pixels removed along the borders of the faces in the
+  //! mask.
+  void setMaskBorder(unsigned int border) { m_maskBorder = border; }
+  //! Set the size of the square tiles rendered in parallel.
+  void setTileSize(unsigned int size) { m_tileSize = size > 0 ? size : 1; }
+
+protected:
+  //! Polygon projected in the image
+  struct vpZBufferPolygon {
+    //! Pixel coordinates (u, v) of the vertices
+    std::vector<std::pair<double, double> > uv;
+    //! Inverse depth as an affine function of the pixel coordinates:
+    //! 1/Z = a u + b v + c
+    double a, b, c;
+    //! Bounding box in pixels, clipped to the image
+    int umin, umax, vmin, vmax;
+    int id;
+  };
+
+  // Loop bodies rendering a range of tiles and building a range of rows of
+  // the mask
+  class RenderTilesBody;
+  class MaskRowsBody;
+
+  void buildMask();
+  bool isOccluded(int u, int v, double Z, double tolerance) const;
+  void renderTile(int tu, int tv, const std::vector<int> &tilePolygons);
+
+  unsigned int m_width, m_height;
+  vpCameraParameters m_cam;
+  unsigned int m_tileSize;
+  unsigned int m_maskBorder;
+  double m_depthTolerance;
+  std::vector<vpZBufferPolygon> m_polygons;
+  //! Inverse of the depth of each pixel, 0 for the background
+  vpImage<float> m_invDepth;
+  vpImage<float> m_depth;
+  vpImage<int> m_ids;
+  vpImage<unsigned char> m_mask;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Organized point cloud read by the depth trackers.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtDepthPoints_h_
+#define __vpMbtDepthPoints_h_
+
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/mbt/vpMbtDepthRayTable.h>
+
+/*!
+  \class vpMbtDepthPoints
+
+  \ingroup group_mbt_faces
+
+  \brief Read-only view of an organized point cloud, giving the 3D point of
+  a pixel whatever the storage of the point cloud. The depth faces extract
+  their points through this class, so that a single implementation handles
+  all the point cloud types accepted by the depth trackers:
+  - a std::vector<vpColVector> of (width x height) points,
+  - a contiguous (width x height) x 3 vpMatrix, each row containing the X, Y,
+    Z coordinates of a point,
+  - a raw depth image, the point of a pixel being its ray \f$(x, y, 1)\f$
+    taken from a vpMbtDepthRayTable multiplied by its depth converted into
+    meters. Only the pixels that are read are back-projected.
+
+  The point cloud is not copied and must outlive the view.
+*/
+class VISP_EXPORT vpMbtDepthPoints
+{
+public:
+  vpMbtDepthPoints(const std::vector<vpColVector> &point_cloud, const unsigned int width, const unsigned int height);
+  vpMbtDepthPoints(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height);
+  vpMbtDepthPoints(const vpImage<uint16_t> &depth, const double depthScale, const vpMbtDepthRayTable &rays);
+
+  //! Get the height of the point cloud.
+  inline unsigned int getHeight() const { return m_height; }
+
+  /*!
+    Get the 3D point of a pixel.
+
+    \param i : Row of the pixel.
+    \param j : Column of the pixel.
+    \param X : X coordinate of the point.
+    \param Y : Y coordinate of the point.
+    \param Z : Depth of the point.
+    \return False if the pixel has no valid depth, in which case \e X, \e Y
+    and \e Z are not set.
+  */
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    if (m_depth != NULL) {
+      const uint16_t d = (*m_depth)[i][j];
+      if (d == 0) {
+        return false;
+      }
+
+      const double *ray = m_rays->getRay(i, j);
+      Z = m_depthScale * d;
+      X = ray[0] * Z;
+      Y = ray[1] * Z;
+      return true;
+    }
+
+    const double *P = m_colVectors != NULL ? (*m_colVectors)[i * m_width + j].data
+                                           : m_data + ((size_t)i * m_width + j) * m_stride;
+    if (!(P[2] > 0)) {
+      return false;
+    }
+
+    X = P[0];
+    Y = P[1];
+    Z = P[2];
+    return true;
+  }
+
+  //! Get the width of the point cloud.
+  inline unsigned int getWidth() const { return m_width; }
+
+protected:
+  unsigned int m_width;
+  unsigned int m_height;
+  //! Point cloud stored as a vector of points, or NULL
+  const std::vector<vpColVector> *m_colVectors;
+  //! Coordinates of the first point of a contiguous point cloud, or NULL
+  const double *m_data;
+  //! Number of values between two consecutive points of m_data
+  unsigned int m_stride;
+  //! Raw depth image, or NULL
+  const vpImage<uint16_t> *m_depth;
+  //! Scale factor converting the raw depth values into meters
+  double m_depthScale;
+  //! Rays of the pixels of m_depth
+  const vpMbtDepthRayTable *m_rays;
+};
+
+#endif
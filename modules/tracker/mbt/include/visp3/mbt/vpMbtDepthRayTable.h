@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Back-projection rays of the pixels of a depth image.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtDepthRayTable_h_
+#define __vpMbtDepthRayTable_h_
+
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpMbtDepthRayTable
+
+  \ingroup group_mbt_faces
+
+  \brief Table of the normalized coordinates \f$(x, y)\f$ of each pixel of a
+  depth image, used by the depth trackers to back-project the depth
+  \f$Z\f$ of a pixel into the 3D point \f$(x Z, y Z, Z)\f$ without
+  converting the whole image into a point cloud.
+
+  The table is computed once with vpPixelMeterConversion::convertPoint() and
+  is only recomputed when the camera parameters or the image size change.
+*/
+class VISP_EXPORT vpMbtDepthRayTable
+{
+public:
+  vpMbtDepthRayTable();
+
+  void build(const vpCameraParameters &cam, const unsigned int width, const unsigned int height);
+
+  //! Get the height of the depth image.
+  inline unsigned int getHeight() const { return m_height; }
+  /*!
+    Get the normalized coordinates of a pixel.
+
+    \param i : Row of the pixel.
+    \param j : Column of the pixel.
+    \return Pointer to the x and y coordinates of the pixel.
+  */
+  inline const double *getRay(const unsigned int i, const unsigned int j) const
+  {
+    return &m_rays[2 * ((size_t)i * m_width + j)];
+  }
+  //! Get the width of the depth image.
+  inline unsigned int getWidth() const { return m_width; }
+
+protected:
+  //! Camera parameters used to compute the table
+  vpCameraParameters m_cam;
+  //! Normalized x and y coordinates of each pixel, row by row
+  std::vector<double> m_rays;
+  unsigned int m_width;
+  unsigned int m_height;
+};
+
+#endif
@@ -42,7 +42,7 @@
 
 #include <visp3/core/vpConfig.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT)
 
 #include <map>
 
@@ -51,6 +51,7 @@
 #include <visp3/core/vpPlane.h>
 #include <visp3/core/vpPolygon3D.h>
 #include <visp3/klt/vpKltOpencv.h>
+#include <visp3/klt/vpKltTracker.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
 #include <visp3/vision/vpHomography.h>
 
@@ -60,7 +61,8 @@
   \brief Implementation of a polygon of the model containing points of
   interest. It is used by the model-based tracker KLT, and hybrid.
 
-  \warning This class is only available if OpenCV is installed, and used.
+  The points can be provided either by vpKltOpencv, when OpenCV is
+  available, or by the native vpKltTracker.
 
   \ingroup group_mbt_features
 */
@@ -113,6 +115,9 @@ private:
   double compute_1_over_Z(const double x, const double y);
   void computeP_mu_t(const double x_in, const double y_in, double &x_out, double &y_out, const vpMatrix &cHc0);
   bool isTrackedFeature(const int id);
+  template <class KltTracker>
+  unsigned int computeNbDetectedCurrentFromTracker(const KltTracker &_tracker, const vpImage<bool> *mask);
+  template <class KltTracker> void initFromTracker(const KltTracker &_tracker, const vpImage<bool> *mask);
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -137,7 +142,10 @@ public:
   vpMbtDistanceKltPoints();
   virtual ~vpMbtDistanceKltPoints();
 
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
   unsigned int computeNbDetectedCurrent(const vpKltOpencv &_tracker, const vpImage<bool> *mask = NULL);
+#endif
+  unsigned int computeNbDetectedCurrent(const vpKltTracker &_tracker, const vpImage<bool> *mask = NULL);
   void computeHomography(const vpHomogeneousMatrix &_cTc0, vpHomography &cHc0);
   void computeInteractionMatrixAndResidu(vpColVector &_R, vpMatrix &_J);
 
@@ -185,7 +193,10 @@ public:
 
   inline bool hasEnoughPoints() const { return enoughPoints; }
 
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
   void init(const vpKltOpencv &_tracker, const vpImage<bool> *mask = NULL);
+#endif
+  void init(const vpKltTracker &_tracker, const vpImage<bool> *mask = NULL);
 
   /*!
    Return if the klt points are used for tracking.
@@ -212,9 +223,10 @@ public:
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   void updateMask(cv::Mat &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
-#else
+#elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
   void updateMask(IplImage *mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
 #endif
+  void updateMask(vpImage<unsigned char> &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
 };
 
 #endif
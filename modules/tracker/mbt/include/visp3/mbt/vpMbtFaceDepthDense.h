@@ -46,7 +46,9 @@
 
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
+#include <visp3/mbt/vpMbtDepthPoints.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
+#include <visp3/mbt/vpMbtNormalEquations.h>
 
 #define DEBUG_DISPLAY_DEPTH_DENSE 0
 
@@ -107,8 +109,28 @@ public:
 #endif
                               , const vpImage<bool> *mask = NULL
   );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width, const unsigned int height,
+                              const vpMatrix &point_cloud, const unsigned int stepX,
+                              const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtDepthPoints &points, const unsigned int stepX,
+                              const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
 
   void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &error);
+  void computeResidu(const vpHomogeneousMatrix &cMo, double *const error);
+  void addNormalEquations(const unsigned int begin, const unsigned int end, const double *const error,
+                          const double *const w, vpMbtNormalEquations &ne) const;
 
   void computeVisibility();
   void computeVisibilityDisplay();
@@ -230,6 +252,10 @@ protected:
                   ,
                   double &distanceToFace);
 
+  void getPoint(const unsigned int i, const bool pairs, double &x, double &y, double &z) const;
+
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
+
+  static bool usePointPairs();
 };
 #endif
@@ -46,6 +46,7 @@
 
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
+#include <visp3/mbt/vpMbtDepthPoints.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
 
 #define DEBUG_DISPLAY_DEPTH_NORMAL 0
@@ -109,6 +110,23 @@ public:
 #endif
                               , const vpImage<bool> *mask = NULL
   );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width, const unsigned int height,
+                              const vpMatrix &point_cloud, vpColVector &desired_features,
+                              const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtDepthPoints &points,
+                              vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
 
   void computeInteractionMatrix(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &features);
 
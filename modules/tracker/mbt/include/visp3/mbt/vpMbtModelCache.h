@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Binary cache of the CAD models loaded by the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtModelCache.h
+  \brief Binary cache of a parsed CAD model with its precomputed structures.
+*/
+
+#ifndef vpMbtModelCache_HH
+#define vpMbtModelCache_HH
+
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbtModelCache
+
+  \ingroup group_mbt_faces
+
+  \brief Description of a CAD model as parsed from a .cao file (and the files
+  it includes), that can be saved to and loaded from a compact binary file.
+
+  When the cache is enabled with vpMbTracker::setUseModelCache(),
+  vpMbTracker::loadModel() records the points and the primitives (faces,
+  segments, cylinders and circles) of a .cao model in the order they are
+  declared, and saves them next to the model in a file named after
+  getCacheFilename(). When the same model is loaded again, and none of the
+  parsed files has changed since (same size and content hash), the
+  primitives are read back from this file instead of being parsed from the
+  text.
+
+  The file also stores structures computed once when it is written: the
+  normal of each face and the list of the unique edges of the model with
+  the faces that share them.
+
+  The file is a flat sequence of little-endian values: a header (magic
+  string, format version, parsed files, transformation applied to the
+  points and index of the first face), then the points, the primitives, the face normals and the edges.
+*/
+class VISP_EXPORT vpMbtModelCache
+{
+public:
+  //! Kind of primitive declared in a .cao model.
+  typedef enum {
+    POLYGON_FROM_LINES,  /*!< Face declared from the indexes of lines. */
+    POLYGON_FROM_POINTS, /*!< Face declared from the indexes of points. */
+    SEGMENT,             /*!< Line that does not belong to a face. */
+    CYLINDER,            /*!< Cylinder given by two points of its axis and its radius. */
+    CIRCLE               /*!< Circle given by its center, two points of its plane and its radius. */
+  } vpPrimitiveType;
+
+  //! Flags telling which LOD parameters are given in the model file.
+  typedef enum {
+    HAS_USE_LOD = 0x01,            /*!< useLod is set. */
+    HAS_MIN_LINE_LENGTH = 0x02,    /*!< minLineLengthThreshold is set. */
+    HAS_MIN_POLYGON_AREA = 0x04    /*!< minPolygonAreaThreshold is set. */
+  } vpLodParameterFlag;
+
+  /*!
+    Primitive of the model. The parameters that are not given in the model
+    file are resolved from the tracker settings when the model is loaded.
+  */
+  struct vpPrimitive {
+    vpPrimitiveType type;
+    //! Indexes of the points of the primitive in getPoints().
+    std::vector<unsigned int> points;
+    //! Index of the face, see getFirstFaceId().
+    int idFace;
+    //! Radius of a cylinder or a circle.
+    double radius;
+    std::string name;
+    //! Combination of vpLodParameterFlag.
+    unsigned int lodFlags;
+    bool useLod;
+    double minLineLengthThreshold;
+    double minPolygonAreaThreshold;
+
+    vpPrimitive()
+      : type(POLYGON_FROM_POINTS), points(), idFace(0), radius(0), name(), lodFlags(0), useLod(false),
+        minLineLengthThreshold(0), minPolygonAreaThreshold(0)
+    {
+    }
+  };
+
+  //! Unique edge of the model and the indexes of the primitives sharing it.
+  struct vpEdge {
+    unsigned int p1;
+    unsigned int p2;
+    std::vector<unsigned int> primitives;
+  };
+
+  //! Number of elements declared in the model files, as reported by the
+  //! parser.
+  struct vpModelInfo {
+    unsigned int nbPoints;
+    unsigned int nbLines;
+    unsigned int nbPolygonLines;
+    unsigned int nbPolygonPoints;
+    unsigned int nbCylinders;
+    unsigned int nbCircles;
+
+    vpModelInfo() : nbPoints(0), nbLines(0), nbPolygonLines(0), nbPolygonPoints(0), nbCylinders(0), nbCircles(0) {}
+  };
+
+  vpMbtModelCache();
+
+  unsigned int addPoints(const vpPoint *points, unsigned int nbPoints);
+  void addPrimitive(const vpPrimitive &primitive);
+  void addSourceFile(const std::string &filename);
+
+  void clear();
+  void computeStructures();
+
+  static std::string getCacheFilename(const std::string &modelFile);
+  //! Get the unique edges of the model, computed by computeStructures().
+  const std::vector<vpEdge> &getEdges() const { return m_edges; }
+  //! Get the normal of each primitive (null for the primitives that are
+  //! not faces), computed by computeStructures().
+  const std::vector<vpColVector> &getNormals() const { return m_normals; }
+  //! Get the index of the first face of the model when it was parsed. The
+  //! face indexes of the primitives are shifted by the difference with the
+  //! first index of the model when it is loaded.
+  int getFirstFaceId() const { return m_firstFaceId; }
+  //! Get the number of elements declared in the model files.
+  const vpModelInfo &getModelInfo() const { return m_info; }
+  //! Get the points of the model, expressed in the object frame after
+  //! getTransformation() was applied.
+  const std::vector<vpPoint> &getPoints() const { return m_points; }
+  //! Get the primitives in the order they are declared in the model files.
+  const std::vector<vpPrimitive> &getPrimitives() const { return m_primitives; }
+  //! Get the files that were parsed to build the model.
+  const std::vector<std::string> &getSourceFiles() const { return m_sourceFiles; }
+  //! Get the transformation applied to the points of the model files.
+  vpHomogeneousMatrix getTransformation() const { return m_T; }
+
+  bool isUpToDate() const;
+
+  bool load(const std::string &filename);
+  bool save(const std::string &filename) const;
+
+  //! Set the index of the first face of the model.
+  void setFirstFaceId(const int id) { m_firstFaceId = id; }
+  //! Set the number of elements declared in the model files.
+  void setModelInfo(const vpModelInfo &info) { m_info = info; }
+  //! Set the transformation applied to the points of the model files.
+  void setTransformation(const vpHomogeneousMatrix &T) { m_T = T; }
+
+protected:
+  std::vector<vpPoint> m_points;
+  std::vector<vpPrimitive> m_primitives;
+  std::vector<vpColVector> m_normals;
+  std::vector<vpEdge> m_edges;
+  //! Files parsed to build the model
+  std::vector<std::string> m_sourceFiles;
+  //! Size of each parsed file
+  std::vector<double> m_sourceSizes;
+  //! Hash of the content of each parsed file
+  std::vector<uint64_t> m_sourceHashes;
+  vpHomogeneousMatrix m_T;
+  int m_firstFaceId;
+  vpModelInfo m_info;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Accumulation of the normal equations of the model-based trackers.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtNormalEquations_h_
+#define __vpMbtNormalEquations_h_
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpMatrix.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+  Sums of the weighted normal equations L^T W^2 L (6x6, upper triangle) and
+  L^T W^2 e (6) of the rows of an interaction matrix, without storing the
+  rows. The features add their rows one by one; accumulate() runs them on
+  vpThreadPool, each fixed-size chunk of rows in its own accumulator, and
+  sums the accumulators in chunk order so that the result does not depend on
+  the number of threads.
+*/
+class VISP_EXPORT vpMbtNormalEquations
+{
+public:
+  /*
+    Rows of an interaction matrix, produced by the features themselves.
+  */
+  class VISP_EXPORT vpRows
+  {
+  public:
+    virtual ~vpRows() {}
+    //! Number of rows.
+    virtual unsigned int getNbRows() const = 0;
+    //! Add the weighted rows [begin, end) to \e ne.
+    virtual void addRows(unsigned int begin, unsigned int end, vpMbtNormalEquations &ne) const = 0;
+  };
+
+  vpMbtNormalEquations() { clear(); }
+
+  void clear()
+  {
+    for (unsigned int i = 0; i < 27; i++) {
+      m_data[i] = 0.0;
+    }
+  }
+
+  //! Add the row \e L (6 values) of residual \e e and weight \e w.
+  inline void addRow(const double *const L, const double w, const double e)
+  {
+    const double w2 = w * w;
+    double wL[6];
+    for (unsigned int j = 0; j < 6; j++) {
+      wL[j] = w2 * L[j];
+    }
+    unsigned int k = 0;
+    for (unsigned int r = 0; r < 6; r++) {
+      for (unsigned int j = r; j < 6; j++) {
+        m_data[k++] += wL[r] * L[j];
+      }
+    }
+    for (unsigned int r = 0; r < 6; r++) {
+      m_data[21 + r] += wL[r] * e;
+    }
+  }
+
+  void add(const vpMbtNormalEquations &ne);
+  void addTo(vpMatrix &LTL, vpColVector &LTR) const;
+
+  static void accumulate(const vpRows &rows, vpMatrix &LTL, vpColVector &LTR);
+
+private:
+  // Upper triangle of L^T W^2 L by rows, followed by L^T W^2 e
+  double m_data[27];
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+#endif
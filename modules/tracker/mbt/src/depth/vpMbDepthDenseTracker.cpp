@@ -33,6 +33,7 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 
 #include <visp3/core/vpConfig.h>
@@ -55,7 +56,8 @@
 vpMbDepthDenseTracker::vpMbDepthDenseTracker()
   : m_depthDenseHiddenFacesDisplay(), m_depthDenseI_dummyVisibility(), m_depthDenseListOfActiveFaces(),
     m_denseDepthNbFeatures(0), m_depthDenseFaces(), m_depthDenseSamplingStepX(2), m_depthDenseSamplingStepY(2),
-    m_error_depthDense(), m_L_depthDense(), m_robust_depthDense(), m_w_depthDense(), m_weightedError_depthDense()
+    m_error_depthDense(), m_L_depthDense(), m_robust_depthDense(), m_w_depthDense(), m_weightedError_depthDense(),
+    m_depthDenseRayTable()
 #if DEBUG_DISPLAY_DEPTH_DENSE
     ,
     m_debugDisp_depthDense(NULL), m_debugImage_depthDense()
@@ -89,8 +91,15 @@ void vpMbDepthDenseTracker::addFace(vpMbtPolygon &polygon, const bool alreadyClo
     return;
   }
 
-  // Copy hidden faces
-  m_depthDenseHiddenFacesDisplay = faces;
+  // Copy the hidden faces added since the last call, instead of the whole
+  // list, to keep the model loading linear in the number of faces
+  if (m_depthDenseHiddenFacesDisplay.size() > faces.size()) {
+    m_depthDenseHiddenFacesDisplay.reset();
+  }
+  for (unsigned int i = m_depthDenseHiddenFacesDisplay.size(); i < faces.size(); i++) {
+    m_depthDenseHiddenFacesDisplay.addPolygon(faces[i]);
+    *m_depthDenseHiddenFacesDisplay.getPolygon().back() = *faces[i];
+  }
 
   vpMbtFaceDepthDense *normal_face = new vpMbtFaceDepthDense;
   normal_face->m_hiddenFace = &faces;
@@ -167,7 +176,6 @@ void vpMbDepthDenseTracker::computeVVS()
   vpHomogeneousMatrix cMo_prev;
 
   bool isoJoIdentity_ = true;
-  vpVelocityTwistMatrix cVo;
   vpMatrix L_true, LVJ_true;
 
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
@@ -190,47 +198,35 @@ void vpMbDepthDenseTracker::computeVVS()
 
       // Compute DoF only once
       if (iter == 0) {
-        isoJoIdentity_ = true;
-        oJo.eye();
-
         // If all the 6 dof should be estimated, we check if the interaction
         // matrix is full rank. If not we remove automatically the dof that
         // cannot be estimated This is particularly useful when consering
         // circles (rank 5) and cylinders (rank 4)
-        if (isoJoIdentity_) {
-          cVo.buildFrom(cMo);
-
-          vpMatrix K; // kernel
-          unsigned int rank = (m_L_depthDense * cVo).kernel(K);
-          if (rank == 0) {
-            throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
-          }
-
-          if (rank != 6) {
-            vpMatrix I; // Identity
-            I.eye(6);
-            oJo = I - K.AtA();
-
-            isoJoIdentity_ = false;
-          }
-        }
+        LTL.resize(6, 6, false, false);
+        LTL = 0.0;
+        LTR.resize(6, false);
+        LTR = 0.0;
+        addVVSDepthDenseNormalEquations(NULL, LTL, LTR);
+        computeVVSCheckRank(LTL, isoJoIdentity_);
       }
 
       double num = 0.0, den = 0.0;
-      for (unsigned int i = 0; i < m_L_depthDense.getRows(); i++) {
+      for (unsigned int i = 0; i < m_error_depthDense.getRows(); i++) {
         // Compute weighted errors and stop criteria
         m_weightedError_depthDense[i] = m_w_depthDense[i] * m_error_depthDense[i];
         num += m_w_depthDense[i] * vpMath::sqr(m_error_depthDense[i]);
         den += m_w_depthDense[i];
-
-        // weight interaction matrix
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_depthDense[i][j] *= m_w_depthDense[i];
-        }
       }
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthDense, LTL, m_weightedError_depthDense,
-                               m_error_depthDense, error_prev, LTR, mu, v);
+      // Normal equations of the weighted interaction matrix, accumulated
+      // point by point without forming the matrix
+      LTL.resize(6, 6, false, false);
+      LTL = 0.0;
+      LTR.resize(6, false);
+      LTR = 0.0;
+      addVVSDepthDenseNormalEquations(m_w_depthDense.data, LTL, LTR);
+
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthDense, error_prev, mu, v);
 
       cMo_prev = cMo;
       cMo = vpExponentialMap::direct(v).inverse() * cMo;
@@ -255,7 +251,8 @@ void vpMbDepthDenseTracker::computeVVSInit()
     m_denseDepthNbFeatures += face->getNbFeatures();
   }
 
-  m_L_depthDense.resize(m_denseDepthNbFeatures, 6, false, false);
+  // The interaction matrix is only stacked to compute the covariance
+  m_L_depthDense.resize(computeCovariance ? m_denseDepthNbFeatures : 0, 6, false, false);
   m_error_depthDense.resize(m_denseDepthNbFeatures, false);
   m_weightedError_depthDense.resize(m_denseDepthNbFeatures, false);
 
@@ -270,18 +267,76 @@ void vpMbDepthDenseTracker::computeVVSInteractionMatrixAndResidu()
        it != m_depthDenseListOfActiveFaces.end(); ++it) {
     vpMbtFaceDepthDense *face = *it;
 
-    vpMatrix L_face;
-    vpColVector error;
+    if (computeCovariance) {
+      vpMatrix L_face;
+      vpColVector error;
 
-    face->computeInteractionMatrixAndResidu(cMo, L_face, error);
+      face->computeInteractionMatrixAndResidu(cMo, L_face, error);
 
-    m_error_depthDense.insert(start_index, error);
-    m_L_depthDense.insert(L_face, start_index, 0);
+      m_error_depthDense.insert(start_index, error);
+      m_L_depthDense.insert(L_face, start_index, 0);
+    } else {
+      face->computeResidu(cMo, m_error_depthDense.data + start_index);
+    }
 
-    start_index += error.getRows();
+    start_index += face->getNbFeatures();
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Rows of the interaction matrix of the active faces, produced by the faces
+class DenseRows : public vpMbtNormalEquations::vpRows
+{
+public:
+  DenseRows(const std::vector<vpMbtFaceDepthDense *> &faces, const double *const error, const double *const w)
+    : m_faces(faces), m_offsets(1, 0), m_error(error), m_w(w)
+  {
+    for (size_t i = 0; i < faces.size(); i++) {
+      m_offsets.push_back(m_offsets.back() + faces[i]->getNbFeatures());
+    }
+  }
+
+  unsigned int getNbRows() const { return m_offsets.back(); }
+
+  void addRows(unsigned int begin, unsigned int end, vpMbtNormalEquations &ne) const
+  {
+    size_t f = (size_t)(std::upper_bound(m_offsets.begin(), m_offsets.end(), begin) - m_offsets.begin()) - 1;
+    for (; begin < end; f++) {
+      const unsigned int offset = m_offsets[f];
+      const unsigned int last = std::min(end, m_offsets[f + 1]);
+      m_faces[f]->addNormalEquations(begin - offset, last - offset, m_error + offset,
+                                     m_w != NULL ? m_w + offset : NULL, ne);
+      begin = last;
+    }
+  }
+
+private:
+  const std::vector<vpMbtFaceDepthDense *> &m_faces;
+  std::vector<unsigned int> m_offsets;
+  const double *m_error;
+  const double *m_w;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Add the normal equations of the dense depth features from the
+  residuals of the last call to computeVVSInteractionMatrixAndResidu(). The
+  rows of the interaction matrix are accumulated point by point on the
+  thread pool and never stored.
+
+  \param w : Weights of the features, or NULL for unit weights.
+  \param LTL : Normal matrix (size 6x6), incremented.
+  \param LTR : Right-hand side (size 6), incremented.
+*/
+void vpMbDepthDenseTracker::addVVSDepthDenseNormalEquations(const double *const w, vpMatrix &LTL,
+                                                            vpColVector &LTR) const
+{
+  vpMbtNormalEquations::accumulate(DenseRows(m_depthDenseListOfActiveFaces, m_error_depthDense.data, w), LTL, LTR);
+}
+
 void vpMbDepthDenseTracker::computeVVSWeights()
 {
   m_robust_depthDense.MEstimator(m_error_depthDense, m_w_depthDense, 1e-3);
@@ -470,6 +525,7 @@ void vpMbDepthDenseTracker::resetTracker()
   m_maxIter = 30;
 
   faces.reset();
+  m_depthDenseHiddenFacesDisplay.reset();
 
   m_optimizationMethod = vpMbTracker::GAUSS_NEWTON_OPT;
 
@@ -589,12 +645,23 @@ void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXY
 
 void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                               const unsigned int height)
+{
+  segmentPointCloud(vpMbtDepthPoints(point_cloud, width, height));
+}
+
+void vpMbDepthDenseTracker::segmentPointCloud(const vpMatrix &point_cloud, const unsigned int width,
+                                              const unsigned int height)
+{
+  segmentPointCloud(vpMbtDepthPoints(point_cloud, width, height));
+}
+
+void vpMbDepthDenseTracker::segmentPointCloud(const vpMbtDepthPoints &points)
 {
   m_depthDenseListOfActiveFaces.clear();
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
   if (!m_debugDisp_depthDense->isInitialised()) {
-    m_debugImage_depthDense.resize(height, width);
+    m_debugImage_depthDense.resize(points.getHeight(), points.getWidth());
     m_debugDisp_depthDense->init(m_debugImage_depthDense, 50, 0, "Debug display dense depth tracker");
   }
 
@@ -610,7 +677,7 @@ void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &po
 #if DEBUG_DISPLAY_DEPTH_DENSE
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, m_depthDenseSamplingStepX,
+      if (face->computeDesiredFeatures(cMo, points, m_depthDenseSamplingStepX,
                                        m_depthDenseSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
                                        ,
@@ -645,6 +712,12 @@ void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &po
 #endif
 }
 
+void vpMbDepthDenseTracker::segmentPointCloud(const vpImage<uint16_t> &depth, const double depthScale)
+{
+  m_depthDenseRayTable.build(cam, depth.getWidth(), depth.getHeight());
+  segmentPointCloud(vpMbtDepthPoints(depth, depthScale, m_depthDenseRayTable));
+}
+
 void vpMbDepthDenseTracker::setCameraParameters(const vpCameraParameters &camera)
 {
   this->cam = camera;
@@ -718,6 +791,45 @@ void vpMbDepthDenseTracker::track(const std::vector<vpColVector> &point_cloud, c
   computeVisibility(width, height);
 }
 
+/*!
+  Track the object using an organized point cloud.
+
+  \param point_cloud : Point cloud stored as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix
+  can be reused between two frames with the same size to avoid any
+  reallocation.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+*/
+void vpMbDepthDenseTracker::track(const vpMatrix &point_cloud, const unsigned int width,
+                                  const unsigned int height)
+{
+  segmentPointCloud(point_cloud, width, height);
+
+  computeVVS();
+
+  computeVisibility(width, height);
+}
+
+/*!
+  Track the object using a raw depth image. The depth image is not converted
+  into a point cloud: only the pixels sampled inside the visible faces are
+  back-projected, with the camera parameters of the tracker (see
+  setCameraParameters()) that must be the ones of the depth camera.
+
+  \param depth : Raw depth image.
+  \param depthScale : Scale factor converting the raw depth values into
+  meters, for instance vpRealSense2::getDepthScale().
+*/
+void vpMbDepthDenseTracker::track(const vpImage<uint16_t> &depth, const double depthScale)
+{
+  segmentPointCloud(depth, depthScale);
+
+  computeVVS();
+
+  computeVisibility(depth.getWidth(), depth.getHeight());
+}
+
 void vpMbDepthDenseTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                        const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
@@ -58,7 +58,8 @@ vpMbDepthNormalTracker::vpMbDepthNormalTracker()
     m_depthNormalListOfDesiredFeatures(), m_depthNormalFaces(), m_depthNormalPclPlaneEstimationMethod(2),
     m_depthNormalPclPlaneEstimationRansacMaxIter(200), m_depthNormalPclPlaneEstimationRansacThreshold(0.001),
     m_depthNormalSamplingStepX(2), m_depthNormalSamplingStepY(2), m_depthNormalUseRobust(false), m_error_depthNormal(),
-    m_L_depthNormal(), m_robust_depthNormal(), m_w_depthNormal(), m_weightedError_depthNormal()
+    m_L_depthNormal(), m_robust_depthNormal(), m_w_depthNormal(), m_weightedError_depthNormal(),
+    m_depthNormalRayTable()
 #if DEBUG_DISPLAY_DEPTH_NORMAL
     ,
     m_debugDisp_depthNormal(NULL), m_debugImage_depthNormal()
@@ -88,8 +89,15 @@ void vpMbDepthNormalTracker::addFace(vpMbtPolygon &polygon, const bool alreadyCl
     return;
   }
 
-  // Copy hidden faces
-  m_depthNormalHiddenFacesDisplay = faces;
+  // Copy the hidden faces added since the last call, instead of the whole
+  // list, to keep the model loading linear in the number of faces
+  if (m_depthNormalHiddenFacesDisplay.size() > faces.size()) {
+    m_depthNormalHiddenFacesDisplay.reset();
+  }
+  for (unsigned int i = m_depthNormalHiddenFacesDisplay.size(); i < faces.size(); i++) {
+    m_depthNormalHiddenFacesDisplay.addPolygon(faces[i]);
+    *m_depthNormalHiddenFacesDisplay.getPolygon().back() = *faces[i];
+  }
 
   vpMbtFaceDepthNormal *normal_face = new vpMbtFaceDepthNormal;
   normal_face->m_hiddenFace = &faces;
@@ -171,7 +179,6 @@ void vpMbDepthNormalTracker::computeVVS()
   vpHomogeneousMatrix cMo_prev;
 
   bool isoJoIdentity_ = true;
-  vpVelocityTwistMatrix cVo;
   vpMatrix L_true, LVJ_true;
 
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
@@ -195,30 +202,16 @@ void vpMbDepthNormalTracker::computeVVS()
 
       // Compute DoF only once
       if (iter == 0) {
-        isoJoIdentity_ = true;
-        oJo.eye();
-
         // If all the 6 dof should be estimated, we check if the interaction
         // matrix is full rank. If not we remove automatically the dof that
         // cannot be estimated This is particularly useful when consering
         // circles (rank 5) and cylinders (rank 4)
-        if (isoJoIdentity_) {
-          cVo.buildFrom(cMo);
-
-          vpMatrix K; // kernel
-          unsigned int rank = (m_L_depthNormal * cVo).kernel(K);
-          if (rank == 0) {
-            throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
-          }
-
-          if (rank != 6) {
-            vpMatrix I; // Identity
-            I.eye(6);
-            oJo = I - K.AtA();
-
-            isoJoIdentity_ = false;
-          }
-        }
+        LTL.resize(6, 6, false, false);
+        LTL = 0.0;
+        LTR.resize(6, false);
+        LTR = 0.0;
+        addVVSNormalEquations(m_L_depthNormal, m_error_depthNormal, NULL, LTL, LTR);
+        computeVVSCheckRank(LTL, isoJoIdentity_);
       }
 
       double num = 0.0, den = 0.0;
@@ -227,15 +220,17 @@ void vpMbDepthNormalTracker::computeVVS()
         m_weightedError_depthNormal[i] = m_w_depthNormal[i] * m_error_depthNormal[i];
         num += m_w_depthNormal[i] * vpMath::sqr(m_error_depthNormal[i]);
         den += m_w_depthNormal[i];
-
-        // weight interaction matrix
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_depthNormal[i][j] *= m_w_depthNormal[i];
-        }
       }
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthNormal, LTL, m_weightedError_depthNormal,
-                               m_error_depthNormal, error_prev, LTR, mu, v);
+      // Normal equations of the weighted interaction matrix, without
+      // weighting it in place
+      LTL.resize(6, 6, false, false);
+      LTL = 0.0;
+      LTR.resize(6, false);
+      LTR = 0.0;
+      addVVSNormalEquations(m_L_depthNormal, m_error_depthNormal, m_w_depthNormal.data, LTL, LTR);
+
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthNormal, error_prev, mu, v);
 
       cMo_prev = cMo;
       cMo = vpExponentialMap::direct(v).inverse() * cMo;
@@ -473,6 +468,7 @@ void vpMbDepthNormalTracker::resetTracker()
   m_lambda = 1.0;
 
   faces.reset();
+  m_depthNormalHiddenFacesDisplay.reset();
 
   m_optimizationMethod = vpMbTracker::GAUSS_NEWTON_OPT;
 
@@ -598,13 +594,24 @@ void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointX
 
 void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                                const unsigned int height)
+{
+  segmentPointCloud(vpMbtDepthPoints(point_cloud, width, height));
+}
+
+void vpMbDepthNormalTracker::segmentPointCloud(const vpMatrix &point_cloud, const unsigned int width,
+                                               const unsigned int height)
+{
+  segmentPointCloud(vpMbtDepthPoints(point_cloud, width, height));
+}
+
+void vpMbDepthNormalTracker::segmentPointCloud(const vpMbtDepthPoints &points)
 {
   m_depthNormalListOfActiveFaces.clear();
   m_depthNormalListOfDesiredFeatures.clear();
 
 #if DEBUG_DISPLAY_DEPTH_NORMAL
   if (!m_debugDisp_depthNormal->isInitialised()) {
-    m_debugImage_depthNormal.resize(height, width);
+    m_debugImage_depthNormal.resize(points.getHeight(), points.getWidth());
     m_debugDisp_depthNormal->init(m_debugImage_depthNormal, 50, 0, "Debug display normal depth tracker");
   }
 
@@ -623,7 +630,7 @@ void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &p
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
 
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, desired_features, m_depthNormalSamplingStepX,
+      if (face->computeDesiredFeatures(cMo, points, desired_features, m_depthNormalSamplingStepX,
                                        m_depthNormalSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
                                        ,
@@ -659,6 +666,12 @@ void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &p
 #endif
 }
 
+void vpMbDepthNormalTracker::segmentPointCloud(const vpImage<uint16_t> &depth, const double depthScale)
+{
+  m_depthNormalRayTable.build(cam, depth.getWidth(), depth.getHeight());
+  segmentPointCloud(vpMbtDepthPoints(depth, depthScale, m_depthNormalRayTable));
+}
+
 void vpMbDepthNormalTracker::setCameraParameters(const vpCameraParameters &camera)
 {
   this->cam = camera;
@@ -759,6 +772,45 @@ void vpMbDepthNormalTracker::track(const std::vector<vpColVector> &point_cloud,
   computeVisibility(width, height);
 }
 
+/*!
+  Track the object using an organized point cloud.
+
+  \param point_cloud : Point cloud stored as a contiguous (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point. The matrix
+  can be reused between two frames with the same size to avoid any
+  reallocation.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+*/
+void vpMbDepthNormalTracker::track(const vpMatrix &point_cloud, const unsigned int width,
+                                   const unsigned int height)
+{
+  segmentPointCloud(point_cloud, width, height);
+
+  computeVVS();
+
+  computeVisibility(width, height);
+}
+
+/*!
+  Track the object using a raw depth image. The depth image is not converted
+  into a point cloud: only the pixels sampled inside the visible faces are
+  back-projected, with the camera parameters of the tracker (see
+  setCameraParameters()) that must be the ones of the depth camera.
+
+  \param depth : Raw depth image.
+  \param depthScale : Scale factor converting the raw depth values into
+  meters, for instance vpRealSense2::getDepthScale().
+*/
+void vpMbDepthNormalTracker::track(const vpImage<uint16_t> &depth, const double depthScale)
+{
+  segmentPointCloud(depth, depthScale);
+
+  computeVVS();
+
+  computeVisibility(depth.getWidth(), depth.getHeight());
+}
+
 void vpMbDepthNormalTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                         const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Organized point cloud read by the depth trackers.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/mbt/vpMbtDepthPoints.h>
+
+/*!
+  View of a point cloud stored as a vector of points.
+
+  \param point_cloud : Organized point cloud of (width x height) points.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+*/
+vpMbtDepthPoints::vpMbtDepthPoints(const std::vector<vpColVector> &point_cloud, const unsigned int width,
+                                   const unsigned int height)
+  : m_width(width), m_height(height), m_colVectors(&point_cloud), m_data(NULL), m_stride(0), m_depth(NULL),
+    m_depthScale(0.), m_rays(NULL)
+{
+}
+
+/*!
+  View of a point cloud stored as a contiguous matrix.
+
+  \param point_cloud : Organized point cloud stored as a (width x height) x 3
+  matrix, each row containing the X, Y, Z coordinates of a point.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+
+  \exception vpException::dimensionError : If the size of the matrix does not
+  match the size of the point cloud.
+*/
+vpMbtDepthPoints::vpMbtDepthPoints(const vpMatrix &point_cloud, const unsigned int width, const unsigned int height)
+  : m_width(width), m_height(height), m_colVectors(NULL), m_data(point_cloud.data), m_stride(point_cloud.getCols()),
+    m_depth(NULL), m_depthScale(0.), m_rays(NULL)
+{
+  if (width > 0 && height > 0 && (point_cloud.getRows() != width * height || point_cloud.getCols() < 3)) {
+    throw vpException(vpException::dimensionError, "Point cloud size (%dx%d) does not match %dx%d points!",
+                      point_cloud.getRows(), point_cloud.getCols(), width * height, 3);
+  }
+}
+
+/*!
+  View of a raw depth image as a point cloud.
+
+  \param depth : Raw depth image, a null value meaning no depth.
+  \param depthScale : Scale factor converting the raw depth values into
+  meters.
+  \param rays : Normalized coordinates of the pixels of the depth image,
+  computed with the camera parameters of the depth camera.
+
+  \exception vpException::dimensionError : If the size of the ray table does
+  not match the size of the depth image.
+*/
+vpMbtDepthPoints::vpMbtDepthPoints(const vpImage<uint16_t> &depth, const double depthScale,
+                                   const vpMbtDepthRayTable &rays)
+  : m_width(depth.getWidth()), m_height(depth.getHeight()), m_colVectors(NULL), m_data(NULL), m_stride(0),
+    m_depth(&depth), m_depthScale(depthScale), m_rays(&rays)
+{
+  if (m_width > 0 && m_height > 0 && (rays.getWidth() != m_width || rays.getHeight() != m_height)) {
+    throw vpException(vpException::dimensionError, "Ray table size (%dx%d) does not match the depth image (%dx%d)!",
+                      rays.getWidth(), rays.getHeight(), m_width, m_height);
+  }
+}
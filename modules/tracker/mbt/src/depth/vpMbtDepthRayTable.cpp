@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Back-projection rays of the pixels of a depth image.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbtDepthRayTable.h>
+
+/*!
+  Default constructor, with an empty table.
+*/
+vpMbtDepthRayTable::vpMbtDepthRayTable() : m_cam(), m_rays(), m_width(0), m_height(0) {}
+
+/*!
+  Compute the normalized coordinates of all the pixels of a depth image. Do
+  nothing if the table was already computed with the same parameters.
+
+  \param cam : Intrinsic parameters of the depth camera.
+  \param width : Width of the depth image.
+  \param height : Height of the depth image.
+*/
+void vpMbtDepthRayTable::build(const vpCameraParameters &cam, const unsigned int width, const unsigned int height)
+{
+  if (width == m_width && height == m_height && cam.get_projModel() == m_cam.get_projModel() &&
+      cam.get_px() == m_cam.get_px() && cam.get_py() == m_cam.get_py() && cam.get_u0() == m_cam.get_u0() &&
+      cam.get_v0() == m_cam.get_v0() && cam.get_kud() == m_cam.get_kud() && cam.get_kdu() == m_cam.get_kdu()) {
+    return;
+  }
+
+  m_cam = cam;
+  m_width = width;
+  m_height = height;
+  m_rays.resize(2 * (size_t)width * height);
+
+  double x = 0, y = 0;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+      m_rays[2 * ((size_t)i * width + j)] = x;
+      m_rays[2 * ((size_t)i * width + j) + 1] = y;
+    }
+  }
+}
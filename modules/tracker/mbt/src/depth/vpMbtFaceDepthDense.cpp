@@ -207,9 +207,9 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
   int totalTheoreticalPoints = 0, totalPoints = 0;
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
+      if ((m_useScanLine ? (i < m_hiddenFace->getPrimitiveIDs().getHeight() &&
+                            j < m_hiddenFace->getPrimitiveIDs().getWidth() &&
+                            m_hiddenFace->getPrimitiveIDs()[i][j] == m_polygon->getIndex())
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         totalTheoreticalPoints++;
 
@@ -266,6 +266,19 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
 }
 #endif
 
+/*!
+  Extract the depth points lying inside the projected face.
+
+  \param cMo : Current pose.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+  \param point_cloud : Organized point cloud of (width x height) points.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the face has enough depth points to be tracked.
+*/
 bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
                                                  const unsigned int height, const std::vector<vpColVector> &point_cloud,
                                                  const unsigned int stepX, const unsigned int stepY
@@ -276,11 +289,74 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
 #endif
                                                  , const vpImage<bool> *mask
 )
+{
+  return computeDesiredFeatures(cMo, vpMbtDepthPoints(point_cloud, width, height), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                ,
+                                debugImage, roiPts_vec
+#endif
+                                , mask);
+}
+
+/*!
+  Extract the depth points lying inside the projected face.
+
+  \param cMo : Current pose.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+  \param point_cloud : Organized point cloud stored as a contiguous (width x
+  height) x 3 matrix, each row containing the X, Y, Z coordinates of a point.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the face has enough depth points to be tracked.
+*/
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                 const unsigned int height, const vpMatrix &point_cloud,
+                                                 const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                 ,
+                                                 vpImage<unsigned char> &debugImage,
+                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                 , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeatures(cMo, vpMbtDepthPoints(point_cloud, width, height), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                ,
+                                debugImage, roiPts_vec
+#endif
+                                , mask);
+}
+
+/*!
+  Extract the depth points lying inside the projected face.
+
+  \param cMo : Current pose.
+  \param points : Organized point cloud.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the face has enough depth points to be tracked.
+*/
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtDepthPoints &points,
+                                                 const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                 ,
+                                                 vpImage<unsigned char> &debugImage,
+                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                 , const vpImage<bool> *mask
+)
 {
   m_pointCloudFace.clear();
 
+  const unsigned int width = points.getWidth(), height = points.getHeight();
   if (width == 0 || height == 0)
-    return 0;
+    return false;
 
   std::vector<vpImagePoint> roiPts;
   double distanceToFace;
@@ -328,40 +404,41 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
 #endif
 
   int totalTheoreticalPoints = 0, totalPoints = 0;
+  double X = 0.0, Y = 0.0, Z = 0.0;
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
+      if ((m_useScanLine ? (i < m_hiddenFace->getPrimitiveIDs().getHeight() &&
+                            j < m_hiddenFace->getPrimitiveIDs().getWidth() &&
+                            m_hiddenFace->getPrimitiveIDs()[i][j] == m_polygon->getIndex())
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         totalTheoreticalPoints++;
 
-        if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0) {
+        if (vpMeTracker::inMask(mask, i, j) && points.getPoint(i, j, X, Y, Z)) {
           totalPoints++;
 
           if (checkSSE2) {
 #if USE_SSE
             if (!push) {
               push = true;
-              prev_x = point_cloud[i * width + j][0];
-              prev_y = point_cloud[i * width + j][1];
-              prev_z = point_cloud[i * width + j][2];
+              prev_x = X;
+              prev_y = Y;
+              prev_z = Z;
             } else {
               push = false;
               m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
+              m_pointCloudFace.push_back(X);
 
               m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
+              m_pointCloudFace.push_back(Y);
 
               m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
+              m_pointCloudFace.push_back(Z);
             }
 #endif
           } else {
-            m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
+            m_pointCloudFace.push_back(X);
+            m_pointCloudFace.push_back(Y);
+            m_pointCloudFace.push_back(Z);
           }
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
@@ -575,6 +652,102 @@ void vpMbtFaceDepthDense::computeInteractionMatrixAndResidu(const vpHomogeneousM
   }
 }
 
+/*!
+  Compute the residual of each point, that is its distance to the plane of
+  the face at pose \e cMo. The interaction matrix is not formed, its rows
+  are accumulated later by addNormalEquations().
+
+  \param cMo : Current pose.
+  \param error : Pointer to getNbFeatures() residuals.
+*/
+void vpMbtFaceDepthDense::computeResidu(const vpHomogeneousMatrix &cMo, double *const error)
+{
+  // Transform the plane equation for the current pose
+  m_planeCamera = m_planeObject;
+  m_planeCamera.changeFrame(cMo);
+
+  const double nx = m_planeCamera.getA();
+  const double ny = m_planeCamera.getB();
+  const double nz = m_planeCamera.getC();
+  const double D = m_planeCamera.getD();
+
+  const bool pairs = usePointPairs();
+  const unsigned int nbFeatures = getNbFeatures();
+  double x, y, z;
+  for (unsigned int i = 0; i < nbFeatures; i++) {
+    getPoint(i, pairs, x, y, z);
+    error[i] = D + nx * x + ny * y + nz * z;
+  }
+}
+
+/*!
+  Add the weighted normal equations of the points [\e begin, \e end) of the
+  face to \e ne. The rows of the interaction matrix are computed on the fly
+  from the plane estimated by the last call to computeResidu().
+
+  \param begin : Index of the first point.
+  \param end : Index after the last point.
+  \param error : Residuals of the getNbFeatures() points of the face.
+  \param w : Weights of the points of the face, or NULL for unit weights.
+  \param ne : Accumulated normal equations.
+*/
+void vpMbtFaceDepthDense::addNormalEquations(const unsigned int begin, const unsigned int end,
+                                             const double *const error, const double *const w,
+                                             vpMbtNormalEquations &ne) const
+{
+  const double nx = m_planeCamera.getA();
+  const double ny = m_planeCamera.getB();
+  const double nz = m_planeCamera.getC();
+
+  const bool pairs = usePointPairs();
+  double L[6] = {nx, ny, nz, 0.0, 0.0, 0.0};
+  double x, y, z;
+  for (unsigned int i = begin; i < end; i++) {
+    getPoint(i, pairs, x, y, z);
+
+    L[3] = (nz * y) - (ny * z);
+    L[4] = (nx * z) - (nz * x);
+    L[5] = (ny * x) - (nx * y);
+    ne.addRow(L, w != NULL ? w[i] : 1.0, error[i]);
+  }
+}
+
+/*!
+  Return true when the points of the face are stored by pairs (x0 x1 y0 y1
+  z0 z1) for the SSE2 code, false when they are stored as x y z triplets.
+*/
+bool vpMbtFaceDepthDense::usePointPairs()
+{
+#if USE_SSE
+  return vpCPUFeatures::checkSSE2();
+#else
+  return false;
+#endif
+}
+
+/*!
+  Get the coordinates of the point \e i of the face. With \e pairs, the last
+  point is stored as a triplet when the number of points is odd.
+*/
+void vpMbtFaceDepthDense::getPoint(const unsigned int i, const bool pairs, double &x, double &y, double &z) const
+{
+  if (pairs) {
+    const size_t base = 6 * (size_t)(i / 2);
+    if (base + 6 <= m_pointCloudFace.size()) {
+      const size_t k = base + i % 2;
+      x = m_pointCloudFace[k];
+      y = m_pointCloudFace[k + 2];
+      z = m_pointCloudFace[k + 4];
+      return;
+    }
+  }
+
+  const size_t k = pairs ? 6 * (size_t)(i / 2) : 3 * (size_t)i;
+  x = m_pointCloudFace[k];
+  y = m_pointCloudFace[k + 1];
+  z = m_pointCloudFace[k + 2];
+}
+
 void vpMbtFaceDepthDense::computeROI(const vpHomogeneousMatrix &cMo, const unsigned int width,
                                      const unsigned int height, std::vector<vpImagePoint> &roiPts
 #if DEBUG_DISPLAY_DEPTH_DENSE
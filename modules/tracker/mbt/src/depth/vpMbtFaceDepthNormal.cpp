@@ -220,9 +220,9 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
       if (vpMeTracker::inMask(mask, i, j) && pcl::isFinite((*point_cloud)(j, i)) && (*point_cloud)(j, i).z > 0 &&
-          (m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
+          (m_useScanLine ? (i < m_hiddenFace->getPrimitiveIDs().getHeight() &&
+                            j < m_hiddenFace->getPrimitiveIDs().getWidth() &&
+                            m_hiddenFace->getPrimitiveIDs()[i][j] == m_polygon->getIndex())
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
 
         if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
@@ -307,6 +307,21 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 }
 #endif
 
+/*!
+  Estimate the desired plane features from the depth points lying inside the
+  projected face.
+
+  \param cMo : Current pose.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+  \param point_cloud : Organized point cloud of (width x height) points.
+  \param desired_features : Estimated desired features.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the desired features have been estimated.
+*/
 bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
                                                   const unsigned int height,
                                                   const std::vector<vpColVector> &point_cloud,
@@ -319,9 +334,79 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 #endif
                                                   , const vpImage<bool> *mask
 )
+{
+  return computeDesiredFeatures(cMo, vpMbtDepthPoints(point_cloud, width, height), desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                ,
+                                debugImage, roiPts_vec
+#endif
+                                , mask);
+}
+
+/*!
+  Estimate the desired plane features from the depth points lying inside the
+  projected face.
+
+  \param cMo : Current pose.
+  \param width : Point cloud width.
+  \param height : Point cloud height.
+  \param point_cloud : Organized point cloud stored as a contiguous (width x
+  height) x 3 matrix, each row containing the X, Y, Z coordinates of a point.
+  \param desired_features : Estimated desired features.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the desired features have been estimated.
+*/
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                  const unsigned int height,
+                                                  const vpMatrix &point_cloud,
+                                                  vpColVector &desired_features, const unsigned int stepX,
+                                                  const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                  ,
+                                                  vpImage<unsigned char> &debugImage,
+                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                  , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeatures(cMo, vpMbtDepthPoints(point_cloud, width, height), desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                ,
+                                debugImage, roiPts_vec
+#endif
+                                , mask);
+}
+
+/*!
+  Estimate the desired plane features from the depth points lying inside the
+  projected face.
+
+  \param cMo : Current pose.
+  \param points : Organized point cloud.
+  \param desired_features : Estimated desired features.
+  \param stepX : Sampling step along the x-direction.
+  \param stepY : Sampling step along the y-direction.
+  \param mask : Optional mask, only pixels where the mask is true are considered.
+
+  \return True if the desired features have been estimated.
+*/
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtDepthPoints &points,
+                                                  vpColVector &desired_features, const unsigned int stepX,
+                                                  const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                  ,
+                                                  vpImage<unsigned char> &debugImage,
+                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                  , const vpImage<bool> *mask
+)
 {
   m_faceActivated = false;
 
+  const unsigned int width = points.getWidth(), height = points.getHeight();
   if (width == 0 || height == 0)
     return false;
 
@@ -371,18 +456,18 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
   double prev_x, prev_y, prev_z;
 #endif
 
-  double x = 0.0, y = 0.0;
+  double x = 0.0, y = 0.0, X = 0.0, Y = 0.0, Z = 0.0;
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
-      if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0 &&
-          (m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
+      if (vpMeTracker::inMask(mask, i, j) && points.getPoint(i, j, X, Y, Z) &&
+          (m_useScanLine ? (i < m_hiddenFace->getPrimitiveIDs().getHeight() &&
+                            j < m_hiddenFace->getPrimitiveIDs().getWidth() &&
+                            m_hiddenFace->getPrimitiveIDs()[i][j] == m_polygon->getIndex())
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         // Add point
-        point_cloud_face.push_back(point_cloud[i * width + j][0]);
-        point_cloud_face.push_back(point_cloud[i * width + j][1]);
-        point_cloud_face.push_back(point_cloud[i * width + j][2]);
+        point_cloud_face.push_back(X);
+        point_cloud_face.push_back(Y);
+        point_cloud_face.push_back(Z);
 
         if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
           // Add point for custom method for plane equation estimation
@@ -394,7 +479,7 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
               push = true;
               prev_x = x;
               prev_y = y;
-              prev_z = point_cloud[i * width + j][2];
+              prev_z = Z;
             } else {
               push = false;
               point_cloud_face_custom.push_back(prev_x);
@@ -404,13 +489,13 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
               point_cloud_face_custom.push_back(y);
 
               point_cloud_face_custom.push_back(prev_z);
-              point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
+              point_cloud_face_custom.push_back(Z);
             }
 #endif
           } else {
             point_cloud_face_custom.push_back(x);
             point_cloud_face_custom.push_back(y);
-            point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
+            point_cloud_face_custom.push_back(Z);
           }
         }
 
@@ -54,14 +54,17 @@
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
+#include <visp3/mbt/vpMbtNormalEquations.h>
 #include <visp3/mbt/vpMbtXmlParser.h>
 #include <visp3/vision/vpPose.h>
 
+#include <algorithm>
 #include <float.h>
 #include <limits>
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 /*!
   Basic constructor
@@ -776,6 +779,20 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu()
 }
 
 void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> &_I)
+{
+  computeVVSEdgeResidu(_I);
+  stackVVSEdgeInteractionMatrix();
+}
+
+/*!
+  Compute the interaction matrix and the residual of each tracked feature
+  and stack the residuals in m_error_edge. The interaction matrices stay in
+  the features, see stackVVSEdgeInteractionMatrix() and
+  addVVSEdgeNormalEquations().
+
+  \param _I : Current image.
+*/
+void vpMbEdgeTracker::computeVVSEdgeResidu(const vpImage<unsigned char> &_I)
 {
   vpMbtDistanceLine *l;
   vpMbtDistanceCylinder *cy;
@@ -792,11 +809,8 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigne
       l = *it;
       l->computeInteractionMatrixError(cMo);
       for (unsigned int i = 0; i < l->nbFeatureTotal; i++) {
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_edge[n + i][j] = l->L[i][j];
-          m_error_edge[n + i] = l->error[i];
-          m_errorLines[nlines + i] = m_error_edge[n + i];
-        }
+        m_error_edge[n + i] = l->error[i];
+        m_errorLines[nlines + i] = m_error_edge[n + i];
       }
       n += l->nbFeatureTotal;
       nlines += l->nbFeatureTotal;
@@ -809,11 +823,8 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigne
       cy = *it;
       cy->computeInteractionMatrixError(cMo, _I);
       for (unsigned int i = 0; i < cy->nbFeature; i++) {
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_edge[n + i][j] = cy->L[i][j];
-          m_error_edge[n + i] = cy->error[i];
-          m_errorCylinders[ncylinders + i] = m_error_edge[n + i];
-        }
+        m_error_edge[n + i] = cy->error[i];
+        m_errorCylinders[ncylinders + i] = m_error_edge[n + i];
       }
 
       n += cy->nbFeature;
@@ -827,11 +838,8 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigne
       ci = *it;
       ci->computeInteractionMatrixError(cMo);
       for (unsigned int i = 0; i < ci->nbFeature; i++) {
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_edge[n + i][j] = ci->L[i][j];
-          m_error_edge[n + i] = ci->error[i];
-          m_errorCircles[ncircles + i] = m_error_edge[n + i];
-        }
+        m_error_edge[n + i] = ci->error[i];
+        m_errorCircles[ncircles + i] = m_error_edge[n + i];
       }
 
       n += ci->nbFeature;
@@ -840,6 +848,116 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigne
   }
 }
 
+/*!
+  Stack in m_L_edge the interaction matrices computed by the last call to
+  computeVVSEdgeResidu().
+*/
+void vpMbEdgeTracker::stackVVSEdgeInteractionMatrix()
+{
+  m_L_edge.resize(m_error_edge.getRows(), 6, false, false);
+
+  unsigned int n = 0;
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
+       ++it) {
+    if ((*it)->isTracked()) {
+      m_L_edge.insert((*it)->L, n, 0);
+      n += (*it)->nbFeatureTotal;
+    }
+  }
+
+  for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cylinders[scaleLevel].begin();
+       it != cylinders[scaleLevel].end(); ++it) {
+    if ((*it)->isTracked()) {
+      m_L_edge.insert((*it)->L, n, 0);
+      n += (*it)->nbFeature;
+    }
+  }
+
+  for (std::list<vpMbtDistanceCircle *>::const_iterator it = circles[scaleLevel].begin();
+       it != circles[scaleLevel].end(); ++it) {
+    if ((*it)->isTracked()) {
+      m_L_edge.insert((*it)->L, n, 0);
+      n += (*it)->nbFeature;
+    }
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Rows of the interaction matrices of the tracked features, in the order of
+// m_error_edge
+class EdgeRows : public vpMbtNormalEquations::vpRows
+{
+public:
+  EdgeRows(const double *const error, const double *const w) : m_L(), m_offsets(1, 0), m_error(error), m_w(w) {}
+
+  void addFeature(const vpMatrix &L, const unsigned int nbRows)
+  {
+    m_L.push_back(&L);
+    m_offsets.push_back(m_offsets.back() + nbRows);
+  }
+
+  unsigned int getNbRows() const { return m_offsets.back(); }
+
+  void addRows(unsigned int begin, unsigned int end, vpMbtNormalEquations &ne) const
+  {
+    size_t f = (size_t)(std::upper_bound(m_offsets.begin(), m_offsets.end(), begin) - m_offsets.begin()) - 1;
+    for (; begin < end; f++) {
+      const unsigned int offset = m_offsets[f];
+      const unsigned int last = std::min(end, m_offsets[f + 1]);
+      for (unsigned int i = begin; i < last; i++) {
+        ne.addRow((*m_L[f])[i - offset], m_w != NULL ? m_w[i] : 1.0, m_error[i]);
+      }
+      begin = last;
+    }
+  }
+
+private:
+  std::vector<const vpMatrix *> m_L;
+  std::vector<unsigned int> m_offsets;
+  const double *m_error;
+  const double *m_w;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Add the normal equations of the moving-edge features directly from the
+  interaction matrices of the features computed by the last call to
+  computeVVSEdgeResidu(), without stacking them.
+
+  \param w : Weights of the features, or NULL for unit weights.
+  \param LTL : Normal matrix (size 6x6), incremented.
+  \param LTR : Right-hand side (size 6), incremented.
+*/
+void vpMbEdgeTracker::addVVSEdgeNormalEquations(const double *const w, vpMatrix &LTL, vpColVector &LTR) const
+{
+  EdgeRows rows(m_error_edge.data, w);
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
+       ++it) {
+    if ((*it)->isTracked()) {
+      rows.addFeature((*it)->L, (*it)->nbFeatureTotal);
+    }
+  }
+
+  for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cylinders[scaleLevel].begin();
+       it != cylinders[scaleLevel].end(); ++it) {
+    if ((*it)->isTracked()) {
+      rows.addFeature((*it)->L, (*it)->nbFeature);
+    }
+  }
+
+  for (std::list<vpMbtDistanceCircle *>::const_iterator it = circles[scaleLevel].begin();
+       it != circles[scaleLevel].end(); ++it) {
+    if ((*it)->isTracked()) {
+      rows.addFeature((*it)->L, (*it)->nbFeature);
+    }
+  }
+
+  vpMbtNormalEquations::accumulate(rows, LTL, LTR);
+}
+
 void vpMbEdgeTracker::computeVVSWeights()
 {
   unsigned int nberrors_lines = m_errorLines.getRows(), nberrors_cylinders = m_errorCylinders.getRows(),
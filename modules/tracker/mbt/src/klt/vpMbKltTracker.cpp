@@ -180,7 +180,7 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   vpMbtDistanceKltPoints *kltpoly;
   vpMbtDistanceKltCylinder *kltPolyCylinder;
   if (useScanLine) {
-    vpImageConvert::convert(faces.getMbScanLineRenderer().getMask(), mask);
+    vpImageConvert::convert(faces.getMask(), mask);
   } else {
     unsigned char val = 255 /* - i*15*/;
     for (std::list<vpMbtDistanceKltPoints *>::const_iterator it = kltPolygons.begin(); it != kltPolygons.end(); ++it) {
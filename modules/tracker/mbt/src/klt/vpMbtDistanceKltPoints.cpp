@@ -41,7 +41,7 @@
 #include <visp3/mbt/vpMbtDistanceKltPoints.h>
 #include <visp3/me/vpMeTracker.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT)
 
 #if defined(VISP_HAVE_CLIPPER)
 #include <clipper.hpp> // clipper private library
@@ -69,6 +69,7 @@ vpMbtDistanceKltPoints::vpMbtDistanceKltPoints()
 */
 vpMbtDistanceKltPoints::~vpMbtDistanceKltPoints() {}
 
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
 /*!
   Initialise the face to track. All the points in the map, representing all
   the map detected in the image, are parsed in order to extract the id of the
@@ -78,6 +79,27 @@ vpMbtDistanceKltPoints::~vpMbtDistanceKltPoints() {}
   \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
 */
 void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<bool> *mask)
+{
+  initFromTracker(_tracker, mask);
+}
+#endif
+
+/*!
+  Initialise the face to track. All the points in the map, representing all
+  the map detected in the image, are parsed in order to extract the id of the
+  points that are indeed in the face.
+
+  \param _tracker : ViSP native KLT Tracker.
+  \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
+*/
+void vpMbtDistanceKltPoints::init(const vpKltTracker &_tracker, const vpImage<bool> *mask)
+{
+  initFromTracker(_tracker, mask);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <class KltTracker>
+void vpMbtDistanceKltPoints::initFromTracker(const KltTracker &_tracker, const vpImage<bool> *mask)
 {
   // extract ids of the points in the face
   nbPointsInit = 0;
@@ -141,6 +163,9 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
   invd0 = 1.0 / d0;
 }
 
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
 /*!
   compute the number of point in this instanciation of the tracker that
   corresponds to the points of the face
@@ -151,6 +176,29 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
   \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
 */
 unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv &_tracker, const vpImage<bool> *mask)
+{
+  return computeNbDetectedCurrentFromTracker(_tracker, mask);
+}
+#endif
+
+/*!
+  compute the number of point in this instanciation of the tracker that
+  corresponds to the points of the face
+
+  \param _tracker : the native KLT tracker
+  \return the number of points that are tracked in this face and in this
+  instanciation of the tracker
+  \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
+*/
+unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltTracker &_tracker, const vpImage<bool> *mask)
+{
+  return computeNbDetectedCurrentFromTracker(_tracker, mask);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <class KltTracker>
+unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrentFromTracker(const KltTracker &_tracker,
+                                                                         const vpImage<bool> *mask)
 {
   long id;
   float x, y;
@@ -180,6 +228,7 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
 
   return nbPointsCur;
 }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   Compute the interaction matrix and the residu vector for the face.
@@ -342,6 +391,7 @@ bool vpMbtDistanceKltPoints::isTrackedFeature(const int _id)
   return false;
 }
 
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
 /*!
   Modification of all the pixels that are in the roi to the value of _nb (
   default is 255).
@@ -495,6 +545,57 @@ void vpMbtDistanceKltPoints::updateMask(
   }
 #endif
 }
+#endif
+
+/*!
+  Modification of all the pixels that are in the roi to the value of _nb (
+  default is 255), for the native KLT tracker.
+
+  \param mask : the mask to update (0, not in the object, _nb otherwise).
+  \param nb : Optionnal value to set to the pixels included in the face.
+  \param shiftBorder : Optionnal shift for the border in pixel (sort of
+  built-in erosion) to avoid to consider pixels near the limits of the face.
+*/
+void vpMbtDistanceKltPoints::updateMask(vpImage<unsigned char> &mask, unsigned char nb, unsigned int shiftBorder)
+{
+  int width = (int)mask.getWidth();
+  int height = (int)mask.getHeight();
+
+  int i_min, i_max, j_min, j_max;
+  std::vector<vpImagePoint> roi;
+  polygon->getRoiClipped(cam, roi);
+  vpPolygon3D::getMinMaxRoi(roi, i_min, i_max, j_min, j_max);
+
+  /* check image boundaries */
+  if (i_min < 0 || i_min > height) { // underflow
+    i_min = 0;
+  }
+  if (i_max > height) {
+    i_max = height;
+  }
+  if (j_min < 0 || j_min > width) { // underflow
+    j_min = 0;
+  }
+  if (j_max > width) {
+    j_max = width;
+  }
+
+  double shiftBorder_d = (double)shiftBorder;
+  for (int i = i_min; i < i_max; i++) {
+    double i_d = (double)i;
+    unsigned char *row = mask[i];
+    for (int j = j_min; j < j_max; j++) {
+      double j_d = (double)j;
+      if (vpPolygon::isInside(roi, i_d, j_d) &&
+          (shiftBorder == 0 || (vpPolygon::isInside(roi, i_d + shiftBorder_d, j_d + shiftBorder_d) &&
+                                vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d + shiftBorder_d) &&
+                                vpPolygon::isInside(roi, i_d + shiftBorder_d, j_d - shiftBorder_d) &&
+                                vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d - shiftBorder_d)))) {
+        row[j] = nb;
+      }
+    }
+  }
+}
 
 /*!
   This method removes the outliers. A point is considered as outlier when its
@@ -37,12 +37,160 @@
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+template <typename T> T findOrDefault(const std::map<std::string, T> *map, const std::string &key, const T &value)
+{
+  if (map != NULL) {
+    typename std::map<std::string, T>::const_iterator it = map->find(key);
+    if (it != map->end()) {
+      return it->second;
+    }
+  }
+  return value;
+}
+}
+
+/*
+  Run one stage of the tracking for a range of cameras. The per-camera
+  trackers are independent, the stages can thus be run concurrently by the
+  shared thread pool. The maps are only read with find() so that they are
+  not modified while the stage is running.
+*/
+class vpMbGenericTracker::TrackerStageBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  enum Stage { PRE_TRACKING, VVS_INIT, VVS_INTERACTION_MATRIX_AND_RESIDU, VVS_WEIGHTS, POST_TRACKING };
+
+  TrackerStageBody(vpMbGenericTracker &owner, const Stage stage,
+                   const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
+    : m_owner(owner), m_stage(stage), m_trackers(), m_startIndexes(), m_mapOfImages(&mapOfImages),
+      m_mapOfPointClouds(NULL), m_mapOfPointCloudMatrices(NULL), m_mapOfDepthImages(NULL), m_mapOfDepthScales(NULL),
+#ifdef VISP_HAVE_PCL
+      m_mapOfPclPointClouds(NULL),
+#endif
+      m_mapOfWidths(NULL), m_mapOfHeights(NULL), m_mapOfVelocityTwist(NULL)
+  {
+    unsigned int start_index = 0;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = owner.m_mapOfTrackers.begin();
+         it != owner.m_mapOfTrackers.end(); ++it) {
+      m_trackers.push_back(*it);
+      m_startIndexes.push_back(start_index);
+      // Feature rows of each camera, valid once computeVVSInit() was called
+      start_index += it->second->m_error.getRows();
+    }
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    for (unsigned int i = begin; i < end; i++) {
+      const std::string &name = m_trackers[i].first;
+      TrackerWrapper *tracker = m_trackers[i].second;
+      const vpImage<unsigned char> *ptr_I = findOrDefault(m_mapOfImages, name, (const vpImage<unsigned char> *)NULL);
+
+      switch (m_stage) {
+      case PRE_TRACKING:
+#ifdef VISP_HAVE_PCL
+        if (m_mapOfPclPointClouds != NULL) {
+          tracker->preTracking(ptr_I, findOrDefault(m_mapOfPclPointClouds, name,
+                                                    pcl::PointCloud<pcl::PointXYZ>::ConstPtr()));
+          break;
+        }
+#endif
+        if (m_mapOfDepthImages != NULL) {
+          tracker->preTracking(ptr_I, findOrDefault(m_mapOfDepthImages, name, (const vpImage<uint16_t> *)NULL),
+                               findOrDefault(m_mapOfDepthScales, name, 0.0));
+        } else if (m_mapOfPointCloudMatrices != NULL) {
+          tracker->preTracking(ptr_I, findOrDefault(m_mapOfPointCloudMatrices, name, (const vpMatrix *)NULL),
+                               findOrDefault(m_mapOfWidths, name, 0u), findOrDefault(m_mapOfHeights, name, 0u));
+        } else {
+          tracker->preTracking(ptr_I,
+                               findOrDefault(m_mapOfPointClouds, name, (const std::vector<vpColVector> *)NULL),
+                               findOrDefault(m_mapOfWidths, name, 0u), findOrDefault(m_mapOfHeights, name, 0u));
+        }
+        break;
+
+      case VVS_INIT:
+        tracker->computeVVSInit(ptr_I);
+        break;
+
+      case VVS_INTERACTION_MATRIX_AND_RESIDU: {
+        const vpHomogeneousMatrix cMref = findOrDefault(&m_owner.m_mapOfCameraTransformationMatrix, name,
+                                                        vpHomogeneousMatrix());
+        tracker->cMo = cMref * m_owner.cMo;
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+        tracker->ctTc0 = cMref * m_owner.cMo * tracker->c0Mo.inverse();
+#endif
+        tracker->computeVVSInteractionMatrixAndResidu(ptr_I);
+
+        // Each camera fills its own rows of the stacked residual, and of the
+        // stacked interaction matrix when it is needed for the covariance
+        if (m_owner.computeCovariance) {
+          tracker->computeVVSStackedInteractionMatrix();
+          m_owner.m_L.insert(tracker->m_L * findOrDefault(m_mapOfVelocityTwist, name, vpVelocityTwistMatrix()),
+                             m_startIndexes[i], 0);
+        }
+        m_owner.m_error.insert(m_startIndexes[i], tracker->m_error);
+        break;
+      }
+
+      case VVS_WEIGHTS:
+        tracker->computeVVSWeights();
+        m_owner.m_w.insert(m_startIndexes[i], tracker->m_w);
+        break;
+
+      case POST_TRACKING:
+#ifdef VISP_HAVE_PCL
+        if (m_mapOfPclPointClouds != NULL) {
+          tracker->postTracking(ptr_I, findOrDefault(m_mapOfPclPointClouds, name,
+                                                     pcl::PointCloud<pcl::PointXYZ>::ConstPtr()));
+          break;
+        }
+#endif
+        tracker->postTracking(ptr_I, findOrDefault(m_mapOfWidths, name, 0u), findOrDefault(m_mapOfHeights, name, 0u));
+        break;
+      }
+    }
+  }
+
+  // Run the stage for all the cameras, concurrently if requested
+  void run()
+  {
+    const unsigned int nbCameras = (unsigned int)m_trackers.size();
+    if (m_owner.m_useParallelTracking && nbCameras > 1) {
+      vpThreadPool::getInstance().parallelFor(0, nbCameras, *this, nbCameras);
+    } else {
+      (*this)(0, nbCameras);
+    }
+  }
+
+  vpMbGenericTracker &m_owner;
+  Stage m_stage;
+  std::vector<std::pair<std::string, TrackerWrapper *> > m_trackers;
+  std::vector<unsigned int> m_startIndexes;
+  const std::map<std::string, const vpImage<unsigned char> *> *m_mapOfImages;
+  const std::map<std::string, const std::vector<vpColVector> *> *m_mapOfPointClouds;
+  const std::map<std::string, const vpMatrix *> *m_mapOfPointCloudMatrices;
+  const std::map<std::string, const vpImage<uint16_t> *> *m_mapOfDepthImages;
+  const std::map<std::string, double> *m_mapOfDepthScales;
+#ifdef VISP_HAVE_PCL
+  const std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> *m_mapOfPclPointClouds;
+#endif
+  const std::map<std::string, unsigned int> *m_mapOfWidths;
+  const std::map<std::string, unsigned int> *m_mapOfHeights;
+  const std::map<std::string, vpVelocityTwistMatrix> *m_mapOfVelocityTwist;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpMbGenericTracker::vpMbGenericTracker()
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(),
+    m_useParallelTracking(false)
 {
   m_mapOfTrackers["Camera"] = new TrackerWrapper(EDGE_TRACKER);
 
@@ -62,7 +210,8 @@ vpMbGenericTracker::vpMbGenericTracker()
 
 vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int trackerType)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(),
+    m_useParallelTracking(false)
 {
   if (nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot use no camera!");
@@ -98,7 +247,8 @@ vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int t
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(),
+    m_useParallelTracking(false)
 {
   if (trackerTypes.empty()) {
     throw vpException(vpException::badValue, "There is no camera!");
@@ -137,7 +287,8 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNames,
                                        const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(),
+    m_useParallelTracking(false)
 {
   if (cameraNames.size() != trackerTypes.size() || cameraNames.empty()) {
     throw vpException(vpTrackingException::badValue,
@@ -283,6 +434,8 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
   double factorEdge = m_mapOfFeatureFactors[EDGE_TRACKER];
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   double factorKlt = m_mapOfFeatureFactors[KLT_TRACKER];
+#else
+  double factorKlt = 1.0;
 #endif
   double factorDepth = m_mapOfFeatureFactors[DEPTH_NORMAL_TRACKER];
   double factorDepthDense = m_mapOfFeatureFactors[DEPTH_DENSE_TRACKER];
@@ -319,32 +472,13 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
         }
       }
 
-      vpVelocityTwistMatrix cVo;
       if (iter == 0) {
-        isoJoIdentity_ = true;
-        oJo.eye();
-
         // If all the 6 dof should be estimated, we check if the interaction
         // matrix is full rank. If not we remove automatically the dof that
         // cannot be estimated This is particularly useful when consering
         // circles (rank 5) and cylinders (rank 4)
-        if (isoJoIdentity_) {
-          cVo.buildFrom(cMo);
-
-          vpMatrix K; // kernel
-          unsigned int rank = (m_L * cVo).kernel(K);
-          if (rank == 0) {
-            throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
-          }
-
-          if (rank != 6) {
-            vpMatrix I; // Identity
-            I.eye(6);
-            oJo = I - K.AtA();
-
-            isoJoIdentity_ = false;
-          }
-        }
+        computeVVSNormalEquations(mapOfVelocityTwist, NULL, LTL, LTR);
+        computeVVSCheckRank(LTL, isoJoIdentity_);
       }
 
       // Weighting
@@ -356,81 +490,18 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
            it != m_mapOfTrackers.end(); ++it) {
         TrackerWrapper *tracker = it->second;
 
-        if (tracker->m_trackerType & EDGE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
-            double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_edge.getRows();
-        }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-        if (tracker->m_trackerType & KLT_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
-            double wi = tracker->m_w_klt[i] * factorKlt;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_klt.getRows();
-        }
-#endif
-
-        if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
-            double wi = tracker->m_w_depthNormal[i] * factorDepth;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthNormal.getRows();
-        }
-
-        if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
-            double wi = tracker->m_w_depthDense[i] * factorDepthDense;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
+        vpColVector W;
+        tracker->computeVVSResidualWeights(factorEdge, factorKlt, factorDepth, factorDepthDense, W, num, den);
+        W_true.insert(start_index, W);
 
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthDense.getRows();
-        }
+        start_index += tracker->m_error.getRows();
       }
 
       normRes_1 = normRes;
       normRes = sqrt(num / den);
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+      computeVVSNormalEquations(mapOfVelocityTwist, &W_true, LTL, LTR);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error, error_prev, mu, v);
 
       cMo_prev = cMo;
 
@@ -477,20 +548,19 @@ void vpMbGenericTracker::computeVVSInit()
 
 void vpMbGenericTracker::computeVVSInit(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
 {
-  unsigned int nbFeatures = 0;
+  TrackerStageBody stage(*this, TrackerStageBody::VVS_INIT, mapOfImages);
+  stage.run();
 
+  unsigned int nbFeatures = 0;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->computeVVSInit(mapOfImages[it->first]);
-
-    nbFeatures += tracker->m_error.getRows();
+    nbFeatures += it->second->m_error.getRows();
   }
 
-  m_L.resize(nbFeatures, 6, false, false);
+  // The stacked interaction matrix is only built to compute the covariance
+  m_L.resize(computeCovariance ? nbFeatures : 0, 6, false, false);
   m_error.resize(nbFeatures, false);
 
-  m_weightedError.resize(nbFeatures, false);
   m_w.resize(nbFeatures, false);
   m_w = 1;
 }
@@ -506,22 +576,45 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
     std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist)
 {
-  unsigned int start_index = 0;
+  TrackerStageBody stage(*this, TrackerStageBody::VVS_INTERACTION_MATRIX_AND_RESIDU, mapOfImages);
+  stage.m_mapOfVelocityTwist = &mapOfVelocityTwist;
+  stage.run();
+}
+
+/*!
+  Accumulate the normal equations of all the cameras expressed in the
+  reference camera frame. With \f$ L_c \f$ the interaction matrix of camera
+  c and \f$ V_c \f$ its velocity twist matrix, the rows of the stacked
+  system are \f$ L_c V_c \f$ so that the 6x6 normal matrix of each camera
+  is simply transformed as \f$ V_c^T L_c^T W_c^2 L_c V_c \f$.
+
+  \param mapOfVelocityTwist : Velocity twist matrices of the cameras.
+  \param W : Weights of the stacked features, or NULL for unit weights.
+  \param LTL : Normal matrix (size 6x6).
+  \param LTR : Right-hand side (size 6).
+*/
+void vpMbGenericTracker::computeVVSNormalEquations(
+    const std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist, const vpColVector *const W,
+    vpMatrix &LTL, vpColVector &LTR) const
+{
+  LTL.resize(6, 6, false, false);
+  LTL = 0.0;
+  LTR.resize(6, false);
+  LTR = 0.0;
 
+  vpMatrix LTL_c;
+  vpColVector LTR_c;
+  unsigned int start_index = 0;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
 
-    tracker->cMo = m_mapOfCameraTransformationMatrix[it->first] * cMo;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-    vpHomogeneousMatrix c_curr_tTc_curr0 = m_mapOfCameraTransformationMatrix[it->first] * cMo * tracker->c0Mo.inverse();
-    tracker->ctTc0 = c_curr_tTc_curr0;
-#endif
-
-    tracker->computeVVSInteractionMatrixAndResidu(mapOfImages[it->first]);
+    tracker->computeVVSNormalEquations(W != NULL ? W->data + start_index : NULL, LTL_c, LTR_c);
 
-    m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
-    m_error.insert(start_index, tracker->m_error);
+    const vpVelocityTwistMatrix V = findOrDefault(&mapOfVelocityTwist, it->first, vpVelocityTwistMatrix());
+    const vpMatrix Vt(V.t());
+    LTL += Vt * LTL_c * V;
+    LTR += Vt * LTR_c;
 
     start_index += tracker->m_error.getRows();
   }
@@ -529,16 +622,9 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
 
 void vpMbGenericTracker::computeVVSWeights()
 {
-  unsigned int start_index = 0;
-
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->computeVVSWeights();
-
-    m_w.insert(start_index, tracker->m_w);
-    start_index += tracker->m_w.getRows();
-  }
+  std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+  TrackerStageBody stage(*this, TrackerStageBody::VVS_WEIGHTS, mapOfImages);
+  stage.run();
 }
 
 /*!
@@ -2244,11 +2330,9 @@ void vpMbGenericTracker::loadModel(const std::map<std::string, std::string> &map
 void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
 {
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
-  }
+  TrackerStageBody stage(*this, TrackerStageBody::PRE_TRACKING, mapOfImages);
+  stage.m_mapOfPclPointClouds = &mapOfPointClouds;
+  stage.run();
 }
 #endif
 
@@ -2257,12 +2341,33 @@ void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigne
                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
 {
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first], mapOfPointCloudWidths[it->first],
-                         mapOfPointCloudHeights[it->first]);
-  }
+  TrackerStageBody stage(*this, TrackerStageBody::PRE_TRACKING, mapOfImages);
+  stage.m_mapOfPointClouds = &mapOfPointClouds;
+  stage.m_mapOfWidths = &mapOfPointCloudWidths;
+  stage.m_mapOfHeights = &mapOfPointCloudHeights;
+  stage.run();
+}
+
+void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                     std::map<std::string, const vpMatrix *> &mapOfPointClouds,
+                                     std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                                     std::map<std::string, unsigned int> &mapOfPointCloudHeights)
+{
+  TrackerStageBody stage(*this, TrackerStageBody::PRE_TRACKING, mapOfImages);
+  stage.m_mapOfPointCloudMatrices = &mapOfPointClouds;
+  stage.m_mapOfWidths = &mapOfPointCloudWidths;
+  stage.m_mapOfHeights = &mapOfPointCloudHeights;
+  stage.run();
+}
+
+void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                     std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                                     std::map<std::string, double> &mapOfDepthScales)
+{
+  TrackerStageBody stage(*this, TrackerStageBody::PRE_TRACKING, mapOfImages);
+  stage.m_mapOfDepthImages = &mapOfDepthImages;
+  stage.m_mapOfDepthScales = &mapOfDepthScales;
+  stage.run();
 }
 
 /*!
@@ -2814,6 +2919,23 @@ void vpMbGenericTracker::setClipping(const std::map<std::string, unsigned int> &
   }
 }
 
+/*!
+  Set if the covariance matrix has to be computed.
+
+  \param flag : True if the covariance has to be computed, false otherwise.
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setCovarianceComputation(const bool &flag)
+{
+  vpMbTracker::setCovarianceComputation(flag);
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setCovarianceComputation(flag);
+  }
+}
+
 /*!
   Set maximum distance to consider a face.
   You should use the maximum depth range of the sensor used.
@@ -3816,6 +3938,24 @@ void vpMbGenericTracker::setScanLineVisibilityTest(const bool &v)
   }
 }
 
+/*!
+  Use a software z-buffer instead of the scanline renderer for the scanline
+  visibility test of all the cameras.
+
+  \param v : true to use the z-buffer renderer.
+
+  \sa setScanLineVisibilityTest()
+*/
+void vpMbGenericTracker::setZBufferVisibilityTest(const bool &v)
+{
+  vpMbTracker::setZBufferVisibilityTest(v);
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->setZBufferVisibilityTest(v);
+  }
+}
+
 /*!
   Set the tracker type.
 
@@ -3930,6 +4070,38 @@ void vpMbGenericTracker::setUseKltTracking(const std::string &name, const bool &
 }
 #endif
 
+/*!
+  Enable or disable the binary cache of the CAO models loaded by the trackers
+  of all the cameras, see vpMbTracker::setUseModelCache().
+
+  \param use : true to use the model cache.
+*/
+void vpMbGenericTracker::setUseModelCache(const bool use)
+{
+  vpMbTracker::setUseModelCache(use);
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseModelCache(use);
+  }
+}
+
+/*!
+  Enable or disable the concurrent execution of the per-camera tracking
+  stages. When enabled, the feature extraction (pre-tracking), the
+  computation of the interaction matrices, residuals and robust weights, and
+  the post-tracking of the different cameras are run by the threads of
+  vpThreadPool::getInstance(). The cameras are only synchronized for the
+  pose update that uses the stacked system of all the cameras.
+
+  \param parallel : True to run the stages of the cameras concurrently.
+
+  \note This is only useful when at least two cameras are used. If a
+  per-camera stage throws, the exception is rethrown as a vpException.
+*/
+void vpMbGenericTracker::setUseParallelTracking(const bool parallel) { m_useParallelTracking = parallel; }
+
 void vpMbGenericTracker::testTracking()
 {
   // Test tracking fails only if all testTracking have failed
@@ -4019,17 +4191,15 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
   track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
 }
 
-#ifdef VISP_HAVE_PCL
-/*!
-  Realize the tracking of the object in the image.
-
-  \throw vpException : if the tracking is supposed to have failed
-
-  \param mapOfImages : Map of images.
-  \param mapOfPointClouds : Map of PCL pointclouds.
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Check the type of each tracker, and that each tracker has the image and the
+  depth input it needs.
 */
-void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
-                               std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
+template <class DepthInput>
+void vpMbGenericTracker::checkTrackingInputs(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                             std::map<std::string, DepthInput> &mapOfDepthInputs,
+                                             const char *missingDepthMessage)
 {
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
@@ -4053,13 +4223,19 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     }
 
     if (tracker->m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER) &&
-        mapOfPointClouds[it->first] == nullptr) {
-      throw vpException(vpException::fatalError, "Pointcloud smart pointer is NULL!");
+        mapOfDepthInputs[it->first] == DepthInput()) {
+      throw vpException(vpException::fatalError, "%s", missingDepthMessage);
     }
   }
+}
 
-  preTracking(mapOfImages, mapOfPointClouds);
-
+/*
+  Estimate the pose once the features of all the trackers are extracted, then
+  run the post-tracking stage.
+*/
+void vpMbGenericTracker::computeVVSAndPostTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                                   TrackerStageBody &postTracking)
+{
   try {
     computeVVS(mapOfImages);
   } catch (...) {
@@ -4069,15 +4245,32 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   testTracking();
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
-  }
+  postTracking.run();
 
   computeProjectionError();
 }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#ifdef VISP_HAVE_PCL
+/*!
+  Realize the tracking of the object in the image.
+
+  \throw vpException : if the tracking is supposed to have failed
+
+  \param mapOfImages : Map of images.
+  \param mapOfPointClouds : Map of PCL pointclouds.
+*/
+void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                               std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
+{
+  checkTrackingInputs(mapOfImages, mapOfPointClouds, "Pointcloud smart pointer is NULL!");
+
+  preTracking(mapOfImages, mapOfPointClouds);
+
+  TrackerStageBody postTracking(*this, TrackerStageBody::POST_TRACKING, mapOfImages);
+  postTracking.m_mapOfPclPointClouds = &mapOfPointClouds;
+  computeVVSAndPostTracking(mapOfImages, postTracking);
+}
 #endif
 
 /*!
@@ -4095,57 +4288,84 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
                                std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                                std::map<std::string, unsigned int> &mapOfPointCloudHeights)
 {
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
+  checkTrackingInputs(mapOfImages, mapOfPointClouds, "Pointcloud is NULL!");
 
-    if ((tracker->m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-                                   KLT_TRACKER |
-#endif
-                                   DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
-      throw vpException(vpException::fatalError, "Bad tracker type: %d", tracker->m_trackerType);
-    }
+  preTracking(mapOfImages, mapOfPointClouds, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
-    if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-                                  | KLT_TRACKER
-#endif
-                                  ) &&
-        mapOfImages[it->first] == NULL) {
-      throw vpException(vpException::fatalError, "Image pointer is NULL!");
-    }
+  TrackerStageBody postTracking(*this, TrackerStageBody::POST_TRACKING, mapOfImages);
+  postTracking.m_mapOfWidths = &mapOfPointCloudWidths;
+  postTracking.m_mapOfHeights = &mapOfPointCloudHeights;
+  computeVVSAndPostTracking(mapOfImages, postTracking);
+}
 
-    if (tracker->m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER) &&
-        (mapOfPointClouds[it->first] == NULL)) {
-      throw vpException(vpException::fatalError, "Pointcloud is NULL!");
-    }
-  }
+/*!
+  Realize the tracking of the object in the image.
+
+  \throw vpException : if the tracking is supposed to have failed
+
+  \param mapOfImages : Map of images.
+  \param mapOfPointClouds : Map of pointclouds, each one stored as a contiguous
+  (width x height) x 3 matrix of X, Y, Z coordinates.
+  \param mapOfPointCloudWidths : Map of pointcloud widths.
+  \param mapOfPointCloudHeights : Map of pointcloud heights.
+*/
+void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                               std::map<std::string, const vpMatrix *> &mapOfPointClouds,
+                               std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                               std::map<std::string, unsigned int> &mapOfPointCloudHeights)
+{
+  checkTrackingInputs(mapOfImages, mapOfPointClouds, "Pointcloud is NULL!");
 
   preTracking(mapOfImages, mapOfPointClouds, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
-  try {
-    computeVVS(mapOfImages);
-  } catch (...) {
-    covarianceMatrix = -1;
-    throw; // throw the original exception
-  }
+  TrackerStageBody postTracking(*this, TrackerStageBody::POST_TRACKING, mapOfImages);
+  postTracking.m_mapOfWidths = &mapOfPointCloudWidths;
+  postTracking.m_mapOfHeights = &mapOfPointCloudHeights;
+  computeVVSAndPostTracking(mapOfImages, postTracking);
+}
 
-  testTracking();
+/*!
+  Realize the tracking of the object in the image, with the depth features
+  computed from raw depth images. Only the pixels sampled inside the visible
+  faces are back-projected, with the camera parameters of the depth cameras.
+
+  \throw vpException : if the tracking is supposed to have failed
 
+  \param mapOfImages : Map of images.
+  \param mapOfDepthImages : Map of raw depth images.
+  \param mapOfDepthScales : Map of scale factors converting the raw depth
+  values into meters.
+*/
+void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                               std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                               std::map<std::string, double> &mapOfDepthScales)
+{
+  checkTrackingInputs(mapOfImages, mapOfDepthImages, "Depth image is NULL!");
+
+  std::map<std::string, unsigned int> mapOfDepthWidths, mapOfDepthHeights;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
+    if (it->second->m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) {
+      if (mapOfDepthScales.find(it->first) == mapOfDepthScales.end()) {
+        throw vpException(vpException::fatalError, "No depth scale for camera: %s", it->first.c_str());
+      }
 
-    tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first], mapOfPointCloudHeights[it->first]);
+      mapOfDepthWidths[it->first] = mapOfDepthImages[it->first]->getWidth();
+      mapOfDepthHeights[it->first] = mapOfDepthImages[it->first]->getHeight();
+    }
   }
 
-  computeProjectionError();
+  preTracking(mapOfImages, mapOfDepthImages, mapOfDepthScales);
+
+  TrackerStageBody postTracking(*this, TrackerStageBody::POST_TRACKING, mapOfImages);
+  postTracking.m_mapOfWidths = &mapOfDepthWidths;
+  postTracking.m_mapOfHeights = &mapOfDepthHeights;
+  computeVVSAndPostTracking(mapOfImages, postTracking);
 }
 
 /** TrackerWrapper **/
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
-  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w()
 {
   m_lambda = 1.0;
   m_maxIter = 30;
@@ -4158,7 +4378,7 @@ vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
 }
 
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper(const int trackerType)
-  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(trackerType), m_w()
 {
   if ((m_trackerType & (EDGE_TRACKER |
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4219,9 +4439,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   unsigned int iter = 0;
 
   double factorEdge = 1.0;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   double factorKlt = 1.0;
-#endif
   double factorDepth = 1.0;
   double factorDepthDense = 1.0;
 
@@ -4240,13 +4458,6 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   vpColVector W_true(m_error.getRows());
   vpMatrix L_true, LVJ_true;
 
-  unsigned int nb_edge_features = m_error_edge.getRows();
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  unsigned int nb_klt_features = m_error_klt.getRows();
-#endif
-  unsigned int nb_depth_features = m_error_depthNormal.getRows();
-  unsigned int nb_depth_dense_features = m_error_depthDense.getRows();
-
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
     computeVVSInteractionMatrixAndResidu(ptr_I);
 
@@ -4265,6 +4476,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
       computeVVSWeights();
 
       if (computeCovariance) {
+        computeVVSStackedInteractionMatrix();
         L_true = m_L;
         if (!isoJoIdentity_) {
           vpVelocityTwistMatrix cVo;
@@ -4273,110 +4485,23 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
         }
       }
 
-      vpVelocityTwistMatrix cVo;
       if (iter == 0) {
-        isoJoIdentity_ = true;
-        oJo.eye();
-
         // If all the 6 dof should be estimated, we check if the interaction
         // matrix is full rank. If not we remove automatically the dof that
         // cannot be estimated This is particularly useful when consering
         // circles (rank 5) and cylinders (rank 4)
-        if (isoJoIdentity_) {
-          cVo.buildFrom(cMo);
-
-          vpMatrix K; // kernel
-          unsigned int rank = (m_L * cVo).kernel(K);
-          if (rank == 0) {
-            throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
-          }
-
-          if (rank != 6) {
-            vpMatrix I; // Identity
-            I.eye(6);
-            oJo = I - K.AtA();
-
-            isoJoIdentity_ = false;
-          }
-        }
+        computeVVSNormalEquations(NULL, LTL, LTR);
+        computeVVSCheckRank(LTL, isoJoIdentity_);
       }
 
       // Weighting
       double num = 0;
       double den = 0;
 
-      unsigned int start_index = 0;
-      if (m_trackerType & EDGE_TRACKER) {
-        for (unsigned int i = 0; i < nb_edge_features; i++) {
-          double wi = m_w_edge[i] * m_factor[i] * factorEdge;
-          W_true[i] = wi;
-          m_weightedError[i] = wi * m_error[i];
-
-          num += wi * vpMath::sqr(m_error[i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[i][j] *= wi;
-          }
-        }
-
-        start_index += nb_edge_features;
-      }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (m_trackerType & KLT_TRACKER) {
-        for (unsigned int i = 0; i < nb_klt_features; i++) {
-          double wi = m_w_klt[i] * factorKlt;
-          W_true[start_index + i] = wi;
-          m_weightedError[start_index + i] = wi * m_error_klt[i];
-
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        start_index += nb_klt_features;
-      }
-#endif
-
-      if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-        for (unsigned int i = 0; i < nb_depth_features; i++) {
-          double wi = m_w_depthNormal[i] * factorDepth;
-          m_w[start_index + i] = m_w_depthNormal[i];
-          m_weightedError[start_index + i] = wi * m_error[start_index + i];
+      computeVVSResidualWeights(factorEdge, factorKlt, factorDepth, factorDepthDense, W_true, num, den);
+      computeVVSNormalEquations(W_true.data, LTL, LTR);
 
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        start_index += nb_depth_features;
-      }
-
-      if (m_trackerType & DEPTH_DENSE_TRACKER) {
-        for (unsigned int i = 0; i < nb_depth_dense_features; i++) {
-          double wi = m_w_depthDense[i] * factorDepthDense;
-          m_w[start_index + i] = m_w_depthDense[i];
-          m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        //        start_index += nb_depth_dense_features;
-      }
-
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error, error_prev, mu, v);
 
       cMo_prev = cMo;
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4422,6 +4547,10 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInit(const vpImage<unsigned c
 
   if (m_trackerType & EDGE_TRACKER) {
     nbFeatures += m_error_edge.getRows();
+    // The rows are read from the features, see computeVVSNormalEquations()
+    if (!computeCovariance) {
+      m_L_edge.resize(0, 6, false, false);
+    }
   } else {
     m_error_edge.clear();
     m_weightedError_edge.clear();
@@ -4461,10 +4590,8 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInit(const vpImage<unsigned c
     m_w_depthDense.clear();
   }
 
-  m_L.resize(nbFeatures, 6, false, false);
   m_error.resize(nbFeatures, false);
 
-  m_weightedError.resize(nbFeatures, false);
   m_w.resize(nbFeatures, false);
   m_w = 1;
 }
@@ -4480,7 +4607,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu()
 void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> *const ptr_I)
 {
   if (m_trackerType & EDGE_TRACKER) {
-    vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(*ptr_I);
+    vpMbEdgeTracker::computeVVSEdgeResidu(*ptr_I);
   }
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4499,7 +4626,6 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 
   unsigned int start_index = 0;
   if (m_trackerType & EDGE_TRACKER) {
-    m_L.insert(m_L_edge, start_index, 0);
     m_error.insert(start_index, m_error_edge);
 
     start_index += m_error_edge.getRows();
@@ -4507,7 +4633,6 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
-    m_L.insert(m_L_klt, start_index, 0);
     m_error.insert(start_index, m_error_klt);
 
     start_index += m_error_klt.getRows();
@@ -4515,20 +4640,164 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    m_L.insert(m_L_depthNormal, start_index, 0);
     m_error.insert(start_index, m_error_depthNormal);
 
     start_index += m_error_depthNormal.getRows();
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    m_L.insert(m_L_depthDense, start_index, 0);
     m_error.insert(start_index, m_error_depthDense);
 
     //    start_index += m_error_depthDense.getRows();
   }
 }
 
+/*!
+  Accumulate the normal equations of each feature type without stacking
+  the interaction matrices. The moving-edge and dense depth rows are added
+  straight from the features, the KLT and depth normal ones from their
+  per-type interaction matrix.
+
+  \param W : Weights of the stacked features, or NULL for unit weights.
+  \param LTL : Normal matrix (size 6x6).
+  \param LTR : Right-hand side (size 6).
+*/
+void vpMbGenericTracker::TrackerWrapper::computeVVSNormalEquations(const double *const W, vpMatrix &LTL,
+                                                                   vpColVector &LTR) const
+{
+  LTL.resize(6, 6, false, false);
+  LTL = 0.0;
+  LTR.resize(6, false);
+  LTR = 0.0;
+
+  unsigned int start_index = 0;
+  if (m_trackerType & EDGE_TRACKER) {
+    addVVSEdgeNormalEquations(W != NULL ? W + start_index : NULL, LTL, LTR);
+    start_index += m_error_edge.getRows();
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (m_trackerType & KLT_TRACKER) {
+    addVVSNormalEquations(m_L_klt, m_error_klt, W != NULL ? W + start_index : NULL, LTL, LTR);
+    start_index += m_error_klt.getRows();
+  }
+#endif
+
+  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    addVVSNormalEquations(m_L_depthNormal, m_error_depthNormal, W != NULL ? W + start_index : NULL, LTL, LTR);
+    start_index += m_error_depthNormal.getRows();
+  }
+
+  if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    addVVSDepthDenseNormalEquations(W != NULL ? W + start_index : NULL, LTL, LTR);
+  }
+}
+
+/*!
+  Compute the weight of each feature from its robust weight and the factor
+  of its feature type, the weighted residual and the terms of the
+  stopping criterion.
+
+  \param factorEdge : Factor of the moving-edge features.
+  \param factorKlt : Factor of the KLT features.
+  \param factorDepth : Factor of the depth normal features.
+  \param factorDepthDense : Factor of the dense depth features.
+  \param W : Weights of the stacked features.
+  \param num : Sum of the weighted squared residuals, incremented.
+  \param den : Sum of the weights, incremented.
+*/
+void vpMbGenericTracker::TrackerWrapper::computeVVSResidualWeights(const double factorEdge, const double factorKlt,
+                                                                   const double factorDepth,
+                                                                   const double factorDepthDense, vpColVector &W,
+                                                                   double &num, double &den)
+{
+  W.resize(m_error.getRows(), false);
+
+  unsigned int start_index = 0;
+  if (m_trackerType & EDGE_TRACKER) {
+    for (unsigned int i = 0; i < m_error_edge.getRows(); i++) {
+      double wi = m_w_edge[i] * m_factor[i] * factorEdge;
+      W[i] = wi;
+
+      num += wi * vpMath::sqr(m_error[i]);
+      den += wi;
+    }
+
+    start_index += m_error_edge.getRows();
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (m_trackerType & KLT_TRACKER) {
+    for (unsigned int i = 0; i < m_error_klt.getRows(); i++) {
+      double wi = m_w_klt[i] * factorKlt;
+      W[start_index + i] = wi;
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
+
+    start_index += m_error_klt.getRows();
+  }
+#else
+  (void)factorKlt;
+#endif
+
+  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    for (unsigned int i = 0; i < m_error_depthNormal.getRows(); i++) {
+      double wi = m_w_depthNormal[i] * factorDepth;
+      W[start_index + i] = wi;
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
+
+    start_index += m_error_depthNormal.getRows();
+  }
+
+  if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    for (unsigned int i = 0; i < m_error_depthDense.getRows(); i++) {
+      double wi = m_w_depthDense[i] * factorDepthDense;
+      W[start_index + i] = wi;
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
+  }
+}
+
+/*!
+  Stack the interaction matrices of all the feature types in m_L. The pose
+  is estimated from the normal equations, the stacked matrix is only needed
+  to compute the covariance.
+*/
+void vpMbGenericTracker::TrackerWrapper::computeVVSStackedInteractionMatrix()
+{
+  m_L.resize(m_error.getRows(), 6, false, false);
+
+  unsigned int start_index = 0;
+  if (m_trackerType & EDGE_TRACKER) {
+    stackVVSEdgeInteractionMatrix();
+    m_L.insert(m_L_edge, start_index, 0);
+    start_index += m_L_edge.getRows();
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (m_trackerType & KLT_TRACKER) {
+    m_L.insert(m_L_klt, start_index, 0);
+    start_index += m_L_klt.getRows();
+  }
+#endif
+
+  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    m_L.insert(m_L_depthNormal, start_index, 0);
+    start_index += m_L_depthNormal.getRows();
+  }
+
+  if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    m_L.insert(m_L_depthDense, start_index, 0);
+  }
+}
+
 void vpMbGenericTracker::TrackerWrapper::computeVVSWeights()
 {
   unsigned int start_index = 0;
@@ -5019,25 +5288,7 @@ void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned cha
 void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
                                                      const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-  if (m_trackerType & EDGE_TRACKER) {
-    try {
-      vpMbEdgeTracker::trackMovingEdge(*ptr_I);
-    } catch (...) {
-      std::cerr << "Error in moving edge tracking" << std::endl;
-      throw;
-    }
-  }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  if (m_trackerType & KLT_TRACKER) {
-    try {
-      vpMbKltTracker::preTracking(*ptr_I);
-    } catch (const vpException &e) {
-      std::cerr << "Error in KLT tracking: " << e.what() << std::endl;
-      throw;
-    }
-  }
-#endif
+  preTrackingImage(ptr_I);
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
     try {
@@ -5115,6 +5366,51 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
                                                      const std::vector<vpColVector> *const point_cloud,
                                                      const unsigned int pointcloud_width,
                                                      const unsigned int pointcloud_height)
+{
+  preTrackingImage(ptr_I);
+
+  if (m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) {
+    preTrackingDepth(vpMbtDepthPoints(*point_cloud, pointcloud_width, pointcloud_height));
+  }
+}
+
+void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
+                                                     const vpMatrix *const point_cloud,
+                                                     const unsigned int pointcloud_width,
+                                                     const unsigned int pointcloud_height)
+{
+  preTrackingImage(ptr_I);
+
+  if (m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) {
+    preTrackingDepth(vpMbtDepthPoints(*point_cloud, pointcloud_width, pointcloud_height));
+  }
+}
+
+// Extract the depth features of the visible faces from an organized point
+// cloud
+void vpMbGenericTracker::TrackerWrapper::preTrackingDepth(const vpMbtDepthPoints &points)
+{
+  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    try {
+      vpMbDepthNormalTracker::segmentPointCloud(points);
+    } catch (...) {
+      std::cerr << "Error in Depth tracking" << std::endl;
+      throw;
+    }
+  }
+
+  if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    try {
+      vpMbDepthDenseTracker::segmentPointCloud(points);
+    } catch (...) {
+      std::cerr << "Error in Depth dense tracking" << std::endl;
+      throw;
+    }
+  }
+}
+
+// Track the moving edges and the KLT points in the image
+void vpMbGenericTracker::TrackerWrapper::preTrackingImage(const vpImage<unsigned char> *const ptr_I)
 {
   if (m_trackerType & EDGE_TRACKER) {
     try {
@@ -5135,23 +5431,20 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
     }
   }
 #endif
+}
 
-  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    try {
-      vpMbDepthNormalTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
-    } catch (...) {
-      std::cerr << "Error in Depth tracking" << std::endl;
-      throw;
-    }
-  }
+void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
+                                                     const vpImage<uint16_t> *const depth, const double depthScale)
+{
+  preTrackingImage(ptr_I);
 
-  if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    try {
-      vpMbDepthDenseTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
-    } catch (...) {
-      std::cerr << "Error in Depth dense tracking" << std::endl;
-      throw;
-    }
+  if (m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) {
+    // Both depth trackers share the camera parameters, a single ray table
+    // serves them
+    vpMbtDepthRayTable &rays =
+        (m_trackerType & DEPTH_NORMAL_TRACKER) ? m_depthNormalRayTable : m_depthDenseRayTable;
+    rays.build(cam, depth->getWidth(), depth->getHeight());
+    preTrackingDepth(vpMbtDepthPoints(*depth, depthScale, rays));
   }
 }
 
@@ -72,6 +72,7 @@
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbTracker.h>
+#include <visp3/mbt/vpMbtNormalEquations.h>
 
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
@@ -106,14 +107,44 @@ namespace
   Structure to store info about segment in CAO model files.
  */
 struct SegmentInfo {
-  SegmentInfo() : extremities(), name(), useLod(false), minLineLengthThresh(0.) {}
+  SegmentInfo() : extremities(), name(), useLod(false), minLineLengthThresh(0.), cachePrimitive() {}
 
   std::vector<vpPoint> extremities;
   std::string name;
   bool useLod;
   double minLineLengthThresh;
+  vpMbtModelCache::vpPrimitive cachePrimitive;
 };
 
+/*!
+  Create the description of a primitive of a CAO model file for the model
+  cache, with the LOD parameters explicitly given in the file.
+ */
+vpMbtModelCache::vpPrimitive createCachePrimitive(const vpMbtModelCache::vpPrimitiveType type,
+                                                  const std::map<std::string, std::string> &mapOfParams,
+                                                  const std::string &name, const bool useLod,
+                                                  const double minLineLengthThreshold,
+                                                  const double minPolygonAreaThreshold)
+{
+  vpMbtModelCache::vpPrimitive primitive;
+  primitive.type = type;
+  primitive.name = name;
+  if (mapOfParams.find("useLod") != mapOfParams.end()) {
+    primitive.lodFlags |= vpMbtModelCache::HAS_USE_LOD;
+    primitive.useLod = useLod;
+  }
+  if (mapOfParams.find("minLineLengthThreshold") != mapOfParams.end()) {
+    primitive.lodFlags |= vpMbtModelCache::HAS_MIN_LINE_LENGTH;
+    primitive.minLineLengthThreshold = minLineLengthThreshold;
+  }
+  if (mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
+    primitive.lodFlags |= vpMbtModelCache::HAS_MIN_POLYGON_AREA;
+    primitive.minPolygonAreaThreshold = minPolygonAreaThreshold;
+  }
+
+  return primitive;
+}
+
 /*!
   Structure to store info about a polygon face represented by a vpPolygon and
   by a list of vpPoint representing the corners of the polygon face in 3D.
@@ -151,7 +182,8 @@ vpMbTracker::vpMbTracker()
     m_projectionErrorFaces(), m_projectionErrorOgreShowConfigDialog(false),
     m_projectionErrorMe(), m_projectionErrorKernelSize(2), m_SobelX(5,5), m_SobelY(5,5),
     m_projectionErrorDisplay(false), m_projectionErrorDisplayLength(20), m_projectionErrorDisplayThickness(1),
-    m_projectionErrorCam(), m_mask(NULL)
+    m_projectionErrorCam(), m_mask(NULL), m_useModelCache(false), m_modelCache(), m_recordModelCache(false),
+    m_projectionErrorLineIndex()
 {
   oJo.eye();
   // Map used to parse additional information in CAO model files,
@@ -1095,7 +1127,56 @@ void vpMbTracker::loadModel(const std::string &modelFile, const bool verbose, co
       nbPolygonPoints = 0;
       nbCylinders = 0;
       nbCircles = 0;
-      loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true, T);
+
+      std::string cacheFile = vpMbtModelCache::getCacheFilename(modelFile);
+      bool loadedFromCache = false;
+      if (m_useModelCache && vpIoTools::checkFilename(cacheFile) && m_modelCache.load(cacheFile) &&
+          m_modelCache.isUpToDate() && m_modelCache.getSourceFiles()[0] == vpIoTools::getAbsolutePathname(modelFile)) {
+        // The cache is only valid for the same transformation of the points
+        vpHomogeneousMatrix T_cache = m_modelCache.getTransformation();
+        bool sameTransformation = true;
+        for (unsigned int i = 0; i < 3 && sameTransformation; i++) {
+          for (unsigned int j = 0; j < 4 && sameTransformation; j++) {
+            sameTransformation = vpMath::equal(T_cache[i][j], T[i][j], std::numeric_limits<double>::epsilon());
+          }
+        }
+
+        if (sameTransformation) {
+          if (verbose) {
+            std::cout << "Model file : " << modelFile << " (cache " << cacheFile << ")" << std::endl;
+          }
+          loadCAOModelFromCache(startIdFace, verbose);
+          loadedFromCache = true;
+        }
+      }
+
+      if (!loadedFromCache) {
+        m_modelCache.clear();
+        m_modelCache.setTransformation(T);
+        m_modelCache.setFirstFaceId(startIdFace);
+        m_recordModelCache = m_useModelCache;
+        try {
+          loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true, T);
+        } catch (...) {
+          m_recordModelCache = false;
+          m_modelCache.clear();
+          throw;
+        }
+        m_recordModelCache = false;
+
+        if (m_useModelCache) {
+          vpMbtModelCache::vpModelInfo info;
+          info.nbPoints = nbPoints;
+          info.nbLines = nbLines;
+          info.nbPolygonLines = nbPolygonLines;
+          info.nbPolygonPoints = nbPolygonPoints;
+          info.nbCylinders = nbCylinders;
+          info.nbCircles = nbCircles;
+          m_modelCache.setModelInfo(info);
+          m_modelCache.computeStructures();
+          m_modelCache.save(cacheFile);
+        }
+      }
     } else if ((*(it - 1) == 'l' && *(it - 2) == 'r' && *(it - 3) == 'w' && *(it - 4) == '.') ||
                (*(it - 1) == 'L' && *(it - 2) == 'R' && *(it - 3) == 'W' && *(it - 4) == '.')) {
       loadVRMLModel(modelFile);
@@ -1319,6 +1400,9 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
     std::cout << "Model file : " << modelFile << std::endl;
   }
   vectorOfModelFilename.push_back(modelFile);
+  if (m_recordModelCache) {
+    m_modelCache.addSourceFile(vpIoTools::getAbsolutePathname(modelFile));
+  }
 
   try {
     char c;
@@ -1440,6 +1524,9 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
       caoPoints[k].setWorldCoordinates(pt_3d_tf[0], pt_3d_tf[1], pt_3d_tf[2]);
     }
 
+    // Index of the first point of this file in the model cache
+    unsigned int cachePointOffset = m_recordModelCache ? m_modelCache.addPoints(caoPoints, caoNbrPoint) : 0;
+
     removeComment(fileId);
 
     //////////////////////////Read the segment declaration part//////////////////////////
@@ -1498,6 +1585,10 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
       segmentInfo.name = segmentName;
       segmentInfo.useLod = useLod;
       segmentInfo.minLineLengthThresh = minLineLengthThresh;
+      if (m_recordModelCache) {
+        segmentInfo.cachePrimitive = createCachePrimitive(vpMbtModelCache::SEGMENT, mapOfParams, segmentName, useLod,
+                                                          minLineLengthThresh, 0.);
+      }
 
       caoLinePoints[2 * k] = index1;
       caoLinePoints[2 * k + 1] = index2;
@@ -1546,6 +1637,7 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
       unsigned int nbLinePol;
       fileId >> nbLinePol;
       std::vector<vpPoint> corners;
+      std::vector<unsigned int> cornerIndexes;
       if (nbLinePol > 100000) {
         throw vpException(vpException::badValue, "Exceed the max number of lines.");
       }
@@ -1558,6 +1650,8 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         }
         corners.push_back(caoPoints[caoLinePoints[2 * index]]);
         corners.push_back(caoPoints[caoLinePoints[2 * index + 1]]);
+        cornerIndexes.push_back(cachePointOffset + caoLinePoints[2 * index]);
+        cornerIndexes.push_back(cachePointOffset + caoLinePoints[2 * index + 1]);
 
         std::pair<unsigned int, unsigned int> key(caoLinePoints[2 * index], caoLinePoints[2 * index + 1]);
         faceSegmentKeyVector.push_back(key);
@@ -1583,6 +1677,14 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         useLod = parseBoolean(mapOfParams["useLod"]);
       }
 
+      if (m_recordModelCache) {
+        vpMbtModelCache::vpPrimitive primitive = createCachePrimitive(
+            vpMbtModelCache::POLYGON_FROM_LINES, mapOfParams, polygonName, useLod, 0., minPolygonAreaThreshold);
+        primitive.points = cornerIndexes;
+        primitive.idFace = idFace;
+        m_modelCache.addPrimitive(primitive);
+      }
+
       addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
       initFaceFromLines(*(faces.getPolygon().back())); // Init from the last polygon that was added
 
@@ -1595,6 +1697,14 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
          it != segmentTemporaryMap.end(); ++it) {
       if (std::find(faceSegmentKeyVector.begin(), faceSegmentKeyVector.end(), it->first) ==
           faceSegmentKeyVector.end()) {
+        if (m_recordModelCache) {
+          vpMbtModelCache::vpPrimitive primitive = it->second.cachePrimitive;
+          primitive.points.push_back(cachePointOffset + it->first.first);
+          primitive.points.push_back(cachePointOffset + it->first.second);
+          primitive.idFace = idFace;
+          m_modelCache.addPrimitive(primitive);
+        }
+
         addPolygon(it->second.extremities, idFace, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
                    it->second.minLineLengthThresh);
         initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
@@ -1631,12 +1741,14 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         throw vpException(vpException::badValue, "Exceed the max number of points.");
       }
       std::vector<vpPoint> corners;
+      std::vector<unsigned int> cornerIndexes;
       for (unsigned int n = 0; n < nbPointPol; n++) {
         fileId >> index;
         if (index > caoNbrPoint - 1) {
           throw vpException(vpException::badValue, "Exceed the max number of points.");
         }
         corners.push_back(caoPoints[index]);
+        cornerIndexes.push_back(cachePointOffset + index);
       }
 
       //////////////////////////Read the parameter value if present//////////////////////////
@@ -1659,6 +1771,14 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         useLod = parseBoolean(mapOfParams["useLod"]);
       }
 
+      if (m_recordModelCache) {
+        vpMbtModelCache::vpPrimitive primitive = createCachePrimitive(
+            vpMbtModelCache::POLYGON_FROM_POINTS, mapOfParams, polygonName, useLod, 0., minPolygonAreaThreshold);
+        primitive.points = cornerIndexes;
+        primitive.idFace = idFace;
+        m_modelCache.addPrimitive(primitive);
+      }
+
       addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
       initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
 
@@ -1721,6 +1841,16 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         }
 
         int idRevolutionAxis = idFace;
+        if (m_recordModelCache) {
+          vpMbtModelCache::vpPrimitive primitive = createCachePrimitive(
+              vpMbtModelCache::CYLINDER, mapOfParams, polygonName, useLod, minLineLengthThreshold, 0.);
+          primitive.points.push_back(cachePointOffset + indexP1);
+          primitive.points.push_back(cachePointOffset + indexP2);
+          primitive.radius = radius;
+          primitive.idFace = idFace;
+          m_modelCache.addPrimitive(primitive);
+        }
+
         addPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace, polygonName, useLod, minLineLengthThreshold);
 
         addProjectionErrorPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace++, polygonName, useLod, minLineLengthThreshold);
@@ -1797,6 +1927,17 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
           useLod = parseBoolean(mapOfParams["useLod"]);
         }
 
+        if (m_recordModelCache) {
+          vpMbtModelCache::vpPrimitive primitive = createCachePrimitive(
+              vpMbtModelCache::CIRCLE, mapOfParams, polygonName, useLod, 0., minPolygonAreaThreshold);
+          primitive.points.push_back(cachePointOffset + indexP1);
+          primitive.points.push_back(cachePointOffset + indexP2);
+          primitive.points.push_back(cachePointOffset + indexP3);
+          primitive.radius = radius;
+          primitive.idFace = idFace;
+          m_modelCache.addPrimitive(primitive);
+        }
+
         addPolygon(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
                    minPolygonAreaThreshold);
 
@@ -1841,6 +1982,125 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
   }
 }
 
+/*!
+  Create the faces, lines, cylinders and circles of the CAO model described
+  in the model cache, as loadCAOModel() does when it parses the model files.
+  The LOD parameters that are not given in the model files are resolved with
+  the current settings of the tracker.
+
+  \param startIdFace : Current Id of the face.
+  \param verbose : If true, print the number of elements of the model.
+*/
+void vpMbTracker::loadCAOModelFromCache(int &startIdFace, const bool verbose)
+{
+  const vpMbtModelCache::vpModelInfo &info = m_modelCache.getModelInfo();
+  nbPoints = info.nbPoints;
+  nbLines = info.nbLines;
+  nbPolygonLines = info.nbPolygonLines;
+  nbPolygonPoints = info.nbPolygonPoints;
+  nbCylinders = info.nbCylinders;
+  nbCircles = info.nbCircles;
+
+  if (verbose) {
+    std::cout << "Total nb of points : " << nbPoints << std::endl;
+    std::cout << "Total nb of lines : " << nbLines << std::endl;
+    std::cout << "Total nb of polygon lines : " << nbPolygonLines << std::endl;
+    std::cout << "Total nb of polygon points : " << nbPolygonPoints << std::endl;
+    std::cout << "Total nb of cylinders : " << nbCylinders << std::endl;
+    std::cout << "Total nb of circles : " << nbCircles << std::endl;
+  } else {
+    std::cout << "> " << nbPoints << " points" << std::endl;
+    std::cout << "> " << nbLines << " lines" << std::endl;
+    std::cout << "> " << nbPolygonLines << " polygon lines" << std::endl;
+    std::cout << "> " << nbPolygonPoints << " polygon points" << std::endl;
+    std::cout << "> " << nbCylinders << " cylinders" << std::endl;
+    std::cout << "> " << nbCircles << " circles" << std::endl;
+  }
+
+  const std::vector<vpPoint> &points = m_modelCache.getPoints();
+  const std::vector<vpMbtModelCache::vpPrimitive> &primitives = m_modelCache.getPrimitives();
+  int offsetIdFace = startIdFace - m_modelCache.getFirstFaceId();
+
+  for (std::vector<vpMbtModelCache::vpPrimitive>::const_iterator it = primitives.begin(); it != primitives.end();
+       ++it) {
+    const vpMbtModelCache::vpPrimitive &primitive = *it;
+    int idFace = primitive.idFace + offsetIdFace;
+
+    bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
+    double minLineLengthThreshold = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
+    double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
+    if (primitive.lodFlags & vpMbtModelCache::HAS_USE_LOD) {
+      useLod = primitive.useLod;
+    }
+    if (primitive.lodFlags & vpMbtModelCache::HAS_MIN_LINE_LENGTH) {
+      minLineLengthThreshold = primitive.minLineLengthThreshold;
+    }
+    if (primitive.lodFlags & vpMbtModelCache::HAS_MIN_POLYGON_AREA) {
+      minPolygonAreaThreshold = primitive.minPolygonAreaThreshold;
+    }
+
+    std::vector<vpPoint> corners;
+    for (size_t i = 0; i < primitive.points.size(); i++) {
+      corners.push_back(points[primitive.points[i]]);
+    }
+
+    switch (primitive.type) {
+    case vpMbtModelCache::POLYGON_FROM_LINES:
+      addPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
+      initFaceFromLines(*(faces.getPolygon().back()));
+
+      addProjectionErrorPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThreshold,
+                                minLineLengthThresholdGeneral);
+      initProjectionErrorFaceFromLines(*(m_projectionErrorFaces.getPolygon().back()));
+      break;
+
+    case vpMbtModelCache::POLYGON_FROM_POINTS:
+      addPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
+      initFaceFromCorners(*(faces.getPolygon().back()));
+
+      addProjectionErrorPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThreshold,
+                                minLineLengthThresholdGeneral);
+      initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+      break;
+
+    case vpMbtModelCache::SEGMENT:
+      addPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThresholdGeneral, minLineLengthThreshold);
+      initFaceFromCorners(*(faces.getPolygon().back()));
+
+      addProjectionErrorPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThresholdGeneral,
+                                minLineLengthThreshold);
+      initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+      break;
+
+    case vpMbtModelCache::CYLINDER: {
+      addPolygon(corners[0], corners[1], idFace, primitive.name, useLod, minLineLengthThreshold);
+      addProjectionErrorPolygon(corners[0], corners[1], idFace, primitive.name, useLod, minLineLengthThreshold);
+
+      std::vector<std::vector<vpPoint> > listFaces;
+      createCylinderBBox(corners[0], corners[1], primitive.radius, listFaces);
+      addPolygon(listFaces, idFace + 1, primitive.name, useLod, minLineLengthThreshold);
+
+      initCylinder(corners[0], corners[1], primitive.radius, idFace, primitive.name);
+
+      addProjectionErrorPolygon(listFaces, idFace + 1, primitive.name, useLod, minLineLengthThreshold);
+      initProjectionErrorCylinder(corners[0], corners[1], primitive.radius, idFace, primitive.name);
+      break;
+    }
+
+    case vpMbtModelCache::CIRCLE:
+      addPolygon(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name, useLod,
+                 minPolygonAreaThreshold);
+
+      initCircle(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name);
+
+      addProjectionErrorPolygon(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name, useLod,
+                                minPolygonAreaThreshold);
+      initProjectionErrorCircle(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name);
+      break;
+    }
+  }
+}
+
 #ifdef VISP_HAVE_COIN3D
 /*!
   Extract a VRML object Group.
@@ -2478,66 +2738,157 @@ void vpMbTracker::computeVVSCheckLevenbergMarquardt(const unsigned int iter, vpC
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Rows of an interaction matrix stored in a vpMatrix
+class MatrixRows : public vpMbtNormalEquations::vpRows
+{
+public:
+  MatrixRows(const vpMatrix &L, const vpColVector &error, const double *const w) : m_L(L), m_error(error), m_w(w) {}
+
+  unsigned int getNbRows() const { return m_L.getRows(); }
+
+  void addRows(unsigned int begin, unsigned int end, vpMbtNormalEquations &ne) const
+  {
+    for (unsigned int i = begin; i < end; i++) {
+      ne.addRow(m_L[i], m_w != NULL ? m_w[i] : 1.0, m_error[i]);
+    }
+  }
+
+private:
+  const vpMatrix &m_L;
+  const vpColVector &m_error;
+  const double *const m_w;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Add the normal equations of the weighted interaction matrix \e L and
+  residual \e error to \e LTL and \e LTR:
+  \f$ L^T W^2 L \f$ and \f$ L^T W^2 e \f$, with \f$ W = diag(w) \f$.
+
+  Used for the feature types whose rows are computed in a matrix (KLT
+  points, depth normals). Large matrices are accumulated by chunks on
+  vpThreadPool, see vpMbtNormalEquations.
+
+  \param L : Interaction matrix (size Nx6).
+  \param error : Residual (size N).
+  \param w : Pointer to the N weights of the rows, or NULL for unit weights.
+  \param LTL : Normal matrix (size 6x6) to which the contributions are added.
+  \param LTR : Right-hand side (size 6) to which the contributions are added.
+*/
+void vpMbTracker::addVVSNormalEquations(const vpMatrix &L, const vpColVector &error, const double *const w,
+                                        vpMatrix &LTL, vpColVector &LTR)
+{
+  if (L.getRows() != error.getRows() || (L.getRows() > 0 && L.getCols() != 6)) {
+    throw vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                            "Incorrect matrices size in addVVSNormalEquations.");
+  }
+
+  vpMbtNormalEquations::accumulate(MatrixRows(L, error, w), LTL, LTR);
+}
+
+/*!
+  Check from the normal equations \f$ L^T L \f$ of the unweighted
+  interaction matrix which degrees of freedom can be estimated. If
+  \f$ L \f$ is not full rank, \e oJo projects the velocity on the estimable
+  degrees of freedom and \e isoJoIdentity_ is set to false. This is
+  particularly useful when considering circles (rank 5) and cylinders
+  (rank 4).
+
+  \param LTL : Normal matrix of the unweighted interaction matrix (size 6x6).
+  \param isoJoIdentity_ : True when all the 6 degrees of freedom can be estimated.
+*/
+void vpMbTracker::computeVVSCheckRank(const vpMatrix &LTL, bool &isoJoIdentity_)
+{
+  isoJoIdentity_ = true;
+  oJo.eye();
+
+  vpVelocityTwistMatrix cVo;
+  cVo.buildFrom(cMo);
+
+  // The kernel of L cVo is the one of cVo^T L^T L cVo, whose singular values
+  // are the squared singular values of L cVo
+  vpMatrix K; // kernel
+  unsigned int rank = (vpMatrix(cVo.t()) * LTL * cVo).kernel(K, 1e-12);
+  if (rank == 0) {
+    throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
+  }
+
+  if (rank != 6) {
+    vpMatrix I; // Identity
+    I.eye(6);
+    oJo = I - K.AtA();
+
+    isoJoIdentity_ = false;
+  }
+}
+
+/*!
+  Compute the pose increment from the weighted interaction matrix \e L and
+  the weighted residual \e R, see the overload taking the normal equations.
+  \e LTL and \e LTR are set to \f$ L^T L \f$ and \f$ L^T R \f$.
+*/
 void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, vpMatrix &L,
                                            vpMatrix &LTL, vpColVector &R, const vpColVector &error,
                                            vpColVector &error_prev, vpColVector &LTR, double &mu, vpColVector &v,
                                            const vpColVector *const w, vpColVector *const m_w_prev)
 {
-  if (isoJoIdentity_) {
-    LTL = L.AtA();
-    computeJTR(L, R, LTR);
+  L.AtA(LTL);
+  computeJTR(L, R, LTR);
 
-    switch (m_optimizationMethod) {
-    case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
-      vpMatrix LMA(LTL.getRows(), LTL.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LTL + (LMA * mu);
-      v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * LTR;
+  computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, error, error_prev, mu, v, w, m_w_prev);
+}
 
-      if (iter != 0)
-        mu /= 10.0;
+/*!
+  Compute the pose increment \e v from the normal equations
+  \f$ L^T W^2 L \f$ and \f$ L^T W^2 e \f$ of the weighted interaction matrix,
+  with Gauss-Newton or Levenberg-Marquardt. When not all the degrees of
+  freedom can be estimated, the normal equations are projected with
+  \f$ J = {^c}V_o \; {^o}J_o \f$ as \f$ J^T L^T W^2 L J \f$ and
+  \f$ J^T L^T W^2 e \f$.
+*/
+void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, const vpMatrix &LTL,
+                                           const vpColVector &LTR, const vpColVector &error,
+                                           vpColVector &error_prev, double &mu, vpColVector &v,
+                                           const vpColVector *const w, vpColVector *const m_w_prev)
+{
+  vpVelocityTwistMatrix cVo;
+  vpMatrix A = LTL;
+  vpColVector b = LTR;
+  if (!isoJoIdentity_) {
+    cVo.buildFrom(cMo);
+    vpMatrix J = cVo * oJo;
+    A = J.t() * LTL * J;
+    b = J.t() * LTR;
+  }
 
-      error_prev = error;
-      if (w != NULL && m_w_prev != NULL)
-        *m_w_prev = *w;
-      break;
-    }
+  switch (m_optimizationMethod) {
+  case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
+    vpMatrix LMA(A.getRows(), A.getCols());
+    LMA.eye();
+    vpMatrix LTLmuI = A + (LMA * mu);
+    v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * b;
 
-    case vpMbTracker::GAUSS_NEWTON_OPT:
-    default:
-      v = -m_lambda * LTL.pseudoInverse(LTL.getRows() * std::numeric_limits<double>::epsilon()) * LTR;
-      break;
-    }
-  } else {
-    vpVelocityTwistMatrix cVo;
-    cVo.buildFrom(cMo);
-    vpMatrix LVJ = (L * (cVo * oJo));
-    vpMatrix LVJTLVJ = (LVJ).AtA();
-    vpColVector LVJTR;
-    computeJTR(LVJ, R, LVJTR);
-
-    switch (m_optimizationMethod) {
-    case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
-      vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LVJTLVJ + (LMA * mu);
-      v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
-      v = cVo * v;
-
-      if (iter != 0)
-        mu /= 10.0;
-
-      error_prev = error;
-      if (w != NULL && m_w_prev != NULL)
-        *m_w_prev = *w;
-      break;
-    }
-    case vpMbTracker::GAUSS_NEWTON_OPT:
-    default:
-      v = -m_lambda * LVJTLVJ.pseudoInverse(LVJTLVJ.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
-      v = cVo * v;
-      break;
-    }
+    if (iter != 0)
+      mu /= 10.0;
+
+    error_prev = error;
+    if (w != NULL && m_w_prev != NULL)
+      *m_w_prev = *w;
+    break;
+  }
+
+  case vpMbTracker::GAUSS_NEWTON_OPT:
+  default:
+    v = -m_lambda * A.pseudoInverse(A.getRows() * std::numeric_limits<double>::epsilon()) * b;
+    break;
+  }
+
+  if (!isoJoIdentity_) {
+    v = cVo * v;
   }
 }
 
@@ -2709,6 +3060,39 @@ bool vpMbTracker::samePoint(const vpPoint &P1, const vpPoint &P2) const
     return false;
 }
 
+/*!
+  Find the lines of an index whose extremities are similar to two points,
+  in any order (see samePoint()).
+
+  \param index : Lines sorted by the X coordinate of their first point.
+  \param P1 : The first extremity.
+  \param P2 : The second extremity.
+  \return The lines of \e index joining \e P1 and \e P2.
+*/
+std::vector<vpMbtDistanceLine *> vpMbTracker::sameLines(const std::multimap<double, vpMbtDistanceLine *> &index,
+                                                        const vpPoint &P1, const vpPoint &P2) const
+{
+  std::vector<vpMbtDistanceLine *> lines;
+  const vpPoint *extremities[2] = {&P1, &P2};
+  for (unsigned int i = 0; i < 2; i++) {
+    // Only the lines whose first point has a similar X coordinate can match
+    double X = extremities[i]->get_oX();
+    std::multimap<double, vpMbtDistanceLine *>::const_iterator it_begin =
+        index.lower_bound(X - std::numeric_limits<double>::epsilon());
+    std::multimap<double, vpMbtDistanceLine *>::const_iterator it_end =
+        index.upper_bound(X + std::numeric_limits<double>::epsilon());
+    for (std::multimap<double, vpMbtDistanceLine *>::const_iterator it = it_begin; it != it_end; ++it) {
+      vpMbtDistanceLine *l = it->second;
+      if (samePoint(*(l->p1), *extremities[i]) && samePoint(*(l->p2), *extremities[1 - i]) &&
+          std::find(lines.begin(), lines.end(), l) == lines.end()) {
+        lines.push_back(l);
+      }
+    }
+  }
+
+  return lines;
+}
+
 void vpMbTracker::addProjectionErrorPolygon(const std::vector<vpPoint> &corners, const int idFace, const std::string &polygonName,
                                             const bool useLod, const double minPolygonAreaThreshold,
                                             const double minLineLengthThreshold)
@@ -2896,14 +3280,12 @@ void vpMbTracker::addProjectionErrorLine(vpPoint &P1, vpPoint &P2, int polygon,
   bool already_here = false;
   vpMbtDistanceLine *l;
 
-  for (std::vector<vpMbtDistanceLine *>::const_iterator it = m_projectionErrorLines.begin(); it != m_projectionErrorLines.end(); ++it) {
+  std::vector<vpMbtDistanceLine *> lines = sameLines(m_projectionErrorLineIndex, P1, P2);
+  for (std::vector<vpMbtDistanceLine *>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
     l = *it;
-    if ((samePoint(*(l->p1), P1) && samePoint(*(l->p2), P2)) ||
-        (samePoint(*(l->p1), P2) && samePoint(*(l->p2), P1))) {
-      already_here = true;
-      l->addPolygon(polygon);
-      l->hiddenface = &m_projectionErrorFaces;
-    }
+    already_here = true;
+    l->addPolygon(polygon);
+    l->hiddenface = &m_projectionErrorFaces;
   }
 
   if (!already_here) {
@@ -2929,6 +3311,7 @@ void vpMbTracker::addProjectionErrorLine(vpPoint &P1, vpPoint &P2, int polygon,
       l->getPolygon().setFarClippingDistance(distFarClip);
 
     m_projectionErrorLines.push_back(l);
+    m_projectionErrorLineIndex.insert(std::make_pair(l->p1->get_oX(), l));
   }
 }
 
@@ -0,0 +1,400 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Software z-buffer rendering of the polygons of a CAD model.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbZBuffer.h>
+
+/*!
+  Default constructor. Tiles are 64 x 64 pixels, the mask is not eroded and
+  the relative depth tolerance of the visibility tests is 2%.
+*/
+vpMbZBuffer::vpMbZBuffer()
+  : m_width(0), m_height(0), m_cam(), m_tileSize(64), m_maskBorder(0), m_depthTolerance(0.02), m_polygons(),
+    m_invDepth(), m_depth(), m_ids(), m_mask()
+{
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class vpMbZBuffer::RenderTilesBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  RenderTilesBody(vpMbZBuffer &zbuffer, int ntu, const std::vector<std::vector<int> > &tiles)
+    : m_zbuffer(zbuffer), m_ntu(ntu), m_tiles(tiles)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    for (unsigned int t = begin; t < end; t++) {
+      m_zbuffer.renderTile((int)t % m_ntu, (int)t / m_ntu, m_tiles[t]);
+    }
+  }
+
+private:
+  vpMbZBuffer &m_zbuffer;
+  int m_ntu;
+  const std::vector<std::vector<int> > &m_tiles;
+};
+
+class vpMbZBuffer::MaskRowsBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  explicit MaskRowsBody(vpMbZBuffer &zbuffer) : m_zbuffer(zbuffer) {}
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const vpImage<int> &ids = m_zbuffer.m_ids;
+    const int b = (int)m_zbuffer.m_maskBorder, h = (int)m_zbuffer.m_height, w = (int)m_zbuffer.m_width;
+    for (int i = (int)begin; i < (int)end; i++) {
+      unsigned char *mask = m_zbuffer.m_mask[i];
+      for (int j = 0; j < w; j++) {
+        const int id = ids[i][j];
+        bool inside = id != -1;
+        if (inside && b > 0) {
+          inside = i - b >= 0 && i + b < h && j - b >= 0 && j + b < w && ids[i - b][j] == id && ids[i + b][j] == id &&
+                   ids[i][j - b] == id && ids[i][j + b] == id;
+        }
+        mask[j] = inside ? 255 : 0;
+      }
+    }
+  }
+
+private:
+  vpMbZBuffer &m_zbuffer;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Render a set of polygons.
+
+  \param polygons : Polygons already clipped, whose points are expressed in
+  the camera frame. Polygons with less than 3 points are ignored.
+  \param listPolyIndices : Index of each polygon, as reported by
+  getPrimitiveIDs().
+  \param cam : Camera parameters used to project the polygons.
+  \param width, height : Size of the rendered image.
+*/
+void vpMbZBuffer::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
+                            const std::vector<int> &listPolyIndices, const vpCameraParameters &cam,
+                            unsigned int width, unsigned int height)
+{
+  m_width = width;
+  m_height = height;
+  m_cam = cam;
+  if (m_ids.getHeight() != height || m_ids.getWidth() != width) {
+    m_invDepth.resize(height, width);
+    m_depth.resize(height, width);
+    m_ids.resize(height, width);
+    m_mask.resize(height, width);
+  }
+
+  const double px = cam.get_px(), py = cam.get_py(), u0 = cam.get_u0(), v0 = cam.get_v0();
+  m_polygons.clear();
+  for (size_t k = 0; k < polygons.size(); k++) {
+    const std::vector<std::pair<vpPoint, unsigned int> > &poly = *polygons[k];
+    const size_t n = poly.size();
+    if (n < 3) {
+      continue;
+    }
+
+    vpZBufferPolygon zp;
+    zp.id = listPolyIndices[k];
+    zp.uv.resize(n);
+    // Newell normal and centroid of the polygon in the camera frame
+    double nx = 0, ny = 0, nz = 0, cx = 0, cy = 0, cz = 0;
+    bool inFront = true;
+    double umin = width, umax = -1, vmin = height, vmax = -1;
+    for (size_t i = 0; i < n && inFront; i++) {
+      const vpPoint &P = poly[i].first, &Q = poly[(i + 1) % n].first;
+      const double X = P.get_X(), Y = P.get_Y(), Z = P.get_Z();
+      if (Z <= 0) {
+        inFront = false;
+        break;
+      }
+      nx += (Y - Q.get_Y()) * (Z + Q.get_Z());
+      ny += (Z - Q.get_Z()) * (X + Q.get_X());
+      nz += (X - Q.get_X()) * (Y + Q.get_Y());
+      cx += X;
+      cy += Y;
+      cz += Z;
+      const double u = X / Z * px + u0, v = Y / Z * py + v0;
+      zp.uv[i] = std::make_pair(u, v);
+      umin = (std::min)(umin, u);
+      umax = (std::max)(umax, u);
+      vmin = (std::min)(vmin, v);
+      vmax = (std::max)(vmax, v);
+    }
+    if (!inFront) {
+      continue;
+    }
+
+    // Plane n.P = d. Seen edge-on when the plane contains the camera center
+    const double d = (nx * cx + ny * cy + nz * cz) / (double)n;
+    const double norm_n = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (norm_n <= 0 || std::fabs(d) <= 1e-9 * norm_n * cz / (double)n) {
+      continue;
+    }
+    // 1/Z = (nx x + ny y + nz) / d with x = (u - u0) / px and y = (v - v0) / py
+    zp.a = nx / (px * d);
+    zp.b = ny / (py * d);
+    zp.c = (nz - nx * u0 / px - ny * v0 / py) / d;
+
+    zp.umin = (std::max)(0, (int)std::ceil(umin));
+    zp.umax = (std::min)((int)width - 1, (int)std::floor(umax));
+    zp.vmin = (std::max)(0, (int)std::ceil(vmin));
+    zp.vmax = (std::min)((int)height - 1, (int)std::floor(vmax));
+    if (zp.umin > zp.umax || zp.vmin > zp.vmax) {
+      continue;
+    }
+    m_polygons.push_back(zp);
+  }
+
+  // Bin the polygons by tile, keeping their order so that the result does
+  // not depend on the number of threads
+  const int T = (int)m_tileSize;
+  const int ntu = ((int)width + T - 1) / T, ntv = ((int)height + T - 1) / T;
+  std::vector<std::vector<int> > tiles((size_t)(ntu * ntv));
+  for (size_t k = 0; k < m_polygons.size(); k++) {
+    const vpZBufferPolygon &zp = m_polygons[k];
+    for (int tv = zp.vmin / T; tv <= zp.vmax / T; tv++) {
+      for (int tu = zp.umin / T; tu <= zp.umax / T; tu++) {
+        tiles[(size_t)(tv * ntu + tu)].push_back((int)k);
+      }
+    }
+  }
+
+  // One task per tile, the tiles having very different costs
+  const unsigned int nbTiles = (unsigned int)(ntu * ntv);
+  vpThreadPool::getInstance().parallelFor(0, nbTiles, RenderTilesBody(*this, ntu, tiles), nbTiles);
+
+  buildMask();
+}
+
+/*!
+  Render the polygons of a tile, then convert the inverse depth of the tile
+  into depth.
+*/
+void vpMbZBuffer::renderTile(int tu, int tv, const std::vector<int> &tilePolygons)
+{
+  const int T = (int)m_tileSize;
+  const int j0 = tu * T, i0 = tv * T;
+  const int j1 = (std::min)(j0 + T, (int)m_width), i1 = (std::min)(i0 + T, (int)m_height);
+
+  for (int i = i0; i < i1; i++) {
+    std::fill(m_invDepth[i] + j0, m_invDepth[i] + j1, 0.f);
+    std::fill(m_ids[i] + j0, m_ids[i] + j1, -1);
+  }
+
+  std::vector<double> crossings;
+  for (size_t k = 0; k < tilePolygons.size(); k++) {
+    const vpZBufferPolygon &zp = m_polygons[(size_t)tilePolygons[k]];
+    const size_t n = zp.uv.size();
+    const int ib = (std::max)(i0, zp.vmin), ie = (std::min)(i1 - 1, zp.vmax);
+    for (int i = ib; i <= ie; i++) {
+      // Intersections of the row with the edges, with the half-open rule
+      // so that a vertex on the row is counted once
+      crossings.clear();
+      const double v = i;
+      for (size_t e = 0; e < n; e++) {
+        const std::pair<double, double> &p = zp.uv[e], &q = zp.uv[(e + 1) % n];
+        if ((p.second <= v) != (q.second <= v)) {
+          crossings.push_back(p.first + (v - p.second) * (q.first - p.first) / (q.second - p.second));
+        }
+      }
+      std::sort(crossings.begin(), crossings.end());
+
+      float *invDepth = m_invDepth[i];
+      int *ids = m_ids[i];
+      // Even-odd filling of the spans [x0, x1[
+      for (size_t s = 0; s + 1 < crossings.size(); s += 2) {
+        const int jb = (std::max)(j0, (int)std::ceil(crossings[s]));
+        const int je = (std::min)(j1, (int)std::ceil(crossings[s + 1]));
+        double inv = zp.a * jb + zp.b * v + zp.c;
+        for (int j = jb; j < je; j++, inv += zp.a) {
+          if (inv > invDepth[j]) {
+            invDepth[j] = (float)inv;
+            ids[j] = zp.id;
+          }
+        }
+      }
+    }
+  }
+
+  for (int i = i0; i < i1; i++) {
+    const float *invDepth = m_invDepth[i];
+    float *depth = m_depth[i];
+    for (int j = j0; j < j1; j++) {
+      depth[j] = invDepth[j] > 0 ? 1.f / invDepth[j] : 0.f;
+    }
+  }
+}
+
+/*!
+  Compute the mask of the visible faces. When getMaskBorder() is not null, a
+  pixel belongs to the mask if the pixels at this distance along the rows and
+  the columns belong to the same face.
+*/
+void vpMbZBuffer::buildMask() { vpThreadPool::getInstance().parallelFor(0, m_height, MaskRowsBody(*this)); }
+
+/*!
+  Test if a point at depth Z projected on pixel (u, v) is hidden: the
+  z-buffer has to be closer by more than the tolerance in all the pixels of
+  the 3x3 neighborhood, which accounts for the discretization along the
+  borders of the faces.
+*/
+bool vpMbZBuffer::isOccluded(int u, int v, double Z, double tolerance) const
+{
+  const double Zmin = Z * (1. - tolerance);
+  bool inImage = false;
+  for (int i = v - 1; i <= v + 1; i++) {
+    if (i < 0 || i >= (int)m_height)
+      continue;
+    for (int j = u - 1; j <= u + 1; j++) {
+      if (j < 0 || j >= (int)m_width)
+        continue;
+      inImage = true;
+      const float inv = m_invDepth[i][j];
+      if (inv <= 0 || 1. / inv >= Zmin) {
+        return false;
+      }
+    }
+  }
+  return inImage;
+}
+
+/*!
+  Test if a point of the model is visible in the last rendered image.
+
+  \param P : Point whose coordinates are expressed in the camera frame.
+  \param tolerance : Relative depth tolerance, or a negative value to use
+  getDepthTolerance().
+
+  \return true if the point projects in the image and is not hidden by a
+  face.
+*/
+bool vpMbZBuffer::isVisible(const vpPoint &P, double tolerance) const
+{
+  const double Z = P.get_Z();
+  if (Z <= 0) {
+    return false;
+  }
+  const double u = P.get_X() / Z * m_cam.get_px() + m_cam.get_u0();
+  const double v = P.get_Y() / Z * m_cam.get_py() + m_cam.get_v0();
+  const int ju = vpMath::round(u), iv = vpMath::round(v);
+  if (ju < 0 || iv < 0 || ju >= (int)m_width || iv >= (int)m_height) {
+    return false;
+  }
+  return !isOccluded(ju, iv, Z, tolerance < 0 ? m_depthTolerance : tolerance);
+}
+
+/*!
+  Compute the visible parts of a segment of the model, typically an edge of
+  a face, like vpMbScanLine::queryLineVisibility(). The segment is sampled
+  every pixel along its main direction in the image and each sample is
+  tested against the z-buffer.
+
+  \param a, b : Extremities of the segment expressed in the camera frame.
+  \param lines : Visible parts of the segment, whose extremities are
+  expressed in the camera frame. Parts out of the image are not visible.
+*/
+void vpMbZBuffer::queryLineVisibility(const vpPoint &a, const vpPoint &b,
+                                      std::vector<std::pair<vpPoint, vpPoint> > &lines) const
+{
+  lines.clear();
+  const double Za = a.get_Z(), Zb = b.get_Z();
+  if (Za <= 0 || Zb <= 0 || m_width == 0 || m_height == 0) {
+    return;
+  }
+  const double px = m_cam.get_px(), py = m_cam.get_py(), u0 = m_cam.get_u0(), v0 = m_cam.get_v0();
+  // Homogeneous pixel coordinates
+  const double Ua = a.get_X() * px + u0 * Za, Va = a.get_Y() * py + v0 * Za;
+  const double Ub = b.get_X() * px + u0 * Zb, Vb = b.get_Y() * py + v0 * Zb;
+  const double ua = Ua / Za, va = Va / Za, ub = Ub / Zb, vb = Vb / Zb;
+
+  // Sample along the main direction of the segment in the image
+  const bool alongU = std::fabs(ub - ua) >= std::fabs(vb - va);
+  const double pa = alongU ? ua : va, pb = alongU ? ub : vb;
+  const double Pa = alongU ? Ua : Va, Pb = alongU ? Ub : Vb;
+  const int size = (int)(alongU ? m_width : m_height);
+  const double pmin = (std::min)(pa, pb), pmax = (std::max)(pa, pb);
+  if (pmax < 0 || pmin > size - 1 || pmax - pmin <= std::numeric_limits<double>::epsilon()) {
+    return;
+  }
+  const int sb = (std::max)(0, (int)std::ceil(pmin)), se = (std::min)(size - 1, (int)std::floor(pmax));
+  const bool reversed = pa > pb;
+
+  bool started = false;
+  vpPoint start, end;
+  for (int k = sb; k <= se; k++) {
+    const int s = reversed ? se - (k - sb) : k;
+    // Parameter of the point of the segment that projects on the sample,
+    // with the perspective
+    double alpha = (Pa - s * Za) / (s * (Zb - Za) - (Pb - Pa));
+    if (vpMath::isNaN(alpha) || vpMath::isInf(alpha)) {
+      alpha = 0;
+    }
+    alpha = (std::max)(0., (std::min)(1., alpha));
+    vpPoint P;
+    P.set_X(a.get_X() + alpha * (b.get_X() - a.get_X()));
+    P.set_Y(a.get_Y() + alpha * (b.get_Y() - a.get_Y()));
+    P.set_Z(Za + alpha * (Zb - Za));
+    const double u = P.get_X() * px / P.get_Z() + u0, v = P.get_Y() * py / P.get_Z() + v0;
+    const int ju = vpMath::round(u), iv = vpMath::round(v);
+    const bool visible = ju >= 0 && iv >= 0 && ju < (int)m_width && iv < (int)m_height &&
+                         !isOccluded(ju, iv, P.get_Z(), m_depthTolerance);
+
+    if (visible) {
+      // The extremities of the segment are kept when their sample is visible
+      const bool first = k == sb && (reversed ? pmax - se < 1 : sb - pmin < 1);
+      const bool last = k == se && (reversed ? sb - pmin < 1 : pmax - se < 1);
+      if (!started) {
+        start = first ? a : P;
+        started = true;
+      }
+      end = last ? b : P;
+    } else if (started) {
+      lines.push_back(std::make_pair(start, end));
+      started = false;
+    }
+  }
+  if (started) {
+    lines.push_back(std::make_pair(start, end));
+  }
+}
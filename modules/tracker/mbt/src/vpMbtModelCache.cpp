@@ -0,0 +1,557 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Binary cache of the CAD models loaded by the model-based trackers.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbtModelCache.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+const char vpMbtModelCacheMagic[8] = {'V', 'I', 'S', 'P', 'M', 'B', 'T', 'C'};
+const uint32_t vpMbtModelCacheVersion = 2;
+// Upper bound of the number of elements of each section, used to reject a
+// corrupted file before allocating memory
+const uint32_t vpMbtModelCacheMaxCount = 100000000;
+
+// Size and 64-bit FNV-1a hash of the content of a file. The modification
+// time is not used: its resolution does not detect a file rewritten within
+// the same second, and copying a file may or may not keep it.
+bool getFileStatus(const std::string &filename, double &size, uint64_t &hash)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  const uint64_t prime = ((uint64_t)0x100 << 32) | 0x1b3;
+  hash = ((uint64_t)0xcbf29ce4 << 32) | 0x84222325;
+  size = 0;
+  char buffer[4096];
+  while (file.good()) {
+    file.read(buffer, (std::streamsize)sizeof(buffer));
+    std::streamsize n = file.gcount();
+    for (std::streamsize i = 0; i < n; i++) {
+      hash = (hash ^ (unsigned char)buffer[i]) * prime;
+    }
+    size += (double)n;
+  }
+
+  return file.eof();
+}
+
+void writeString(std::ofstream &file, const std::string &str)
+{
+  vpIoTools::writeBinaryValueLE(file, (uint32_t)str.size());
+  file.write(str.c_str(), (std::streamsize)str.size());
+}
+
+bool readCount(std::ifstream &file, uint32_t &count)
+{
+  vpIoTools::readBinaryValueLE(file, count);
+  return file.good() && count <= vpMbtModelCacheMaxCount;
+}
+
+bool readString(std::ifstream &file, std::string &str)
+{
+  uint32_t length;
+  if (!readCount(file, length)) {
+    return false;
+  }
+  str.resize(length);
+  if (length > 0) {
+    file.read(&str[0], (std::streamsize)length);
+  }
+  return file.good();
+}
+
+// Check that a primitive read from a file has the number of points that its
+// type needs
+bool hasValidNbPoints(const uint32_t type, const uint32_t nbPoints)
+{
+  switch (type) {
+  case vpMbtModelCache::POLYGON_FROM_LINES:
+    return nbPoints % 2 == 0;
+  case vpMbtModelCache::SEGMENT:
+  case vpMbtModelCache::CYLINDER:
+    return nbPoints == 2;
+  case vpMbtModelCache::CIRCLE:
+    return nbPoints == 3;
+  default:
+    return true;
+  }
+}
+
+bool isFace(const vpMbtModelCache::vpPrimitive &primitive)
+{
+  return (primitive.type == vpMbtModelCache::POLYGON_FROM_LINES ||
+          primitive.type == vpMbtModelCache::POLYGON_FROM_POINTS);
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor, with an empty model.
+*/
+vpMbtModelCache::vpMbtModelCache()
+  : m_points(), m_primitives(), m_normals(), m_edges(), m_sourceFiles(), m_sourceSizes(), m_sourceHashes(), m_T(),
+    m_firstFaceId(0), m_info()
+{
+}
+
+/*!
+  Append points to the model.
+
+  \param points : Array of points, expressed in the object frame.
+  \param nbPoints : Number of points in \e points.
+
+  \return The index of the first added point in getPoints(), that is the
+  offset to add to the indexes of the points in the file that declares them.
+*/
+unsigned int vpMbtModelCache::addPoints(const vpPoint *points, unsigned int nbPoints)
+{
+  unsigned int offset = (unsigned int)m_points.size();
+  m_points.insert(m_points.end(), points, points + nbPoints);
+  return offset;
+}
+
+/*!
+  Append a primitive to the model.
+
+  \param primitive : Primitive, with indexes of points in getPoints().
+*/
+void vpMbtModelCache::addPrimitive(const vpPrimitive &primitive) { m_primitives.push_back(primitive); }
+
+/*!
+  Append a file to the list of files parsed to build the model. Its size
+  and the hash of its content are computed to check later if the model is
+  up to date.
+
+  \param filename : Full name of the parsed file.
+*/
+void vpMbtModelCache::addSourceFile(const std::string &filename)
+{
+  double size = 0;
+  uint64_t hash = 0;
+  getFileStatus(filename, size, hash);
+  m_sourceFiles.push_back(filename);
+  m_sourceSizes.push_back(size);
+  m_sourceHashes.push_back(hash);
+}
+
+/*!
+  Remove the model description, the source files and the precomputed
+  structures.
+*/
+void vpMbtModelCache::clear()
+{
+  m_points.clear();
+  m_primitives.clear();
+  m_normals.clear();
+  m_edges.clear();
+  m_sourceFiles.clear();
+  m_sourceSizes.clear();
+  m_sourceHashes.clear();
+  m_T.eye();
+  m_firstFaceId = 0;
+  m_info = vpModelInfo();
+}
+
+/*!
+  Compute the normal of each face, with the Newell method, and the list of
+  the unique edges of the faces and segments with the primitives sharing
+  them.
+*/
+void vpMbtModelCache::computeStructures()
+{
+  m_normals.assign(m_primitives.size(), vpColVector(3, 0.0));
+  m_edges.clear();
+
+  std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeIndex;
+  for (size_t i = 0; i < m_primitives.size(); i++) {
+    const vpPrimitive &primitive = m_primitives[i];
+    if (!isFace(primitive) && primitive.type != SEGMENT) {
+      continue;
+    }
+
+    // Faces declared from lines list the two extremities of each line
+    size_t step = primitive.type == POLYGON_FROM_LINES ? 2 : 1;
+    size_t nbPoints = primitive.points.size();
+    std::vector<unsigned int> corners;
+    for (size_t j = 0; j < nbPoints; j += step) {
+      corners.push_back(primitive.points[j]);
+    }
+
+    size_t nbCorners = corners.size();
+    size_t nbEdges = (primitive.type == SEGMENT || nbCorners < 3) ? nbCorners - 1 : nbCorners;
+    for (size_t j = 0; j < nbEdges && nbCorners > 1; j++) {
+      unsigned int a, b;
+      if (primitive.type == POLYGON_FROM_LINES) {
+        a = primitive.points[2 * j];
+        b = primitive.points[2 * j + 1];
+      } else {
+        a = corners[j];
+        b = corners[(j + 1) % nbCorners];
+      }
+      std::pair<unsigned int, unsigned int> key(std::min(a, b), std::max(a, b));
+      std::map<std::pair<unsigned int, unsigned int>, unsigned int>::const_iterator it = edgeIndex.find(key);
+      if (it == edgeIndex.end()) {
+        vpEdge edge;
+        edge.p1 = a;
+        edge.p2 = b;
+        edge.primitives.push_back((unsigned int)i);
+        edgeIndex[key] = (unsigned int)m_edges.size();
+        m_edges.push_back(edge);
+      } else {
+        m_edges[it->second].primitives.push_back((unsigned int)i);
+      }
+    }
+
+    if (isFace(primitive) && nbCorners >= 3) {
+      vpColVector &n = m_normals[i];
+      for (size_t j = 0; j < nbCorners; j++) {
+        const vpPoint &P = m_points[corners[j]];
+        const vpPoint &Q = m_points[corners[(j + 1) % nbCorners]];
+        n[0] += (P.get_oY() - Q.get_oY()) * (P.get_oZ() + Q.get_oZ());
+        n[1] += (P.get_oZ() - Q.get_oZ()) * (P.get_oX() + Q.get_oX());
+        n[2] += (P.get_oX() - Q.get_oX()) * (P.get_oY() + Q.get_oY());
+      }
+      double norm = n.euclideanNorm();
+      if (norm > std::numeric_limits<double>::epsilon()) {
+        n /= norm;
+      }
+    }
+  }
+}
+
+/*!
+  Get the name of the cache file of a model file.
+
+  \param modelFile : Full name of the model file.
+  \return The full name of the cache file.
+*/
+std::string vpMbtModelCache::getCacheFilename(const std::string &modelFile) { return modelFile + ".bin"; }
+
+/*!
+  Check that all the files parsed to build the model still exist and have
+  the same size and content. Each file is read to compute the hash of its
+  content.
+
+  \return true if the model is up to date, false otherwise or if it has no
+  source file.
+*/
+bool vpMbtModelCache::isUpToDate() const
+{
+  if (m_sourceFiles.empty()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    double size;
+    uint64_t hash;
+    if (!getFileStatus(m_sourceFiles[i], size, hash) || size != m_sourceSizes[i] || hash != m_sourceHashes[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+  Load the model from a binary file written by save().
+
+  \param filename : Name of the binary file.
+  \return true if the file was read, false if it cannot be opened, was
+  written by another version of ViSP or is corrupted. In that case the model
+  is cleared.
+*/
+bool vpMbtModelCache::load(const std::string &filename)
+{
+  clear();
+
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  bool ok = false;
+  char magic[sizeof(vpMbtModelCacheMagic)];
+  uint32_t version = 0;
+  file.read(magic, (std::streamsize)sizeof(magic));
+  vpIoTools::readBinaryValueLE(file, version);
+  if (file.good() && std::memcmp(magic, vpMbtModelCacheMagic, sizeof(magic)) == 0 &&
+      version == vpMbtModelCacheVersion) {
+    ok = true;
+
+    uint32_t count = 0;
+    ok = ok && readCount(file, count);
+    for (uint32_t i = 0; ok && i < count; i++) {
+      std::string name;
+      double size;
+      uint32_t hashHigh, hashLow;
+      ok = readString(file, name);
+      vpIoTools::readBinaryValueLE(file, size);
+      vpIoTools::readBinaryValueLE(file, hashHigh);
+      vpIoTools::readBinaryValueLE(file, hashLow);
+      m_sourceFiles.push_back(name);
+      m_sourceSizes.push_back(size);
+      m_sourceHashes.push_back(((uint64_t)hashHigh << 32) | hashLow);
+    }
+
+    for (unsigned int i = 0; ok && i < 3; i++) {
+      for (unsigned int j = 0; j < 4; j++) {
+        vpIoTools::readBinaryValueLE(file, m_T[i][j]);
+      }
+    }
+
+    int32_t firstFaceId = 0;
+    vpIoTools::readBinaryValueLE(file, firstFaceId);
+    m_firstFaceId = firstFaceId;
+
+    uint32_t info[6];
+    for (unsigned int i = 0; ok && i < 6; i++) {
+      vpIoTools::readBinaryValueLE(file, info[i]);
+    }
+    m_info.nbPoints = info[0];
+    m_info.nbLines = info[1];
+    m_info.nbPolygonLines = info[2];
+    m_info.nbPolygonPoints = info[3];
+    m_info.nbCylinders = info[4];
+    m_info.nbCircles = info[5];
+
+    ok = ok && readCount(file, count);
+    if (ok) {
+      m_points.resize(count);
+    }
+    for (uint32_t i = 0; ok && i < count; i++) {
+      double oX, oY, oZ;
+      vpIoTools::readBinaryValueLE(file, oX);
+      vpIoTools::readBinaryValueLE(file, oY);
+      vpIoTools::readBinaryValueLE(file, oZ);
+      m_points[i].setWorldCoordinates(oX, oY, oZ);
+    }
+
+    ok = ok && readCount(file, count);
+    if (ok) {
+      m_primitives.resize(count);
+    }
+    for (uint32_t i = 0; ok && i < count; i++) {
+      vpPrimitive &primitive = m_primitives[i];
+      uint32_t type, lodFlags, useLod, nbPoints;
+      int32_t idFace;
+      vpIoTools::readBinaryValueLE(file, type);
+      vpIoTools::readBinaryValueLE(file, idFace);
+      vpIoTools::readBinaryValueLE(file, lodFlags);
+      vpIoTools::readBinaryValueLE(file, useLod);
+      vpIoTools::readBinaryValueLE(file, primitive.radius);
+      vpIoTools::readBinaryValueLE(file, primitive.minLineLengthThreshold);
+      vpIoTools::readBinaryValueLE(file, primitive.minPolygonAreaThreshold);
+      ok = type <= (uint32_t)CIRCLE && readString(file, primitive.name) && readCount(file, nbPoints) &&
+           hasValidNbPoints(type, nbPoints);
+      primitive.type = (vpPrimitiveType)type;
+      primitive.idFace = idFace;
+      primitive.lodFlags = lodFlags;
+      primitive.useLod = useLod != 0;
+      if (ok) {
+        primitive.points.resize(nbPoints);
+      }
+      for (uint32_t j = 0; ok && j < nbPoints; j++) {
+        uint32_t index;
+        vpIoTools::readBinaryValueLE(file, index);
+        ok = index < m_points.size();
+        primitive.points[j] = index;
+      }
+    }
+
+    ok = ok && readCount(file, count) && count == m_primitives.size();
+    if (ok) {
+      m_normals.assign(count, vpColVector(3));
+    }
+    for (uint32_t i = 0; ok && i < count; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        vpIoTools::readBinaryValueLE(file, m_normals[i][j]);
+      }
+    }
+
+    ok = ok && readCount(file, count);
+    if (ok) {
+      m_edges.resize(count);
+    }
+    for (uint32_t i = 0; ok && i < count; i++) {
+      vpEdge &edge = m_edges[i];
+      uint32_t nbPrimitives;
+      vpIoTools::readBinaryValueLE(file, edge.p1);
+      vpIoTools::readBinaryValueLE(file, edge.p2);
+      ok = edge.p1 < m_points.size() && edge.p2 < m_points.size() && readCount(file, nbPrimitives);
+      if (ok) {
+        edge.primitives.resize(nbPrimitives);
+      }
+      for (uint32_t j = 0; ok && j < nbPrimitives; j++) {
+        vpIoTools::readBinaryValueLE(file, edge.primitives[j]);
+        ok = edge.primitives[j] < m_primitives.size();
+      }
+    }
+
+    // The file ends with the magic string, to detect a truncated file
+    file.read(magic, (std::streamsize)sizeof(magic));
+    ok = ok && file.good() && std::memcmp(magic, vpMbtModelCacheMagic, sizeof(magic)) == 0;
+  }
+
+  if (!ok) {
+    clear();
+  }
+
+  return ok;
+}
+
+/*!
+  Save the model and the precomputed structures to a binary file. The file
+  is first written under a temporary name and then renamed, so that an
+  other process loading the same model never reads a partially written
+  file.
+
+  \param filename : Name of the binary file, usually
+  getCacheFilename(modelFile).
+  \return true if the file was written, false otherwise (for instance when
+  the directory is not writable).
+*/
+bool vpMbtModelCache::save(const std::string &filename) const
+{
+  std::ostringstream oss;
+  oss << filename << "." << (unsigned long)vpTime::measureTimeMicros() << ".tmp";
+  std::string tmpFilename = oss.str();
+
+  {
+    std::ofstream file(tmpFilename.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    file.write(vpMbtModelCacheMagic, (std::streamsize)sizeof(vpMbtModelCacheMagic));
+    vpIoTools::writeBinaryValueLE(file, vpMbtModelCacheVersion);
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_sourceFiles.size());
+    for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+      writeString(file, m_sourceFiles[i]);
+      vpIoTools::writeBinaryValueLE(file, m_sourceSizes[i]);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)(m_sourceHashes[i] >> 32));
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)(m_sourceHashes[i] & 0xffffffff));
+    }
+
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 4; j++) {
+        vpIoTools::writeBinaryValueLE(file, m_T[i][j]);
+      }
+    }
+
+    vpIoTools::writeBinaryValueLE(file, (int32_t)m_firstFaceId);
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbPoints);
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbLines);
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbPolygonLines);
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbPolygonPoints);
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbCylinders);
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_info.nbCircles);
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_points.size());
+    for (size_t i = 0; i < m_points.size(); i++) {
+      vpIoTools::writeBinaryValueLE(file, m_points[i].get_oX());
+      vpIoTools::writeBinaryValueLE(file, m_points[i].get_oY());
+      vpIoTools::writeBinaryValueLE(file, m_points[i].get_oZ());
+    }
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_primitives.size());
+    for (size_t i = 0; i < m_primitives.size(); i++) {
+      const vpPrimitive &primitive = m_primitives[i];
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)primitive.type);
+      vpIoTools::writeBinaryValueLE(file, (int32_t)primitive.idFace);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)primitive.lodFlags);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)(primitive.useLod ? 1 : 0));
+      vpIoTools::writeBinaryValueLE(file, primitive.radius);
+      vpIoTools::writeBinaryValueLE(file, primitive.minLineLengthThreshold);
+      vpIoTools::writeBinaryValueLE(file, primitive.minPolygonAreaThreshold);
+      writeString(file, primitive.name);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)primitive.points.size());
+      for (size_t j = 0; j < primitive.points.size(); j++) {
+        vpIoTools::writeBinaryValueLE(file, (uint32_t)primitive.points[j]);
+      }
+    }
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_normals.size());
+    for (size_t i = 0; i < m_normals.size(); i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        vpIoTools::writeBinaryValueLE(file, m_normals[i][j]);
+      }
+    }
+
+    vpIoTools::writeBinaryValueLE(file, (uint32_t)m_edges.size());
+    for (size_t i = 0; i < m_edges.size(); i++) {
+      const vpEdge &edge = m_edges[i];
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)edge.p1);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)edge.p2);
+      vpIoTools::writeBinaryValueLE(file, (uint32_t)edge.primitives.size());
+      for (size_t j = 0; j < edge.primitives.size(); j++) {
+        vpIoTools::writeBinaryValueLE(file, (uint32_t)edge.primitives[j]);
+      }
+    }
+
+    file.write(vpMbtModelCacheMagic, (std::streamsize)sizeof(vpMbtModelCacheMagic));
+
+    if (!file.good()) {
+      file.close();
+      std::remove(tmpFilename.c_str());
+      return false;
+    }
+  }
+
+#if defined(_WIN32)
+  // rename() does not replace an existing file on Windows
+  std::remove(filename.c_str());
+#endif
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Accumulation of the normal equations of the model-based trackers.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbtNormalEquations.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Number of rows accumulated by a task. The chunks do not depend on the
+// number of threads, neither does the order of the reduction.
+#define VVS_NORMAL_EQUATIONS_CHUNK_SIZE 4096
+
+namespace
+{
+class NormalEquationsChunks : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  NormalEquationsChunks(const vpMbtNormalEquations::vpRows &rows, std::vector<vpMbtNormalEquations> &chunks)
+    : m_rows(rows), m_chunks(chunks)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int nbRows = m_rows.getNbRows();
+    for (unsigned int c = begin; c < end; c++) {
+      const unsigned int first = c * VVS_NORMAL_EQUATIONS_CHUNK_SIZE;
+      const unsigned int last = std::min(first + VVS_NORMAL_EQUATIONS_CHUNK_SIZE, nbRows);
+      m_rows.addRows(first, last, m_chunks[c]);
+    }
+  }
+
+private:
+  const vpMbtNormalEquations::vpRows &m_rows;
+  std::vector<vpMbtNormalEquations> &m_chunks;
+};
+}
+
+void vpMbtNormalEquations::add(const vpMbtNormalEquations &ne)
+{
+  for (unsigned int i = 0; i < 27; i++) {
+    m_data[i] += ne.m_data[i];
+  }
+}
+
+/*
+  Add the accumulated sums to the 6x6 matrix LTL and the 6 vector LTR.
+*/
+void vpMbtNormalEquations::addTo(vpMatrix &LTL, vpColVector &LTR) const
+{
+  if (LTL.getRows() != 6 || LTL.getCols() != 6) {
+    LTL.resize(6, 6);
+  }
+  if (LTR.getRows() != 6) {
+    LTR.resize(6);
+  }
+
+  unsigned int k = 0;
+  for (unsigned int r = 0; r < 6; r++) {
+    for (unsigned int j = r; j < 6; j++, k++) {
+      LTL[r][j] += m_data[k];
+      if (j != r) {
+        LTL[j][r] += m_data[k];
+      }
+    }
+    LTR[r] += m_data[21 + r];
+  }
+}
+
+/*
+  Add the normal equations of \e rows to LTL and LTR. The rows are split in
+  chunks of fixed size run by vpThreadPool, each one in its own accumulator.
+*/
+void vpMbtNormalEquations::accumulate(const vpRows &rows, vpMatrix &LTL, vpColVector &LTR)
+{
+  const unsigned int nbRows = rows.getNbRows();
+  const unsigned int nbChunks = (nbRows + VVS_NORMAL_EQUATIONS_CHUNK_SIZE - 1) / VVS_NORMAL_EQUATIONS_CHUNK_SIZE;
+
+  vpMbtNormalEquations ne;
+  if (nbChunks <= 1) {
+    rows.addRows(0, nbRows, ne);
+  } else {
+    std::vector<vpMbtNormalEquations> chunks(nbChunks);
+    vpThreadPool::getInstance().parallelFor(0, nbChunks, NormalEquationsChunks(rows, chunks), nbChunks);
+    for (unsigned int c = 0; c < nbChunks; c++) {
+      ne.add(chunks[c]);
+    }
+  }
+  ne.addTo(LTL, LTR);
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
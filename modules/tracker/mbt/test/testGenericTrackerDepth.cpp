@@ -55,7 +55,7 @@
 #include <visp3/gui/vpDisplayGTK.h>
 #include <visp3/mbt/vpMbGenericTracker.h>
 
-#define GETOPTARGS "i:dcle:mh"
+#define GETOPTARGS "i:dcle:mprh"
 
 namespace
 {
@@ -66,7 +66,7 @@ namespace
     \n\
     SYNOPSIS\n\
       %s [-i <test image path>] [-c] [-d] [-h] [-l] \n\
-     [-e <last frame index>] [-m]\n", name);
+     [-e <last frame index>] [-m] [-p] [-r]\n", name);
 
     fprintf(stdout, "\n\
     OPTIONS:                                               \n\
@@ -93,6 +93,14 @@ namespace
     \n\
       -m \n\
          Set a tracking mask.\n\
+    \n\
+      -p \n\
+         Use a contiguous point cloud (vpMatrix) instead of a\n\
+         vector of vpColVector.\n\
+    \n\
+      -r \n\
+         Track directly from the raw depth images instead of\n\
+         a point cloud.\n\
     \n\
       -h \n\
          Print the help.\n\n");
@@ -102,7 +110,8 @@ namespace
   }
 
   bool getOptions(int argc, const char **argv, std::string &ipath, bool &click_allowed, bool &display,
-                  bool &useScanline, int &lastFrame, bool &use_mask)
+                  bool &useScanline, int &lastFrame, bool &use_mask, bool &use_matrix_pointcloud,
+                  bool &use_raw_depth)
   {
     const char *optarg_;
     int c;
@@ -127,6 +136,12 @@ namespace
       case 'm':
         use_mask = true;
         break;
+      case 'p':
+        use_matrix_pointcloud = true;
+        break;
+      case 'r':
+        use_raw_depth = true;
+        break;
       case 'h':
         usage(argv[0], NULL);
         return false;
@@ -152,7 +167,8 @@ namespace
 
   bool read_data(const std::string &input_directory, const int cpt, const vpCameraParameters &cam_depth,
                  vpImage<unsigned char> &I, vpImage<uint16_t> &I_depth,
-                 std::vector<vpColVector> &pointcloud, vpHomogeneousMatrix &cMo)
+                 std::vector<vpColVector> &pointcloud, vpMatrix &pointcloud_matrix, const bool use_matrix_pointcloud,
+                 vpHomogeneousMatrix &cMo)
   {
     char buffer[256];
     sprintf(buffer, std::string(input_directory + "/Images/Image_%04d.pgm").c_str(), cpt);
@@ -178,7 +194,12 @@ namespace
     vpIoTools::readBinaryValueLE(file_depth, depth_height);
     vpIoTools::readBinaryValueLE(file_depth, depth_width);
     I_depth.resize(depth_height, depth_width);
-    pointcloud.resize(depth_height*depth_width);
+    // Only fill the point cloud container that is tracked
+    if (use_matrix_pointcloud) {
+      pointcloud_matrix.resize(depth_height*depth_width, 3, false);
+    } else {
+      pointcloud.resize(depth_height*depth_width);
+    }
 
     const float depth_scale = 0.000030518f;
     for (unsigned int i = 0; i < I_depth.getHeight(); i++) {
@@ -186,11 +207,17 @@ namespace
         vpIoTools::readBinaryValueLE(file_depth, I_depth[i][j]);
         double x = 0.0, y = 0.0, Z = I_depth[i][j] * depth_scale;
         vpPixelMeterConversion::convertPoint(cam_depth, j, i, x, y);
-        vpColVector pt3d(4, 1.0);
-        pt3d[0] = x*Z;
-        pt3d[1] = y*Z;
-        pt3d[2] = Z;
-        pointcloud[i*I_depth.getWidth()+j] = pt3d;
+        if (use_matrix_pointcloud) {
+          pointcloud_matrix[i*I_depth.getWidth()+j][0] = x*Z;
+          pointcloud_matrix[i*I_depth.getWidth()+j][1] = y*Z;
+          pointcloud_matrix[i*I_depth.getWidth()+j][2] = Z;
+        } else {
+          vpColVector pt3d(4, 1.0);
+          pt3d[0] = x*Z;
+          pt3d[1] = y*Z;
+          pt3d[2] = Z;
+          pointcloud[i*I_depth.getWidth()+j] = pt3d;
+        }
       }
     }
 
@@ -224,6 +251,8 @@ int main(int argc, const char *argv[])
     int opt_lastFrame = -1;
 #endif
     bool use_mask = false;
+    bool use_matrix_pointcloud = false;
+    bool use_raw_depth = false;
 
     // Get the visp-images-data package path or VISP_INPUT_IMAGE_PATH
     // environment variable value
@@ -231,12 +260,14 @@ int main(int argc, const char *argv[])
 
     // Read the command line options
     if (!getOptions(argc, argv, opt_ipath, opt_click_allowed, opt_display,
-                    useScanline, opt_lastFrame, use_mask)) {
+                    useScanline, opt_lastFrame, use_mask, use_matrix_pointcloud, use_raw_depth)) {
       return EXIT_FAILURE;
     }
 
     std::cout << "useScanline: " << useScanline << std::endl;
     std::cout << "use_mask: " << use_mask << std::endl;
+    std::cout << "use_matrix_pointcloud: " << use_matrix_pointcloud << std::endl;
+    std::cout << "use_raw_depth: " << use_raw_depth << std::endl;
 
     // Test if an input path is set
     if (opt_ipath.empty() && env_ipath.empty()) {
@@ -322,8 +353,10 @@ int main(int argc, const char *argv[])
     vpImage<vpRGBa> I_depth;
     vpHomogeneousMatrix cMo_truth;
     std::vector<vpColVector> pointcloud;
+    vpMatrix pointcloud_matrix;
     int cpt_frame = 1;
-    if (!read_data(input_directory, cpt_frame, cam_depth, I, I_depth_raw, pointcloud, cMo_truth)) {
+    if (!read_data(input_directory, cpt_frame, cam_depth, I, I_depth_raw, pointcloud, pointcloud_matrix,
+                   use_matrix_pointcloud, cMo_truth)) {
       std::cerr << "Cannot read first frame!" << std::endl;
       return EXIT_FAILURE;
     }
@@ -356,7 +389,8 @@ int main(int argc, const char *argv[])
     bool click = false, quit = false;
     std::vector<double> vec_err_t, vec_err_tu;
     std::vector<double> time_vec;
-    while (read_data(input_directory, cpt_frame, cam_depth, I, I_depth_raw, pointcloud, cMo_truth) && !quit
+    while (read_data(input_directory, cpt_frame, cam_depth, I, I_depth_raw, pointcloud, pointcloud_matrix,
+                     use_matrix_pointcloud, cMo_truth) && !quit
            && (opt_lastFrame > 0 ? (int)cpt_frame <= opt_lastFrame : true)) {
       vpImageConvert::createDepthHistogram(I_depth_raw, I_depth);
 
@@ -367,13 +401,25 @@ int main(int argc, const char *argv[])
 
       double t = vpTime::measureTimeMs();
       std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
-      std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
-      mapOfPointclouds["Camera"] = &pointcloud;
       std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
       mapOfWidths["Camera"] = I_depth.getWidth();
       mapOfHeights["Camera"] = I_depth.getHeight();
 
-      tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      if (use_raw_depth) {
+        std::map<std::string, const vpImage<uint16_t> *> mapOfDepthImages;
+        std::map<std::string, double> mapOfDepthScales;
+        mapOfDepthImages["Camera"] = &I_depth_raw;
+        mapOfDepthScales["Camera"] = 0.000030518f;
+        tracker.track(mapOfImages, mapOfDepthImages, mapOfDepthScales);
+      } else if (use_matrix_pointcloud) {
+        std::map<std::string, const vpMatrix *> mapOfPointclouds;
+        mapOfPointclouds["Camera"] = &pointcloud_matrix;
+        tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      } else {
+        std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
+        mapOfPointclouds["Camera"] = &pointcloud;
+        tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      }
       vpHomogeneousMatrix cMo = tracker.getPose();
       t = vpTime::measureTimeMs() - t;
       time_vec.push_back(t);
@@ -0,0 +1,244 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the depth trackers fed with a raw depth image and with a point cloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerDepthImage.cpp
+
+  \brief Track a synthetic box with the depth trackers, once from a raw
+  16-bit depth image and once from the point cloud back-projected from the
+  same depth image, and check that both trackers estimate the same poses.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+namespace
+{
+// Box [0, sx] x [0, sy] x [-sz, 0] in the object frame
+const double box_min[3] = {0., 0., -0.08};
+const double box_max[3] = {0.165, 0.068, 0.};
+// Depth of one unit of the raw depth image
+const double depth_scale = 0.0001;
+
+void writeModel(const std::string &filename)
+{
+  std::ofstream file(filename.c_str());
+  file << "V1\n"
+       << "# 3D points\n"
+       << "8\n";
+  for (unsigned int k = 0; k < 8; k++) {
+    const double Z = k < 4 ? box_max[2] : box_min[2];
+    const unsigned int c = k % 4;
+    const double X = (c == 1 || c == 2) ? box_max[0] : box_min[0];
+    const double Y = (c == 2 || c == 3) ? box_max[1] : box_min[1];
+    file << X << " " << Y << " " << Z << "\n";
+  }
+  file << "# 3D lines\n"
+       << "0\n"
+       << "# Faces from 3D lines\n"
+       << "0\n"
+       << "# Faces from 3D points\n"
+       << "6\n"
+       << "4 0 1 2 3\n"
+       << "4 1 0 4 5\n"
+       << "4 2 1 5 6\n"
+       << "4 3 2 6 7\n"
+       << "4 0 3 7 4\n"
+       << "4 5 4 7 6\n"
+       << "# Cylinders\n"
+       << "0\n"
+       << "# Circles\n"
+       << "0\n";
+}
+
+// Ray cast the box into a raw depth image, and back-project the depth image
+// into the point cloud expected by the point cloud interface
+void render(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int width, unsigned int height,
+            vpImage<uint16_t> &depth, std::vector<vpColVector> &pointcloud)
+{
+  depth.resize(height, width, 0);
+  pointcloud.assign(width * height, vpColVector(3, 0.));
+  const vpHomogeneousMatrix oMc = cMo.inverse();
+  const double o[3] = {oMc[0][3], oMc[1][3], oMc[2][3]};
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double x = 0., y = 0.;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+      double d[3];
+      for (unsigned int k = 0; k < 3; k++) {
+        d[k] = oMc[k][0] * x + oMc[k][1] * y + oMc[k][2];
+      }
+
+      double t0 = 0., t1 = 1e9;
+      int axis = -1;
+      bool hit = true;
+      for (unsigned int k = 0; k < 3 && hit; k++) {
+        if (std::fabs(d[k]) < 1e-12) {
+          hit = o[k] >= box_min[k] && o[k] <= box_max[k];
+          continue;
+        }
+        double ta = (box_min[k] - o[k]) / d[k], tb = (box_max[k] - o[k]) / d[k];
+        if (ta > tb) {
+          std::swap(ta, tb);
+        }
+        if (ta > t0) {
+          t0 = ta;
+          axis = (int)k;
+        }
+        t1 = std::min(t1, tb);
+        hit = t0 <= t1;
+      }
+
+      if (hit && axis >= 0) {
+        depth[i][j] = (uint16_t)vpMath::round(t0 / depth_scale);
+        const double Z = depth_scale * depth[i][j];
+        pointcloud[i * width + j][0] = x * Z;
+        pointcloud[i * width + j][1] = y * Z;
+        pointcloud[i * width + j][2] = Z;
+      }
+    }
+  }
+}
+
+bool run(const int trackerType, const std::string &modelFile)
+{
+  const unsigned int width = 320, height = 240;
+  vpCameraParameters cam(300, 300, 160, 120);
+
+  vpMbGenericTracker fromPointcloud(1, trackerType), fromDepth(1, trackerType);
+  vpMbGenericTracker *trackers[2] = {&fromPointcloud, &fromDepth};
+  for (unsigned int k = 0; k < 2; k++) {
+    trackers[k]->setCameraParameters(cam);
+    trackers[k]->loadModel(modelFile);
+    trackers[k]->setNearClippingDistance(0.01);
+    trackers[k]->setFarClippingDistance(2.0);
+    trackers[k]->setDepthNormalSamplingStep(2, 2);
+    trackers[k]->setDepthDenseSamplingStep(2, 2);
+  }
+
+  vpImage<unsigned char> I(height, width, 0);
+  vpImage<uint16_t> depth;
+  std::vector<vpColVector> pointcloud;
+  vpHomogeneousMatrix cMo_truth(-0.08, -0.03, 0.45, vpMath::rad(20), vpMath::rad(-30), vpMath::rad(10));
+  vpHomogeneousMatrix cMo_init(-0.075, -0.032, 0.455, vpMath::rad(18), vpMath::rad(-28), vpMath::rad(11));
+  fromPointcloud.initFromPose(I, cMo_init);
+  fromDepth.initFromPose(I, cMo_init);
+
+  bool ok = true;
+  double max_difference = 0., max_error = 0.;
+  for (unsigned int frame = 0; frame < 20 && ok; frame++) {
+    cMo_truth = vpHomogeneousMatrix(0.001, 0.0005, 0.001, vpMath::rad(0.3), vpMath::rad(0.2), 0.) * cMo_truth;
+    render(cMo_truth, cam, width, height, depth, pointcloud);
+
+    std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+    mapOfImages["Camera"] = &I;
+    std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
+    mapOfPointclouds["Camera"] = &pointcloud;
+    std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+    mapOfWidths["Camera"] = width;
+    mapOfHeights["Camera"] = height;
+    std::map<std::string, const vpImage<uint16_t> *> mapOfDepthImages;
+    mapOfDepthImages["Camera"] = &depth;
+    std::map<std::string, double> mapOfDepthScales;
+    mapOfDepthScales["Camera"] = depth_scale;
+
+    fromPointcloud.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+    fromDepth.track(mapOfImages, mapOfDepthImages, mapOfDepthScales);
+
+    vpPoseVector pose_pointcloud(fromPointcloud.getPose()), pose_depth(fromDepth.getPose());
+    for (unsigned int i = 0; i < 6; i++) {
+      max_difference = std::max(max_difference, std::fabs(pose_pointcloud[i] - pose_depth[i]));
+    }
+    vpTranslationVector t_error = cMo_truth.getTranslationVector() - fromDepth.getPose().getTranslationVector();
+    max_error = std::max(max_error, sqrt(t_error.sumSquare()));
+
+    if (max_difference > 1e-12) {
+      std::cerr << "Frame " << frame << ": the depth image gives the pose " << pose_depth.t() << " instead of "
+                << pose_pointcloud.t() << std::endl;
+      ok = false;
+    }
+  }
+
+  std::cout << "Tracker type " << trackerType << ": max difference between the poses: " << max_difference
+            << ", max translation error: " << max_error << std::endl;
+  if (max_error > 0.005) {
+    std::cerr << "The tracking is lost" << std::endl;
+    ok = false;
+  }
+
+  return ok;
+}
+}
+
+int main()
+{
+  try {
+    std::string username;
+    vpIoTools::getUserName(username);
+#if defined(_WIN32)
+    std::string directory = "C:/temp/" + username + "/testGenericTrackerDepthImage";
+#else
+    std::string directory = "/tmp/" + username + "/testGenericTrackerDepthImage";
+#endif
+    vpIoTools::makeDirectory(directory);
+    std::string modelFile = vpIoTools::createFilePath(directory, "box.cao");
+    writeModel(modelFile);
+
+    bool ok = run(vpMbGenericTracker::DEPTH_NORMAL_TRACKER, modelFile) &&
+              run(vpMbGenericTracker::DEPTH_DENSE_TRACKER, modelFile) &&
+              run(vpMbGenericTracker::DEPTH_NORMAL_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER, modelFile);
+
+    vpIoTools::remove(directory);
+
+    if (!ok) {
+      return EXIT_FAILURE;
+    }
+    std::cout << "testGenericTrackerDepthImage is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
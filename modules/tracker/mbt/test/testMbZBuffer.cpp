@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the software z-buffer renderer of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbZBuffer.cpp
+
+  \brief Test the software z-buffer renderer of the model-based trackers on
+  a synthetic scene, and compare it with the scanline renderer.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/mbt/vpMbScanLine.h>
+#include <visp3/mbt/vpMbZBuffer.h>
+
+namespace
+{
+typedef std::vector<std::pair<vpPoint, unsigned int> > vpPolygon3D;
+
+vpPoint makePoint(double X, double Y, double Z)
+{
+  vpPoint P;
+  P.set_X(X);
+  P.set_Y(Y);
+  P.set_Z(Z);
+  return P;
+}
+
+// Square parallel to the image plane
+vpPolygon3D makeSquare(double halfSize, double Z)
+{
+  vpPolygon3D poly;
+  poly.push_back(std::make_pair(makePoint(-halfSize, -halfSize, Z), 0u));
+  poly.push_back(std::make_pair(makePoint(halfSize, -halfSize, Z), 0u));
+  poly.push_back(std::make_pair(makePoint(halfSize, halfSize, Z), 0u));
+  poly.push_back(std::make_pair(makePoint(-halfSize, halfSize, Z), 0u));
+  return poly;
+}
+
+bool check(bool condition, const char *message)
+{
+  if (!condition)
+    std::cerr << "Failure: " << message << std::endl;
+  return condition;
+}
+}
+
+int main()
+{
+  const unsigned int width = 640, height = 480;
+  vpCameraParameters cam(600, 600, 320, 240);
+
+  // A small square in front of a large one, and a slanted quad on the right
+  std::vector<vpPolygon3D> scene;
+  scene.push_back(makeSquare(0.1, 1.));
+  scene.push_back(makeSquare(0.3, 2.));
+  vpPolygon3D slanted;
+  slanted.push_back(std::make_pair(makePoint(0.5, -0.2, 1.5), 0u));
+  slanted.push_back(std::make_pair(makePoint(0.9, -0.2, 2.5), 0u));
+  slanted.push_back(std::make_pair(makePoint(0.9, 0.2, 2.5), 0u));
+  slanted.push_back(std::make_pair(makePoint(0.5, 0.2, 1.5), 0u));
+  scene.push_back(slanted);
+
+  std::vector<vpPolygon3D *> polygons;
+  std::vector<int> indices;
+  for (size_t i = 0; i < scene.size(); i++) {
+    polygons.push_back(&scene[i]);
+    indices.push_back((int)i);
+  }
+
+  vpMbZBuffer zbuffer;
+  zbuffer.setTileSize(32);
+  zbuffer.drawScene(polygons, indices, cam, width, height);
+  const vpImage<int> &ids = zbuffer.getPrimitiveIDs();
+  const vpImage<float> &depth = zbuffer.getDepthMap();
+
+  bool ok = true;
+  ok &= check(ids[240][320] == 0 && std::fabs(depth[240][320] - 1.f) < 1e-5f, "front square");
+  ok &= check(ids[240][240] == 1 && std::fabs(depth[240][240] - 2.f) < 1e-5f, "back square");
+  ok &= check(ids[10][10] == -1 && depth[10][10] == 0.f, "background");
+
+  // Depth of the slanted quad: intersection of the ray with the plane
+  // Z = 1.5 + 2.5 (X - 0.5)
+  for (unsigned int j = 521; j < 536; j += 2) {
+    const double x = (j - 320.) / 600.;
+    const double Z = (1.5 - 1.25) / (1. - 2.5 * x);
+    ok &= check(ids[240][j] == 2 && std::fabs(depth[240][j] - Z) < 1e-4 * Z, "slanted quad");
+  }
+
+  // The top edge of the back square is entirely visible
+  std::vector<std::pair<vpPoint, vpPoint> > lines;
+  zbuffer.queryLineVisibility(makePoint(-0.3, -0.3, 2.), makePoint(0.3, -0.3, 2.), lines);
+  ok &= check(lines.size() == 1 && std::fabs(lines[0].first.get_X() + 0.3) < 1e-9 &&
+                  std::fabs(lines[0].second.get_X() - 0.3) < 1e-9,
+              "visible edge");
+
+  // A segment of the back square is split by the front square, that hides
+  // X in [-0.2, 0.2]
+  zbuffer.queryLineVisibility(makePoint(-0.3, 0., 2.), makePoint(0.3, 0., 2.), lines);
+  ok &= check(lines.size() == 2, "hidden segment");
+  if (lines.size() == 2) {
+    ok &= check(std::fabs(lines[0].first.get_X() + 0.3) < 1e-9 && std::fabs(lines[0].second.get_X() + 0.2) < 0.01 &&
+                    std::fabs(lines[1].first.get_X() - 0.2) < 0.01 && std::fabs(lines[1].second.get_X() - 0.3) < 1e-9,
+                "hidden segment extremities");
+  }
+  ok &= check(zbuffer.isVisible(makePoint(0., 0., 1.)) && !zbuffer.isVisible(makePoint(0., 0., 2.)), "point");
+
+  // Eroded mask
+  zbuffer.setMaskBorder(3);
+  zbuffer.drawScene(polygons, indices, cam, width, height);
+  ok &= check(zbuffer.getMask()[240][320] == 255 && zbuffer.getMask()[240][261] == 0 &&
+                  zbuffer.getMask()[240][258] == 0 && zbuffer.getMask()[240][250] == 255,
+              "mask");
+
+  // Same visible faces as the scanline renderer, except along the borders
+  vpMbScanLine scanline;
+  std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> scanlinePolygons(polygons.begin(), polygons.end());
+  scanline.drawScene(scanlinePolygons, indices, cam, width, height);
+  unsigned int nbDifferent = 0;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      if (scanline.getPrimitiveIDs()[i][j] != ids[i][j])
+        nbDifferent++;
+    }
+  }
+  std::cout << "Pixels that differ from the scanline renderer: " << nbDifferent << std::endl;
+  ok &= check(nbDifferent < 0.005 * width * height, "comparison with the scanline renderer");
+
+  if (!ok) {
+    return EXIT_FAILURE;
+  }
+  std::cout << "testMbZBuffer is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
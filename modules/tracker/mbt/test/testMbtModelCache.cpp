@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the binary cache of the CAD models loaded by the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtModelCache.cpp
+
+  \brief Test that a CAO model loaded from its binary cache gives the same
+  faces as the model parsed from the text file, that the cache is rebuilt
+  when the model file changes, and that a corrupted cache is rejected.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+namespace
+{
+void writeModel(const std::string &filename, double size)
+{
+  std::ofstream file(filename.c_str());
+  file << "V1\n"
+       << "# 3D points\n"
+       << "8\n"
+       << "0 0 0\n"
+       << size << " 0 0\n"
+       << size << " " << size << " 0\n"
+       << "0 " << size << " 0\n"
+       << "0 0 " << size << "\n"
+       << size << " 0 " << size << "\n"
+       << size << " " << size << " " << size << "\n"
+       << "0 " << size << " " << size << "\n"
+       << "# 3D lines\n"
+       << "5\n"
+       << "0 1\n1 2\n2 3\n3 0\n"
+       << "4 5 name=segment useLod=true minLineLengthThreshold=20\n"
+       << "# Faces from 3D lines\n"
+       << "1\n"
+       << "4 0 1 2 3 name=bottom\n"
+       << "# Faces from 3D points\n"
+       << "2\n"
+       << "4 4 5 6 7 name=top minPolygonAreaThreshold=100\n"
+       << "4 0 1 5 4\n"
+       << "# Cylinders\n"
+       << "1\n"
+       << "0 4 0.05 name=cylinder\n"
+       << "# Circles\n"
+       << "1\n"
+       << "0.05 2 3 6 name=circle\n";
+}
+
+std::string describeFaces(vpMbTracker &tracker)
+{
+  std::ostringstream oss;
+  vpMbHiddenFaces<vpMbtPolygon> &faces = tracker.getFaces();
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    vpMbtPolygon *polygon = faces[i];
+    oss << polygon->getIndex() << " " << polygon->getName() << " " << polygon->useLod << " "
+        << polygon->minLineLengthThresh << " " << polygon->minPolygonAreaThresh;
+    for (unsigned int j = 0; j < polygon->getNbPoint(); j++) {
+      vpPoint P = polygon->getPoint(j);
+      oss << " " << P.get_oX() << " " << P.get_oY() << " " << P.get_oZ();
+    }
+    oss << std::endl;
+  }
+  return oss.str();
+}
+
+// Cache whose edges can be made to refer to points and primitives that do
+// not exist, as in a corrupted file
+class vpCorruptedModelCache : public vpMbtModelCache
+{
+public:
+  explicit vpCorruptedModelCache(const vpMbtModelCache &cache) : vpMbtModelCache(cache) {}
+
+  void setEdgePoint(unsigned int index) { m_edges[0].p2 = index; }
+  void setEdgePrimitive(unsigned int index) { m_edges[0].primitives[0] = index; }
+};
+
+bool check(bool condition, const char *message)
+{
+  if (!condition)
+    std::cerr << "Failure: " << message << std::endl;
+  return condition;
+}
+}
+
+int main()
+{
+  try {
+    std::string username;
+    vpIoTools::getUserName(username);
+#if defined(_WIN32)
+    std::string directory = "C:/temp/" + username + "/testMbtModelCache";
+#else
+    std::string directory = "/tmp/" + username + "/testMbtModelCache";
+#endif
+    vpIoTools::makeDirectory(directory);
+    std::string modelFile = vpIoTools::createFilePath(directory, "cube.cao");
+    std::string cacheFile = vpMbtModelCache::getCacheFilename(modelFile);
+    writeModel(modelFile, 0.1);
+    if (vpIoTools::checkFilename(cacheFile)) {
+      vpIoTools::remove(cacheFile);
+    }
+
+    bool ok = true;
+    vpHomogeneousMatrix T(0.1, 0, 0, 0, 0, vpMath::rad(10));
+
+    // The cache is disabled by default
+    vpMbEdgeTracker parsed;
+    parsed.loadModel(modelFile, false, T);
+    ok &= check(!vpIoTools::checkFilename(cacheFile), "cache written while disabled");
+
+    // The generic tracker forwards the setting to the tracker of each camera
+    vpMbGenericTracker generic(1, vpMbGenericTracker::EDGE_TRACKER);
+    generic.setUseModelCache(true);
+    generic.loadModel(modelFile, false, T);
+    ok &= check(vpIoTools::checkFilename(cacheFile), "cache not written by the generic tracker");
+    vpIoTools::remove(cacheFile);
+
+    // The first load writes the cache, the second one reads it
+    vpMbEdgeTracker written, cached;
+    written.setUseModelCache(true);
+    written.loadModel(modelFile, false, T);
+    ok &= check(vpIoTools::checkFilename(cacheFile), "cache not written");
+    cached.setUseModelCache(true);
+    cached.loadModel(modelFile, false, T);
+    ok &= check(describeFaces(written) == describeFaces(parsed), "faces of the written model");
+    ok &= check(describeFaces(cached) == describeFaces(parsed), "faces of the cached model");
+    ok &= check(cached.getNbPolygon() == 10, "number of faces");
+
+    // Precomputed structures
+    const vpMbtModelCache &cache = cached.getModelCache();
+    ok &= check(cache.getPrimitives().size() == 6, "number of primitives");
+    ok &= check(cache.getEdges().size() == 10, "number of edges");
+    const vpColVector &normal = cache.getNormals()[0];
+    ok &= check(std::fabs(std::fabs(normal[2]) - 1.) < 1e-9, "normal of the bottom face");
+
+    // A file with indexes out of range is rejected
+    std::string corruptedFile = vpIoTools::createFilePath(directory, "corrupted.bin");
+    vpMbtModelCache reloaded;
+    ok &= check(cache.save(corruptedFile) && reloaded.load(corruptedFile), "cache saved and loaded");
+    vpCorruptedModelCache badPoint(cache);
+    badPoint.setEdgePoint((unsigned int)cache.getPoints().size());
+    ok &= check(badPoint.save(corruptedFile) && !reloaded.load(corruptedFile), "edge point out of range");
+    vpCorruptedModelCache badPrimitive(cache);
+    badPrimitive.setEdgePrimitive((unsigned int)cache.getPrimitives().size());
+    ok &= check(badPrimitive.save(corruptedFile) && !reloaded.load(corruptedFile), "edge primitive out of range");
+
+    // A different transformation or a modified model file invalidates the cache
+    vpMbEdgeTracker untransformed, untransformedParsed;
+    untransformed.setUseModelCache(true);
+    untransformed.loadModel(modelFile);
+    untransformedParsed.loadModel(modelFile);
+    ok &= check(describeFaces(untransformed) == describeFaces(untransformedParsed), "transformation");
+
+    writeModel(modelFile, 0.25);
+    vpMbEdgeTracker modified, modifiedParsed;
+    modified.setUseModelCache(true);
+    modified.loadModel(modelFile);
+    modifiedParsed.loadModel(modelFile);
+    ok &= check(describeFaces(modified) == describeFaces(modifiedParsed), "modified model");
+
+    // Same size, and most likely the same modification time
+    writeModel(modelFile, 0.35);
+    vpMbEdgeTracker rewritten, rewrittenParsed;
+    rewritten.setUseModelCache(true);
+    rewritten.loadModel(modelFile);
+    rewrittenParsed.loadModel(modelFile);
+    ok &= check(describeFaces(rewritten) == describeFaces(rewrittenParsed), "model rewritten with the same size");
+
+    vpIoTools::remove(directory);
+
+    if (!ok) {
+      return EXIT_FAILURE;
+    }
+    std::cout << "testMbtModelCache is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
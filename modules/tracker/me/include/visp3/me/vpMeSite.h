@@ -48,6 +48,7 @@
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/me/vpMe.h>
 
@@ -101,6 +102,9 @@ private:
   vpMeSiteDisplayType selectDisplay;
   vpMeSiteState state;
 
+  void trackImpl(const vpImageView<const unsigned char> &I, const vpImage<unsigned char> *Idisplay, const vpMe *me,
+                 const bool test_contraste);
+
 public:
   void init();
   void init(double ip, double jp, double alphap);
@@ -115,10 +119,12 @@ public:
   void display(const vpImage<unsigned char> &I);
 
   double convolution(const vpImage<unsigned char> &ima, const vpMe *me);
+  double convolution(const vpImageView<const unsigned char> &ima, const vpMe *me);
 
   vpMeSite *getQueryList(const vpImage<unsigned char> &I, const int range);
 
   void track(const vpImage<unsigned char> &im, const vpMe *me, const bool test_contraste = true);
+  void track(const vpImageView<const unsigned char> &im, const vpMe *me, const bool test_contraste = true);
 
   /*!
     Set the angle of tangent at site
@@ -90,9 +90,11 @@ public:
 
   void init();
   void initTracking(const vpImage<unsigned char> &I);
+  void initTracking(const vpImageView<const unsigned char> &I);
 
   //! Track sampled pixels.
   void track(const vpImage<unsigned char> &I);
+  void track(const vpImageView<const unsigned char> &I);
 
   unsigned int numberOfSignal();
   unsigned int totalNumberOfSignal();
@@ -177,6 +179,10 @@ public:
   int query_range;
   bool display_point; // if 1 (TRUE) displays the line that is being tracked
 #endif
+
+private:
+  template <class ImageType> void initTrackingImpl(const ImageType &I);
+  template <class ImageType> void trackImpl(const ImageType &I);
 };
 
 #endif
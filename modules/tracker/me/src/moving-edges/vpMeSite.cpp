@@ -46,10 +46,23 @@
 #include <cmath>  // std::fabs
 #include <limits> // numeric_limits
 #include <stdlib.h>
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/me/vpMe.h>
 #include <visp3/me/vpMeSite.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#define USE_SSE_CODE 1
+#if VISP_HAVE_SSE2 && USE_SSE_CODE
+#define USE_SSE 1
+#else
+#define USE_SSE 0
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static bool horsImage(int i, int j, int half, int rows, int cols)
 {
@@ -61,6 +74,69 @@ static bool horsImage(int i, int j, int half, int rows, int cols)
   // > (cols - half - 3) )) ;
   return ((0 < (half_1 - i)) || ((i - rows + half_3) > 0) || (0 < (half_1 - j)) || ((j - cols + half_3) > 0));
 }
+
+namespace
+{
+// Index of the convolution mask corresponding to the normal direction alpha
+unsigned int getMaskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta = alpha + M_PI / 2;
+  // Move tangent angle to within 0->M_PI for a positive mask index
+  while (theta < 0)
+    theta += M_PI;
+  while (theta > M_PI)
+    theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+
+  if (abs(thetadeg) == 180) {
+    thetadeg = 0;
+  }
+
+  return (unsigned int)(thetadeg / (double)me->getAngleStep());
+}
+
+// Convolution of the msize x msize row-major mask centered on the pixel
+// (i,j), which has to be inside the image. The accumulation order is the
+// one of vpMeSite::convolution() so that both give the same result.
+double convolveCandidate(const vpImageView<const unsigned char> &I, const double *mask, unsigned int msize, double sign,
+                         int i, int j, int half)
+{
+  double conv = 0.0;
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row = I[static_cast<unsigned int>(i - half) + a] + (j - half);
+    const double *mask_row = mask + a * msize;
+    for (unsigned int b = 0; b < msize; b++) {
+      conv += sign * mask_row[b] * row[b];
+    }
+  }
+
+  return conv;
+}
+
+#if USE_SSE
+// Same as convolveCandidate() for two candidates at once, one per SSE2 lane
+void convolveCandidates(const vpImageView<const unsigned char> &I, const double *mask, unsigned int msize, double sign,
+                        const int *i, const int *j, int half, double *conv)
+{
+  __m128d vconv = _mm_setzero_pd();
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row0 = I[static_cast<unsigned int>(i[0] - half) + a] + (j[0] - half);
+    const unsigned char *row1 = I[static_cast<unsigned int>(i[1] - half) + a] + (j[1] - half);
+    const double *mask_row = mask + a * msize;
+    for (unsigned int b = 0; b < msize; b++) {
+      const __m128d vmask = _mm_set1_pd(sign * mask_row[b]);
+      const __m128d vpix = _mm_set_pd(row1[b], row0[b]);
+      vconv = _mm_add_pd(vconv, _mm_mul_pd(vmask, vpix));
+    }
+  }
+
+  _mm_storeu_pd(conv, vconv);
+}
+#endif
+}
 #endif
 
 void vpMeSite::init()
@@ -292,6 +368,15 @@ void vpMeSite::getSign(const vpImage<unsigned char> &I, const int range)
 
 // Specific function for ME
 double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
+{
+  return convolution(vpImageView<const unsigned char>(I), me);
+}
+
+/*!
+  Same as convolution(const vpImage<unsigned char> &, const vpMe *) on a
+  view of the image, the site coordinates being expressed in the view frame.
+*/
+double vpMeSite::convolution(const vpImageView<const unsigned char> &I, const vpMe *me)
 {
   int half;
   int height_ = static_cast<int>(I.getHeight());
@@ -306,23 +391,7 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
     i = 0;
     j = 0;
   } else {
-    // Calculate tangent angle from normal
-    double theta = alpha + M_PI / 2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta < 0)
-      theta += M_PI;
-    while (theta > M_PI)
-      theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI);
-
-    if (abs(thetadeg) == 180) {
-      thetadeg = 0;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg / (double)me->getAngleStep());
+    unsigned int index_mask = getMaskIndex(alpha, me);
 
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
@@ -353,6 +422,27 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
 
 */
 void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool test_contraste)
+{
+  trackImpl(vpImageView<const unsigned char>(I), &I, me, test_contraste);
+}
+
+/*!
+
+  Same as track(const vpImage<unsigned char> &, const vpMe *, const bool) on
+  a view of the image, for instance a region of interest, without copying
+  it. The site coordinates are expressed in the view frame. Nothing is
+  displayed.
+
+*/
+void vpMeSite::track(const vpImageView<const unsigned char> &I, const vpMe *me, const bool test_contraste)
+{
+  trackImpl(I, NULL, me, test_contraste);
+}
+
+// Search along the normal in I. The range and the result are displayed in
+// Idisplay when not NULL.
+void vpMeSite::trackImpl(const vpImageView<const unsigned char> &I, const vpImage<unsigned char> *Idisplay,
+                         const vpMe *me, const bool test_contraste)
 {
   //   vpMeSite  *list_query_pixels ;
   //   int  max_rank =0 ;
@@ -479,29 +569,18 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
   //     }
 
   int max_rank = -1;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
   double max_convolution = 0;
   double max = 0;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range = me->getRange();
-
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
-  //  std::endl ;
-  vpMeSite *list_query_pixels = getQueryList(I, (int)range);
+  const int range = static_cast<int>(me->getRange());
+  const int nb_queries = 2 * range + 1;
 
   double contraste_max = 1 + me->getMu2();
   double contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double *likelihood = new double[2 * range + 1];
-
   int ii_1 = i;
   int jj_1 = j;
   i_1 = i;
@@ -510,37 +589,85 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
   threshold = me->getThreshold();
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for (unsigned int n = 0; n < 2 * range + 1; n++) {
+  // The query sites along the normal are not stored: they are generated on
+  // the fly, two at a time, and only the rank of the best one is kept.
+  const double salpha = sin(alpha);
+  const double calpha = cos(alpha);
+  const int height_ = static_cast<int>(I.getHeight());
+  const int width_ = static_cast<int>(I.getWidth());
+  const unsigned int msize = me->getMaskSize();
+  const int half = (static_cast<int>(msize) - 1) >> 1;
+  const int border = half + me->getStrip();
+  const double *mask = me->getMask()[getMaskIndex(alpha, me)].data;
+  const double sign = mask_sign;
+
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#if !USE_SSE
+  checkSSE2 = false;
+#endif
+
+  int query_i[2], query_j[2];
+  double query_conv[2];
+  vpImagePoint ip;
+
+  for (int n = 0; n < nb_queries; n += 2) {
+    const int nb = (n + 1 < nb_queries) ? 2 : 1;
+    bool inside[2];
+    for (int l = 0; l < nb; l++) {
+      const int k = n + l - range;
+      double ii = (ifloat + k * salpha);
+      double jj = (jfloat + k * calpha);
+
+      // Display
+      if (Idisplay != NULL && ((selectDisplay == RANGE_RESULT) || (selectDisplay == RANGE))) {
+        ip.set_i(ii);
+        ip.set_j(jj);
+        vpDisplay::displayCross(*Idisplay, ip, 1, vpColor::yellow);
+      }
+
+      query_i[l] = (int)ii;
+      query_j[l] = (int)jj;
+      inside[l] = !horsImage(query_i[l], query_j[l], border, height_, width_);
+    }
+
     //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me);
-
-    // luminance ratio of reference pixel to potential correspondent pixel
-    // the luminance must be similar, hence the ratio value should
-    // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-    if (test_contraste) {
-      likelihood[n] = fabs(convolution_ + convlt);
-      if (likelihood[n] > threshold) {
-        contraste = convolution_ / convlt;
-        if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
-          diff = fabs(1 - contraste);
-          max_convolution = convolution_;
-          max = likelihood[n];
-          max_rank = (int)n;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
-        }
+    if (checkSSE2 && nb == 2 && inside[0] && inside[1]) {
+#if USE_SSE
+      convolveCandidates(I, mask, msize, sign, query_i, query_j, half, query_conv);
+#endif
+    } else {
+      for (int l = 0; l < nb; l++) {
+        query_conv[l] = inside[l] ? convolveCandidate(I, mask, msize, sign, query_i[l], query_j[l], half) : 0.0;
       }
     }
 
-    else {
-      likelihood[n] = fabs(2 * convolution_);
-      if (likelihood[n] > max && likelihood[n] > threshold) {
-        max_convolution = convolution_;
-        max = likelihood[n];
-        max_rank = (int)n;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
+    for (int l = 0; l < nb; l++) {
+      double convolution_ = query_conv[l];
+      double likelihood;
+
+      // luminance ratio of reference pixel to potential correspondent pixel
+      // the luminance must be similar, hence the ratio value should
+      // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
+      if (test_contraste) {
+        likelihood = fabs(convolution_ + convlt);
+        if (likelihood > threshold) {
+          contraste = convolution_ / convlt;
+          if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
+            diff = fabs(1 - contraste);
+            max_convolution = convolution_;
+            max = likelihood;
+            max_rank = n + l;
+          }
+        }
+      }
+
+      else {
+        likelihood = fabs(2 * convolution_);
+        if (likelihood > max && likelihood > threshold) {
+          max_convolution = convolution_;
+          max = likelihood;
+          max_rank = n + l;
+        }
       }
     }
   }
@@ -548,31 +675,48 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
-  vpImagePoint ip;
+  // Query site of rank max_rank, or of rank 0 if no site was selected.
+  // Like vpMeSite::convolution(), an out of image site is set to (0,0).
+  const int k = (max_rank >= 0 ? max_rank : 0) - range;
+  double query_ifloat = (ifloat + k * salpha);
+  double query_jfloat = (jfloat + k * calpha);
+  int query_i_ = (int)query_ifloat;
+  int query_j_ = (int)query_jfloat;
+  if (horsImage(query_i_, query_j_, border, height_, width_)) {
+    query_i_ = 0;
+    query_j_ = 0;
+  }
 
   //  if (test_contrast)
   if (max_rank >= 0) {
-    if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[max_rank].i);
-      ip.set_j(list_query_pixels[max_rank].j);
-      vpDisplay::displayPoint(I, ip, vpColor::red);
+    if (Idisplay != NULL && ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT))) {
+      ip.set_i(query_i_);
+      ip.set_j(query_j_);
+      vpDisplay::displayPoint(*Idisplay, ip, vpColor::red);
     }
 
-    *this = list_query_pixels[max_rank]; // The vpMeSite2 is replaced by the
-                                         // vpMeSite2 of max likelihood
+    // The vpMeSite is replaced by the vpMeSite of max likelihood
+    ifloat = query_ifloat;
+    jfloat = query_jfloat;
+    i = query_i_;
+    j = query_j_;
+    v = 0;
+    weight = 1;
+    state = NO_SUPPRESSION;
+#ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
+    suppress = 0;
+#endif
     normGradient = vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
-    i_1 = ii_1; // list_query_pixels[max_rank].i ;
-    j_1 = jj_1; // list_query_pixels[max_rank].j ;
-    delete[] list_query_pixels;
-    delete[] likelihood;
+    i_1 = ii_1;
+    j_1 = jj_1;
   } else // none of the query sites is better than the threshold
   {
-    if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[0].i);
-      ip.set_j(list_query_pixels[0].j);
-      vpDisplay::displayPoint(I, ip, vpColor::green);
+    if (Idisplay != NULL && ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT))) {
+      ip.set_i(query_i_);
+      ip.set_j(query_j_);
+      vpDisplay::displayPoint(*Idisplay, ip, vpColor::green);
     }
     normGradient = 0;
     // if(contraste != 0)
@@ -580,9 +724,6 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete[] list_query_pixels;
-    delete[] likelihood; // modif portage
   }
 }
 
@@ -166,7 +166,15 @@ int vpMeTracker::outOfImage(const vpImagePoint &iP, int half, int rows, int cols
   \exception vpTrackingException::initializationError : Moving edges not
   initialized.
 */
-void vpMeTracker::initTracking(const vpImage<unsigned char> &I)
+void vpMeTracker::initTracking(const vpImage<unsigned char> &I) { initTrackingImpl(I); }
+
+/*!
+  Same as initTracking(const vpImage<unsigned char> &) on a view of the
+  image, the sites being expressed in the view frame.
+*/
+void vpMeTracker::initTracking(const vpImageView<const unsigned char> &I) { initTrackingImpl(I); }
+
+template <class ImageType> void vpMeTracker::initTrackingImpl(const ImageType &I)
 {
   if (!me) {
     vpDERROR_TRACE(2, "Tracking error: Moving edges not initialized");
@@ -247,7 +255,21 @@ void vpMeTracker::initTracking(const vpImage<unsigned char> &I)
   initialized.
 
 */
-void vpMeTracker::track(const vpImage<unsigned char> &I)
+void vpMeTracker::track(const vpImage<unsigned char> &I) { trackImpl(I); }
+
+/*!
+  Track the moving-edges sites in a view of the image, for instance a region
+  of interest, without copying it. The sites and the mask are expressed in
+  the view frame.
+
+  \param I : View on the image.
+
+  \exception vpTrackingException::initializationError : Moving edges not
+  initialized.
+*/
+void vpMeTracker::track(const vpImageView<const unsigned char> &I) { trackImpl(I); }
+
+template <class ImageType> void vpMeTracker::trackImpl(const ImageType &I)
 {
   if (!me) {
     vpDERROR_TRACE(2, "Tracking error: Moving edges not initialized");
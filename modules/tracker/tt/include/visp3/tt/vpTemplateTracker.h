@@ -66,6 +66,8 @@ protected:
   unsigned int nbLvlPyr; // If = 1, disable pyramidal usage
   unsigned int l0Pyr;
   bool pyrInitialised;
+  // Pyramid level of ptTemplate
+  unsigned int currentLvlPyr;
 
   vpTemplateTrackerPoint *ptTemplate;
   vpTemplateTrackerPoint **ptTemplatePyr;
@@ -85,6 +87,10 @@ protected:
 
   vpTemplateTrackerPointCompo *ptTemplateCompo;     // pour ESM
   vpTemplateTrackerPointCompo **ptTemplateCompoPyr; // pour ESM
+  // Mirror of the template points of each pyramid level as contiguous
+  // arrays, for the trackers that process them by batches. ptTemplate stays
+  // the reference copy used by the other trackers and by the common code.
+  std::vector<vpTemplateTrackerPointArray> ptTemplateArrayPyr;
   vpTemplateTrackerZone *zoneTracked;
   vpTemplateTrackerZone *zoneTrackedPyr;
 
@@ -173,10 +179,11 @@ protected:
 public:
   //! Default constructor.
   vpTemplateTracker()
-    : nbLvlPyr(0), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
-      templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
+    : nbLvlPyr(0), l0Pyr(0), pyrInitialised(false), currentLvlPyr(0), ptTemplate(NULL), ptTemplatePyr(NULL),
+      ptTemplateInit(false), templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
       ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
+      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), ptTemplateArrayPyr(), zoneTracked(NULL), zoneTrackedPyr(NULL),
+      pyr_IDes(NULL), H(),
       Hdesire(), HdesirePyr(NULL), HLM(), HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(),
       HLMdesireInversePyr(NULL), G(), gain(0), thresholdGradient(0), costFunctionVerification(false), blur(false),
       useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(0), mod_j(0),
@@ -288,10 +295,12 @@ protected:
   void computeOptimalBrentGain(const vpImage<unsigned char> &I, vpColVector &tp, double tMI, vpColVector &direction,
                                double &alpha);
   virtual double getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
+  vpTemplateTrackerPointArray &getTemplateArray(unsigned int level);
   void getGaussianBluredImage(const vpImage<unsigned char> &I) { vpImageFilter::filter(I, BI, fgG, taillef); }
   virtual void initHessienDesired(const vpImage<unsigned char> &I) = 0;
   virtual void initHessienDesiredPyr(const vpImage<unsigned char> &I);
   virtual void initPyramidal(unsigned int nbLvl, unsigned int l0);
+  void initTemplateArray(unsigned int level, const bool *select = NULL);
   void initTracking(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void initTrackingPyr(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void trackNoPyr(const vpImage<unsigned char> &I) = 0;
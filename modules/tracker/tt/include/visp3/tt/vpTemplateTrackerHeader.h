@@ -46,6 +46,7 @@
 #define vpTemplateTrackerHeader_hh
 
 #include <stdio.h>
+#include <vector>
 
 /*!
   \struct vpTemplateTrackerZPoint
@@ -87,6 +88,30 @@ struct vpTemplateTrackerPointCompo {
   vpTemplateTrackerPointCompo() : dW(NULL) {}
 };
 
+/*!
+  \struct vpTemplateTrackerPointArray
+  \ingroup group_tt_tools
+
+  Template points stored as contiguous arrays, one per field, so that they
+  can be warped and sampled by batches.
+*/
+struct vpTemplateTrackerPointArray {
+  //! Coordinates along the columns.
+  std::vector<double> x;
+  //! Coordinates along the rows.
+  std::vector<double> y;
+  //! Intensities of the template.
+  std::vector<double> val;
+  //! Derivatives of the intensities, nbParam values per point.
+  std::vector<double> dW;
+  //! Derivatives multiplied by the opposite of the inverse Hessian, nbParam
+  //! values per point.
+  std::vector<double> HiG;
+
+  //! Number of points.
+  unsigned int size() const { return (unsigned int)x.size(); }
+};
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 struct vpTemplateTrackerPointSuppMIInv {
   double et;
@@ -193,7 +193,8 @@ public:
   }
 
   /*!
-    Warp a list of points.
+    Warp a list of points. The affine and homography warps process several
+    points at once with SSE2 instructions when available.
 
     \param ut0 : List of u coordinates of the points.
     \param vt0 : List of v coordinates of the points.
@@ -202,7 +203,41 @@ public:
     \param u : Resulting u coordinates.
     \param v : resulting v coordinates.
   */
-  void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
+  virtual void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
+
+  /*!
+    Get the bilinear interpolations of the intensities of an image at a list
+    of points, as vpImage::getValue() would do. The points are inside the
+    image when \f$0 \le u < width-1\f$ and \f$0 \le v < height-1\f$.
+
+    \param I : Image to interpolate.
+    \param u : List of u coordinates (along the columns) of the points.
+    \param v : List of v coordinates (along the rows) of the points.
+    \param nb_pt : Number of points to consider.
+    \param val : Resulting intensities, rounded to integers, or 0 for the
+    points outside of the image.
+    \param inside : Flags set to true for the points inside the image.
+
+    \return The number of points inside the image.
+  */
+  static unsigned int interpolate(const vpImage<unsigned char> &I, const double *u, const double *v, int nb_pt,
+                                  double *val, bool *inside);
+
+  /*!
+    Get the bilinear interpolations of an image of double at a list of
+    points, as vpImage<double>::getValue() would do.
+
+    \param I : Image to interpolate.
+    \param u : List of u coordinates (along the columns) of the points.
+    \param v : List of v coordinates (along the rows) of the points.
+    \param nb_pt : Number of points to consider.
+    \param val : Resulting values, or 0 for the points outside of the image.
+    \param inside : Flags set to true for the points inside the image.
+
+    \return The number of points inside the image.
+  */
+  static unsigned int interpolate(const vpImage<double> &I, const double *u, const double *v, int nb_pt, double *val,
+                                  bool *inside);
 
   /*!
     Warp a point.
@@ -96,6 +96,7 @@ double vpTemplateTrackerSSD::getSSD(const vpImage<unsigned char> &I, const vpCol
   unsigned int Nbpoint = 0;
 
   if (pyrInitialised) {
+    currentLvlPyr = 0;
     templateSize = templateSizePyr[0];
     ptTemplate = ptTemplatePyr[0];
   }
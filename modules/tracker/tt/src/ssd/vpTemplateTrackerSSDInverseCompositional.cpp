@@ -37,9 +37,105 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
+
 #include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of template points processed by a task of the thread pool
+const unsigned int CHUNK_SIZE = 1024;
+
+// Sample the image at the warped template points, and accumulate the error
+// and the update of the parameters of each chunk of points. The sums of the
+// chunks are reduced in order afterwards, so that the result does not depend
+// on the number of threads
+template <class Type> class vpSSDInverseCompositionalBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpSSDInverseCompositionalBody(const vpImage<Type> &I, const vpTemplateTrackerPointArray &pts, const double *u,
+                                const double *v, unsigned int nbParam, double *sums, unsigned int *nbPoints)
+    : m_I(I), m_pts(pts), m_u(u), m_v(v), m_nbParam(nbParam), m_sums(sums), m_nbPoints(nbPoints)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    double val[CHUNK_SIZE];
+    bool inside[CHUNK_SIZE];
+    for (unsigned int chunk = begin; chunk < end; chunk++) {
+      const unsigned int first = chunk * CHUNK_SIZE;
+      const unsigned int nb = (std::min)(CHUNK_SIZE, m_pts.size() - first);
+      vpTemplateTrackerWarp::interpolate(m_I, m_u + first, m_v + first, (int)nb, val, inside);
+
+      // Error of the points, 0 outside of the image
+      double erreur = 0;
+      unsigned int nbPoint = 0;
+      for (unsigned int k = 0; k < nb; k++) {
+        if (inside[k]) {
+          val[k] = m_pts.val[first + k] - val[k];
+          erreur += val[k] * val[k];
+          nbPoint++;
+        } else {
+          val[k] = 0;
+        }
+      }
+
+      double *dp = m_sums + chunk * (m_nbParam + 1);
+      const double *HiG = &m_pts.HiG[first * m_nbParam];
+      switch (m_nbParam) {
+      case 6:
+        accumulate<6>(val, HiG, nb, dp);
+        break;
+      case 8:
+        accumulate<8>(val, HiG, nb, dp);
+        break;
+      default:
+        accumulate(val, HiG, nb, m_nbParam, dp);
+      }
+      dp[m_nbParam] = erreur;
+      m_nbPoints[chunk] = nbPoint;
+    }
+  }
+
+private:
+  // dp = sum of er * HiG, with a number of parameters known at compile time
+  // for the affine and homography warps
+  template <unsigned int N> static void accumulate(const double *er, const double *HiG, unsigned int nb, double *dp)
+  {
+    double sum[N];
+    for (unsigned int it = 0; it < N; it++)
+      sum[it] = 0;
+    for (unsigned int k = 0; k < nb; k++, HiG += N)
+      for (unsigned int it = 0; it < N; it++)
+        sum[it] += er[k] * HiG[it];
+    for (unsigned int it = 0; it < N; it++)
+      dp[it] = sum[it];
+  }
+
+  static void accumulate(const double *er, const double *HiG, unsigned int nb, unsigned int nbParam, double *dp)
+  {
+    for (unsigned int it = 0; it < nbParam; it++)
+      dp[it] = 0;
+    for (unsigned int k = 0; k < nb; k++, HiG += nbParam)
+      for (unsigned int it = 0; it < nbParam; it++)
+        dp[it] += er[k] * HiG[it];
+  }
+
+  const vpImage<Type> &m_I;
+  const vpTemplateTrackerPointArray &m_pts;
+  const double *m_u;
+  const double *m_v;
+  unsigned int m_nbParam;
+  double *m_sums;
+  unsigned int *m_nbPoints;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerSSDInverseCompositional::vpTemplateTrackerSSDInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerSSD(warp), compoInitialised(false), HInv(), HCompInverse(), useTemplateSelect(false), evolRMS(0),
     x_pos(), y_pos(), threshold_RMS(1e-8)
@@ -95,6 +191,7 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
         ptTemplate[point].HiG[it] = HiGtemp[it];
     }
   }
+  initTemplateArray(currentLvlPyr, useTemplateSelect ? ptTemplateSelect : NULL);
   compoInitialised = true;
 }
 
@@ -109,48 +206,40 @@ void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned
     vpImageFilter::filter(I, BI, fgG, taillef);
 
   vpColVector dpinv(nbParam);
-  double IW;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
-  // vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
 
-  vpTemplateTrackerPoint *pt;
+  // The template points, selected or not when initialized, are warped by
+  // batches, then sampled and accumulated in parallel
+  const vpTemplateTrackerPointArray &pts = getTemplateArray(currentLvlPyr);
+  const unsigned int nbPts = pts.size();
+  const unsigned int nbChunks = (nbPts + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<double> u(nbPts), v(nbPts);
+  std::vector<double> sums(nbChunks * (nbParam + 1));
+  std::vector<unsigned int> nbPoints(nbChunks);
+
   do {
     unsigned int Nbpoint = 0;
     double erreur = 0;
     dp = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
-        // pt=&ptTemplatetest[point];
-        pt = &ptTemplate[point];
-        i = pt->y;
-        j = pt->x;
-        X1[0] = j;
-        X1[1] = i;
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-        j2 = X2[0];
-        i2 = X2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Tij = pt->val;
-          if (!blur)
-            IW = I.getValue(i2, j2);
-          else
-            IW = BI.getValue(i2, j2);
-          Nbpoint++;
-          double er = (Tij - IW);
-          for (unsigned int it = 0; it < nbParam; it++)
-            dp[it] += er * pt->HiG[it];
-
-          erreur += er * er;
-        }
-      }
+    if (nbPts > 0) {
+      Warp->warp(&pts.x[0], &pts.y[0], (int)nbPts, p, &u[0], &v[0]);
+      if (!blur)
+        vpThreadPool::getInstance().parallelFor(0, nbChunks,
+                                                vpSSDInverseCompositionalBody<unsigned char>(
+                                                    I, pts, &u[0], &v[0], nbParam, &sums[0], &nbPoints[0]));
+      else
+        vpThreadPool::getInstance().parallelFor(
+            0, nbChunks,
+            vpSSDInverseCompositionalBody<double>(BI, pts, &u[0], &v[0], nbParam, &sums[0], &nbPoints[0]));
+    }
+    for (unsigned int chunk = 0; chunk < nbChunks; chunk++) {
+      const double *dpChunk = &sums[chunk * (nbParam + 1)];
+      for (unsigned int it = 0; it < nbParam; it++)
+        dp[it] += dpChunk[it];
+      erreur += dpChunk[nbParam];
+      Nbpoint += nbPoints[chunk];
     }
     // std::cout << "npoint: " << Nbpoint << std::endl;
     if (Nbpoint == 0) {
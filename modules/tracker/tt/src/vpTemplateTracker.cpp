@@ -42,11 +42,12 @@
 #include <visp3/tt/vpTemplateTrackerBSpline.h>
 
 vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
-  : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
-    templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
+  : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), currentLvlPyr(0), ptTemplate(NULL), ptTemplatePyr(NULL),
+    ptTemplateInit(false), templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
     ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
-    Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(), HLMdesireInversePyr(), G(),
+    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), ptTemplateArrayPyr(), zoneTracked(NULL), zoneTrackedPyr(NULL),
+    pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(),
+    HLMdesireInversePyr(), G(),
     gain(1.), thresholdGradient(40), costFunctionVerification(false), blur(true), useBrent(false), nbIterBrent(3),
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0), lambdaDep(0.001),
     iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(true), useInverse(false),
@@ -180,6 +181,8 @@ void vpTemplateTracker::resetTracker()
 {
   // reset the tracker parameters
   p = 0;
+  currentLvlPyr = 0;
+  ptTemplateArrayPyr.clear();
 
   // 	vpTRACE("resetTracking");
   if (pyrInitialised) {
@@ -304,6 +307,54 @@ void vpTemplateTracker::resetTracker()
   }
 }
 
+/*!
+  Return the template points of a pyramid level as contiguous arrays, built
+  by initTemplateArray(). They mirror ptTemplate and are not updated when
+  ptTemplate changes.
+
+  \param level : Pyramid level, currentLvlPyr for the level of ptTemplate.
+*/
+vpTemplateTrackerPointArray &vpTemplateTracker::getTemplateArray(unsigned int level)
+{
+  if (ptTemplateArrayPyr.size() <= level) {
+    ptTemplateArrayPyr.resize(level + 1);
+  }
+  return ptTemplateArrayPyr[level];
+}
+
+/*!
+  Copy the template points ptTemplate in contiguous arrays, with their
+  derivatives dW and HiG when they are computed.
+
+  \param level : Pyramid level of ptTemplate, usually currentLvlPyr.
+  \param select : If not NULL, only the points whose flag is true are copied.
+*/
+void vpTemplateTracker::initTemplateArray(unsigned int level, const bool *select)
+{
+  vpTemplateTrackerPointArray &pts = getTemplateArray(level);
+  pts.x.clear();
+  pts.y.clear();
+  pts.val.clear();
+  pts.dW.clear();
+  pts.HiG.clear();
+
+  for (unsigned int point = 0; point < templateSize; point++) {
+    if (select != NULL && !select[point]) {
+      continue;
+    }
+    const vpTemplateTrackerPoint &pt = ptTemplate[point];
+    pts.x.push_back(pt.x);
+    pts.y.push_back(pt.y);
+    pts.val.push_back(pt.val);
+    if (pt.dW != NULL) {
+      pts.dW.insert(pts.dW.end(), pt.dW, pt.dW + nbParam);
+    }
+    if (pt.HiG != NULL) {
+      pts.HiG.insert(pts.HiG.end(), pt.HiG, pt.HiG + nbParam);
+    }
+  }
+}
+
 /*!
   Display the warped reference template in an image.
 
@@ -617,6 +668,7 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char> &I, vpTempl
   // vpTRACE("fin copy zone");
 
   pyr_IDes[0] = I;
+  currentLvlPyr = 0;
   initTracking(pyr_IDes[0], zoneTrackedPyr[0]);
   ptTemplatePyr[0] = ptTemplate;
   ptTemplateSelectPyr[0] = ptTemplateSelect;
@@ -628,6 +680,7 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char> &I, vpTempl
       zoneTrackedPyr[i] = zoneTrackedPyr[i - 1].getPyramidDown();
       vpImageFilter::getGaussPyramidal(pyr_IDes[i - 1], pyr_IDes[i]);
 
+      currentLvlPyr = i;
       initTracking(pyr_IDes[i], zoneTrackedPyr[i]);
       ptTemplatePyr[i] = ptTemplate;
       ptTemplateSelectPyr[i] = ptTemplateSelect;
@@ -734,6 +787,7 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
 {
   // 	vpTRACE("initHessienDesiredPyr");
 
+  currentLvlPyr = 0;
   templateSize = templateSizePyr[0];
   // ptTemplateSupp=ptTemplateSuppPyr[0];
   // ptTemplateCompo=ptTemplateCompoPyr[0];
@@ -762,6 +816,7 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
     for (unsigned int i = 1; i < nbLvlPyr; i++) {
       vpImageFilter::getGaussPyramidal(Itemp, Itemp);
 
+      currentLvlPyr = i;
       templateSize = templateSizePyr[i];
       ptTemplate = ptTemplatePyr[i];
       ptTemplateSelect = ptTemplateSelectPyr[i];
@@ -842,6 +897,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 
       for (int i = (int)nbLvlPyr - 1; i >= 0; i--) {
         if (i >= (int)l0Pyr) {
+          currentLvlPyr = (unsigned int)i;
           templateSize = templateSizePyr[i];
           ptTemplate = ptTemplatePyr[i];
           ptTemplateSelect = ptTemplateSelectPyr[i];
@@ -37,8 +37,115 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpMath.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Conversion of an interpolated value to the pixel type, as done by
+// vpImage::getValue()
+inline double pixelValue(double value, const unsigned char *) { return vpMath::round(value); }
+inline double pixelValue(double value, const double *) { return value; }
+
+#if VISP_HAVE_SSE2
+// Same as pixelValue() for two positive values. Halves are rounded away from
+// zero like vpMath::round()
+inline __m128d pixelValue(const __m128d &value, const unsigned char *)
+{
+  const __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(value));
+  return _mm_add_pd(t, _mm_and_pd(_mm_cmpge_pd(_mm_sub_pd(value, t), _mm_set1_pd(0.5)), _mm_set1_pd(1.)));
+}
+inline __m128d pixelValue(const __m128d &value, const double *) { return value; }
+#endif
+
+template <class Type>
+unsigned int interpolateImage(const vpImage<Type> &I, const double *u, const double *v, int nb_pt, double *val,
+                              bool *inside)
+{
+  const double umax = I.getWidth() - 1.;
+  const double vmax = I.getHeight() - 1.;
+  unsigned int nb_inside = 0;
+  int k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.);
+    const __m128d umax_ = _mm_set1_pd(umax);
+    const __m128d vmax_ = _mm_set1_pd(vmax);
+    for (; k + 2 <= nb_pt; k += 2) {
+      __m128d uu = _mm_loadu_pd(u + k);
+      __m128d vv = _mm_loadu_pd(v + k);
+      const __m128d in = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(vv, zero), _mm_cmpge_pd(uu, zero)),
+                                    _mm_and_pd(_mm_cmplt_pd(vv, vmax_), _mm_cmplt_pd(uu, umax_)));
+      const int mask = _mm_movemask_pd(in);
+      if (mask == 0) {
+        val[k] = val[k + 1] = 0;
+        inside[k] = inside[k + 1] = false;
+        continue;
+      }
+
+      // The coordinates of the points outside of the image are replaced by 0
+      // to read valid pixels
+      uu = _mm_and_pd(uu, in);
+      vv = _mm_and_pd(vv, in);
+      const __m128i ii = _mm_cvttpd_epi32(vv);
+      const __m128i jj = _mm_cvttpd_epi32(uu);
+      const __m128d rratio = _mm_sub_pd(vv, _mm_cvtepi32_pd(ii));
+      const __m128d cratio = _mm_sub_pd(uu, _mm_cvtepi32_pd(jj));
+      const __m128d rfrac = _mm_sub_pd(one, rratio);
+      const __m128d cfrac = _mm_sub_pd(one, cratio);
+
+      const int i0 = _mm_cvtsi128_si32(ii), i1 = _mm_cvtsi128_si32(_mm_srli_si128(ii, 4));
+      const int j0 = _mm_cvtsi128_si32(jj), j1 = _mm_cvtsi128_si32(_mm_srli_si128(jj, 4));
+      const Type *r0 = I[i0] + j0, *r0n = I[i0 + 1] + j0;
+      const Type *r1 = I[i1] + j1, *r1n = I[i1 + 1] + j1;
+      const __m128d I00 = _mm_set_pd((double)r1[0], (double)r0[0]);
+      const __m128d I10 = _mm_set_pd((double)r1n[0], (double)r0n[0]);
+      const __m128d I01 = _mm_set_pd((double)r1[1], (double)r0[1]);
+      const __m128d I11 = _mm_set_pd((double)r1n[1], (double)r0n[1]);
+
+      // Same operations as vpImage::getValue()
+      const __m128d value =
+          _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(I00, rfrac), _mm_mul_pd(I10, rratio)), cfrac),
+                     _mm_mul_pd(_mm_add_pd(_mm_mul_pd(I01, rfrac), _mm_mul_pd(I11, rratio)), cratio));
+      _mm_storeu_pd(val + k, _mm_and_pd(pixelValue(value, (const Type *)NULL), in));
+      inside[k] = (mask & 1) != 0;
+      inside[k + 1] = (mask & 2) != 0;
+      nb_inside += (mask & 1) + (mask >> 1);
+    }
+  }
+#endif
+
+  for (; k < nb_pt; k++) {
+    const double i = v[k], j = u[k];
+    inside[k] = (i >= 0) && (j >= 0) && (i < vmax) && (j < umax);
+    if (!inside[k]) {
+      val[k] = 0;
+      continue;
+    }
+    const unsigned int iround = (unsigned int)i, jround = (unsigned int)j;
+    const double rratio = i - iround, cratio = j - jround;
+    const double rfrac = 1. - rratio, cfrac = 1. - cratio;
+    const Type *r = I[iround] + jround, *rn = I[iround + 1] + jround;
+    val[k] = pixelValue(((double)r[0] * rfrac + (double)rn[0] * rratio) * cfrac +
+                            ((double)r[1] * rfrac + (double)rn[1] * rratio) * cratio,
+                        (const Type *)NULL);
+    nb_inside++;
+  }
+
+  return nb_inside;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpTemplateTrackerWarp::warpTriangle(const vpTemplateTrackerTriangle &in, const vpColVector &p,
                                          vpTemplateTrackerTriangle &out)
 {
@@ -159,3 +266,15 @@ void vpTemplateTrackerWarp::findWarp(const double *ut0, const double *vt0, const
   // std::cout<<"erreur apres transformation="<<erreur<<std::endl;
 }
 #endif // #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+unsigned int vpTemplateTrackerWarp::interpolate(const vpImage<unsigned char> &I, const double *u, const double *v,
+                                                int nb_pt, double *val, bool *inside)
+{
+  return interpolateImage(I, u, v, nb_pt, val, inside);
+}
+
+unsigned int vpTemplateTrackerWarp::interpolate(const vpImage<double> &I, const double *u, const double *v, int nb_pt,
+                                                double *val, bool *inside)
+{
+  return interpolateImage(I, u, v, nb_pt, val, inside);
+}
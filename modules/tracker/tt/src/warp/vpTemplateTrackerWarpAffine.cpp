@@ -37,8 +37,14 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/tt/vpTemplateTrackerWarpAffine.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 vpTemplateTrackerWarpAffine::vpTemplateTrackerWarpAffine()
 {
   nbParam = 6;
@@ -101,6 +107,32 @@ void vpTemplateTrackerWarpAffine::warpX(const vpColVector &vX, vpColVector &vXre
   vXres[1] = ParamM[1] * vX[0] + (1.0 + ParamM[3]) * vX[1] + ParamM[5];
 }
 
+void vpTemplateTrackerWarpAffine::warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p,
+                                       double *u, double *v)
+{
+  const double a00 = 1.0 + p[0], a01 = p[2], a02 = p[4];
+  const double a10 = p[1], a11 = 1.0 + p[3], a12 = p[5];
+  int k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128d a00_ = _mm_set1_pd(a00), a01_ = _mm_set1_pd(a01), a02_ = _mm_set1_pd(a02);
+    const __m128d a10_ = _mm_set1_pd(a10), a11_ = _mm_set1_pd(a11), a12_ = _mm_set1_pd(a12);
+    for (; k + 2 <= nb_pt; k += 2) {
+      const __m128d x = _mm_loadu_pd(ut0 + k);
+      const __m128d y = _mm_loadu_pd(vt0 + k);
+      _mm_storeu_pd(u + k, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a00_, x), _mm_mul_pd(a01_, y)), a02_));
+      _mm_storeu_pd(v + k, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a10_, x), _mm_mul_pd(a11_, y)), a12_));
+    }
+  }
+#endif
+
+  for (; k < nb_pt; k++) {
+    u[k] = a00 * ut0[k] + a01 * vt0[k] + a02;
+    v[k] = a10 * ut0[k] + a11 * vt0[k] + a12;
+  }
+}
+
 void vpTemplateTrackerWarpAffine::dWarp(const vpColVector &X1, const vpColVector & /*X2*/,
                                         const vpColVector & /*ParamM*/, vpMatrix &dW_)
 {
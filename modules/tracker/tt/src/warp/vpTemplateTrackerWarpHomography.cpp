@@ -37,9 +37,15 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/tt/vpTemplateTrackerWarpHomography.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 vpTemplateTrackerWarpHomography::vpTemplateTrackerWarpHomography()
 {
   nbParam = 8;
@@ -123,6 +129,48 @@ void vpTemplateTrackerWarpHomography::warpX(const vpColVector &vX, vpColVector &
                               "Division by zero in vpTemplateTrackerWarpHomography::warpX()"));
 }
 
+void vpTemplateTrackerWarpHomography::warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p,
+                                           double *u, double *v)
+{
+  const double a00 = 1. + p[0], a01 = p[3], a02 = p[6];
+  const double a10 = p[1], a11 = 1. + p[4], a12 = p[7];
+  const double a20 = p[2], a21 = p[5];
+  bool valid = true;
+  int k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128d a00_ = _mm_set1_pd(a00), a01_ = _mm_set1_pd(a01), a02_ = _mm_set1_pd(a02);
+    const __m128d a10_ = _mm_set1_pd(a10), a11_ = _mm_set1_pd(a11), a12_ = _mm_set1_pd(a12);
+    const __m128d a20_ = _mm_set1_pd(a20), a21_ = _mm_set1_pd(a21);
+    const __m128d one = _mm_set1_pd(1.), zero = _mm_setzero_pd();
+    __m128d invalid = _mm_setzero_pd();
+    for (; k + 2 <= nb_pt; k += 2) {
+      const __m128d x = _mm_loadu_pd(ut0 + k);
+      const __m128d y = _mm_loadu_pd(vt0 + k);
+      const __m128d d = _mm_div_pd(one, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a20_, x), _mm_mul_pd(a21_, y)), one));
+      invalid = _mm_or_pd(invalid, _mm_cmpngt_pd(d, zero));
+      _mm_storeu_pd(u + k, _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(a00_, x), _mm_mul_pd(a01_, y)), a02_), d));
+      _mm_storeu_pd(v + k, _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(a10_, x), _mm_mul_pd(a11_, y)), a12_), d));
+    }
+    valid = (_mm_movemask_pd(invalid) == 0);
+  }
+#endif
+
+  for (; k < nb_pt; k++) {
+    const double d = 1. / (a20 * ut0[k] + a21 * vt0[k] + 1.);
+    valid = valid && (d > 0);
+    u[k] = (a00 * ut0[k] + a01 * vt0[k] + a02) * d;
+    v[k] = (a10 * ut0[k] + a11 * vt0[k] + a12) * d;
+  }
+
+  // Same check as warpX()
+  if (!valid) {
+    throw(vpTrackingException(vpTrackingException::fatalError,
+                              "Division by zero in vpTemplateTrackerWarpHomography::warp()"));
+  }
+}
+
 void vpTemplateTrackerWarpHomography::dWarp(const vpColVector &X1, const vpColVector &X2,
                                             const vpColVector & /*ParamM*/, vpMatrix &dW_)
 {
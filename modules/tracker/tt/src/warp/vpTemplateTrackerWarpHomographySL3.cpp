@@ -37,8 +37,14 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 // findWarp special a SL3 car methode additionnelle ne marche pas (la derivee
 // n est calculable qu en p=0)
 // => resout le probleme de maniere compositionnelle
@@ -264,6 +270,37 @@ void vpTemplateTrackerWarpHomographySL3::warpX(const int &i, const int &j, doubl
   i2 = (j * G[1][0] + i * G[1][1] + G[1][2]) / denom;
 }
 
+void vpTemplateTrackerWarpHomographySL3::warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p,
+                                              double *u, double *v)
+{
+  computeCoeff(p);
+  const double g00 = G[0][0], g01 = G[0][1], g02 = G[0][2];
+  const double g10 = G[1][0], g11 = G[1][1], g12 = G[1][2];
+  const double g20 = G[2][0], g21 = G[2][1], g22 = G[2][2];
+  int k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128d g00_ = _mm_set1_pd(g00), g01_ = _mm_set1_pd(g01), g02_ = _mm_set1_pd(g02);
+    const __m128d g10_ = _mm_set1_pd(g10), g11_ = _mm_set1_pd(g11), g12_ = _mm_set1_pd(g12);
+    const __m128d g20_ = _mm_set1_pd(g20), g21_ = _mm_set1_pd(g21), g22_ = _mm_set1_pd(g22);
+    for (; k + 2 <= nb_pt; k += 2) {
+      const __m128d x = _mm_loadu_pd(ut0 + k);
+      const __m128d y = _mm_loadu_pd(vt0 + k);
+      const __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, g20_), _mm_mul_pd(y, g21_)), g22_);
+      _mm_storeu_pd(u + k, _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, g00_), _mm_mul_pd(y, g01_)), g02_), d));
+      _mm_storeu_pd(v + k, _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, g10_), _mm_mul_pd(y, g11_)), g12_), d));
+    }
+  }
+#endif
+
+  for (; k < nb_pt; k++) {
+    const double d = ut0[k] * g20 + vt0[k] * g21 + g22;
+    u[k] = (ut0[k] * g00 + vt0[k] * g01 + g02) / d;
+    v[k] = (ut0[k] * g10 + vt0[k] * g11 + g12) / d;
+  }
+}
+
 vpHomography vpTemplateTrackerWarpHomographySL3::getHomography() const
 {
   vpHomography H;
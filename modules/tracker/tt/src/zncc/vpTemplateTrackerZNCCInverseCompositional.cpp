@@ -37,11 +37,123 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
 #include <limits> // numeric_limits
 
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of template points processed by a task of the thread pool
+const unsigned int CHUNK_SIZE = 1024;
+
+// Sample the image at the warped template points, and accumulate the sums of
+// the intensities of each chunk of points
+template <class Type> class vpZNCCMeanBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpZNCCMeanBody(const vpImage<Type> &I, const vpTemplateTrackerPointArray &pts, const double *u, const double *v,
+                 double *Ic, unsigned char *inside, double *sums, unsigned int *nbPoints)
+    : m_I(I), m_pts(pts), m_u(u), m_v(v), m_Ic(Ic), m_inside(inside), m_sums(sums), m_nbPoints(nbPoints)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    bool inside[CHUNK_SIZE];
+    for (unsigned int chunk = begin; chunk < end; chunk++) {
+      const unsigned int first = chunk * CHUNK_SIZE;
+      const unsigned int nb = (std::min)(CHUNK_SIZE, m_pts.size() - first);
+      vpTemplateTrackerWarp::interpolate(m_I, m_u + first, m_v + first, (int)nb, m_Ic + first, inside);
+
+      double moyIref = 0, moyIc = 0;
+      unsigned int nbPoint = 0;
+      for (unsigned int k = 0; k < nb; k++) {
+        m_inside[first + k] = inside[k];
+        if (inside[k]) {
+          moyIref += m_pts.val[first + k];
+          moyIc += m_Ic[first + k];
+          nbPoint++;
+        }
+      }
+      m_sums[2 * chunk] = moyIref;
+      m_sums[2 * chunk + 1] = moyIc;
+      m_nbPoints[chunk] = nbPoint;
+    }
+  }
+
+private:
+  const vpImage<Type> &m_I;
+  const vpTemplateTrackerPointArray &m_pts;
+  const double *m_u;
+  const double *m_v;
+  double *m_Ic;
+  unsigned char *m_inside;
+  double *m_sums;
+  unsigned int *m_nbPoints;
+};
+
+// Accumulate the covariances and their derivatives of each chunk of points:
+// sIcdIref and sIrefdIref (nbParam values each), covarIref, covarIc and
+// sIcIref
+class vpZNCCCovarianceBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpZNCCCovarianceBody(const vpTemplateTrackerPointArray &pts, const double *Ic, const unsigned char *inside,
+                       double moyIref, double moyIc, const vpColVector &moydIrefdp, double *sums)
+    : m_pts(pts), m_Ic(Ic), m_inside(inside), m_moyIref(moyIref), m_moyIc(moyIc), m_moydIrefdp(moydIrefdp),
+      m_sums(sums)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int nbParam = m_moydIrefdp.getRows();
+    for (unsigned int chunk = begin; chunk < end; chunk++) {
+      const unsigned int first = chunk * CHUNK_SIZE;
+      const unsigned int last = (std::min)(first + CHUNK_SIZE, m_pts.size());
+
+      double *sIcdIref = m_sums + chunk * (2 * nbParam + 3);
+      double *sIrefdIref = sIcdIref + nbParam;
+      double covarIref = 0, covarIc = 0, sIcIref = 0;
+      for (unsigned int it = 0; it < 2 * nbParam; it++)
+        sIcdIref[it] = 0;
+      for (unsigned int point = first; point < last; point++) {
+        if (m_inside[point]) {
+          const double *dW = &m_pts.dW[point * nbParam];
+          const double prod = (m_Ic[point] - m_moyIc);
+          const double prodIref = (m_pts.val[point] - m_moyIref);
+          for (unsigned int it = 0; it < nbParam; it++)
+            sIcdIref[it] += prod * (dW[it] - m_moydIrefdp[it]);
+          for (unsigned int it = 0; it < nbParam; it++)
+            sIrefdIref[it] += prodIref * (dW[it] - m_moydIrefdp[it]);
+
+          covarIref += prodIref * prodIref;
+          covarIc += prod * prod;
+          sIcIref += prodIref * prod;
+        }
+      }
+      sIrefdIref[nbParam] = covarIref;
+      sIrefdIref[nbParam + 1] = covarIc;
+      sIrefdIref[nbParam + 2] = sIcIref;
+    }
+  }
+
+private:
+  const vpTemplateTrackerPointArray &m_pts;
+  const double *m_Ic;
+  const unsigned char *m_inside;
+  double m_moyIref;
+  double m_moyIc;
+  const vpColVector &m_moydIrefdp;
+  double *m_sums;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerZNCCInverseCompositional::vpTemplateTrackerZNCCInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerZNCC(warp), compoInitialised(false), evolRMS(0), x_pos(), y_pos(), threshold_RMS(1e-8),
     moydIrefdp()
@@ -71,6 +183,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
 
     Warp->getdW0(i, j, dy, dx, ptTemplate[point].dW);
   }
+  initTemplateArray(currentLvlPyr);
   // vpTRACE("fin Comp Inverse");
   compoInitialised = true;
 }
@@ -250,42 +363,40 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
 
   // double erreur=0;
   vpColVector dpinv(nbParam);
-  double Ic;
-  double Iref;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   initPosEvalRMS(p);
+
+  // The template points are warped and sampled once per iteration, by
+  // batches, and the sums are accumulated in parallel
+  const vpTemplateTrackerPointArray &pts = getTemplateArray(currentLvlPyr);
+  const unsigned int nbPts = pts.size();
+  const unsigned int nbChunks = (nbPts + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<double> u(nbPts), v(nbPts), Ic(nbPts);
+  std::vector<unsigned char> inside(nbPts);
+  std::vector<double> sums(nbChunks * (2 * nbParam + 3));
+  std::vector<unsigned int> nbPoints(nbChunks);
+
   do {
     unsigned int Nbpoint = 0;
     // erreur=0;
     G = 0;
-    Warp->computeCoeff(p);
     double moyIref = 0;
     double moyIc = 0;
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Iref = ptTemplate[point].val;
-
-        if (!blur)
-          Ic = I.getValue(i2, j2);
-        else
-          Ic = BI.getValue(i2, j2);
-
-        Nbpoint++;
-        moyIref += Iref;
-        moyIc += Ic;
-      }
+    if (nbPts > 0) {
+      Warp->warp(&pts.x[0], &pts.y[0], (int)nbPts, p, &u[0], &v[0]);
+      if (!blur)
+        vpThreadPool::getInstance().parallelFor(0, nbChunks,
+                                                vpZNCCMeanBody<unsigned char>(I, pts, &u[0], &v[0], &Ic[0],
+                                                                              &inside[0], &sums[0], &nbPoints[0]));
+      else
+        vpThreadPool::getInstance().parallelFor(
+            0, nbChunks,
+            vpZNCCMeanBody<double>(BI, pts, &u[0], &v[0], &Ic[0], &inside[0], &sums[0], &nbPoints[0]));
+    }
+    for (unsigned int chunk = 0; chunk < nbChunks; chunk++) {
+      moyIref += sums[2 * chunk];
+      moyIc += sums[2 * chunk + 1];
+      Nbpoint += nbPoints[chunk];
     }
     if (Nbpoint > 0) {
       moyIref = moyIref / Nbpoint;
@@ -297,38 +408,17 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
       vpColVector sIrefdIref(nbParam);
       sIrefdIref = 0;
 
-      for (unsigned int point = 0; point < templateSize; point++) {
-        i = ptTemplate[point].y;
-        j = ptTemplate[point].x;
-        X1[0] = j;
-        X1[1] = i;
-
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-
-        j2 = X2[0];
-        i2 = X2[1];
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Iref = ptTemplate[point].val;
-
-          if (!blur)
-            Ic = I.getValue(i2, j2);
-          else
-            Ic = BI.getValue(i2, j2);
-
-          double prod = (Ic - moyIc);
-          for (unsigned int it = 0; it < nbParam; it++)
-            sIcdIref[it] += prod * (ptTemplate[point].dW[it] - moydIrefdp[it]);
-          for (unsigned int it = 0; it < nbParam; it++)
-            sIrefdIref[it] += (Iref - moyIref) * (ptTemplate[point].dW[it] - moydIrefdp[it]);
-
-          // double er=(Iref-Ic);
-          // erreur+=(er*er);
-          // denom+=(Iref-moyIref)*(Iref-moyIref)*(Ic-moyIc)*(Ic-moyIc);
-          covarIref += (Iref - moyIref) * (Iref - moyIref);
-          covarIc += (Ic - moyIc) * (Ic - moyIc);
-          sIcIref += (Iref - moyIref) * (Ic - moyIc);
+      vpThreadPool::getInstance().parallelFor(
+          0, nbChunks, vpZNCCCovarianceBody(pts, &Ic[0], &inside[0], moyIref, moyIc, moydIrefdp, &sums[0]));
+      for (unsigned int chunk = 0; chunk < nbChunks; chunk++) {
+        const double *sumsChunk = &sums[chunk * (2 * nbParam + 3)];
+        for (unsigned int it = 0; it < nbParam; it++) {
+          sIcdIref[it] += sumsChunk[it];
+          sIrefdIref[it] += sumsChunk[nbParam + it];
         }
+        covarIref += sumsChunk[2 * nbParam];
+        covarIc += sumsChunk[2 * nbParam + 1];
+        sIcIref += sumsChunk[2 * nbParam + 2];
       }
       covarIref = sqrt(covarIref);
       covarIc = sqrt(covarIc);
@@ -40,6 +40,8 @@
 #ifndef vpTemplateTrackerMI_hh
 #define vpTemplateTrackerMI_hh
 
+#include <vector>
+
 #include <visp3/core/vpConfig.h>
 
 #include <visp3/core/vpImageFilter.h>
@@ -69,7 +71,43 @@ public:
   /*! Hessian computation. */
   typedef enum { BSPLINE_THIRD_ORDER = 3, BSPLINE_FOURTH_ORDER = 4 } vpBsplineType;
 
+  /*! Terms of the joint probability accumulated for a point by computeProbabilities(). */
+  typedef enum {
+    PROBA_NONE,        /*!< The point is not accumulated. */
+    PROBA_ONLY,        /*!< Only Prt is accumulated. */
+    PROBA_FIRST_ORDER, /*!< Prt and dPrt are accumulated. */
+    PROBA_SECOND_ORDER /*!< Prt, dPrt and d2Prt are accumulated. */
+  } vpProbaOrder;
+
 protected:
+  /*!
+    Contributions of the template points to the joint histogram, one per
+    point: bins and residuals of the reference (r) and current (t)
+    intensities, and terms to accumulate. The derivatives are taken with
+    respect to the t intensity.
+  */
+  struct vpHistogramSamples {
+    //! Coordinates of the warped template points.
+    std::vector<double> u;
+    std::vector<double> v;
+    std::vector<int> cr;
+    std::vector<double> er;
+    std::vector<int> ct;
+    std::vector<double> et;
+    std::vector<unsigned char> order;
+
+    void resize(unsigned int nbPoints)
+    {
+      u.resize(nbPoints);
+      v.resize(nbPoints);
+      cr.resize(nbPoints);
+      er.resize(nbPoints);
+      ct.resize(nbPoints);
+      et.resize(nbPoints);
+      order.resize(nbPoints);
+    }
+  };
+
   vpHessienType hessianComputation;
   vpHessienApproximationType ApproxHessian;
   double lambda;
@@ -105,12 +143,24 @@ protected:
   vpMatrix covarianceMatrix;
   bool computeCovariance;
 
+  //! Samples of the joint histogram
+  vpHistogramSamples samples;
+  //! Joint probabilities and their derivatives accumulated by each chunk of
+  //! template points
+  std::vector<double> PrtChunks;
+  //! Upper triangles of the second derivatives of the joint probabilities
+  //! accumulated by each chunk of template points
+  std::vector<float> d2PrtChunks;
+
 protected:
   void computeGradient();
   void computeHessien(vpMatrix &H);
   void computeHessienNormalized(vpMatrix &H);
   void computeMI(double &MI);
   void computeProba(int &nbpoint);
+  int computeHistogramSamples(const vpImage<unsigned char> &I, const vpColVector &tp);
+  void computeProbabilities(const vpHistogramSamples &histSamples, const double *dWt, int nbpoint,
+                            vpProbaOrder order);
   double getCost(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getCost(const vpImage<unsigned char> &I) { return getCost(I, p); }
   double getNormalizedCost(const vpImage<unsigned char> &I, const vpColVector &tp);
@@ -146,7 +196,8 @@ public:
     : vpTemplateTracker(), hessianComputation(USE_HESSIEN_NORMAL), ApproxHessian(HESSIAN_0), lambda(0), temp(NULL),
       Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL), dprtemp(NULL), PrtD(NULL), dPrtD(NULL),
       influBspline(0), bspline(0), Nc(0), Ncb(0), d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false), samples(),
+      PrtChunks(), d2PrtChunks()
   {
   }
   explicit vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp);
@@ -37,10 +37,294 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/tt_mi/vpTemplateTrackerMI.h>
 #include <visp3/tt_mi/vpTemplateTrackerMIBSpline.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Minimal number of template points accumulated by a task of the thread pool
+const unsigned int MIN_CHUNK_SIZE = 1024;
+
+// Number of points interpolated at once by computeHistogramSamples()
+const unsigned int SAMPLE_BLOCK_SIZE = 256;
+
+// First bin and B-spline weights of the bins of an intensity of bin c and
+// residual e, as in vpTemplateTrackerMIBSpline. The polynomials of each
+// interval are evaluated directly
+inline int bsplineWeights(int bspline, int c, double e, double *B)
+{
+  if (bspline == 3) {
+    if (e > 0.5) {
+      c++;
+      e -= 1.;
+    }
+    const double a = 0.5 - e, b = 0.5 + e;
+    B[0] = 0.5 * a * a;
+    B[1] = 0.75 - e * e;
+    B[2] = 0.5 * b * b;
+  } else {
+    const double f = 1. - e, e2 = e * e, f2 = f * f;
+    B[0] = f2 * f / 6.;
+    B[1] = e2 * e / 2. - e2 + 4. / 6.;
+    B[2] = f2 * f / 2. - f2 + 4. / 6.;
+    B[3] = e2 * e / 6.;
+  }
+  return c;
+}
+
+// Same as above, with the first and second derivatives of the weights with
+// respect to the residual
+inline int bsplineWeights(int bspline, int c, double e, double *B, double *dB, double *d2B)
+{
+  if (bspline == 3) {
+    if (e > 0.5) {
+      c++;
+      e -= 1.;
+    }
+    const double a = 0.5 - e, b = 0.5 + e;
+    B[0] = 0.5 * a * a;
+    B[1] = 0.75 - e * e;
+    B[2] = 0.5 * b * b;
+    dB[0] = -a;
+    dB[1] = -2. * e;
+    dB[2] = b;
+    d2B[0] = 1.;
+    d2B[1] = -2.;
+    d2B[2] = 1.;
+  } else {
+    const double f = 1. - e, e2 = e * e, f2 = f * f;
+    B[0] = f2 * f / 6.;
+    B[1] = e2 * e / 2. - e2 + 4. / 6.;
+    B[2] = f2 * f / 2. - f2 + 4. / 6.;
+    B[3] = e2 * e / 6.;
+    dB[0] = -f2 / 2.;
+    dB[1] = 3. * e2 / 2. - 2. * e;
+    dB[2] = -3. * f2 / 2. + 2. * f;
+    dB[3] = e2 / 2.;
+    d2B[0] = f;
+    d2B[1] = 3. * e - 2.;
+    d2B[2] = 1. - 3. * e;
+    d2B[3] = e;
+  }
+  return c;
+}
+
+// y -= a * x
+inline void subScaled(double *y, double a, const double *x, unsigned int n, bool useSSE2)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    const __m128d a_ = _mm_set1_pd(a);
+    for (; i + 2 <= n; i += 2) {
+      _mm_storeu_pd(y + i, _mm_sub_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a_, _mm_loadu_pd(x + i))));
+    }
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; i < n; i++) {
+    y[i] -= a * x[i];
+  }
+}
+
+// y += a * x
+inline void addScaled(float *y, float a, const float *x, unsigned int n, bool useSSE2)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    const __m128 a_ = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(a_, _mm_loadu_ps(x + i))));
+    }
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; i < n; i++) {
+    y[i] += a * x[i];
+  }
+}
+
+// Accumulation of the joint histogram of each chunk of template points in
+// its own buffers. For each bin, PrtChunks stores the probability followed
+// by its derivatives, and d2PrtChunks the upper triangle of the second
+// derivatives in single precision
+class vpMIHistogramBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpMIHistogramBody(const std::vector<int> &cr, const std::vector<double> &er, const std::vector<int> &ct,
+                    const std::vector<double> &et, const std::vector<unsigned char> &order, const double *dW,
+                    unsigned int chunkSize, int bspline, int Ncb, unsigned int nbParam, unsigned int stride,
+                    double *PrtChunks, float *d2PrtChunks)
+    : m_cr(cr), m_er(er), m_ct(ct), m_et(et), m_order(order), m_dW(dW), m_chunkSize(chunkSize), m_bspline(bspline),
+      m_Ncb(Ncb), m_nbParam(nbParam), m_stride(stride), m_PrtChunks(PrtChunks), m_d2PrtChunks(d2PrtChunks),
+      m_useSSE2(vpCPUFeatures::checkSSE2())
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int nbBins = (unsigned int)(m_Ncb * m_Ncb);
+    const unsigned int nbSecond = m_nbParam * (m_nbParam + 1) / 2;
+    const unsigned int nbPoints = (unsigned int)m_order.size();
+    std::vector<float> dW2(nbSecond);
+    double Br[4], Bt[4], dBt[4], d2Bt[4];
+
+    for (unsigned int chunk = begin; chunk < end; chunk++) {
+      double *Prt = m_PrtChunks + (size_t)chunk * nbBins * m_stride;
+      std::fill(Prt, Prt + nbBins * m_stride, 0.);
+      float *d2Prt = NULL;
+      if (m_d2PrtChunks != NULL) {
+        d2Prt = m_d2PrtChunks + (size_t)chunk * nbBins * nbSecond;
+        std::fill(d2Prt, d2Prt + nbBins * nbSecond, 0.f);
+      }
+
+      const unsigned int last = (std::min)((chunk + 1) * m_chunkSize, nbPoints);
+      for (unsigned int point = chunk * m_chunkSize; point < last; point++) {
+        const unsigned char order = m_order[point];
+        if (order == vpTemplateTrackerMI::PROBA_NONE) {
+          continue;
+        }
+        const int r0 = bsplineWeights(m_bspline, m_cr[point], m_er[point], Br);
+
+        if (order == vpTemplateTrackerMI::PROBA_ONLY) {
+          const int t0 = bsplineWeights(m_bspline, m_ct[point], m_et[point], Bt);
+          for (int ir = 0; ir < m_bspline; ir++) {
+            double *pt = Prt + ((r0 + ir) * m_Ncb + t0) * (int)m_stride;
+            for (int it = 0; it < m_bspline; it++, pt += m_stride) {
+              *pt += Br[ir] * Bt[it];
+            }
+          }
+          continue;
+        }
+
+        const int t0 = bsplineWeights(m_bspline, m_ct[point], m_et[point], Bt, dBt, d2Bt);
+        const double *dW = m_dW + (size_t)point * m_nbParam;
+        const bool second = (order == vpTemplateTrackerMI::PROBA_SECOND_ORDER);
+        if (second) {
+          // The products of the derivatives are shared by all the bins
+          unsigned int k = 0;
+          for (unsigned int ip = 0; ip < m_nbParam; ip++) {
+            for (unsigned int ip2 = ip; ip2 < m_nbParam; ip2++) {
+              dW2[k++] = (float)(dW[ip] * dW[ip2]);
+            }
+          }
+        }
+
+        for (int ir = 0; ir < m_bspline; ir++) {
+          const int bin0 = (r0 + ir) * m_Ncb + t0;
+          for (int it = 0; it < m_bspline; it++) {
+            double *pt = Prt + (bin0 + it) * (int)m_stride;
+            pt[0] += Br[ir] * Bt[it];
+            subScaled(pt + 1, Br[ir] * dBt[it], dW, m_nbParam, m_useSSE2);
+            if (second) {
+              addScaled(d2Prt + (bin0 + it) * (int)nbSecond, (float)(Br[ir] * d2Bt[it]), &dW2[0], nbSecond,
+                        m_useSSE2);
+            }
+          }
+        }
+      }
+    }
+  }
+
+private:
+  const std::vector<int> &m_cr;
+  const std::vector<double> &m_er;
+  const std::vector<int> &m_ct;
+  const std::vector<double> &m_et;
+  const std::vector<unsigned char> &m_order;
+  const double *m_dW;
+  unsigned int m_chunkSize;
+  int m_bspline;
+  int m_Ncb;
+  unsigned int m_nbParam;
+  unsigned int m_stride;
+  double *m_PrtChunks;
+  float *m_d2PrtChunks;
+  bool m_useSSE2;
+};
+
+// Sum of the histograms of the chunks in order, normalized by the number of
+// points, for a range of bins
+class vpMIReductionBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpMIReductionBody(const double *PrtChunks, const float *d2PrtChunks, unsigned int nbChunks, unsigned int nbBins,
+                    unsigned int nbParam, unsigned int stride, int nbpoint, double *Prt, double *dPrt,
+                    double *d2Prt)
+    : m_PrtChunks(PrtChunks), m_d2PrtChunks(d2PrtChunks), m_nbChunks(nbChunks), m_nbBins(nbBins),
+      m_nbParam(nbParam), m_stride(stride), m_nbpoint(nbpoint), m_Prt(Prt), m_dPrt(dPrt), m_d2Prt(d2Prt)
+  {
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    const unsigned int nbSecond = m_nbParam * (m_nbParam + 1) / 2;
+    const size_t chunkStride = (size_t)m_nbBins * m_stride;
+    const size_t chunkStride2 = (size_t)m_nbBins * nbSecond;
+
+    for (unsigned int bin = begin; bin < end; bin++) {
+      for (unsigned int k = 0; k < m_stride; k++) {
+        double sum = 0;
+        for (unsigned int chunk = 0; chunk < m_nbChunks; chunk++) {
+          sum += m_PrtChunks[chunk * chunkStride + bin * m_stride + k];
+        }
+        if (k == 0) {
+          m_Prt[bin] = sum / m_nbpoint;
+        } else {
+          m_dPrt[bin * m_nbParam + k - 1] = sum / m_nbpoint;
+        }
+      }
+
+      if (m_d2Prt == NULL) {
+        continue;
+      }
+      double *d2Prt = m_d2Prt + (size_t)bin * m_nbParam * m_nbParam;
+      if (m_d2PrtChunks == NULL) {
+        std::fill(d2Prt, d2Prt + m_nbParam * m_nbParam, 0.);
+        continue;
+      }
+      unsigned int k = 0;
+      for (unsigned int ip = 0; ip < m_nbParam; ip++) {
+        for (unsigned int ip2 = ip; ip2 < m_nbParam; ip2++, k++) {
+          double sum = 0;
+          for (unsigned int chunk = 0; chunk < m_nbChunks; chunk++) {
+            sum += m_d2PrtChunks[chunk * chunkStride2 + bin * nbSecond + k];
+          }
+          d2Prt[ip * m_nbParam + ip2] = d2Prt[ip2 * m_nbParam + ip] = sum / m_nbpoint;
+        }
+      }
+    }
+  }
+
+private:
+  const double *m_PrtChunks;
+  const float *m_d2PrtChunks;
+  unsigned int m_nbChunks;
+  unsigned int m_nbBins;
+  unsigned int m_nbParam;
+  unsigned int m_stride;
+  int m_nbpoint;
+  double *m_Prt;
+  double *m_dPrt;
+  double *m_d2Prt;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpTemplateTrackerMI::setBspline(const vpBsplineType &newbs)
 {
   bspline = (int)newbs;
@@ -82,7 +366,8 @@ vpTemplateTrackerMI::vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp)
   : vpTemplateTracker(_warp), hessianComputation(USE_HESSIEN_NORMAL), ApproxHessian(HESSIAN_NEW), lambda(0), temp(NULL),
     Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL), dprtemp(NULL), PrtD(NULL), dPrtD(NULL),
     influBspline(0), bspline(3), Nc(8), Ncb(0), d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false), samples(),
+    PrtChunks(), d2PrtChunks()
 {
   Ncb = Nc + bspline;
   influBspline = bspline * bspline;
@@ -148,71 +433,15 @@ void vpTemplateTrackerMI::setNc(int nc)
 double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
   double MI = 0;
-  int Nbpoint = 0;
-  double IW;
-
   unsigned int Ncb_ = (unsigned int)Ncb;
-  unsigned int Nc_ = (unsigned int)Nc;
-  unsigned int influBspline_ = (unsigned int)influBspline;
-
-  memset(Prt, 0, Ncb_ * Ncb_ * sizeof(double));
-  memset(PrtD, 0, Nc_ * Nc_ * influBspline_ * sizeof(double));
-
-  // Warp->ComputeMAtWarp(tp);
-  Warp->computeCoeff(tp);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, tp);
-    Warp->warpX(X1, X2, tp);
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    // Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-
-      double Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-
-      int cr = (int)((IW * (Nc - 1)) / 255.);
-      int ct = (int)((Tij * (Nc - 1)) / 255.);
-      double er = (IW * (Nc - 1)) / 255. - cr;
-      double et = ((double)Tij * (Nc - 1)) / 255. - ct;
-
-      // Calcul de l'histogramme joint par interpolation bilinÃaire
-      // (Bspline ordre 1)
-      vpTemplateTrackerMIBSpline::PutPVBsplineD(PrtD, cr, er, ct, et, Nc, 1., bspline);
-    }
-  }
 
+  int Nbpoint = computeHistogramSamples(I, tp);
   ratioPixelIn = (double)Nbpoint / (double)templateSize;
 
-  double *pt = PrtD;
-  for (int r = 0; r < Nc; r++)
-    for (int t = 0; t < Nc; t++) {
-      for (int i = 0; i < influBspline; i++) {
-        int r2, t2;
-        r2 = r + i / bspline;
-        t2 = t + i % bspline;
-        Prt[r2 * Ncb + t2] += *pt;
-
-        pt++;
-      }
-    }
-
   if (Nbpoint == 0)
     return 0;
-  for (unsigned int r = 0; r < Ncb_; r++)
-    for (unsigned int t = 0; t < Ncb_; t++)
-      // printf("%f ",Prt[r*Ncb+t]);
-      Prt[r * Ncb_ + t] = Prt[r * Ncb_ + t] / Nbpoint;
+  computeProbabilities(samples, NULL, Nbpoint, PROBA_ONLY);
+
   // calcul Pr;
   memset(Pr, 0, Ncb_ * sizeof(double));
   for (unsigned int r = 0; r < Ncb_; r++) {
@@ -245,6 +474,107 @@ double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpCol
   return -MI;
 }
 
+/*!
+  Warp the template points with the parameters \e tp, and initialize the
+  samples of the joint histogram: the current intensities, interpolated in
+  \e I or in its blurred version BI, are the reference (r) intensities, and
+  the template intensities are the t intensities. The points inside the image
+  are set to PROBA_ONLY, the others to PROBA_NONE.
+
+  \return The number of template points inside the image.
+*/
+int vpTemplateTrackerMI::computeHistogramSamples(const vpImage<unsigned char> &I, const vpColVector &tp)
+{
+  vpTemplateTrackerPointArray &pts = getTemplateArray(currentLvlPyr);
+  if (pts.size() != templateSize)
+    initTemplateArray(currentLvlPyr);
+
+  samples.resize(templateSize);
+  if (templateSize == 0)
+    return 0;
+  Warp->warp(&pts.x[0], &pts.y[0], (int)templateSize, tp, &samples.u[0], &samples.v[0]);
+
+  double IW[SAMPLE_BLOCK_SIZE];
+  bool inside[SAMPLE_BLOCK_SIZE];
+  int Nbpoint = 0;
+  for (unsigned int first = 0; first < templateSize; first += SAMPLE_BLOCK_SIZE) {
+    const int nb = (int)(std::min)(SAMPLE_BLOCK_SIZE, templateSize - first);
+    if (!blur)
+      Nbpoint += (int)vpTemplateTrackerWarp::interpolate(I, &samples.u[first], &samples.v[first], nb, IW, inside);
+    else
+      Nbpoint += (int)vpTemplateTrackerWarp::interpolate(BI, &samples.u[first], &samples.v[first], nb, IW, inside);
+
+    for (int k = 0; k < nb; k++) {
+      const unsigned int point = first + (unsigned int)k;
+      if (!inside[k]) {
+        samples.order[point] = PROBA_NONE;
+        continue;
+      }
+      samples.order[point] = PROBA_ONLY;
+      samples.cr[point] = (int)((IW[k] * (Nc - 1)) / 255.);
+      samples.er[point] = (IW[k] * (Nc - 1)) / 255. - samples.cr[point];
+      samples.ct[point] = (int)((pts.val[point] * (Nc - 1)) / 255.);
+      samples.et[point] = (pts.val[point] * (Nc - 1)) / 255. - samples.ct[point];
+    }
+  }
+
+  return Nbpoint;
+}
+
+/*!
+  Compute the joint probabilities Prt of the samples, and their derivatives
+  dPrt and d2Prt with respect to the warp parameters, normalized by the number
+  of points \e nbpoint.
+
+  The template points are accumulated by chunks in parallel with
+  vpThreadPool, each chunk in its own histogram. The second derivatives are
+  accumulated in single precision in the chunks, and only their upper
+  triangle since they are symmetric. The histograms of the chunks are then
+  summed in order, so that the result does not depend on the number of
+  threads.
+
+  \param histSamples : Bins of the intensities of the template points, and
+  terms to accumulate for each point.
+  \param dWt : Derivatives of the t intensity bins of the points with
+  respect to the warp parameters, nbParam values per point. Not used when
+  \e order is PROBA_ONLY.
+  \param nbpoint : Number of points used to normalize the probabilities.
+  \param order : Terms computed. Prt is always computed; dPrt and d2Prt are
+  computed unless \e order is PROBA_ONLY, d2Prt being zero if \e order is
+  PROBA_FIRST_ORDER. The terms of the samples must not exceed \e order.
+*/
+void vpTemplateTrackerMI::computeProbabilities(const vpHistogramSamples &histSamples, const double *dWt, int nbpoint,
+                                               vpProbaOrder order)
+{
+  const unsigned int nbPoints = (unsigned int)histSamples.order.size();
+  const unsigned int nbBins = (unsigned int)(Ncb * Ncb);
+  const unsigned int stride = (order == PROBA_ONLY) ? 1 : 1 + nbParam;
+  const unsigned int nbSecond = nbParam * (nbParam + 1) / 2;
+
+  // The chunks are large enough for the reduction of their histograms to be
+  // negligible, and only depend on the size of the problem
+  const unsigned int chunkSize = (std::max)(MIN_CHUNK_SIZE, nbBins);
+  const unsigned int nbChunks = (std::max)(1u, (nbPoints + chunkSize - 1) / chunkSize);
+
+  if (PrtChunks.size() < (size_t)nbChunks * nbBins * stride)
+    PrtChunks.resize((size_t)nbChunks * nbBins * stride);
+  float *d2PrtChunks_ = NULL;
+  if (order == PROBA_SECOND_ORDER) {
+    if (d2PrtChunks.size() < (size_t)nbChunks * nbBins * nbSecond)
+      d2PrtChunks.resize((size_t)nbChunks * nbBins * nbSecond);
+    d2PrtChunks_ = &d2PrtChunks[0];
+  }
+
+  vpThreadPool &pool = vpThreadPool::getInstance();
+  vpMIHistogramBody histogramBody(histSamples.cr, histSamples.er, histSamples.ct, histSamples.et, histSamples.order,
+                                  dWt, chunkSize, bspline, Ncb, nbParam, stride, &PrtChunks[0], d2PrtChunks_);
+  pool.parallelFor(0, nbChunks, histogramBody);
+
+  vpMIReductionBody reductionBody(&PrtChunks[0], d2PrtChunks_, nbChunks, nbBins, nbParam, stride, nbpoint, Prt,
+                                  order == PROBA_ONLY ? NULL : dPrt, order == PROBA_ONLY ? NULL : d2Prt);
+  pool.parallelFor(0, nbBins, reductionBody);
+}
+
 double vpTemplateTrackerMI::getNormalizedCost(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
   // Attention, cette version calculée de la NMI ne pourra pas atteindre le
@@ -556,25 +886,28 @@ void vpTemplateTrackerMI::computeHessienNormalized(vpMatrix &Hessian)
             // dPxy/dt
             dprtemp[it] = dPrt[(r * Ncb_ + t) * nbParam + it];
           }
+          // The logarithms do not depend on the parameters
+          const double logPtPr = log(Pt[t] * Pr[r]);
+          const double logPrt = log(Prt[r * Ncb_ + t]);
+
           // dtemp=1.+log(Prt[r*Ncb+t]/Pt[t]);
           // u = som(Pxy.logPxPy)
-          u += Prt[r * Ncb_ + t] * log(Pt[t] * Pr[r]);
+          u += Prt[r * Ncb_ + t] * logPtPr;
           // v = som(Pxy.logPxy)
-          v += Prt[r * Ncb_ + t] * log(Prt[r * Ncb_ + t]);
+          v += Prt[r * Ncb_ + t] * logPrt;
 
           for (unsigned int it = 0; it < nbParam; it++) {
             // u' = som dPxylog(PxPy)
-            du[it] += dprtemp[it] * log(Pt[t] * Pr[r]);
+            du[it] += dprtemp[it] * logPtPr;
             // v' = som dPxy(1+log(Pxy))
-            dv[it] += dprtemp[it] * (1 + log(Prt[r * Ncb_ + t]));
+            dv[it] += dprtemp[it] * (1 + logPrt);
           }
           for (unsigned int it = 0; it < nbParam; it++) {
             for (unsigned int jt = 0; jt < nbParam; jt++) {
-              d2u[it][jt] += d2Prt[(r * Ncb_ + t) * nbParam * nbParam + it * nbParam + jt] * log(Pt[t] * Pr[r]) +
+              d2u[it][jt] += d2Prt[(r * Ncb_ + t) * nbParam * nbParam + it * nbParam + jt] * logPtPr +
+                             (1.0 / Prt[r * Ncb_ + t]) * (dprtemp[it] * dprtemp[it]);
+              d2v[it][jt] += d2Prt[(r * Ncb_ + t) * nbParam * nbParam + it * nbParam + jt] * (1 + logPrt) +
                              (1.0 / Prt[r * Ncb_ + t]) * (dprtemp[it] * dprtemp[it]);
-              d2v[it][jt] +=
-                  d2Prt[(r * Ncb_ + t) * nbParam * nbParam + it * nbParam + jt] * (1 + log(Prt[r * Ncb_ + t])) +
-                  (1.0 / Prt[r * Ncb_ + t]) * (dprtemp[it] * dprtemp[it]);
             }
           }
         }
@@ -40,10 +40,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIForwardAdditional::vpTemplateTrackerMIForwardAdditional(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), evolRMS(0), x_pos(NULL), y_pos(NULL), threshold_RMS(0),
     p_prec(), G_prec(), KQuasiNewton()
@@ -65,14 +61,15 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
   vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
 
-  double Tij;
-  double IW, dx, dy;
-  int cr, ct;
-  double er, et;
+  vpProbaOrder order = PROBA_NONE;
+  if (ApproxHessian == HESSIAN_NONSECOND)
+    order = PROBA_FIRST_ORDER;
+  else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+    order = PROBA_SECOND_ORDER;
 
-  Nbpoint = 0;
+  samples.resize(templateSize);
+  std::vector<double> dWt(templateSize * nbParam);
 
-  zeroProbabilities();
   Warp->computeCoeff(p);
   for (unsigned int point = 0; point < templateSize; point++) {
     int i = ptTemplate[point].y;
@@ -88,40 +85,36 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
     double j2 = X2[0];
     double i2 = X2[1];
 
+    samples.order[point] = PROBA_NONE;
     if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
       Nbpoint++;
-      Tij = ptTemplate[point].val;
+      double Tij = ptTemplate[point].val;
+      double IW;
       if (!blur)
         IW = I.getValue(i2, j2);
       else
         IW = BI.getValue(i2, j2);
 
-      dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-      dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
+      double dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
+      double dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
+
+      samples.ct[point] = (int)((IW * (Nc - 1)) / 255.);
+      samples.cr[point] = (int)((Tij * (Nc - 1)) / 255.);
+      samples.et[point] = (IW * (Nc - 1)) / 255. - samples.ct[point];
+      samples.er[point] = ((double)Tij * (Nc - 1)) / 255. - samples.cr[point];
+      samples.order[point] = (unsigned char)order;
 
-      ct = (int)((IW * (Nc - 1)) / 255.);
-      cr = (int)((Tij * (Nc - 1)) / 255.);
-      et = (IW * (Nc - 1)) / 255. - ct;
-      er = ((double)Tij * (Nc - 1)) / 255. - cr;
-      // std::cout<<"test"<<std::endl;
       Warp->dWarp(X1, X2, p, dW);
 
-      double *tptemp = new double[nbParam];
+      double *tptemp = &dWt[point * nbParam];
       for (unsigned int it = 0; it < nbParam; it++)
         tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-      if (ApproxHessian == HESSIAN_NONSECOND)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-      else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-        vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      delete[] tptemp;
     }
   }
 
   if (Nbpoint > 0) {
     double MI;
-    computeProba(Nbpoint);
+    computeProbabilities(samples, &dWt[0], Nbpoint, order == PROBA_NONE ? PROBA_FIRST_ORDER : order);
     computeMI(MI);
     computeHessien(Hdesire);
 
@@ -158,6 +151,15 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
 
   unsigned int iteration = 0;
 
+  vpProbaOrder order = PROBA_NONE;
+  if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+    order = PROBA_FIRST_ORDER;
+  else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+    order = PROBA_SECOND_ORDER;
+
+  samples.resize(templateSize);
+  std::vector<double> dWt(templateSize * nbParam);
+
   initPosEvalRMS(p);
   do {
     if (iteration % 5 == 0)
@@ -167,17 +169,8 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
     MI = 0;
     // erreur=0;
 
-    zeroProbabilities();
-
     Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-    int nthreads = omp_get_num_procs();
-    // std::cout << "file: " __FILE__ << " line: " << __LINE__ << " function:
-    // " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-    omp_set_num_threads(nthreads);
-#pragma omp parallel for default(shared)
-#endif
-    for (int point = 0; point < (int)templateSize; point++) {
+    for (unsigned int point = 0; point < templateSize; point++) {
       int i = ptTemplate[point].y;
       int j = ptTemplate[point].x;
       X1[0] = j;
@@ -189,6 +182,7 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
       double j2 = X2[0];
       double i2 = X2[1];
 
+      samples.order[point] = PROBA_NONE;
       if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
         Nbpoint++;
         double Tij = ptTemplate[point].val;
@@ -201,31 +195,18 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
         double dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
         double dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
 
-        int ct = (int)((IW * (Nc - 1)) / 255.);
-        int cr = (int)((Tij * (Nc - 1)) / 255.);
-        double et = (IW * (Nc - 1)) / 255. - ct;
-        double er = ((double)Tij * (Nc - 1)) / 255. - cr;
-
-        // calcul de l'erreur
-        // erreur+=(Tij-IW)*(Tij-IW);
+        samples.ct[point] = (int)((IW * (Nc - 1)) / 255.);
+        samples.cr[point] = (int)((Tij * (Nc - 1)) / 255.);
+        samples.et[point] = (IW * (Nc - 1)) / 255. - samples.ct[point];
+        samples.er[point] = ((double)Tij * (Nc - 1)) / 255. - samples.cr[point];
+        samples.order[point] = (unsigned char)order;
 
-        // Calcul de l'histogramme joint par interpolation bilinÃaire
-        // (Bspline ordre 1)
+        // Derivatives of the current intensity with respect to the parameters
         Warp->dWarp(X1, X2, p, dW);
 
-        // double *tptemp=temp;
-        double *tptemp = new double[nbParam];
-        ;
+        double *tptemp = &dWt[point * nbParam];
         for (unsigned int it = 0; it < nbParam; it++)
           tptemp[it] = (dW[0][it] * dx + dW[1][it] * dy);
-        //*tptemp++ =dW[0][it]*dIWx+dW[1][it]*dIWy;
-        // std::cout<<cr<<"   "<<ct<<"  ; ";
-        if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
       }
     }
 
@@ -236,7 +217,7 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
       deletePosEvalRMS();
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     } else {
-      computeProba(Nbpoint);
+      computeProbabilities(samples, &dWt[0], Nbpoint, order == PROBA_NONE ? PROBA_FIRST_ORDER : order);
       computeMI(MI);
       // std::cout<<iteration<<"\tMI= "<<MI<<std::endl;
       computeHessien(H);
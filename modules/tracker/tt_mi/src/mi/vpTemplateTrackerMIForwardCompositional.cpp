@@ -84,18 +84,10 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
   vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
 
-  // double erreur=0;
   int Nbpoint = 0;
 
-  // double Tij;
-  double IW, dx, dy;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
-  // erreur=0;
-
-  zeroProbabilities();
+  samples.resize(templateSize);
+  std::vector<double> dWt(templateSize * nbParam);
 
   Warp->computeCoeff(p);
   for (unsigned int point = 0; point < templateSize; point++) {
@@ -110,38 +102,33 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
     double j2 = X2[0];
     double i2 = X2[1];
 
+    samples.order[point] = PROBA_NONE;
     if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
       Nbpoint++;
-      // Tij=ptTemplate[point].val;
+      double IW;
       if (!blur)
         IW = I.getValue(i2, j2);
       else
         IW = BI.getValue(i2, j2);
 
-      dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-      dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
+      double dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
+      double dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
 
-      cr = ptTemplateSupp[point].ct;
-      er = ptTemplateSupp[point].et;
-      ct = (int)((IW * (Nc - 1)) / 255.);
-      et = ((double)IW * (Nc - 1)) / 255. - ct;
+      samples.cr[point] = ptTemplateSupp[point].ct;
+      samples.er[point] = ptTemplateSupp[point].et;
+      samples.ct[point] = (int)((IW * (Nc - 1)) / 255.);
+      samples.et[point] = ((double)IW * (Nc - 1)) / 255. - samples.ct[point];
+      samples.order[point] = PROBA_SECOND_ORDER;
 
       Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
 
-      double *tptemp = new double[nbParam];
+      double *tptemp = &dWt[point * nbParam];
       for (unsigned int it = 0; it < nbParam; it++)
         tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-      // calcul de l'erreur
-      // erreur+=(Tij-IW)*(Tij-IW);
-
-      vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      delete[] tptemp;
     }
   }
   double MI;
-  computeProba(Nbpoint);
+  computeProbabilities(samples, &dWt[0], Nbpoint, PROBA_SECOND_ORDER);
   computeMI(MI);
   computeHessien(Hdesire);
 
@@ -173,32 +160,30 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
 
   MI_preEstimation = -getCost(I, p);
 
-  double i2, j2;
-  // double Tij;
-  double IW;
-  // unsigned
-  int cr, ct;
-  double er, et;
-  double dx, dy;
+  vpProbaOrder order = PROBA_NONE;
+  if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+    order = PROBA_FIRST_ORDER;
+  else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+    order = PROBA_SECOND_ORDER;
+
+  samples.resize(templateSize);
+  std::vector<double> dWt(templateSize * nbParam);
 
   vpColVector dpinv(nbParam);
   double alpha = 2.;
 
-  int i, j;
   unsigned int iteration = 0;
   do {
     int Nbpoint = 0;
     MIprec = MI;
     MI = 0;
-    // erreur=0;
-
-    zeroProbabilities();
 
     Warp->computeCoeff(p);
 
     for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
+      int i = ptTemplate[point].y;
+      int j = ptTemplate[point].x;
+      double i2, j2;
       X1[0] = j;
       X1[1] = i;
       Warp->warpX(i, j, i2, j2, p);
@@ -206,37 +191,29 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
       X2[1] = i2;
 
       Warp->computeDenom(X1, p);
+      samples.order[point] = PROBA_NONE;
       if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
         Nbpoint++;
-        // Tij=ptTemplate[point].val;
+        double IW;
         if (!blur)
           IW = I.getValue(i2, j2);
         else
           IW = BI.getValue(i2, j2);
 
-        dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-        dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
+        double dx = 1. * dIx.getValue(i2, j2) * (Nc - 1) / 255.;
+        double dy = 1. * dIy.getValue(i2, j2) * (Nc - 1) / 255.;
 
-        ct = (int)((IW * (Nc - 1)) / 255.);
-        et = ((double)IW * (Nc - 1)) / 255. - ct;
-        cr = ptTemplateSupp[point].ct;
-        er = ptTemplateSupp[point].et;
+        samples.ct[point] = (int)((IW * (Nc - 1)) / 255.);
+        samples.et[point] = ((double)IW * (Nc - 1)) / 255. - samples.ct[point];
+        samples.cr[point] = ptTemplateSupp[point].ct;
+        samples.er[point] = ptTemplateSupp[point].et;
+        samples.order[point] = (unsigned char)order;
 
         Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
 
-        double *tptemp = new double[nbParam];
+        double *tptemp = &dWt[point * nbParam];
         for (unsigned int it = 0; it < nbParam; it++)
           tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-        // calcul de l'erreur
-        // erreur+=(Tij-IW)*(Tij-IW);
-
-        if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
       }
     }
     if (Nbpoint == 0) {
@@ -245,7 +222,7 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
       MI = 0;
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     } else {
-      computeProba(Nbpoint);
+      computeProbabilities(samples, &dWt[0], Nbpoint, order == PROBA_NONE ? PROBA_FIRST_ORDER : order);
       computeMI(MI);
       if (hessianComputation != vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
         computeHessien(H);
@@ -130,97 +130,37 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
     //                initTemplateRefBspline(point, et);
     // ###################
   }
+  initTemplateArray(currentLvlPyr);
   CompoInitialised = true;
 }
 void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<unsigned char> &I)
 {
   initCompInverse(I);
 
-  // double erreur=0;
-  int Nbpoint = 0;
-
-  // double Tij;
-  double IW;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
-  // erreur=0;
-
   if (blur)
     vpImageFilter::filter(I, BI, fgG, taillef);
 
-  zeroProbabilities();
-  Warp->computeCoeff(p);
+  int Nbpoint = computeHistogramSamples(I, p);
 
-  // AY : Optim
-  //    unsigned int totParam = (bspline *
-  //    bspline)*(1+nbParam+nbParam*nbParam); unsigned int size = (1 + nbParam
-  //    + nbParam*nbParam)*bspline; double *ptb;
+  vpProbaOrder order;
+  if (ApproxHessian == HESSIAN_NONSECOND)
+    order = PROBA_FIRST_ORDER;
+  else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+    order = PROBA_SECOND_ORDER;
+  else
+    order = PROBA_ONLY;
 
   for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-      // Tij=ptTemplate[point].val;
-
-      if (blur)
-        IW = BI.getValue(i2, j2);
-      else
-        IW = I.getValue(i2, j2);
-
-      ct = ptTemplateSupp[point].ct;
-      et = ptTemplateSupp[point].et;
-      cr = (int)((IW * (Nc - 1)) / 255.);
-      er = ((double)IW * (Nc - 1)) / 255. - cr;
-
-      // calcul de l'erreur
-      // erreur+=(Tij-IW)*(Tij-IW);
-
-      if (ApproxHessian == HESSIAN_NONSECOND && (ptTemplateSelect[point] || !useTemplateSelect)) {
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam,
-                                                            bspline);
-      } else if ((ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW) &&
-                 (ptTemplateSelect[point] || !useTemplateSelect)) {
-        if (bspline == 3) {
-          vpTemplateTrackerMIBSpline::PutTotPVBspline3(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-          //                    {
-          //                        if(et>0.5){ct++;}
-          //                        if(er>0.5){cr++;}
-          //                        int index = (cr*Nc+ct)*totParam;
-          //                        double *ptb = &PrtTout[index];
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline3(ptb,
-          //                        er, ptTemplateSupp[point].BtInit, size);
-          //                    }
-        } else {
-          vpTemplateTrackerMIBSpline::PutTotPVBspline4(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-
-          //                    {
-          //                        // ################### AY : Optim
-          //                        unsigned int index = (cr*Nc+ct)*totParam;
-          //                        ptb = &PrtTout[index];
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline4(ptb,
-          //                        er, ptTemplateSupp[point].BtInit, size);
-          //                        // ###################
-          //                    }
-        }
-      } else if (ptTemplateSelect[point] || !useTemplateSelect)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(PrtTout, cr, er, ct, et, Nc, nbParam, bspline);
-    }
+    if (samples.order[point] != PROBA_NONE)
+      samples.order[point] = (ptTemplateSelect[point] || !useTemplateSelect) ? order : PROBA_NONE;
   }
 
+  if (Nbpoint == 0)
+    throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+
   double MI;
-  computeProba(Nbpoint);
+  computeProbabilities(samples, &getTemplateArray(currentLvlPyr).dW[0], Nbpoint,
+                       order == PROBA_ONLY ? PROBA_FIRST_ORDER : order);
   computeMI(MI);
   computeHessien(Hdesire);
 
@@ -267,66 +207,27 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
 
   vpMatrix Hnorm(nbParam, nbParam);
 
+  // Terms accumulated for the selected template points, the others only
+  // contribute to the probabilities
+  const vpProbaOrder order =
+      (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+          ? PROBA_FIRST_ORDER
+          : PROBA_SECOND_ORDER;
+
   do {
-    int Nbpoint = 0;
     MIprec = MI;
     MI = 0;
 
-    zeroProbabilities();
-
-    Warp->computeCoeff(p);
-
-    {
-      for (int point = 0; point < (int)templateSize; point++) {
-        vpColVector x1(2), x2(2);
-        double i2, j2;
-
-        x1[0] = (double)ptTemplate[point].x;
-        x1[1] = (double)ptTemplate[point].y;
-
-        Warp->computeDenom(x1, p); // A modif pour parallelisation mais ne
-                                   // pose pas de pb avec warp utilises dans
-                                   // DECSA
-        Warp->warpX(x1, x2, p);
-
-        j2 = x2[0];
-        i2 = x2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          // if(m_ptCurrentMask == NULL ||(m_ptCurrentMask->getWidth() ==
-          // I.getWidth() && m_ptCurrentMask->getHeight() == I.getHeight() &&
-          // (*m_ptCurrentMask)[(unsigned int)i2][(unsigned int)j2] > 128))
-          {
-            Nbpoint++;
-            double IW;
-            if (!blur)
-              IW = (double)I.getValue(i2, j2);
-            else
-              IW = BI.getValue(i2, j2);
-
-            int ct = ptTemplateSupp[point].ct;
-            double et = ptTemplateSupp[point].et;
-            double tmp = IW * (((double)Nc) - 1.f) / 255.f;
-            int cr = (int)tmp;
-            double er = tmp - (double)cr;
-
-            if ((ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE) &&
-                (ptTemplateSelect[point] || !useTemplateSelect)) {
-              vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(Prt, dPrt, cr, er, ct, et, Ncb, ptTemplate[point].dW,
-                                                                  nbParam, bspline);
-            } else if (ptTemplateSelect[point] || !useTemplateSelect) {
-              if (bspline == 3) {
-                vpTemplateTrackerMIBSpline::PutTotPVBspline3(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb,
-                                                             ptTemplate[point].dW, nbParam);
-              } else {
-                vpTemplateTrackerMIBSpline::PutTotPVBspline4(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb,
-                                                             ptTemplate[point].dW, nbParam);
-              }
-            } else {
-              vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(Prt, cr, er, ct, et, Ncb, nbParam, bspline);
-            }
-          }
-        }
+    int Nbpoint = computeHistogramSamples(I, p);
+    if (useTemplateSelect) {
+      for (unsigned int point = 0; point < templateSize; point++) {
+        if (samples.order[point] != PROBA_NONE && ptTemplateSelect[point])
+          samples.order[point] = order;
+      }
+    } else {
+      for (unsigned int point = 0; point < templateSize; point++) {
+        if (samples.order[point] != PROBA_NONE)
+          samples.order[point] = order;
       }
     }
 
@@ -337,22 +238,7 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
 
     } else {
-      //            computeProba(Nbpoint);
-
-      unsigned int indd, indd2;
-      indd = indd2 = 0;
-      unsigned int Ncb_ = (unsigned int)Ncb;
-      for (unsigned int i = 0; i < Ncb_ * Ncb_; i++) {
-        Prt[i] = Prt[i] / Nbpoint;
-        for (unsigned int j = 0; j < nbParam; j++) {
-          dPrt[indd] = dPrt[indd] / Nbpoint;
-          indd++;
-          for (unsigned int k = 0; k < nbParam; k++) {
-            d2Prt[indd2] = d2Prt[indd2] / Nbpoint;
-            indd2++;
-          }
-        }
-      }
+      computeProbabilities(samples, &getTemplateArray(currentLvlPyr).dW[0], Nbpoint, order);
 
       computeMI(MI);
 
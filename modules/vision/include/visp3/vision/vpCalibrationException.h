@@ -98,6 +98,9 @@ public:
   }
   vpCalibrationException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpCalibrationException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpCalibrationException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
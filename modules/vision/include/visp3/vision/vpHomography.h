@@ -50,6 +50,7 @@ some tools for homography computation.
 #include <list>
 #include <vector>
 
+#include <visp3/core/vpAdaptiveRansac.h>
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImagePoint.h>
@@ -276,6 +277,9 @@ public:
   static bool ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
                      const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers, double &residual,
                      unsigned int nbInliersConsensus, double threshold, bool normalization = true);
+  static bool ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
+                     const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers, double &residual,
+                     vpAdaptiveRansac &ransac, bool normalization = true);
 
   static vpImagePoint project(const vpCameraParameters &cam, const vpHomography &bHa, const vpImagePoint &iPa);
   static vpPoint project(const vpHomography &bHa, const vpPoint &Pa);
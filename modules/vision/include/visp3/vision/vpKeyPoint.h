@@ -378,6 +378,10 @@ public:
                    std::vector<unsigned int> &inlierIndex, double &elapsedTime,
                    bool (*func)(vpHomogeneousMatrix *) = NULL);
 
+  bool computePose(const std::vector<vpPoint> &objectVpPoints, const std::vector<double> &qualities,
+                   vpHomogeneousMatrix &cMo, std::vector<vpPoint> &inliers, std::vector<unsigned int> &inlierIndex,
+                   double &elapsedTime, bool (*func)(vpHomogeneousMatrix *) = NULL);
+
   void createImageMatching(vpImage<unsigned char> &IRef, vpImage<unsigned char> &ICurrent,
                            vpImage<unsigned char> &IMatching);
   void createImageMatching(vpImage<unsigned char> &ICurrent, vpImage<unsigned char> &IMatching);
@@ -993,6 +997,21 @@ public:
     m_ransacParallel = parallel;
   }
 
+  /*!
+    Draw the RANSAC samples with PROSAC, from the matches with the smallest
+    descriptor distances first, when the pose is computed with the ViSP
+    method. This usually needs far less trials than a uniform sampling.
+    Only used by matchPoint(), where the points come with their matches; to
+    compute a pose from a given list of points with PROSAC, pass the
+    qualities to computePose().
+
+    \sa vpPose::setRansacQualities
+  */
+  inline void setRansacProsac(const bool prosac)
+  {
+    m_ransacProsac = prosac;
+  }
+
   /*!
     Set the number of threads to use if multithreaded RANSAC pose.
 
@@ -1213,6 +1232,8 @@ private:
   bool m_ransacParallel;
   //! Number of threads (if 0, try to determine the number of CPU threads)
   unsigned int m_ransacParallelNbThreads;
+  //! If true, draw the RANSAC samples with PROSAC
+  bool m_ransacProsac;
   //! Maximum reprojection error (in pixel for the OpenCV method) to decide if
   //! a point is an inlier or not.
   double m_ransacReprojectionError;
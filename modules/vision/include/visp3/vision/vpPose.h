@@ -57,13 +57,11 @@
 #include <visp3/core/vpList.h>
 #endif
 #include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <list>
 #include <math.h>
 #include <vector>
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-#include <atomic>
-#endif
 
 /*!
   \class vpPose
@@ -83,13 +81,13 @@ class VISP_EXPORT vpPose
 public:
   //! Methods that could be used to estimate the pose from points.
   typedef enum {
-    LAGRANGE,             /*!< Linear Lagrange approach (does't need an initialization) */
-    DEMENTHON,            /*!< Linear Dementhon aproach (does't need an initialization)
+    LAGRANGE,             /*!< Linear Lagrange approach (doesn't need an initialization) */
+    DEMENTHON,            /*!< Linear Dementhon aproach (doesn't need an initialization)
                            */
     LOWE,                 /*!< Lowe aproach based on a Levenberg Marquartd non linear
                              minimization scheme that needs an initialization from Lagrange or
                              Dementhon aproach */
-    RANSAC,               /*!< Robust Ransac aproach (does't need an initialization) */
+    RANSAC,               /*!< Robust Ransac aproach (doesn't need an initialization) */
     LAGRANGE_LOWE,        /*!< Non linear Lowe aproach initialized by Lagrange
                              approach */
     DEMENTHON_LOWE,       /*!< Non linear Lowe aproach initialized by Dementhon
@@ -98,8 +96,12 @@ public:
                              initialization from Lagrange or Dementhon aproach */
     DEMENTHON_VIRTUAL_VS, /*!< Non linear virtual visual servoing approach
                              initialized by Dementhon approach */
-    LAGRANGE_VIRTUAL_VS   /*!< Non linear virtual visual servoing approach
+    LAGRANGE_VIRTUAL_VS,  /*!< Non linear virtual visual servoing approach
                              initialized by Lagrange approach */
+    P3P,                  /*!< Closed-form perspective-three-point solver; the
+                             remaining points select one of its four solutions */
+    EPNP                  /*!< Linear Efficient PnP approach (doesn't need an
+                             initialization) */
   } vpPoseMethodType;
 
   enum RANSAC_FILTER_FLAGS {
@@ -141,6 +143,15 @@ private:
   double distanceToPlaneForCoplanarityTest;
   //! RANSAC flag to remove or not degenerate points
   RANSAC_FILTER_FLAGS ransacFlag;
+  //! Method used to compute the pose hypotheses of the RANSAC
+  vpPoseMethodType ransacHypothesisMethod;
+  //! Probability to draw at least one outlier free sample, used to stop the
+  //! RANSAC adaptively
+  double ransacProbability;
+  //! Matching qualities of the points used for the PROSAC sampling
+  std::vector<double> ransacQualities;
+  //! If true, verify the RANSAC hypotheses with the SPRT test
+  bool useRansacSPRT;
   //! List of points used for the RANSAC (std::vector is contiguous whereas
   //! std::list is a linked list)
   std::vector<vpPoint> listOfPoints;
@@ -152,64 +163,16 @@ private:
   //! epsilon
   double vvsEpsilon;
 
-  // For parallel RANSAC
-  class RansacFunctor
-  {
-  public:
-    RansacFunctor(const vpHomogeneousMatrix &cMo_, const unsigned int ransacNbInlierConsensus_,
-                  const int ransacMaxTrials_, const double ransacThreshold_, const unsigned int initial_seed_,
-                  const bool checkDegeneratePoints_, const std::vector<vpPoint> &listOfUniquePoints_,
-                  bool (*func_)(vpHomogeneousMatrix *)
-              #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-                  , std::atomic<bool> &abort
-              #endif
-                  )
-      :
-    #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-        m_abort(abort),
-    #endif
-        m_best_consensus(), m_checkDegeneratePoints(checkDegeneratePoints_), m_cMo(cMo_), m_foundSolution(false),
-        m_func(func_), m_initial_seed(initial_seed_), m_listOfUniquePoints(listOfUniquePoints_), m_nbInliers(0),
-        m_ransacMaxTrials(ransacMaxTrials_), m_ransacNbInlierConsensus(ransacNbInlierConsensus_),
-        m_ransacThreshold(ransacThreshold_)
-    { }
-
-    void operator()() { m_foundSolution = poseRansacImpl(); }
-
-    // Access the return value.
-    bool getResult() const { return m_foundSolution; }
-
-    std::vector<unsigned int> getBestConsensus() const { return m_best_consensus; }
-
-    vpHomogeneousMatrix getEstimatedPose() const { return m_cMo; }
-
-    unsigned int getNbInliers() const { return m_nbInliers; }
-
-  private:
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::atomic<bool> &m_abort;
-#endif
-    std::vector<unsigned int> m_best_consensus;
-    bool m_checkDegeneratePoints;
-    vpHomogeneousMatrix m_cMo;
-    bool m_foundSolution;
-    bool (*m_func)(vpHomogeneousMatrix *);
-    unsigned int m_initial_seed;
-    std::vector<vpPoint> m_listOfUniquePoints;
-    unsigned int m_nbInliers;
-    int m_ransacMaxTrials;
-    unsigned int m_ransacNbInlierConsensus;
-    double m_ransacThreshold;
-
-    bool poseRansacImpl();
-  };
-
 protected:
   double computeResidualDementhon(const vpHomogeneousMatrix &cMo);
 
   // method used in poseDementhonPlan()
   int calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatrix &cMo);
 
+  // method used in poseP3P() and poseEPnP()
+  static bool computeRigidTransformation(const std::vector<vpColVector> &oP, const std::vector<vpColVector> &cP,
+                                         vpHomogeneousMatrix &cMo);
+
 public:
   vpPose();
   virtual ~vpPose();
@@ -225,9 +188,11 @@ public:
   void init();
   void poseDementhonPlan(vpHomogeneousMatrix &cMo);
   void poseDementhonNonPlan(vpHomogeneousMatrix &cMo);
+  void poseEPnP(vpHomogeneousMatrix &cMo);
   void poseLagrangePlan(vpHomogeneousMatrix &cMo, const int coplanar_plane_type = 0);
   void poseLagrangeNonPlan(vpHomogeneousMatrix &cMo);
   void poseLowe(vpHomogeneousMatrix &cMo);
+  void poseP3P(vpHomogeneousMatrix &cMo);
   bool poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatrix *) = NULL);
   void poseVirtualVSrobust(vpHomogeneousMatrix &cMo);
   void poseVirtualVS(vpHomogeneousMatrix &cMo);
@@ -255,6 +220,52 @@ public:
     }
   }
   void setRansacMaxTrials(const int &rM) { ransacMaxTrials = rM; }
+
+  /*!
+    Get the method used to compute the pose hypotheses of the RANSAC.
+
+    \sa setRansacHypothesisMethod
+  */
+  inline vpPoseMethodType getRansacHypothesisMethod() const { return ransacHypothesisMethod; }
+  void setRansacHypothesisMethod(const vpPoseMethodType &method);
+
+  /*!
+    Get the probability to draw at least one outlier free sample.
+
+    \sa setRansacProbability
+  */
+  inline double getRansacProbability() const { return ransacProbability; }
+  void setRansacProbability(const double &p);
+
+  /*!
+    Get the matching qualities used for the PROSAC sampling.
+
+    \sa setRansacQualities
+  */
+  inline std::vector<double> getRansacQualities() const { return ransacQualities; }
+
+  /*!
+    Set the matching qualities (the higher the better) of the points, in
+    the order they were added. When not empty, the RANSAC samples are drawn
+    with PROSAC from the best points first \cite Chum05a.
+
+    \note The qualities have to be set again after the points are modified.
+  */
+  inline void setRansacQualities(const std::vector<double> &qualities) { ransacQualities = qualities; }
+
+  /*!
+    \return True if the RANSAC hypotheses are verified with the SPRT test.
+
+    \sa setUseRansacSPRT
+  */
+  inline bool getUseRansacSPRT() const { return useRansacSPRT; }
+
+  /*!
+    Set if the RANSAC hypotheses are verified with the Sequential
+    Probability Ratio Test \cite Matas05a, which rejects bad hypotheses
+    without scoring all the points.
+  */
+  inline void setUseRansacSPRT(const bool use) { useRansacSPRT = use; }
   unsigned int getRansacNbInliers() const { return (unsigned int)ransacInliers.size(); }
   std::vector<unsigned int> getRansacInlierIndex() const { return ransacInlierIndex; }
   std::vector<vpPoint> getRansacInliers() const { return ransacInliers; }
@@ -309,23 +320,22 @@ public:
     Set the number of threads for the parallel RANSAC implementation.
 
     \note You have to enable the parallel version with setUseParallelRansac().
-    If the number of threads is 0, the number of threads to use is
-    automatically determined with C++11.
+    If the number of threads is 0, the number of threads of the shared
+    vpThreadPool is used.
     \sa setUseParallelRansac
   */
   inline void setNbParallelRansacThreads(const int nb) { nbParallelRansacThreads = nb; }
 
   /*!
-    \return True if the parallel RANSAC version should be used (depends also to C++11 availability).
+    \return True if the parallel RANSAC version should be used.
 
     \sa setUseParallelRansac
   */
   inline bool getUseParallelRansac() const { return useParallelRansac; }
 
   /*!
-    Set if parallel RANSAC version should be used or not (only if C++11).
-
-    \note Need C++11.
+    Set if parallel RANSAC version should be used or not. The RANSAC
+    trials are then split in tasks executed by vpThreadPool::getInstance().
   */
   inline void setUseParallelRansac(const bool use) { useParallelRansac = use; }
 
@@ -347,6 +357,9 @@ public:
   static double poseFromRectangle(vpPoint &p1, vpPoint &p2, vpPoint &p3, vpPoint &p4, double lx,
                                   vpCameraParameters &cam, vpHomogeneousMatrix &cMo);
 
+  static unsigned int computePoseP3P(const vpPoint &P1, const vpPoint &P2, const vpPoint &P3,
+                                     std::vector<vpHomogeneousMatrix> &cMo);
+
   static int computeRansacIterations(double probability, double epsilon, const int sampleSize = 4,
                                      int maxIterations = 2000);
 
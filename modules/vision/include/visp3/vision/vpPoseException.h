@@ -95,6 +95,9 @@ public:
   vpPoseException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpPoseException(const int id) : vpException(id) { ; }
   // vpPoseException() : vpException() { ;}
+
+  vpException *clone() const { return new vpPoseException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
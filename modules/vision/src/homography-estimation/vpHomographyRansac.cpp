@@ -36,6 +36,7 @@
  *
  *****************************************************************************/
 
+#include <visp3/core/vpAdaptiveRansac.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpRansac.h>
 #include <visp3/vision/vpHomography.h>
@@ -44,6 +45,10 @@
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 
+#include <cmath>
+#include <float.h>
+#include <limits>
+
 #define vpEps 1e-6
 
 /*!
@@ -286,6 +291,102 @@ void vpHomography::initRansac(unsigned int n, double *xb, double *yb, double *xa
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Homography estimated by vpAdaptiveRansac. The model stores the 9
+// coefficients of aHb row by row, normalized so that the last one is 1.
+class HomographyEstimator : public vpAdaptiveRansac::vpModelEstimator
+{
+public:
+  HomographyEstimator(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
+                      const std::vector<double> &ya, const double threshold, const bool normalization)
+    : m_xb(xb), m_yb(yb), m_xa(xa), m_ya(ya), m_threshold(threshold), m_normalization(normalization)
+  {
+  }
+
+  unsigned int getNbData() const { return (unsigned int)m_xb.size(); }
+
+  unsigned int getSampleSize() const { return 4; }
+
+  bool isSampleValid(const std::vector<unsigned int> &sample) const
+  {
+    std::vector<double> xb_rand, yb_rand, xa_rand, ya_rand;
+    getSample(sample, xb_rand, yb_rand, xa_rand, ya_rand);
+    return !vpHomography::degenerateConfiguration(xb_rand, yb_rand, xa_rand, ya_rand);
+  }
+
+  void computeModels(const std::vector<unsigned int> &sample, std::vector<vpColVector> &models) const
+  {
+    std::vector<double> xb_rand, yb_rand, xa_rand, ya_rand;
+    getSample(sample, xb_rand, yb_rand, xa_rand, ya_rand);
+
+    vpHomography aHb;
+    try {
+      vpHomography::DLT(xb_rand, yb_rand, xa_rand, ya_rand, aHb, m_normalization);
+    } catch (...) {
+      return;
+    }
+    if (std::fabs(aHb[2][2]) <= std::numeric_limits<double>::epsilon()) {
+      return;
+    }
+    aHb /= aHb[2][2];
+
+    vpColVector model(9);
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        model[3 * i + j] = aHb[i][j];
+      }
+    }
+
+    // Discard the models that do not fit their own sample
+    double r = 0;
+    for (size_t i = 0; i < sample.size(); i++) {
+      r += vpMath::sqr(computeError(model, sample[i]));
+    }
+    if (!(sqrt(r / sample.size()) < m_threshold)) {
+      return;
+    }
+
+    models.push_back(model);
+  }
+
+  double computeError(const vpColVector &model, unsigned int index) const
+  {
+    const double xb = m_xb[index], yb = m_yb[index];
+    const double w = model[6] * xb + model[7] * yb + model[8];
+    const double x = (model[0] * xb + model[1] * yb + model[2]) / w;
+    const double y = (model[3] * xb + model[4] * yb + model[5]) / w;
+    double error = sqrt(vpMath::sqr(m_xa[index] - x) + vpMath::sqr(m_ya[index] - y));
+    return vpMath::isNaN(error) ? DBL_MAX : error;
+  }
+
+private:
+  void getSample(const std::vector<unsigned int> &sample, std::vector<double> &xb_rand, std::vector<double> &yb_rand,
+                 std::vector<double> &xa_rand, std::vector<double> &ya_rand) const
+  {
+    xb_rand.resize(sample.size());
+    yb_rand.resize(sample.size());
+    xa_rand.resize(sample.size());
+    ya_rand.resize(sample.size());
+    for (size_t i = 0; i < sample.size(); i++) {
+      xb_rand[i] = m_xb[sample[i]];
+      yb_rand[i] = m_yb[sample[i]];
+      xa_rand[i] = m_xa[sample[i]];
+      ya_rand[i] = m_ya[sample[i]];
+    }
+  }
+
+  const std::vector<double> &m_xb;
+  const std::vector<double> &m_yb;
+  const std::vector<double> &m_xa;
+  const std::vector<double> &m_ya;
+  double m_threshold;
+  bool m_normalization;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
 
   From couples of matched points \f$^a{\bf p}=(x_a,y_a,1)\f$ in image a
@@ -307,17 +408,56 @@ void vpHomography::initRansac(unsigned int n, double *xb, double *yb, double *xa
 
   \param threshold : Threshold for outlier removing. A point is considered as
   an outlier if the reprojection error \f$\| {^a{\bf p} - {\hat{^a{\bf H}_b}}
-  {^b{\bf p}}} \|\f$ is greater than this threshold.
+  {^b{\bf p}}} \|\f$ is greater than or equal to this threshold, which must
+  be positive.
 
   \param normalization : When set to true, the coordinates of the points are
   normalized. The normalization carried out is the one preconized by Hartley.
 
   \return true if the homography could be computed, false otherwise.
 
+  \note The number of trials is adapted to the ratio of inliers with a
+  probability of 0.99 and bounded by 1000. Use the overload taking a
+  vpAdaptiveRansac to change these settings or to enable PROSAC, SPRT and
+  the parallel trials.
 */
 bool vpHomography::ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
                           const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers,
                           double &residual, unsigned int nbInliersConsensus, double threshold, bool normalization)
+{
+  vpAdaptiveRansac ransac;
+  ransac.setNbInliersToReachConsensus(nbInliersConsensus);
+  ransac.setThreshold(threshold);
+
+  return vpHomography::ransac(xb, yb, xa, ya, aHb, inliers, residual, ransac, normalization);
+}
+
+/*!
+
+  Computes the homography \f$^a{\bf H}_b\f$ from couples of matched points
+  with a RANSAC configured by the caller.
+
+  \param xb, yb : Coordinates vector of matched points in image b, expressed
+  in meters.
+  \param xa, ya : Coordinates vector of matched points in image a, expressed
+  in meters.
+  \param aHb : Estimated homography.
+  \param inliers : Vector that indicates if a matched point is an inlier
+  (true) or an outlier (false).
+  \param residual : Global residual computed over the inliers.
+  \param ransac : RANSAC settings. A point is an inlier when its distance
+  \f$\| {^a{\bf p} - {\hat{^a{\bf H}_b}} {^b{\bf p}}} \|\f$ is strictly below the threshold, and
+  the consensus is the minimal number of inliers requested to fit the
+  estimated homography. The qualities, if any, are given in the order of
+  the points.
+  \param normalization : When set to true, the coordinates of the points are
+  normalized. The normalization carried out is the one preconized by Hartley.
+
+  \return true if the homography could be computed, false otherwise.
+*/
+bool vpHomography::ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
+                          const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers,
+                          double &residual, vpAdaptiveRansac &ransac, bool normalization)
 {
   unsigned int n = (unsigned int)xb.size();
   if (yb.size() != n || xa.size() != n || ya.size() != n)
@@ -327,174 +467,50 @@ bool vpHomography::ransac(const std::vector<double> &xb, const std::vector<doubl
   if (n < 4)
     throw(vpException(vpException::fatalError, "There must be at least 4 matched points"));
 
-  vpUniRand random((const long)time(NULL));
-
+  HomographyEstimator estimator(xb, yb, xa, ya, ransac.getThreshold(), normalization);
+  vpColVector model;
   std::vector<unsigned int> best_consensus;
-  std::vector<unsigned int> cur_consensus;
-  std::vector<unsigned int> cur_outliers;
-  std::vector<unsigned int> cur_randoms;
-
-  std::vector<unsigned int> rand_ind;
-
-  unsigned int nbMinRandom = 4;
-  unsigned int ransacMaxTrials = 1000;
-  unsigned int maxDegenerateIter = 1000;
-
-  unsigned int nbTrials = 0;
-  unsigned int nbDegenerateIter = 0;
-  unsigned int nbInliers = 0;
-
-  bool foundSolution = false;
-
-  std::vector<double> xa_rand(nbMinRandom);
-  std::vector<double> ya_rand(nbMinRandom);
-  std::vector<double> xb_rand(nbMinRandom);
-  std::vector<double> yb_rand(nbMinRandom);
-
-  if (inliers.size() != n)
-    inliers.resize(n);
-
-  while (nbTrials < ransacMaxTrials && nbInliers < nbInliersConsensus) {
-    cur_outliers.clear();
-    cur_randoms.clear();
-
-    bool degenerate = true;
-    while (degenerate == true) {
-      std::vector<bool> usedPt(n, false);
+  bool foundSolution = ransac.estimate(estimator, model, best_consensus);
 
-      rand_ind.clear();
-      for (unsigned int i = 0; i < nbMinRandom; i++) {
-        // Generate random indicies in the range 0..n
-        unsigned int r = (unsigned int)ceil(random() * n) - 1;
-        while (usedPt[r]) {
-          r = (unsigned int)ceil(random() * n) - 1;
-        }
-        usedPt[r] = true;
-        rand_ind.push_back(r);
-
-        xa_rand[i] = xa[r];
-        ya_rand[i] = ya[r];
-        xb_rand[i] = xb[r];
-        yb_rand[i] = yb[r];
-      }
-
-      try {
-        if (!vpHomography::degenerateConfiguration(xb_rand, yb_rand, xa_rand, ya_rand)) {
-          vpHomography::DLT(xb_rand, yb_rand, xa_rand, ya_rand, aHb, normalization);
-          degenerate = false;
-        }
-      } catch (...) {
-        degenerate = true;
-      }
-
-      nbDegenerateIter++;
-
-      if (nbDegenerateIter > maxDegenerateIter) {
-        vpERROR_TRACE("Unable to select a nondegenerate data set");
-        throw(vpException(vpException::fatalError, "Unable to select a nondegenerate data set"));
-      }
-    }
-
-    aHb /= aHb[2][2];
-
-    // Computing Residual
-    double r = 0;
-    vpColVector a(3), b(3), c(3);
-    for (unsigned int i = 0; i < nbMinRandom; i++) {
-      a[0] = xa_rand[i];
-      a[1] = ya_rand[i];
-      a[2] = 1;
-      b[0] = xb_rand[i];
-      b[1] = yb_rand[i];
-      b[2] = 1;
-
-      c = aHb * b;
-      c /= c[2];
-      r += (a - c).sumSquare();
-      // cout << "point " <<i << "  " << (a-c).sumSquare()  <<endl ;;
-    }
+  inliers.assign(n, false);
+  for (size_t i = 0; i < best_consensus.size(); i++) {
+    inliers[best_consensus[i]] = true;
+  }
 
-    // Finding inliers & ouliers
-    r = sqrt(r / nbMinRandom);
-    // std::cout << "Candidate residual: " << r << std::endl;
-    if (r < threshold) {
-      unsigned int nbInliersCur = 0;
-      for (unsigned int i = 0; i < n; i++) {
-        a[0] = xa[i];
-        a[1] = ya[i];
-        a[2] = 1;
-        b[0] = xb[i];
-        b[1] = yb[i];
-        b[2] = 1;
-
-        c = aHb * b;
-        c /= c[2];
-        double error = sqrt((a - c).sumSquare());
-        if (error <= threshold) {
-          nbInliersCur++;
-          cur_consensus.push_back(i);
-          inliers[i] = true;
-        } else {
-          cur_outliers.push_back(i);
-          inliers[i] = false;
-        }
-      }
-      // std::cout << "nb inliers that matches: " << nbInliersCur <<
-      // std::endl;
-      if (nbInliersCur > nbInliers) {
-        foundSolution = true;
-        best_consensus = cur_consensus;
-        nbInliers = nbInliersCur;
-      }
+  if (!foundSolution || best_consensus.size() < 4 || best_consensus.size() < ransac.getNbInliersToReachConsensus()) {
+    return false;
+  }
 
-      cur_consensus.clear();
-    }
+  std::vector<double> xa_best(best_consensus.size());
+  std::vector<double> ya_best(best_consensus.size());
+  std::vector<double> xb_best(best_consensus.size());
+  std::vector<double> yb_best(best_consensus.size());
 
-    nbTrials++;
-    if (nbTrials >= ransacMaxTrials) {
-      vpERROR_TRACE("Ransac reached the maximum number of trials");
-      foundSolution = true;
-    }
+  for (unsigned i = 0; i < best_consensus.size(); i++) {
+    xa_best[i] = xa[best_consensus[i]];
+    ya_best[i] = ya[best_consensus[i]];
+    xb_best[i] = xb[best_consensus[i]];
+    yb_best[i] = yb[best_consensus[i]];
   }
 
-  if (foundSolution) {
-    if (nbInliers >= nbInliersConsensus) {
-      std::vector<double> xa_best(best_consensus.size());
-      std::vector<double> ya_best(best_consensus.size());
-      std::vector<double> xb_best(best_consensus.size());
-      std::vector<double> yb_best(best_consensus.size());
-
-      for (unsigned i = 0; i < best_consensus.size(); i++) {
-        xa_best[i] = xa[best_consensus[i]];
-        ya_best[i] = ya[best_consensus[i]];
-        xb_best[i] = xb[best_consensus[i]];
-        yb_best[i] = yb[best_consensus[i]];
-      }
-
-      vpHomography::DLT(xb_best, yb_best, xa_best, ya_best, aHb, normalization);
-      aHb /= aHb[2][2];
-
-      residual = 0;
-      vpColVector a(3), b(3), c(3);
-      for (unsigned int i = 0; i < best_consensus.size(); i++) {
-        a[0] = xa_best[i];
-        a[1] = ya_best[i];
-        a[2] = 1;
-        b[0] = xb_best[i];
-        b[1] = yb_best[i];
-        b[2] = 1;
-
-        c = aHb * b;
-        c /= c[2];
-        residual += (a - c).sumSquare();
-      }
+  vpHomography::DLT(xb_best, yb_best, xa_best, ya_best, aHb, normalization);
+  aHb /= aHb[2][2];
 
-      residual = sqrt(residual / best_consensus.size());
-      return true;
-    } else {
-      return false;
-    }
-  } else {
-    return false;
+  residual = 0;
+  vpColVector a(3), b(3), c(3);
+  for (unsigned int i = 0; i < best_consensus.size(); i++) {
+    a[0] = xa_best[i];
+    a[1] = ya_best[i];
+    a[2] = 1;
+    b[0] = xb_best[i];
+    b[1] = yb_best[i];
+    b[2] = 1;
+
+    c = aHb * b;
+    c /= c[2];
+    residual += (a - c).sumSquare();
   }
+
+  residual = sqrt(residual / best_consensus.size());
+  return true;
 }
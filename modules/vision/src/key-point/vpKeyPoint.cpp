@@ -86,7 +86,7 @@ vpKeyPoint::vpKeyPoint(const vpFeatureDetectorType &detectorType, const vpFeatur
     m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(), m_ransacOutliers(),
-    m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0),
+    m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacProsac(false), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
     m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
@@ -122,7 +122,7 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
     m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(), m_ransacOutliers(),
-    m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0),
+    m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacProsac(false), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
     m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
@@ -158,7 +158,7 @@ vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std:
     m_matchingRatioThreshold(0.85), m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200),
     m_nbRansacMinInlierCount(100), m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(),
     m_queryFilteredKeyPoints(), m_queryKeyPoints(), m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(),
-    m_ransacOutliers(), m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0), m_ransacThreshold(0.01),
+    m_ransacOutliers(), m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacProsac(false), m_ransacReprojectionError(6.0), m_ransacThreshold(0.01),
     m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(), m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
@@ -914,6 +914,32 @@ bool vpKeyPoint::computePose(const std::vector<vpPoint> &objectVpPoints, vpHomog
 bool vpKeyPoint::computePose(const std::vector<vpPoint> &objectVpPoints, vpHomogeneousMatrix &cMo,
                              std::vector<vpPoint> &inliers, std::vector<unsigned int> &inlierIndex, double &elapsedTime,
                              bool (*func)(vpHomogeneousMatrix *))
+{
+  return computePose(objectVpPoints, std::vector<double>(), cMo, inliers, inlierIndex, elapsedTime, func);
+}
+
+/*!
+   Compute the pose using the correspondence between 2D points and 3D points
+   using ViSP function with RANSAC method, drawing the RANSAC samples with
+   PROSAC from the given matching qualities.
+
+   \param objectVpPoints : List of vpPoint with coordinates expressed in the
+   object and in the camera frame.
+   \param qualities : Matching quality of each point, the higher the better,
+   see vpPose::setRansacQualities(). If empty, the samples are drawn uniformly.
+   \param cMo : Homogeneous matrix between the object frame and the camera frame.
+   \param inliers : List of inlier points.
+   \param inlierIndex : List of inlier index.
+   \param elapsedTime : Elapsed time.
+   \param func : Function pointer to filter the pose in Ransac pose estimation,
+   if we want to eliminate the poses which do not respect some criterion
+   \return True if the pose has been computed, false otherwise (not enough
+   points, or size list mismatch).
+ */
+bool vpKeyPoint::computePose(const std::vector<vpPoint> &objectVpPoints, const std::vector<double> &qualities,
+                             vpHomogeneousMatrix &cMo, std::vector<vpPoint> &inliers,
+                             std::vector<unsigned int> &inlierIndex, double &elapsedTime,
+                             bool (*func)(vpHomogeneousMatrix *))
 {
   double t = vpTime::measureTimeMs();
 
@@ -943,6 +969,7 @@ bool vpKeyPoint::computePose(const std::vector<vpPoint> &objectVpPoints, vpHomog
   pose.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
   pose.setRansacThreshold(m_ransacThreshold);
   pose.setRansacMaxTrials(m_nbRansacIterations);
+  pose.setRansacQualities(qualities);
 
   bool isRansacPoseEstimationOk = false;
   try {
@@ -3137,10 +3164,20 @@ bool vpKeyPoint::matchPoint(const vpImage<unsigned char> &I, const vpCameraParam
       objectVpPoints[cpt] = pt;
     }
 
+    // m_filteredMatches is in the order of m_objectFilteredPoints
+    std::vector<double> qualities;
+    if (m_ransacProsac) {
+      // The smaller the descriptor distance, the better the match
+      qualities.resize(m_filteredMatches.size());
+      for (size_t i = 0; i < m_filteredMatches.size(); i++) {
+        qualities[i] = -m_filteredMatches[i].distance;
+      }
+    }
+
     std::vector<vpPoint> inliers;
     std::vector<unsigned int> inlierIndex;
 
-    bool res = computePose(objectVpPoints, cMo, inliers, inlierIndex, m_poseTime, func);
+    bool res = computePose(objectVpPoints, qualities, cMo, inliers, inlierIndex, m_poseTime, func);
 
     std::map<unsigned int, bool> mapOfInlierIndex;
     m_matchRansacKeyPointsToPoints.clear();
@@ -3589,6 +3626,7 @@ void vpKeyPoint::reset()
   m_ransacOutliers.clear();
   m_ransacParallel = true;
   m_ransacParallelNbThreads = 0;
+  m_ransacProsac = false;
   m_ransacReprojectionError = 6.0;
   m_ransacThreshold = 0.01;
   m_trainDescriptors = cv::Mat();
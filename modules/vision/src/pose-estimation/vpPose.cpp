@@ -52,8 +52,9 @@ pour faire du calcul de pose par difference methode
 #include <visp3/vision/vpPose.h>
 #include <visp3/vision/vpPoseException.h>
 
-#include <cmath>  // std::fabs
-#include <limits> // numeric_limits
+#include <algorithm> // std::swap
+#include <cmath>     // std::fabs
+#include <limits>    // numeric_limits
 
 #define DEBUG_LEVEL1 0
 /*!
@@ -80,6 +81,10 @@ void vpPose::init()
   ransacThreshold = 0.0001;
   distanceToPlaneForCoplanarityTest = 0.001;
   ransacFlag = NO_FILTER;
+  ransacHypothesisMethod = P3P;
+  ransacProbability = 0.99;
+  ransacQualities.clear();
+  useRansacSPRT = false;
   listOfPoints.clear();
   useParallelRansac = false;
   nbParallelRansacThreads = 0;
@@ -94,7 +99,8 @@ void vpPose::init()
 vpPose::vpPose()
   : npt(0), listP(), residual(0), lambda(0.25), vvsIterMax(200), c3d(), computeCovariance(false), covarianceMatrix(),
     ransacNbInlierConsensus(4), ransacMaxTrials(1000), ransacInliers(), ransacInlierIndex(), ransacThreshold(0.0001),
-    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), listOfPoints(),
+    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), ransacHypothesisMethod(vpPose::P3P),
+    ransacProbability(0.99), ransacQualities(), useRansacSPRT(false), listOfPoints(),
     useParallelRansac(false),
     nbParallelRansacThreads(0), // 0 means that we use C++11 (if available) to get the number of threads
     vvsEpsilon(1e-8)
@@ -356,7 +362,11 @@ double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const
   initialized by Dementhon approach
   - vpPose::LAGRANGE_VIRTUAL_VS: Non linear virtual visual servoing approach
   initialized by Lagrange approach
-  - vpPose::RANSAC: Robust Ransac aproach (does't need an initialization)
+  - vpPose::RANSAC: Robust Ransac aproach (doesn't need an initialization)
+  - vpPose::P3P: Closed-form perspective-three-point solver applied on the
+  three first points, the other points being used to select the solution
+  - vpPose::EPNP: Linear Efficient PnP approach (doesn't need an
+  initialization)
 
 */
 bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatrix *))
@@ -456,6 +466,12 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
       throw;
     }
     break;
+  case P3P:
+    poseP3P(cMo);
+    break;
+  case EPNP:
+    poseEPnP(cMo);
+    break;
   case LOWE:
   case VIRTUAL_VS:
     break;
@@ -465,6 +481,8 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
   case LAGRANGE:
   case DEMENTHON:
   case RANSAC:
+  case P3P:
+  case EPNP:
     break;
   case VIRTUAL_VS:
   case LAGRANGE_VIRTUAL_VS:
@@ -492,6 +510,128 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
   return true;
 }
 
+/*!
+  Set the method used to compute a pose hypothesis from a minimal random
+  sample during the RANSAC:
+  - vpPose::P3P (default): three points are drawn and each of the up to four
+  solutions of the closed-form P3P solver is an hypothesis
+  - vpPose::EPNP: four points are drawn and the pose is computed by EPnP
+  - vpPose::LAGRANGE or vpPose::DEMENTHON: four points are drawn and the pose
+  with the smallest residual among Lagrange and Dementhon approaches is kept
+
+  Since three points are enough with P3P, less trials are needed to draw an
+  outlier free sample for a given ratio of outliers.
+
+  \param method : Hypothesis method.
+  \exception vpException::badValue : Unsupported method.
+*/
+void vpPose::setRansacHypothesisMethod(const vpPoseMethodType &method)
+{
+  switch (method) {
+  case P3P:
+  case EPNP:
+  case LAGRANGE:
+  case DEMENTHON:
+    ransacHypothesisMethod = method;
+    break;
+  default:
+    throw vpException(vpException::badValue, "Unsupported RANSAC hypothesis method %d", (int)method);
+  }
+}
+
+/*!
+  Set the probability to draw at least one outlier free sample. The number
+  of RANSAC trials is adapted from this probability and from the ratio of
+  inliers of the best consensus found so far, without exceeding the maximum
+  number of trials set with setRansacMaxTrials().
+
+  \param p : Probability in ]0, 1] (0.99 by default). With a probability of
+  1, all the trials set with setRansacMaxTrials() are run.
+  \exception vpException::badValue : Probability outside ]0, 1].
+*/
+void vpPose::setRansacProbability(const double &p)
+{
+  if (p <= 0.0 || p > 1.0) {
+    throw vpException(vpException::badValue, "The RANSAC probability %f must be in ]0, 1]", p);
+  }
+  ransacProbability = p;
+}
+
+/*!
+  Compute the rigid transformation that best aligns, in the least-squares
+  sense, the points \e oP expressed in the object frame with the points \e cP
+  expressed in the camera frame (Arun et al., PAMI 1987).
+
+  \param oP : At least three non collinear points in the object frame.
+  \param cP : Corresponding points in the camera frame.
+  \param cMo : Estimated transformation.
+  \return false if the points are degenerate.
+*/
+bool vpPose::computeRigidTransformation(const std::vector<vpColVector> &oP, const std::vector<vpColVector> &cP,
+                                        vpHomogeneousMatrix &cMo)
+{
+  const size_t n = oP.size();
+  if (n < 3 || cP.size() != n) {
+    return false;
+  }
+
+  vpColVector oG(3, 0.0), cG(3, 0.0);
+  for (size_t k = 0; k < n; k++) {
+    oG += oP[k];
+    cG += cP[k];
+  }
+  oG /= (double)n;
+  cG /= (double)n;
+
+  vpMatrix H(3, 3, 0.0);
+  for (size_t k = 0; k < n; k++) {
+    for (unsigned int i = 0; i < 3; i++) {
+      const double o = oP[k][i] - oG[i];
+      for (unsigned int j = 0; j < 3; j++) {
+        H[i][j] += o * (cP[k][j] - cG[j]);
+      }
+    }
+  }
+
+  // H = U S V^T, H is replaced by U
+  vpColVector sv;
+  vpMatrix V;
+  H.svd(sv, V);
+
+  // Sort the singular values by increasing order
+  unsigned int idx[3] = {0, 1, 2};
+  for (unsigned int i = 0; i < 2; i++) {
+    for (unsigned int j = i + 1; j < 3; j++) {
+      if (sv[idx[j]] < sv[idx[i]])
+        std::swap(idx[i], idx[j]);
+    }
+  }
+  // Rank 2 is needed: only the smallest singular value may vanish
+  const unsigned int imin = idx[0];
+  if (sv[idx[1]] <= 1e-12 * sv[idx[2]]) {
+    return false;
+  }
+
+  vpMatrix R = V * H.t();
+  if (R.det() < 0) {
+    for (unsigned int i = 0; i < 3; i++) {
+      V[i][imin] = -V[i][imin];
+    }
+    R = V * H.t();
+  }
+
+  for (unsigned int i = 0; i < 3; i++) {
+    double t = cG[i];
+    for (unsigned int j = 0; j < 3; j++) {
+      cMo[i][j] = R[i][j];
+      t -= R[i][j] * oG[j];
+    }
+    cMo[i][3] = t;
+  }
+
+  return true;
+}
+
 void vpPose::printPoint()
 {
   vpPoint P;
@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pose computation with the EPnP approach.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPoseEPnP.cpp
+  \brief Pose computation with the Efficient PnP approach.
+*/
+
+#include <algorithm> // std::swap
+#include <cmath>
+#include <limits>
+
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPoseException.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Indexes of the values of sv sorted by increasing order
+std::vector<unsigned int> sortIndexes(const vpColVector &sv)
+{
+  std::vector<unsigned int> idx(sv.getRows());
+  for (unsigned int i = 0; i < sv.getRows(); i++) {
+    idx[i] = i;
+  }
+  for (unsigned int i = 1; i < sv.getRows(); i++) {
+    for (unsigned int j = i; j > 0 && sv[idx[j]] < sv[idx[j - 1]]; j--) {
+      std::swap(idx[j], idx[j - 1]);
+    }
+  }
+  return idx;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute the pose using the Efficient PnP approach introduced in Lepetit,
+  Moreno-Noguer and Fua, "EPnP: An Accurate O(n) Solution to the PnP
+  Problem", IJCV 2009.
+
+  The points are expressed as a weighted sum of four control points (three
+  when the points are coplanar) whose coordinates in the camera frame are a
+  combination of the null vectors of a \f$ 2n \times 12 \f$ linear system.
+  The combinations with one, two and three null vectors are refined by
+  Gauss-Newton on the distances between control points, and the one with
+  the smallest residual is kept.
+
+  \param cMo : Estimated pose.
+
+  \exception vpPoseException::notEnoughPointError : Less than four points.
+  \exception vpPoseException::notInitializedError : Collinear points or no
+  solution.
+*/
+void vpPose::poseEPnP(vpHomogeneousMatrix &cMo)
+{
+  if (npt < 4) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError, "EPnP needs at least four points (%d points)", npt));
+  }
+
+  const unsigned int n = static_cast<unsigned int>(listP.size());
+  std::vector<vpColVector> oP(n, vpColVector(3));
+  std::vector<double> x(n), y(n);
+  vpColVector oG(3, 0.0);
+  unsigned int k = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, k++) {
+    oP[k][0] = it->get_oX();
+    oP[k][1] = it->get_oY();
+    oP[k][2] = it->get_oZ();
+    x[k] = it->get_x();
+    y[k] = it->get_y();
+    oG += oP[k];
+  }
+  oG /= (double)n;
+
+  // Control points: the centroid and the principal directions of the points
+  vpMatrix A(3, 3, 0.0);
+  for (k = 0; k < n; k++) {
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        A[i][j] += (oP[k][i] - oG[i]) * (oP[k][j] - oG[j]);
+      }
+    }
+  }
+  vpColVector sv;
+  vpMatrix V;
+  A.svd(sv, V);
+  std::vector<unsigned int> idx = sortIndexes(sv);
+  if (sv[idx[1]] <= 1e-12 * sv[idx[2]]) {
+    throw(vpPoseException(vpPoseException::notInitializedError, "EPnP cannot be used with collinear points"));
+  }
+  const bool planar = (sv[idx[0]] <= 1e-10 * sv[idx[2]]);
+  const unsigned int nbCtrl = planar ? 3 : 4;
+
+  std::vector<vpColVector> oCtrl(nbCtrl, oG);
+  vpMatrix C(3, nbCtrl - 1);
+  for (unsigned int c = 1; c < nbCtrl; c++) {
+    const unsigned int axis = idx[3 - c];
+    const double scale = sqrt(sv[axis] / n);
+    for (unsigned int i = 0; i < 3; i++) {
+      C[i][c - 1] = scale * V[i][axis];
+      oCtrl[c][i] += C[i][c - 1];
+    }
+  }
+
+  // Barycentric coordinates of the points with respect to the control points
+  vpMatrix Cp = C.pseudoInverse(1e-12);
+  vpMatrix alphas(n, nbCtrl);
+  for (k = 0; k < n; k++) {
+    vpColVector a = Cp * (oP[k] - oG);
+    alphas[k][0] = 1.0;
+    for (unsigned int c = 1; c < nbCtrl; c++) {
+      alphas[k][c] = a[c - 1];
+      alphas[k][0] -= a[c - 1];
+    }
+  }
+
+  // Linear system M ctrl = 0 where ctrl stacks the control points in the
+  // camera frame
+  vpMatrix M(2 * n, 3 * nbCtrl, 0.0);
+  for (k = 0; k < n; k++) {
+    for (unsigned int c = 0; c < nbCtrl; c++) {
+      M[2 * k][3 * c] = alphas[k][c];
+      M[2 * k][3 * c + 2] = -alphas[k][c] * x[k];
+      M[2 * k + 1][3 * c + 1] = alphas[k][c];
+      M[2 * k + 1][3 * c + 2] = -alphas[k][c] * y[k];
+    }
+  }
+  vpMatrix MtM = M.AtA();
+  vpColVector svM;
+  vpMatrix VM;
+  MtM.svd(svM, VM);
+  std::vector<unsigned int> idxM = sortIndexes(svM);
+
+  // The distances between control points are preserved: for each pair, the
+  // scalar products between the differences of the null vectors
+  const unsigned int nbNullMax = planar ? 2 : 3;
+  std::vector<double> dist;
+  std::vector<vpMatrix> G;
+  for (unsigned int a = 0; a < nbCtrl; a++) {
+    for (unsigned int b = a + 1; b < nbCtrl; b++) {
+      dist.push_back((oCtrl[a] - oCtrl[b]).sumSquare());
+
+      vpMatrix Gab(nbNullMax, nbNullMax, 0.0);
+      for (unsigned int l = 0; l < nbNullMax; l++) {
+        for (unsigned int m = 0; m < nbNullMax; m++) {
+          for (unsigned int i = 0; i < 3; i++) {
+            Gab[l][m] +=
+                (VM[3 * a + i][idxM[l]] - VM[3 * b + i][idxM[l]]) * (VM[3 * a + i][idxM[m]] - VM[3 * b + i][idxM[m]]);
+          }
+        }
+      }
+      G.push_back(Gab);
+    }
+  }
+  const unsigned int nbPairs = static_cast<unsigned int>(dist.size());
+
+  double residual_min = std::numeric_limits<double>::max();
+  bool found = false;
+  std::vector<vpColVector> cP(n, vpColVector(3));
+  for (unsigned int N = 1; N <= nbNullMax; N++) {
+    // Linearization: the products beta_l beta_m (l <= m) are the unknowns
+    const unsigned int nbUnknowns = N * (N + 1) / 2;
+    vpMatrix L(nbPairs, nbUnknowns);
+    vpColVector rho(nbPairs);
+    for (unsigned int p = 0; p < nbPairs; p++) {
+      unsigned int u = 0;
+      for (unsigned int l = 0; l < N; l++) {
+        for (unsigned int m = l; m < N; m++, u++) {
+          L[p][u] = (l == m ? 1.0 : 2.0) * G[p][l][m];
+        }
+      }
+      rho[p] = dist[p];
+    }
+    vpColVector b = L.pseudoInverse(1e-12) * rho;
+
+    vpColVector beta(N);
+    beta[0] = sqrt(std::fabs(b[0]));
+    if (beta[0] <= std::numeric_limits<double>::epsilon()) {
+      continue;
+    }
+    for (unsigned int l = 1; l < N; l++) {
+      beta[l] = b[l] / beta[0];
+    }
+
+    // Gauss-Newton refinement of the betas
+    for (unsigned int iter = 0; iter < 5; iter++) {
+      vpMatrix J(nbPairs, N);
+      vpColVector e(nbPairs);
+      for (unsigned int p = 0; p < nbPairs; p++) {
+        e[p] = -dist[p];
+        for (unsigned int l = 0; l < N; l++) {
+          double Gb = 0;
+          for (unsigned int m = 0; m < N; m++) {
+            Gb += G[p][l][m] * beta[m];
+          }
+          J[p][l] = 2.0 * Gb;
+          e[p] += beta[l] * Gb;
+        }
+      }
+      beta -= J.pseudoInverse(1e-12) * e;
+    }
+
+    // Control points and points in the camera frame
+    std::vector<vpColVector> cCtrl(nbCtrl, vpColVector(3, 0.0));
+    for (unsigned int c = 0; c < nbCtrl; c++) {
+      for (unsigned int l = 0; l < N; l++) {
+        for (unsigned int i = 0; i < 3; i++) {
+          cCtrl[c][i] += beta[l] * VM[3 * c + i][idxM[l]];
+        }
+      }
+    }
+    double sumZ = 0;
+    for (k = 0; k < n; k++) {
+      cP[k] = 0;
+      for (unsigned int c = 0; c < nbCtrl; c++) {
+        cP[k] += alphas[k][c] * cCtrl[c];
+      }
+      sumZ += cP[k][2];
+    }
+    if (sumZ < 0) {
+      // The points have to be in front of the camera
+      for (k = 0; k < n; k++) {
+        cP[k] = -cP[k];
+      }
+    }
+
+    vpHomogeneousMatrix cMo_;
+    if (computeRigidTransformation(oP, cP, cMo_)) {
+      double r = computeResidual(cMo_);
+      if (r < residual_min) {
+        residual_min = r;
+        cMo = cMo_;
+        found = true;
+      }
+    }
+  }
+
+  if (!found) {
+    throw(vpPoseException(vpPoseException::notInitializedError, "No EPnP solution"));
+  }
+}
@@ -0,0 +1,318 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pose computation from three points (P3P).
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPoseP3P.cpp
+  \brief Closed-form pose computation from three points.
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPoseException.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+double cubicRoot(double x) { return x < 0 ? -pow(-x, 1.0 / 3.0) : pow(x, 1.0 / 3.0); }
+
+// Largest real root of x^3 + a x^2 + b x + c = 0
+double solveCubicLargestRoot(double a, double b, double c)
+{
+  // Depressed cubic t^3 + p t + q = 0 with x = t - a/3
+  const double a_3 = a / 3.0;
+  const double p = b - a * a_3;
+  const double q = 2.0 * a_3 * a_3 * a_3 - a_3 * b + c;
+  const double delta = q * q / 4.0 + p * p * p / 27.0;
+
+  double x;
+  if (delta > 0) {
+    const double sqrt_delta = sqrt(delta);
+    x = cubicRoot(-q / 2.0 + sqrt_delta) + cubicRoot(-q / 2.0 - sqrt_delta) - a_3;
+  } else if (p < 0) {
+    double cos_arg = 3.0 * q / (2.0 * p) * sqrt(-3.0 / p);
+    cos_arg = (std::max)(-1.0, (std::min)(1.0, cos_arg));
+    x = 2.0 * sqrt(-p / 3.0) * cos(acos(cos_arg) / 3.0) - a_3;
+  } else {
+    x = -a_3;
+  }
+
+  // Polish the root
+  for (int iter = 0; iter < 2; iter++) {
+    const double f = ((x + a) * x + b) * x + c;
+    const double df = (3.0 * x + 2.0 * a) * x + b;
+    if (std::fabs(df) < std::numeric_limits<double>::epsilon())
+      break;
+    x -= f / df;
+  }
+
+  return x;
+}
+
+// Real roots of the quadratic x^2 + b x + c = 0, appended to roots
+void solveQuadratic(double b, double c, double *roots, unsigned int &nbRoots)
+{
+  double delta = b * b - 4.0 * c;
+  if (delta < 0) {
+    // Accept a slightly negative discriminant due to rounding errors
+    if (delta < -1e-10 * (b * b + std::fabs(c)))
+      return;
+    delta = 0;
+  }
+  const double sqrt_delta = sqrt(delta);
+  roots[nbRoots++] = (-b + sqrt_delta) / 2.0;
+  roots[nbRoots++] = (-b - sqrt_delta) / 2.0;
+}
+
+// Real roots of a4 x^4 + a3 x^3 + a2 x^2 + a1 x + a0 = 0 using Ferrari's method
+unsigned int solveQuartic(double a4, double a3, double a2, double a1, double a0, double roots[4])
+{
+  unsigned int nbRoots = 0;
+  if (std::fabs(a4) < std::numeric_limits<double>::epsilon()) {
+    return nbRoots;
+  }
+
+  const double a = a3 / a4, b = a2 / a4, c = a1 / a4, d = a0 / a4;
+
+  // Depressed quartic y^4 + p y^2 + q y + r = 0 with x = y - a/4
+  const double a_4 = a / 4.0;
+  const double a2_16 = a_4 * a_4;
+  const double p = b - 6.0 * a2_16;
+  const double q = c - 2.0 * b * a_4 + 8.0 * a2_16 * a_4;
+  const double r = d - c * a_4 + b * a2_16 - 3.0 * a2_16 * a2_16;
+
+  if (std::fabs(q) < 1e-12) {
+    // Biquadratic equation
+    double z[2];
+    unsigned int nbZ = 0;
+    solveQuadratic(p, r, z, nbZ);
+    for (unsigned int k = 0; k < nbZ; k++) {
+      if (z[k] >= 0) {
+        roots[nbRoots++] = sqrt(z[k]) - a_4;
+        roots[nbRoots++] = -sqrt(z[k]) - a_4;
+      }
+    }
+  } else {
+    // Resolvent cubic m^3 + p m^2 + (p^2/4 - r) m - q^2/8 = 0 has a positive root
+    const double m = solveCubicLargestRoot(p, p * p / 4.0 - r, -q * q / 8.0);
+    if (m <= 0) {
+      return nbRoots;
+    }
+    const double s = sqrt(2.0 * m);
+    const double t = q / (2.0 * s);
+    solveQuadratic(-s, p / 2.0 + m + t, roots, nbRoots);
+    solveQuadratic(s, p / 2.0 + m - t, roots, nbRoots);
+    for (unsigned int k = 0; k < nbRoots; k++) {
+      roots[k] -= a_4;
+    }
+  }
+
+  // Polish the roots on the original polynomial
+  for (unsigned int k = 0; k < nbRoots; k++) {
+    double x = roots[k];
+    for (int iter = 0; iter < 2; iter++) {
+      const double f = (((a4 * x + a3) * x + a2) * x + a1) * x + a0;
+      const double df = ((4.0 * a4 * x + 3.0 * a3) * x + 2.0 * a2) * x + a1;
+      if (std::fabs(df) < std::numeric_limits<double>::epsilon())
+        break;
+      x -= f / df;
+    }
+    roots[k] = x;
+  }
+
+  return nbRoots;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute the poses that are consistent with three point correspondences
+  using Grunert's closed-form solution of the perspective-three-point
+  problem, as reviewed in Haralick et al., "Review and analysis of solutions
+  of the three point perspective pose estimation problem", IJCV 1994.
+
+  \param P1, P2, P3 : Points for which the object frame coordinates (oX, oY,
+  oZ) and the normalized image plane coordinates (x, y) are set.
+  \param cMo : Up to four poses consistent with the three points.
+  \return The number of poses that were found, 0 if the points are
+  collinear or if the problem has no solution.
+
+  \sa poseP3P()
+*/
+unsigned int vpPose::computePoseP3P(const vpPoint &P1, const vpPoint &P2, const vpPoint &P3,
+                                    std::vector<vpHomogeneousMatrix> &cMo)
+{
+  cMo.clear();
+
+  const vpPoint *P[3] = {&P1, &P2, &P3};
+  std::vector<vpColVector> oP(3), f(3);
+  for (unsigned int k = 0; k < 3; k++) {
+    oP[k].resize(3, false);
+    oP[k][0] = P[k]->get_oX();
+    oP[k][1] = P[k]->get_oY();
+    oP[k][2] = P[k]->get_oZ();
+
+    // Unit bearing vector
+    f[k].resize(3, false);
+    f[k][0] = P[k]->get_x();
+    f[k][1] = P[k]->get_y();
+    f[k][2] = 1.0;
+    f[k].normalize();
+  }
+
+  // Reject collinear object points
+  vpColVector cross = vpColVector::crossProd(oP[1] - oP[0], oP[2] - oP[0]);
+  const double scale = (oP[1] - oP[0]).sumSquare() + (oP[2] - oP[0]).sumSquare();
+  if (cross.sumSquare() <= 1e-12 * scale * scale) {
+    return 0;
+  }
+
+  // Squared distances between the object points: a opposite to P1,
+  // b opposite to P2 and c opposite to P3
+  const double a2 = (oP[1] - oP[2]).sumSquare();
+  const double b2 = (oP[0] - oP[2]).sumSquare();
+  const double c2 = (oP[0] - oP[1]).sumSquare();
+
+  // Cosines of the angles between the lines of sight
+  const double cos_alpha = vpColVector::dotProd(f[1], f[2]);
+  const double cos_beta = vpColVector::dotProd(f[0], f[2]);
+  const double cos_gamma = vpColVector::dotProd(f[0], f[1]);
+
+  const double a2_b2 = a2 / b2;
+  const double c2_b2 = c2 / b2;
+  const double amc = a2_b2 - c2_b2; // (a^2 - c^2) / b^2
+  const double apc = a2_b2 + c2_b2; // (a^2 + c^2) / b^2
+  const double cos_alpha2 = cos_alpha * cos_alpha;
+  const double cos_beta2 = cos_beta * cos_beta;
+  const double cos_gamma2 = cos_gamma * cos_gamma;
+
+  // Quartic in v = s3 / s1 where si is the distance of the i-th point to the
+  // camera center
+  const double A4 = vpMath::sqr(amc - 1.0) - 4.0 * c2_b2 * cos_alpha2;
+  const double A3 = 4.0 * (amc * (1.0 - amc) * cos_beta - (1.0 - apc) * cos_alpha * cos_gamma +
+                           2.0 * c2_b2 * cos_alpha2 * cos_beta);
+  const double A2 = 2.0 * (amc * amc - 1.0 + 2.0 * amc * amc * cos_beta2 + 2.0 * (1.0 - c2_b2) * cos_alpha2 -
+                           4.0 * apc * cos_alpha * cos_beta * cos_gamma + 2.0 * (1.0 - a2_b2) * cos_gamma2);
+  const double A1 = 4.0 * (-amc * (1.0 + amc) * cos_beta + 2.0 * a2_b2 * cos_gamma2 * cos_beta -
+                           (1.0 - apc) * cos_alpha * cos_gamma);
+  const double A0 = vpMath::sqr(1.0 + amc) - 4.0 * a2_b2 * cos_gamma2;
+
+  double roots[4];
+  const unsigned int nbRoots = solveQuartic(A4, A3, A2, A1, A0, roots);
+
+  std::vector<vpColVector> cP(3, vpColVector(3));
+  for (unsigned int k = 0; k < nbRoots; k++) {
+    const double v = roots[k];
+    if (v <= 0) {
+      continue;
+    }
+
+    const double den = 2.0 * (cos_gamma - v * cos_alpha);
+    if (std::fabs(den) < std::numeric_limits<double>::epsilon()) {
+      continue;
+    }
+    const double u = ((-1.0 + amc) * v * v - 2.0 * amc * cos_beta * v + 1.0 + amc) / den;
+    if (u <= 0) {
+      continue;
+    }
+
+    const double s1_2 = b2 / (1.0 + v * v - 2.0 * v * cos_beta);
+    if (s1_2 <= 0) {
+      continue;
+    }
+    const double s1 = sqrt(s1_2);
+    const double s[3] = {s1, u * s1, v * s1};
+
+    for (unsigned int l = 0; l < 3; l++) {
+      cP[l] = s[l] * f[l];
+    }
+
+    vpHomogeneousMatrix cMo_;
+    if (computeRigidTransformation(oP, cP, cMo_)) {
+      // Discard duplicated solutions coming from a double root
+      bool duplicated = false;
+      for (size_t l = 0; l < cMo.size() && !duplicated; l++) {
+        duplicated = ((cMo[l].getTranslationVector() - cMo_.getTranslationVector()).sumSquare() < 1e-12 * s1_2);
+      }
+      if (!duplicated) {
+        cMo.push_back(cMo_);
+      }
+    }
+  }
+
+  return static_cast<unsigned int>(cMo.size());
+}
+
+/*!
+  Compute the pose using the closed-form perspective-three-point solver on
+  the three first points. Among the up to four solutions, the one with the
+  smallest residual computed on all the points is kept.
+
+  \param cMo : Estimated pose.
+
+  \exception vpPoseException::notEnoughPointError : Less than four points.
+  \exception vpPoseException::notInitializedError : The first three points
+  are collinear or do not lead to any solution.
+
+  \sa computePoseP3P()
+*/
+void vpPose::poseP3P(vpHomogeneousMatrix &cMo)
+{
+  if (npt < 4) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "P3P needs a fourth point to select the solution (%d points)", npt));
+  }
+
+  std::list<vpPoint>::const_iterator it = listP.begin();
+  const vpPoint &P1 = *it++;
+  const vpPoint &P2 = *it++;
+  const vpPoint &P3 = *it;
+
+  std::vector<vpHomogeneousMatrix> solutions;
+  if (computePoseP3P(P1, P2, P3, solutions) == 0) {
+    throw(vpPoseException(vpPoseException::notInitializedError, "No P3P solution for the three first points"));
+  }
+
+  double residual_min = std::numeric_limits<double>::max();
+  for (size_t k = 0; k < solutions.size(); k++) {
+    double r = computeResidual(solutions[k]);
+    if (r < residual_min) {
+      residual_min = r;
+      cMo = solutions[k];
+    }
+  }
+}
@@ -50,16 +50,13 @@
 #include <limits> // numeric_limits
 #include <map>
 
+#include <visp3/core/vpAdaptiveRansac.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRansac.h>
 #include <visp3/vision/vpPose.h>
 #include <visp3/vision/vpPoseException.h>
 
-#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
-#include <thread>
-#endif
-
 #define eps 1e-6
 
 namespace
@@ -118,203 +115,169 @@ struct FindDegeneratePoint {
 
   vpPoint m_pt;
 };
-}
 
-bool vpPose::RansacFunctor::poseRansacImpl()
+// Pose of a four points minimal sample with the EPnP approach or with the
+// best of the Lagrange and Dementhon approaches. Return false if the
+// computation failed or if the residual is above the threshold.
+bool computeMinimalSamplePose(vpPose &poseMin, const vpPose::vpPoseMethodType method, vpHomogeneousMatrix &cMo,
+                              const double threshold)
 {
-  const unsigned int size = (unsigned int)m_listOfUniquePoints.size();
-  const unsigned int nbMinRandom = 4;
-  int nbTrials = 0;
-
-#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__))
-  srand(m_initial_seed);
-#endif
-
-  vpPoint p; // Point used to project using the estimated pose
-
-  bool foundSolution = false;
-  while (nbTrials < m_ransacMaxTrials && m_nbInliers < m_ransacNbInlierConsensus) {
-    // Hold the list of the index of the inliers (points in the consensus set)
-    std::vector<unsigned int> cur_consensus;
-    // Hold the list of the index of the outliers
-    std::vector<unsigned int> cur_outliers;
-    // Hold the list of the index of the points randomly picked
-    std::vector<unsigned int> cur_randoms;
-    // Hold the list of the current inliers points to avoid to add a
-    // degenerate point if the flag is set
-    std::vector<vpPoint> cur_inliers;
-
-    vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
-    // Use a temporary variable because if not, the cMo passed in parameters
-    // will be modified when
-    // we compute the pose for the minimal sample sets but if the pose is not
-    // correct when we pass a function pointer we do not want to modify the
-    // cMo passed in parameters
-    vpHomogeneousMatrix cMo_tmp;
-
-    // Vector of used points, initialized at false for all points
-    std::vector<bool> usedPt(size, false);
-
-    vpPose poseMin;
-    for (unsigned int i = 0; i < nbMinRandom;) {
-      if ((size_t)std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
-        // All points was picked once, break otherwise we stay in an infinite loop
-        break;
-      }
+  // Flags set if pose computation is OK
+  bool is_valid_lagrange = false;
+  bool is_valid_dementhon = false;
 
-// Pick a point randomly
-#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__))
-      unsigned int r_ = (unsigned int)rand() % size;
-#else
-      unsigned int r_ = (unsigned int)rand_r(&m_initial_seed) % size;
-#endif
-
-      while (usedPt[r_]) {
-// If already picked, pick another point randomly
-#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__))
-        r_ = (unsigned int)rand() % size;
-#else
-        r_ = (unsigned int)rand_r(&m_initial_seed) % size;
-#endif
-      }
-      // Mark this point as already picked
-      usedPt[r_] = true;
-      vpPoint pt = m_listOfUniquePoints[r_];
-
-      bool degenerate = false;
-      if (m_checkDegeneratePoints) {
-        if (std::find_if(poseMin.listOfPoints.begin(), poseMin.listOfPoints.end(), FindDegeneratePoint(pt)) !=
-            poseMin.listOfPoints.end()) {
-          degenerate = true;
-        }
-      }
+  // Set maximum value for residuals
+  double r_lagrange = DBL_MAX;
+  double r_dementhon = DBL_MAX;
 
-      if (!degenerate) {
-        poseMin.addPoint(pt);
-        cur_randoms.push_back(r_);
-        // Increment the number of points picked
-        i++;
-      }
-    }
-
-    if (poseMin.npt < nbMinRandom) {
-      nbTrials++;
-      continue;
+  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
+  if (method == vpPose::EPNP) {
+    // Stored in the Lagrange slot to share the selection below
+    try {
+      poseMin.computePose(vpPose::EPNP, cMo_lagrange);
+      r_lagrange = poseMin.computeResidual(cMo_lagrange);
+      is_valid_lagrange = true;
+    } catch (...) {
     }
-
-    // Flags set if pose computation is OK
-    bool is_valid_lagrange = false;
-    bool is_valid_dementhon = false;
-
-    // Set maximum value for residuals
-    double r_lagrange = DBL_MAX;
-    double r_dementhon = DBL_MAX;
-
+  } else {
     try {
       poseMin.computePose(vpPose::LAGRANGE, cMo_lagrange);
       r_lagrange = poseMin.computeResidual(cMo_lagrange);
       is_valid_lagrange = true;
-    } catch (...) { }
+    } catch (...) {
+    }
 
     try {
       poseMin.computePose(vpPose::DEMENTHON, cMo_dementhon);
       r_dementhon = poseMin.computeResidual(cMo_dementhon);
       is_valid_dementhon = true;
-    } catch (...) { }
-
-    // If residual returned is not a number (NAN), set valid to false
-    if (vpMath::isNaN(r_lagrange)) {
-      is_valid_lagrange = false;
-      r_lagrange = DBL_MAX;
+    } catch (...) {
     }
+  }
 
-    if (vpMath::isNaN(r_dementhon)) {
-      is_valid_dementhon = false;
-      r_dementhon = DBL_MAX;
+  // If residual returned is not a number (NAN), set valid to false
+  if (vpMath::isNaN(r_lagrange)) {
+    is_valid_lagrange = false;
+    r_lagrange = DBL_MAX;
+  }
+
+  if (vpMath::isNaN(r_dementhon)) {
+    is_valid_dementhon = false;
+    r_dementhon = DBL_MAX;
+  }
+
+  // If at least one pose computation is OK,
+  // we can continue, otherwise pick another random set
+  if (!is_valid_lagrange && !is_valid_dementhon) {
+    return false;
+  }
+
+  double r;
+  if (r_lagrange < r_dementhon) {
+    r = r_lagrange;
+    cMo = cMo_lagrange;
+  } else {
+    r = r_dementhon;
+    cMo = cMo_dementhon;
+  }
+  r = sqrt(r) / (double)poseMin.npt;
+
+  return r < threshold;
+}
+
+// Pose estimated by vpAdaptiveRansac. The model stores the 3x4 matrix
+// [R t] of cMo row by row.
+class PoseEstimator : public vpAdaptiveRansac::vpModelEstimator
+{
+public:
+  PoseEstimator(const std::vector<vpPoint> &points, const vpPose::vpPoseMethodType hypothesisMethod,
+                const bool checkDegeneratePoints, const double threshold, bool (*func)(vpHomogeneousMatrix *))
+    : m_points(points), m_hypothesisMethod(hypothesisMethod), m_checkDegeneratePoints(checkDegeneratePoints),
+      m_threshold(threshold), m_func(func)
+  {
+  }
+
+  unsigned int getNbData() const { return (unsigned int)m_points.size(); }
+
+  unsigned int getSampleSize() const { return (m_hypothesisMethod == vpPose::P3P) ? 3 : 4; }
+
+  bool isSampleValid(const std::vector<unsigned int> &sample) const
+  {
+    if (m_checkDegeneratePoints) {
+      for (size_t i = 1; i < sample.size(); i++) {
+        FindDegeneratePoint degenerate(m_points[sample[i]]);
+        for (size_t j = 0; j < i; j++) {
+          if (degenerate(m_points[sample[j]])) {
+            return false;
+          }
+        }
+      }
     }
+    return true;
+  }
 
-    // If at least one pose computation is OK,
-    // we can continue, otherwise pick another random set
-    if (is_valid_lagrange || is_valid_dementhon) {
-      double r;
-      if (r_lagrange < r_dementhon) {
-        r = r_lagrange;
-        cMo_tmp = cMo_lagrange;
-      } else {
-        r = r_dementhon;
-        cMo_tmp = cMo_dementhon;
+  void computeModels(const std::vector<unsigned int> &sample, std::vector<vpColVector> &models) const
+  {
+    std::vector<vpHomogeneousMatrix> hypotheses;
+    if (m_hypothesisMethod == vpPose::P3P) {
+      // Up to four solutions, the sample residual is null for each of them
+      vpPose::computePoseP3P(m_points[sample[0]], m_points[sample[1]], m_points[sample[2]], hypotheses);
+    } else {
+      vpPose poseMin;
+      for (size_t i = 0; i < sample.size(); i++) {
+        poseMin.addPoint(m_points[sample[i]]);
+      }
+      vpHomogeneousMatrix cMo;
+      if (computeMinimalSamplePose(poseMin, m_hypothesisMethod, cMo, m_threshold)) {
+        hypotheses.push_back(cMo);
       }
-      r = sqrt(r) / (double)nbMinRandom;
+    }
 
+    for (size_t h = 0; h < hypotheses.size(); h++) {
       // Filter the pose using some criterion (orientation angles,
       // translations, etc.)
-      bool isPoseValid = true;
-      if (m_func != NULL) {
-        isPoseValid = m_func(&cMo_tmp);
-        if (isPoseValid) {
-          m_cMo = cMo_tmp;
-        }
-      } else {
-        // No post filtering on pose, so copy cMo_temp to cMo
-        m_cMo = cMo_tmp;
+      if (m_func != NULL && !m_func(&hypotheses[h])) {
+        continue;
       }
 
-      if (isPoseValid && r < m_ransacThreshold) {
-        unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::vector<vpPoint>::const_iterator it = m_listOfUniquePoints.begin(); it != m_listOfUniquePoints.end();
-             ++it, iter++) {
-          p.setWorldCoordinates(it->get_oX(), it->get_oY(), it->get_oZ());
-          p.track(m_cMo);
-
-          double error = sqrt(vpMath::sqr(p.get_x() - it->get_x()) + vpMath::sqr(p.get_y() - it->get_y()));
-          if (error < m_ransacThreshold) {
-            bool degenerate = false;
-            if (m_checkDegeneratePoints) {
-              if (std::find_if(cur_inliers.begin(), cur_inliers.end(), FindDegeneratePoint(*it)) != cur_inliers.end()) {
-                degenerate = true;
-              }
-            }
-
-            if (!degenerate) {
-              // the point is considered as inlier if the error is below the
-              // threshold
-              nbInliersCur++;
-              cur_consensus.push_back(iter);
-              cur_inliers.push_back(*it);
-            } else {
-              cur_outliers.push_back(iter);
-            }
-          } else {
-            cur_outliers.push_back(iter);
-          }
-        }
-
-        if (nbInliersCur > m_nbInliers) {
-          foundSolution = true;
-          m_best_consensus = cur_consensus;
-          m_nbInliers = nbInliersCur;
-        }
+      vpColVector model(12);
+      for (unsigned int i = 0; i < 12; i++) {
+        model[i] = hypotheses[h].data[i];
+      }
+      models.push_back(model);
+    }
+  }
 
-        nbTrials++;
+  double computeError(const vpColVector &model, unsigned int index) const
+  {
+    const vpPoint &pt = m_points[index];
+    const double oX = pt.get_oX(), oY = pt.get_oY(), oZ = pt.get_oZ();
+    const double X = model[0] * oX + model[1] * oY + model[2] * oZ + model[3];
+    const double Y = model[4] * oX + model[5] * oY + model[6] * oZ + model[7];
+    const double Z = model[8] * oX + model[9] * oY + model[10] * oZ + model[11];
+    return sqrt(vpMath::sqr(X / Z - pt.get_x()) + vpMath::sqr(Y / Z - pt.get_y()));
+  }
 
-        if (nbTrials >= m_ransacMaxTrials) {
-          foundSolution = true;
+  bool isInlierValid(const std::vector<unsigned int> &inliers, unsigned int index) const
+  {
+    if (m_checkDegeneratePoints) {
+      FindDegeneratePoint degenerate(m_points[index]);
+      for (size_t i = 0; i < inliers.size(); i++) {
+        if (degenerate(m_points[inliers[i]])) {
+          return false;
         }
-      } else {
-        nbTrials++;
       }
-    } else {
-      nbTrials++;
     }
+    return true;
   }
 
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-  if (m_nbInliers >= m_ransacNbInlierConsensus)
-    m_abort = true;
-#endif
-
-  return foundSolution;
+private:
+  const std::vector<vpPoint> &m_points;
+  vpPose::vpPoseMethodType m_hypothesisMethod;
+  bool m_checkDegeneratePoints;
+  double m_threshold;
+  bool (*m_func)(vpHomogeneousMatrix *);
+};
 }
 
 /*!
@@ -326,7 +289,10 @@ bool vpPose::RansacFunctor::poseRansacImpl()
   otherwise
   \return True if we found at least 4 points with a reprojection
   error below ransacThreshold.
-  \note You can enable a multithreaded version if you have C++11 enabled using \e setUseParallelRansac
+  \note The pose hypotheses are computed from minimal samples of three
+  points with the P3P solver. Another method can be selected with \e
+  setRansacHypothesisMethod.
+  \note You can enable a multithreaded version using \e setUseParallelRansac.
   The number of threads used can then be set with \e setNbParallelRansacThreads
   Filter flag can be used  with \e setRansacFilterFlag
 */
@@ -345,8 +311,6 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
   std::vector<unsigned int> best_consensus;
   unsigned int nbInliers = 0;
 
-  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
-
   if (listOfPoints.size() < 4) {
     throw(vpPoseException(vpPoseException::notInitializedError, "Not enough point to compute the pose"));
   }
@@ -394,190 +358,81 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
     throw(vpPoseException(vpPoseException::notInitializedError, "Not enough point to compute the pose"));
   }
 
-  bool executeParallelVersion = useParallelRansac;
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-  unsigned int nbThreads = 1;
-#else
-  executeParallelVersion = false;
-#endif
-
-  if (executeParallelVersion) {
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    if (nbParallelRansacThreads <= 0) {
-      // Get number of CPU threads
-      nbThreads = std::thread::hardware_concurrency();
-      if (nbThreads <= 1) {
-        nbThreads = 1;
-        executeParallelVersion = false;
-      }
-    }
-#endif
+  vpAdaptiveRansac ransac;
+  ransac.setMaxTrials(ransacMaxTrials > 0 ? (unsigned int)ransacMaxTrials : 0);
+  ransac.setNbInliersToReachConsensus(ransacNbInlierConsensus);
+  ransac.setProbability(ransacProbability);
+  ransac.setThreshold(ransacThreshold);
+  ransac.setUseSPRT(useRansacSPRT);
+  if (useParallelRansac) {
+    // 0 means as many tasks as threads in the pool
+    ransac.setNbThreads(nbParallelRansacThreads > 0 ? (unsigned int)nbParallelRansacThreads : 0);
   }
 
-  bool foundSolution = false;
-
-  if (executeParallelVersion) {
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::vector<std::thread> threadpool;
-    std::vector<RansacFunctor> ransacWorkers;
-    const unsigned int nthreads = std::thread::hardware_concurrency();
-
-    int splitTrials = ransacMaxTrials / nthreads;
-    std::atomic<bool> abort{false};
-    for (size_t i = 0; i < (size_t)nthreads; i++) {
-      unsigned int initial_seed = (unsigned int)i; //((unsigned int) time(NULL) ^ i);
-      if (i < (size_t)nthreads - 1) {
-        ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, splitTrials, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
-      } else {
-        int maxTrialsRemainder = ransacMaxTrials - splitTrials * (nbThreads - 1);
-        ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, maxTrialsRemainder, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
-      }
-    }
-
-    for (auto& worker : ransacWorkers) {
-      threadpool.emplace_back(&RansacFunctor::operator(), &worker);
-    }
-
-    for (auto& th : threadpool) {
-      th.join();
-    }
-
-    bool successRansac = false;
-    size_t best_consensus_size = 0;
-    for (auto &worker : ransacWorkers) {
-      if (worker.getResult()) {
-        successRansac = true;
-
-        if (worker.getBestConsensus().size() > best_consensus_size) {
-          nbInliers = worker.getNbInliers();
-          best_consensus = worker.getBestConsensus();
-          best_consensus_size = worker.getBestConsensus().size();
-        }
-      }
+  if (!ransacQualities.empty()) {
+    if (ransacQualities.size() != listOfPoints.size()) {
+      throw(vpPoseException(vpPoseException::notInitializedError, "%d RANSAC qualities for %d points",
+                            (int)ransacQualities.size(), (int)listOfPoints.size()));
     }
-
-    foundSolution = successRansac;
-#endif
-  } else {
-    // Sequential RANSAC
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::atomic<bool> abort{false};
-#endif
-    RansacFunctor sequentialRansac(cMo, ransacNbInlierConsensus, ransacMaxTrials, ransacThreshold, 0,
-                                   checkDegeneratePoints, listOfUniquePoints, func
-                               #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-                                   , abort
-                               #endif
-                                   );
-    sequentialRansac();
-    foundSolution = sequentialRansac.getResult();
-
-    if (foundSolution) {
-      nbInliers = sequentialRansac.getNbInliers();
-      best_consensus = sequentialRansac.getBestConsensus();
+    std::vector<double> qualities(listOfUniquePoints.size());
+    for (size_t i = 0; i < listOfUniquePoints.size(); i++) {
+      qualities[i] = ransacQualities[mapOfUniquePointIndex[i]];
     }
+    ransac.setQualities(qualities);
   }
 
-  if (foundSolution) {
-    const unsigned int nbMinRandom = 4;
-    //    std::cout << "Nombre d'inliers " << nbInliers << std::endl ;
-
-    // Display the random picked points
-    /*
-    std::cout << "Randoms : ";
-    for(unsigned int i = 0 ; i < cur_randoms.size() ; i++)
-      std::cout << cur_randoms[i] << " ";
-    std::cout << std::endl;
-    */
-
-    // Display the outliers
-    /*
-    std::cout << "Outliers : ";
-    for(unsigned int i = 0 ; i < cur_outliers.size() ; i++)
-      std::cout << cur_outliers[i] << " ";
-    std::cout << std::endl;
-    */
+  PoseEstimator estimator(listOfUniquePoints, ransacHypothesisMethod, checkDegeneratePoints, ransacThreshold, func);
+  vpColVector model;
+  bool foundSolution = ransac.estimate(estimator, model, best_consensus);
+  nbInliers = (unsigned int)best_consensus.size();
 
+  if (foundSolution) {
     // Even if the cardinality of the best consensus set is inferior to
     // ransacNbInlierConsensus,  we want to refine the solution with data in
     // best_consensus and return this pose.  This is an approach used for
     // example in p118 in Multiple View Geometry in Computer Vision, Hartley,
     // R.~I. and Zisserman, A.
-    if (nbInliers >= nbMinRandom) // if(nbInliers >= (unsigned)ransacNbInlierConsensus)
-    {
-      // Refine the solution using all the points in the consensus set and
-      // with VVS pose estimation
-      vpPose pose;
-      for (size_t i = 0; i < best_consensus.size(); i++) {
-        vpPoint pt = listOfUniquePoints[best_consensus[i]];
-
-        pose.addPoint(pt);
-        ransacInliers.push_back(pt);
-      }
+    // A P3P consensus set may have three points, less than computePose()
+    // needs for the refinement.
+    if (nbInliers < 4) {
+      return false;
+    }
 
-      // Update the list of inlier index
-      for (std::vector<unsigned int>::const_iterator it_index = best_consensus.begin();
-           it_index != best_consensus.end(); ++it_index) {
-        ransacInlierIndex.push_back((unsigned int)mapOfUniquePointIndex[*it_index]);
-      }
+    // Refine the solution using all the points in the consensus set and
+    // with VVS pose estimation
+    vpPose pose;
+    for (size_t i = 0; i < best_consensus.size(); i++) {
+      vpPoint pt = listOfUniquePoints[best_consensus[i]];
 
-      // Flags set if pose computation is OK
-      bool is_valid_lagrange = false;
-      bool is_valid_dementhon = false;
-
-      // Set maximum value for residuals
-      double r_lagrange = DBL_MAX;
-      double r_dementhon = DBL_MAX;
-
-      try {
-        pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
-        r_lagrange = pose.computeResidual(cMo_lagrange);
-        is_valid_lagrange = true;
-      } catch (...) { }
-
-      try {
-        pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
-        r_dementhon = pose.computeResidual(cMo_dementhon);
-        is_valid_dementhon = true;
-      } catch (...) { }
-
-      // If residual returned is not a number (NAN), set valid to false
-      if (vpMath::isNaN(r_lagrange)) {
-        is_valid_lagrange = false;
-        r_lagrange = DBL_MAX;
-      }
-
-      if (vpMath::isNaN(r_dementhon)) {
-        is_valid_dementhon = false;
-        r_dementhon = DBL_MAX;
-      }
+      pose.addPoint(pt);
+      ransacInliers.push_back(pt);
+    }
 
-      if (is_valid_lagrange || is_valid_dementhon) {
-        if (r_lagrange < r_dementhon) {
-          cMo = cMo_lagrange;
-        } else {
-          cMo = cMo_dementhon;
-        }
+    // Update the list of inlier index
+    for (std::vector<unsigned int>::const_iterator it_index = best_consensus.begin();
+         it_index != best_consensus.end(); ++it_index) {
+      ransacInlierIndex.push_back((unsigned int)mapOfUniquePointIndex[*it_index]);
+    }
 
-        pose.setCovarianceComputation(computeCovariance);
-        pose.computePose(vpPose::VIRTUAL_VS, cMo);
+    // The VVS starts from the pose of the best RANSAC hypothesis
+    vpHomogeneousMatrix cMo_ransac;
+    for (unsigned int i = 0; i < 12; i++) {
+      cMo_ransac.data[i] = model[i];
+    }
+    cMo = cMo_ransac;
 
-        // In some rare cases, the final pose could not respect the pose
-        // criterion even  if the 4 minimal points picked respect the pose
-        // criterion.
-        if (func != NULL && !func(&cMo)) {
-          return false;
-        }
+    pose.setCovarianceComputation(computeCovariance);
+    pose.computePose(vpPose::VIRTUAL_VS, cMo);
 
-        if (computeCovariance) {
-          covarianceMatrix = pose.covarianceMatrix;
-        }
-      }
-    } else {
+    // In some rare cases, the final pose could not respect the pose
+    // criterion even if the best hypothesis respects it.
+    if (func != NULL && !func(&cMo)) {
       return false;
     }
+
+    if (computeCovariance) {
+      covarianceMatrix = pose.covarianceMatrix;
+    }
   }
 
   return foundSolution;
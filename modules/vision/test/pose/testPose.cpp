@@ -55,8 +55,8 @@
 /*!
   \example testPose.cpp
 
-  Compute the pose of a 3D object using the Dementhon, Lagrange and
-  Non-Linear approach.
+  Compute the pose of a 3D object using the Dementhon, Lagrange, P3P, EPnP
+  and Non-Linear approach.
 
 */
 
@@ -154,6 +154,20 @@ int main()
     fail = compare_pose(pose, cMo_ref, cMo, "pose by Dementhon");
     test_fail |= fail;
 
+    std::cout << "--------------------------------------------------" << std::endl;
+    pose.computePose(vpPose::P3P, cMo);
+
+    print_pose(cMo, std::string("Pose estimated by P3P"));
+    fail = compare_pose(pose, cMo_ref, cMo, "pose by P3P");
+    test_fail |= fail;
+
+    std::cout << "--------------------------------------------------" << std::endl;
+    pose.computePose(vpPose::EPNP, cMo);
+
+    print_pose(cMo, std::string("Pose estimated by EPnP"));
+    fail = compare_pose(pose, cMo_ref, cMo, "pose by EPnP");
+    test_fail |= fail;
+
     std::cout << "--------------------------------------------------" << std::endl;
     pose.setRansacNbInliersToReachConsensus(4);
     pose.setRansacThreshold(0.01);
@@ -163,6 +177,15 @@ int main()
     fail = compare_pose(pose, cMo_ref, cMo, "pose by Ransac");
     test_fail |= fail;
 
+    std::cout << "--------------------------------------------------" << std::endl;
+    pose.setRansacHypothesisMethod(vpPose::EPNP);
+    pose.computePose(vpPose::RANSAC, cMo);
+    pose.setRansacHypothesisMethod(vpPose::P3P);
+
+    print_pose(cMo, std::string("Pose estimated by Ransac with EPnP hypotheses"));
+    fail = compare_pose(pose, cMo_ref, cMo, "pose by Ransac with EPnP hypotheses");
+    test_fail |= fail;
+
     std::cout << "--------------------------------------------------" << std::endl;
     pose.computePose(vpPose::LAGRANGE_LOWE, cMo);
 
@@ -95,6 +95,9 @@ public:
   }
   vpFeatureException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpFeatureException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpFeatureException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
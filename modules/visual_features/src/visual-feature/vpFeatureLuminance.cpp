@@ -36,6 +36,7 @@
  *
  *****************************************************************************/
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
@@ -43,9 +44,95 @@
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <visp3/visual_features/vpFeatureLuminance.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Fill the rows [begin, end) of the interaction matrix of the luminance
+// feature. With SSE2, two rows are computed at once
+class vpLuminanceInteractionBody : public vpThreadPool::vpParallelLoopBody
+{
+public:
+  vpLuminanceInteractionBody(const vpLuminance *pixInfo, vpMatrix &L) : m_pixInfo(pixInfo), m_L(L), m_useSSE2(false)
+  {
+#if VISP_HAVE_SSE2
+    m_useSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+  }
+
+  void operator()(unsigned int begin, unsigned int end) const
+  {
+    unsigned int m = begin;
+
+#if VISP_HAVE_SSE2
+    if (m_useSSE2) {
+      const __m128d one = _mm_set1_pd(1.0);
+      const __m128d sign = _mm_set1_pd(-0.0);
+      for (; m + 2 <= end; m += 2) {
+        const vpLuminance &a = m_pixInfo[m];
+        const vpLuminance &b = m_pixInfo[m + 1];
+        const __m128d Ix = _mm_loadh_pd(_mm_load_sd(&a.Ix), &b.Ix);
+        const __m128d Iy = _mm_loadh_pd(_mm_load_sd(&a.Iy), &b.Iy);
+        const __m128d x = _mm_loadh_pd(_mm_load_sd(&a.x), &b.x);
+        const __m128d y = _mm_loadh_pd(_mm_load_sd(&a.y), &b.y);
+        const __m128d Zinv = _mm_div_pd(one, _mm_loadh_pd(_mm_load_sd(&a.Z), &b.Z));
+
+        // Same operations, in the same order, as the scalar code below
+        const __m128d L0 = _mm_mul_pd(Ix, Zinv);
+        const __m128d L1 = _mm_mul_pd(Iy, Zinv);
+        const __m128d L2 = _mm_mul_pd(_mm_xor_pd(sign, _mm_add_pd(_mm_mul_pd(x, Ix), _mm_mul_pd(y, Iy))), Zinv);
+        const __m128d L3 = _mm_sub_pd(_mm_mul_pd(_mm_mul_pd(_mm_xor_pd(sign, Ix), x), y),
+                                      _mm_mul_pd(_mm_add_pd(one, _mm_mul_pd(y, y)), Iy));
+        const __m128d L4 =
+            _mm_add_pd(_mm_mul_pd(_mm_add_pd(one, _mm_mul_pd(x, x)), Ix), _mm_mul_pd(_mm_mul_pd(Iy, x), y));
+        const __m128d L5 = _mm_sub_pd(_mm_mul_pd(Iy, x), _mm_mul_pd(Ix, y));
+
+        double *La = m_L[m];
+        double *Lb = m_L[m + 1];
+        _mm_storeu_pd(La, _mm_unpacklo_pd(L0, L1));
+        _mm_storeu_pd(La + 2, _mm_unpacklo_pd(L2, L3));
+        _mm_storeu_pd(La + 4, _mm_unpacklo_pd(L4, L5));
+        _mm_storeu_pd(Lb, _mm_unpackhi_pd(L0, L1));
+        _mm_storeu_pd(Lb + 2, _mm_unpackhi_pd(L2, L3));
+        _mm_storeu_pd(Lb + 4, _mm_unpackhi_pd(L4, L5));
+      }
+    }
+#endif
+
+    for (; m < end; m++) {
+      double Ix = m_pixInfo[m].Ix;
+      double Iy = m_pixInfo[m].Iy;
+
+      double x = m_pixInfo[m].x;
+      double y = m_pixInfo[m].y;
+      double Zinv = 1 / m_pixInfo[m].Z;
+
+      double *Lm = m_L[m];
+      Lm[0] = Ix * Zinv;
+      Lm[1] = Iy * Zinv;
+      Lm[2] = -(x * Ix + y * Iy) * Zinv;
+      Lm[3] = -Ix * x * y - (1 + y * y) * Iy;
+      Lm[4] = (1 + x * x) * Ix + Iy * x * y;
+      Lm[5] = Iy * x - Ix * y;
+    }
+  }
+
+private:
+  const vpLuminance *m_pixInfo;
+  vpMatrix &m_L;
+  bool m_useSSE2;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   \file vpFeatureLuminance.cpp
   \brief Class that defines the image luminance visual feature
@@ -222,28 +309,21 @@ void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 
   Compute and return the interaction matrix \f$ L_I \f$. The computation is
   made thanks to the values of the luminance features \f$ I \f$
+
+  The rows, one per pixel, are filled in parallel by the threads of
+  vpThreadPool::getInstance(), two rows at a time with SSE2 instructions when
+  available.
 */
 void vpFeatureLuminance::interaction(vpMatrix &L)
 {
-  L.resize(dim_s, 6);
-
-  for (unsigned int m = 0; m < L.getRows(); m++) {
-    double Ix = pixInfo[m].Ix;
-    double Iy = pixInfo[m].Iy;
-
-    double x = pixInfo[m].x;
-    double y = pixInfo[m].y;
-    double Zinv = 1 / pixInfo[m].Z;
-
-    {
-      L[m][0] = Ix * Zinv;
-      L[m][1] = Iy * Zinv;
-      L[m][2] = -(x * Ix + y * Iy) * Zinv;
-      L[m][3] = -Ix * x * y - (1 + y * y) * Iy;
-      L[m][4] = (1 + x * x) * Ix + Iy * x * y;
-      L[m][5] = Iy * x - Ix * y;
-    }
+  L.resize(dim_s, 6, false);
+  if (dim_s == 0) {
+    return;
   }
+
+  // The rows are independent, and their number is the number of pixels of
+  // the image
+  vpThreadPool::getInstance().parallelFor(0, dim_s, vpLuminanceInteractionBody(pixInfo, L));
 }
 
 /*!
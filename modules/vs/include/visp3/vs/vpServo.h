@@ -539,6 +539,9 @@ protected:
    */
   void computeProjectionOperators();
 
+  void computePrimaryTask();
+  unsigned int computeNormalPseudoInverse(vpMatrix &J1tJ1p_, vpMatrix &imJ1t);
+
 public:
   //! Interaction matrix
   vpMatrix L;
@@ -549,7 +552,8 @@ public:
   vpColVector error;
   //! Task Jacobian  \f$J_1 = L {^c}V_a {^a}J_e\f$.
   vpMatrix J1;
-  //! Pseudo inverse \f${J_1}^{+}\f$ of the task Jacobian.
+  //! Pseudo inverse \f${J_1}^{+}\f$ of the task Jacobian. It is not
+  //! updated for tall task Jacobians, see getTaskJacobianPseudoInverse().
   vpMatrix J1p;
 
   //! Current state of visual features \f$s\f$.
@@ -674,6 +678,14 @@ protected:
   //! A diag matrix used to determine which are the degrees of freedom that
   //! are controlled in the camera frame
   vpMatrix cJc;
+
+  //! Minimal ratio between the number of rows and columns of a task
+  //! Jacobian inverted through its normal matrix
+  static const unsigned int TALL_TASK_JACOBIAN_RATIO = 32;
+  //! Pseudo inverse of \f${J_1}^\top J_1\f$ when the task Jacobian is tall
+  vpMatrix J1tJ1p;
+  //! false if J1p was not computed because the task Jacobian is tall
+  bool J1pComputed;
 };
 
 #endif
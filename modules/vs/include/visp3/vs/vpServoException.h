@@ -91,6 +91,9 @@ public:
   }
   vpServoException(const int id, const std::string &msg) : vpException(id, msg) { ; }
   explicit vpServoException(const int id) : vpException(id) { ; }
+
+  vpException *clone() const { return new vpServoException(*this); }
+  void rethrow() const { throw *this; }
 };
 
 #endif
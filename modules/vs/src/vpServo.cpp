@@ -40,6 +40,7 @@
 
 #include <visp3/vs/vpServo.h>
 
+#include <algorithm>
 #include <sstream>
 
 // Exception
@@ -72,7 +73,7 @@ vpServo::vpServo()
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false),
     fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false), errorComputed(false),
     interactionMatrixComputed(false), dim_task(0), taskWasKilled(false), forceInteractionMatrixComputation(false),
-    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6)
+    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6), J1tJ1p(), J1pComputed(true)
 {
   cJc.eye();
 }
@@ -97,7 +98,7 @@ vpServo::vpServo(vpServoType servo_type)
     inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(),
     init_eJe(false), fJe(), init_fJe(false), errorComputed(false), interactionMatrixComputed(false), dim_task(0),
     taskWasKilled(false), forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
-    iscJcIdentity(true), cJc(6, 6)
+    iscJcIdentity(true), cJc(6, 6), J1tJ1p(), J1pComputed(true)
 {
   cJc.eye();
 }
@@ -171,6 +172,7 @@ void vpServo::init()
   forceInteractionMatrixComputation = false;
 
   rankJ1 = 0;
+  J1pComputed = true;
 }
 
 /*!
@@ -993,47 +995,9 @@ vpColVector vpServo::computeControlLaw()
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1: " << rankJ1 << std::endl;
-      imJ1t.print(std::cout, 10, "imJ1t");
-      imJ1.print(std::cout, 10, "imJ1");
-
-      WpW.print(std::cout, 10, "WpW");
-      J1.print(std::cout, 10, "J1");
-      J1p.print(std::cout, 10, "J1p");
-#endif
-      e1 = WpW * J1p * error;
-    }
+    // pseudo inverse of the task Jacobian, rank of the task Jacobian and
+    // primary task
+    computePrimaryTask();
     e = -lambda(e1) * e1;
 
     vpMatrix I;
@@ -1143,47 +1107,9 @@ vpColVector vpServo::computeControlLaw(double t)
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
-
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
-#endif
-      e1 = WpW * J1p * error;
-    }
+    // pseudo inverse of the task Jacobian, rank of the task Jacobian and
+    // primary task
+    computePrimaryTask();
 
     // memorize the initial e1 value if the function is called the first time
     // or if the time given as parameter is equal to 0.
@@ -1303,47 +1229,9 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
-
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
-#endif
-      e1 = WpW * J1p * error;
-    }
+    // pseudo inverse of the task Jacobian, rank of the task Jacobian and
+    // primary task
+    computePrimaryTask();
 
     // memorize the initial e1 value if the function is called the first time
     // or if the time given as parameter is equal to 0.
@@ -1370,6 +1258,140 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
   return e;
 }
 
+/*!
+  Compute the pseudo inverse and the rank of the task Jacobian, the
+  projection operator \f$\bf WpW\f$ and the primary task \f$e_1\f$.
+
+  When the task Jacobian is tall, with at least
+  vpServo::TALL_TASK_JACOBIAN_RATIO times more rows than columns as with
+  dense photometric features, the pseudo inverse is obtained from the SVD of
+  the small normal matrix \f${J_1}^\top J_1\f$ instead of the one of \f$J_1\f$, and
+  \f$e_1 = ({J_1}^\top J_1)^{+} {J_1}^\top e\f$ is computed without forming
+  \f${J_1}^{+}\f$. The member J1p is then not updated, but
+  getTaskJacobianPseudoInverse() computes it on demand.
+*/
+void vpServo::computePrimaryTask()
+{
+  const unsigned int n = J1.getCols();
+  const bool tall = J1.getRows() >= TALL_TASK_JACOBIAN_RATIO * n;
+
+  // the image of J1 is also computed to allows the computation
+  // of the projection operator
+  vpMatrix imJ1t, imJ1;
+  bool imageComputed = false;
+  J1pComputed = true;
+
+  if (inversionType == PSEUDO_INVERSE) {
+    if (tall) {
+      rankJ1 = computeNormalPseudoInverse(J1tJ1p, imJ1t);
+      J1pComputed = false;
+    } else {
+      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
+    }
+
+    imageComputed = true;
+  } else
+    J1p = J1.t();
+
+  if (rankJ1 == n) {
+    /* if no degrees of freedom remains (rank J1 = ndof)
+     WpW = I, multiply by WpW is useless
+  */
+    WpW.eye(n, n);
+  } else {
+    if (imageComputed != true) {
+      vpMatrix Jtmp;
+      // image of J1 is computed to allows the computation
+      // of the projection operator
+      if (tall) {
+        rankJ1 = computeNormalPseudoInverse(Jtmp, imJ1t);
+      } else {
+        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
+      }
+    }
+    WpW = imJ1t * imJ1t.t();
+
+#ifdef DEBUG
+    std::cout << "rank J1 " << rankJ1 << std::endl;
+    std::cout << "imJ1t" << std::endl << imJ1t;
+    std::cout << "imJ1" << std::endl << imJ1;
+
+    std::cout << "WpW" << std::endl << WpW;
+    std::cout << "J1" << std::endl << J1;
+    std::cout << "J1p" << std::endl << J1p;
+#endif
+  }
+
+  if (J1pComputed) {
+    e1 = J1p * error; // primary task
+  } else {
+    e1 = J1tJ1p * (error.t() * J1).t(); // primary task
+  }
+
+  if (rankJ1 != n) {
+    e1 = WpW * e1;
+  }
+}
+
+/*!
+  Compute the pseudo inverse of \f${J_1}^\top J_1\f$ from its SVD, with the
+  singular values of \f$J_1\f$ and the image of \f${J_1}^\top\f$, as
+  vpMatrix::pseudoInverse() would do for \f$J_1\f$.
+
+  The singular values of \f$J_1\f$ are the square roots of the eigenvalues of
+  \f${J_1}^\top J_1\f$. Forming this matrix squares the condition number,
+  but the 1e-6 relative threshold on the singular values is a 1e-12 relative
+  threshold on the eigenvalues, well above their rounding error.
+
+  \param J1tJ1p_ : Pseudo inverse of \f${J_1}^\top J_1\f$.
+  \param imJ1t : Image of \f${J_1}^\top\f$.
+  \return The rank of \f$J_1\f$.
+*/
+unsigned int vpServo::computeNormalPseudoInverse(vpMatrix &J1tJ1p_, vpMatrix &imJ1t)
+{
+  const unsigned int n = J1.getCols();
+  vpMatrix U, V;
+  vpColVector w;
+  J1.AtA(U);
+  // U is symmetric positive semi-definite: its singular values are the
+  // squares of the ones of J1, and its singular vectors the right singular
+  // vectors of J1
+  U.svd(w, V);
+
+  // The singular values are not assumed to be sorted: as in
+  // vpMatrix::pseudoInverse(), they are compared with the largest one
+  sv.resize(n);
+  double maxsv = 0.;
+  for (unsigned int i = 0; i < n; i++) {
+    sv[i] = sqrt((std::max)(w[i], 0.));
+    maxsv = (std::max)(maxsv, sv[i]);
+  }
+
+  const double svThreshold = 1e-6 * maxsv;
+  std::vector<unsigned int> kept;
+  J1tJ1p_.resize(n, n);
+  for (unsigned int k = 0; k < n; k++) {
+    if (sv[k] > svThreshold) {
+      kept.push_back(k);
+      for (unsigned int i = 0; i < n; i++) {
+        for (unsigned int j = 0; j < n; j++) {
+          J1tJ1p_[i][j] += V[i][k] * V[j][k] / w[k];
+        }
+      }
+    }
+  }
+
+  const unsigned int rank = (unsigned int)kept.size();
+  imJ1t.resize(n, rank);
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = 0; j < rank; j++) {
+      imJ1t[i][j] = V[i][kept[j]];
+    }
+  }
+
+  return rank;
+}
+
 void vpServo::computeProjectionOperators()
 {
   // Initialization
@@ -1396,15 +1418,14 @@ void vpServo::computeProjectionOperators()
   else
     sig = 0.0;
 
-  vpMatrix J1t = J1.transpose();
+  // With g = J1^T e, e^T J1 J1^T e = g^T g and J1^T e e^T J1 = g g^T are
+  // computed in the joint space, without forming m x m matrices
+  vpColVector g = (error.t() * J1).t();
 
-  double pp = (error.t() * (J1 * J1t) * error);
-
-  vpMatrix ee_t(n, n);
-  ee_t = error * error.t();
+  double pp = g.sumSquare();
 
   vpMatrix P_norm_e(n, n);
-  P_norm_e = I - (1.0 / pp) * J1t * ee_t * J1;
+  P_norm_e = I - (1.0 / pp) * g * g.t();
 
   P = sig * P_norm_e + (1 - sig) * I_WpW;
 
@@ -1795,7 +1816,9 @@ vpMatrix vpServo::getTaskJacobian() const { return J1; }
 {\bf L}} {^c}{\bf V}_a {^a}{\bf J}_e\f$.
 
    The task jacobian and its pseudo inverse are updated after a call of
-computeControlLaw().
+computeControlLaw(). For a tall task jacobian, e.g. with dense photometric
+features, the control law does not need the pseudo inverse, which is then
+computed by this function.
 
    \return Pseudo inverse \f${J}^{+}\f$ of the task jacobian.
 \code
@@ -1806,7 +1829,14 @@ computeControlLaw().
 
  \sa getTaskJacobian()
  */
-vpMatrix vpServo::getTaskJacobianPseudoInverse() const { return J1p; }
+vpMatrix vpServo::getTaskJacobianPseudoInverse() const
+{
+  if (!J1pComputed) {
+    // Tall task Jacobian, see computePrimaryTask()
+    return J1tJ1p * J1.t();
+  }
+  return J1p;
+}
 /*!
    Return the rank of the task jacobian. The rank is updated after a call of
 computeControlLaw().
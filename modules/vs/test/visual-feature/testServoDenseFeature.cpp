@@ -0,0 +1,260 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test visual servoing tasks with a large number of features.
+ *
+ *****************************************************************************/
+
+/*!
+
+  \example testServoDenseFeature.cpp
+
+  \brief Test the control law of a task whose Jacobian has much more rows
+  than columns, as with photometric features, against explicit
+  pseudo-inverses, and the interaction matrix of the luminance feature.
+
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+#include <visp3/vs/vpServo.h>
+
+namespace
+{
+// Feature with a given interaction matrix, whose dimension can be larger than
+// the one handled by vpGenericFeature
+class vpFeatureDense : public vpBasicFeature
+{
+public:
+  vpFeatureDense(const vpMatrix &L, const vpColVector &s_) : m_L(L)
+  {
+    dim_s = s_.getRows();
+    s = s_;
+    nbParameters = 0;
+  }
+
+  vpBasicFeature *duplicate() const { return new vpFeatureDense(m_L, s); }
+  void display(const vpCameraParameters &, const vpImage<unsigned char> &, const vpColor &, unsigned int) const {}
+  void display(const vpCameraParameters &, const vpImage<vpRGBa> &, const vpColor &, unsigned int) const {}
+  void init() {}
+  vpMatrix interaction(const unsigned int /* select */) { return m_L; }
+  void print(const unsigned int /* select */) const {}
+
+private:
+  vpMatrix m_L;
+};
+
+bool equal(const vpMatrix &A, const vpMatrix &B, double tolerance, const std::string &name)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    std::cerr << name << ": bad size" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    for (unsigned int j = 0; j < A.getCols(); j++) {
+      if (std::fabs(A[i][j] - B[i][j]) > tolerance) {
+        std::cerr << name << ": " << A[i][j] << " != " << B[i][j] << " at (" << i << ", " << j << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool checkTask(const vpMatrix &L, const vpColVector &e, unsigned int rank)
+{
+  vpFeatureDense s(L, e);
+  vpFeatureDense s_star(L, vpColVector(e.getRows(), 0));
+
+  vpServo task;
+  task.setServo(vpServo::EYEINHAND_CAMERA);
+  task.setInteractionMatrixType(vpServo::CURRENT);
+  task.setLambda(0.5);
+  task.addFeature(s, s_star);
+  vpColVector v = task.computeControlLaw();
+
+  vpMatrix Lp, imL, imLt;
+  vpColVector sv;
+  unsigned int rank_ref = L.pseudoInverse(Lp, sv, 1e-6, imL, imLt);
+  vpColVector v_ref = -0.5 * Lp * e;
+  vpMatrix WpW_ref = imLt * imLt.t();
+
+  bool ok = true;
+  if (task.getTaskRank() != rank || rank_ref != rank) {
+    std::cerr << "Bad rank: " << task.getTaskRank() << " instead of " << rank << std::endl;
+    ok = false;
+  }
+  ok = ok && equal(v, v_ref, 1e-9, "velocity");
+  ok = ok && equal(task.getTaskJacobianPseudoInverse(), Lp, 1e-9, "pseudo-inverse");
+  ok = ok && equal(task.getWpW(), WpW_ref, 1e-9, "WpW");
+  // The singular values below the threshold are not accurate when computed
+  // from the normal equations
+  ok = ok && equal(task.getTaskSingularValues().extract(0, rank), sv.extract(0, rank), 1e-9, "singular values");
+
+  // Projection operator of the secondary task on the norm of the error
+  vpMatrix P = task.getLargeP();
+  vpColVector g = L.t() * e;
+  vpMatrix P_ref = vpMatrix(WpW_ref.getRows(), WpW_ref.getCols());
+  P_ref.eye();
+  P_ref -= (1.0 / g.sumSquare()) * g * g.t();
+  ok = ok && equal(P, P_ref, 1e-9, "large projection operator");
+
+  task.kill();
+  return ok;
+}
+
+/*
+  Check that the rank of a task decided from the normal equations matches the
+  one of the direct pseudo-inverse of its Jacobian.
+*/
+bool checkRank(const vpMatrix &L, const vpColVector &e, unsigned int rank, const std::string &name)
+{
+  vpFeatureDense s(L, e);
+  vpFeatureDense s_star(L, vpColVector(e.getRows(), 0));
+
+  vpServo task;
+  task.setServo(vpServo::EYEINHAND_CAMERA);
+  task.setInteractionMatrixType(vpServo::CURRENT);
+  task.setLambda(0.5);
+  task.addFeature(s, s_star);
+  task.computeControlLaw();
+
+  vpMatrix Lp;
+  unsigned int rank_ref = L.pseudoInverse(Lp, 1e-6);
+  unsigned int rank_task = task.getTaskRank();
+  task.kill();
+
+  if (rank_task != rank_ref || rank_ref != rank) {
+    std::cerr << name << ": rank " << rank_task << " instead of " << rank_ref << " (expected " << rank << ")"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Gives access to the per pixel data used to build the interaction matrix
+class vpFeatureLuminanceTest : public vpFeatureLuminance
+{
+public:
+  const vpLuminance &getPixInfo(unsigned int i) const { return pixInfo[i]; }
+};
+}
+
+int main()
+{
+  vpUniRand rand(42);
+
+  // Well conditioned task with 2000 features, enough to use the normal
+  // equations of the task Jacobian
+  const unsigned int nbFeatures = 2000;
+  vpMatrix L(nbFeatures, 6);
+  vpColVector e(nbFeatures);
+  for (unsigned int i = 0; i < nbFeatures; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      L[i][j] = 2 * rand() - 1;
+    }
+    e[i] = 2 * rand() - 1;
+  }
+  if (!checkTask(L, e, 6)) {
+    return EXIT_FAILURE;
+  }
+
+  // Rank deficient task
+  for (unsigned int i = 0; i < nbFeatures; i++) {
+    L[i][5] = L[i][4] - 2 * L[i][0];
+  }
+  if (!checkTask(L, e, 5)) {
+    return EXIT_FAILURE;
+  }
+
+  // Nearly rank deficient tasks, whose smallest singular value is far below,
+  // 3 times below and 3 times above the threshold relative to the largest one
+  const double perturbations[3] = {1e-12, 2e-6, 2e-5};
+  const unsigned int ranks[3] = {5, 5, 6};
+  for (unsigned int k = 0; k < 3; k++) {
+    vpMatrix L_near = L;
+    for (unsigned int i = 0; i < nbFeatures; i++) {
+      L_near[i][5] += perturbations[k] * (2 * rand() - 1);
+    }
+    std::ostringstream name;
+    name << "nearly rank deficient task (" << perturbations[k] << ")";
+    if (!checkRank(L_near, e, ranks[k], name.str())) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Small task, that uses the pseudo-inverse of the task Jacobian
+  if (!checkTask(L.extract(0, 0, 100, 6), e.extract(0, 100), 5)) {
+    return EXIT_FAILURE;
+  }
+
+  // Interaction matrix of the luminance feature, with an odd number of rows
+  vpImage<unsigned char> I(61, 75);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)(127.5 + 60 * sin(i / 5.) + 60 * cos(j / 7.));
+    }
+  }
+  vpCameraParameters cam(300, 300, 37, 30);
+  vpFeatureLuminanceTest sI;
+  sI.init(I.getHeight(), I.getWidth(), 0.8);
+  sI.setCameraParameters(cam);
+  sI.buildFrom(I);
+  vpMatrix LI;
+  sI.interaction(LI);
+  if (LI.getRows() % 2 == 0 || LI.getRows() != sI.getDimension()) {
+    std::cerr << "Bad size of the luminance interaction matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vpMatrix LI_ref(LI.getRows(), 6);
+  for (unsigned int m = 0; m < LI_ref.getRows(); m++) {
+    const vpLuminance &p = sI.getPixInfo(m);
+    LI_ref[m][0] = p.Ix / p.Z;
+    LI_ref[m][1] = p.Iy / p.Z;
+    LI_ref[m][2] = -(p.x * p.Ix + p.y * p.Iy) / p.Z;
+    LI_ref[m][3] = -p.Ix * p.x * p.y - (1 + p.y * p.y) * p.Iy;
+    LI_ref[m][4] = (1 + p.x * p.x) * p.Ix + p.Iy * p.x * p.y;
+    LI_ref[m][5] = p.Iy * p.x - p.Ix * p.y;
+  }
+  if (!equal(LI, LI_ref, 1e-9, "luminance interaction matrix")) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testServoDenseFeature is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+#
+# Compare the results of ViSP micro-benchmarks between two builds.
+#
+# Usage: compare-benchmarks.py [-t <percent>] <before> <after>
+#
+# <before> and <after> are JSON files written by the benchmarks with the -o
+# option, or directories containing such files. The ratio after/before of the
+# median time per operation is printed for each case found in both. The
+# script exits with 1 when a case is slower than the threshold.
+
+from __future__ import print_function
+
+import getopt
+import json
+import os
+import sys
+
+def usage():
+  print("Usage: %s [-t <percent>] <before> <after>" % sys.argv[0])
+  print(" ")
+  print("  <before>, <after>  JSON result file or directory of JSON result files")
+  print("  -t <percent>       Report a regression above this slowdown (default 10)")
+  print("  -h                 Print this help")
+
+def load(path):
+  files = []
+  if os.path.isdir(path):
+    files = [os.path.join(path, f) for f in sorted(os.listdir(path)) if f.endswith(".json")]
+  else:
+    files = [path]
+
+  results = {}
+  for f in files:
+    with open(f) as fd:
+      data = json.load(fd)
+    for r in data["results"]:
+      results[(data["suite"], r["name"])] = r["ns_per_op"]
+  return results
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], "ht:")
+  except getopt.GetoptError as err:
+    print(err)
+    usage()
+    return 2
+
+  threshold = 10.
+  for o, a in opts:
+    if o == "-h":
+      usage()
+      return 0
+    elif o == "-t":
+      threshold = float(a)
+
+  if len(args) != 2:
+    usage()
+    return 2
+
+  before = load(args[0])
+  after = load(args[1])
+
+  regressions = 0
+  print("%-60s %14s %14s %8s" % ("case", "before (ns)", "after (ns)", "ratio"))
+  for key in sorted(before.keys()):
+    if key not in after or before[key] <= 0:
+      continue
+    ratio = after[key] / before[key]
+    flag = ""
+    if (ratio - 1.) * 100. > threshold:
+      flag = "  <-- slower"
+      regressions += 1
+    print("%-60s %14.1f %14.1f %8.3f%s" % (key[0] + "/" + key[1], before[key], after[key], ratio, flag))
+
+  for key in sorted(set(before.keys()) ^ set(after.keys())):
+    print("%-60s only in %s" % (key[0] + "/" + key[1], "before" if key in before else "after"))
+
+  if regressions:
+    print("%d case(s) slower by more than %g%%" % (regressions, threshold))
+    return 1
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())